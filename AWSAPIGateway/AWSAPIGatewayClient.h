@@ -52,6 +52,17 @@ typedef NS_ENUM(NSInteger, AWSAPIGatewayErrorType) {
  */
 - (AWSTask<AWSAPIGatewayResponse *> *)invoke:(AWSAPIGatewayRequest *)apiRequest;
 
+/**
+ *  Invokes an `AWS API Gateway` API endpoint and passes the response body to `responseDataHandler` as it arrives instead of collecting it, so that large responses are handled in constant memory.
+ *
+ *  @param apiRequest          An `AWSAPIGatewayRequest` object.
+ *  @param responseDataHandler The block to call with each part of the response body, in order. It is called on a background queue, for error responses as well as successful ones.
+ *
+ *  @return An instance of `AWSTask`. On successful execution, `task.result` will contain an instance of `AWSAPIGatewayResponse` whose `responseData` is `nil`. On failed execution, `task.error` may contain an `NSError`.
+ */
+- (AWSTask<AWSAPIGatewayResponse *> *)invoke:(AWSAPIGatewayRequest *)apiRequest
+                         responseDataHandler:(void (^)(NSData *data))responseDataHandler;
+
 @end
 
 NS_ASSUME_NONNULL_END
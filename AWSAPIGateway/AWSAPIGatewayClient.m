@@ -25,12 +25,32 @@ static NSString *const AWSAPIGatewayAPIKeyHeader = @"x-api-key";
 
 NSString *const AWSAPIGatewaySDKVersion = @"2.24.0";
 
-static int defaultChunkSize = 1024;
-
 @interface AWSAPIGatewayClient()
 
 // Networking
 @property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) NSURLSession *streamingSession;
+
+@end
+
+// An invocation whose response body is passed to a handler as it arrives.
+@interface AWSAPIGatewayStreamingTask : NSObject
+
+@property (nonatomic, copy) void (^responseDataHandler)(NSData *data);
+@property (nonatomic, strong) AWSTaskCompletionSource<AWSAPIGatewayResponse *> *completionSource;
+@property (nonatomic, strong) NSURLResponse *response;
+
+@end
+
+@implementation AWSAPIGatewayStreamingTask
+
+@end
+
+// The delegate of the session for streamed responses. A session keeps its delegate until it is invalidated, so a single
+// delegate serves every client.
+@interface AWSAPIGatewaySessionDelegate : NSObject <NSURLSessionDataDelegate>
+
+- (void)addStreamingTask:(AWSAPIGatewayStreamingTask *)streamingTask forSessionTask:(NSURLSessionTask *)sessionTask;
 
 @end
 
@@ -74,19 +94,29 @@ static int defaultChunkSize = 1024;
 - (instancetype)init {
     if (self = [super init]) {
         static NSURLSession *session = nil;
+        static NSURLSession *streamingSession = nil;
 
         static dispatch_once_t onceToken;
         dispatch_once(&onceToken, ^{
             NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
             session = [NSURLSession sessionWithConfiguration:sessionConfiguration];
+            streamingSession = [NSURLSession sessionWithConfiguration:sessionConfiguration
+                                                             delegate:[AWSAPIGatewaySessionDelegate new]
+                                                        delegateQueue:nil];
         });
 
         _session = session;
+        _streamingSession = streamingSession;
     }
     return self;
 }
 
 - (AWSTask<AWSAPIGatewayResponse *> *)invoke:(AWSAPIGatewayRequest *)apiRequest {
+    return [self invoke:apiRequest responseDataHandler:nil];
+}
+
+- (AWSTask<AWSAPIGatewayResponse *> *)invoke:(AWSAPIGatewayRequest *)apiRequest
+                         responseDataHandler:(void (^)(NSData *data))responseDataHandler {
     
     if(!apiRequest) {
         @throw [NSException exceptionWithName:NSInternalInconsistencyException
@@ -109,54 +139,21 @@ static int defaultChunkSize = 1024;
         if (apiRequest.HTTPBody != nil) {
             
             if ([apiRequest.HTTPBody isKindOfClass:[NSString class]]) {
-                NSString *body = (NSString *)apiRequest.HTTPBody;
-                NSDictionary *bodyParameters = [NSJSONSerialization JSONObjectWithData:[body dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
-                request.HTTPBody = [NSJSONSerialization dataWithJSONObject:bodyParameters
-                                                                   options:0
-                                                                     error:&error];
+                request.HTTPBody = [(NSString *)apiRequest.HTTPBody dataUsingEncoding:NSUTF8StringEncoding];
             } else if ([apiRequest.HTTPBody isKindOfClass:[NSDictionary class]]) {
                 request.HTTPBody = [NSJSONSerialization dataWithJSONObject:apiRequest.HTTPBody
                                                                    options:0
                                                                      error:&error];
             } else if ([apiRequest.HTTPBody isKindOfClass:[NSInputStream class]]) {
-                
-                NSInputStream *iStream = (NSInputStream *)apiRequest.HTTPBody;
-                NSOutputStream *oStream = [[NSOutputStream alloc] initToMemory];
-                [iStream open];
-                [oStream open];
-                
-                int len = defaultChunkSize;
-                uint8_t buf[len];
-                
-                while (YES) {
-                    if ([oStream hasSpaceAvailable]) {
-                        NSInteger bytesRead = [iStream read:buf maxLength:len];
-                        
-                        if ([oStream write:(const uint8_t *)buf maxLength:bytesRead] == -1) {
-                            @throw [NSException exceptionWithName:NSInternalInconsistencyException
-                                                           reason:[NSString stringWithFormat:@"Error occurred while writing input stream to output stream."]
-                                                         userInfo:nil];
-                            break;
-                        }
-                        if (defaultChunkSize != bytesRead) {
-                            break;
-                        }
-                    }
-                }
-                
-                NSData *data = [oStream propertyForKey: NSStreamDataWrittenToMemoryStreamKey];
-                if (!data) {
-                    AWSDDLogVerbose(@"No data written to memory!");
-                } else {
-                    request.HTTPBody = data;
-                }
-                [oStream close];
-                oStream = nil;
+                // The stream is read by NSURLSession as the request is sent, so it is never held in memory. It is
+                // signed as an unsigned payload, since hashing it would read it twice.
+                request.HTTPBodyStream = apiRequest.HTTPBody;
+                [request setValue:@"UNSIGNED-PAYLOAD" forHTTPHeaderField:@"x-amz-content-sha256"];
             } else {
                 request.HTTPBody = apiRequest.HTTPBody;
             }
             
-            if (!request.HTTPBody && ![apiRequest.HTTPBody isKindOfClass:[NSInputStream class]]) {
+            if (!request.HTTPBody && !request.HTTPBodyStream) {
                 AWSDDLogError(@"Failed to set a request body. %@", error);
             }
         }
@@ -202,9 +199,20 @@ static int defaultChunkSize = 1024;
             }
         };
         AWSDDLogVerbose(@"%@",request);
-        NSURLSessionDataTask *sessionTask = [self.session dataTaskWithRequest:request
-                                                            completionHandler:completionHandler];
-        [sessionTask resume];
+        if (responseDataHandler) {
+            AWSAPIGatewayStreamingTask *streamingTask = [AWSAPIGatewayStreamingTask new];
+            streamingTask.responseDataHandler = responseDataHandler;
+            streamingTask.completionSource = completionSource;
+
+            NSURLSessionDataTask *sessionTask = [self.streamingSession dataTaskWithRequest:request];
+            [(AWSAPIGatewaySessionDelegate *)self.streamingSession.delegate addStreamingTask:streamingTask
+                                                                              forSessionTask:sessionTask];
+            [sessionTask resume];
+        } else {
+            NSURLSessionDataTask *sessionTask = [self.session dataTaskWithRequest:request
+                                                                completionHandler:completionHandler];
+            [sessionTask resume];
+        }
         
         return completionSource.task;
     }];
@@ -429,3 +437,67 @@ static int defaultChunkSize = 1024;
 }
 
 @end
+
+@implementation AWSAPIGatewaySessionDelegate {
+    NSMutableDictionary<NSNumber *, AWSAPIGatewayStreamingTask *> *_streamingTasks;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _streamingTasks = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)addStreamingTask:(AWSAPIGatewayStreamingTask *)streamingTask forSessionTask:(NSURLSessionTask *)sessionTask {
+    @synchronized(_streamingTasks) {
+        _streamingTasks[@(sessionTask.taskIdentifier)] = streamingTask;
+    }
+}
+
+- (AWSAPIGatewayStreamingTask *)streamingTaskForSessionTask:(NSURLSessionTask *)sessionTask {
+    @synchronized(_streamingTasks) {
+        return _streamingTasks[@(sessionTask.taskIdentifier)];
+    }
+}
+
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session
+          dataTask:(NSURLSessionDataTask *)dataTask
+didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
+    [self streamingTaskForSessionTask:dataTask].response = response;
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession *)session
+          dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveData:(NSData *)data {
+    AWSAPIGatewayStreamingTask *streamingTask = [self streamingTaskForSessionTask:dataTask];
+    if (streamingTask.responseDataHandler) {
+        streamingTask.responseDataHandler(data);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session
+              task:(NSURLSessionTask *)task
+didCompleteWithError:(NSError *)error {
+    AWSAPIGatewayStreamingTask *streamingTask = nil;
+    @synchronized(_streamingTasks) {
+        streamingTask = _streamingTasks[@(task.taskIdentifier)];
+        [_streamingTasks removeObjectForKey:@(task.taskIdentifier)];
+    }
+
+    if (error) {
+        [streamingTask.completionSource setError:error];
+        return;
+    }
+    NSHTTPURLResponse *HTTPResponse = (NSHTTPURLResponse *)streamingTask.response;
+    [streamingTask.completionSource setResult:[[AWSAPIGatewayResponse alloc] initWithHeaders:HTTPResponse.allHeaderFields
+                                                                                responseData:nil
+                                                                         NSURLResponseObject:HTTPResponse
+                                                                                  statusCode:HTTPResponse.statusCode]];
+}
+
+@end
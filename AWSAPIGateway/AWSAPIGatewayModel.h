@@ -30,7 +30,7 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param URLString        The path to be invoked(E.g. : /cars)
  *  @param queryParameters  The query string parameters for the invocation request
  *  @param headerParameters The header parameters for the request
- *  @param HTTPBody         The Http body for the request (Could be of type NSString, NSData, NSInputStream)
+ *  @param HTTPBody         The Http body for the request (Could be of type NSString, NSData, NSDictionary, NSInputStream). Strings are sent as UTF-8 and dictionaries as JSON. An NSInputStream is read as the request is sent; set a Content-Length header if its length is known, otherwise the body is sent with chunked transfer encoding. Streamed bodies are signed with an unsigned payload.
  *
  *  @return An instance of `AWSAPIGateway`
  */
@@ -19,10 +19,70 @@
 
 @interface AWSAPIGatewayClient()
 
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) NSURLSession *streamingSession;
+
 - (NSURL *)requestURL:(NSString *)URLString query:(NSDictionary *)query URLPathComponentsDictionary:(NSDictionary *)URLPathComponentsDictionary;
 
 @end
 
+static const NSUInteger AWSAPIGatewayTestResponseChunkLength = 64 * 1024;
+
+static NSData *AWSAPIGatewayTestReceivedBody = nil;
+static NSDictionary *AWSAPIGatewayTestReceivedHeaders = nil;
+static NSUInteger AWSAPIGatewayTestResponseChunkCount = 0;
+
+// Answers every request in place of the network. It records the body and headers it was sent and responds with
+// `AWSAPIGatewayTestResponseChunkCount` chunks of data.
+@interface AWSAPIGatewayTestURLProtocol : NSURLProtocol
+
+@end
+
+@implementation AWSAPIGatewayTestURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    NSMutableData *body = [NSMutableData new];
+    if (self.request.HTTPBodyStream) {
+        NSInputStream *stream = self.request.HTTPBodyStream;
+        uint8_t buffer[4096];
+        [stream open];
+        NSInteger length;
+        while ((length = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+            [body appendBytes:buffer length:length];
+        }
+        [stream close];
+    } else if (self.request.HTTPBody) {
+        [body appendData:self.request.HTTPBody];
+    }
+    AWSAPIGatewayTestReceivedBody = body;
+    AWSAPIGatewayTestReceivedHeaders = self.request.allHTTPHeaderFields;
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{@"Content-Type" : @"application/octet-stream"}];
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    NSMutableData *chunk = [NSMutableData dataWithLength:AWSAPIGatewayTestResponseChunkLength];
+    for (NSUInteger i = 0; i < AWSAPIGatewayTestResponseChunkCount; i++) {
+        memset(chunk.mutableBytes, (int)i, chunk.length);
+        [self.client URLProtocol:self didLoadData:[chunk copy]];
+    }
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
+
 @interface AWSAPIGatewayUnitTests : XCTestCase
 
 @end
@@ -31,7 +91,36 @@
 
 - (void)setUp {
     [super setUp];
-    // Put setup code here. This method is called before the invocation of each test method in the class.
+    AWSAPIGatewayTestReceivedBody = nil;
+    AWSAPIGatewayTestReceivedHeaders = nil;
+    AWSAPIGatewayTestResponseChunkCount = 0;
+}
+
+- (AWSAPIGatewayClient *)clientWithSigner:(BOOL)signs {
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:credentialsProvider];
+    configuration.baseURL = [NSURL URLWithString:@"https://example.execute-api.us-east-1.amazonaws.com/prod"];
+    if (signs) {
+        AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        serviceName:@"execute-api"
+                                                                URL:configuration.baseURL];
+        AWSSignatureV4Signer *signer = [[AWSSignatureV4Signer alloc] initWithCredentialsProvider:credentialsProvider
+                                                                                        endpoint:endpoint];
+        configuration.requestInterceptors = @[[AWSNetworkingRequestInterceptor new], signer];
+    }
+
+    AWSAPIGatewayClient *client = [AWSAPIGatewayClient new];
+    client.configuration = configuration;
+
+    NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    sessionConfiguration.protocolClasses = @[[AWSAPIGatewayTestURLProtocol class]];
+    client.session = [NSURLSession sessionWithConfiguration:sessionConfiguration];
+    client.streamingSession = [NSURLSession sessionWithConfiguration:sessionConfiguration
+                                                            delegate:client.streamingSession.delegate
+                                                       delegateQueue:nil];
+    return client;
 }
 
 - (void)tearDown {
@@ -56,4 +145,63 @@
     XCTAssertEqualObjects([URL path], @"/user/my-user-id/action/my-action-id");
 }
 
+- (void)testStringBodyIsSentUnchanged {
+    AWSAPIGatewayClient *client = [self clientWithSigner:NO];
+    for (NSString *body in @[@"{ \"name\" : \"value\" }", @"not JSON"]) {
+        AWSAPIGatewayRequest *request = [[AWSAPIGatewayRequest alloc] initWithHTTPMethod:@"POST"
+                                                                               URLString:@"/items"
+                                                                         queryParameters:nil
+                                                                        headerParameters:nil
+                                                                                HTTPBody:body];
+        AWSTask *task = [client invoke:request];
+        [task waitUntilFinished];
+
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects([[NSString alloc] initWithData:AWSAPIGatewayTestReceivedBody encoding:NSUTF8StringEncoding], body);
+    }
+}
+
+- (void)testStreamBodyIsStreamedWithUnsignedPayload {
+    AWSAPIGatewayClient *client = [self clientWithSigner:YES];
+    NSMutableData *data = [NSMutableData dataWithLength:5 * 1024 * 1024];
+    memset(data.mutableBytes, 'a', data.length);
+    AWSAPIGatewayRequest *request = [[AWSAPIGatewayRequest alloc] initWithHTTPMethod:@"PUT"
+                                                                           URLString:@"/upload"
+                                                                     queryParameters:nil
+                                                                    headerParameters:@{@"Content-Type" : @"application/octet-stream",
+                                                                                       @"Content-Length" : [@(data.length) stringValue]}
+                                                                            HTTPBody:[NSInputStream inputStreamWithData:data]];
+    AWSTask *task = [client invoke:request];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(AWSAPIGatewayTestReceivedBody, data);
+    XCTAssertEqualObjects(AWSAPIGatewayTestReceivedHeaders[@"x-amz-content-sha256"], @"UNSIGNED-PAYLOAD");
+    XCTAssertTrue([AWSAPIGatewayTestReceivedHeaders[@"Authorization"] containsString:@"x-amz-content-sha256"]);
+}
+
+- (void)testResponseDataHandlerReceivesBodyAsItArrives {
+    AWSAPIGatewayClient *client = [self clientWithSigner:NO];
+    AWSAPIGatewayTestResponseChunkCount = 8;
+    AWSAPIGatewayRequest *request = [[AWSAPIGatewayRequest alloc] initWithHTTPMethod:@"GET"
+                                                                           URLString:@"/download"
+                                                                     queryParameters:nil
+                                                                    headerParameters:nil
+                                                                            HTTPBody:nil];
+    __block NSUInteger handlerCallCount = 0;
+    __block NSUInteger byteCount = 0;
+    AWSTask<AWSAPIGatewayResponse *> *task = [client invoke:request
+                                        responseDataHandler:^(NSData *data) {
+        handlerCallCount++;
+        byteCount += data.length;
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertEqual(task.result.statusCode, 200);
+    XCTAssertNil(task.result.responseData);
+    XCTAssertGreaterThan(handlerCallCount, 1);
+    XCTAssertEqual(byteCount, 8 * AWSAPIGatewayTestResponseChunkLength);
+}
+
 @end
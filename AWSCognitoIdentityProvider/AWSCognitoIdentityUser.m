@@ -8,6 +8,7 @@
 #import "AWSCognitoIdentityProvider.h"
 #import "AWSCognitoIdentityUser_Internal.h"
 #import "AWSCognitoIdentityUserPool_Internal.h"
+#import "AWSCognitoIdentityUserSessionCache.h"
 #import "AWSCognitoIdentityProviderSrpHelper.h"
 #import "AWSJKBigInteger.h"
 #import "NSData+AWSCognitoIdentityProvider.h"
@@ -215,9 +216,21 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
  Get a session
  */
 -(AWSTask<AWSCognitoIdentityUserSession*> *) getSession {
-    
+    NSString * keyChainNamespace = [self keyChainNamespaceClientId];
+    AWSCognitoIdentityUserSessionCache * sessionCache = self.pool.sessionCache;
+
+    // Sessions already read or refreshed in this process are served from memory.
+    BOOL needsRefresh = NO;
+    AWSCognitoIdentityUserSession * cachedSession = [sessionCache validSessionForKey:keyChainNamespace needsRefresh:&needsRefresh];
+    if (cachedSession) {
+        self.confirmedStatus = AWSCognitoIdentityUserStatusConfirmed;
+        if (needsRefresh) {
+            [self refreshSessionAhead:cachedSession.refreshToken.tokenString ?: [self refreshTokenFromKeyChain:keyChainNamespace]];
+        }
+        return [AWSTask taskWithResult:cachedSession];
+    }
+
     //check to see if we have valid tokens
-    __block NSString * keyChainNamespace = [self keyChainNamespaceClientId];
     NSString * expirationTokenKey = [self keyChainKey:keyChainNamespace key:AWSCognitoIdentityUserTokenExpiration];
     NSString * expirationDate = self.pool.keychain[expirationTokenKey];
     
@@ -249,55 +262,94 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
         if(session
            && [self isSessionValid:session]
            && [expiration compare:[NSDate dateWithTimeIntervalSinceNow:2 * 60]] == NSOrderedDescending) {
+            [sessionCache setSession:session forKey:keyChainNamespace];
+            [sessionCache validSessionForKey:keyChainNamespace needsRefresh:&needsRefresh];
+            if (needsRefresh) {
+                [self refreshSessionAhead:refreshToken];
+            }
             return [AWSTask taskWithResult:session];
         }
         //else refresh it using the refresh token
         else if(refreshToken){
-            AWSCognitoIdentityProviderInitiateAuthRequest * request = [AWSCognitoIdentityProviderInitiateAuthRequest new];
-            request.authFlow = AWSCognitoIdentityProviderAuthFlowTypeRefreshTokenAuth;
-            request.clientId = self.pool.userPoolConfiguration.clientId;
-            request.analyticsMetadata = [self.pool analyticsMetadata];
-            request.userContextData = [self.pool userContextData:self.username deviceId: [self asfDeviceId]];
-            
-            NSMutableDictionary * authParameters = [[NSMutableDictionary alloc] initWithDictionary:@{@"REFRESH_TOKEN" : refreshToken}];
-            
-            //refresh token secret hash is actually client secret for this api, set it if it is supplied
-            if(self.pool.userPoolConfiguration.clientSecret != nil){
-                [authParameters setObject:self.pool.userPoolConfiguration.clientSecret forKey:@"SECRET_HASH"];
-            }
-            
-            [self addDeviceKey:authParameters];
-            
-            request.authParameters = authParameters;
-            return [[self.pool.client initiateAuth:request] continueWithBlock:^id _Nullable(AWSTask<AWSCognitoIdentityProviderInitiateAuthResponse *> * _Nonnull task) {
-                if(task.error){
-                    //If this token is no longer valid, fall back on interactive auth.
-                    if(task.error.code == AWSCognitoIdentityProviderErrorNotAuthorized) {
-                        return [self interactiveAuth];
-                    } else {
-                        return task;
-                    }
+            return [[self refreshSession:refreshToken] continueWithBlock:^id _Nullable(AWSTask<AWSCognitoIdentityUserSession *> * _Nonnull task) {
+                //If this token is no longer valid, fall back on interactive auth.
+                if(task.error && task.error.code == AWSCognitoIdentityProviderErrorNotAuthorized) {
+                    return [self interactiveAuth];
                 }
-                
-                AWSCognitoIdentityProviderInitiateAuthResponse *response = task.result;
-                AWSCognitoIdentityProviderAuthenticationResultType *authResult = response.authenticationResult;
-                /** Check to see if refreshToken is received in the response.
-                 If not, load it from the keychain.
-                 */
-                NSString * refreshToken = authResult.refreshToken;
-                if (refreshToken == nil){
-                    NSString * keyChainNamespace = [self keyChainNamespaceClientId];
-                    refreshToken = [self refreshTokenFromKeyChain:keyChainNamespace];
-                }
-                AWSCognitoIdentityUserSession * session = [[AWSCognitoIdentityUserSession alloc] initWithIdToken: authResult.idToken accessToken:authResult.accessToken refreshToken:refreshToken expiresIn:authResult.expiresIn];
-                [self updateUsernameAndPersistTokens:session];
-                return [AWSTask taskWithResult:session];
+                return task;
             }];
         }
     }
     return [self setConfirmationStatus: [self interactiveAuth]];
 }
 
+/**
+ Refresh the session using the refresh token. Callers that ask while a refresh of this user is in flight get that
+ refresh instead of starting another one.
+ */
+- (AWSTask<AWSCognitoIdentityUserSession*>*) refreshSession:(NSString *) refreshToken {
+    return [self.pool.sessionCache refreshSessionForKey:[self keyChainNamespaceClientId] usingBlock:^AWSTask<AWSCognitoIdentityUserSession *> * {
+        NSUInteger generation = [self.pool.sessionCache generationForKey:[self keyChainNamespaceClientId]];
+        AWSCognitoIdentityProviderInitiateAuthRequest * request = [AWSCognitoIdentityProviderInitiateAuthRequest new];
+        request.authFlow = AWSCognitoIdentityProviderAuthFlowTypeRefreshTokenAuth;
+        request.clientId = self.pool.userPoolConfiguration.clientId;
+        request.analyticsMetadata = [self.pool analyticsMetadata];
+        request.userContextData = [self.pool userContextData:self.username deviceId: [self asfDeviceId]];
+        
+        NSMutableDictionary * authParameters = [[NSMutableDictionary alloc] initWithDictionary:@{@"REFRESH_TOKEN" : refreshToken}];
+        
+        //refresh token secret hash is actually client secret for this api, set it if it is supplied
+        if(self.pool.userPoolConfiguration.clientSecret != nil){
+            [authParameters setObject:self.pool.userPoolConfiguration.clientSecret forKey:@"SECRET_HASH"];
+        }
+        
+        [self addDeviceKey:authParameters];
+        
+        request.authParameters = authParameters;
+        return [[self.pool.client initiateAuth:request] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCognitoIdentityProviderInitiateAuthResponse *> * _Nonnull task) {
+            AWSCognitoIdentityProviderInitiateAuthResponse *response = task.result;
+            AWSCognitoIdentityProviderAuthenticationResultType *authResult = response.authenticationResult;
+            /** Check to see if refreshToken is received in the response.
+             If not, load it from the keychain.
+             */
+            NSString * refreshToken = authResult.refreshToken;
+            if (refreshToken == nil){
+                NSString * keyChainNamespace = [self keyChainNamespaceClientId];
+                refreshToken = [self refreshTokenFromKeyChain:keyChainNamespace];
+            }
+            AWSCognitoIdentityUserSession * session = [[AWSCognitoIdentityUserSession alloc] initWithIdToken: authResult.idToken accessToken:authResult.accessToken refreshToken:refreshToken expiresIn:authResult.expiresIn];
+            //The user signed out or the session was cleared while the refresh was in flight, so its tokens are dropped.
+            BOOL persisted = [self.pool.sessionCache performIfGeneration:generation
+                                                                  forKey:[self keyChainNamespaceClientId]
+                                                                   block:^{
+                [self updateUsernameAndPersistTokens:session];
+            }];
+            if (!persisted) {
+                return [AWSTask taskWithError:[NSError errorWithDomain:AWSCognitoIdentityProviderErrorDomain
+                                                                  code:AWSCognitoIdentityProviderClientErrorSessionInvalidated
+                                                              userInfo:@{NSLocalizedDescriptionKey: @"The session was signed out or cleared while it was being refreshed."}]];
+            }
+            return [AWSTask taskWithResult:session];
+        }];
+    }];
+}
+
+/**
+ Start refreshing a session that is still valid but close to the 2 minute window, so that callers keep getting a
+ valid session without waiting for the refresh. Errors are left for the next getSession after the session expires.
+ */
+- (void) refreshSessionAhead:(NSString *) refreshToken {
+    if (refreshToken == nil) {
+        return;
+    }
+    [[self refreshSession:refreshToken] continueWithBlock:^id _Nullable(AWSTask<AWSCognitoIdentityUserSession *> * _Nonnull task) {
+        if (task.error) {
+            AWSDDLogDebug(@"Refreshing the session ahead of its expiration failed: %@", task.error);
+        }
+        return nil;
+    }];
+}
+
 - (AWSTask<AWSCognitoIdentityUserSession*>*) getSession:(NSString *) username
                                                password:(NSString *) password
                                          validationData:(NSArray<AWSCognitoIdentityUserAttributeType*>*) validationData
@@ -1446,6 +1498,7 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
 
 -(void) signOut {
     if(self.username){
+        [self.pool.sessionCache invalidateRefreshesForKey:[self keyChainNamespaceClientId]];
         NSArray *keys = self.pool.keychain.allKeys;
         NSString *keyChainPrefix = [[self keyChainNamespaceClientId] stringByAppendingString:@"."];
         for (NSString *key in keys) {
@@ -1454,6 +1507,7 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
                 [self.pool.keychain removeItemForKey:key];
             }
         }
+        [self.pool.sessionCache removeSessionForKey:[self keyChainNamespaceClientId]];
     }
 }
 
@@ -1465,10 +1519,12 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
 -(void) clearSession{
     if(self.username){
         NSString * keyChainNamespace = [self keyChainNamespaceClientId];
+        [self.pool.sessionCache invalidateRefreshesForKey:keyChainNamespace];
         NSString * idTokenKey = [self keyChainKey:keyChainNamespace key:AWSCognitoIdentityUserIdToken];
         NSString * accessTokenKey = [self keyChainKey:keyChainNamespace key:AWSCognitoIdentityUserAccessToken];
         [self.pool.keychain removeItemForKey:idTokenKey];
         [self.pool.keychain removeItemForKey:accessTokenKey];
+        [self.pool.sessionCache removeSessionForKey:keyChainNamespace];
     }
 }
 
@@ -1610,6 +1666,10 @@ static const NSString * AWSCognitoIdentityUserUserAttributePrefix = @"userAttrib
         NSString * expirationTokenKey = [self keyChainKey:keyChainNamespace key:AWSCognitoIdentityUserTokenExpiration];
         self.pool.keychain[expirationTokenKey] = [session.expirationTime aws_stringValue:AWSDateISO8601DateFormat1];
     }
+    //Write through to the in-memory copy once the keychain has the session.
+    if(session.accessToken && session.expirationTime){
+        [self.pool.sessionCache setSession:session forKey:keyChainNamespace];
+    }
 }
 
 - (void) persistDevice:(NSString *) deviceKey deviceSecret: (NSString *) deviceSecret  deviceGroup: (NSString *) deviceGroup {
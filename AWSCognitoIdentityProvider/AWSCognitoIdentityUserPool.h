@@ -345,6 +345,7 @@ shouldProvideCognitoValidationData:(BOOL)shouldProvideCognitoValidationData
  <li>AWSCognitoIdentityProviderClientErrorInvalidAuthenticationDelegate - Necessary authentication delegate isn't set.</li>
  <li>AWSCognitoIdentityProviderClientErrorCustomAuthenticationNotSupported - Custom authentication is not supported by this SDK.</li>
  <li>AWSCognitoIdentityProviderClientErrorDeviceNotTracked - This device does not have an id, either it was never tracked or previously forgotten.</li>
+ <li>AWSCognitoIdentityProviderClientErrorSessionInvalidated - The user signed out or the session was cleared while it was being refreshed.</li>
  </ul>
  */
 typedef NS_ENUM(NSInteger, AWSCognitoIdentityClientErrorType) {
@@ -352,6 +353,7 @@ typedef NS_ENUM(NSInteger, AWSCognitoIdentityClientErrorType) {
     AWSCognitoIdentityProviderClientErrorInvalidAuthenticationDelegate = -1000,
     AWSCognitoIdentityProviderClientErrorCustomAuthenticationNotSupported = -2000,
     AWSCognitoIdentityProviderClientErrorDeviceNotTracked = -3000,
+    AWSCognitoIdentityProviderClientErrorSessionInvalidated = -4000,
 };
 
 @interface AWSCognitoIdentityUserPoolSignUpResponse : AWSCognitoIdentityProviderSignUpResponse
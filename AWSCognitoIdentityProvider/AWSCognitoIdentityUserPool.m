@@ -8,6 +8,7 @@
 #import "AWSCognitoIdentityProvider.h"
 #import "AWSCognitoIdentityUser_Internal.h"
 #import "AWSCognitoIdentityUserPool_Internal.h"
+#import "AWSCognitoIdentityUserSessionCache.h"
 #import <AWSCore/AWSUICKeyChainStore.h>
 #import <CommonCrypto/CommonHMAC.h>
 #import "NSData+AWSCognitoIdentityProvider.h"
@@ -171,6 +172,7 @@ static NSString *const AWSPinpointContextKeychainUniqueIdKey = @"com.amazonaws.A
         _userPoolConfiguration = userPoolConfiguration;
 
         _keychain = [AWSUICKeyChainStore keyChainStoreWithService:[NSString stringWithFormat:@"%@.%@", [NSBundle mainBundle].bundleIdentifier, [AWSCognitoIdentityUserPool class]]];
+        _sessionCache = [AWSCognitoIdentityUserSessionCache sharedCache];
         
         
         //If Pinpoint is setup, get the endpoint or create one.
@@ -285,11 +287,13 @@ static NSString *const AWSPinpointContextKeychainUniqueIdKey = @"com.amazonaws.A
 - (void) clearAll {
     NSArray *keys = self.keychain.allKeys;
     NSString *keyChainPrefix = [NSString stringWithFormat:@"%@.", self.userPoolConfiguration.clientId];
+    [self.sessionCache invalidateRefreshesWithPrefix:keyChainPrefix];
     for (NSString *key in keys) {
         if([key hasPrefix:keyChainPrefix]){
             [self.keychain removeItemForKey:key];
         }
     }
+    [self.sessionCache removeSessionsWithPrefix:keyChainPrefix];
 }
 
 #pragma mark identity provider
@@ -95,6 +95,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (AWSJKBigInteger*) generatePrivateABigInt:(AWSJKBigInteger*)N;
 + (AWSJKBigInteger*) generatePublicABigInt:(AWSJKBigInteger*)privateA N:(AWSJKBigInteger*)N g:(AWSJKBigInteger*)g;
+/// g^exponent % N, using precomputed powers of g when N and g are the default SRP group's.
++ (nullable AWSJKBigInteger*) gPow:(AWSJKBigInteger*)exponent N:(AWSJKBigInteger*)N g:(AWSJKBigInteger*)g;
 + (NSString*) generateDateString:(NSDate *)date;
 
 + (AWSJKBigInteger*) hashSignedBigInts:(NSArray*)bigInts;
@@ -9,6 +9,7 @@
 #import "AWSCognitoIdentityProviderHKDF.h"
 #import "AWSJKBigInteger.h"
 #import <AWSCore/AWSCocoaLumberjack.h>
+#import <AWSCore/AWSDateFormatting.h>
 #import <CommonCrypto/CommonCrypto.h>
 #import <CommonCrypto/CommonKeyDerivation.h>
 #import <CommonCrypto/CommonDigest.h>
@@ -23,15 +24,59 @@ AWSJKBigInteger* finalizeSignedBigIntHash(CC_SHA256_CTX *ctx);
 
 static NSString* N_IN_HEX = @"FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129024E088A67CC74020BBEA63B139B22514A08798E3404DDEF9519B3CD3A431B302B0A6DF25F14374FE1356D6D51C245E485B576625E7EC6F44C42E9A637ED6B0BFF5CB6F406B7EDEE386BFB5A899FA5AE9F24117C4B1FE649286651ECE45B3DC2007CB8A163BF0598DA48361C55D39A69163FA8FD24CF5F83655D23DCA3AD961C62F356208552BB9ED529077096966D670C354E4ABC9804F1746C08CA18217C32905E462E36CE3BE39E772C180E86039B2783A2EC07A28FB5C55DF06F4C52C9DE2BCBF6955817183995497CEA956AE515D2261898FA051015728E5A8AAAC42DAD33170D04507A33A85521ABDF1CBA64ECFB850458DBEF0A8AEA71575D060C7DB3970F85A6E1E4C7ABF5AE8CDB0933D71E8C94E04A25619DCEE3D2261AD2EE6BF12FFA06D98A0864D87602733EC86A64521F2B18177B200CBBE117577A615D6C770988C0BAD946E208E24FA074E5AB3143DB5BFCE0FD108E4B82D120A93AD2CAFFFFFFFFFFFFFFFF";
 
+// Exponents raised to g are either a private A or an x, both at most 256 bits.
+static const int AWSCognitoIdentityProviderSrpFixedBaseExponentBits = 256;
+static const int AWSCognitoIdentityProviderSrpFixedBaseWindowBits = 4;
+
+static AWSJKBigInteger *AWSCognitoIdentityProviderSrpGroupN = nil;
+static AWSJKBigInteger *AWSCognitoIdentityProviderSrpGroupG = nil;
+static AWSJKBigInteger *AWSCognitoIdentityProviderSrpGroupK = nil;
+static aws_mp_fixed_base AWSCognitoIdentityProviderSrpGroupGPowers;
+static BOOL AWSCognitoIdentityProviderSrpGroupGPowersAvailable = NO;
+
+/**
+ The SRP group never changes, so N, g, k and the precomputed powers of g are built once per process.
+ */
+static void AWSCognitoIdentityProviderSrpGroupSetUp(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        AWSCognitoIdentityProviderSrpGroupN = [[AWSJKBigInteger alloc] initWithString:N_IN_HEX andRadix:16];
+        AWSCognitoIdentityProviderSrpGroupG = [[AWSJKBigInteger alloc] initWithUnsignedLong:2l];
+        AWSCognitoIdentityProviderSrpGroupK = [[[AWSCognitoIdentityProviderSrpCommonState alloc] initN:AWSCognitoIdentityProviderSrpGroupN
+                                                                                                     g:AWSCognitoIdentityProviderSrpGroupG] k];
+        int err = aws_mp_fixed_base_init(&AWSCognitoIdentityProviderSrpGroupGPowers,
+                                         [AWSCognitoIdentityProviderSrpGroupG value],
+                                         [AWSCognitoIdentityProviderSrpGroupN value],
+                                         AWSCognitoIdentityProviderSrpFixedBaseExponentBits,
+                                         AWSCognitoIdentityProviderSrpFixedBaseWindowBits);
+        AWSCognitoIdentityProviderSrpGroupGPowersAvailable = (err == AWS_MP_OKAY);
+        if (!AWSCognitoIdentityProviderSrpGroupGPowersAvailable) {
+            AWSDDLogWarn(@"Failed to precompute SRP generator powers: %s", aws_mp_error_to_string(err));
+        }
+    });
+}
+
+/**
+ result = g^exponent % N, through the precomputed powers when g and N are the SRP group's.
+ */
+static int AWSCognitoIdentityProviderSrpGPow(aws_mp_int *g, aws_mp_int *exponent, aws_mp_int *N, aws_mp_int *result) {
+    AWSCognitoIdentityProviderSrpGroupSetUp();
+    if (AWSCognitoIdentityProviderSrpGroupGPowersAvailable
+        && aws_mp_cmp(g, [AWSCognitoIdentityProviderSrpGroupG value]) == AWS_MP_EQ
+        && aws_mp_cmp(N, [AWSCognitoIdentityProviderSrpGroupN value]) == AWS_MP_EQ) {
+        return aws_mp_exptmod_fixed_base(&AWSCognitoIdentityProviderSrpGroupGPowers, exponent, result);
+    }
+    return aws_mp_exptmod(g, exponent, N, result);
+}
+
 #pragma mark - Srp State
 @implementation AWSCognitoIdentityProviderSrpCommonState
 - (instancetype)init {
     if (self = [super init]) {
-            self.N = [[AWSJKBigInteger alloc] initWithString:N_IN_HEX
-                                               andRadix:16];
-
-            self.g = [[AWSJKBigInteger alloc] initWithUnsignedLong:2l];
-            self.k = [self calculateK:self.N g:self.g];
+        AWSCognitoIdentityProviderSrpGroupSetUp();
+        self.N = AWSCognitoIdentityProviderSrpGroupN;
+        self.g = AWSCognitoIdentityProviderSrpGroupG;
+        self.k = AWSCognitoIdentityProviderSrpGroupK;
     }
     return self;
 }
@@ -183,12 +228,10 @@ static NSString* N_IN_HEX = @"FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129
                               password:password
                               salt:self.salt];
 
-        AWSJKBigInteger *N = [[AWSJKBigInteger alloc] initWithString:N_IN_HEX
-                                       andRadix:16];
-        AWSJKBigInteger *g = [[AWSJKBigInteger alloc] initWithUnsignedLong:2l];
+        AWSCognitoIdentityProviderSrpCommonState *commonState = [[AWSCognitoIdentityProviderSrpCommonState alloc] init];
         
         //calculate v
-        self.v = [g pow:x andMod:N];
+        self.v = [AWSCognitoIdentityProviderSrpHelper gPow:x N:commonState.N g:commonState.g];
     }
     return self;
 }
@@ -272,27 +315,49 @@ static NSString* N_IN_HEX = @"FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129
     AWSJKBigInteger *k = self.commonState.k;
     AWSJKBigInteger *g = self.commonState.g;
     AWSJKBigInteger *N = self.commonState.N;
-
     AWSJKBigInteger *a = self.clientState.privateA;
-    AWSJKBigInteger *exp = [a add:[self.u multiply:self.x]];
-    AWSJKBigInteger *base = [B subtract:[k multiply:[g pow:self.x andMod:N]]];
 
-    //Need this for negative base #s
-    base = [AWSCognitoIdentityProviderSrpHelper mod:base divisor:N];
+    // The intermediate values stay in LibTomMath integers; only S is wrapped.
+    aws_mp_int gx, base, exp, S;
+    aws_mp_init_multi(&gx, &base, &exp, &S, NULL);
 
-    AWSJKBigInteger *S = [base pow:exp andMod:N];
-    S = [AWSCognitoIdentityProviderSrpHelper mod:S divisor:N];
-    
-    return S;
+    // base = (B - k * g^x) % N, kept non-negative
+    int err = AWSCognitoIdentityProviderSrpGPow([g value], [self.x value], [N value], &gx);
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_mul([k value], &gx, &base);
+    }
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_sub([B value], &base, &base);
+    }
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_mod(&base, [N value], &base);
+    }
+    // exp = a + u * x
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_mul([self.u value], [self.x value], &exp);
+    }
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_add([a value], &exp, &exp);
+    }
+    if (err == AWS_MP_OKAY) {
+        err = aws_mp_exptmod(&base, &exp, [N value], &S);
+    }
+
+    AWSJKBigInteger *result = nil;
+    if (err == AWS_MP_OKAY) {
+        result = [[AWSJKBigInteger alloc] initWithValue:&S];
+    } else {
+        AWSDDLogError(@"Failed to calculate S: %s", aws_mp_error_to_string(err));
+    }
+    aws_mp_clear_multi(&gx, &base, &exp, &S, NULL);
+
+    return result;
 }
 
 + (NSString *)generateDateString:(NSDate *)date {
-    NSTimeZone *timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
-    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-    dateFormatter.timeZone = timeZone;
-    dateFormatter.dateFormat = @"EEE MMM d HH:mm:ss 'UTC' yyyy";
-    dateFormatter.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
-    return [dateFormatter stringFromDate:date];
+    char buffer[AWSDateFormatMaximumLength];
+    size_t length = AWSDateFormatWrite(AWSDateFormatUnixDate, [date timeIntervalSince1970], buffer, sizeof(buffer));
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
 }
 
 + (AWSJKBigInteger*) generatePrivateABigInt:(AWSJKBigInteger*)N {
@@ -301,10 +366,23 @@ static NSString* N_IN_HEX = @"FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129
 }
 
 + (AWSJKBigInteger*) generatePublicABigInt:(AWSJKBigInteger*)privateA N:(AWSJKBigInteger*)N g:(AWSJKBigInteger*)g {
-    AWSJKBigInteger *publicA = [g pow:privateA andMod:N];
+    AWSJKBigInteger *publicA = [self gPow:privateA N:N g:g];
     return publicA;
 }
 
++ (AWSJKBigInteger*) gPow:(AWSJKBigInteger*)exponent N:(AWSJKBigInteger*)N g:(AWSJKBigInteger*)g {
+    aws_mp_int output;
+    aws_mp_init(&output);
+
+    AWSJKBigInteger *result = nil;
+    if (AWSCognitoIdentityProviderSrpGPow([g value], [exponent value], [N value], &output) == AWS_MP_OKAY) {
+        result = [[AWSJKBigInteger alloc] initWithValue:&output];
+    }
+    aws_mp_clear(&output);
+
+    return result;
+}
+
 + (AWSJKBigInteger*) mod:(AWSJKBigInteger*)dividend divisor:(AWSJKBigInteger*) divisor {
     return [[divisor add:[dividend remainder:divisor]] remainder:divisor];
 }
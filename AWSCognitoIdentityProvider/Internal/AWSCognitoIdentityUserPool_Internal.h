@@ -9,9 +9,11 @@
 #import "AWSCognitoIdentityUserPool.h"
 
 @class AWSUICKeyChainStore;
+@class AWSCognitoIdentityUserSessionCache;
 
 @interface AWSCognitoIdentityUserPool()
 @property (nonatomic, strong) AWSUICKeyChainStore * _Nonnull keychain;
+@property (nonatomic, strong) AWSCognitoIdentityUserSessionCache * _Nonnull sessionCache;
 @property (nonatomic, readonly) AWSCognitoIdentityProviderAnalyticsMetadataType * _Nullable analyticsMetadata;
 
 - (NSString * _Nullable) calculateSecretHash: (NSString* _Nonnull) userName;
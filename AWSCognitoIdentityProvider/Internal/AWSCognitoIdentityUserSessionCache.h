@@ -0,0 +1,95 @@
+//
+// Copyright 2014-2020 Amazon.com,
+// Inc. or its affiliates. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSCognitoIdentityUserSession;
+@class AWSTask<__covariant ResultType>;
+
+/**
+ Keeps the sessions of a user pool in memory, keyed by keychain namespace, so that `getSession` does not read and
+ decode the tokens in the keychain on every call. The keychain stays the source of truth: sessions are written to it
+ before they are cached, and removed from the cache whenever they are removed from it.
+
+ It also makes sure that a user has at most one token refresh in flight, and that a refresh which finishes after the
+ user signed out does not store its tokens again. Both are tracked per key, so signing one user out does not affect the
+ refreshes of another.
+ */
+@interface AWSCognitoIdentityUserSessionCache : NSObject
+
+/**
+ The cache shared by every user pool. Pools with the same app client share keychain entries, so they share cached
+ sessions too.
+ */
++ (instancetype)sharedCache;
+
+/**
+ How long before a session stops being returned, which happens 2 minutes before it expires, a refresh is started in
+ the background. Defaults to 3 minutes.
+ */
+@property (atomic, assign) NSTimeInterval refreshAheadInterval;
+
+/**
+ Returns the cached session if it is valid for more than 2 minutes.
+
+ @param needsRefresh Set to YES when the session is close enough to the end of its validity that it should be
+                     refreshed now.
+ */
+- (nullable AWSCognitoIdentityUserSession *)validSessionForKey:(NSString *)key needsRefresh:(nullable BOOL *)needsRefresh;
+
+/**
+ Caches a session. The time it is valid until is computed once here, from the expiration time and the `exp` claims of
+ its access and id tokens.
+ */
+- (void)setSession:(AWSCognitoIdentityUserSession *)session forKey:(NSString *)key;
+
+- (void)removeSessionForKey:(NSString *)key;
+
+/**
+ Incremented by `invalidateRefreshesForKey:`. A refresh of `key` reads it when it starts, and persists its tokens with
+ `performIfGeneration:forKey:block:`.
+ */
+- (NSUInteger)generationForKey:(NSString *)key;
+
+/**
+ Keeps the refreshes of `key` in flight from persisting their tokens, and lets the next caller start a new refresh
+ instead of waiting for one of them. Call it before removing the tokens of `key` from the keychain, so that no refresh
+ can write them back. Refreshes of other keys are not affected.
+ */
+- (void)invalidateRefreshesForKey:(NSString *)key;
+
+/**
+ Calls `invalidateRefreshesForKey:` for every key that starts with `prefix`.
+ */
+- (void)invalidateRefreshesWithPrefix:(NSString *)prefix;
+
+/**
+ Runs `block` unless `invalidateRefreshesForKey:` was called for `key` since `generation` was read.
+ `invalidateRefreshesForKey:` waits for `block` to return. `block` runs under a lock of its own key, not the lock of
+ the cache, so it can write to the keychain without holding up other users.
+
+ @return Whether `block` ran.
+ */
+- (BOOL)performIfGeneration:(NSUInteger)generation forKey:(NSString *)key block:(void (^)(void))block;
+
+/**
+ Removes the sessions whose keys start with `prefix`.
+ */
+- (void)removeSessionsWithPrefix:(NSString *)prefix;
+
+/**
+ Runs `block` to refresh the session of `key`, unless a refresh of that key is already in flight, in which case the
+ caller gets the task of that refresh instead.
+ */
+- (AWSTask<AWSCognitoIdentityUserSession *> *)refreshSessionForKey:(NSString *)key
+                                                        usingBlock:(AWSTask<AWSCognitoIdentityUserSession *> *(^)(void))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
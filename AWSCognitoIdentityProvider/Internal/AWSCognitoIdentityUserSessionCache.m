@@ -0,0 +1,211 @@
+//
+// Copyright 2014-2020 Amazon.com,
+// Inc. or its affiliates. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#import "AWSCognitoIdentityUserSessionCache.h"
+#import "AWSCognitoIdentityUser.h"
+#import <AWSCore/AWSCore.h>
+
+// Sessions are not handed out in the last 2 minutes of their validity, so that callers never get a token which
+// expires right away.
+static const NSTimeInterval AWSCognitoIdentityUserSessionCacheExpiryWindow = 2 * 60;
+
+@interface AWSCognitoIdentityUserSessionCacheEntry : NSObject
+
+@property (nonatomic, strong) AWSCognitoIdentityUserSession *session;
+@property (nonatomic, assign) NSTimeInterval validUntil;
+
+@end
+
+@implementation AWSCognitoIdentityUserSessionCacheEntry
+
+@end
+
+@interface AWSCognitoIdentityUserSessionCache()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSCognitoIdentityUserSessionCacheEntry *> *entries;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSTask<AWSCognitoIdentityUserSession *> *> *refreshTasks;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *generations;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSObject *> *keyLocks;
+
+@end
+
+@implementation AWSCognitoIdentityUserSessionCache
+
++ (instancetype)sharedCache {
+    static AWSCognitoIdentityUserSessionCache *_sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedCache = [AWSCognitoIdentityUserSessionCache new];
+    });
+    return _sharedCache;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _refreshAheadInterval = 3 * 60;
+        _entries = [NSMutableDictionary new];
+        _refreshTasks = [NSMutableDictionary new];
+        _generations = [NSMutableDictionary new];
+        _keyLocks = [NSMutableDictionary new];
+    }
+    return self;
+}
+
++ (NSTimeInterval)expirationOfToken:(AWSCognitoIdentityUserSessionToken *)token {
+    id exp = [token.tokenClaims valueForKey:@"exp"];
+    return exp ? [exp doubleValue] : 0;
+}
+
+- (AWSCognitoIdentityUserSession *)validSessionForKey:(NSString *)key needsRefresh:(BOOL *)needsRefresh {
+    if (needsRefresh) {
+        *needsRefresh = NO;
+    }
+    AWSCognitoIdentityUserSessionCacheEntry *entry = nil;
+    @synchronized(self) {
+        entry = self.entries[key];
+    }
+    if (!entry) {
+        return nil;
+    }
+
+    NSTimeInterval remaining = entry.validUntil - [[NSDate date] timeIntervalSince1970];
+    if (remaining <= 0) {
+        return nil;
+    }
+    if (needsRefresh) {
+        *needsRefresh = remaining <= self.refreshAheadInterval;
+    }
+    return entry.session;
+}
+
+- (void)setSession:(AWSCognitoIdentityUserSession *)session forKey:(NSString *)key {
+    // The session ends at whichever comes first of its expiration time and the expiry of its tokens, since either
+    // token can be given a shorter lifetime in the user pool.
+    NSTimeInterval validUntil = [session.expirationTime timeIntervalSince1970];
+    if (session.accessToken) {
+        validUntil = MIN(validUntil, [AWSCognitoIdentityUserSessionCache expirationOfToken:session.accessToken]);
+    }
+    if (session.idToken) {
+        validUntil = MIN(validUntil, [AWSCognitoIdentityUserSessionCache expirationOfToken:session.idToken]);
+    }
+
+    AWSCognitoIdentityUserSessionCacheEntry *entry = [AWSCognitoIdentityUserSessionCacheEntry new];
+    entry.session = session;
+    entry.validUntil = validUntil - AWSCognitoIdentityUserSessionCacheExpiryWindow;
+    @synchronized(self) {
+        self.entries[key] = entry;
+    }
+}
+
+- (void)removeSessionForKey:(NSString *)key {
+    @synchronized(self) {
+        [self.entries removeObjectForKey:key];
+    }
+}
+
+- (void)removeSessionsWithPrefix:(NSString *)prefix {
+    @synchronized(self) {
+        for (NSString *key in [self.entries allKeys]) {
+            if ([key hasPrefix:prefix]) {
+                [self.entries removeObjectForKey:key];
+            }
+        }
+    }
+}
+
+- (NSUInteger)generationForKey:(NSString *)key {
+    @synchronized(self) {
+        NSNumber *generation = self.generations[key];
+        if (!generation) {
+            // Registered so that `invalidateRefreshesWithPrefix:` finds the key while its first refresh is in flight.
+            generation = @0;
+            self.generations[key] = generation;
+        }
+        return [generation unsignedIntegerValue];
+    }
+}
+
+// Held while a refresh of the key persists its tokens and while its refreshes are invalidated. Always taken before
+// the lock of the cache.
+- (NSObject *)lockForKey:(NSString *)key {
+    @synchronized(self) {
+        NSObject *lock = self.keyLocks[key];
+        if (!lock) {
+            lock = [NSObject new];
+            self.keyLocks[key] = lock;
+        }
+        return lock;
+    }
+}
+
+- (void)invalidateRefreshesForKey:(NSString *)key {
+    @synchronized([self lockForKey:key]) {
+        @synchronized(self) {
+            self.generations[key] = @([self.generations[key] unsignedIntegerValue] + 1);
+            [self.refreshTasks removeObjectForKey:key];
+        }
+    }
+}
+
+- (void)invalidateRefreshesWithPrefix:(NSString *)prefix {
+    NSMutableSet<NSString *> *keys = [NSMutableSet new];
+    @synchronized(self) {
+        for (NSString *key in [[self.generations allKeys] arrayByAddingObjectsFromArray:[self.refreshTasks allKeys]]) {
+            if ([key hasPrefix:prefix]) {
+                [keys addObject:key];
+            }
+        }
+    }
+    for (NSString *key in keys) {
+        [self invalidateRefreshesForKey:key];
+    }
+}
+
+- (BOOL)performIfGeneration:(NSUInteger)generation forKey:(NSString *)key block:(void (^)(void))block {
+    @synchronized([self lockForKey:key]) {
+        @synchronized(self) {
+            if (generation != [self.generations[key] unsignedIntegerValue]) {
+                return NO;
+            }
+        }
+        block();
+        return YES;
+    }
+}
+
+- (AWSTask<AWSCognitoIdentityUserSession *> *)refreshSessionForKey:(NSString *)key
+                                                        usingBlock:(AWSTask<AWSCognitoIdentityUserSession *> *(^)(void))block {
+    AWSTaskCompletionSource<AWSCognitoIdentityUserSession *> *completionSource = nil;
+    @synchronized(self) {
+        AWSTask<AWSCognitoIdentityUserSession *> *refreshTask = self.refreshTasks[key];
+        if (refreshTask) {
+            return refreshTask;
+        }
+        // The task is registered before the refresh starts, so that a refresh which finishes right away cannot leave
+        // a finished task behind.
+        completionSource = [AWSTaskCompletionSource taskCompletionSource];
+        self.refreshTasks[key] = completionSource.task;
+    }
+
+    [block() continueWithBlock:^id _Nullable(AWSTask<AWSCognitoIdentityUserSession *> *task) {
+        @synchronized(self) {
+            // The refresh may have been invalidated and replaced by a newer one.
+            if (self.refreshTasks[key] == completionSource.task) {
+                [self.refreshTasks removeObjectForKey:key];
+            }
+        }
+        if (task.error) {
+            [completionSource setError:task.error];
+        } else {
+            [completionSource setResult:task.result];
+        }
+        return nil;
+    }];
+    return completionSource.task;
+}
+
+@end
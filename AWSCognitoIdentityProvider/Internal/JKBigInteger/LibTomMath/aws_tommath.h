@@ -443,6 +443,23 @@ int aws_mp_reduce_2k_l(aws_mp_int *a, aws_mp_int *n, aws_mp_int *d);
 /* d = a**b (mod c) */
 int aws_mp_exptmod(aws_mp_int *a, aws_mp_int *b, aws_mp_int *c, aws_mp_int *d);
 
+/* precomputed powers of a fixed base G modulo a fixed odd modulus P, for repeated G**X (mod P) */
+typedef struct {
+   aws_mp_int    G, P;
+   aws_mp_digit  mp;
+   int           winsize, rows;
+   aws_mp_int   *table;
+} aws_mp_fixed_base;
+
+/* table[i] = G**(2**(winsize*i)) * R (mod P) for exponents of up to maxbits bits */
+int aws_mp_fixed_base_init(aws_mp_fixed_base *fb, aws_mp_int *G, aws_mp_int *P, int maxbits, int winsize);
+
+/* releases the table */
+void aws_mp_fixed_base_clear(aws_mp_fixed_base *fb);
+
+/* Y = G**X (mod P), falls back to aws_mp_exptmod when X is negative or wider than the table */
+int aws_mp_exptmod_fixed_base(aws_mp_fixed_base *fb, aws_mp_int *X, aws_mp_int *Y);
+
 /* ---> Primes <--- */
 
 /* number of primes */
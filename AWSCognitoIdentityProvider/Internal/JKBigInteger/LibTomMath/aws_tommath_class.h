@@ -41,6 +41,7 @@
 #define AWS_BN_MP_EXPT_D_C
 #define AWS_BN_MP_EXPTMOD_C
 #define AWS_BN_MP_EXPTMOD_FAST_C
+#define AWS_BN_MP_EXPTMOD_FIXED_BASE_C
 #define AWS_BN_MP_EXTEUCLID_C
 #define AWS_BN_MP_FREAD_C
 #define AWS_BN_MP_FWRITE_C
@@ -337,6 +338,24 @@
    #define AWS_BN_MP_EXPTMOD_FAST_C
 #endif
 
+#if defined(AWS_BN_MP_EXPTMOD_FIXED_BASE_C)
+   #define AWS_BN_MP_INIT_C
+   #define AWS_BN_MP_INIT_COPY_C
+   #define AWS_BN_MP_CLEAR_C
+   #define AWS_BN_MP_ISODD_C
+   #define AWS_BN_MP_COUNT_BITS_C
+   #define AWS_BN_MP_MONTGOMERY_SETUP_C
+   #define AWS_BN_MP_MONTGOMERY_CALC_NORMALIZATION_C
+   #define AWS_BN_FAST_MP_MONTGOMERY_REDUCE_C
+   #define AWS_BN_MP_MONTGOMERY_REDUCE_C
+   #define AWS_BN_MP_MULMOD_C
+   #define AWS_BN_MP_MUL_C
+   #define AWS_BN_MP_SQR_C
+   #define AWS_BN_MP_COPY_C
+   #define AWS_BN_MP_EXCH_C
+   #define AWS_BN_MP_EXPTMOD_C
+#endif
+
 #if defined(AWS_BN_MP_EXPTMOD_FAST_C)
    #define AWS_BN_MP_COUNT_BITS_C
    #define AWS_BN_MP_INIT_C
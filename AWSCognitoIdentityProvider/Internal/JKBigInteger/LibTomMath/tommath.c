@@ -4592,6 +4592,212 @@ aws_mp_clear(&M[1]);
 }
 #endif
 
+#ifdef AWS_BN_MP_EXPTMOD_FIXED_BASE_C
+
+/* Fixed base exponentiation (Yao's method) for a base that is raised to many
+ * different exponents modulo the same odd modulus, such as the generator of an
+ * SRP group.
+ *
+ * The exponent is split into rows of winsize bits, e_i, and the table holds
+ * G**(2**(winsize*i)) in Montgomery form.  Then
+ *
+ *    G**X = prod_{j=2**winsize-1..1} (prod_{i: e_i = j} table[i])**j
+ *
+ * which is evaluated with running products and costs at most rows + 2**winsize
+ * Montgomery multiplications, against one squaring per exponent bit for the
+ * sliding window method.
+ */
+static int s_fixed_base_redux(aws_mp_fixed_base *fb, aws_mp_int *a)
+{
+#ifdef AWS_BN_FAST_MP_MONTGOMERY_REDUCE_C
+  if (((fb->P.used * 2 + 1) < AWS_MP_WARRAY) &&
+       fb->P.used < (1 << ((CHAR_BIT * sizeof (aws_mp_word)) - (2 * AWS_DIGIT_BIT)))) {
+    return aws_fast_mp_montgomery_reduce(a, &fb->P, fb->mp);
+  }
+#endif
+  return aws_mp_montgomery_reduce(a, &fb->P, fb->mp);
+}
+
+/* returns the count bits of a starting at bit pos */
+static int s_fixed_base_window(aws_mp_int *a, int pos, int count)
+{
+  int bit, digit, res = 0;
+
+  for (bit = pos + count - 1; bit >= pos; bit--) {
+    digit = bit / AWS_DIGIT_BIT;
+    res <<= 1;
+    if (digit < a->used) {
+      res |= (int)((a->dp[digit] >> ((aws_mp_digit)(bit % AWS_DIGIT_BIT))) & 1);
+    }
+  }
+  return res;
+}
+
+int aws_mp_fixed_base_init(aws_mp_fixed_base *fb, aws_mp_int *G, aws_mp_int *P, int maxbits, int winsize)
+{
+  int     err, x, y;
+
+  /* Montgomery reduction needs an odd modulus */
+  if (P->sign == AWS_MP_NEG || aws_mp_isodd(P) == 0 || maxbits <= 0 || winsize <= 0 || winsize > 8) {
+    return AWS_MP_VAL;
+  }
+
+  fb->winsize = winsize;
+  fb->rows    = (maxbits + winsize - 1) / winsize;
+  fb->table   = NULL;
+
+  if ((err = aws_mp_init_copy(&fb->G, G)) != AWS_MP_OKAY) {
+    return err;
+  }
+  if ((err = aws_mp_init_copy(&fb->P, P)) != AWS_MP_OKAY) {
+    goto LBL_G;
+  }
+  if ((err = aws_mp_montgomery_setup(P, &fb->mp)) != AWS_MP_OKAY) {
+    goto LBL_P;
+  }
+
+  fb->table = AWS_XMALLOC(sizeof(aws_mp_int) * fb->rows);
+  if (fb->table == NULL) {
+    err = AWS_MP_MEM;
+    goto LBL_P;
+  }
+  for (x = 0; x < fb->rows; x++) {
+    if ((err = aws_mp_init(&fb->table[x])) != AWS_MP_OKAY) {
+      for (y = 0; y < x; y++) {
+        aws_mp_clear(&fb->table[y]);
+      }
+      goto LBL_T;
+    }
+  }
+
+  /* table[0] = G * R mod P */
+  if ((err = aws_mp_montgomery_calc_normalization(&fb->table[0], P)) != AWS_MP_OKAY) {
+    goto LBL_ERR;
+  }
+  if ((err = aws_mp_mulmod(G, &fb->table[0], P, &fb->table[0])) != AWS_MP_OKAY) {
+    goto LBL_ERR;
+  }
+
+  /* table[x] = table[x-1]**(2**winsize) */
+  for (x = 1; x < fb->rows; x++) {
+    if ((err = aws_mp_copy(&fb->table[x - 1], &fb->table[x])) != AWS_MP_OKAY) {
+      goto LBL_ERR;
+    }
+    for (y = 0; y < winsize; y++) {
+      if ((err = aws_mp_sqr(&fb->table[x], &fb->table[x])) != AWS_MP_OKAY) {
+        goto LBL_ERR;
+      }
+      if ((err = s_fixed_base_redux(fb, &fb->table[x])) != AWS_MP_OKAY) {
+        goto LBL_ERR;
+      }
+    }
+  }
+  return AWS_MP_OKAY;
+
+LBL_ERR:
+  for (x = 0; x < fb->rows; x++) {
+    aws_mp_clear(&fb->table[x]);
+  }
+LBL_T:
+  AWS_XFREE(fb->table);
+  fb->table = NULL;
+LBL_P:
+  aws_mp_clear(&fb->P);
+LBL_G:
+  aws_mp_clear(&fb->G);
+  return err;
+}
+
+void aws_mp_fixed_base_clear(aws_mp_fixed_base *fb)
+{
+  int x;
+
+  if (fb->table != NULL) {
+    for (x = 0; x < fb->rows; x++) {
+      aws_mp_clear(&fb->table[x]);
+    }
+    AWS_XFREE(fb->table);
+    fb->table = NULL;
+  }
+  aws_mp_clear(&fb->P);
+  aws_mp_clear(&fb->G);
+}
+
+int aws_mp_exptmod_fixed_base(aws_mp_fixed_base *fb, aws_mp_int *X, aws_mp_int *Y)
+{
+  aws_mp_int  A, B;
+  int        *windows;
+  int         err, i, j, started;
+
+  if (X->sign == AWS_MP_NEG || aws_mp_count_bits(X) > fb->rows * fb->winsize) {
+    return aws_mp_exptmod(&fb->G, X, &fb->P, Y);
+  }
+
+  windows = AWS_XMALLOC(sizeof(int) * fb->rows);
+  if (windows == NULL) {
+    return AWS_MP_MEM;
+  }
+  for (i = 0; i < fb->rows; i++) {
+    windows[i] = s_fixed_base_window(X, i * fb->winsize, fb->winsize);
+  }
+
+  /* A and B start at 1 in Montgomery form, i.e. R mod P */
+  if ((err = aws_mp_init(&A)) != AWS_MP_OKAY) {
+    goto LBL_W;
+  }
+  if ((err = aws_mp_init(&B)) != AWS_MP_OKAY) {
+    goto LBL_A;
+  }
+  if ((err = aws_mp_montgomery_calc_normalization(&A, &fb->P)) != AWS_MP_OKAY) {
+    goto LBL_B;
+  }
+  if ((err = aws_mp_copy(&A, &B)) != AWS_MP_OKAY) {
+    goto LBL_B;
+  }
+
+  /* B accumulates the rows whose window is at least j, A accumulates B once per j */
+  started = 0;
+  for (j = (1 << fb->winsize) - 1; j > 0; j--) {
+    for (i = 0; i < fb->rows; i++) {
+      if (windows[i] != j) {
+        continue;
+      }
+      if ((err = aws_mp_mul(&B, &fb->table[i], &B)) != AWS_MP_OKAY) {
+        goto LBL_B;
+      }
+      if ((err = s_fixed_base_redux(fb, &B)) != AWS_MP_OKAY) {
+        goto LBL_B;
+      }
+      started = 1;
+    }
+    /* until a row has been seen B is still 1 and so is A */
+    if (started) {
+      if ((err = aws_mp_mul(&A, &B, &A)) != AWS_MP_OKAY) {
+        goto LBL_B;
+      }
+      if ((err = s_fixed_base_redux(fb, &A)) != AWS_MP_OKAY) {
+        goto LBL_B;
+      }
+    }
+  }
+
+  /* leave Montgomery form */
+  if ((err = s_fixed_base_redux(fb, &A)) != AWS_MP_OKAY) {
+    goto LBL_B;
+  }
+  aws_mp_exch(&A, Y);
+  err = AWS_MP_OKAY;
+
+LBL_B:
+  aws_mp_clear(&B);
+LBL_A:
+  aws_mp_clear(&A);
+LBL_W:
+  AWS_XFREE(windows);
+  return err;
+}
+#endif
+
 #ifdef AWS_BN_S_MP_ADD_C
 
 /* low level addition, based on HAC pp.594, Algorithm 14.7 */
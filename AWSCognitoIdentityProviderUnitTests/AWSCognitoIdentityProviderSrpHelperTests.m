@@ -0,0 +1,96 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCognitoIdentityProviderSrpHelper.h"
+#import "AWSJKBigInteger.h"
+
+static const NSUInteger AWSCognitoIdentityProviderSrpHelperTestsBenchmarkIterations = 20;
+
+@interface AWSCognitoIdentityProviderSrpHelper()
+
++ (AWSJKBigInteger *)generateRandomUnsignedBigInt:(size_t)bitLength;
+
+@end
+
+@interface AWSCognitoIdentityProviderSrpHelperTests : XCTestCase
+
+@end
+
+@implementation AWSCognitoIdentityProviderSrpHelperTests
+
+- (AWSCognitoIdentityProviderSrpServerState *)serverStateWithCommonState:(AWSCognitoIdentityProviderSrpCommonState *)commonState {
+    AWSJKBigInteger *b = [AWSCognitoIdentityProviderSrpHelper generateRandomUnsignedBigInt:256];
+    AWSJKBigInteger *B = [commonState.g pow:b andMod:commonState.N];
+    AWSJKBigInteger *salt = [AWSCognitoIdentityProviderSrpHelper generateRandomUnsignedBigInt:128];
+    return [AWSCognitoIdentityProviderSrpServerState serverStateForPoolName:@"pool"
+                                                           publicBHexString:[B stringValueWithRadix:16]
+                                                              saltHexString:[salt stringValueWithRadix:16]
+                                                             derivedKeyInfo:@"Caldera Derived Key"
+                                                             derivedKeySize:16
+                                                         serviceSecretBlock:[NSData data]];
+}
+
+- (void)testCommonStateIsSharedAcrossInstances {
+    AWSCognitoIdentityProviderSrpCommonState *first = [AWSCognitoIdentityProviderSrpCommonState new];
+    AWSCognitoIdentityProviderSrpCommonState *second = [AWSCognitoIdentityProviderSrpCommonState new];
+    XCTAssertEqual(first.N, second.N);
+    XCTAssertEqual(first.k, second.k);
+    XCTAssertEqual([first.k compare:[first calculateK:first.N g:first.g]], NSOrderedSame);
+}
+
+- (void)testFixedBaseExponentiationMatchesGenericExponentiation {
+    AWSCognitoIdentityProviderSrpCommonState *commonState = [AWSCognitoIdentityProviderSrpCommonState new];
+    // 512 bits is wider than the precomputed table and exercises the fallback.
+    for (NSNumber *bits in @[@8, @128, @248, @256, @512]) {
+        for (NSUInteger i = 0; i < 5; i++) {
+            AWSJKBigInteger *exponent = [AWSCognitoIdentityProviderSrpHelper generateRandomUnsignedBigInt:[bits unsignedIntegerValue]];
+            AWSJKBigInteger *expected = [commonState.g pow:exponent andMod:commonState.N];
+            AWSJKBigInteger *actual = [AWSCognitoIdentityProviderSrpHelper gPow:exponent N:commonState.N g:commonState.g];
+            XCTAssertEqual([expected compare:actual], NSOrderedSame, @"%@ bit exponent", bits);
+        }
+    }
+
+    AWSJKBigInteger *zero = [[AWSJKBigInteger alloc] initWithUnsignedLong:0];
+    XCTAssertEqual([[AWSCognitoIdentityProviderSrpHelper gPow:zero N:commonState.N g:commonState.g] unsignedIntValue], 1);
+}
+
+- (void)testCalculateSMatchesReferenceFormula {
+    AWSCognitoIdentityProviderSrpHelper *helper = [AWSCognitoIdentityProviderSrpHelper beginUserAuthentication:@"user" password:@"password"];
+    AWSCognitoIdentityProviderSrpServerState *serverState = [self serverStateWithCommonState:helper.commonState];
+
+    AWSJKBigInteger *S = [helper calculateS:serverState];
+
+    // S = ((B - k * g^x) ^ (a + u * x)) % N, step by step through AWSJKBigInteger
+    AWSJKBigInteger *N = helper.commonState.N;
+    AWSJKBigInteger *exp = [helper.clientState.privateA add:[helper.u multiply:helper.x]];
+    AWSJKBigInteger *base = [serverState.publicB subtract:[helper.commonState.k multiply:[helper.commonState.g pow:helper.x andMod:N]]];
+    base = [[N add:[base remainder:N]] remainder:N];
+    AWSJKBigInteger *expected = [base pow:exp andMod:N];
+
+    XCTAssertEqual([S compare:expected], NSOrderedSame);
+}
+
+- (void)testPerformanceSrpAAndS {
+    AWSCognitoIdentityProviderSrpServerState *serverState = [self serverStateWithCommonState:[AWSCognitoIdentityProviderSrpCommonState new]];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSCognitoIdentityProviderSrpHelperTestsBenchmarkIterations; i++) {
+            AWSCognitoIdentityProviderSrpHelper *helper = [AWSCognitoIdentityProviderSrpHelper beginUserAuthentication:@"user" password:@"password"];
+            XCTAssertNotNil([helper calculateS:serverState]);
+        }
+    }];
+}
+
+@end
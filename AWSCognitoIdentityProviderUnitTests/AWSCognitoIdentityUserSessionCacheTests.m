@@ -0,0 +1,297 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <AWSCore/AWSUICKeyChainStore.h>
+#import "AWSCognitoIdentityProvider.h"
+#import "AWSCognitoIdentityUser_Internal.h"
+#import "AWSCognitoIdentityUserPool_Internal.h"
+#import "AWSCognitoIdentityUserSessionCache.h"
+
+static NSString *const AWSCognitoIdentityUserSessionCacheTestsUsername = @"user";
+
+@interface AWSCognitoIdentityProvider()
+
+- (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration;
+
+@end
+
+@interface AWSCognitoIdentityUserPool()
+
+@property (nonatomic, strong) AWSCognitoIdentityProvider *client;
+
+@end
+
+/**
+ Stands in for the user pool endpoint: answers RefreshTokenAuth with new tokens after `delay`, or with `error`.
+ */
+@interface AWSCognitoIdentityUserSessionCacheTestsUserPool : AWSCognitoIdentityProvider
+
+@property (atomic, assign) NSUInteger initiateAuthCount;
+@property (atomic, assign) NSTimeInterval delay;
+@property (atomic, assign) NSTimeInterval tokenLifetime;
+@property (atomic, strong) NSError *error;
+
+@end
+
+@implementation AWSCognitoIdentityUserSessionCacheTestsUserPool
+
++ (NSString *)tokenExpiringAt:(NSDate *)expiration {
+    NSDictionary *claims = @{@"exp" : @((long long)[expiration timeIntervalSince1970]),
+                             @"jti" : [NSUUID UUID].UUIDString};
+    NSData *claimsData = [NSJSONSerialization dataWithJSONObject:claims options:0 error:nil];
+    NSString *encodedClaims = [[claimsData base64EncodedStringWithOptions:0] stringByReplacingOccurrencesOfString:@"=" withString:@""];
+    return [NSString stringWithFormat:@"eyJhbGciOiJub25lIn0.%@.signature", encodedClaims];
+}
+
+- (AWSTask<AWSCognitoIdentityProviderInitiateAuthResponse *> *)initiateAuth:(AWSCognitoIdentityProviderInitiateAuthRequest *)request {
+    @synchronized(self) {
+        self.initiateAuthCount++;
+    }
+    AWSTaskCompletionSource *completionSource = [AWSTaskCompletionSource taskCompletionSource];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        if (self.error) {
+            [completionSource setError:self.error];
+            return;
+        }
+        NSDate *expiration = [NSDate dateWithTimeIntervalSinceNow:self.tokenLifetime];
+        AWSCognitoIdentityProviderAuthenticationResultType *authenticationResult = [AWSCognitoIdentityProviderAuthenticationResultType new];
+        authenticationResult.accessToken = [AWSCognitoIdentityUserSessionCacheTestsUserPool tokenExpiringAt:expiration];
+        authenticationResult.idToken = [AWSCognitoIdentityUserSessionCacheTestsUserPool tokenExpiringAt:expiration];
+        authenticationResult.expiresIn = @(self.tokenLifetime);
+        AWSCognitoIdentityProviderInitiateAuthResponse *response = [AWSCognitoIdentityProviderInitiateAuthResponse new];
+        response.authenticationResult = authenticationResult;
+        [completionSource setResult:response];
+    });
+    return completionSource.task;
+}
+
+@end
+
+@interface AWSCognitoIdentityUserSessionCacheTests : XCTestCase
+
+@property (nonatomic, strong) AWSCognitoIdentityUserPool *pool;
+@property (nonatomic, strong) AWSCognitoIdentityUserSessionCacheTestsUserPool *userPoolStandIn;
+@property (nonatomic, strong) NSString *keyChainNamespace;
+
+@end
+
+@implementation AWSCognitoIdentityUserSessionCacheTests
+
+- (void)setUp {
+    [super setUp];
+    // A new app client for each test, so that the shared session cache starts out empty.
+    NSString *clientId = [NSUUID UUID].UUIDString;
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:nil];
+    AWSCognitoIdentityUserPoolConfiguration *userPoolConfiguration = [[AWSCognitoIdentityUserPoolConfiguration alloc] initWithClientId:clientId
+                                                                                                                           clientSecret:nil
+                                                                                                                                 poolId:@"us-east-1_test"];
+    [AWSCognitoIdentityUserPool registerCognitoIdentityUserPoolWithConfiguration:configuration
+                                                           userPoolConfiguration:userPoolConfiguration
+                                                                          forKey:clientId];
+    self.pool = [AWSCognitoIdentityUserPool CognitoIdentityUserPoolForKey:clientId];
+    self.userPoolStandIn = [[AWSCognitoIdentityUserSessionCacheTestsUserPool alloc] initWithConfiguration:configuration];
+    self.userPoolStandIn.delay = 0.2;
+    self.userPoolStandIn.tokenLifetime = 60 * 60;
+    self.pool.client = self.userPoolStandIn;
+    self.keyChainNamespace = [NSString stringWithFormat:@"%@.%@", clientId, AWSCognitoIdentityUserSessionCacheTestsUsername];
+}
+
+- (void)tearDown {
+    [self.pool clearAll];
+    [AWSCognitoIdentityUserPool removeCognitoIdentityUserPoolForKey:self.pool.userPoolConfiguration.clientId];
+    [super tearDown];
+}
+
+- (NSString *)keychainValueForKey:(NSString *)key {
+    return [self keychainValueForKey:key username:AWSCognitoIdentityUserSessionCacheTestsUsername];
+}
+
+- (NSString *)keychainValueForKey:(NSString *)key username:(NSString *)username {
+    return self.pool.keychain[[NSString stringWithFormat:@"%@.%@.%@", self.pool.userPoolConfiguration.clientId, username, key]];
+}
+
+- (void)setKeychainValue:(NSString *)value forKey:(NSString *)key {
+    [self setKeychainValue:value forKey:key username:AWSCognitoIdentityUserSessionCacheTestsUsername];
+}
+
+- (void)setKeychainValue:(NSString *)value forKey:(NSString *)key username:(NSString *)username {
+    self.pool.keychain[[NSString stringWithFormat:@"%@.%@.%@", self.pool.userPoolConfiguration.clientId, username, key]] = value;
+}
+
+// Stores a signed in session which expires `lifetime` seconds from now.
+- (void)storeSessionWithLifetime:(NSTimeInterval)lifetime {
+    [self storeSessionWithLifetime:lifetime username:AWSCognitoIdentityUserSessionCacheTestsUsername];
+}
+
+- (void)storeSessionWithLifetime:(NSTimeInterval)lifetime username:(NSString *)username {
+    NSDate *expiration = [NSDate dateWithTimeIntervalSinceNow:lifetime];
+    [self setKeychainValue:[AWSCognitoIdentityUserSessionCacheTestsUserPool tokenExpiringAt:expiration] forKey:@"accessToken" username:username];
+    [self setKeychainValue:[AWSCognitoIdentityUserSessionCacheTestsUserPool tokenExpiringAt:expiration] forKey:@"idToken" username:username];
+    [self setKeychainValue:@"refreshToken" forKey:@"refreshToken" username:username];
+    [self setKeychainValue:[expiration aws_stringValue:AWSDateISO8601DateFormat1] forKey:@"tokenExpiration" username:username];
+}
+
+- (AWSCognitoIdentityUserSession *)getSession {
+    AWSTask<AWSCognitoIdentityUserSession *> *task = [[self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername] getSession];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return task.result;
+}
+
+- (void)testSessionIsServedFromMemory {
+    [self storeSessionWithLifetime:60 * 60];
+    AWSCognitoIdentityUserSession *session = [self getSession];
+    XCTAssertNotNil(session);
+
+    // Later calls do not read the keychain again.
+    [self setKeychainValue:@"changed" forKey:@"accessToken"];
+    AWSCognitoIdentityUserSession *cachedSession = [self getSession];
+    XCTAssertEqual(cachedSession, session);
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 0);
+}
+
+- (void)testConcurrentCallersShareOneRefresh {
+    [self storeSessionWithLifetime:60];
+    NSString *expiredAccessToken = [self keychainValueForKey:@"accessToken"];
+
+    NSUInteger callerCount = 10;
+    XCTestExpectation *refreshed = [self expectationWithDescription:@"Every caller gets a session"];
+    refreshed.expectedFulfillmentCount = callerCount;
+    NSMutableSet<NSString *> *accessTokens = [NSMutableSet new];
+    for (NSUInteger i = 0; i < callerCount; i++) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [[[self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername] getSession] continueWithBlock:^id _Nullable(AWSTask<AWSCognitoIdentityUserSession *> *task) {
+                XCTAssertNil(task.error);
+                @synchronized(accessTokens) {
+                    [accessTokens addObject:task.result.accessToken.tokenString];
+                }
+                [refreshed fulfill];
+                return nil;
+            }];
+        });
+    }
+    [self waitForExpectations:@[refreshed] timeout:5];
+
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 1);
+    XCTAssertEqual([accessTokens count], 1);
+    XCTAssertNotEqualObjects([accessTokens anyObject], expiredAccessToken);
+
+    // The refreshed session was written through to the keychain.
+    XCTAssertEqualObjects([self keychainValueForKey:@"accessToken"], [accessTokens anyObject]);
+    XCTAssertEqualObjects([self keychainValueForKey:@"refreshToken"], @"refreshToken");
+}
+
+- (void)testSessionIsRefreshedBeforeItExpires {
+    // Four minutes left: still valid, but within the refresh ahead interval.
+    [self storeSessionWithLifetime:4 * 60];
+    NSString *accessToken = [self keychainValueForKey:@"accessToken"];
+
+    AWSCognitoIdentityUserSession *session = [self getSession];
+    XCTAssertEqualObjects(session.accessToken.tokenString, accessToken);
+
+    NSPredicate *refreshedPredicate = [NSPredicate predicateWithBlock:^BOOL(id object, NSDictionary *bindings) {
+        return ![[self keychainValueForKey:@"accessToken"] isEqualToString:accessToken];
+    }];
+    [self waitForExpectations:@[[[XCTNSPredicateExpectation alloc] initWithPredicate:refreshedPredicate object:nil]] timeout:5];
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 1);
+
+    AWSCognitoIdentityUserSession *refreshedSession = [self getSession];
+    XCTAssertEqualObjects(refreshedSession.accessToken.tokenString, [self keychainValueForKey:@"accessToken"]);
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 1);
+}
+
+- (void)testFailedRefreshIsNotShared {
+    [self storeSessionWithLifetime:60];
+    self.userPoolStandIn.error = [NSError errorWithDomain:AWSCognitoIdentityProviderErrorDomain
+                                                     code:AWSCognitoIdentityProviderErrorInternalError
+                                                 userInfo:nil];
+
+    AWSTask *task = [[self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername] getSession];
+    [task waitUntilFinished];
+    XCTAssertEqual(task.error.code, AWSCognitoIdentityProviderErrorInternalError);
+
+    // The next caller starts a new refresh rather than getting the failed one.
+    self.userPoolStandIn.error = nil;
+    XCTAssertNotNil([self getSession]);
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 2);
+}
+
+- (void)testSignOutRemovesTheCachedSession {
+    [self storeSessionWithLifetime:60 * 60];
+    XCTAssertNotNil([self getSession]);
+    XCTAssertNotNil([self.pool.sessionCache validSessionForKey:self.keyChainNamespace needsRefresh:NULL]);
+
+    [[self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername] signOut];
+    XCTAssertNil([self.pool.sessionCache validSessionForKey:self.keyChainNamespace needsRefresh:NULL]);
+    XCTAssertNil([self keychainValueForKey:@"accessToken"]);
+}
+
+- (void)testRefreshFinishingAfterSignOutDoesNotPersistTokens {
+    [self storeSessionWithLifetime:60];
+    AWSCognitoIdentityUser *user = [self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername];
+
+    AWSTask *task = [user getSession];
+    [user signOut];
+    [task waitUntilFinished];
+
+    // The caller is told the session was signed out, rather than being sent through interactive authentication.
+    XCTAssertEqualObjects(task.error.domain, AWSCognitoIdentityProviderErrorDomain);
+    XCTAssertEqual(task.error.code, AWSCognitoIdentityProviderClientErrorSessionInvalidated);
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 1);
+    XCTAssertNil([self keychainValueForKey:@"accessToken"]);
+    XCTAssertNil([self keychainValueForKey:@"refreshToken"]);
+    XCTAssertNil([self.pool.sessionCache validSessionForKey:self.keyChainNamespace needsRefresh:NULL]);
+}
+
+- (void)testSignOutDoesNotDropTheRefreshOfAnotherUser {
+    NSString *otherUsername = @"otherUser";
+    [self storeSessionWithLifetime:60];
+    [self storeSessionWithLifetime:60 username:otherUsername];
+    AWSCognitoIdentityUser *user = [self.pool getUser:AWSCognitoIdentityUserSessionCacheTestsUsername];
+    AWSCognitoIdentityUser *otherUser = [self.pool getUser:otherUsername];
+
+    AWSTask *task = [user getSession];
+    AWSTask<AWSCognitoIdentityUserSession *> *otherTask = [otherUser getSession];
+    [otherUser signOut];
+    [task waitUntilFinished];
+    [otherTask waitUntilFinished];
+
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 2);
+    XCTAssertEqual(otherTask.error.code, AWSCognitoIdentityProviderClientErrorSessionInvalidated);
+    XCTAssertNil([self keychainValueForKey:@"accessToken" username:otherUsername]);
+
+    // The refresh of the user who stayed signed in still persists its tokens and is shared with later callers.
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects([self keychainValueForKey:@"accessToken"], [task.result accessToken].tokenString);
+    XCTAssertEqual([self getSession], task.result);
+    XCTAssertEqual(self.userPoolStandIn.initiateAuthCount, 2);
+}
+
+- (void)testSessionsAreNotReturnedWithinTheExpiryWindow {
+    AWSCognitoIdentityUserSessionCache *sessionCache = [AWSCognitoIdentityUserSessionCache new];
+    NSDate *expiration = [NSDate dateWithTimeIntervalSinceNow:90];
+    AWSCognitoIdentityUserSession *session = [[AWSCognitoIdentityUserSession alloc] initWithIdToken:nil
+                                                                                        accessToken:[AWSCognitoIdentityUserSessionCacheTestsUserPool tokenExpiringAt:expiration]
+                                                                                       refreshToken:@"refreshToken"
+                                                                                     expirationTime:[NSDate dateWithTimeIntervalSinceNow:60 * 60]];
+    [sessionCache setSession:session forKey:@"key"];
+    // The access token expires in less than 2 minutes, even though the session expiration is an hour away.
+    XCTAssertNil([sessionCache validSessionForKey:@"key" needsRefresh:NULL]);
+}
+
+@end
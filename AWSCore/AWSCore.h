@@ -48,6 +48,7 @@ FOUNDATION_EXPORT const unsigned char AWSCoreVersionString[] DEPRECATED_MSG_ATTR
 #import "AWSNetworking.h"
 #import "AWSNetworkingHelpers.h"
 #import "AWSCategory.h"
+#import "AWSDateFormatting.h"
 #import "AWSLogging.h"
 #import "AWSClientContext.h"
 #import "AWSSynchronizedMutableDictionary.h"
@@ -57,11 +58,14 @@ FOUNDATION_EXPORT const unsigned char AWSCoreVersionString[] DEPRECATED_MSG_ATTR
 #import "AWSURLRequestSerialization.h"
 #import "AWSURLResponseSerialization.h"
 #import "AWSURLSessionManager.h"
+#import "AWSNetworkingMetrics.h"
+#import "AWSNetworkingRequestScheduler.h"
 #import "AWSSignature.h"
 #import "AWSURLRequestRetryHandler.h"
 #import "AWSValidation.h"
 #import "AWSInfo.h"
 #import "AWSNSCodingUtilities.h"
+#import "AWSDurableQueue.h"
 
 #import "AWSBolts.h"
 #import "AWSGZIP.h"
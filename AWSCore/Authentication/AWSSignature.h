@@ -20,6 +20,7 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Algorithm;
 FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
 
 @class AWSEndpoint;
+@class AWSCredentials;
 
 @protocol AWSCredentialsProvider;
 
@@ -92,6 +93,35 @@ FOUNDATION_EXPORT NSString * _Nonnull const AWSSignatureV4Terminator;
                                                 signBody:(BOOL)signBody
                                         signSessionToken:(BOOL)signSessionToken;
 
+/**
+ Returns a URL signed using the SigV4 algorithm with credentials that have already been resolved.
+
+ Callers signing many URLs at once can resolve the credentials and derive the signing key a single time, and pass them
+ to every call instead of paying for both per URL.
+
+ @param request the NSURLRequest to sign
+ @param credentials the credentials providing the accessKey, secretKey, and optional sessionKey
+ @param signingKey the key returned by `+ getV4DerivedKey:date:region:service:` for the credentials' secretKey, the
+        short date of `date`, regionName and serviceName. If nil, the key is derived by this method.
+ @param regionName the string representing the AWS region of the endpoint to be signed.
+ @param serviceName the name of the AWS service the request is for
+ @param date the date of the signed credential
+ @param expireDuration the duration in seconds the signed URL will be valid for
+ @param signBody if true and the httpMethod is GET, sign an empty string as part of the signature content
+ @param signSessionToken if true, include the sessionKey of the credentials in the signed payload.
+        If false, appends the X-AMZ-Security-Token to the end of the signed URL request parameters
+ @return the signed URL
+ */
++ (NSURL * _Nullable)sigV4SignedURLWithRequest:(NSURLRequest * _Nonnull)request
+                                   credentials:(AWSCredentials * _Nonnull)credentials
+                                    signingKey:(NSData * _Nullable)signingKey
+                                    regionName:(NSString * _Nonnull)regionName
+                                   serviceName:(NSString * _Nonnull)serviceName
+                                          date:(NSDate * _Nonnull)date
+                                expireDuration:(int32_t)expireDuration
+                                      signBody:(BOOL)signBody
+                              signSessionToken:(BOOL)signSessionToken;
+
 + (NSString * _Nonnull)getCanonicalizedRequest:(NSString * _Nonnull)method
                                  path:(NSString * _Nonnull)path
                                 query:(NSString * _Nullable)query
@@ -21,6 +21,7 @@
 #import "AWSCocoaLumberjack.h"
 #import "AWSBolts.h"
 #import "AWSNetworkingHelpers.h"
+#import "AWSNetworkingMetrics.h"
 
 static NSString *const AWSSigV4Marker = @"AWS4";
 NSString *const AWSSignatureV4Algorithm = @"AWS4-HMAC-SHA256";
@@ -151,7 +152,13 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
 - (AWSTask *)interceptRequest:(NSMutableURLRequest *)request {
     [request setValue:request.URL.host forHTTPHeaderField:@"Host"];
+    AWSNetworkingOperationMetrics *metrics = [AWSNetworkingOperationMetrics metricsForRequest:request];
+    NSTimeInterval credentialsStartTime = metrics ? [NSProcessInfo processInfo].systemUptime : 0;
     return [[self.credentialsProvider credentials] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        if (metrics) {
+            [metrics addDuration:[NSProcessInfo processInfo].systemUptime - credentialsStartTime
+                        forPhase:AWSNetworkingMetricsPhaseCredentials];
+        }
         AWSCredentials *credentials = task.result;
         // clear authorization header if set
         [request setValue:nil forHTTPHeaderField:@"Authorization"];
@@ -324,7 +331,12 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         query = [NSString stringWithFormat:@""];
     }
 
-    NSString *contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:request.HTTPBody] encoding:NSASCIIStringEncoding]];
+    NSString *contentSha256 = [request valueForHTTPHeaderField:@"x-amz-content-sha256"];
+
+    //a client that streams its body and whose service accepts it marks the payload as unsigned, since hashing would read the stream twice.
+    if (![contentSha256 isEqualToString:@"UNSIGNED-PAYLOAD"]) {
+        contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:request.HTTPBody] encoding:NSASCIIStringEncoding]];
+    }
 
     NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:request.HTTPMethod
                                                                           path:path
@@ -426,136 +438,157 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
             return [AWSTask taskWithError:error];
         }
 
-        AWSCredentials *credentials = task.result;
-
-        // Deconstruct the incoming URL into components for easier manipulation and inspection of individual pieces.
-        // We'll use the mutated components at the end of this method to construct the signed URL
-        NSURLComponents *urlComponents = [[NSURLComponents alloc] initWithURL:request.URL
-                                                      resolvingAgainstBaseURL:NO];
-
-        // Implementation of V4 signature http://docs.aws.amazon.com/AmazonS3/latest/API/sigv4-query-string-auth.html
-        // Start with existing query string parameters; signature parameters will be appended to them
-        NSMutableArray<NSURLQueryItem *> *queryItems = [[NSMutableArray alloc] initWithArray:urlComponents.queryItems];
-
-        //Append Identifies the version of AWS Signature and the algorithm that you used to calculate the signature.
-        [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Algorithm" value:AWSSignatureV4Algorithm]];
-
-        NSString *credentialsScope = [self getCredentialScopeForDate:date
-                                                          regionName:regionName
-                                                         serviceName:serviceName];
-        NSString *credential = [NSString stringWithFormat:@"%@/%@", credentials.accessKey, credentialsScope];
-        [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Credential" value:credential]];
+        return [self sigV4SignedURLWithRequest:request
+                                   credentials:task.result
+                                    signingKey:nil
+                                    regionName:regionName
+                                   serviceName:serviceName
+                                          date:date
+                                expireDuration:expireDuration
+                                      signBody:signBody
+                              signSessionToken:signSessionToken];
+    }];
+}
 
-        //X-Amz-Date in ISO 8601 format, for example, 20130721T201207Z. This value must match the date value used to calculate the signature.
-        NSString *iso8601Date = [date aws_stringValue:AWSDateISO8601DateFormat2];
-        [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Date" value:iso8601Date]];
++ (NSURL *)sigV4SignedURLWithRequest:(NSURLRequest *)request
+                         credentials:(AWSCredentials *)credentials
+                          signingKey:(NSData *)signingKey
+                          regionName:(NSString *)regionName
+                         serviceName:(NSString *)serviceName
+                                date:(NSDate *)date
+                      expireDuration:(int32_t)expireDuration
+                            signBody:(BOOL)signBody
+                    signSessionToken:(BOOL)signSessionToken {
+    // Deconstruct the incoming URL into components for easier manipulation and inspection of individual pieces.
+    // We'll use the mutated components at the end of this method to construct the signed URL
+    NSURLComponents *urlComponents = [[NSURLComponents alloc] initWithURL:request.URL
+                                                  resolvingAgainstBaseURL:NO];
+
+    // Implementation of V4 signature http://docs.aws.amazon.com/AmazonS3/latest/API/sigv4-query-string-auth.html
+    // Start with existing query string parameters; signature parameters will be appended to them
+    NSMutableArray<NSURLQueryItem *> *queryItems = [[NSMutableArray alloc] initWithArray:urlComponents.queryItems];
+
+    //Append Identifies the version of AWS Signature and the algorithm that you used to calculate the signature.
+    [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Algorithm" value:AWSSignatureV4Algorithm]];
+
+    NSString *credentialsScope = [self getCredentialScopeForDate:date
+                                                      regionName:regionName
+                                                     serviceName:serviceName];
+    NSString *credential = [NSString stringWithFormat:@"%@/%@", credentials.accessKey, credentialsScope];
+    [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Credential" value:credential]];
+
+    //X-Amz-Date in ISO 8601 format, for example, 20130721T201207Z. This value must match the date value used to calculate the signature.
+    NSString *iso8601Date = [date aws_stringValue:AWSDateISO8601DateFormat2];
+    [queryItems addObject:[NSURLQueryItem queryItemWithName:@"X-Amz-Date" value:iso8601Date]];
+
+    //X-Amz-Expires, Provides the time period, in seconds, for which the generated presigned URL is valid.
+    //For example, 86400 (24 hours). This value is an integer. The minimum value you can set is 1, and the maximum is 604800 (seven days).
+    NSString *expireString = [NSString stringWithFormat:@"%d", expireDuration];
+    [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Expires" value:expireString]];
+    
+    /*
+     X-Amz-SignedHeaders Lists the headers that you used to calculate the signature. The HTTP host header is required.
+     Any x-amz-* headers that you plan to add to the request are also required for signature calculation.
+     In general, for added security, you should sign all the request headers that you plan to include in your request.
+     */
+    NSDictionary *headers = request.allHTTPHeaderFields;
+    NSString *signedHeaders = [self getSignedHeadersString:headers];
+    [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-SignedHeaders" value:signedHeaders]];
+
+    // Add security-token as part of signed payload if present, and `signSessionToken` is true
+    if (signSessionToken && credentials.sessionKey.length > 0) {
+        [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Security-Token" value:credentials.sessionKey]];
+    }
+    
+    // =============  generate v4 signature string ===================
+    
+    /* Canonical Request Format:
+     *
+     * HTTP-VERB + "\n" +  (e.g. GET, PUT, POST)
+     * Canonical URI + "\n" + (e.g. /test.txt)
+     * Canonical Query String + "\n" (multiple queryString need to sorted by QueryParameter)
+     * Canonical Headers + "\n" + (multiple headers need to be sorted by HeaderName)
+     * Signed Headers + "\n" + (multiple headers need to be sorted by HeaderName)
+     * "UNSIGNED-PAYLOAD"
+     */
+    
+    // CanonicalURI is the URI-encoded version of the absolute path component of the URI—everything starting with
+    // the "/" that follows the domain name and up to the end of the string or to the question mark character ('?')
+    // if you have query string parameters. e.g. https://s3.amazonaws.com/examplebucket/myphoto.jpg
+    // /examplebucket/myphoto.jpg is the absolute path. In the absolute path, you don't encode the "/".
 
-        //X-Amz-Expires, Provides the time period, in seconds, for which the generated presigned URL is valid.
-        //For example, 86400 (24 hours). This value is an integer. The minimum value you can set is 1, and the maximum is 604800 (seven days).
-        NSString *expireString = [NSString stringWithFormat:@"%d", expireDuration];
-        [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Expires" value:expireString]];
-        
-        /*
-         X-Amz-SignedHeaders Lists the headers that you used to calculate the signature. The HTTP host header is required.
-         Any x-amz-* headers that you plan to add to the request are also required for signature calculation.
-         In general, for added security, you should sign all the request headers that you plan to include in your request.
-         */
-        NSDictionary *headers = request.allHTTPHeaderFields;
-        NSString *signedHeaders = [self getSignedHeadersString:headers];
-        [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-SignedHeaders" value:signedHeaders]];
-
-        // Add security-token as part of signed payload if present, and `signSessionToken` is true
-        if (signSessionToken && credentials.sessionKey.length > 0) {
-            [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Security-Token" value:credentials.sessionKey]];
-        }
-        
-        // =============  generate v4 signature string ===================
-        
-        /* Canonical Request Format:
-         *
-         * HTTP-VERB + "\n" +  (e.g. GET, PUT, POST)
-         * Canonical URI + "\n" + (e.g. /test.txt)
-         * Canonical Query String + "\n" (multiple queryString need to sorted by QueryParameter)
-         * Canonical Headers + "\n" + (multiple headers need to be sorted by HeaderName)
-         * Signed Headers + "\n" + (multiple headers need to be sorted by HeaderName)
-         * "UNSIGNED-PAYLOAD"
-         */
-        
-        // CanonicalURI is the URI-encoded version of the absolute path component of the URI—everything starting with
-        // the "/" that follows the domain name and up to the end of the string or to the question mark character ('?')
-        // if you have query string parameters. e.g. https://s3.amazonaws.com/examplebucket/myphoto.jpg
-        // /examplebucket/myphoto.jpg is the absolute path. In the absolute path, you don't encode the "/".
+    NSString *pathToEncode;
 
-        NSString *pathToEncode;
+    if ([urlComponents.path hasPrefix:@"/"]) {
+        NSRange firstCharacter = NSMakeRange(0, 1);
+        pathToEncode = [urlComponents.path stringByReplacingCharactersInRange:firstCharacter withString:@""];
+    } else {
+        pathToEncode = urlComponents.path;
+    }
+    NSString *canonicalURI = [NSString stringWithFormat:@"/%@", [pathToEncode aws_stringWithURLEncodingPath]];
 
-        if ([urlComponents.path hasPrefix:@"/"]) {
-            NSRange firstCharacter = NSMakeRange(0, 1);
-            pathToEncode = [urlComponents.path stringByReplacingCharactersInRange:firstCharacter withString:@""];
-        } else {
-            pathToEncode = urlComponents.path;
-        }
-        NSString *canonicalURI = [NSString stringWithFormat:@"/%@", [pathToEncode aws_stringWithURLEncodingPath]];
-
-        NSString *contentSha256;
-        if(signBody && [request.HTTPMethod isEqualToString:@"GET"]){
-            //in case of http get we sign the body as an empty string only if the sign body flag is set to true
-            NSData *emptyData = [@"" dataUsingEncoding:NSUTF8StringEncoding];
-            NSData *emptyDataHash = [AWSSignatureSignerUtility hash:emptyData];
-            NSString *emptyDataEncodedString = [[NSString alloc] initWithData:emptyDataHash
-                                                                     encoding:NSASCIIStringEncoding];
-            contentSha256 = [AWSSignatureSignerUtility hexEncode:emptyDataEncodedString];
-        } else {
-            contentSha256 = @"UNSIGNED-PAYLOAD";
-        }
+    NSString *contentSha256;
+    if(signBody && [request.HTTPMethod isEqualToString:@"GET"]){
+        //in case of http get we sign the body as an empty string only if the sign body flag is set to true
+        NSData *emptyData = [@"" dataUsingEncoding:NSUTF8StringEncoding];
+        NSData *emptyDataHash = [AWSSignatureSignerUtility hash:emptyData];
+        NSString *emptyDataEncodedString = [[NSString alloc] initWithData:emptyDataHash
+                                                                 encoding:NSASCIIStringEncoding];
+        contentSha256 = [AWSSignatureSignerUtility hexEncode:emptyDataEncodedString];
+    } else {
+        contentSha256 = @"UNSIGNED-PAYLOAD";
+    }
 
-        // Generate Canonical Request
+    // Generate Canonical Request
 
-        // Get the URL encoded query string
-        NSString *queryString = [self getURIEncodedQueryStringForSigV4:queryItems];
+    // Get the URL encoded query string
+    NSString *queryString = [self getURIEncodedQueryStringForSigV4:queryItems];
 
-        NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:request.HTTPMethod
-                                                                              path:canonicalURI
-                                                                             query:queryString
-                                                                           headers:request.allHTTPHeaderFields
-                                                                     contentSha256:contentSha256];
-        AWSDDLogVerbose(@"AWSS4 PresignedURL Canonical request: [%@]", canonicalRequest);
-        
-        //Generate String to Sign
-        NSString *stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@",
-                                  AWSSignatureV4Algorithm,
-                                  [date aws_stringValue:AWSDateISO8601DateFormat2],
-                                  credentialsScope,
-                                  [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
-        
-        AWSDDLogVerbose(@"AWS4 PresignedURL String to Sign: [%@]", stringToSign);
-        
-        // Generate Signature
-        NSData *kSigning  = [AWSSignatureV4Signer getV4DerivedKey:credentials.secretKey
-                                                             date:[date aws_stringValue:AWSDateShortDateFormat1]
-                                                           region:regionName
-                                                          service:serviceName];
-        NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                                  withKey:kSigning];
-        NSString *signatureString = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature
-                                                                                               encoding:NSASCIIStringEncoding]];
-        
-        // ============  generate v4 signature string (END) ===================
-        
-        // Add security-token as part of the postamble if present, and `signSessionToken` is false
-        if (!signSessionToken && credentials.sessionKey.length > 0) {
-            [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Security-Token" value:credentials.sessionKey]];
-        }
+    NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:request.HTTPMethod
+                                                                          path:canonicalURI
+                                                                         query:queryString
+                                                                       headers:request.allHTTPHeaderFields
+                                                                 contentSha256:contentSha256];
+    AWSDDLogVerbose(@"AWSS4 PresignedURL Canonical request: [%@]", canonicalRequest);
+    
+    //Generate String to Sign
+    NSString *stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@",
+                              AWSSignatureV4Algorithm,
+                              [date aws_stringValue:AWSDateISO8601DateFormat2],
+                              credentialsScope,
+                              [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
+    
+    AWSDDLogVerbose(@"AWS4 PresignedURL String to Sign: [%@]", stringToSign);
+    
+    // Generate Signature
+    NSData *kSigning = signingKey;
+    if (!kSigning) {
+        kSigning = [AWSSignatureV4Signer getV4DerivedKey:credentials.secretKey
+                                                    date:[date aws_stringValue:AWSDateShortDateFormat1]
+                                                  region:regionName
+                                                 service:serviceName];
+    }
+    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
+                                                              withKey:kSigning];
+    NSString *signatureString = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature
+                                                                                           encoding:NSASCIIStringEncoding]];
+    
+    // ============  generate v4 signature string (END) ===================
+    
+    // Add security-token as part of the postamble if present, and `signSessionToken` is false
+    if (!signSessionToken && credentials.sessionKey.length > 0) {
+        [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Security-Token" value:credentials.sessionKey]];
+    }
 
-        [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Signature" value:signatureString]];
+    [queryItems addObject:[NSURLQueryItem queryItemWithName: @"X-Amz-Signature" value:signatureString]];
 
-        // Regenerate the escaped query string now that we've added the signature
-        queryString = [self getURIEncodedQueryStringForSigV4:queryItems];
+    // Regenerate the escaped query string now that we've added the signature
+    queryString = [self getURIEncodedQueryStringForSigV4:queryItems];
 
-        urlComponents.percentEncodedQuery = queryString;
+    urlComponents.percentEncodedQuery = queryString;
 
-        AWSDDLogVerbose(@"AWS4 PresignedURL: [%@]", urlComponents.URL);
-        return urlComponents.URL;
-    }];
+    AWSDDLogVerbose(@"AWS4 PresignedURL: [%@]", urlComponents.URL);
+    return urlComponents.URL;
 }
 
 + (NSString *)getCredentialScopeForDate:(NSDate *)date
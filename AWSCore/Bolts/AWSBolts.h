@@ -15,6 +15,7 @@
 #import "AWSGeneric.h"
 #import "AWSTask.h"
 #import "AWSTaskCompletionSource.h"
+#import "AWSWorkStealingExecutor.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -11,6 +11,7 @@
 #import "AWSTask.h"
 
 #import <libkern/OSAtomic.h>
+#import <stdatomic.h>
 
 #import "AWSBolts.h"
 
@@ -26,19 +27,33 @@ NSInteger const kAWSMultipleErrorsError = 80175001;
 
 NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
+typedef NS_ENUM(NSInteger, AWSTaskState) {
+    AWSTaskStatePending = 0,
+    // A trySet* call has won the race and is publishing the result or error.
+    AWSTaskStateCompleting,
+    AWSTaskStateSucceeded,
+    AWSTaskStateFaulted,
+    AWSTaskStateCancelled,
+};
+
+// A node of the lock-free stack of continuations. `block` is a retained dispatch_block_t.
+typedef struct AWSTaskContinuation {
+    struct AWSTaskContinuation *next;
+    void *block;
+} AWSTaskContinuation;
+
+// Stored as the stack head once the continuations have been taken, so a late push knows to run its block directly.
+static const uintptr_t AWSTaskContinuationsSealed = 1;
+
 @interface AWSTask () {
     id _result;
     NSError *_error;
+    _Atomic(NSInteger) _state;
+    _Atomic(uintptr_t) _continuations;
+    // A retained NSCondition, created the first time a caller blocks in `waitUntilFinished`.
+    _Atomic(void *) _condition;
 }
 
-@property (nonatomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
-@property (nonatomic, assign, readwrite, getter=isFaulted) BOOL faulted;
-@property (nonatomic, assign, readwrite, getter=isCompleted) BOOL completed;
-
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
-
 @end
 
 @implementation AWSTask
@@ -49,9 +64,9 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
     self = [super init];
     if (!self) return self;
 
-    _lock = [[NSObject alloc] init];
-    _condition = [[NSCondition alloc] init];
-    _callbacks = [NSMutableArray array];
+    atomic_init(&_state, AWSTaskStatePending);
+    atomic_init(&_continuations, 0);
+    atomic_init(&_condition, NULL);
 
     return self;
 }
@@ -231,85 +246,113 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
 #pragma mark - Custom Setters/Getters
 
+- (AWSTaskState)state {
+    return atomic_load_explicit(&_state, memory_order_acquire);
+}
+
 - (nullable id)result {
-    @synchronized(self.lock) {
-        return _result;
-    }
+    return [self state] == AWSTaskStateSucceeded ? _result : nil;
 }
 
 - (BOOL)trySetResult:(nullable id)result {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
-    }
+    return [self trySetState:AWSTaskStateSucceeded result:result error:nil];
 }
 
 - (nullable NSError *)error {
-    @synchronized(self.lock) {
-        return _error;
-    }
+    return [self state] == AWSTaskStateFaulted ? _error : nil;
 }
 
 - (BOOL)trySetError:(NSError *)error {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
-    }
+    return [self trySetState:AWSTaskStateFaulted result:nil error:error];
 }
 
 - (BOOL)isCancelled {
-    @synchronized(self.lock) {
-        return _cancelled;
-    }
+    return [self state] == AWSTaskStateCancelled;
 }
 
 - (BOOL)isFaulted {
-    @synchronized(self.lock) {
-        return _faulted;
-    }
+    return [self state] == AWSTaskStateFaulted;
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
-    }
+    return [self trySetState:AWSTaskStateCancelled result:nil error:nil];
 }
 
 - (BOOL)isCompleted {
-    @synchronized(self.lock) {
-        return _completed;
+    return [self state] >= AWSTaskStateSucceeded;
+}
+
+- (BOOL)trySetState:(AWSTaskState)state result:(nullable id)result error:(nullable NSError *)error {
+    NSInteger expected = AWSTaskStatePending;
+    if (!atomic_compare_exchange_strong_explicit(&_state, &expected, AWSTaskStateCompleting,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return NO;
     }
+    _result = result;
+    _error = error;
+    // Sequentially consistent so that it is ordered against the lazy creation of the condition in `waitUntilFinished`.
+    atomic_store_explicit(&_state, state, memory_order_seq_cst);
+    [self runContinuations];
+    return YES;
 }
 
 - (void)runContinuations {
-    @synchronized(self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)(void) in self.callbacks) {
-            callback();
-        }
-        [self.callbacks removeAllObjects];
+    NSCondition *condition = (__bridge NSCondition *)atomic_load_explicit(&_condition, memory_order_seq_cst);
+    if (condition) {
+        [condition lock];
+        [condition broadcast];
+        [condition unlock];
+    }
+
+    uintptr_t head = atomic_exchange_explicit(&_continuations, AWSTaskContinuationsSealed, memory_order_acq_rel);
+
+    // The stack holds the newest continuation first; reverse it so continuations run in the order they were added.
+    AWSTaskContinuation *continuation = (AWSTaskContinuation *)head;
+    AWSTaskContinuation *ordered = NULL;
+    while (continuation) {
+        AWSTaskContinuation *next = continuation->next;
+        continuation->next = ordered;
+        ordered = continuation;
+        continuation = next;
+    }
+
+    while (ordered) {
+        AWSTaskContinuation *next = ordered->next;
+        dispatch_block_t callback = CFBridgingRelease(ordered->block);
+        free(ordered);
+        callback();
+        ordered = next;
     }
 }
 
+/**
+ Pushes `callback` onto the continuation stack. Returns NO if the continuations have already run, in which case the
+ caller must run `callback` itself.
+ */
+- (BOOL)addContinuation:(dispatch_block_t)callback {
+    uintptr_t head = atomic_load_explicit(&_continuations, memory_order_acquire);
+    if (head == AWSTaskContinuationsSealed) {
+        return NO;
+    }
+
+    AWSTaskContinuation *continuation = malloc(sizeof(AWSTaskContinuation));
+    if (!continuation) {
+        return NO;
+    }
+    continuation->block = (void *)CFBridgingRetain([callback copy]);
+
+    do {
+        if (head == AWSTaskContinuationsSealed) {
+            CFRelease(continuation->block);
+            free(continuation);
+            return NO;
+        }
+        continuation->next = (AWSTaskContinuation *)head;
+    } while (!atomic_compare_exchange_weak_explicit(&_continuations, &head, (uintptr_t)continuation,
+                                                    memory_order_release, memory_order_acquire));
+    return YES;
+}
+
 #pragma mark - Chaining methods
 
 - (AWSTask *)continueWithExecutor:(AWSExecutor *)executor withBlock:(AWSContinuationBlock)block {
@@ -355,16 +398,9 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         }
     };
 
-    BOOL completed;
-    @synchronized(self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[^{
-                [executor execute:executionBlock];
-            } copy]];
-        }
-    }
-    if (completed) {
+    if (self.completed || ![self addContinuation:^{
+        [executor execute:executionBlock];
+    }]) {
         [executor execute:executionBlock];
     }
 
@@ -419,35 +455,62 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         [self warnOperationOnMainThread];
     }
 
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return;
-        }
-        [self.condition lock];
+    if (self.completed) {
+        return;
     }
-    // TODO: (nlutsenko) Restructure this to use Bolts-Swift thread access synchronization architecture
-    // In the meantime, it's absolutely safe to get `_completed` aka an ivar, as long as it's a `BOOL` aka less than word size.
-    while (!_completed) {
-        [self.condition wait];
+
+    NSCondition *condition = [self waitCondition];
+    [condition lock];
+    // Either this load sees the task completed, or the completing thread sees the condition and broadcasts to it.
+    while (atomic_load_explicit(&_state, memory_order_seq_cst) < AWSTaskStateSucceeded) {
+        [condition wait];
     }
-    [self.condition unlock];
+    [condition unlock];
+}
+
+- (NSCondition *)waitCondition {
+    void *condition = atomic_load_explicit(&_condition, memory_order_acquire);
+    if (condition) {
+        return (__bridge NSCondition *)condition;
+    }
+
+    void *created = (void *)CFBridgingRetain([NSCondition new]);
+    if (atomic_compare_exchange_strong_explicit(&_condition, &condition, created,
+                                                memory_order_seq_cst, memory_order_acquire)) {
+        return (__bridge NSCondition *)created;
+    }
+    // Another waiter installed its condition first.
+    CFRelease(created);
+    return (__bridge NSCondition *)condition;
 }
 
 #pragma mark - NSObject
 
-- (NSString *)description {
-    // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-    NSString *resultDescription = nil;
-
-    @synchronized(self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-        resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
+- (void)dealloc {
+    uintptr_t head = atomic_load_explicit(&_continuations, memory_order_acquire);
+    if (head != AWSTaskContinuationsSealed) {
+        AWSTaskContinuation *continuation = (AWSTaskContinuation *)head;
+        while (continuation) {
+            AWSTaskContinuation *next = continuation->next;
+            CFRelease(continuation->block);
+            free(continuation);
+            continuation = next;
+        }
+    }
+
+    void *condition = atomic_load_explicit(&_condition, memory_order_acquire);
+    if (condition) {
+        CFRelease(condition);
     }
+}
+
+- (NSString *)description {
+    // Read the state once so the flags are consistent with each other
+    AWSTaskState state = [self state];
+    BOOL completed = state >= AWSTaskStateSucceeded;
+    BOOL cancelled = state == AWSTaskStateCancelled;
+    BOOL faulted = state == AWSTaskStateFaulted;
+    NSString *resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
 
     // Description string includes status information and, if available, the
     // result since in some ways this is what a promise actually "is".
@@ -0,0 +1,78 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSExecutor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ An executor backed by a fixed number of worker threads, each with its own deque of blocks.
+
+ Blocks submitted from outside the pool are spread across the workers round-robin. A block submitted from one of the
+ workers runs inline while that worker has at least a tenth of its stack left, measured from its stack address and
+ size, and otherwise goes to the back of that worker's deque. Workers take the oldest block from their own deque first and, when it is empty, steal the oldest block
+ from another worker, so no block waits behind work that was submitted after it.
+
+ Because the number of threads never grows, a block must not wait synchronously for another block submitted to the same
+ executor.
+ */
+@interface AWSWorkStealingExecutor : AWSExecutor
+
+/*!
+ Returns a shared executor with one worker per active processor.
+ */
++ (instancetype)sharedExecutor;
+
+/*!
+ Creates an executor with the given number of worker threads.
+ @param threadCount The number of worker threads. Must be greater than zero.
+ */
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ The number of worker threads.
+ */
+@property (nonatomic, readonly) NSUInteger threadCount;
+
+/*!
+ The number of blocks currently waiting in the worker deques.
+ */
+@property (nonatomic, readonly) NSUInteger queueDepth;
+
+/*!
+ The largest value `queueDepth` has reached.
+ */
+@property (nonatomic, readonly) NSUInteger maxQueueDepth;
+
+/*!
+ The number of blocks a worker took from another worker's deque.
+ */
+@property (nonatomic, readonly) NSUInteger stealCount;
+
+/*!
+ The number of blocks run inline on the submitting worker instead of being queued.
+ */
+@property (nonatomic, readonly) NSUInteger inlineCount;
+
+/*!
+ The number of blocks that have finished running.
+ */
+@property (nonatomic, readonly) NSUInteger executedCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
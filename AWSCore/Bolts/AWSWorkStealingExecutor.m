@@ -0,0 +1,331 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSWorkStealingExecutor.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const NSUInteger AWSWorkStealingDequeInitialCapacity = 64;
+
+// A growable ring buffer of retained blocks, guarded by its own lock. Each worker owns one; other workers only touch it
+// to steal.
+typedef struct {
+    pthread_mutex_t lock;
+    void *_Nullable *_Nullable blocks;
+    NSUInteger capacity;
+    NSUInteger head;
+    NSUInteger count;
+} AWSWorkStealingDeque;
+
+typedef struct {
+    void *pool;
+    NSUInteger index;
+} AWSWorkStealingWorkerContext;
+
+static pthread_key_t AWSWorkStealingWorkerContextKey;
+
+// Whether the calling thread has at least a tenth of its stack left, the same headroom `+[AWSExecutor defaultExecutor]`
+// keeps before it stops running blocks inline.
+__attribute__((noinline)) static BOOL AWSWorkStealingHasStackHeadroom(void) {
+    pthread_t currentThread = pthread_self();
+
+    // NOTE: We must store stack pointers as uint8_t so that the pointer math is well-defined
+    uint8_t *endStack = pthread_get_stackaddr_np(currentThread);
+    size_t totalSize = pthread_get_stacksize_np(currentThread);
+
+    // NOTE: If the function is inlined, this value could be incorrect
+    uint8_t *frameAddr = __builtin_frame_address(0);
+
+    size_t remainingSize = totalSize - (size_t)(endStack - frameAddr);
+    return remainingSize >= totalSize / 10;
+}
+
+// Returns the pool's queue depth including the pushed block, or 0 if the deque could not grow. The depth is counted
+// under the deque lock so it only includes blocks that were enqueued, and a stealing worker can never decrement it first.
+static NSUInteger AWSWorkStealingDequePush(AWSWorkStealingDeque *deque, void *block, _Atomic(NSUInteger) *queueDepth) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        NSUInteger capacity = deque->capacity ? deque->capacity * 2 : AWSWorkStealingDequeInitialCapacity;
+        void **blocks = malloc(capacity * sizeof(void *));
+        if (!blocks) {
+            pthread_mutex_unlock(&deque->lock);
+            return 0;
+        }
+        for (NSUInteger i = 0; i < deque->count; i++) {
+            blocks[i] = deque->blocks[(deque->head + i) & (deque->capacity - 1)];
+        }
+        free(deque->blocks);
+        deque->blocks = blocks;
+        deque->capacity = capacity;
+        deque->head = 0;
+    }
+    deque->blocks[(deque->head + deque->count) & (deque->capacity - 1)] = block;
+    deque->count++;
+    NSUInteger depth = atomic_fetch_add(queueDepth, 1) + 1;
+    pthread_mutex_unlock(&deque->lock);
+    return depth;
+}
+
+static void *_Nullable AWSWorkStealingDequePopOldest(AWSWorkStealingDeque *deque, _Atomic(NSUInteger) *queueDepth) {
+    pthread_mutex_lock(&deque->lock);
+    void *block = NULL;
+    if (deque->count > 0) {
+        block = deque->blocks[deque->head];
+        deque->head = (deque->head + 1) & (deque->capacity - 1);
+        deque->count--;
+        atomic_fetch_sub(queueDepth, 1);
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return block;
+}
+
+#pragma mark - AWSWorkStealingExecutorPool
+
+/**
+ The worker threads and their deques. The threads retain the pool rather than the executor, so releasing the last
+ reference to an executor shuts its pool down; the pool itself goes away once every worker has drained and exited.
+ */
+@interface AWSWorkStealingExecutorPool : NSObject {
+@package
+    NSUInteger _threadCount;
+    _Atomic(NSUInteger) _queueDepth;
+    _Atomic(NSUInteger) _maxQueueDepth;
+    _Atomic(NSUInteger) _stealCount;
+    _Atomic(NSUInteger) _inlineCount;
+    _Atomic(NSUInteger) _executedCount;
+}
+
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount;
+
+- (void)submit:(dispatch_block_t)block;
+
+- (void)shutdown;
+
+@end
+
+@implementation AWSWorkStealingExecutorPool {
+    AWSWorkStealingDeque *_deques;
+    AWSWorkStealingWorkerContext *_contexts;
+    _Atomic(NSUInteger) _nextWorker;
+    _Atomic(NSUInteger) _idleWorkers;
+    _Atomic(bool) _shuttingDown;
+    pthread_mutex_t _idleLock;
+    pthread_cond_t _idleCondition;
+}
+
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount {
+    if (self = [super init]) {
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            pthread_key_create(&AWSWorkStealingWorkerContextKey, NULL);
+        });
+
+        _deques = calloc(threadCount, sizeof(AWSWorkStealingDeque));
+        _contexts = calloc(threadCount, sizeof(AWSWorkStealingWorkerContext));
+        if (!_deques || !_contexts) {
+            free(_deques);
+            free(_contexts);
+            return nil;
+        }
+        _threadCount = threadCount;
+        pthread_mutex_init(&_idleLock, NULL);
+        pthread_cond_init(&_idleCondition, NULL);
+        atomic_init(&_queueDepth, 0);
+        atomic_init(&_maxQueueDepth, 0);
+        atomic_init(&_stealCount, 0);
+        atomic_init(&_inlineCount, 0);
+        atomic_init(&_executedCount, 0);
+        atomic_init(&_nextWorker, 0);
+        atomic_init(&_idleWorkers, 0);
+        atomic_init(&_shuttingDown, false);
+
+        for (NSUInteger i = 0; i < threadCount; i++) {
+            pthread_mutex_init(&_deques[i].lock, NULL);
+            _contexts[i].pool = (__bridge void *)self;
+            _contexts[i].index = i;
+        }
+        for (NSUInteger i = 0; i < threadCount; i++) {
+            NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(runWorker:) object:@(i)];
+            thread.name = [NSString stringWithFormat:@"com.amazonaws.AWSWorkStealingExecutor.worker.%lu", (unsigned long)i];
+            [thread start];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _threadCount; i++) {
+        free(_deques[i].blocks);
+        pthread_mutex_destroy(&_deques[i].lock);
+    }
+    free(_deques);
+    free(_contexts);
+    pthread_mutex_destroy(&_idleLock);
+    pthread_cond_destroy(&_idleCondition);
+}
+
+- (void)submit:(dispatch_block_t)block {
+    AWSWorkStealingWorkerContext *context = pthread_getspecific(AWSWorkStealingWorkerContextKey);
+    NSUInteger index;
+    if (context && context->pool == (__bridge void *)self) {
+        if (AWSWorkStealingHasStackHeadroom()) {
+            atomic_fetch_add_explicit(&_inlineCount, 1, memory_order_relaxed);
+            @autoreleasepool {
+                block();
+            }
+            atomic_fetch_add_explicit(&_executedCount, 1, memory_order_relaxed);
+            return;
+        }
+        index = context->index;
+    } else {
+        index = atomic_fetch_add_explicit(&_nextWorker, 1, memory_order_relaxed) % _threadCount;
+    }
+
+    void *retainedBlock = (void *)CFBridgingRetain([block copy]);
+    NSUInteger depth = AWSWorkStealingDequePush(&_deques[index], retainedBlock, &_queueDepth);
+    if (depth == 0) {
+        CFRelease(retainedBlock);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), block);
+        return;
+    }
+
+    NSUInteger maxDepth = atomic_load_explicit(&_maxQueueDepth, memory_order_relaxed);
+    while (depth > maxDepth
+           && !atomic_compare_exchange_weak_explicit(&_maxQueueDepth, &maxDepth, depth, memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    // Pairs with the increment of _idleWorkers in -waitForWork: either the worker sees the new depth, or this sees it idle.
+    if (atomic_load(&_idleWorkers) > 0) {
+        pthread_mutex_lock(&_idleLock);
+        pthread_cond_signal(&_idleCondition);
+        pthread_mutex_unlock(&_idleLock);
+    }
+}
+
+- (void)shutdown {
+    atomic_store(&_shuttingDown, true);
+    pthread_mutex_lock(&_idleLock);
+    pthread_cond_broadcast(&_idleCondition);
+    pthread_mutex_unlock(&_idleLock);
+}
+
+- (void)runWorker:(NSNumber *)workerIndex {
+    NSUInteger index = [workerIndex unsignedIntegerValue];
+    pthread_setspecific(AWSWorkStealingWorkerContextKey, &_contexts[index]);
+    do {
+        void *retainedBlock;
+        while ((retainedBlock = [self nextBlockForWorker:index])) {
+            @autoreleasepool {
+                dispatch_block_t block = CFBridgingRelease(retainedBlock);
+                block();
+            }
+            atomic_fetch_add_explicit(&_executedCount, 1, memory_order_relaxed);
+        }
+    } while ([self waitForWork]);
+    pthread_setspecific(AWSWorkStealingWorkerContextKey, NULL);
+}
+
+- (nullable void *)nextBlockForWorker:(NSUInteger)index {
+    void *block = AWSWorkStealingDequePopOldest(&_deques[index], &_queueDepth);
+    for (NSUInteger offset = 1; !block && offset < _threadCount; offset++) {
+        block = AWSWorkStealingDequePopOldest(&_deques[(index + offset) % _threadCount], &_queueDepth);
+        if (block) {
+            atomic_fetch_add_explicit(&_stealCount, 1, memory_order_relaxed);
+        }
+    }
+    return block;
+}
+
+/**
+ Blocks until there may be queued work. Returns NO once the pool is shutting down and every deque has drained.
+ */
+- (BOOL)waitForWork {
+    pthread_mutex_lock(&_idleLock);
+    atomic_fetch_add(&_idleWorkers, 1);
+    while (atomic_load(&_queueDepth) == 0 && !atomic_load(&_shuttingDown)) {
+        pthread_cond_wait(&_idleCondition, &_idleLock);
+    }
+    atomic_fetch_sub(&_idleWorkers, 1);
+    BOOL hasWork = atomic_load(&_queueDepth) > 0;
+    BOOL shuttingDown = atomic_load(&_shuttingDown);
+    pthread_mutex_unlock(&_idleLock);
+    return hasWork || !shuttingDown;
+}
+
+@end
+
+#pragma mark - AWSWorkStealingExecutor
+
+@implementation AWSWorkStealingExecutor {
+    AWSWorkStealingExecutorPool *_pool;
+}
+
++ (instancetype)sharedExecutor {
+    static AWSWorkStealingExecutor *sharedExecutor = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedExecutor = [[self alloc] initWithThreadCount:[NSProcessInfo processInfo].activeProcessorCount];
+    });
+    return sharedExecutor;
+}
+
+- (instancetype)initWithThreadCount:(NSUInteger)threadCount {
+    if (self = [super init]) {
+        _pool = [[AWSWorkStealingExecutorPool alloc] initWithThreadCount:MAX(threadCount, (NSUInteger)1)];
+        if (!_pool) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_pool shutdown];
+}
+
+- (void)execute:(void(^)(void))block {
+    [_pool submit:block];
+}
+
+- (NSUInteger)threadCount {
+    return _pool->_threadCount;
+}
+
+- (NSUInteger)queueDepth {
+    return atomic_load_explicit(&_pool->_queueDepth, memory_order_relaxed);
+}
+
+- (NSUInteger)maxQueueDepth {
+    return atomic_load_explicit(&_pool->_maxQueueDepth, memory_order_relaxed);
+}
+
+- (NSUInteger)stealCount {
+    return atomic_load_explicit(&_pool->_stealCount, memory_order_relaxed);
+}
+
+- (NSUInteger)inlineCount {
+    return atomic_load_explicit(&_pool->_inlineCount, memory_order_relaxed);
+}
+
+- (NSUInteger)executedCount {
+    return atomic_load_explicit(&_pool->_executedCount, memory_order_relaxed);
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -19,11 +19,91 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ The settings the SDK applies to each connection of its SQLite stores.
+ */
+@interface AWSFMDatabaseStorageConfiguration : NSObject <NSCopying>
+
+/**
+ The configuration used by `serialDatabaseQueueWithPath:`.
+ */
++ (instancetype)defaultConfiguration;
+
+/**
+ Whether prepared statements are kept and reused. Defaults to `YES`.
+ */
+@property (nonatomic, assign) BOOL shouldCacheStatements;
+
+/**
+ Whether the database uses write-ahead logging (`PRAGMA journal_mode = WAL`). Defaults to `YES`.
+ */
+@property (nonatomic, assign) BOOL usesWriteAheadLogging;
+
+/**
+ The value for `PRAGMA synchronous`. Defaults to `NORMAL`, which in WAL mode only syncs at checkpoints, so a
+ committed transaction can be lost on power failure but the database cannot be corrupted.
+ */
+@property (nonatomic, copy) NSString *synchronous;
+
+/**
+ The number of WAL pages after which a commit checkpoints (`PRAGMA wal_autocheckpoint`). Defaults to 1000.
+ */
+@property (nonatomic, assign) NSUInteger autoCheckpointPageCount;
+
+/**
+ The size in bytes the WAL file is truncated to after a checkpoint (`PRAGMA journal_size_limit`). Defaults to 1 MB.
+ */
+@property (nonatomic, assign) int64_t journalSizeLimit;
+
+/**
+ How long a statement keeps retrying while the database is locked by another connection. Defaults to 2 seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval busyTimeout;
+
+@end
+
+/**
+ Counts and times the blocks run on a database queue. All values are updated atomically and may be read from any
+ thread.
+ */
+@interface AWSFMDatabaseQueueStatistics : NSObject
+
+/**
+ The number of `inDatabase:`, transaction and save point blocks that have finished.
+ */
+@property (nonatomic, readonly) NSUInteger operationCount;
+
+/**
+ The time spent running those blocks, including beginning and committing transactions.
+ */
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+
+/**
+ The longest time spent running a single block.
+ */
+@property (nonatomic, readonly) NSTimeInterval maximumDuration;
+
+/**
+ `totalDuration` divided by `operationCount`.
+ */
+@property (nonatomic, readonly) NSTimeInterval averageDuration;
+
+/**
+ The time callers spent waiting for the queue before their block started.
+ */
+@property (nonatomic, readonly) NSTimeInterval totalWaitDuration;
+
+/**
+ Sets every counter back to zero.
+ */
+- (void)reset;
+
+@end
+
 @interface AWSFMDatabaseQueue (AWSHelpers)
 
 /**
- Convenience method to open a database queue with the SQLITE_OPEN_FULLMUTEX flag so it can be safely accessed across
- threads.
+ Convenience method to open a database queue configured with `[AWSFMDatabaseStorageConfiguration defaultConfiguration]`.
 
  @param aPath The file path of the database.
 
@@ -32,6 +112,25 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)serialDatabaseQueueWithPath:(NSString*)aPath;
 
+/**
+ Opens a database queue whose connection is configured as given and which records `aws_statistics`.
+
+ Every access goes through the queue, so the connection is opened with `SQLITE_OPEN_NOMUTEX` and SQLite does not lock
+ it again. Use the database only inside the queue's blocks.
+
+ @param aPath The file path of the database.
+ @param configuration The settings applied each time the connection is opened.
+
+ @return The `FMDatabaseQueue` object. `nil` on error.
+ */
++ (instancetype)serialDatabaseQueueWithPath:(NSString*)aPath
+                              configuration:(AWSFMDatabaseStorageConfiguration *)configuration;
+
+/**
+ Latency counters for queues opened with `serialDatabaseQueueWithPath:`, `nil` for other queues.
+ */
+@property (nonatomic, readonly, nullable) AWSFMDatabaseQueueStatistics *aws_statistics;
+
 @end
 
 
@@ -15,16 +15,243 @@
 
 #import <Foundation/Foundation.h>
 #import <sqlite3.h>
+#import <mach/mach_time.h>
+#import <stdatomic.h>
 #import "AWSFMDB+AWSHelpers.h"
 
+static NSTimeInterval AWSFMDatabaseQueueSecondsFromTicks(uint64_t ticks) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return (double)ticks * timebase.numer / timebase.denom / NSEC_PER_SEC;
+}
+
+@interface AWSFMDatabaseStorageConfiguration ()
+
+- (void)applyToDatabase:(AWSFMDatabase *)db;
+
+@end
+
+@implementation AWSFMDatabaseStorageConfiguration
+
++ (instancetype)defaultConfiguration {
+    return [self new];
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _shouldCacheStatements = YES;
+        _usesWriteAheadLogging = YES;
+        _synchronous = @"NORMAL";
+        _autoCheckpointPageCount = 1000;
+        _journalSizeLimit = 1024 * 1024;
+        _busyTimeout = 2;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    AWSFMDatabaseStorageConfiguration *configuration = [[[self class] allocWithZone:zone] init];
+    configuration.shouldCacheStatements = self.shouldCacheStatements;
+    configuration.usesWriteAheadLogging = self.usesWriteAheadLogging;
+    configuration.synchronous = self.synchronous;
+    configuration.autoCheckpointPageCount = self.autoCheckpointPageCount;
+    configuration.journalSizeLimit = self.journalSizeLimit;
+    configuration.busyTimeout = self.busyTimeout;
+    return configuration;
+}
+
+- (void)applyToDatabase:(AWSFMDatabase *)db {
+    db.shouldCacheStatements = self.shouldCacheStatements;
+    [db setMaxBusyRetryTimeInterval:self.busyTimeout];
+
+    NSMutableArray<NSString *> *statements = [NSMutableArray new];
+    if (self.usesWriteAheadLogging) {
+        [statements addObject:@"PRAGMA journal_mode = WAL"];
+        [statements addObject:[NSString stringWithFormat:@"PRAGMA wal_autocheckpoint = %lu",
+                               (unsigned long)self.autoCheckpointPageCount]];
+    }
+    if (self.synchronous.length > 0) {
+        [statements addObject:[NSString stringWithFormat:@"PRAGMA synchronous = %@", self.synchronous]];
+    }
+    [statements addObject:[NSString stringWithFormat:@"PRAGMA journal_size_limit = %lld", self.journalSizeLimit]];
+
+    for (NSString *statement in statements) {
+        if (![db executeStatements:statement]) {
+            AWSDDLogError(@"Failed to execute '%@'. [%@]", statement, db.lastError);
+        }
+    }
+}
+
+@end
+
+@interface AWSFMDatabaseQueueStatistics ()
+
+- (void)recordOperationEnqueuedAt:(uint64_t)enqueued startedAt:(uint64_t)started finishedAt:(uint64_t)finished;
+
+@end
+
+@implementation AWSFMDatabaseQueueStatistics {
+    _Atomic(uint64_t) _operationCount;
+    _Atomic(uint64_t) _totalTicks;
+    _Atomic(uint64_t) _maximumTicks;
+    _Atomic(uint64_t) _totalWaitTicks;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        atomic_init(&_operationCount, 0);
+        atomic_init(&_totalTicks, 0);
+        atomic_init(&_maximumTicks, 0);
+        atomic_init(&_totalWaitTicks, 0);
+    }
+    return self;
+}
+
+- (void)recordOperationEnqueuedAt:(uint64_t)enqueued startedAt:(uint64_t)started finishedAt:(uint64_t)finished {
+    uint64_t ticks = finished - started;
+    atomic_fetch_add_explicit(&_operationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_totalTicks, ticks, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_totalWaitTicks, started - enqueued, memory_order_relaxed);
+    uint64_t maximumTicks = atomic_load_explicit(&_maximumTicks, memory_order_relaxed);
+    while (ticks > maximumTicks
+           && !atomic_compare_exchange_weak_explicit(&_maximumTicks, &maximumTicks, ticks, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+- (NSUInteger)operationCount {
+    return (NSUInteger)atomic_load_explicit(&_operationCount, memory_order_relaxed);
+}
+
+- (NSTimeInterval)totalDuration {
+    return AWSFMDatabaseQueueSecondsFromTicks(atomic_load_explicit(&_totalTicks, memory_order_relaxed));
+}
+
+- (NSTimeInterval)maximumDuration {
+    return AWSFMDatabaseQueueSecondsFromTicks(atomic_load_explicit(&_maximumTicks, memory_order_relaxed));
+}
+
+- (NSTimeInterval)averageDuration {
+    NSUInteger operationCount = self.operationCount;
+    return operationCount > 0 ? self.totalDuration / operationCount : 0;
+}
+
+- (NSTimeInterval)totalWaitDuration {
+    return AWSFMDatabaseQueueSecondsFromTicks(atomic_load_explicit(&_totalWaitTicks, memory_order_relaxed));
+}
+
+- (void)reset {
+    atomic_store_explicit(&_operationCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_totalTicks, 0, memory_order_relaxed);
+    atomic_store_explicit(&_maximumTicks, 0, memory_order_relaxed);
+    atomic_store_explicit(&_totalWaitTicks, 0, memory_order_relaxed);
+}
+
+@end
+
+/**
+ The queue returned by `serialDatabaseQueueWithPath:configuration:`. It applies the configuration each time the queue
+ opens its connection, including after `close`, and times every block.
+ */
+@interface AWSFMSerialDatabaseQueue : AWSFMDatabaseQueue
+
+@property (nonatomic, copy) AWSFMDatabaseStorageConfiguration *configuration;
+@property (nonatomic, strong) AWSFMDatabaseQueueStatistics *statistics;
+
+@end
+
+@interface AWSFMDatabaseQueue ()
+
+// Opens the connection if it is not open yet. Only called on the queue.
+- (AWSFMDatabase *)database;
+
+@end
+
+@implementation AWSFMSerialDatabaseQueue
+
+- (AWSFMDatabase *)database {
+    BOOL isOpening = _db == nil;
+    AWSFMDatabase *db = [super database];
+    if (isOpening && db) {
+        [self.configuration applyToDatabase:db];
+    }
+    return db;
+}
+
+- (AWSFMDatabaseQueueStatistics *)aws_statistics {
+    return self.statistics;
+}
+
+- (void)inDatabase:(void (^)(AWSFMDatabase *db))block {
+    __block uint64_t started = 0;
+    uint64_t enqueued = mach_absolute_time();
+    [super inDatabase:^(AWSFMDatabase *db) {
+        started = mach_absolute_time();
+        block(db);
+    }];
+    [self.statistics recordOperationEnqueuedAt:enqueued startedAt:started finishedAt:mach_absolute_time()];
+}
+
+- (void)inTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+    __block uint64_t started = 0;
+    uint64_t enqueued = mach_absolute_time();
+    [super inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        started = mach_absolute_time();
+        block(db, rollback);
+    }];
+    [self.statistics recordOperationEnqueuedAt:enqueued startedAt:started finishedAt:mach_absolute_time()];
+}
+
+- (void)inDeferredTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+    __block uint64_t started = 0;
+    uint64_t enqueued = mach_absolute_time();
+    [super inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        started = mach_absolute_time();
+        block(db, rollback);
+    }];
+    [self.statistics recordOperationEnqueuedAt:enqueued startedAt:started finishedAt:mach_absolute_time()];
+}
+
+- (NSError *)inSavePoint:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+    __block uint64_t started = 0;
+    uint64_t enqueued = mach_absolute_time();
+    NSError *error = [super inSavePoint:^(AWSFMDatabase *db, BOOL *rollback) {
+        started = mach_absolute_time();
+        block(db, rollback);
+    }];
+    [self.statistics recordOperationEnqueuedAt:enqueued startedAt:started finishedAt:mach_absolute_time()];
+    return error;
+}
+
+@end
+
 @implementation AWSFMDatabaseQueue (AWSHelpers)
 
 + (instancetype)serialDatabaseQueueWithPath:(NSString*)aPath {
-    // Open the database queue in readwrite mode, creating if necessary, with full mutex to prevent errors
-    // when accessing across threads.
-    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
-    return [AWSFMDatabaseQueue databaseQueueWithPath:aPath
-                                               flags:flags];
+    return [self serialDatabaseQueueWithPath:aPath configuration:[AWSFMDatabaseStorageConfiguration defaultConfiguration]];
+}
+
++ (instancetype)serialDatabaseQueueWithPath:(NSString*)aPath
+                              configuration:(AWSFMDatabaseStorageConfiguration *)configuration {
+    // Open the database queue in readwrite mode, creating if necessary. The queue serializes every access, so SQLite's
+    // own per-connection mutex is not needed.
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    AWSFMSerialDatabaseQueue *databaseQueue = [AWSFMSerialDatabaseQueue databaseQueueWithPath:aPath
+                                                                                         flags:flags];
+    databaseQueue.configuration = configuration;
+    // The queue opened its connection before it had a configuration, so this first connection is configured here.
+    // Connections opened again after `close` are configured by `database`.
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [databaseQueue.configuration applyToDatabase:db];
+    }];
+    databaseQueue.statistics = [AWSFMDatabaseQueueStatistics new];
+    return databaseQueue;
+}
+
+- (AWSFMDatabaseQueueStatistics *)aws_statistics {
+    return nil;
 }
 
 @end
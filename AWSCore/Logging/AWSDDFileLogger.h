@@ -33,6 +33,7 @@
 // rollingFrequency        -> kAWSDDDefaultLogRollingFrequency
 // maximumNumberOfLogFiles -> kAWSDDDefaultLogMaxNumLogFiles
 // logFilesDiskQuota       -> kAWSDDDefaultLogFilesDiskQuota
+// bufferFlushInterval     -> kAWSDDDefaultLogBufferFlushInterval
 //
 // You should carefully consider the proper configuration values for your application.
 
@@ -40,6 +41,7 @@ extern unsigned long long const kAWSDDDefaultLogMaxFileSize;
 extern NSTimeInterval     const kAWSDDDefaultLogRollingFrequency;
 extern NSUInteger         const kAWSDDDefaultLogMaxNumLogFiles;
 extern unsigned long long const kAWSDDDefaultLogFilesDiskQuota;
+extern NSTimeInterval     const kAWSDDDefaultLogBufferFlushInterval;
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -393,6 +395,39 @@ extern unsigned long long const kAWSDDDefaultLogFilesDiskQuota;
  **/
 @property (nonatomic, readwrite, assign) BOOL automaticallyAppendNewlineForCustomFormatters;
 
+/**
+ * Write-behind buffering:
+ *
+ * `maximumBufferSize`
+ *   When greater than zero, log lines are collected in memory and written to the log file with a single write
+ *   once this many bytes are waiting, instead of with one write per line.
+ *   Default is zero, which writes every line as it is logged.
+ *
+ * `bufferFlushInterval`
+ *   The longest time, in seconds, a buffered line waits before it is written.
+ *   Only used when `maximumBufferSize` is greater than zero.
+ *
+ * The buffer is also written before the log file is rolled, when `[AWSDDLog flushLog]` is called
+ * (which happens automatically when the application terminates), and when an iOS application enters the background.
+ * Lines still in the buffer are lost if the process crashes.
+ **/
+@property (readwrite, assign, atomic) NSUInteger maximumBufferSize;
+
+/**
+ *  See description for `maximumBufferSize`
+ */
+@property (readwrite, assign, atomic) NSTimeInterval bufferFlushInterval;
+
+/**
+ * When set, log files opened from then on are appended to through a shared memory mapping instead of with a write
+ * per line. A line reaches the kernel as soon as it is copied into the mapping, so it is kept if the process is killed
+ * or crashes, but not if the device loses power before the kernel writes it out. While mapped, the file is grown a
+ * megabyte at a time and trimmed back to the logged length when it is closed or rolled. If the process dies first, the
+ * unused part is left as NUL padding, which is trimmed when the file is next opened for logging. Takes precedence over
+ * `maximumBufferSize`. Default is NO.
+ **/
+@property (readwrite, assign, atomic) BOOL usesMemoryMappedAppends;
+
 /**
  *  You can optionally force the current log file to be rolled with this method.
  *  CompletionBlock will be called on main queue.
@@ -15,7 +15,9 @@
 
 #import "AWSDDFileLogger.h"
 
+#import <fcntl.h>
 #import <unistd.h>
+#import <sys/mman.h>
 #import <sys/attr.h>
 #import <sys/xattr.h>
 #import <libkern/OSAtomic.h>
@@ -50,6 +52,46 @@ unsigned long long const kAWSDDDefaultLogMaxFileSize      = 1024 * 1024;      //
 NSTimeInterval     const kAWSDDDefaultLogRollingFrequency = 60 * 60 * 24;     // 24 Hours
 NSUInteger         const kAWSDDDefaultLogMaxNumLogFiles   = 5;                // 5 Files
 unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; // 20 MB
+NSTimeInterval     const kAWSDDDefaultLogBufferFlushInterval = 1;             // 1 Second
+
+// How much a memory mapped log file is grown by at a time.
+static size_t const kAWSDDMappedAppendWindowSize = 1024 * 1024;
+
+// A process killed while appending through a mapping leaves the unused part of the last window as NUL bytes at the end
+// of the file. Log lines never contain NUL, so the file is cut back to its last non-NUL byte. Returns whether the file
+// was changed.
+static BOOL AWSDDTrimMappedAppendPadding(NSString *filePath) {
+    int fileDescriptor = open([filePath fileSystemRepresentation], O_RDWR);
+    if (fileDescriptor < 0) {
+        return NO;
+    }
+
+    off_t end = lseek(fileDescriptor, 0, SEEK_END);
+    off_t logicalEnd = end;
+    uint8_t bytes[4096];
+    while (logicalEnd > 0) {
+        size_t length = (size_t)MIN((off_t)sizeof(bytes), logicalEnd);
+        if (pread(fileDescriptor, bytes, length, logicalEnd - (off_t)length) != (ssize_t)length) {
+            break;
+        }
+        size_t index = length;
+        while (index > 0 && bytes[index - 1] == 0) {
+            index--;
+        }
+        logicalEnd -= (off_t)(length - index);
+        if (index > 0) {
+            break;
+        }
+    }
+
+    BOOL trimmed = logicalEnd < end && ftruncate(fileDescriptor, logicalEnd) == 0;
+    close(fileDescriptor);
+    if (trimmed) {
+        NSLogInfo(@"AWSDDFileLogger: Trimmed %lld bytes of padding left by memory mapped appends from %@",
+                  (long long)(end - logicalEnd), filePath);
+    }
+    return trimmed;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma mark -
@@ -564,6 +606,16 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     
     unsigned long long _maximumFileSize;
     NSTimeInterval _rollingFrequency;
+
+    NSMutableData *_writeBuffer;
+    dispatch_source_t _bufferFlushTimer;
+
+    // Set when the current log file was opened with `usesMemoryMappedAppends`.
+    BOOL _isMappingCurrentLogFile;
+    uint8_t *_mappedBytes;
+    unsigned long long _mappedFileOffset;
+    size_t _mappedLength;
+    unsigned long long _mappedLogLength;
 }
 
 - (void)rollLogFileNow;
@@ -585,16 +637,29 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         _maximumFileSize = kAWSDDDefaultLogMaxFileSize;
         _rollingFrequency = kAWSDDDefaultLogRollingFrequency;
         _automaticallyAppendNewlineForCustomFormatters = YES;
+        _bufferFlushInterval = kAWSDDDefaultLogBufferFlushInterval;
 
         logFileManager = aLogFileManager;
 
         self.logFormatter = [AWSDDLogFileFormatterDefault new];
+
+#if TARGET_OS_IOS
+        // Apps in the background are usually suspended and killed without a terminate notification.
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(applicationDidEnterBackground:)
+                                                     name:@"UIApplicationDidEnterBackgroundNotification"
+                                                   object:nil];
+#endif
     }
 
     return self;
 }
 
 - (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+
+    [self flushWriteBuffer];
+    [self unmapCurrentLogFile];
     [_currentLogFileHandle synchronizeFile];
     [_currentLogFileHandle closeFile];
 
@@ -817,6 +882,8 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         return;
     }
 
+    [self flushWriteBuffer];
+    [self unmapCurrentLogFile];
     [_currentLogFileHandle synchronizeFile];
     [_currentLogFileHandle closeFile];
     _currentLogFileHandle = nil;
@@ -858,7 +925,7 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     // We specifically wrote our own getter/setter method to allow us to do this (for performance reasons).
 
     if (_maximumFileSize > 0) {
-        unsigned long long fileSize = [_currentLogFileHandle offsetInFile];
+        unsigned long long fileSize = [self currentLogFileLength];
 
         if (fileSize >= _maximumFileSize) {
             NSLogVerbose(@"AWSDDFileLogger: Rolling log file due to size (%qu)...", fileSize);
@@ -888,6 +955,11 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 
             BOOL shouldArchiveMostRecent = NO;
 
+            // Trimmed before its size is checked, so that padding does not make it look full.
+            if (!mostRecentLogFileInfo.isArchived && AWSDDTrimMappedAppendPadding(mostRecentLogFileInfo.filePath)) {
+                [mostRecentLogFileInfo reset];
+            }
+
             if (mostRecentLogFileInfo.isArchived) {
                 shouldArchiveMostRecent = NO;
 			} else if ([self shouldArchiveRecentLogFileInfo:mostRecentLogFileInfo]) {
@@ -949,8 +1021,15 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     if (_currentLogFileHandle == nil) {
         NSString *logFilePath = [[self currentLogFileInfo] filePath];
 
-        _currentLogFileHandle = [NSFileHandle fileHandleForWritingAtPath:logFilePath];
-        [_currentLogFileHandle seekToEndOfFile];
+        // A shared writable mapping needs a descriptor that is open for reading as well.
+        _isMappingCurrentLogFile = self.usesMemoryMappedAppends;
+        if (_isMappingCurrentLogFile) {
+            _currentLogFileHandle = [NSFileHandle fileHandleForUpdatingAtPath:logFilePath];
+        } else {
+            _currentLogFileHandle = [NSFileHandle fileHandleForWritingAtPath:logFilePath];
+        }
+        _mappedLogLength = [_currentLogFileHandle seekToEndOfFile];
+        _isMappingCurrentLogFile = _isMappingCurrentLogFile && _currentLogFileHandle != nil;
 
         if (_currentLogFileHandle) {
             [self scheduleTimerToRollLogFileDueToAge];
@@ -1008,7 +1087,7 @@ static int exception_count = 0;
         @try {
             [self willLogMessage];
 			
-            [[self currentLogFileHandle] writeData:logData];
+            [self writeLogData:logData];
 
             [self didLogMessage];
         } @catch (NSException *exception) {
@@ -1025,6 +1104,158 @@ static int exception_count = 0;
     }
 }
 
+- (void)writeLogData:(NSData *)logData {
+    NSFileHandle *fileHandle = [self currentLogFileHandle];
+
+    if (_isMappingCurrentLogFile) {
+        if ([self appendMappedBytes:logData.bytes length:logData.length]) {
+            return;
+        }
+        NSLogError(@"AWSDDFileLogger: Could not map the log file, falling back to writing it: %s", strerror(errno));
+        [self unmapCurrentLogFile];
+    }
+
+    NSUInteger maximumBufferSize = self.maximumBufferSize;
+    if (maximumBufferSize == 0) {
+        [self flushWriteBuffer];
+        [fileHandle writeData:logData];
+        return;
+    }
+
+    if (_writeBuffer == nil) {
+        _writeBuffer = [NSMutableData dataWithCapacity:maximumBufferSize];
+    }
+    [_writeBuffer appendData:logData];
+
+    if (_writeBuffer.length >= maximumBufferSize) {
+        [self flushWriteBuffer];
+    } else if (_bufferFlushTimer == NULL) {
+        [self scheduleTimerToFlushWriteBuffer];
+    }
+}
+
+- (void)scheduleTimerToFlushWriteBuffer {
+    _bufferFlushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.loggerQueue);
+
+    dispatch_source_set_event_handler(_bufferFlushTimer, ^{ @autoreleasepool {
+                                                               [self flushWriteBuffer];
+                                                           } });
+
+    #if !OS_OBJECT_USE_OBJC
+    dispatch_source_t theBufferFlushTimer = _bufferFlushTimer;
+    dispatch_source_set_cancel_handler(_bufferFlushTimer, ^{
+        dispatch_release(theBufferFlushTimer);
+    });
+    #endif
+
+    uint64_t delay = (uint64_t)(MAX(self.bufferFlushInterval, 0) * (NSTimeInterval) NSEC_PER_SEC);
+    dispatch_source_set_timer(_bufferFlushTimer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, delay / 10);
+    dispatch_resume(_bufferFlushTimer);
+}
+
+- (void)flushWriteBuffer {
+    if (_bufferFlushTimer) {
+        dispatch_source_cancel(_bufferFlushTimer);
+        _bufferFlushTimer = NULL;
+    }
+
+    if (_writeBuffer.length == 0) {
+        return;
+    }
+
+    @try {
+        [_currentLogFileHandle writeData:_writeBuffer];
+    } @catch (NSException *exception) {
+        NSLogError(@"AWSDDFileLogger: Dropping %lu buffered bytes: %@", (unsigned long)_writeBuffer.length, exception);
+    }
+    _writeBuffer.length = 0;
+}
+
+- (unsigned long long)currentLogFileLength {
+    if (_isMappingCurrentLogFile) {
+        return _mappedLogLength;
+    }
+    return [_currentLogFileHandle offsetInFile] + _writeBuffer.length;
+}
+
+- (BOOL)appendMappedBytes:(const void *)bytes length:(size_t)length {
+    if (_mappedBytes == NULL || _mappedLogLength + length > _mappedFileOffset + _mappedLength) {
+        if (![self mapLogFileForAppendingLength:length]) {
+            return NO;
+        }
+    }
+
+    memcpy(_mappedBytes + (_mappedLogLength - _mappedFileOffset), bytes, length);
+    _mappedLogLength += length;
+    return YES;
+}
+
+- (BOOL)mapLogFileForAppendingLength:(size_t)length {
+    if (_mappedBytes) {
+        munmap(_mappedBytes, _mappedLength);
+        _mappedBytes = NULL;
+    }
+
+    int fileDescriptor = [_currentLogFileHandle fileDescriptor];
+    size_t pageSize = (size_t)getpagesize();
+    // Mappings have to start on a page boundary, so the window starts at the page holding the end of the log.
+    unsigned long long fileOffset = _mappedLogLength - (_mappedLogLength % pageSize);
+    size_t mappedLength = MAX(kAWSDDMappedAppendWindowSize, (size_t)(_mappedLogLength - fileOffset) + length);
+    mappedLength = (mappedLength + pageSize - 1) / pageSize * pageSize;
+
+    if (ftruncate(fileDescriptor, (off_t)(fileOffset + mappedLength)) != 0) {
+        return NO;
+    }
+    void *mappedBytes = mmap(NULL, mappedLength, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, (off_t)fileOffset);
+    if (mappedBytes == MAP_FAILED) {
+        ftruncate(fileDescriptor, (off_t)_mappedLogLength);
+        return NO;
+    }
+
+    _mappedBytes = mappedBytes;
+    _mappedFileOffset = fileOffset;
+    _mappedLength = mappedLength;
+    return YES;
+}
+
+- (void)unmapCurrentLogFile {
+    if (!_isMappingCurrentLogFile) {
+        return;
+    }
+    _isMappingCurrentLogFile = NO;
+
+    if (_mappedBytes) {
+        munmap(_mappedBytes, _mappedLength);
+        _mappedBytes = NULL;
+    }
+
+    // Trim the unused part of the last window, and leave the handle ready for ordinary writes.
+    ftruncate([_currentLogFileHandle fileDescriptor], (off_t)_mappedLogLength);
+    [_currentLogFileHandle seekToFileOffset:_mappedLogLength];
+}
+
+- (void)flush {
+    // This method is invoked on the logger queue by [AWSDDLog flushLog].
+    [self flushWriteBuffer];
+}
+
+- (void)applicationDidEnterBackground:(NSNotification * __attribute__((unused)))notification {
+    dispatch_block_t block = ^{
+        @autoreleasepool {
+            [self flushWriteBuffer];
+        }
+    };
+
+    // The design of this method is taken from the AWSDDAbstractLogger implementation.
+    // For extensive documentation please refer to the AWSDDAbstractLogger implementation.
+
+    dispatch_queue_t globalLoggingQueue = [AWSDDLog loggingQueue];
+
+    dispatch_async(globalLoggingQueue, ^{
+        dispatch_async(self.loggerQueue, block);
+    });
+}
+
 - (void)willLogMessage {
 	
 }
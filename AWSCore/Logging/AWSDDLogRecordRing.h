@@ -0,0 +1,113 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSDDLog.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The longest message, in bytes and including the terminating NUL, that fits in a record. Longer messages are truncated.
+ */
+FOUNDATION_EXPORT const NSUInteger AWSDDLogRecordMessageCapacity;
+
+/**
+ * A bounded, lock-free ring of log records that sits in front of an `AWSDDLog`.
+ *
+ * Logging through `AWSDDLog` creates an `AWSDDLogMessage` object on the calling thread and may block the caller once the
+ * logging queue falls behind. Writing a record instead formats the message into a preallocated slot with `vsnprintf`
+ * and captures the thread ID and queue label as plain C values; nothing is allocated and no lock is taken. The records
+ * are turned into `AWSDDLogMessage` objects on a private queue and passed to the log asynchronously.
+ *
+ * Any number of threads may write at once. When the ring is full the record is dropped and counted in
+ * `droppedRecordCount`, and a warning with the number dropped is logged once the ring has room again.
+ *
+ * Use the `AWSDDRecord*` macros below, which take a printf-style format (`%@` is not supported), to log through
+ * `sharedRing`. The message is still formatted on the calling thread, so they suit frequent messages made of C values,
+ * such as byte counts and message types, rather than ones that describe objects.
+ */
+@interface AWSDDLogRecordRing : NSObject
+
+/**
+ * A ring of 4096 records in front of `[AWSDDLog sharedInstance]`.
+ */
+@property (class, nonatomic, strong, readonly) AWSDDLogRecordRing *sharedRing;
+
+/**
+ * Creates a ring in front of the given log.
+ *
+ * @param capacity the number of records the ring holds, rounded up to a power of two
+ * @param log      the log the records are passed to
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity log:(AWSDDLog *)log NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * The number of records the ring holds.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ * The log the records are passed to.
+ */
+@property (nonatomic, strong, readonly) AWSDDLog *log;
+
+/**
+ * The number of records dropped because the ring was full.
+ */
+@property (nonatomic, readonly) NSUInteger droppedRecordCount;
+
+/**
+ * Passes every record written so far to the log and then flushes the log.
+ */
+- (void)flush;
+
+@end
+
+/**
+ * Writes a record to the ring. Returns NO, without blocking, if the ring is full.
+ *
+ * `file` and `function` are not copied and must outlive the ring; pass `__FILE__` and `__PRETTY_FUNCTION__`.
+ */
+FOUNDATION_EXPORT BOOL AWSDDLogRecordWrite(AWSDDLogRecordRing *ring,
+                                           AWSDDLogLevel level,
+                                           AWSDDLogFlag flag,
+                                           NSInteger context,
+                                           const char *file,
+                                           const char *function,
+                                           NSUInteger line,
+                                           const char *format, ...) __attribute__((format(printf, 8, 9)));
+
+/**
+ * Like the `AWSDDLog*` macros, but written to `[AWSDDLogRecordRing sharedRing]`. Records whose flag is not in
+ * `[AWSDDLog sharedInstance].logLevel` are skipped before the message is formatted.
+ **/
+#define AWSDD_RECORD_MAYBE(lvl, flg, frmt, ...)                                                             \
+        do {                                                                                                 \
+            AWSDDLogLevel __awsddRecordLevel = (lvl);                                                        \
+            if (__awsddRecordLevel & (flg)) {                                                                \
+                AWSDDLogRecordWrite(AWSDDLogRecordRing.sharedRing, __awsddRecordLevel, (flg), 0,             \
+                                    __FILE__, __PRETTY_FUNCTION__, __LINE__, (frmt), ##__VA_ARGS__);        \
+            }                                                                                                \
+        } while(0)
+
+#define AWSDDRecordError(frmt, ...)   AWSDD_RECORD_MAYBE([AWSDDLog sharedInstance].logLevel, AWSDDLogFlagError,   frmt, ##__VA_ARGS__)
+#define AWSDDRecordWarn(frmt, ...)    AWSDD_RECORD_MAYBE([AWSDDLog sharedInstance].logLevel, AWSDDLogFlagWarning, frmt, ##__VA_ARGS__)
+#define AWSDDRecordInfo(frmt, ...)    AWSDD_RECORD_MAYBE([AWSDDLog sharedInstance].logLevel, AWSDDLogFlagInfo,    frmt, ##__VA_ARGS__)
+#define AWSDDRecordDebug(frmt, ...)   AWSDD_RECORD_MAYBE([AWSDDLog sharedInstance].logLevel, AWSDDLogFlagDebug,   frmt, ##__VA_ARGS__)
+#define AWSDDRecordVerbose(frmt, ...) AWSDD_RECORD_MAYBE([AWSDDLog sharedInstance].logLevel, AWSDDLogFlagVerbose, frmt, ##__VA_ARGS__)
+
+NS_ASSUME_NONNULL_END
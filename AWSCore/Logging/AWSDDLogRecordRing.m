@@ -0,0 +1,301 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDDLogRecordRing.h"
+
+#import <pthread.h>
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define AWSDD_LOG_RECORD_MESSAGE_CAPACITY 320
+#define AWSDD_LOG_RECORD_THREAD_NAME_CAPACITY 32
+#define AWSDD_LOG_RECORD_QUEUE_LABEL_CAPACITY 64
+
+const NSUInteger AWSDDLogRecordMessageCapacity = AWSDD_LOG_RECORD_MESSAGE_CAPACITY;
+
+static const NSUInteger AWSDDLogRecordRingSharedCapacity = 4096;
+
+/**
+ * One slot of the ring. `sequence` follows the slot through its life: it equals the write position that may claim the
+ * slot next, becomes that position + 1 once the record is written, and moves a full lap ahead once the record is read.
+ */
+typedef struct {
+    _Atomic(NSUInteger) sequence;
+    CFAbsoluteTime timestamp;
+    uint64_t threadID;
+    const char *file;
+    const char *function;
+    NSUInteger line;
+    NSInteger context;
+    AWSDDLogLevel level;
+    AWSDDLogFlag flag;
+    char threadName[AWSDD_LOG_RECORD_THREAD_NAME_CAPACITY];
+    char queueLabel[AWSDD_LOG_RECORD_QUEUE_LABEL_CAPACITY];
+    char message[AWSDD_LOG_RECORD_MESSAGE_CAPACITY];
+} AWSDDLogRecord;
+
+// vsnprintf truncates at a byte count, which can split a UTF-8 sequence; drop the partial character so the message
+// still decodes.
+static void AWSDDLogRecordTrimPartialCharacter(char *message, size_t length) {
+    size_t start = length;
+    while (start > 0 && ((unsigned char)message[start - 1] & 0xC0) == 0x80) {
+        start--;
+    }
+    if (start == 0) {
+        return;
+    }
+    unsigned char lead = (unsigned char)message[start - 1];
+    if (lead < 0x80) {
+        return;
+    }
+    size_t expectedLength = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    if (length - (start - 1) < expectedLength) {
+        message[start - 1] = '\0';
+    }
+}
+
+@implementation AWSDDLogRecordRing {
+    AWSDDLogRecord *_records;
+    NSUInteger _mask;
+    _Atomic(NSUInteger) _writePosition;
+    _Atomic(NSUInteger) _droppedRecordCount;
+    _Atomic(bool) _drainScheduled;
+    dispatch_queue_t _drainQueue;
+    dispatch_source_t _drainSource;
+
+    // Only touched on _drainQueue.
+    NSUInteger _readPosition;
+    NSUInteger _reportedDroppedRecordCount;
+    CFMutableDictionaryRef _strings;
+    CFMutableDictionaryRef _fileNames;
+}
+
++ (AWSDDLogRecordRing *)sharedRing {
+    static AWSDDLogRecordRing *sharedRing = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedRing = [[self alloc] initWithCapacity:AWSDDLogRecordRingSharedCapacity log:[AWSDDLog sharedInstance]];
+    });
+    return sharedRing;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity log:(AWSDDLog *)log {
+    if (self = [super init]) {
+        NSUInteger roundedCapacity = 1;
+        while (roundedCapacity < capacity) {
+            roundedCapacity <<= 1;
+        }
+        _records = calloc(roundedCapacity, sizeof(AWSDDLogRecord));
+        if (!_records) {
+            return nil;
+        }
+        for (NSUInteger i = 0; i < roundedCapacity; i++) {
+            atomic_init(&_records[i].sequence, i);
+        }
+        _capacity = roundedCapacity;
+        _mask = roundedCapacity - 1;
+        _log = log;
+        atomic_init(&_writePosition, 0);
+        atomic_init(&_droppedRecordCount, 0);
+        atomic_init(&_drainScheduled, false);
+
+        // The keys are the addresses of string literals, so they are compared as pointers and never retained.
+        _strings = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        _fileNames = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+
+        _drainQueue = dispatch_queue_create("com.amazonaws.AWSDDLogRecordRing", DISPATCH_QUEUE_SERIAL);
+        _drainSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_ADD, 0, 0, _drainQueue);
+        __weak AWSDDLogRecordRing *weakSelf = self;
+        dispatch_source_set_event_handler(_drainSource, ^{
+            [weakSelf drain];
+        });
+        dispatch_resume(_drainSource);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_drainSource) {
+        dispatch_source_cancel(_drainSource);
+    }
+    if (_strings) {
+        CFRelease(_strings);
+    }
+    if (_fileNames) {
+        CFRelease(_fileNames);
+    }
+    free(_records);
+}
+
+- (NSUInteger)droppedRecordCount {
+    return atomic_load_explicit(&_droppedRecordCount, memory_order_relaxed);
+}
+
+- (void)flush {
+    dispatch_sync(_drainQueue, ^{
+        [self drain];
+    });
+    [self.log flushLog];
+}
+
+BOOL AWSDDLogRecordWrite(AWSDDLogRecordRing *ring,
+                         AWSDDLogLevel level,
+                         AWSDDLogFlag flag,
+                         NSInteger context,
+                         const char *file,
+                         const char *function,
+                         NSUInteger line,
+                         const char *format, ...) {
+    // Claim a slot. A slot whose sequence is behind the write position still holds a record that has not been read,
+    // which means the ring is full.
+    NSUInteger position = atomic_load_explicit(&ring->_writePosition, memory_order_relaxed);
+    AWSDDLogRecord *record;
+    for (;;) {
+        record = &ring->_records[position & ring->_mask];
+        NSUInteger sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+        NSInteger difference = (NSInteger)(sequence - position);
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->_writePosition, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            atomic_fetch_add_explicit(&ring->_droppedRecordCount, 1, memory_order_relaxed);
+            return NO;
+        } else {
+            position = atomic_load_explicit(&ring->_writePosition, memory_order_relaxed);
+        }
+    }
+
+    record->timestamp = CFAbsoluteTimeGetCurrent();
+    record->level = level;
+    record->flag = flag;
+    record->context = context;
+    record->file = file;
+    record->function = function;
+    record->line = line;
+    pthread_threadid_np(NULL, &record->threadID);
+    if (pthread_getname_np(pthread_self(), record->threadName, sizeof(record->threadName)) != 0) {
+        record->threadName[0] = '\0';
+    }
+    const char *queueLabel = dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL);
+    strlcpy(record->queueLabel, queueLabel ?: "", sizeof(record->queueLabel));
+
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(record->message, sizeof(record->message), format, arguments);
+    va_end(arguments);
+    if (length < 0) {
+        record->message[0] = '\0';
+    } else if ((size_t)length >= sizeof(record->message)) {
+        AWSDDLogRecordTrimPartialCharacter(record->message, sizeof(record->message) - 1);
+    }
+
+    atomic_store_explicit(&record->sequence, position + 1, memory_order_release);
+
+    // Pairs with the exchange at the start of -drain: either that drain sees this record, or this schedules another.
+    if (!atomic_exchange(&ring->_drainScheduled, true)) {
+        dispatch_source_merge_data(ring->_drainSource, 1);
+    }
+    return YES;
+}
+
+- (void)drain {
+    atomic_exchange(&_drainScheduled, false);
+    for (;;) {
+        AWSDDLogRecord *record = &_records[_readPosition & _mask];
+        if (atomic_load_explicit(&record->sequence, memory_order_acquire) != _readPosition + 1) {
+            break;
+        }
+        AWSDDLogMessage *message = [self messageForRecord:record];
+        // Hand the slot back before logging, which may wait for the logging queue.
+        atomic_store_explicit(&record->sequence, _readPosition + _capacity, memory_order_release);
+        _readPosition++;
+        [self.log log:YES message:message];
+    }
+    [self reportDroppedRecords];
+}
+
+- (AWSDDLogMessage *)messageForRecord:(const AWSDDLogRecord *)record {
+    AWSDDLogMessage *message = [AWSDDLogMessage new];
+    message->_message = [[NSString alloc] initWithUTF8String:record->message] ?: @"";
+    message->_level = record->level;
+    message->_flag = record->flag;
+    message->_context = record->context;
+    message->_file = [self stringForCString:record->file];
+    message->_fileName = [self fileNameForCString:record->file];
+    message->_function = [self stringForCString:record->function];
+    message->_line = record->line;
+    message->_options = 0;
+    message->_timestamp = [NSDate dateWithTimeIntervalSinceReferenceDate:record->timestamp];
+    message->_threadID = [[NSString alloc] initWithFormat:@"%llu", record->threadID];
+    message->_threadName = [[NSString alloc] initWithUTF8String:record->threadName] ?: @"";
+    message->_queueLabel = [[NSString alloc] initWithUTF8String:record->queueLabel] ?: @"";
+    return message;
+}
+
+- (nullable NSString *)stringForCString:(nullable const char *)cString {
+    if (!cString) {
+        return nil;
+    }
+    NSString *string = (__bridge NSString *)CFDictionaryGetValue(_strings, cString);
+    if (!string) {
+        string = [[NSString alloc] initWithUTF8String:cString] ?: @"";
+        CFDictionarySetValue(_strings, cString, (__bridge const void *)string);
+    }
+    return string;
+}
+
+- (NSString *)fileNameForCString:(const char *)file {
+    NSString *fileName = (__bridge NSString *)CFDictionaryGetValue(_fileNames, file);
+    if (!fileName) {
+        // The same file name without extension that AWSDDLogMessage derives.
+        fileName = [[self stringForCString:file] lastPathComponent] ?: @"";
+        NSUInteger dotLocation = [fileName rangeOfString:@"." options:NSBackwardsSearch].location;
+        if (dotLocation != NSNotFound) {
+            fileName = [fileName substringToIndex:dotLocation];
+        }
+        CFDictionarySetValue(_fileNames, file, (__bridge const void *)fileName);
+    }
+    return fileName;
+}
+
+- (void)reportDroppedRecords {
+    NSUInteger droppedRecordCount = atomic_load_explicit(&_droppedRecordCount, memory_order_relaxed);
+    if (droppedRecordCount == _reportedDroppedRecordCount) {
+        return;
+    }
+    NSUInteger newlyDroppedRecordCount = droppedRecordCount - _reportedDroppedRecordCount;
+    _reportedDroppedRecordCount = droppedRecordCount;
+
+    NSString *text = [NSString stringWithFormat:@"Dropped %lu log records because the log record ring was full.",
+                      (unsigned long)newlyDroppedRecordCount];
+    AWSDDLogMessage *message = [[AWSDDLogMessage alloc] initWithMessage:text
+                                                                  level:self.log.logLevel
+                                                                   flag:AWSDDLogFlagWarning
+                                                                context:0
+                                                                   file:@(__FILE__)
+                                                               function:@(__PRETTY_FUNCTION__)
+                                                                   line:__LINE__
+                                                                    tag:nil
+                                                                options:0
+                                                              timestamp:nil];
+    [self.log log:YES message:message];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -32,15 +32,31 @@ typedef NS_ENUM(NSInteger, AWSNetworkingRetryType) {
     AWSNetworkingRetryTypeResetStreamAndRetry
 };
 
+/**
+ The order in which requests waiting for an `AWSNetworkingRequestScheduler` are sent. The priority is also passed to the session task, which uses it to order the streams of HTTP/2 connections.
+ */
+typedef NS_ENUM(NSInteger, AWSNetworkingRequestPriority) {
+    /** Sent after the waiting requests of higher priority. */
+    AWSNetworkingRequestPriorityLow = -1,
+    /** The default. */
+    AWSNetworkingRequestPriorityNormal = 0,
+    /** Sent before the waiting requests of lower priority. */
+    AWSNetworkingRequestPriorityHigh = 1,
+};
+
 /** UserInfo dictionary key for response errors */
 FOUNDATION_EXPORT NSString *const AWSResponseObjectErrorUserInfoKey;
 
 @class AWSNetworkingConfiguration;
 @class AWSNetworkingRequest;
+@class AWSExecutor;
+@class AWSNetworkingMetricsCollector;
+@class AWSNetworkingRequestScheduler;
 @class AWSTask<__covariant ResultType>;
 
 typedef void (^AWSNetworkingUploadProgressBlock) (int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend);
 typedef void (^AWSNetworkingDownloadProgressBlock) (int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite);
+typedef void (^AWSNetworkingResponseDataBlock) (NSData *data);
 
 #pragma mark - AWSHTTPMethod
 
@@ -172,6 +188,51 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
  */
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
 
+/**
+ The executor that runs the continuations which serialize requests and process responses. Defaults to `[AWSExecutor defaultExecutor]` when `nil`. Set it to an `AWSWorkStealingExecutor` to run this work on a fixed pool of threads.
+ */
+@property (nonatomic, strong) AWSExecutor *continuationExecutor;
+
+/**
+ The collector that receives the timings of each operation, such as signing, time to first byte and parsing. No metrics are collected when `nil`, the default.
+ */
+@property (nonatomic, strong) AWSNetworkingMetricsCollector *metricsCollector;
+
+/**
+ The maximum number of simultaneous connections to a host. Defaults to `0`, which keeps the `NSURLSession` default. Requests to a host that supports HTTP/2 are multiplexed over one connection whatever this is set to.
+ */
+@property (nonatomic, assign) NSInteger HTTPMaximumConnectionsPerHost;
+
+/**
+ Whether HTTP/1.1 requests are pipelined on a connection. Defaults to `NO`.
+ */
+@property (nonatomic, assign) BOOL HTTPShouldUsePipelining;
+
+/**
+ Whether connections are kept open to be reused by later requests. Defaults to `YES`. When `NO`, every request is sent in an ephemeral session of its own, so that it opens a new connection that is closed once the request finishes.
+ */
+@property (nonatomic, assign) BOOL allowsConnectionReuse;
+
+/**
+ How long the connections of the session may stay unused. Once the session has had no requests in flight for this long, it is flushed, so that its idle connections are closed and the next request opens a new one. Defaults to `0`, which leaves idle connections to the system.
+ */
+@property (nonatomic, assign) NSTimeInterval connectionIdleTimeout;
+
+/**
+ Whether the service client shares its `NSURLSession`, and so its pool of connections, with the other clients that set this and have the same timeouts, cellular access, shared container and connection settings. Defaults to `NO`, which gives every client its own session.
+ */
+@property (nonatomic, assign) BOOL usesSharedURLSession;
+
+/**
+ Limits how many requests are in flight at once and orders the requests that wait. Assign the same scheduler to several configurations to make their clients share the limit. A request takes its place once it is signed, and gives it up when each attempt finishes. Requests are sent as soon as they are made when `nil`, the default.
+ */
+@property (nonatomic, strong) AWSNetworkingRequestScheduler *requestScheduler;
+
+/**
+ The priority of requests when they wait for `requestScheduler`. Defaults to `AWSNetworkingRequestPriorityNormal`. A request left at `AWSNetworkingRequestPriorityNormal` takes the priority of the configuration it is sent with.
+ */
+@property (nonatomic, assign) AWSNetworkingRequestPriority requestPriority;
+
 @end
 
 #pragma mark - AWSNetworkingRequest
@@ -186,6 +247,11 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
 
+/**
+ When set, the body of a successful response is passed to this block in parts as it arrives instead of being collected in memory, so that a large body can be fed to an incremental parser or written out without holding all of it at once. The response serializer then only sees the status code and headers. Error responses are still collected and parsed as usual. If the request is retried, the block receives the body of the new response from its start. Set `downloadingFileURL` instead to write the body to a file.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseDataBlock responseDataHandler;
+
 @property (readonly, nonatomic, strong) NSURLSessionTask *task;
 @property (readonly, nonatomic, assign, getter = isCancelled) BOOL cancelled;
 
@@ -199,6 +265,10 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
+/**
+ Passes the body of a successful response to a block as it arrives instead of parsing it into the output. See `AWSNetworkingRequest.responseDataHandler`.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseDataBlock responseDataHandler;
 @property (nonatomic, assign, readonly, getter = isCancelled) BOOL cancelled;
 @property (nonatomic, strong) NSURL *downloadingFileURL;
 
@@ -111,6 +111,7 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     if (self = [super init]) {
         _maxRetryCount = 3;
         _allowsCellularAccess = YES;
+        _allowsConnectionReuse = YES;
     }
     return self;
 }
@@ -166,6 +167,15 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     configuration.maxRetryCount = self.maxRetryCount;
     configuration.timeoutIntervalForRequest = self.timeoutIntervalForRequest;
     configuration.timeoutIntervalForResource = self.timeoutIntervalForResource;
+    configuration.continuationExecutor = self.continuationExecutor;
+    configuration.metricsCollector = self.metricsCollector;
+    configuration.HTTPMaximumConnectionsPerHost = self.HTTPMaximumConnectionsPerHost;
+    configuration.HTTPShouldUsePipelining = self.HTTPShouldUsePipelining;
+    configuration.allowsConnectionReuse = self.allowsConnectionReuse;
+    configuration.connectionIdleTimeout = self.connectionIdleTimeout;
+    configuration.usesSharedURLSession = self.usesSharedURLSession;
+    configuration.requestScheduler = self.requestScheduler;
+    configuration.requestPriority = self.requestPriority;
 
     return configuration;
 }
@@ -223,6 +233,22 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     if (!self.retryHandler) {
         self.retryHandler = configuration.retryHandler;
     }
+
+    if (!self.continuationExecutor) {
+        self.continuationExecutor = configuration.continuationExecutor;
+    }
+
+    if (!self.metricsCollector) {
+        self.metricsCollector = configuration.metricsCollector;
+    }
+
+    if (!self.requestScheduler) {
+        self.requestScheduler = configuration.requestScheduler;
+    }
+
+    if (self.requestPriority == AWSNetworkingRequestPriorityNormal) {
+        self.requestPriority = configuration.requestPriority;
+    }
 }
 
 - (void)setTask:(NSURLSessionTask *)task {
@@ -279,6 +305,7 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
 
     encodingBehaviors[@"downloadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"internalRequest"] = @(AWSMTLModelEncodingBehaviorExcluded);
+    encodingBehaviors[@"responseDataHandler"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"uploadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
 
     return encodingBehaviors;
@@ -313,6 +340,13 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     return NULL;
 }
 
+// This may be a bug in our version of Mantle--despite declaring these properties as "excluded",
+// Mantle attempts to decode them from an archive, and fails when it cannot find the field name.
+- (nullable id)decodeResponseDataHandlerWithCoder:(NSCoder *)coder
+                                     modelVersion:(NSUInteger)modelVersion {
+    return NULL;
+}
+
 - (void)setUploadProgress:(AWSNetworkingUploadProgressBlock)uploadProgress {
     self.internalRequest.uploadProgress = uploadProgress;
 }
@@ -321,6 +355,10 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     self.internalRequest.downloadProgress = downloadProgress;
 }
 
+- (void)setResponseDataHandler:(AWSNetworkingResponseDataBlock)responseDataHandler {
+    self.internalRequest.responseDataHandler = responseDataHandler;
+}
+
 - (BOOL)isCancelled {
     return [self.internalRequest isCancelled];
 }
@@ -0,0 +1,214 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The parts of an operation that are timed.
+ */
+typedef NS_ENUM(NSInteger, AWSNetworkingMetricsPhase) {
+    /** From the start of the operation until its result is ready, including retries. */
+    AWSNetworkingMetricsPhaseTotal,
+    /** Getting credentials for signing. */
+    AWSNetworkingMetricsPhaseCredentials,
+    /** The request interceptors, such as the signer, apart from getting credentials. */
+    AWSNetworkingMetricsPhaseSigning,
+    /** Building the HTTP request from the request parameters. */
+    AWSNetworkingMetricsPhaseSerialization,
+    /** From starting the session task until it completes. */
+    AWSNetworkingMetricsPhaseNetwork,
+    /** The DNS lookup. Only recorded when a new connection was opened. */
+    AWSNetworkingMetricsPhaseDomainLookup,
+    /** Opening the connection, including the TLS handshake. Only recorded when a new connection was opened. */
+    AWSNetworkingMetricsPhaseConnect,
+    /** The TLS handshake. Only recorded when a new connection was opened. */
+    AWSNetworkingMetricsPhaseSecureConnection,
+    /** From sending the first byte of the request until receiving the first byte of the response. */
+    AWSNetworkingMetricsPhaseTimeToFirstByte,
+    /** From the first byte of the response until the last. */
+    AWSNetworkingMetricsPhaseResponseTransfer,
+    /** Turning the response into the operation's result or error. */
+    AWSNetworkingMetricsPhaseParsing,
+    /** Waiting between attempts. */
+    AWSNetworkingMetricsPhaseRetryDelay,
+};
+
+/**
+ The number of values in `AWSNetworkingMetricsPhase`.
+ */
+FOUNDATION_EXPORT const NSUInteger AWSNetworkingMetricsPhaseCount;
+
+/**
+ Returns a short name for a phase, such as `timeToFirstByte`, for use by exporters.
+ */
+FOUNDATION_EXPORT NSString *AWSNetworkingMetricsPhaseName(AWSNetworkingMetricsPhase phase);
+
+/**
+ The measurements of one operation, from the first attempt to the result. Durations of the SDK phases are summed over
+ all attempts, and the connection phases come from the last attempt.
+ */
+@interface AWSNetworkingOperationMetrics : NSObject
+
+@property (nonatomic, readonly) NSString *serviceName;
+@property (nonatomic, readonly) NSString *operationName;
+@property (nonatomic, readonly) NSDate *startDate;
+
+/**
+ The number of attempts after the first.
+ */
+@property (nonatomic, readonly) NSUInteger retryCount;
+
+/**
+ The status code of the last response, or zero if no response was received.
+ */
+@property (nonatomic, readonly) NSInteger statusCode;
+
+/**
+ The number of response body bytes received by the last attempt.
+ */
+@property (nonatomic, readonly) int64_t bytesReceived;
+
+/**
+ Whether the last attempt was sent on a connection that was already open.
+ */
+@property (nonatomic, readonly) BOOL reusedConnection;
+
+/**
+ The error the operation failed with, or `nil` if it succeeded.
+ */
+@property (nonatomic, readonly, nullable) NSError *error;
+
+- (instancetype)initWithServiceName:(NSString *)serviceName operationName:(NSString *)operationName;
+
+/**
+ Whether a phase was measured. Connection phases are not measured for reused connections, and none of the network
+ phases are measured before iOS 10.
+ */
+- (BOOL)hasDurationForPhase:(AWSNetworkingMetricsPhase)phase;
+
+/**
+ The time spent in a phase, in seconds, or zero if it was not measured.
+ */
+- (NSTimeInterval)durationForPhase:(AWSNetworkingMetricsPhase)phase;
+
+/**
+ Adds to the time spent in a phase. Request interceptors can call this through
+ `+[AWSNetworkingOperationMetrics metricsForRequest:]` to report their own phases.
+ */
+- (void)addDuration:(NSTimeInterval)duration forPhase:(AWSNetworkingMetricsPhase)phase;
+
+/**
+ Returns the metrics of the operation a request is being prepared for, or `nil` if the service does not collect
+ metrics.
+ */
++ (nullable AWSNetworkingOperationMetrics *)metricsForRequest:(NSURLRequest *)request;
+
+@end
+
+/**
+ A summary of the values recorded in a histogram. Durations are in seconds, sizes in bytes and throughput in bytes per
+ second.
+ */
+@interface AWSNetworkingMetricsHistogramSnapshot : NSObject
+
+@property (nonatomic, readonly) uint64_t count;
+@property (nonatomic, readonly) double sum;
+@property (nonatomic, readonly) double minimum;
+@property (nonatomic, readonly) double maximum;
+@property (nonatomic, readonly) double mean;
+
+/**
+ Returns an estimate of the value below which `percentile` percent of the recorded values fall. Values are bucketed by
+ powers of two, so the estimate is the upper bound of a bucket, limited to `maximum`.
+ */
+- (double)valueAtPercentile:(double)percentile;
+
+@end
+
+/**
+ The metrics of one operation of one service, aggregated over every call since the collector was created or reset.
+ */
+@interface AWSNetworkingMetricsSnapshot : NSObject
+
+@property (nonatomic, readonly) NSString *serviceName;
+@property (nonatomic, readonly) NSString *operationName;
+@property (nonatomic, readonly) uint64_t operationCount;
+@property (nonatomic, readonly) uint64_t errorCount;
+@property (nonatomic, readonly) uint64_t retryCount;
+
+- (AWSNetworkingMetricsHistogramSnapshot *)histogramForPhase:(AWSNetworkingMetricsPhase)phase;
+
+/**
+ The response body size of each operation.
+ */
+@property (nonatomic, readonly) AWSNetworkingMetricsHistogramSnapshot *bytesReceived;
+
+/**
+ The response body size of each operation divided by the time it took to receive it.
+ */
+@property (nonatomic, readonly) AWSNetworkingMetricsHistogramSnapshot *throughput;
+
+@end
+
+@class AWSNetworkingMetricsCollector;
+
+/**
+ Receives the metrics of each operation as it finishes, for example to send them to a monitoring service.
+ */
+@protocol AWSNetworkingMetricsExporter <NSObject>
+
+/**
+ Called on a serial background queue, once per operation, so an exporter does not need to be thread-safe and does not
+ slow down the operations it reports on.
+ */
+- (void)metricsCollector:(AWSNetworkingMetricsCollector *)collector didRecordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics;
+
+@end
+
+/**
+ Aggregates the metrics of the operations of the services configured with it into one histogram per phase, service and
+ operation. Recording into a histogram does not take a lock. Metrics are collected only for services whose
+ `metricsCollector` is set, and one collector can be shared by several services.
+ */
+@interface AWSNetworkingMetricsCollector : NSObject
+
+/**
+ Adds the metrics of a finished operation to the histograms and passes them to the exporters.
+ */
+- (void)recordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics;
+
+/**
+ Returns the aggregated metrics of every service and operation recorded so far.
+ */
+- (NSArray<AWSNetworkingMetricsSnapshot *> *)snapshot;
+
+/**
+ Returns the aggregated metrics of one operation, or `nil` if it has not been recorded.
+ */
+- (nullable AWSNetworkingMetricsSnapshot *)snapshotForServiceName:(NSString *)serviceName operationName:(NSString *)operationName;
+
+/**
+ Discards the aggregated metrics.
+ */
+- (void)reset;
+
+- (void)addExporter:(id<AWSNetworkingMetricsExporter>)exporter;
+- (void)removeExporter:(id<AWSNetworkingMetricsExporter>)exporter;
+
+@end
+
+NS_ASSUME_NONNULL_END
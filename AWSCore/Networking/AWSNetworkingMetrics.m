@@ -0,0 +1,481 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSNetworkingMetrics.h"
+
+#import <objc/runtime.h>
+#import <stdatomic.h>
+#import "AWSSynchronizedMutableDictionary.h"
+
+const NSUInteger AWSNetworkingMetricsPhaseCount = AWSNetworkingMetricsPhaseRetryDelay + 1;
+
+// One bucket per bit of a 64-bit value: bucket i holds the values in [2^(i-1), 2^i), and bucket 0 holds zero.
+#define AWSNetworkingMetricsBucketCount 65
+
+static const double AWSNetworkingMetricsMicrosecondsPerSecond = 1000000.0;
+
+static char AWSNetworkingOperationMetricsRequestKey;
+
+NSString *AWSNetworkingMetricsPhaseName(AWSNetworkingMetricsPhase phase) {
+    switch (phase) {
+        case AWSNetworkingMetricsPhaseTotal:
+            return @"total";
+        case AWSNetworkingMetricsPhaseCredentials:
+            return @"credentials";
+        case AWSNetworkingMetricsPhaseSigning:
+            return @"signing";
+        case AWSNetworkingMetricsPhaseSerialization:
+            return @"serialization";
+        case AWSNetworkingMetricsPhaseNetwork:
+            return @"network";
+        case AWSNetworkingMetricsPhaseDomainLookup:
+            return @"domainLookup";
+        case AWSNetworkingMetricsPhaseConnect:
+            return @"connect";
+        case AWSNetworkingMetricsPhaseSecureConnection:
+            return @"secureConnection";
+        case AWSNetworkingMetricsPhaseTimeToFirstByte:
+            return @"timeToFirstByte";
+        case AWSNetworkingMetricsPhaseResponseTransfer:
+            return @"responseTransfer";
+        case AWSNetworkingMetricsPhaseParsing:
+            return @"parsing";
+        case AWSNetworkingMetricsPhaseRetryDelay:
+            return @"retryDelay";
+    }
+    return @"unknown";
+}
+
+#pragma mark - AWSNetworkingOperationMetrics
+
+@interface AWSNetworkingOperationMetrics()
+
+@property (nonatomic, assign) NSUInteger retryCount;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, assign) int64_t bytesReceived;
+@property (nonatomic, assign) BOOL reusedConnection;
+@property (nonatomic, strong) NSError *error;
+
+- (void)setDuration:(NSTimeInterval)duration forPhase:(AWSNetworkingMetricsPhase)phase;
+
++ (void)setMetrics:(AWSNetworkingOperationMetrics *)metrics forRequest:(NSURLRequest *)request;
+
+@end
+
+@implementation AWSNetworkingOperationMetrics {
+    NSTimeInterval _durations[AWSNetworkingMetricsPhaseRetryDelay + 1];
+    uint32_t _measuredPhases;
+}
+
+- (instancetype)initWithServiceName:(NSString *)serviceName operationName:(NSString *)operationName {
+    if (self = [super init]) {
+        _serviceName = [serviceName copy];
+        _operationName = [operationName copy];
+        _startDate = [NSDate date];
+    }
+    return self;
+}
+
+- (BOOL)hasDurationForPhase:(AWSNetworkingMetricsPhase)phase {
+    if (phase < 0 || phase >= AWSNetworkingMetricsPhaseCount) {
+        return NO;
+    }
+    @synchronized(self) {
+        return (_measuredPhases & (1u << phase)) != 0;
+    }
+}
+
+- (NSTimeInterval)durationForPhase:(AWSNetworkingMetricsPhase)phase {
+    if (phase < 0 || phase >= AWSNetworkingMetricsPhaseCount) {
+        return 0;
+    }
+    @synchronized(self) {
+        return _durations[phase];
+    }
+}
+
+- (void)addDuration:(NSTimeInterval)duration forPhase:(AWSNetworkingMetricsPhase)phase {
+    if (phase < 0 || phase >= AWSNetworkingMetricsPhaseCount) {
+        return;
+    }
+    @synchronized(self) {
+        _durations[phase] += MAX(duration, 0);
+        _measuredPhases |= 1u << phase;
+    }
+}
+
+- (void)setDuration:(NSTimeInterval)duration forPhase:(AWSNetworkingMetricsPhase)phase {
+    if (phase < 0 || phase >= AWSNetworkingMetricsPhaseCount) {
+        return;
+    }
+    @synchronized(self) {
+        _durations[phase] = MAX(duration, 0);
+        _measuredPhases |= 1u << phase;
+    }
+}
+
++ (AWSNetworkingOperationMetrics *)metricsForRequest:(NSURLRequest *)request {
+    return objc_getAssociatedObject(request, &AWSNetworkingOperationMetricsRequestKey);
+}
+
++ (void)setMetrics:(AWSNetworkingOperationMetrics *)metrics forRequest:(NSURLRequest *)request {
+    objc_setAssociatedObject(request, &AWSNetworkingOperationMetricsRequestKey, metrics, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
+- (NSString *)description {
+    NSMutableString *description = [NSMutableString stringWithFormat:@"<%@: %@.%@ status=%ld retries=%lu bytes=%lld",
+                                     NSStringFromClass([self class]),
+                                     self.serviceName,
+                                     self.operationName,
+                                     (long)self.statusCode,
+                                     (unsigned long)self.retryCount,
+                                     self.bytesReceived];
+    for (NSUInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+        if ([self hasDurationForPhase:phase]) {
+            [description appendFormat:@" %@=%.3fms", AWSNetworkingMetricsPhaseName(phase), [self durationForPhase:phase] * 1000];
+        }
+    }
+    [description appendString:@">"];
+    return description;
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsHistogramSnapshot
+
+@interface AWSNetworkingMetricsHistogramSnapshot()
+
+- (instancetype)initWithBuckets:(const uint64_t *)buckets
+                          count:(uint64_t)count
+                            sum:(uint64_t)sum
+                        minimum:(uint64_t)minimum
+                        maximum:(uint64_t)maximum
+                          scale:(double)scale;
+
+@end
+
+@implementation AWSNetworkingMetricsHistogramSnapshot {
+    uint64_t _buckets[AWSNetworkingMetricsBucketCount];
+    uint64_t _rawMaximum;
+    double _scale;
+}
+
+- (instancetype)initWithBuckets:(const uint64_t *)buckets
+                          count:(uint64_t)count
+                            sum:(uint64_t)sum
+                        minimum:(uint64_t)minimum
+                        maximum:(uint64_t)maximum
+                          scale:(double)scale {
+    if (self = [super init]) {
+        memcpy(_buckets, buckets, sizeof(_buckets));
+        _count = count;
+        _scale = scale;
+        _rawMaximum = maximum;
+        _sum = sum / scale;
+        _minimum = count > 0 ? minimum / scale : 0;
+        _maximum = count > 0 ? maximum / scale : 0;
+        _mean = count > 0 ? _sum / count : 0;
+    }
+    return self;
+}
+
+- (double)valueAtPercentile:(double)percentile {
+    uint64_t total = 0;
+    for (NSUInteger i = 0; i < AWSNetworkingMetricsBucketCount; i++) {
+        total += _buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)ceil(MIN(MAX(percentile, 0), 100) / 100.0 * total);
+    rank = MAX(rank, 1);
+    uint64_t seen = 0;
+    for (NSUInteger i = 0; i < AWSNetworkingMetricsBucketCount; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            uint64_t upperBound = i == 0 ? 0 : (i == 64 ? UINT64_MAX : (1ull << i) - 1);
+            return MIN(upperBound, _rawMaximum) / _scale;
+        }
+    }
+    return self.maximum;
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsHistogram
+
+// Counts values in buckets that are updated with atomic operations, so recording never blocks.
+@interface AWSNetworkingMetricsHistogram : NSObject
+
+- (instancetype)initWithScale:(double)scale;
+
+- (void)recordValue:(uint64_t)value;
+
+- (AWSNetworkingMetricsHistogramSnapshot *)snapshot;
+
+@end
+
+@implementation AWSNetworkingMetricsHistogram {
+    double _scale;
+    _Atomic(uint64_t) _buckets[AWSNetworkingMetricsBucketCount];
+    _Atomic(uint64_t) _count;
+    _Atomic(uint64_t) _sum;
+    _Atomic(uint64_t) _minimum;
+    _Atomic(uint64_t) _maximum;
+}
+
+- (instancetype)initWithScale:(double)scale {
+    if (self = [super init]) {
+        _scale = scale;
+        for (NSUInteger i = 0; i < AWSNetworkingMetricsBucketCount; i++) {
+            atomic_init(&_buckets[i], 0);
+        }
+        atomic_init(&_count, 0);
+        atomic_init(&_sum, 0);
+        atomic_init(&_minimum, UINT64_MAX);
+        atomic_init(&_maximum, 0);
+    }
+    return self;
+}
+
+- (void)recordValue:(uint64_t)value {
+    NSUInteger bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    atomic_fetch_add_explicit(&_buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_sum, value, memory_order_relaxed);
+
+    uint64_t minimum = atomic_load_explicit(&_minimum, memory_order_relaxed);
+    while (value < minimum
+           && !atomic_compare_exchange_weak_explicit(&_minimum, &minimum, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+    uint64_t maximum = atomic_load_explicit(&_maximum, memory_order_relaxed);
+    while (value > maximum
+           && !atomic_compare_exchange_weak_explicit(&_maximum, &maximum, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&_count, 1, memory_order_release);
+}
+
+- (AWSNetworkingMetricsHistogramSnapshot *)snapshot {
+    uint64_t count = atomic_load_explicit(&_count, memory_order_acquire);
+    uint64_t buckets[AWSNetworkingMetricsBucketCount];
+    for (NSUInteger i = 0; i < AWSNetworkingMetricsBucketCount; i++) {
+        buckets[i] = atomic_load_explicit(&_buckets[i], memory_order_relaxed);
+    }
+    return [[AWSNetworkingMetricsHistogramSnapshot alloc] initWithBuckets:buckets
+                                                                    count:count
+                                                                      sum:atomic_load_explicit(&_sum, memory_order_relaxed)
+                                                                  minimum:atomic_load_explicit(&_minimum, memory_order_relaxed)
+                                                                  maximum:atomic_load_explicit(&_maximum, memory_order_relaxed)
+                                                                    scale:_scale];
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsSnapshot
+
+@interface AWSNetworkingMetricsSnapshot()
+
+@property (nonatomic, strong) NSString *serviceName;
+@property (nonatomic, strong) NSString *operationName;
+@property (nonatomic, assign) uint64_t operationCount;
+@property (nonatomic, assign) uint64_t errorCount;
+@property (nonatomic, assign) uint64_t retryCount;
+@property (nonatomic, strong) NSArray<AWSNetworkingMetricsHistogramSnapshot *> *phaseHistograms;
+@property (nonatomic, strong) AWSNetworkingMetricsHistogramSnapshot *bytesReceived;
+@property (nonatomic, strong) AWSNetworkingMetricsHistogramSnapshot *throughput;
+
+@end
+
+@implementation AWSNetworkingMetricsSnapshot
+
+- (AWSNetworkingMetricsHistogramSnapshot *)histogramForPhase:(AWSNetworkingMetricsPhase)phase {
+    if (phase < 0 || phase >= AWSNetworkingMetricsPhaseCount) {
+        return [[[AWSNetworkingMetricsHistogram alloc] initWithScale:1] snapshot];
+    }
+    return self.phaseHistograms[phase];
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsAggregate
+
+// The histograms and counters of one operation of one service.
+@interface AWSNetworkingMetricsAggregate : NSObject
+
+- (instancetype)initWithServiceName:(NSString *)serviceName operationName:(NSString *)operationName;
+
+- (void)recordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics;
+
+- (AWSNetworkingMetricsSnapshot *)snapshot;
+
+@end
+
+@implementation AWSNetworkingMetricsAggregate {
+    NSString *_serviceName;
+    NSString *_operationName;
+    NSArray<AWSNetworkingMetricsHistogram *> *_phaseHistograms;
+    AWSNetworkingMetricsHistogram *_bytesReceived;
+    AWSNetworkingMetricsHistogram *_throughput;
+    _Atomic(uint64_t) _operationCount;
+    _Atomic(uint64_t) _errorCount;
+    _Atomic(uint64_t) _retryCount;
+}
+
+- (instancetype)initWithServiceName:(NSString *)serviceName operationName:(NSString *)operationName {
+    if (self = [super init]) {
+        _serviceName = serviceName;
+        _operationName = operationName;
+        NSMutableArray *phaseHistograms = [NSMutableArray arrayWithCapacity:AWSNetworkingMetricsPhaseCount];
+        for (NSUInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+            [phaseHistograms addObject:[[AWSNetworkingMetricsHistogram alloc] initWithScale:AWSNetworkingMetricsMicrosecondsPerSecond]];
+        }
+        _phaseHistograms = phaseHistograms;
+        _bytesReceived = [[AWSNetworkingMetricsHistogram alloc] initWithScale:1];
+        _throughput = [[AWSNetworkingMetricsHistogram alloc] initWithScale:1];
+        atomic_init(&_operationCount, 0);
+        atomic_init(&_errorCount, 0);
+        atomic_init(&_retryCount, 0);
+    }
+    return self;
+}
+
+- (void)recordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics {
+    for (NSUInteger phase = 0; phase < AWSNetworkingMetricsPhaseCount; phase++) {
+        if ([metrics hasDurationForPhase:phase]) {
+            [_phaseHistograms[phase] recordValue:(uint64_t)llround([metrics durationForPhase:phase] * AWSNetworkingMetricsMicrosecondsPerSecond)];
+        }
+    }
+    if (metrics.statusCode > 0) {
+        [_bytesReceived recordValue:(uint64_t)MAX(metrics.bytesReceived, 0)];
+
+        // Prefer the time the body took to arrive, and fall back to the whole attempt before iOS 10.
+        NSTimeInterval transferDuration = [metrics hasDurationForPhase:AWSNetworkingMetricsPhaseResponseTransfer]
+        ? [metrics durationForPhase:AWSNetworkingMetricsPhaseResponseTransfer]
+        : [metrics durationForPhase:AWSNetworkingMetricsPhaseNetwork];
+        if (metrics.bytesReceived > 0 && transferDuration > 0) {
+            [_throughput recordValue:(uint64_t)llround(metrics.bytesReceived / transferDuration)];
+        }
+    }
+
+    atomic_fetch_add_explicit(&_operationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_retryCount, metrics.retryCount, memory_order_relaxed);
+    if (metrics.error) {
+        atomic_fetch_add_explicit(&_errorCount, 1, memory_order_relaxed);
+    }
+}
+
+- (AWSNetworkingMetricsSnapshot *)snapshot {
+    AWSNetworkingMetricsSnapshot *snapshot = [AWSNetworkingMetricsSnapshot new];
+    snapshot.serviceName = _serviceName;
+    snapshot.operationName = _operationName;
+    snapshot.operationCount = atomic_load_explicit(&_operationCount, memory_order_relaxed);
+    snapshot.errorCount = atomic_load_explicit(&_errorCount, memory_order_relaxed);
+    snapshot.retryCount = atomic_load_explicit(&_retryCount, memory_order_relaxed);
+    NSMutableArray *phaseHistograms = [NSMutableArray arrayWithCapacity:AWSNetworkingMetricsPhaseCount];
+    for (AWSNetworkingMetricsHistogram *histogram in _phaseHistograms) {
+        [phaseHistograms addObject:[histogram snapshot]];
+    }
+    snapshot.phaseHistograms = phaseHistograms;
+    snapshot.bytesReceived = [_bytesReceived snapshot];
+    snapshot.throughput = [_throughput snapshot];
+    return snapshot;
+}
+
+@end
+
+#pragma mark - AWSNetworkingMetricsCollector
+
+@interface AWSNetworkingMetricsCollector()
+
+@property (nonatomic, strong) AWSSynchronizedMutableDictionary *aggregates;
+@property (atomic, copy) NSArray<id<AWSNetworkingMetricsExporter>> *exporters;
+@property (nonatomic, strong) dispatch_queue_t exportQueue;
+
+@end
+
+@implementation AWSNetworkingMetricsCollector
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _aggregates = [AWSSynchronizedMutableDictionary new];
+        _exporters = @[];
+        _exportQueue = dispatch_queue_create("com.amazonaws.AWSNetworkingMetricsCollector.export", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)recordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics {
+    NSArray *key = @[metrics.serviceName ?: @"", metrics.operationName ?: @""];
+    AWSNetworkingMetricsAggregate *aggregate = [self.aggregates objectForKey:key];
+    if (!aggregate) {
+        @synchronized(self) {
+            aggregate = [self.aggregates objectForKey:key];
+            if (!aggregate) {
+                aggregate = [[AWSNetworkingMetricsAggregate alloc] initWithServiceName:key[0] operationName:key[1]];
+                [self.aggregates setObject:aggregate forKey:key];
+            }
+        }
+    }
+    [aggregate recordOperationMetrics:metrics];
+
+    NSArray<id<AWSNetworkingMetricsExporter>> *exporters = self.exporters;
+    if ([exporters count] > 0) {
+        dispatch_async(self.exportQueue, ^{
+            for (id<AWSNetworkingMetricsExporter> exporter in exporters) {
+                [exporter metricsCollector:self didRecordOperationMetrics:metrics];
+            }
+        });
+    }
+}
+
+- (NSArray<AWSNetworkingMetricsSnapshot *> *)snapshot {
+    NSMutableArray *snapshots = [NSMutableArray new];
+    for (NSArray *key in [self.aggregates allKeys]) {
+        AWSNetworkingMetricsAggregate *aggregate = [self.aggregates objectForKey:key];
+        if (aggregate) {
+            [snapshots addObject:[aggregate snapshot]];
+        }
+    }
+    return snapshots;
+}
+
+- (AWSNetworkingMetricsSnapshot *)snapshotForServiceName:(NSString *)serviceName operationName:(NSString *)operationName {
+    AWSNetworkingMetricsAggregate *aggregate = [self.aggregates objectForKey:@[serviceName, operationName]];
+    return [aggregate snapshot];
+}
+
+- (void)reset {
+    @synchronized(self) {
+        for (NSArray *key in [self.aggregates allKeys]) {
+            [self.aggregates removeObjectForKey:key];
+        }
+    }
+}
+
+- (void)addExporter:(id<AWSNetworkingMetricsExporter>)exporter {
+    @synchronized(self) {
+        self.exporters = [self.exporters arrayByAddingObject:exporter];
+    }
+}
+
+- (void)removeExporter:(id<AWSNetworkingMetricsExporter>)exporter {
+    @synchronized(self) {
+        NSMutableArray *exporters = [self.exporters mutableCopy];
+        [exporters removeObjectIdenticalTo:exporter];
+        self.exporters = exporters;
+    }
+}
+
+@end
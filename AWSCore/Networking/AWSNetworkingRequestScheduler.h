@@ -0,0 +1,62 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSNetworking.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Limits the number of requests in flight at once. Requests over the limit wait, and are started by priority, and in the
+ order they were scheduled within a priority, as the requests in flight finish. Service clients schedule each attempt
+ of a request once it is signed, so that fetching credentials never waits for a slot. Safe to use from any thread, and to share between the configurations of several service clients.
+ */
+@interface AWSNetworkingRequestScheduler : NSObject
+
+/**
+ The number of requests that may be in flight at once.
+ */
+@property (nonatomic, readonly) NSUInteger maximumConcurrentRequests;
+
+/**
+ The number of requests started and not finished yet.
+ */
+@property (nonatomic, readonly) NSUInteger inFlightRequestCount;
+
+/**
+ The number of requests waiting to be started.
+ */
+@property (nonatomic, readonly) NSUInteger waitingRequestCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ @param maximumConcurrentRequests The number of requests that may be in flight at once. Values less than 1 are treated as 1.
+ */
+- (instancetype)initWithMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests NS_DESIGNATED_INITIALIZER;
+
+/**
+ Calls `block` once fewer than `maximumConcurrentRequests` requests are in flight and no request of the same or higher
+ priority is waiting. The request is in flight until the task returned by `block` finishes.
+
+ @param priority The priority of the request.
+ @param block Starts the request and returns a task that finishes with it.
+ @return A task that finishes with the task returned by `block`.
+ */
+- (AWSTask *)scheduleWithPriority:(AWSNetworkingRequestPriority)priority block:(AWSTask *(^)(void))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
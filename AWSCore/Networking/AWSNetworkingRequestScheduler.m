@@ -0,0 +1,112 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSNetworkingRequestScheduler.h"
+
+#import "AWSBolts.h"
+
+static const NSUInteger AWSNetworkingRequestPriorityCount = AWSNetworkingRequestPriorityHigh - AWSNetworkingRequestPriorityLow + 1;
+
+typedef void (^AWSNetworkingRequestSchedulerStartBlock)(void);
+
+@implementation AWSNetworkingRequestScheduler {
+    // One FIFO queue of start blocks per priority, lowest priority first.
+    NSArray<NSMutableArray<AWSNetworkingRequestSchedulerStartBlock> *> *waitingRequests;
+    NSUInteger inFlightRequestCount;
+}
+
+- (instancetype)initWithMaximumConcurrentRequests:(NSUInteger)maximumConcurrentRequests {
+    if (self = [super init]) {
+        _maximumConcurrentRequests = MAX(maximumConcurrentRequests, 1);
+        NSMutableArray *queues = [NSMutableArray arrayWithCapacity:AWSNetworkingRequestPriorityCount];
+        for (NSUInteger i = 0; i < AWSNetworkingRequestPriorityCount; i++) {
+            [queues addObject:[NSMutableArray new]];
+        }
+        waitingRequests = queues;
+    }
+    return self;
+}
+
+- (NSUInteger)inFlightRequestCount {
+    @synchronized(self) {
+        return inFlightRequestCount;
+    }
+}
+
+- (NSUInteger)waitingRequestCount {
+    @synchronized(self) {
+        NSUInteger count = 0;
+        for (NSMutableArray *queue in waitingRequests) {
+            count += [queue count];
+        }
+        return count;
+    }
+}
+
+- (AWSTask *)scheduleWithPriority:(AWSNetworkingRequestPriority)priority block:(AWSTask *(^)(void))block {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    AWSNetworkingRequestSchedulerStartBlock start = ^{
+        AWSTask *task = block() ?: [AWSTask taskWithResult:nil];
+        [task continueWithBlock:^id(AWSTask *task) {
+            [self requestDidFinish];
+            if (task.cancelled) {
+                [taskCompletionSource trySetCancelled];
+            } else if (task.error) {
+                [taskCompletionSource trySetError:task.error];
+            } else {
+                [taskCompletionSource trySetResult:task.result];
+            }
+            return nil;
+        }];
+    };
+
+    BOOL shouldStart = NO;
+    @synchronized(self) {
+        if (inFlightRequestCount < self.maximumConcurrentRequests) {
+            inFlightRequestCount++;
+            shouldStart = YES;
+        } else {
+            NSInteger clampedPriority = MIN(MAX(priority, AWSNetworkingRequestPriorityLow), AWSNetworkingRequestPriorityHigh);
+            [waitingRequests[clampedPriority - AWSNetworkingRequestPriorityLow] addObject:start];
+        }
+    }
+    if (shouldStart) {
+        start();
+    }
+
+    return taskCompletionSource.task;
+}
+
+// Hands the slot of a finished request to the next waiting request, if any.
+- (void)requestDidFinish {
+    AWSNetworkingRequestSchedulerStartBlock next = nil;
+    @synchronized(self) {
+        for (NSMutableArray<AWSNetworkingRequestSchedulerStartBlock> *queue in [waitingRequests reverseObjectEnumerator]) {
+            next = [queue firstObject];
+            if (next) {
+                [queue removeObjectAtIndex:0];
+                break;
+            }
+        }
+        if (!next) {
+            inFlightRequestCount--;
+        }
+    }
+    if (next) {
+        next();
+    }
+}
+
+@end
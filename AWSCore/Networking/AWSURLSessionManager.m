@@ -20,12 +20,18 @@
 #import "AWSSignature.h"
 #import "AWSBolts.h"
 #import "AWSCredentialsProvider.h"
+#import "AWSNetworkingMetrics.h"
+#import "AWSNetworkingRequestScheduler.h"
+#import "AWSService.h"
+#import "AWSURLResponseSerialization.h"
 
 NSString* const AWSResponseObjectErrorUserInfoKey = @"ResponseObjectError";
 
 #pragma mark - AWSURLSessionManagerDelegate
 
 static NSString* const AWSMobileURLSessionManagerCacheDomain = @"com.amazonaws.AWSURLSessionManager";
+// Responses whose Content-Length is larger than this are still collected, but without reserving all of it up front.
+static const long long AWSURLSessionManagerMaximumPreallocatedLength = 32 * 1024 * 1024;
 
 typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     AWSURLSessionTaskTypeUnknown,
@@ -50,10 +56,18 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (nonatomic, strong) NSURL *tempDownloadedFileURL;
 @property (nonatomic, assign) BOOL shouldWriteDirectly;
 @property (nonatomic, assign) BOOL shouldWriteToFile;
+@property (nonatomic, assign) BOOL shouldStreamResponse;
 
 @property (atomic, assign) int64_t lastTotalLengthOfChunkSignatureSent;
 @property (atomic, assign) int64_t payloadTotalBytesWritten;
 
+@property (nonatomic, strong) AWSNetworkingOperationMetrics *metrics;
+@property (nonatomic, assign) NSTimeInterval operationStartTime;
+@property (nonatomic, assign) NSTimeInterval networkStartTime;
+@property (atomic, assign) int64_t attemptBytesReceived;
+// Finishes when the task of the current attempt completes.
+@property (nonatomic, strong) AWSTaskCompletionSource *attemptCompletionSource;
+
 @end
 
 @implementation AWSURLSessionManagerDelegate
@@ -76,6 +90,235 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 @end
 
+@interface AWSNetworkingOperationMetrics()
+
+@property (nonatomic, assign) NSUInteger retryCount;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, assign) int64_t bytesReceived;
+@property (nonatomic, assign) BOOL reusedConnection;
+@property (nonatomic, strong) NSError *error;
+
+- (void)setDuration:(NSTimeInterval)duration forPhase:(AWSNetworkingMetricsPhase)phase;
+
++ (void)setMetrics:(AWSNetworkingOperationMetrics *)metrics forRequest:(NSURLRequest *)request;
+
+@end
+
+static NSTimeInterval AWSURLSessionManagerUptime(void) {
+    return [NSProcessInfo processInfo].systemUptime;
+}
+
+static NSURLSessionConfiguration *AWSURLSessionManagerSessionConfiguration(NSURLSessionConfiguration *sessionConfiguration,
+                                                                           AWSNetworkingConfiguration *configuration) {
+    sessionConfiguration.URLCache = nil;
+    if (configuration.timeoutIntervalForRequest > 0) {
+        sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
+    }
+    if (configuration.timeoutIntervalForResource > 0) {
+        sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+    }
+    sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
+    sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
+    if (configuration.HTTPMaximumConnectionsPerHost > 0) {
+        sessionConfiguration.HTTPMaximumConnectionsPerHost = configuration.HTTPMaximumConnectionsPerHost;
+    }
+    sessionConfiguration.HTTPShouldUsePipelining = configuration.HTTPShouldUsePipelining;
+
+    return sessionConfiguration;
+}
+
+// Task identifiers are only unique within a session, and a manager may start tasks in sessions of their own.
+static NSValue *AWSURLSessionManagerTaskKey(NSURLSessionTask *task) {
+    return [NSValue valueWithNonretainedObject:task];
+}
+
+static float AWSURLSessionManagerTaskPriority(AWSNetworkingRequestPriority priority) {
+    if (priority < AWSNetworkingRequestPriorityNormal) {
+        return NSURLSessionTaskPriorityLow;
+    }
+    if (priority > AWSNetworkingRequestPriorityNormal) {
+        return NSURLSessionTaskPriorityHigh;
+    }
+    return NSURLSessionTaskPriorityDefault;
+}
+
+#pragma mark - AWSURLSessionIdleMonitor
+
+// Flushes a session once it has had no tasks in flight for `idleTimeout`, which closes its idle connections.
+@interface AWSURLSessionIdleMonitor : NSObject
+
+- (instancetype)initWithSession:(NSURLSession *)session idleTimeout:(NSTimeInterval)idleTimeout;
+
+- (void)taskDidStart;
+- (void)taskDidFinish;
+- (void)stop;
+
+@end
+
+@implementation AWSURLSessionIdleMonitor {
+    __weak NSURLSession *session;
+    NSTimeInterval idleTimeout;
+    NSUInteger inFlightTaskCount;
+    // Incremented whenever the session stops being idle, so that a pending flush can tell it is stale.
+    NSUInteger generation;
+    BOOL stopped;
+}
+
+- (instancetype)initWithSession:(NSURLSession *)idleSession idleTimeout:(NSTimeInterval)timeout {
+    if (self = [super init]) {
+        session = idleSession;
+        idleTimeout = timeout;
+    }
+    return self;
+}
+
+- (void)taskDidStart {
+    @synchronized(self) {
+        inFlightTaskCount++;
+        generation++;
+    }
+}
+
+- (void)taskDidFinish {
+    NSUInteger idleGeneration;
+    @synchronized(self) {
+        if (inFlightTaskCount == 0) {
+            return;
+        }
+        inFlightTaskCount--;
+        if (inFlightTaskCount > 0 || stopped) {
+            return;
+        }
+        idleGeneration = ++generation;
+    }
+
+    __weak AWSURLSessionIdleMonitor *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(idleTimeout * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [weakSelf flushIfIdleSinceGeneration:idleGeneration];
+    });
+}
+
+- (void)flushIfIdleSinceGeneration:(NSUInteger)idleGeneration {
+    NSURLSession *idleSession = nil;
+    @synchronized(self) {
+        if (stopped || inFlightTaskCount > 0 || generation != idleGeneration) {
+            return;
+        }
+        idleSession = session;
+    }
+    AWSDDLogDebug(@"Closing the idle connections of session %@.", idleSession);
+    [idleSession flushWithCompletionHandler:^{}];
+}
+
+- (void)stop {
+    @synchronized(self) {
+        stopped = YES;
+    }
+}
+
+@end
+
+#pragma mark - AWSURLSessionManagerSharedSession
+
+// An NSURLSession, and so a pool of connections, shared by the managers whose configurations have the same transport
+// settings. It is the delegate of the session and passes the callbacks of each task to the manager that started it.
+// Shared sessions live as long as the process and are never invalidated.
+@interface AWSURLSessionManagerSharedSession : NSObject <NSURLSessionDataDelegate>
+
+@property (nonatomic, strong, readonly) NSURLSession *session;
+@property (nonatomic, strong, readonly) AWSURLSessionIdleMonitor *idleMonitor;
+
++ (instancetype)sharedSessionWithConfiguration:(AWSNetworkingConfiguration *)configuration;
+
+- (void)setManager:(AWSURLSessionManager *)manager forTask:(NSURLSessionTask *)task;
+
+@end
+
+@implementation AWSURLSessionManagerSharedSession {
+    AWSSynchronizedMutableDictionary *managers;
+}
+
++ (instancetype)sharedSessionWithConfiguration:(AWSNetworkingConfiguration *)configuration {
+    static NSMutableDictionary<NSString *, AWSURLSessionManagerSharedSession *> *sharedSessions = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedSessions = [NSMutableDictionary new];
+    });
+
+    NSString *key = [NSString stringWithFormat:@"%f|%f|%d|%@|%ld|%d|%f",
+                     configuration.timeoutIntervalForRequest,
+                     configuration.timeoutIntervalForResource,
+                     configuration.allowsCellularAccess,
+                     configuration.sharedContainerIdentifier ?: @"",
+                     (long)configuration.HTTPMaximumConnectionsPerHost,
+                     configuration.HTTPShouldUsePipelining,
+                     configuration.connectionIdleTimeout];
+    @synchronized(sharedSessions) {
+        AWSURLSessionManagerSharedSession *sharedSession = sharedSessions[key];
+        if (!sharedSession) {
+            sharedSession = [[self alloc] initWithConfiguration:configuration];
+            sharedSessions[key] = sharedSession;
+        }
+        return sharedSession;
+    }
+}
+
+- (instancetype)initWithConfiguration:(AWSNetworkingConfiguration *)configuration {
+    if (self = [super init]) {
+        managers = [AWSSynchronizedMutableDictionary new];
+        _session = [NSURLSession sessionWithConfiguration:AWSURLSessionManagerSessionConfiguration([NSURLSessionConfiguration defaultSessionConfiguration], configuration)
+                                                 delegate:self
+                                            delegateQueue:nil];
+        if (configuration.connectionIdleTimeout > 0) {
+            _idleMonitor = [[AWSURLSessionIdleMonitor alloc] initWithSession:_session
+                                                                 idleTimeout:configuration.connectionIdleTimeout];
+        }
+    }
+    return self;
+}
+
+- (void)setManager:(AWSURLSessionManager *)manager forTask:(NSURLSessionTask *)task {
+    [managers setObject:manager forKey:@(task.taskIdentifier)];
+}
+
+- (AWSURLSessionManager *)managerForTask:(NSURLSessionTask *)task {
+    return [managers objectForKey:@(task.taskIdentifier)];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    AWSURLSessionManager *manager = [self managerForTask:task];
+    [managers removeObjectForKey:@(task.taskIdentifier)];
+    [manager URLSession:session task:task didCompleteWithError:error];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
+    [[self managerForTask:task] URLSession:session
+                                      task:task
+                           didSendBodyData:bytesSent
+                            totalBytesSent:totalBytesSent
+                  totalBytesExpectedToSend:totalBytesExpectedToSend];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)taskMetrics API_AVAILABLE(ios(10.0)) {
+    [[self managerForTask:task] URLSession:session task:task didFinishCollectingMetrics:taskMetrics];
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
+    AWSURLSessionManager *manager = [self managerForTask:dataTask];
+    if (manager) {
+        [manager URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
+    } else {
+        completionHandler(NSURLSessionResponseAllow);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    [[self managerForTask:dataTask] URLSession:session dataTask:dataTask didReceiveData:data];
+}
+
+@end
+
 #pragma mark - AWSURLSessionManager
 
 //const int64_t AWSMinimumDownloadTaskSize = 1000000;
@@ -85,6 +328,9 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (nonatomic, strong) NSURLSession *session;
 @property (nonatomic, strong) AWSSynchronizedMutableDictionary *sessionManagerDelegates;
 @property (nonatomic) BOOL isSessionValid;
+@property (nonatomic, strong) NSString *metricsServiceName;
+@property (nonatomic, strong) AWSURLSessionManagerSharedSession *sharedSession;
+@property (nonatomic, strong) AWSURLSessionIdleMonitor *idleMonitor;
 
 @end
 
@@ -105,23 +351,28 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     if (self = [super init]) {
         _configuration = configuration;
 
-
-        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
-        sessionConfiguration.URLCache = nil;
-        if (configuration.timeoutIntervalForRequest > 0) {
-            sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
-        }
-        if (configuration.timeoutIntervalForResource > 0) {
-            sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+        if (configuration.usesSharedURLSession) {
+            _sharedSession = [AWSURLSessionManagerSharedSession sharedSessionWithConfiguration:configuration];
+            _session = _sharedSession.session;
+            _idleMonitor = _sharedSession.idleMonitor;
+        } else {
+            _session = [NSURLSession sessionWithConfiguration:AWSURLSessionManagerSessionConfiguration([NSURLSessionConfiguration defaultSessionConfiguration], configuration)
+                                                     delegate:self
+                                                delegateQueue:nil];
+            if (configuration.connectionIdleTimeout > 0) {
+                _idleMonitor = [[AWSURLSessionIdleMonitor alloc] initWithSession:_session
+                                                                     idleTimeout:configuration.connectionIdleTimeout];
+            }
         }
-        sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
-        sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
-        
-        _session = [NSURLSession sessionWithConfiguration:sessionConfiguration
-                                                 delegate:self
-                                            delegateQueue:nil];
         _sessionManagerDelegates = [AWSSynchronizedMutableDictionary new];
         _isSessionValid = YES;
+
+        if ([configuration isKindOfClass:[AWSServiceConfiguration class]]) {
+            _metricsServiceName = ((AWSServiceConfiguration *)configuration).endpoint.serviceName;
+        }
+        if (!_metricsServiceName) {
+            _metricsServiceName = configuration.baseURL.host ?: @"unknown";
+        }
     }
 
     return self;
@@ -138,6 +389,16 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     delegate.uploadingFileURL = request.uploadingFileURL;
     delegate.shouldWriteDirectly = request.shouldWriteDirectly;
 
+    if (request.metricsCollector) {
+        NSString *operationName = nil;
+        if ([request.responseSerializer respondsToSelector:@selector(actionName)]) {
+            operationName = [(AWSJSONResponseSerializer *)request.responseSerializer actionName];
+        }
+        delegate.metrics = [[AWSNetworkingOperationMetrics alloc] initWithServiceName:self.metricsServiceName
+                                                                         operationName:operationName ?: [NSString aws_stringWithHTTPMethod:request.HTTPMethod]];
+        delegate.operationStartTime = AWSURLSessionManagerUptime();
+    }
+
     [self taskWithDelegate:delegate];
 
     return delegate.taskCompletionSource.task;
@@ -145,30 +406,45 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 - (void)taskWithDelegate:(AWSURLSessionManagerDelegate *)delegate {
     if (!self.session || !self.isSessionValid) {
-        delegate.taskCompletionSource.error = [NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                                  code:AWSNetworkingErrorSessionInvalid
-                                                              userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated"}];
+        NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                             code:AWSNetworkingErrorSessionInvalid
+                                         userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated"}];
+        [self recordMetricsOfDelegate:delegate error:error];
+        delegate.taskCompletionSource.error = error;
         return;
     }
 
     if (delegate.downloadingFileURL) delegate.shouldWriteToFile = YES;
     delegate.responseData = nil;
     delegate.responseObject = nil;
+    delegate.shouldStreamResponse = NO;
+    delegate.attemptBytesReceived = 0;
     delegate.error = nil;
     NSMutableURLRequest *mutableRequest = [NSMutableURLRequest requestWithURL:delegate.request.URL];
     mutableRequest.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
 
     AWSNetworkingRequest *request = delegate.request;
     if (request.isCancelled) {
-        delegate.taskCompletionSource.error = [NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                                  code:AWSNetworkingErrorCancelled
-                                                              userInfo:nil];
+        NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                             code:AWSNetworkingErrorCancelled
+                                         userInfo:nil];
+        [self recordMetricsOfDelegate:delegate error:error];
+        delegate.taskCompletionSource.error = error;
         return;
     }
 
     mutableRequest.HTTPMethod = [NSString aws_stringWithHTTPMethod:delegate.request.HTTPMethod];
 
     AWSTask *task = [AWSTask taskWithResult:nil];
+    AWSExecutor *executor = request.continuationExecutor ?: [AWSExecutor defaultExecutor];
+
+    AWSNetworkingOperationMetrics *metrics = delegate.metrics;
+    __block NSTimeInterval phaseStartTime = 0;
+    __block NSTimeInterval credentialsDuration = 0;
+    if (metrics) {
+        [AWSNetworkingOperationMetrics setMetrics:metrics forRequest:mutableRequest];
+        phaseStartTime = AWSURLSessionManagerUptime();
+    }
 
     if (request.requestSerializer) {
         task = [request.requestSerializer serializeRequest:mutableRequest
@@ -176,66 +452,144 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                                                 parameters:request.parameters];
     }
 
+    if (metrics) {
+        task = [task continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
+            NSTimeInterval now = AWSURLSessionManagerUptime();
+            [metrics addDuration:now - phaseStartTime forPhase:AWSNetworkingMetricsPhaseSerialization];
+            phaseStartTime = now;
+            credentialsDuration = [metrics durationForPhase:AWSNetworkingMetricsPhaseCredentials];
+            return task;
+        }];
+    }
+
     for(id<AWSNetworkingRequestInterceptor>interceptor in request.requestInterceptors) {
-        task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+        task = [task continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
             return [interceptor interceptRequest:mutableRequest];
         }];
     }
 
-    [[[task continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    if (metrics) {
+        // The signer reports the time it waited for credentials itself, so that is taken out of the signing time.
+        task = [task continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
+            NSTimeInterval credentialsDurationOfAttempt = [metrics durationForPhase:AWSNetworkingMetricsPhaseCredentials] - credentialsDuration;
+            [metrics addDuration:AWSURLSessionManagerUptime() - phaseStartTime - credentialsDurationOfAttempt
+                        forPhase:AWSNetworkingMetricsPhaseSigning];
+            return task;
+        }];
+    }
+
+    [[[task continueWithExecutor:executor withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         AWSNetworkingRequest *request = delegate.request;
         return [request.requestSerializer validateRequest:mutableRequest];
-    }] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        switch (delegate.taskType) {
-            case AWSURLSessionTaskTypeData:
-                delegate.request.task = [self.session dataTaskWithRequest:mutableRequest];
-                break;
-
-            default:
-                break;
+    }] continueWithExecutor:executor withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        AWSNetworkingRequestScheduler *scheduler = delegate.request.requestScheduler;
+        if (scheduler) {
+            // Signing may wait for credentials that are fetched through the same scheduler, so the slot is only taken
+            // once the request is signed. It is held until the attempt finishes.
+            return [scheduler scheduleWithPriority:delegate.request.requestPriority block:^AWSTask *{
+                return [self resumeTaskWithDelegate:delegate request:mutableRequest];
+            }];
         }
-
-        if (delegate.request.task) {
-            if (!self.session || !self.isSessionValid) {
-                AWSDDLogError(@"Invalid AWSURLSessionTaskType.");
-                return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                                  code:AWSNetworkingErrorSessionInvalid
-                                                              userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated."}]];
-            }
-
-            [self.sessionManagerDelegates setObject:delegate
-                                             forKey:@(((NSURLSessionTask *)delegate.request.task).taskIdentifier)];
-
-            [self printHTTPHeadersAndBodyForRequest:delegate.request.task.originalRequest];
-
-            [delegate.request.task resume];
-        } else {
-            AWSDDLogError(@"Invalid AWSURLSessionTaskType.");
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
-                                                              code:AWSNetworkingErrorUnknown
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"Invalid AWSURLSessionTaskType."}]];
-        }
-
-        return nil;
-    }] continueWithBlock:^id(AWSTask *task) {
+        return [self resumeTaskWithDelegate:delegate request:mutableRequest];
+    }] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
         if (task.error) {
             NSError *error = task.error;
+            [self recordMetricsOfDelegate:delegate error:error];
             delegate.taskCompletionSource.error = error;
         }
         return nil;
     }];
 }
 
+// Starts the task of an attempt. Returns a task that finishes when it completes, or an error if it cannot be started.
+- (AWSTask *)resumeTaskWithDelegate:(AWSURLSessionManagerDelegate *)delegate request:(NSMutableURLRequest *)mutableRequest {
+    if (!self.session || !self.isSessionValid) {
+        return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                          code:AWSNetworkingErrorSessionInvalid
+                                                      userInfo:@{NSLocalizedDescriptionKey: @"URLSession is nil or invalidated."}]];
+    }
+    if (delegate.request.isCancelled) {
+        return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                          code:AWSNetworkingErrorCancelled
+                                                      userInfo:nil]];
+    }
+
+    NSURLSession *session = self.session;
+    if (!self.configuration.allowsConnectionReuse) {
+        // NSURLSession reserves the `Connection` header, so a request that must not share its connection is sent
+        // in an ephemeral session of its own, which is invalidated once the task has started.
+        session = [NSURLSession sessionWithConfiguration:AWSURLSessionManagerSessionConfiguration([NSURLSessionConfiguration ephemeralSessionConfiguration], self.configuration)
+                                                delegate:self
+                                           delegateQueue:nil];
+    }
+
+    switch (delegate.taskType) {
+        case AWSURLSessionTaskTypeData:
+            delegate.request.task = [session dataTaskWithRequest:mutableRequest];
+            break;
+
+        default:
+            break;
+    }
+
+    if (!delegate.request.task) {
+        if (session != self.session) {
+            [session finishTasksAndInvalidate];
+        }
+        AWSDDLogError(@"Invalid AWSURLSessionTaskType.");
+        return [AWSTask taskWithError:[NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                          code:AWSNetworkingErrorUnknown
+                                                      userInfo:@{NSLocalizedDescriptionKey: @"Invalid AWSURLSessionTaskType."}]];
+    }
+
+    delegate.attemptCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    [self.sessionManagerDelegates setObject:delegate
+                                     forKey:AWSURLSessionManagerTaskKey(delegate.request.task)];
+
+    if (session == self.sharedSession.session) {
+        [self.sharedSession setManager:self forTask:delegate.request.task];
+    }
+
+    [self printHTTPHeadersAndBodyForRequest:delegate.request.task.originalRequest];
+
+    delegate.request.task.priority = AWSURLSessionManagerTaskPriority(delegate.request.requestPriority);
+    delegate.networkStartTime = AWSURLSessionManagerUptime();
+    [self.idleMonitor taskDidStart];
+    [delegate.request.task resume];
+    if (session != self.session) {
+        [session finishTasksAndInvalidate];
+    }
+
+    return delegate.attemptCompletionSource.task;
+}
+
+// Finishes the metrics of an operation and passes them to the collector. Called once, when the result is known.
+- (void)recordMetricsOfDelegate:(AWSURLSessionManagerDelegate *)delegate error:(NSError *)error {
+    AWSNetworkingOperationMetrics *metrics = delegate.metrics;
+    if (!metrics) {
+        return;
+    }
+    [metrics addDuration:AWSURLSessionManagerUptime() - delegate.operationStartTime forPhase:AWSNetworkingMetricsPhaseTotal];
+    metrics.retryCount = delegate.currentRetryCount;
+    metrics.error = error;
+    [delegate.request.metricsCollector recordOperationMetrics:metrics];
+}
+
 /**
  Invalidates the underlying NSURLSession to avoid memory leaks. Internally, calls
  `-[NSURLSession finishTasksAndInvalidate]` so that any in-process tasks are allowed
- to complete before invalidating.
+ to complete before invalidating. A shared session is left valid for the other managers
+ using it, and only stops being used by this one.
 
  @warning Before calling this method, make sure no method is running on this manager.
  */
 - (void)invalidate {
-    // Invalidate the session so its strong reference to self is released.
     self.isSessionValid = NO;
+    if (self.sharedSession) {
+        return;
+    }
+    // Invalidate the session so its strong reference to self is released.
+    [self.idleMonitor stop];
     [self.session finishTasksAndInvalidate];
 }
 
@@ -258,9 +612,19 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }
 
     [self printHTTPHeadersForResponse:sessionTask.response];
-
-    [[[AWSTask taskWithResult:nil] continueWithSuccessBlock:^id(AWSTask *task) {
-        AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(sessionTask.taskIdentifier)];
+    [self.idleMonitor taskDidFinish];
+
+    AWSExecutor *executor = self.configuration.continuationExecutor ?: [AWSExecutor defaultExecutor];
+    [[[AWSTask taskWithResult:nil] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
+        AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:AWSURLSessionManagerTaskKey(sessionTask)];
+        // Gives up the place of the attempt in the request scheduler, also when it is about to be retried.
+        [delegate.attemptCompletionSource trySetResult:nil];
+        AWSNetworkingOperationMetrics *metrics = delegate.metrics;
+        if (metrics) {
+            [metrics addDuration:AWSURLSessionManagerUptime() - delegate.networkStartTime forPhase:AWSNetworkingMetricsPhaseNetwork];
+            metrics.bytesReceived = delegate.attemptBytesReceived;
+            metrics.statusCode = [sessionTask.response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)sessionTask.response).statusCode : 0;
+        }
 
         if (delegate.responseFilehandle) {
             [delegate.responseFilehandle closeFile];
@@ -302,11 +666,15 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 } else {
                     if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                         NSError *error = nil;
+                        NSTimeInterval parsingStartTime = metrics ? AWSURLSessionManagerUptime() : 0;
                         delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                                  originalRequest:sessionTask.originalRequest
                                                                                                   currentRequest:sessionTask.currentRequest
                                                                                                             data:delegate.downloadingFileURL
                                                                                                            error:&error];
+                        if (metrics) {
+                            [metrics addDuration:AWSURLSessionManagerUptime() - parsingStartTime forPhase:AWSNetworkingMetricsPhaseParsing];
+                        }
                         if (error) {
                             delegate.error = error;
                         }
@@ -319,11 +687,15 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 // need to call responseSerializer if there is no client-side error.
                 if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                     NSError *error = nil;
+                    NSTimeInterval parsingStartTime = metrics ? AWSURLSessionManagerUptime() : 0;
                     delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                              originalRequest:sessionTask.originalRequest
                                                                                               currentRequest:sessionTask.currentRequest
                                                                                                         data:delegate.responseData
                                                                                                        error:&error];
+                    if (metrics) {
+                        [metrics addDuration:AWSURLSessionManagerUptime() - parsingStartTime forPhase:AWSNetworkingMetricsPhaseParsing];
+                    }
                     if (error) {
                         if ([delegate.responseObject isKindOfClass:[NSDictionary class]]) {
                             NSDictionary *responseObject = (NSDictionary *)delegate.responseObject;
@@ -397,16 +769,18 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                                                                                                         data:delegate.responseData
                                                                                                        error:delegate.error];
                     [NSThread sleepForTimeInterval:timeIntervalToSleep];
+                    [metrics addDuration:timeIntervalToSleep forPhase:AWSNetworkingMetricsPhaseRetryDelay];
                     delegate.currentRetryCount++;
                     [self taskWithDelegate:delegate];
                 }
                     break;
 
                 case AWSNetworkingRetryTypeShouldNotRetry: {
+                    [self recordMetricsOfDelegate:delegate error:delegate.error];
                     if (delegate.error) {
                         NSError *error = delegate.error;
                         delegate.taskCompletionSource.error = error;
-                    } else if (delegate.responseObject) {
+                    } else {
                         id result = delegate.responseObject;
                         delegate.taskCompletionSource.result = result;
                     }
@@ -425,23 +799,24 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 [retryHandler setValue:@NO forKey:@"isClockSkewRetried"];
             }
 
+            [self recordMetricsOfDelegate:delegate error:delegate.error];
             if (delegate.error) {
                 NSError *error = delegate.error;
                 delegate.taskCompletionSource.error = error;
-            } else if (delegate.responseObject) {
+            } else {
                 id result = delegate.responseObject;
                 delegate.taskCompletionSource.result = result;
             }
         }
         return nil;
-    }] continueWithBlock:^id(AWSTask *task) {
-        [self.sessionManagerDelegates removeObjectForKey:@(sessionTask.taskIdentifier)];
+    }] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
+        [self.sessionManagerDelegates removeObjectForKey:AWSURLSessionManagerTaskKey(sessionTask)];
         return nil;
     }];
 }
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(task.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:AWSURLSessionManagerTaskKey(task)];
     AWSNetworkingUploadProgressBlock uploadProgress = delegate.request.uploadProgress;
     
     if (uploadProgress) {
@@ -464,11 +839,43 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)taskMetrics API_AVAILABLE(ios(10.0)) {
+    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:AWSURLSessionManagerTaskKey(task)];
+    AWSNetworkingOperationMetrics *metrics = delegate.metrics;
+    NSURLSessionTaskTransactionMetrics *transaction = [taskMetrics.transactionMetrics lastObject];
+    if (!metrics || !transaction) {
+        return;
+    }
+
+    // Only the last attempt's connection is described, so these replace the values of earlier attempts.
+    metrics.reusedConnection = transaction.reusedConnection;
+    if (transaction.domainLookupStartDate && transaction.domainLookupEndDate) {
+        [metrics setDuration:[transaction.domainLookupEndDate timeIntervalSinceDate:transaction.domainLookupStartDate]
+                    forPhase:AWSNetworkingMetricsPhaseDomainLookup];
+    }
+    if (transaction.connectStartDate && transaction.connectEndDate) {
+        [metrics setDuration:[transaction.connectEndDate timeIntervalSinceDate:transaction.connectStartDate]
+                    forPhase:AWSNetworkingMetricsPhaseConnect];
+    }
+    if (transaction.secureConnectionStartDate && transaction.secureConnectionEndDate) {
+        [metrics setDuration:[transaction.secureConnectionEndDate timeIntervalSinceDate:transaction.secureConnectionStartDate]
+                    forPhase:AWSNetworkingMetricsPhaseSecureConnection];
+    }
+    if (transaction.requestStartDate && transaction.responseStartDate) {
+        [metrics setDuration:[transaction.responseStartDate timeIntervalSinceDate:transaction.requestStartDate]
+                    forPhase:AWSNetworkingMetricsPhaseTimeToFirstByte];
+    }
+    if (transaction.responseStartDate && transaction.responseEndDate) {
+        [metrics setDuration:[transaction.responseEndDate timeIntervalSinceDate:transaction.responseStartDate]
+                    forPhase:AWSNetworkingMetricsPhaseResponseTransfer];
+    }
+}
+
 #pragma mark - NSURLSessionDataDelegate
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(dataTask.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:AWSURLSessionManagerTaskKey(dataTask)];
     
     //If the response code is not 2xx, avoid write data to disk
     if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
@@ -480,6 +887,16 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             // got error status code, avoid write data to disk
             delegate.shouldWriteToFile = NO;
         }
+
+        // Error responses are collected so that the response serializer can parse them.
+        if (!delegate.shouldWriteToFile) {
+            if (delegate.request.responseDataHandler
+                && httpResponse.statusCode >= 200 && httpResponse.statusCode < 300) {
+                delegate.shouldStreamResponse = YES;
+            } else if (response.expectedContentLength > 0) {
+                delegate.responseData = [NSMutableData dataWithCapacity:(NSUInteger)MIN(response.expectedContentLength, AWSURLSessionManagerMaximumPreallocatedLength)];
+            }
+        }
     }
     
     @try {
@@ -556,7 +973,10 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(dataTask.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:AWSURLSessionManagerTaskKey(dataTask)];
+    if (delegate.metrics) {
+        delegate.attemptBytesReceived += [data length];
+    }
     
     if (delegate.responseFilehandle) {
         @try{
@@ -571,6 +991,8 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             delegate.error = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo: userInfo];
             [dataTask cancel];
         }
+    } else if (delegate.shouldStreamResponse) {
+        delegate.request.responseDataHandler(data);
     } else {
         if (!delegate.responseData) {
             delegate.responseData = [NSMutableData dataWithData:data];
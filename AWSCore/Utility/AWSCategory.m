@@ -17,6 +17,7 @@
 #import <CommonCrypto/CommonCryptor.h>
 #import <CommonCrypto/CommonDigest.h>
 #import "AWSCocoaLumberjack.h"
+#import "AWSDateFormatting.h"
 #import "AWSGZIP.h"
 #import "AWSMantle.h"
 
@@ -55,6 +56,21 @@ static NSTimeInterval _clockskew = 0.0;
 }
 
 + (NSDate *)aws_dateFromString:(NSString *)string {
+    // Try every fixed format before falling back to NSDateFormatter, so that a string in one of the later formats is
+    // not first run through the formatters of the earlier ones.
+    static const AWSDateFormat fixedFormats[] = {
+        AWSDateFormatRFC822,
+        AWSDateFormatISO8601,
+        AWSDateFormatISO8601Basic,
+        AWSDateFormatISO8601Milliseconds,
+    };
+    for (size_t i = 0; i < sizeof(fixedFormats) / sizeof(fixedFormats[0]); i++) {
+        NSDate *parsedDate = [NSDate aws_dateFromString:string fixedFormat:fixedFormats[i]];
+        if (parsedDate) {
+            return parsedDate;
+        }
+    }
+
     NSDate *parsedDate = nil;
     NSArray *arrayOfDateFormat = @[AWSDateRFC822DateFormat1,
                                    AWSDateISO8601DateFormat1,
@@ -63,7 +79,7 @@ static NSTimeInterval _clockskew = 0.0;
 
     for (NSString *dateFormat in arrayOfDateFormat) {
         if (!parsedDate) {
-            parsedDate = [NSDate aws_dateFromString:string format:dateFormat];
+            parsedDate = [[NSDate aws_dateFormatterWithFormat:dateFormat] dateFromString:string];
         } else {
             break;
         }
@@ -73,143 +89,65 @@ static NSTimeInterval _clockskew = 0.0;
 }
 
 + (NSDate *)aws_dateFromString:(NSString *)string format:(NSString *)dateFormat {
-    if ([dateFormat isEqualToString:AWSDateRFC822DateFormat1]) {
-        return [[NSDate aws_RFC822Date1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat1]) {
-        return [[NSDate aws_ISO8601Date1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat2]) {
-        return [[NSDate aws_ISO8601Date2Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat3]) {
-        return [[NSDate aws_ISO8601Date3Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat1]) {
-        return [[NSDate aws_ShortDateFormat1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat2]) {
-        return [[NSDate aws_ShortDateFormat2Formatter] dateFromString:string];
+    AWSDateFormat fixedFormat;
+    if (AWSDateFormatFromString(dateFormat, &fixedFormat)) {
+        NSDate *parsedDate = [NSDate aws_dateFromString:string fixedFormat:fixedFormat];
+        if (parsedDate) {
+            return parsedDate;
+        }
     }
 
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    dateFormatter.dateFormat = dateFormat;
-
-    return [dateFormatter dateFromString:string];
+    // NSDateFormatter is more lenient than the fixed-format parser, e.g. about time zone names.
+    return [[NSDate aws_dateFormatterWithFormat:dateFormat] dateFromString:string];
 }
 
-- (NSString *)aws_stringValue:(NSString *)dateFormat {
-    if ([dateFormat isEqualToString:AWSDateRFC822DateFormat1]) {
-        return [[NSDate aws_RFC822Date1Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat1]) {
-        return [[NSDate aws_ISO8601Date1Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat2]) {
-        return [[NSDate aws_ISO8601Date2Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat3]) {
-        return [[NSDate aws_ISO8601Date3Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat1]) {
-        return [[NSDate aws_ShortDateFormat1Formatter] stringFromDate:self];
++ (NSDate *)aws_dateFromString:(NSString *)string fixedFormat:(AWSDateFormat)format {
+    char buffer[64];
+    if (![string getCString:buffer maxLength:sizeof(buffer) encoding:NSASCIIStringEncoding]) {
+        return nil;
     }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat2]) {
-        return [[NSDate aws_ShortDateFormat2Formatter] stringFromDate:self];
+    NSTimeInterval timeIntervalSince1970;
+    if (!AWSDateFormatParse(format, buffer, strlen(buffer), &timeIntervalSince1970)) {
+        return nil;
     }
-
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    dateFormatter.dateFormat = dateFormat;
-
-    return [dateFormatter stringFromDate:self];
-}
-
-+ (NSDateFormatter *)aws_RFC822Date1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateRFC822DateFormat1;
-    });
-
-    return _dateFormatter;
+    return [NSDate dateWithTimeIntervalSince1970:timeIntervalSince1970];
 }
 
-+ (NSDateFormatter *)aws_ISO8601Date1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat1;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ISO8601Date2Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat2;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ISO8601Date3Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat3;
-    });
+- (NSString *)aws_stringValue:(NSString *)dateFormat {
+    AWSDateFormat fixedFormat;
+    if (AWSDateFormatFromString(dateFormat, &fixedFormat)) {
+        char buffer[AWSDateFormatMaximumLength];
+        size_t length = AWSDateFormatWrite(fixedFormat, [self timeIntervalSince1970], buffer, sizeof(buffer));
+        if (length > 0) {
+            return [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
+        }
+    }
 
-    return _dateFormatter;
+    return [[NSDate aws_dateFormatterWithFormat:dateFormat] stringFromDate:self];
 }
 
-+ (NSDateFormatter *)aws_ShortDateFormat1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
+/**
+ Returns a GMT, en_US_POSIX formatter for the format. Formatters are kept in a cache, since creating one is expensive;
+ NSDateFormatter itself is safe to use from several threads at once.
+ */
++ (NSDateFormatter *)aws_dateFormatterWithFormat:(NSString *)dateFormat {
+    static NSCache<NSString *, NSDateFormatter *> *_dateFormatters = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateShortDateFormat1;
+        _dateFormatters = [NSCache new];
+        _dateFormatters.name = @"com.amazonaws.AWSCategory.dateFormatters";
     });
 
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ShortDateFormat2Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateShortDateFormat2;
-    });
+    NSDateFormatter *dateFormatter = [_dateFormatters objectForKey:dateFormat];
+    if (!dateFormatter) {
+        dateFormatter = [NSDateFormatter new];
+        dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+        dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        dateFormatter.dateFormat = dateFormat;
+        [_dateFormatters setObject:dateFormatter forKey:[dateFormat copy]];
+    }
 
-    return _dateFormatter;
+    return dateFormatter;
 }
 
 + (void)aws_setRuntimeClockSkew:(NSTimeInterval)clockskew {
@@ -346,8 +284,8 @@ static NSTimeInterval _clockskew = 0.0;
              * Ref. https://developer.apple.com/library/ios/documentation/Cocoa/Conceptual/ObjCRuntimeGuide/Articles/ocrtPropertyIntrospection.html#//apple_ref/doc/uid/TP40008048-CH101-SW1
              */
             if ([attributes rangeOfString:@",R,"].location == NSNotFound) {
-                if (![key isEqualToString:@"uploadProgress"] && ![key isEqualToString:@"downloadProgress"]) {
-                    //do not copy progress block since they do not have getter method and they have already been copied via internalRequest. copy it again will result in overwrite the current value to nil.
+                if (![key isEqualToString:@"uploadProgress"] && ![key isEqualToString:@"downloadProgress"] && ![key isEqualToString:@"responseDataHandler"]) {
+                    //do not copy progress and response data blocks since they do not have getter method and they have already been copied via internalRequest. copy it again will result in overwrite the current value to nil.
                     [self setValue:[object valueForKey:key]
                             forKey:key];
                 }
@@ -0,0 +1,89 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The fixed date formats used by AWS services. Dates are always written in UTC.
+ */
+typedef NS_ENUM(NSInteger, AWSDateFormat) {
+    /** `AWSDateRFC822DateFormat1`, e.g. `Wed, 02 Jan 2019 03:45:06 GMT`. */
+    AWSDateFormatRFC822,
+    /** `AWSDateISO8601DateFormat1`, e.g. `2019-01-02T03:45:06Z`. */
+    AWSDateFormatISO8601,
+    /** `AWSDateISO8601DateFormat2`, e.g. `20190102T034506Z`. */
+    AWSDateFormatISO8601Basic,
+    /** `AWSDateISO8601DateFormat3`, e.g. `2019-01-02T03:45:06.789Z`. */
+    AWSDateFormatISO8601Milliseconds,
+    /** `AWSDateShortDateFormat1`, e.g. `20190102`. */
+    AWSDateFormatShortDateBasic,
+    /** `AWSDateShortDateFormat2`, e.g. `2019-01-02`. */
+    AWSDateFormatShortDate,
+    /** The format of the Unix `date -u` command, `EEE MMM d HH:mm:ss 'UTC' yyyy`, e.g. `Wed Jan 2 03:45:06 UTC 2019`. */
+    AWSDateFormatUnixDate,
+};
+
+/**
+ A buffer of this many bytes holds any date written by `AWSDateFormatWrite`, including the terminating NUL. A
+ compile-time constant, so it can size arrays on the stack.
+ */
+enum {
+    AWSDateFormatMaximumLength = 32
+};
+
+/**
+ Writes a date in the given format as a NUL-terminated ASCII string.
+
+ These functions keep no state, so they are safe to call from any thread without locking.
+
+ @param format                the format to write
+ @param timeIntervalSince1970 the date to write
+ @param buffer                the buffer to write to
+ @param capacity              the size of `buffer` in bytes
+ @return the length of the string written, not counting the NUL, or 0 if the year is outside 1 through 9999 or the
+         buffer is too small
+ */
+FOUNDATION_EXPORT size_t AWSDateFormatWrite(AWSDateFormat format,
+                                            NSTimeInterval timeIntervalSince1970,
+                                            char *buffer,
+                                            size_t capacity);
+
+/**
+ Parses a date written in the given format.
+
+ Parsing is strict: the string must match the format exactly, except that RFC 822 dates may use a one-digit day and
+ any of `GMT`, `UTC`, `UT`, `Z` or a `+hhmm`/`-hhmm` offset as the zone.
+
+ @param format                the format to parse
+ @param string                the characters to parse, which need not be NUL-terminated
+ @param length                the number of characters to parse
+ @param timeIntervalSince1970 set to the parsed date on success
+ @return YES if the string matched the format
+ */
+FOUNDATION_EXPORT BOOL AWSDateFormatParse(AWSDateFormat format,
+                                          const char *string,
+                                          size_t length,
+                                          NSTimeInterval *timeIntervalSince1970);
+
+/**
+ Looks up the fixed format for one of the `AWSDate*Format*` format strings.
+
+ @return YES if `dateFormat` is one of the format strings in `AWSCategory.h`
+ */
+FOUNDATION_EXPORT BOOL AWSDateFormatFromString(NSString *dateFormat, AWSDateFormat *format);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,436 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDateFormatting.h"
+#import "AWSCategory.h"
+
+#import <math.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const int64_t AWSDateSecondsPerDay = 86400;
+
+static const char AWSDateWeekdayNames[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char AWSDateMonthNames[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                              "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+typedef struct {
+    int64_t year;
+    unsigned month;   // 1-12
+    unsigned day;     // 1-31
+    unsigned hour;
+    unsigned minute;
+    unsigned second;
+    unsigned millisecond;
+    unsigned weekday; // 0 is Sunday
+} AWSDateComponents;
+
+#pragma mark - Calendar arithmetic
+
+// Days from 1970-01-01 to the given proleptic Gregorian date, and back. These are Howard Hinnant's days_from_civil and
+// civil_from_days, which shift the year to start in March so that the leap day falls at its end.
+static int64_t AWSDateDaysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+static void AWSDateCivilFromDays(int64_t days, AWSDateComponents *components) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    components->day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    components->month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    components->year = (int64_t)yearOfEra + era * 400 + (components->month <= 2);
+}
+
+static unsigned AWSDateDaysInMonth(int64_t year, unsigned month) {
+    static const unsigned daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
+        return 29;
+    }
+    return daysInMonth[month - 1];
+}
+
+static int64_t AWSDateFloorDivide(int64_t dividend, int64_t divisor) {
+    int64_t quotient = dividend / divisor;
+    return (dividend % divisor != 0 && (dividend < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+static BOOL AWSDateComponentsFromTimeInterval(NSTimeInterval timeIntervalSince1970, AWSDateComponents *components) {
+    // Milliseconds are truncated towards the past, as NSDateFormatter does.
+    double totalMilliseconds = floor(timeIntervalSince1970 * 1000.0);
+    if (!isfinite(totalMilliseconds) || fabs(totalMilliseconds) > 4.0e17) {
+        return NO;
+    }
+    int64_t milliseconds = (int64_t)totalMilliseconds;
+    int64_t seconds = AWSDateFloorDivide(milliseconds, 1000);
+    int64_t days = AWSDateFloorDivide(seconds, AWSDateSecondsPerDay);
+    int64_t secondOfDay = seconds - days * AWSDateSecondsPerDay;
+
+    AWSDateCivilFromDays(days, components);
+    if (components->year < 1 || components->year > 9999) {
+        return NO;
+    }
+    components->millisecond = (unsigned)(milliseconds - seconds * 1000);
+    components->hour = (unsigned)(secondOfDay / 3600);
+    components->minute = (unsigned)(secondOfDay / 60 % 60);
+    components->second = (unsigned)(secondOfDay % 60);
+    // 1970-01-01 was a Thursday.
+    components->weekday = (unsigned)(days - AWSDateFloorDivide(days + 4, 7) * 7 + 4);
+    return YES;
+}
+
+#pragma mark - Writing
+
+static char *AWSDateWriteDigits(char *cursor, unsigned value, unsigned width) {
+    for (unsigned i = width; i > 0; i--) {
+        cursor[i - 1] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    return cursor + width;
+}
+
+static char *AWSDateWriteName(char *cursor, const char name[4]) {
+    cursor[0] = name[0];
+    cursor[1] = name[1];
+    cursor[2] = name[2];
+    return cursor + 3;
+}
+
+static char *AWSDateWriteLiteral(char *cursor, const char *literal) {
+    while (*literal) {
+        *cursor++ = *literal++;
+    }
+    return cursor;
+}
+
+static char *AWSDateWriteTime(char *cursor, const AWSDateComponents *components, BOOL separated) {
+    cursor = AWSDateWriteDigits(cursor, components->hour, 2);
+    if (separated) {
+        *cursor++ = ':';
+    }
+    cursor = AWSDateWriteDigits(cursor, components->minute, 2);
+    if (separated) {
+        *cursor++ = ':';
+    }
+    return AWSDateWriteDigits(cursor, components->second, 2);
+}
+
+static char *AWSDateWriteDate(char *cursor, const AWSDateComponents *components, BOOL separated) {
+    cursor = AWSDateWriteDigits(cursor, (unsigned)components->year, 4);
+    if (separated) {
+        *cursor++ = '-';
+    }
+    cursor = AWSDateWriteDigits(cursor, components->month, 2);
+    if (separated) {
+        *cursor++ = '-';
+    }
+    return AWSDateWriteDigits(cursor, components->day, 2);
+}
+
+size_t AWSDateFormatWrite(AWSDateFormat format, NSTimeInterval timeIntervalSince1970, char *buffer, size_t capacity) {
+    AWSDateComponents components;
+    if (!AWSDateComponentsFromTimeInterval(timeIntervalSince1970, &components)) {
+        return 0;
+    }
+
+    char string[AWSDateFormatMaximumLength];
+    char *cursor = string;
+    switch (format) {
+        case AWSDateFormatRFC822:
+            cursor = AWSDateWriteName(cursor, AWSDateWeekdayNames[components.weekday]);
+            cursor = AWSDateWriteLiteral(cursor, ", ");
+            cursor = AWSDateWriteDigits(cursor, components.day, 2);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteName(cursor, AWSDateMonthNames[components.month - 1]);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteDigits(cursor, (unsigned)components.year, 4);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteTime(cursor, &components, YES);
+            cursor = AWSDateWriteLiteral(cursor, " GMT");
+            break;
+        case AWSDateFormatISO8601:
+            cursor = AWSDateWriteDate(cursor, &components, YES);
+            *cursor++ = 'T';
+            cursor = AWSDateWriteTime(cursor, &components, YES);
+            *cursor++ = 'Z';
+            break;
+        case AWSDateFormatISO8601Basic:
+            cursor = AWSDateWriteDate(cursor, &components, NO);
+            *cursor++ = 'T';
+            cursor = AWSDateWriteTime(cursor, &components, NO);
+            *cursor++ = 'Z';
+            break;
+        case AWSDateFormatISO8601Milliseconds:
+            cursor = AWSDateWriteDate(cursor, &components, YES);
+            *cursor++ = 'T';
+            cursor = AWSDateWriteTime(cursor, &components, YES);
+            *cursor++ = '.';
+            cursor = AWSDateWriteDigits(cursor, components.millisecond, 3);
+            *cursor++ = 'Z';
+            break;
+        case AWSDateFormatShortDateBasic:
+            cursor = AWSDateWriteDate(cursor, &components, NO);
+            break;
+        case AWSDateFormatShortDate:
+            cursor = AWSDateWriteDate(cursor, &components, YES);
+            break;
+        case AWSDateFormatUnixDate:
+            cursor = AWSDateWriteName(cursor, AWSDateWeekdayNames[components.weekday]);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteName(cursor, AWSDateMonthNames[components.month - 1]);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteDigits(cursor, components.day, components.day < 10 ? 1 : 2);
+            *cursor++ = ' ';
+            cursor = AWSDateWriteTime(cursor, &components, YES);
+            cursor = AWSDateWriteLiteral(cursor, " UTC ");
+            cursor = AWSDateWriteDigits(cursor, (unsigned)components.year, 4);
+            break;
+        default:
+            return 0;
+    }
+
+    size_t length = (size_t)(cursor - string);
+    if (length + 1 > capacity) {
+        return 0;
+    }
+    memcpy(buffer, string, length);
+    buffer[length] = '\0';
+    return length;
+}
+
+#pragma mark - Parsing
+
+typedef struct {
+    const char *cursor;
+    const char *end;
+} AWSDateScanner;
+
+static BOOL AWSDateScanDigits(AWSDateScanner *scanner, unsigned minimumWidth, unsigned maximumWidth, unsigned *value) {
+    unsigned width = 0;
+    unsigned result = 0;
+    while (width < maximumWidth && scanner->cursor < scanner->end
+           && *scanner->cursor >= '0' && *scanner->cursor <= '9') {
+        result = result * 10 + (unsigned)(*scanner->cursor - '0');
+        scanner->cursor++;
+        width++;
+    }
+    *value = result;
+    return width >= minimumWidth;
+}
+
+static BOOL AWSDateScanLiteral(AWSDateScanner *scanner, const char *literal) {
+    const char *cursor = scanner->cursor;
+    while (*literal) {
+        if (cursor >= scanner->end || *cursor != *literal) {
+            return NO;
+        }
+        cursor++;
+        literal++;
+    }
+    scanner->cursor = cursor;
+    return YES;
+}
+
+static BOOL AWSDateScanName(AWSDateScanner *scanner, const char names[][4], unsigned count, unsigned *index) {
+    if (scanner->end - scanner->cursor < 3) {
+        return NO;
+    }
+    for (unsigned i = 0; i < count; i++) {
+        if (memcmp(scanner->cursor, names[i], 3) == 0) {
+            scanner->cursor += 3;
+            *index = i;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+static BOOL AWSDateScanDate(AWSDateScanner *scanner, AWSDateComponents *components, BOOL separated) {
+    unsigned year;
+    if (!AWSDateScanDigits(scanner, 4, 4, &year)
+        || (separated && !AWSDateScanLiteral(scanner, "-"))
+        || !AWSDateScanDigits(scanner, 2, 2, &components->month)
+        || (separated && !AWSDateScanLiteral(scanner, "-"))
+        || !AWSDateScanDigits(scanner, 2, 2, &components->day)) {
+        return NO;
+    }
+    components->year = year;
+    return YES;
+}
+
+static BOOL AWSDateScanTime(AWSDateScanner *scanner, AWSDateComponents *components, BOOL separated) {
+    return AWSDateScanDigits(scanner, 2, 2, &components->hour)
+        && (!separated || AWSDateScanLiteral(scanner, ":"))
+        && AWSDateScanDigits(scanner, 2, 2, &components->minute)
+        && (!separated || AWSDateScanLiteral(scanner, ":"))
+        && AWSDateScanDigits(scanner, 2, 2, &components->second);
+}
+
+// Scans the zone of an RFC 822 date as an offset east of UTC, in seconds.
+static BOOL AWSDateScanZone(AWSDateScanner *scanner, int64_t *offset) {
+    *offset = 0;
+    if (AWSDateScanLiteral(scanner, "GMT") || AWSDateScanLiteral(scanner, "UTC")
+        || AWSDateScanLiteral(scanner, "UT") || AWSDateScanLiteral(scanner, "Z")) {
+        return YES;
+    }
+    int64_t sign;
+    if (AWSDateScanLiteral(scanner, "+")) {
+        sign = 1;
+    } else if (AWSDateScanLiteral(scanner, "-")) {
+        sign = -1;
+    } else {
+        return NO;
+    }
+    unsigned hours, minutes;
+    if (!AWSDateScanDigits(scanner, 2, 2, &hours) || !AWSDateScanDigits(scanner, 2, 2, &minutes)
+        || hours > 23 || minutes > 59) {
+        return NO;
+    }
+    *offset = sign * (int64_t)(hours * 3600 + minutes * 60);
+    return YES;
+}
+
+BOOL AWSDateFormatParse(AWSDateFormat format, const char *string, size_t length, NSTimeInterval *timeIntervalSince1970) {
+    AWSDateScanner scanner = {string, string + length};
+    AWSDateComponents components = {0};
+    int64_t offset = 0;
+    unsigned ignored;
+    BOOL matched;
+
+    switch (format) {
+        case AWSDateFormatRFC822: {
+            unsigned month = 0;
+            unsigned year = 0;
+            matched = AWSDateScanName(&scanner, AWSDateWeekdayNames, 7, &ignored)
+                && AWSDateScanLiteral(&scanner, ", ")
+                && AWSDateScanDigits(&scanner, 1, 2, &components.day)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanName(&scanner, AWSDateMonthNames, 12, &month)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanDigits(&scanner, 4, 4, &year)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanTime(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanZone(&scanner, &offset);
+            components.month = month + 1;
+            components.year = year;
+            break;
+        }
+        case AWSDateFormatISO8601:
+            matched = AWSDateScanDate(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, "T")
+                && AWSDateScanTime(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, "Z");
+            break;
+        case AWSDateFormatISO8601Basic:
+            matched = AWSDateScanDate(&scanner, &components, NO)
+                && AWSDateScanLiteral(&scanner, "T")
+                && AWSDateScanTime(&scanner, &components, NO)
+                && AWSDateScanLiteral(&scanner, "Z");
+            break;
+        case AWSDateFormatISO8601Milliseconds:
+            matched = AWSDateScanDate(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, "T")
+                && AWSDateScanTime(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, ".")
+                && AWSDateScanDigits(&scanner, 3, 3, &components.millisecond)
+                && AWSDateScanLiteral(&scanner, "Z");
+            break;
+        case AWSDateFormatShortDateBasic:
+            matched = AWSDateScanDate(&scanner, &components, NO);
+            break;
+        case AWSDateFormatShortDate:
+            matched = AWSDateScanDate(&scanner, &components, YES);
+            break;
+        case AWSDateFormatUnixDate: {
+            unsigned month = 0;
+            unsigned year = 0;
+            matched = AWSDateScanName(&scanner, AWSDateWeekdayNames, 7, &ignored)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanName(&scanner, AWSDateMonthNames, 12, &month)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanDigits(&scanner, 1, 2, &components.day)
+                && AWSDateScanLiteral(&scanner, " ")
+                && AWSDateScanTime(&scanner, &components, YES)
+                && AWSDateScanLiteral(&scanner, " UTC ")
+                && AWSDateScanDigits(&scanner, 4, 4, &year);
+            components.month = month + 1;
+            components.year = year;
+            break;
+        }
+        default:
+            return NO;
+    }
+
+    if (!matched || scanner.cursor != scanner.end
+        || components.year < 1
+        || components.month < 1 || components.month > 12
+        || components.day < 1 || components.day > AWSDateDaysInMonth(components.year, components.month)
+        || components.hour > 23 || components.minute > 59 || components.second > 59) {
+        return NO;
+    }
+
+    int64_t days = AWSDateDaysFromCivil(components.year, components.month, components.day);
+    int64_t seconds = days * AWSDateSecondsPerDay
+        + components.hour * 3600 + components.minute * 60 + components.second
+        - offset;
+    *timeIntervalSince1970 = (NSTimeInterval)seconds + components.millisecond / 1000.0;
+    return YES;
+}
+
+BOOL AWSDateFormatFromString(NSString *dateFormat, AWSDateFormat *format) {
+    // Callers nearly always pass the constants themselves, so compare pointers before contents.
+    __unsafe_unretained NSString *formatStrings[] = {
+        AWSDateRFC822DateFormat1,
+        AWSDateISO8601DateFormat1,
+        AWSDateISO8601DateFormat2,
+        AWSDateISO8601DateFormat3,
+        AWSDateShortDateFormat1,
+        AWSDateShortDateFormat2,
+    };
+    static const AWSDateFormat formats[] = {
+        AWSDateFormatRFC822,
+        AWSDateFormatISO8601,
+        AWSDateFormatISO8601Basic,
+        AWSDateFormatISO8601Milliseconds,
+        AWSDateFormatShortDateBasic,
+        AWSDateFormatShortDate,
+    };
+    const size_t count = sizeof(formats) / sizeof(formats[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        if (dateFormat == formatStrings[i]) {
+            *format = formats[i];
+            return YES;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if ([dateFormat isEqualToString:formatStrings[i]]) {
+            *format = formats[i];
+            return YES;
+        }
+    }
+    return NO;
+}
+
+NS_ASSUME_NONNULL_END
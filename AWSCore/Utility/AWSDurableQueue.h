@@ -0,0 +1,218 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSTask.h"
+
+@class AWSFMDatabaseQueue;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A record stored in an `AWSDurableQueue`.
+ */
+@interface AWSDurableQueueRecord : NSObject
+
+/**
+ Creates a record to append, timestamped now.
+
+ @param channel The channel the record belongs to, such as a stream name.
+ @param key     An optional key stored with the record, such as a partition key.
+ @param tag     An optional tag records can be looked up by.
+ @param data    The record data.
+ */
+- (instancetype)initWithChannel:(NSString *)channel
+                            key:(nullable NSString *)key
+                            tag:(nullable NSString *)tag
+                           data:(NSData *)data;
+
+/**
+ Creates a record with an existing timestamp and retry count, for moving records from another store.
+ */
+- (instancetype)initWithChannel:(NSString *)channel
+                            key:(nullable NSString *)key
+                            tag:(nullable NSString *)tag
+                           data:(NSData *)data
+                      timestamp:(NSTimeInterval)timestamp
+                     retryCount:(NSUInteger)retryCount NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The row the record is stored in, or 0 if it has not been stored yet.
+ */
+@property (nonatomic, readonly) int64_t identifier;
+
+@property (nonatomic, readonly) NSString *channel;
+
+@property (nonatomic, readonly, nullable) NSString *key;
+
+@property (nonatomic, readonly, nullable) NSString *tag;
+
+@property (nonatomic, readonly) NSData *data;
+
+/**
+ When the record was first appended, in seconds since 1970.
+ */
+@property (nonatomic, readonly) NSTimeInterval timestamp;
+
+/**
+ How many times delivery of the record has been retried.
+ */
+@property (nonatomic, readonly) NSUInteger retryCount;
+
+/**
+ The bytes the record counts against `byteLimit`: the length of the data plus the UTF-8 length of the key and tag.
+ */
+@property (nonatomic, readonly) NSUInteger byteCount;
+
+@end
+
+/**
+ A first-in, first-out queue of records kept in a SQLite table.
+
+ Records are delivered at least once: reading records does not remove them, and they stay in the queue until they are
+ acknowledged. A consumer that stops before acknowledging a batch receives the same records again the next time it
+ reads. Only one consumer should read a channel at a time.
+
+ Records are appended in segments of about `segmentByteSize` bytes. When the queue holds more than `byteLimit` bytes,
+ whole segments are removed, oldest first, so that eviction costs one statement however many records it removes. The
+ segment being appended to is never removed.
+ */
+@interface AWSDurableQueue : NSObject
+
+/**
+ Opens a queue in the database at `path`, creating it if needed.
+ */
+- (instancetype)initWithPath:(NSString *)path;
+
+/**
+ Opens a queue in a database that may also hold other tables. The queue keeps its records in the
+ `aws_durable_record` table.
+
+ @param databaseQueue A queue opened with `serialDatabaseQueueWithPath:`.
+ */
+- (instancetype)initWithDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) AWSFMDatabaseQueue *databaseQueue;
+
+/**
+ The most bytes, as counted by `byteCount`, the queue keeps. Appending past the limit evicts the oldest segments. 0,
+ the default, means no limit.
+ */
+@property (atomic, assign) uint64_t byteLimit;
+
+/**
+ Records appended longer ago than this are removed on the next append. 0, the default, means no limit.
+ */
+@property (atomic, assign) NSTimeInterval ageLimit;
+
+/**
+ The number of bytes appended before a new segment is started. The default is 64KB. When `byteLimit` is smaller, it is
+ used instead.
+ */
+@property (atomic, assign) NSUInteger segmentByteSize;
+
+/**
+ The number of times a record may be retried. A record retried more often is moved to `deadLetterChannel`, or removed
+ if there is none. The default is 3.
+ */
+@property (atomic, assign) NSUInteger maximumRetryCount;
+
+/**
+ The channel records that run out of retries are moved to. Records in this channel are evicted before any others, and
+ `oldestRecordsInChannel:` never picks it when no channel is given. The default is `nil`.
+ */
+@property (atomic, copy, nullable) NSString *deadLetterChannel;
+
+/**
+ The total `byteCount` of the records in the queue.
+ */
+@property (nonatomic, readonly) uint64_t byteCount;
+
+/**
+ The number of records in the queue.
+ */
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+/**
+ Appends a record. Records appended while an earlier batch is being written are written together in one transaction.
+
+ @return A task that completes once the record is committed. `task.result` is the stored record.
+ */
+- (AWSTask<AWSDurableQueueRecord *> *)appendRecord:(AWSDurableQueueRecord *)record;
+
+/**
+ Appends records in a single transaction and waits for it to commit.
+ */
+- (BOOL)appendRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error;
+
+/**
+ Reads the oldest records of a channel without removing them.
+
+ @param channel   The channel to read, or `nil` for the channel of the oldest record outside `deadLetterChannel`.
+ @param limit     The most records to return.
+ @param byteLimit The most bytes, as counted by `byteCount`, to return. The oldest record is always returned even if
+                  it is larger. 0 means no limit.
+ @return The records, oldest first, or `nil` on error.
+ */
+- (nullable NSArray<AWSDurableQueueRecord *> *)oldestRecordsInChannel:(nullable NSString *)channel
+                                                                limit:(NSUInteger)limit
+                                                            byteLimit:(NSUInteger)byteLimit
+                                                                error:(NSError **)error;
+
+/**
+ Reads every record of a channel with the given tag, oldest first.
+ */
+- (nullable NSArray<AWSDurableQueueRecord *> *)recordsInChannel:(NSString *)channel
+                                                            tag:(NSString *)tag
+                                                          error:(NSError **)error;
+
+/**
+ Removes delivered records from the queue. Records that are no longer in the queue are ignored.
+ */
+- (BOOL)acknowledgeRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error;
+
+/**
+ Counts a failed delivery for each record. Records retried more than `maximumRetryCount` times are moved to
+ `deadLetterChannel` or removed.
+ */
+- (BOOL)retryRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error;
+
+/**
+ Moves records to another channel, keeping their place in the queue.
+ */
+- (BOOL)moveRecords:(NSArray<AWSDurableQueueRecord *> *)records toChannel:(NSString *)channel error:(NSError **)error;
+
+/**
+ Rewrites the data of every record of a channel with the given tag.
+
+ @param block Returns the new data for a record, or `nil` to leave it unchanged.
+ */
+- (BOOL)updateRecordsInChannel:(NSString *)channel
+                           tag:(NSString *)tag
+                    usingBlock:(NSData * _Nullable (^)(AWSDurableQueueRecord *record))block
+                         error:(NSError **)error;
+
+/**
+ Removes the records of a channel, or every record if `channel` is `nil`.
+ */
+- (BOOL)removeRecordsInChannel:(nullable NSString *)channel error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
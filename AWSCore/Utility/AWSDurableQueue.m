@@ -0,0 +1,625 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDurableQueue.h"
+
+#import <stdatomic.h>
+#import "AWSCocoaLumberjack.h"
+#import "AWSFMDB.h"
+#import "AWSTaskCompletionSource.h"
+
+static NSUInteger const AWSDurableQueueSegmentByteSizeDefault = 64 * 1024;
+static NSUInteger const AWSDurableQueueMaximumRetryCountDefault = 3;
+
+static NSString *const AWSDurableQueueSelectColumns = @"SELECT id, channel, record_key, record_tag, data, timestamp, retry_count ";
+
+// How a transaction changed the counters. Applied only once the transaction commits.
+typedef struct {
+    int64_t byteCount;
+    NSInteger recordCount;
+} AWSDurableQueueChange;
+
+@interface AWSDurableQueueRecord()
+
+@property (nonatomic, assign) int64_t identifier;
+@property (nonatomic, assign) NSUInteger byteCount;
+
+@end
+
+@implementation AWSDurableQueueRecord
+
+- (instancetype)initWithChannel:(NSString *)channel
+                            key:(NSString *)key
+                            tag:(NSString *)tag
+                           data:(NSData *)data {
+    return [self initWithChannel:channel
+                             key:key
+                             tag:tag
+                            data:data
+                       timestamp:[[NSDate date] timeIntervalSince1970]
+                      retryCount:0];
+}
+
+- (instancetype)initWithChannel:(NSString *)channel
+                            key:(NSString *)key
+                            tag:(NSString *)tag
+                           data:(NSData *)data
+                      timestamp:(NSTimeInterval)timestamp
+                     retryCount:(NSUInteger)retryCount {
+    if (self = [super init]) {
+        _channel = [channel copy];
+        _key = [key copy];
+        _tag = [tag copy];
+        _data = [data copy];
+        _timestamp = timestamp;
+        _retryCount = retryCount;
+        _byteCount = [_data length]
+        + [_key lengthOfBytesUsingEncoding:NSUTF8StringEncoding]
+        + [_tag lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    }
+    return self;
+}
+
+- (instancetype)initWithResultSet:(AWSFMResultSet *)rs {
+    if (self = [self initWithChannel:[rs stringForColumnIndex:1]
+                                 key:[rs stringForColumnIndex:2]
+                                 tag:[rs stringForColumnIndex:3]
+                                data:[rs dataForColumnIndex:4] ?: [NSData data]
+                           timestamp:[rs doubleForColumnIndex:5]
+                          retryCount:(NSUInteger)[rs longLongIntForColumnIndex:6]]) {
+        _identifier = [rs longLongIntForColumnIndex:0];
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p> {identifier: %lld, channel: %@, key: %@, tag: %@, byteCount: %lu, retryCount: %lu}",
+            NSStringFromClass([self class]), self, self.identifier, self.channel, self.key, self.tag,
+            (unsigned long)self.byteCount, (unsigned long)self.retryCount];
+}
+
+@end
+
+@interface AWSDurableQueue()
+
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+
+@end
+
+@implementation AWSDurableQueue {
+    _Atomic(uint64_t) _byteCount;
+    _Atomic(NSUInteger) _recordCount;
+
+    // Only touched inside databaseQueue blocks.
+    int64_t _segment;
+    uint64_t _segmentByteCount;
+
+    // Guarded by _pendingLock.
+    NSObject *_pendingLock;
+    NSMutableArray<AWSDurableQueueRecord *> *_pendingRecords;
+    NSMutableArray<AWSTaskCompletionSource *> *_pendingCompletionSources;
+    BOOL _appendScheduled;
+    dispatch_queue_t _appendQueue;
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    return [self initWithDatabaseQueue:[AWSFMDatabaseQueue serialDatabaseQueueWithPath:path]];
+}
+
+- (instancetype)initWithDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    if (self = [super init]) {
+        _databaseQueue = databaseQueue;
+        _segmentByteSize = AWSDurableQueueSegmentByteSizeDefault;
+        _maximumRetryCount = AWSDurableQueueMaximumRetryCountDefault;
+        atomic_init(&_byteCount, 0);
+        atomic_init(&_recordCount, 0);
+        _pendingLock = [NSObject new];
+        _pendingRecords = [NSMutableArray new];
+        _pendingCompletionSources = [NSMutableArray new];
+        _appendQueue = dispatch_queue_create("com.amazonaws.AWSDurableQueue", DISPATCH_QUEUE_SERIAL);
+
+        [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            if (![db executeStatements:
+                  @"CREATE TABLE IF NOT EXISTS aws_durable_record ("
+                  @"id INTEGER PRIMARY KEY,"
+                  @"segment INTEGER NOT NULL,"
+                  @"channel TEXT NOT NULL,"
+                  @"record_key TEXT,"
+                  @"record_tag TEXT,"
+                  @"data BLOB NOT NULL,"
+                  @"byte_count INTEGER NOT NULL,"
+                  @"timestamp REAL NOT NULL,"
+                  @"retry_count INTEGER NOT NULL);"
+                  @"CREATE INDEX IF NOT EXISTS aws_durable_record_channel ON aws_durable_record (channel, id);"
+                  @"CREATE INDEX IF NOT EXISTS aws_durable_record_segment ON aws_durable_record (segment);"]) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                return;
+            }
+
+            AWSFMResultSet *rs = [db executeQuery:@"SELECT COUNT(*), TOTAL(byte_count), MAX(segment) FROM aws_durable_record"];
+            if ([rs next]) {
+                atomic_store(&self->_recordCount, (NSUInteger)[rs longLongIntForColumnIndex:0]);
+                atomic_store(&self->_byteCount, (uint64_t)[rs doubleForColumnIndex:1]);
+                self->_segment = [rs longLongIntForColumnIndex:2];
+            }
+            [rs close];
+
+            rs = [db executeQuery:@"SELECT TOTAL(byte_count) FROM aws_durable_record WHERE segment = ?", @(self->_segment)];
+            if ([rs next]) {
+                self->_segmentByteCount = (uint64_t)[rs doubleForColumnIndex:0];
+            }
+            [rs close];
+        }];
+    }
+    return self;
+}
+
+- (uint64_t)byteCount {
+    return atomic_load(&_byteCount);
+}
+
+- (NSUInteger)recordCount {
+    return atomic_load(&_recordCount);
+}
+
+#pragma mark - Appending
+
+- (AWSTask<AWSDurableQueueRecord *> *)appendRecord:(AWSDurableQueueRecord *)record {
+    AWSTaskCompletionSource *completionSource = [AWSTaskCompletionSource taskCompletionSource];
+    BOOL scheduleAppend = NO;
+    @synchronized(_pendingLock) {
+        [_pendingRecords addObject:record];
+        [_pendingCompletionSources addObject:completionSource];
+        if (!_appendScheduled) {
+            _appendScheduled = YES;
+            scheduleAppend = YES;
+        }
+    }
+
+    if (scheduleAppend) {
+        dispatch_async(_appendQueue, ^{
+            [self appendPendingRecords];
+        });
+    }
+    return completionSource.task;
+}
+
+// Group commit: everything appended while the previous transaction was being written goes into the next one.
+- (void)appendPendingRecords {
+    NSArray<AWSDurableQueueRecord *> *records = nil;
+    NSArray<AWSTaskCompletionSource *> *completionSources = nil;
+    @synchronized(_pendingLock) {
+        records = _pendingRecords;
+        completionSources = _pendingCompletionSources;
+        _pendingRecords = [NSMutableArray new];
+        _pendingCompletionSources = [NSMutableArray new];
+        _appendScheduled = NO;
+    }
+
+    NSError *error = nil;
+    [self appendRecords:records error:&error];
+    for (NSUInteger i = 0; i < [completionSources count]; i++) {
+        if (error) {
+            [completionSources[i] setError:error];
+        } else {
+            [completionSources[i] setResult:records[i]];
+        }
+    }
+}
+
+- (BOOL)appendRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error {
+    if ([records count] == 0) {
+        return YES;
+    }
+
+    // A segment larger than the byte limit could only be evicted whole, taking the records just appended with it.
+    uint64_t segmentByteSize = MAX(self.segmentByteSize, 1);
+    uint64_t byteLimit = self.byteLimit;
+    if (byteLimit > 0) {
+        segmentByteSize = MIN(segmentByteSize, byteLimit);
+    }
+    __block NSError *databaseError = nil;
+    // The transaction is begun and committed by hand, so that the counters and segment are only updated, still on the
+    // database queue, once the commit has succeeded.
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        if (![db beginTransaction]) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            databaseError = db.lastError;
+            return;
+        }
+
+        int64_t segment = self->_segment;
+        uint64_t segmentByteCount = self->_segmentByteCount;
+        AWSDurableQueueChange change = {0, 0};
+        NSMutableArray<NSNumber *> *identifiers = [NSMutableArray arrayWithCapacity:[records count]];
+
+        for (AWSDurableQueueRecord *record in records) {
+            if (segmentByteCount >= segmentByteSize) {
+                segment++;
+                segmentByteCount = 0;
+            }
+            BOOL result = [db executeUpdate:
+                           @"INSERT INTO aws_durable_record ("
+                           @"segment, channel, record_key, record_tag, data, byte_count, timestamp, retry_count"
+                           @") VALUES (?, ?, ?, ?, ?, ?, ?, ?)"
+                       withArgumentsInArray:@[@(segment),
+                                              record.channel,
+                                              record.key ?: [NSNull null],
+                                              record.tag ?: [NSNull null],
+                                              record.data,
+                                              @(record.byteCount),
+                                              @(record.timestamp),
+                                              @(record.retryCount)]];
+            if (!result) {
+                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
+                databaseError = db.lastError;
+                [db rollback];
+                return;
+            }
+            [identifiers addObject:@([db lastInsertRowId])];
+            segmentByteCount += record.byteCount;
+            change.byteCount += (int64_t)record.byteCount;
+            change.recordCount += 1;
+        }
+
+        // The records are stored even if eviction fails; it is tried again on the next append.
+        [self evictInDatabase:db currentSegment:segment change:&change];
+
+        if (![db commit]) {
+            AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
+            databaseError = db.lastError;
+            [db rollback];
+            return;
+        }
+
+        for (NSUInteger i = 0; i < [records count]; i++) {
+            records[i].identifier = [identifiers[i] longLongValue];
+        }
+        self->_segment = segment;
+        self->_segmentByteCount = segmentByteCount;
+        [self applyChange:change];
+    }];
+
+    if (databaseError && error) {
+        *error = databaseError;
+    }
+    return databaseError == nil;
+}
+
+- (void)applyChange:(AWSDurableQueueChange)change {
+    atomic_fetch_add(&_byteCount, (uint64_t)change.byteCount);
+    atomic_fetch_add(&_recordCount, (NSUInteger)change.recordCount);
+}
+
+#pragma mark - Eviction
+
+// Never evicts `currentSegment`, which holds the records being appended.
+- (BOOL)evictInDatabase:(AWSFMDatabase *)db currentSegment:(int64_t)currentSegment change:(AWSDurableQueueChange *)change {
+    NSTimeInterval ageLimit = self.ageLimit;
+    if (ageLimit > 0) {
+        NSTimeInterval cutoff = [[NSDate date] timeIntervalSince1970] - ageLimit;
+        // Records are appended in time order, so only look for old records when the first one is old.
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT timestamp FROM aws_durable_record ORDER BY id ASC LIMIT 1"];
+        BOOL hasExpiredRecords = [rs next] && [rs doubleForColumnIndex:0] < cutoff;
+        [rs close];
+        if (hasExpiredRecords
+            && ![self deleteRecordsWhere:@"timestamp < ?" arguments:@[@(cutoff)] inDatabase:db change:change]) {
+            return NO;
+        }
+    }
+
+    uint64_t byteLimit = self.byteLimit;
+    if (byteLimit == 0 || [self byteCountWithChange:change] <= byteLimit) {
+        return YES;
+    }
+
+    NSString *deadLetterChannel = self.deadLetterChannel;
+    if (deadLetterChannel) {
+        if (![self deleteRecordsWhere:@"channel = ?" arguments:@[deadLetterChannel] inDatabase:db change:change]) {
+            return NO;
+        }
+        if ([self byteCountWithChange:change] <= byteLimit) {
+            return YES;
+        }
+    }
+
+    // Find the fewest oldest segments that bring the queue back under the limit.
+    uint64_t excessByteCount = [self byteCountWithChange:change] - byteLimit;
+    uint64_t evictedByteCount = 0;
+    int64_t lastEvictedSegment = INT64_MIN;
+    AWSFMResultSet *rs = [db executeQuery:@"SELECT segment, TOTAL(byte_count) FROM aws_durable_record WHERE segment < ? GROUP BY segment ORDER BY segment ASC",
+                          @(currentSegment)];
+    if (!rs) {
+        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+        return NO;
+    }
+    while (evictedByteCount < excessByteCount && [rs next]) {
+        lastEvictedSegment = [rs longLongIntForColumnIndex:0];
+        evictedByteCount += (uint64_t)[rs doubleForColumnIndex:1];
+    }
+    [rs close];
+
+    if (lastEvictedSegment == INT64_MIN) {
+        return YES;
+    }
+    AWSDDLogWarn(@"Evicting segments up to %lld, the byte limit of %llu has been reached.", lastEvictedSegment, byteLimit);
+    return [self deleteRecordsWhere:@"segment <= ?" arguments:@[@(lastEvictedSegment)] inDatabase:db change:change];
+}
+
+// The byte count the queue will have once `change` is applied.
+- (uint64_t)byteCountWithChange:(const AWSDurableQueueChange *)change {
+    return atomic_load(&_byteCount) + (uint64_t)change->byteCount;
+}
+
+- (BOOL)deleteRecordsWhere:(NSString *)condition
+                 arguments:(NSArray *)arguments
+                inDatabase:(AWSFMDatabase *)db
+                    change:(AWSDurableQueueChange *)change {
+    AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:@"SELECT COUNT(*), TOTAL(byte_count) FROM aws_durable_record WHERE %@", condition]
+                     withArgumentsInArray:arguments];
+    if (!rs) {
+        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+        return NO;
+    }
+    NSUInteger recordCount = 0;
+    uint64_t byteCount = 0;
+    if ([rs next]) {
+        recordCount = (NSUInteger)[rs longLongIntForColumnIndex:0];
+        byteCount = (uint64_t)[rs doubleForColumnIndex:1];
+    }
+    [rs close];
+    if (recordCount == 0) {
+        return YES;
+    }
+
+    if (![db executeUpdate:[NSString stringWithFormat:@"DELETE FROM aws_durable_record WHERE %@", condition]
+      withArgumentsInArray:arguments]) {
+        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+        return NO;
+    }
+    change->byteCount -= (int64_t)byteCount;
+    change->recordCount -= (NSInteger)recordCount;
+    return YES;
+}
+
+#pragma mark - Reading
+
+- (NSArray<AWSDurableQueueRecord *> *)oldestRecordsInChannel:(NSString *)channel
+                                                       limit:(NSUInteger)limit
+                                                   byteLimit:(NSUInteger)byteLimit
+                                                       error:(NSError **)error {
+    NSString *deadLetterChannel = self.deadLetterChannel;
+    __block NSError *databaseError = nil;
+    __block NSMutableArray<AWSDurableQueueRecord *> *records = [NSMutableArray new];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        NSString *selectedChannel = channel;
+        if (!selectedChannel) {
+            AWSFMResultSet *rs = deadLetterChannel
+            ? [db executeQuery:@"SELECT channel FROM aws_durable_record WHERE channel != ? ORDER BY id ASC LIMIT 1", deadLetterChannel]
+            : [db executeQuery:@"SELECT channel FROM aws_durable_record ORDER BY id ASC LIMIT 1"];
+            if (!rs) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                databaseError = db.lastError;
+                return;
+            }
+            if ([rs next]) {
+                selectedChannel = [rs stringForColumnIndex:0];
+            }
+            [rs close];
+            if (!selectedChannel) {
+                return;
+            }
+        }
+
+        AWSFMResultSet *rs = [db executeQuery:[AWSDurableQueueSelectColumns stringByAppendingString:
+                                               @"FROM aws_durable_record WHERE channel = ? ORDER BY id ASC LIMIT ?"],
+                              selectedChannel, @(limit)];
+        if (!rs) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            databaseError = db.lastError;
+            return;
+        }
+        NSUInteger byteCount = 0;
+        while ([rs next]) {
+            AWSDurableQueueRecord *record = [[AWSDurableQueueRecord alloc] initWithResultSet:rs];
+            if (byteLimit > 0 && [records count] > 0 && byteCount + record.byteCount > byteLimit) {
+                break;
+            }
+            byteCount += record.byteCount;
+            [records addObject:record];
+        }
+        [rs close];
+    }];
+
+    if (databaseError) {
+        if (error) {
+            *error = databaseError;
+        }
+        return nil;
+    }
+    return records;
+}
+
+- (NSArray<AWSDurableQueueRecord *> *)recordsInChannel:(NSString *)channel
+                                                   tag:(NSString *)tag
+                                                 error:(NSError **)error {
+    __block NSError *databaseError = nil;
+    __block NSMutableArray<AWSDurableQueueRecord *> *records = [NSMutableArray new];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:[AWSDurableQueueSelectColumns stringByAppendingString:
+                                               @"FROM aws_durable_record WHERE channel = ? AND record_tag = ? ORDER BY id ASC"],
+                              channel, tag];
+        if (!rs) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            databaseError = db.lastError;
+            return;
+        }
+        while ([rs next]) {
+            [records addObject:[[AWSDurableQueueRecord alloc] initWithResultSet:rs]];
+        }
+        [rs close];
+    }];
+
+    if (databaseError) {
+        if (error) {
+            *error = databaseError;
+        }
+        return nil;
+    }
+    return records;
+}
+
+#pragma mark - Acknowledging
+
+// Runs `block` for each record still in the queue, in one transaction. The block receives the stored byte count and
+// retry count, which may differ from the caller's copy of the record.
+- (BOOL)inTransactionForRecords:(NSArray<AWSDurableQueueRecord *> *)records
+                          error:(NSError **)error
+                     usingBlock:(BOOL (^)(AWSFMDatabase *db, AWSDurableQueueRecord *record, uint64_t byteCount, NSUInteger retryCount, AWSDurableQueueChange *change))block {
+    if ([records count] == 0) {
+        return YES;
+    }
+
+    __block NSError *databaseError = nil;
+    __block AWSDurableQueueChange change = {0, 0};
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (AWSDurableQueueRecord *record in records) {
+            AWSFMResultSet *rs = [db executeQuery:@"SELECT byte_count, retry_count FROM aws_durable_record WHERE id = ?", @(record.identifier)];
+            if (!rs) {
+                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
+                databaseError = db.lastError;
+                *rollback = YES;
+                return;
+            }
+            BOOL exists = [rs next];
+            uint64_t byteCount = exists ? (uint64_t)[rs longLongIntForColumnIndex:0] : 0;
+            NSUInteger retryCount = exists ? (NSUInteger)[rs longLongIntForColumnIndex:1] : 0;
+            [rs close];
+
+            if (exists && !block(db, record, byteCount, retryCount, &change)) {
+                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
+                databaseError = db.lastError;
+                *rollback = YES;
+                return;
+            }
+        }
+    }];
+
+    if (databaseError) {
+        if (error) {
+            *error = databaseError;
+        }
+        return NO;
+    }
+    [self applyChange:change];
+    return YES;
+}
+
+- (BOOL)deleteRecord:(AWSDurableQueueRecord *)record
+           byteCount:(uint64_t)byteCount
+          inDatabase:(AWSFMDatabase *)db
+              change:(AWSDurableQueueChange *)change {
+    if (![db executeUpdate:@"DELETE FROM aws_durable_record WHERE id = ?", @(record.identifier)]) {
+        return NO;
+    }
+    change->byteCount -= (int64_t)byteCount;
+    change->recordCount -= 1;
+    return YES;
+}
+
+- (BOOL)acknowledgeRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error {
+    return [self inTransactionForRecords:records error:error usingBlock:^BOOL(AWSFMDatabase *db, AWSDurableQueueRecord *record, uint64_t byteCount, NSUInteger retryCount, AWSDurableQueueChange *change) {
+        return [self deleteRecord:record byteCount:byteCount inDatabase:db change:change];
+    }];
+}
+
+- (BOOL)retryRecords:(NSArray<AWSDurableQueueRecord *> *)records error:(NSError **)error {
+    NSUInteger maximumRetryCount = self.maximumRetryCount;
+    NSString *deadLetterChannel = self.deadLetterChannel;
+    return [self inTransactionForRecords:records error:error usingBlock:^BOOL(AWSFMDatabase *db, AWSDurableQueueRecord *record, uint64_t byteCount, NSUInteger retryCount, AWSDurableQueueChange *change) {
+        if (retryCount + 1 <= maximumRetryCount) {
+            return [db executeUpdate:@"UPDATE aws_durable_record SET retry_count = ? WHERE id = ?", @(retryCount + 1), @(record.identifier)];
+        }
+        if (deadLetterChannel) {
+            AWSDDLogWarn(@"Moving record %lld to %@ after %lu retries.", record.identifier, deadLetterChannel, (unsigned long)retryCount + 1);
+            return [db executeUpdate:@"UPDATE aws_durable_record SET retry_count = ?, channel = ? WHERE id = ?",
+                    @(retryCount + 1), deadLetterChannel, @(record.identifier)];
+        }
+        AWSDDLogWarn(@"Removing record %lld after %lu retries.", record.identifier, (unsigned long)retryCount + 1);
+        return [self deleteRecord:record byteCount:byteCount inDatabase:db change:change];
+    }];
+}
+
+- (BOOL)moveRecords:(NSArray<AWSDurableQueueRecord *> *)records toChannel:(NSString *)channel error:(NSError **)error {
+    return [self inTransactionForRecords:records error:error usingBlock:^BOOL(AWSFMDatabase *db, AWSDurableQueueRecord *record, uint64_t byteCount, NSUInteger retryCount, AWSDurableQueueChange *change) {
+        return [db executeUpdate:@"UPDATE aws_durable_record SET channel = ? WHERE id = ?", channel, @(record.identifier)];
+    }];
+}
+
+- (BOOL)updateRecordsInChannel:(NSString *)channel
+                           tag:(NSString *)tag
+                    usingBlock:(NSData * _Nullable (^)(AWSDurableQueueRecord *record))block
+                         error:(NSError **)error {
+    NSArray<AWSDurableQueueRecord *> *records = [self recordsInChannel:channel tag:tag error:error];
+    if (!records) {
+        return NO;
+    }
+
+    NSMutableDictionary<NSNumber *, NSData *> *updatedData = [NSMutableDictionary new];
+    for (AWSDurableQueueRecord *record in records) {
+        NSData *data = block(record);
+        if (data) {
+            updatedData[@(record.identifier)] = data;
+        }
+    }
+
+    return [self inTransactionForRecords:records error:error usingBlock:^BOOL(AWSFMDatabase *db, AWSDurableQueueRecord *record, uint64_t byteCount, NSUInteger retryCount, AWSDurableQueueChange *change) {
+        NSData *data = updatedData[@(record.identifier)];
+        if (!data) {
+            return YES;
+        }
+        uint64_t updatedByteCount = byteCount - [record.data length] + [data length];
+        if (![db executeUpdate:@"UPDATE aws_durable_record SET data = ?, byte_count = ? WHERE id = ?",
+              data, @(updatedByteCount), @(record.identifier)]) {
+            return NO;
+        }
+        change->byteCount += (int64_t)updatedByteCount - (int64_t)byteCount;
+        return YES;
+    }];
+}
+
+- (BOOL)removeRecordsInChannel:(NSString *)channel error:(NSError **)error {
+    __block BOOL result = YES;
+    __block NSError *databaseError = nil;
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSDurableQueueChange change = {0, 0};
+        result = channel
+        ? [self deleteRecordsWhere:@"channel = ?" arguments:@[channel] inDatabase:db change:&change]
+        : [self deleteRecordsWhere:@"1" arguments:@[] inDatabase:db change:&change];
+        if (result) {
+            // A single DELETE outside a transaction commits as soon as it succeeds.
+            [self applyChange:change];
+        } else {
+            databaseError = db.lastError;
+        }
+    }];
+
+    if (databaseError && error) {
+        *error = databaseError;
+    }
+    return result;
+}
+
+@end
@@ -15,6 +15,10 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ A thread-safe mutable dictionary. Keys are spread across several shards, each behind a reader/writer lock, so lookups
+ run concurrently with each other and only contend with writes to the same shard.
+ */
 @interface AWSSynchronizedMutableDictionary : NSObject
 
 - (id)objectForKey:(id)aKey;
@@ -14,64 +14,109 @@
 //
 
 #import "AWSSynchronizedMutableDictionary.h"
+#import <pthread.h>
 
-@interface AWSSynchronizedMutableDictionary()
+// Keys are spread over this many independently locked dictionaries, so that writers only block readers of one shard.
+static const NSUInteger AWSSynchronizedMutableDictionaryShardCount = 16;
 
-@property (nonatomic, strong) NSMutableDictionary *dictionary;
-@property (nonatomic, strong) dispatch_queue_t dispatchQueue;
+typedef struct {
+    pthread_rwlock_t lock;
+    // A retained NSMutableDictionary.
+    void *dictionary;
+} AWSSynchronizedMutableDictionaryShard;
 
-@end
-
-@implementation AWSSynchronizedMutableDictionary
+@implementation AWSSynchronizedMutableDictionary {
+    AWSSynchronizedMutableDictionaryShard _shards[AWSSynchronizedMutableDictionaryShardCount];
+}
 
 - (instancetype)init {
     if (self = [super init]) {
-        _dictionary = [NSMutableDictionary new];
-        _dispatchQueue = dispatch_queue_create("com.amazonaws.AWSSynchronizedMutableDictionary", DISPATCH_QUEUE_SERIAL);
+        for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+            pthread_rwlock_init(&_shards[i].lock, NULL);
+            _shards[i].dictionary = (void *)CFBridgingRetain([NSMutableDictionary new]);
+        }
     }
 
     return self;
 }
 
-- (id)objectForKey:(id)aKey {
-    __block id returnObject = nil;
+- (void)dealloc {
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_rwlock_destroy(&_shards[i].lock);
+        CFRelease(_shards[i].dictionary);
+    }
+}
 
-    dispatch_sync(self.dispatchQueue, ^{
-        returnObject = [self.dictionary objectForKey:aKey];
-    });
+- (AWSSynchronizedMutableDictionaryShard *)shardForKey:(id)aKey {
+    // Mix the hash first; NSNumber and short NSString hashes are poorly distributed in their low bits.
+    uint64_t hash = (uint64_t)[aKey hash] * 0x9E3779B97F4A7C15ULL;
+    return &_shards[(hash >> 32) % AWSSynchronizedMutableDictionaryShardCount];
+}
+
+- (id)objectForKey:(id)aKey {
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:aKey];
+    pthread_rwlock_rdlock(&shard->lock);
+    id returnObject = [(__bridge NSMutableDictionary *)shard->dictionary objectForKey:aKey];
+    pthread_rwlock_unlock(&shard->lock);
 
     return returnObject;
 }
 
 - (void)removeObjectForKey:(id)aKey {
-    dispatch_sync(self.dispatchQueue, ^{
-        [self.dictionary removeObjectForKey:aKey];
-    });
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:aKey];
+    // Keep the object alive until the lock is released, so its dealloc never runs while other callers are blocked.
+    // Precise lifetime stops ARC from releasing it early, since it is never read again.
+    __attribute__((objc_precise_lifetime)) id removedObject = nil;
+    pthread_rwlock_wrlock(&shard->lock);
+    NSMutableDictionary *dictionary = (__bridge NSMutableDictionary *)shard->dictionary;
+    removedObject = [dictionary objectForKey:aKey];
+    [dictionary removeObjectForKey:aKey];
+    pthread_rwlock_unlock(&shard->lock);
 }
 
 - (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey {
-    dispatch_sync(self.dispatchQueue, ^{
-        [self.dictionary setObject:anObject forKey:aKey];
-    });
+    AWSSynchronizedMutableDictionaryShard *shard = [self shardForKey:aKey];
+    __attribute__((objc_precise_lifetime)) id replacedObject = nil;
+    pthread_rwlock_wrlock(&shard->lock);
+    NSMutableDictionary *dictionary = (__bridge NSMutableDictionary *)shard->dictionary;
+    replacedObject = [dictionary objectForKey:aKey];
+    [dictionary setObject:anObject forKey:aKey];
+    pthread_rwlock_unlock(&shard->lock);
 }
 
 - (NSArray *)allKeys {
-    __block NSArray *allKeys = nil;
-    dispatch_sync(self.dispatchQueue, ^{
-        allKeys = [self.dictionary allKeys];
-    });
+    // Hold every shard at once so the keys are a consistent snapshot.
+    NSMutableArray *allKeys = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_rwlock_rdlock(&_shards[i].lock);
+    }
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        [allKeys addObjectsFromArray:[(__bridge NSMutableDictionary *)_shards[i].dictionary allKeys]];
+    }
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        pthread_rwlock_unlock(&_shards[i].lock);
+    }
     return allKeys;
 }
 
 - (void)removeObject:(id)object {
-    dispatch_sync(self.dispatchQueue, ^{
-        for (NSString *key in self.dictionary) {
-            if (object == self.dictionary[key]) {
-                [self.dictionary removeObjectForKey:key];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryShardCount; i++) {
+        AWSSynchronizedMutableDictionaryShard *shard = &_shards[i];
+        __attribute__((objc_precise_lifetime)) id removedObject = nil;
+        pthread_rwlock_wrlock(&shard->lock);
+        NSMutableDictionary *dictionary = (__bridge NSMutableDictionary *)shard->dictionary;
+        for (id key in dictionary) {
+            if (object == dictionary[key]) {
+                removedObject = dictionary[key];
+                [dictionary removeObjectForKey:key];
                 break;
             }
         }
-    });
+        pthread_rwlock_unlock(&shard->lock);
+        if (removedObject) {
+            break;
+        }
+    }
 }
 
 @end
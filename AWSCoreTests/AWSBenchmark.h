@@ -0,0 +1,96 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Runs one operation of a benchmark and returns once it has finished, with whether it succeeded.
+ */
+typedef BOOL (^AWSBenchmarkOperationBlock)(NSUInteger index);
+
+/**
+ The measurements of one benchmark run. Durations are in seconds and sizes in bytes.
+ */
+@interface AWSBenchmarkResult : NSObject
+
+@property (nonatomic, readonly) NSString *name;
+@property (nonatomic, readonly) NSUInteger operationCount;
+@property (nonatomic, readonly) NSUInteger failureCount;
+@property (nonatomic, readonly) NSTimeInterval duration;
+@property (nonatomic, readonly) double operationsPerSecond;
+@property (nonatomic, readonly) NSTimeInterval medianLatency;
+@property (nonatomic, readonly) NSTimeInterval p99Latency;
+
+/**
+ The user and system CPU time of the whole process per operation. It includes the local mock server, which runs in the
+ same process.
+ */
+@property (nonatomic, readonly) NSTimeInterval cpuTimePerOperation;
+
+/**
+ How much the heap grew per operation, counted over every malloc zone once the autorelease pool of the last operation
+ is drained. Memory that was allocated and freed during the run is not counted, so this is what the operations retain,
+ such as caches and leaks, not how much they allocate.
+ */
+@property (nonatomic, readonly) double retainedBytesPerOperation;
+@property (nonatomic, readonly) double retainedBlocksPerOperation;
+
+/**
+ The measurements keyed as in a baseline file.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation;
+
+@end
+
+/**
+ Runs a benchmark and compares its result with the baseline checked in under `AWSCoreTests/BenchmarkBaselines`, in a
+ file named after the benchmark.
+
+ A measurement regresses when it is worse than its baseline by more than the file's `tolerance`, which defaults to 25%.
+ Measurements missing from the baseline are not compared. A baseline without any measurements, which is how they are
+ checked in, is filled in with the result of the first run. Set the `AWS_BENCHMARK_RECORD_BASELINES` environment
+ variable to write the measured values to the baseline files every run, and `AWS_BENCHMARK_BASELINE_DIRECTORY` to read
+ them from another directory, such as one copied onto a device.
+
+ Benchmarks only run when `AWS_RUN_BENCHMARKS` or `AWS_BENCHMARK_RECORD_BASELINES` is set, so that regular unit test
+ runs stay fast and are not failed by a slow machine.
+ */
+@interface AWSBenchmark : NSObject
+
+/**
+ Whether benchmarks should run. Benchmark test classes return an empty `defaultTestSuite` when they should not.
+ */
++ (BOOL)isEnabled;
+
+/**
+ Runs `warmUpCount` operations that are not measured, then `operationCount` that are, one after the other on the calling
+ thread. The result is logged and written as JSON to `AWSBenchmarkResults` in the temporary directory.
+ */
++ (AWSBenchmarkResult *)runBenchmarkNamed:(NSString *)name
+                              warmUpCount:(NSUInteger)warmUpCount
+                           operationCount:(NSUInteger)operationCount
+                                operation:(AWSBenchmarkOperationBlock)operation;
+
+/**
+ Returns a description of each measurement of `result` that regressed from its baseline, or records the result as the
+ baseline when recording is enabled or the baseline has no measurements yet.
+ */
++ (NSArray<NSString *> *)regressionsOfResult:(AWSBenchmarkResult *)result;
+
+@end
+
+NS_ASSUME_NONNULL_END
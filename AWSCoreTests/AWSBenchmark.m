@@ -0,0 +1,225 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSBenchmark.h"
+#import <malloc/malloc.h>
+#import <sys/resource.h>
+
+static NSString *const AWSBenchmarkToleranceKey = @"tolerance";
+static const double AWSBenchmarkDefaultTolerance = 0.25;
+
+static NSString *const AWSBenchmarkOperationsPerSecondKey = @"operationsPerSecond";
+static NSString *const AWSBenchmarkMedianLatencyKey = @"medianLatency";
+static NSString *const AWSBenchmarkP99LatencyKey = @"p99Latency";
+static NSString *const AWSBenchmarkCPUTimePerOperationKey = @"cpuTimePerOperation";
+static NSString *const AWSBenchmarkRetainedBytesPerOperationKey = @"retainedBytesPerOperation";
+static NSString *const AWSBenchmarkRetainedBlocksPerOperationKey = @"retainedBlocksPerOperation";
+
+static NSTimeInterval AWSBenchmarkUptime(void) {
+    return [NSProcessInfo processInfo].systemUptime;
+}
+
+static NSTimeInterval AWSBenchmarkCPUTime(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static malloc_statistics_t AWSBenchmarkHeapStatistics(void) {
+    malloc_statistics_t statistics = {0};
+    // A NULL zone sums the statistics of every zone.
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics;
+}
+
+static int AWSBenchmarkCompareLatencies(const void *a, const void *b) {
+    NSTimeInterval left = *(const NSTimeInterval *)a;
+    NSTimeInterval right = *(const NSTimeInterval *)b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+// The nearest-rank percentile of sorted latencies.
+static NSTimeInterval AWSBenchmarkPercentile(const NSTimeInterval *sortedLatencies, NSUInteger count, double percentile) {
+    if (count == 0) {
+        return 0;
+    }
+    NSUInteger rank = (NSUInteger)ceil(percentile / 100.0 * count);
+    return sortedLatencies[MIN(MAX(rank, 1), count) - 1];
+}
+
+@interface AWSBenchmarkResult()
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, assign) NSUInteger operationCount;
+@property (nonatomic, assign) NSUInteger failureCount;
+@property (nonatomic, assign) NSTimeInterval duration;
+@property (nonatomic, assign) NSTimeInterval medianLatency;
+@property (nonatomic, assign) NSTimeInterval p99Latency;
+@property (nonatomic, assign) NSTimeInterval cpuTimePerOperation;
+@property (nonatomic, assign) double retainedBytesPerOperation;
+@property (nonatomic, assign) double retainedBlocksPerOperation;
+
+@end
+
+@implementation AWSBenchmarkResult
+
+- (double)operationsPerSecond {
+    return self.duration > 0 ? self.operationCount / self.duration : 0;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)dictionaryRepresentation {
+    return @{AWSBenchmarkOperationsPerSecondKey : @(self.operationsPerSecond),
+             AWSBenchmarkMedianLatencyKey : @(self.medianLatency),
+             AWSBenchmarkP99LatencyKey : @(self.p99Latency),
+             AWSBenchmarkCPUTimePerOperationKey : @(self.cpuTimePerOperation),
+             AWSBenchmarkRetainedBytesPerOperationKey : @(self.retainedBytesPerOperation),
+             AWSBenchmarkRetainedBlocksPerOperationKey : @(self.retainedBlocksPerOperation)};
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%@: %lu operations (%lu failed), %.1f ops/sec, p50 %.2f ms, p99 %.2f ms, CPU %.2f ms/op, retained %+.0f bytes (%+.1f blocks)/op",
+            self.name,
+            (unsigned long)self.operationCount,
+            (unsigned long)self.failureCount,
+            self.operationsPerSecond,
+            self.medianLatency * 1000,
+            self.p99Latency * 1000,
+            self.cpuTimePerOperation * 1000,
+            self.retainedBytesPerOperation,
+            self.retainedBlocksPerOperation];
+}
+
+@end
+
+@implementation AWSBenchmark
+
++ (BOOL)isEnabled {
+    NSDictionary<NSString *, NSString *> *environment = [NSProcessInfo processInfo].environment;
+    return environment[@"AWS_RUN_BENCHMARKS"] != nil || environment[@"AWS_BENCHMARK_RECORD_BASELINES"] != nil;
+}
+
++ (AWSBenchmarkResult *)runBenchmarkNamed:(NSString *)name
+                              warmUpCount:(NSUInteger)warmUpCount
+                           operationCount:(NSUInteger)operationCount
+                                operation:(AWSBenchmarkOperationBlock)operation {
+    for (NSUInteger i = 0; i < warmUpCount; i++) {
+        @autoreleasepool {
+            operation(i);
+        }
+    }
+
+    NSTimeInterval *latencies = calloc(MAX(operationCount, 1), sizeof(NSTimeInterval));
+    NSUInteger failureCount = 0;
+    malloc_statistics_t heapBefore = AWSBenchmarkHeapStatistics();
+    NSTimeInterval cpuTimeBefore = AWSBenchmarkCPUTime();
+    NSTimeInterval startTime = AWSBenchmarkUptime();
+    for (NSUInteger i = 0; i < operationCount; i++) {
+        @autoreleasepool {
+            NSTimeInterval operationStartTime = AWSBenchmarkUptime();
+            if (!operation(warmUpCount + i)) {
+                failureCount++;
+            }
+            latencies[i] = AWSBenchmarkUptime() - operationStartTime;
+        }
+    }
+    NSTimeInterval duration = AWSBenchmarkUptime() - startTime;
+    NSTimeInterval cpuTime = AWSBenchmarkCPUTime() - cpuTimeBefore;
+    malloc_statistics_t heapAfter = AWSBenchmarkHeapStatistics();
+
+    qsort(latencies, operationCount, sizeof(NSTimeInterval), AWSBenchmarkCompareLatencies);
+    AWSBenchmarkResult *result = [AWSBenchmarkResult new];
+    result.name = name;
+    result.operationCount = operationCount;
+    result.failureCount = failureCount;
+    result.duration = duration;
+    result.medianLatency = AWSBenchmarkPercentile(latencies, operationCount, 50);
+    result.p99Latency = AWSBenchmarkPercentile(latencies, operationCount, 99);
+    free(latencies);
+    if (operationCount > 0) {
+        result.cpuTimePerOperation = cpuTime / operationCount;
+        result.retainedBytesPerOperation = ((double)heapAfter.size_in_use - (double)heapBefore.size_in_use) / operationCount;
+        result.retainedBlocksPerOperation = ((double)heapAfter.blocks_in_use - (double)heapBefore.blocks_in_use) / operationCount;
+    }
+
+    NSLog(@"%@", result);
+    [self writeResult:result];
+    return result;
+}
+
++ (void)writeResult:(AWSBenchmarkResult *)result {
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"AWSBenchmarkResults"];
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[result dictionaryRepresentation]
+                                                   options:NSJSONWritingPrettyPrinted
+                                                     error:nil];
+    [data writeToFile:[directory stringByAppendingPathComponent:[result.name stringByAppendingPathExtension:@"json"]]
+           atomically:YES];
+}
+
++ (NSString *)baselinePathForName:(NSString *)name {
+    NSString *directory = [NSProcessInfo processInfo].environment[@"AWS_BENCHMARK_BASELINE_DIRECTORY"];
+    if (!directory) {
+        // The baselines are read from the source tree, which the simulator can reach.
+        directory = [[@(__FILE__) stringByDeletingLastPathComponent] stringByAppendingPathComponent:@"BenchmarkBaselines"];
+    }
+    return [directory stringByAppendingPathComponent:[name stringByAppendingPathExtension:@"json"]];
+}
+
++ (NSArray<NSString *> *)regressionsOfResult:(AWSBenchmarkResult *)result {
+    NSString *path = [self baselinePathForName:result.name];
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    NSDictionary *baseline = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    if (![baseline isKindOfClass:[NSDictionary class]]) {
+        NSLog(@"%@: no baseline at %@", result.name, path);
+        baseline = @{};
+    }
+    NSNumber *tolerance = baseline[AWSBenchmarkToleranceKey] ?: @(AWSBenchmarkDefaultTolerance);
+
+    NSDictionary<NSString *, NSNumber *> *measured = [result dictionaryRepresentation];
+    BOOL hasMeasurements = NO;
+    for (NSString *key in measured) {
+        hasMeasurements = hasMeasurements || baseline[key] != nil;
+    }
+    if (!hasMeasurements || [NSProcessInfo processInfo].environment[@"AWS_BENCHMARK_RECORD_BASELINES"]) {
+        NSMutableDictionary *recorded = [measured mutableCopy];
+        recorded[AWSBenchmarkToleranceKey] = tolerance;
+        NSData *recordedData = [NSJSONSerialization dataWithJSONObject:recorded
+                                                               options:NSJSONWritingPrettyPrinted
+                                                                 error:nil];
+        if (![recordedData writeToFile:path atomically:YES]) {
+            return @[[NSString stringWithFormat:@"%@: could not record the baseline at %@", result.name, path]];
+        }
+        NSLog(@"%@: recorded the baseline at %@", result.name, path);
+        return @[];
+    }
+
+    NSMutableArray<NSString *> *regressions = [NSMutableArray new];
+    [measured enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSNumber *value, BOOL *stop) {
+        NSNumber *expected = baseline[key];
+        if (![expected isKindOfClass:[NSNumber class]] || [expected doubleValue] <= 0) {
+            return;
+        }
+        // Throughput should not drop; every other measurement should not grow.
+        BOOL regressed = [key isEqualToString:AWSBenchmarkOperationsPerSecondKey]
+        ? [value doubleValue] < [expected doubleValue] * (1 - [tolerance doubleValue])
+        : [value doubleValue] > [expected doubleValue] * (1 + [tolerance doubleValue]);
+        if (regressed) {
+            [regressions addObject:[NSString stringWithFormat:@"%@: %@ is %g, baseline %g", result.name, key, [value doubleValue], [expected doubleValue]]];
+        }
+    }];
+    return regressions;
+}
+
+@end
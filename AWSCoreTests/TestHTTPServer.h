@@ -0,0 +1,120 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A request received by `TestHTTPServer`. A chunked request body is decoded before the request is handled.
+ */
+@interface TestHTTPServerRequest : NSObject
+
+@property (nonatomic, readonly) NSString *method;
+
+/**
+ The path of the request target, without the query.
+ */
+@property (nonatomic, readonly) NSString *path;
+
+/**
+ The query of the request target, still percent-encoded, or `nil` if there is none.
+ */
+@property (nonatomic, readonly, nullable) NSString *query;
+
+/**
+ The request headers, with lowercase names.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, readonly) NSData *body;
+
+@end
+
+@interface TestHTTPServerResponse : NSObject
+
+@property (nonatomic, readonly) NSInteger statusCode;
+@property (nonatomic, readonly) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, readonly) NSData *body;
+
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode
+                               headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+                                  body:(nullable NSData *)body;
+
+@end
+
+/**
+ Returns the response to a request, or `nil` to fall back to the canned responses. Called on a background queue, once
+ per request, possibly for several connections at the same time.
+ */
+typedef TestHTTPServerResponse *_Nullable (^TestHTTPServerRequestHandler)(TestHTTPServerRequest *request);
+
+/**
+ A minimal HTTP/1.1 server on 127.0.0.1 that answers requests with scripted responses. Connections are kept open
+ unless a request asks for `Connection: close`. A request is passed to
+ `requestHandler` first; otherwise canned responses are used in the order they were added, and the last one is repeated
+ once the others are used up.
+ */
+@interface TestHTTPServer : NSObject
+
+/**
+ The base URL of the server, once it has started.
+ */
+@property (nonatomic, readonly, nullable) NSURL *URL;
+
+/**
+ How long each request waits before it is answered. Defaults to zero.
+ */
+@property (atomic, assign) NSTimeInterval responseDelay;
+
+/**
+ The number of requests answered so far.
+ */
+@property (atomic, readonly) NSUInteger requestCount;
+
+/**
+ The number of connections accepted so far.
+ */
+@property (atomic, readonly) NSUInteger connectionCount;
+
+/**
+ The largest number of connections that were open at the same time.
+ */
+@property (atomic, readonly) NSUInteger maximumConcurrentConnectionCount;
+
+/**
+ The largest number of requests that were being answered at the same time.
+ */
+@property (atomic, readonly) NSUInteger maximumConcurrentRequestCount;
+
+/**
+ Answers requests, such as the operations of a service, with responses built from the request.
+ */
+@property (atomic, copy, nullable) TestHTTPServerRequestHandler requestHandler;
+
+/**
+ Listens on an ephemeral port.
+
+ @return Whether the server could listen.
+ */
+- (BOOL)start;
+- (void)stop;
+
+- (void)addResponseWithStatusCode:(NSInteger)statusCode
+                          headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+                             body:(nullable NSData *)body;
+
+@end
+
+NS_ASSUME_NONNULL_END
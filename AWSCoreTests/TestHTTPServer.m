@@ -0,0 +1,323 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "TestHTTPServer.h"
+#import <arpa/inet.h>
+#import <netinet/in.h>
+#import <sys/socket.h>
+#import <unistd.h>
+
+@interface TestHTTPServerRequest()
+
+@property (nonatomic, strong) NSString *method;
+@property (nonatomic, strong) NSString *path;
+@property (nonatomic, strong) NSString *query;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, strong) NSData *body;
+
+@end
+
+@implementation TestHTTPServerRequest
+
+@end
+
+@interface TestHTTPServerResponse()
+
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, strong) NSData *body;
+
+@end
+
+@implementation TestHTTPServerResponse
+
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode
+                               headers:(NSDictionary<NSString *, NSString *> *)headers
+                                  body:(NSData *)body {
+    TestHTTPServerResponse *response = [self new];
+    response.statusCode = statusCode;
+    response.headers = headers ?: @{};
+    response.body = body ?: [NSData data];
+    return response;
+}
+
+@end
+
+@interface TestHTTPServer()
+
+@property (atomic, assign) NSUInteger requestCount;
+@property (atomic, assign) NSUInteger connectionCount;
+@property (atomic, assign) NSUInteger maximumConcurrentConnectionCount;
+@property (atomic, assign) NSUInteger maximumConcurrentRequestCount;
+
+@end
+
+@implementation TestHTTPServer {
+    int listeningSocket;
+    dispatch_source_t acceptSource;
+    NSMutableSet<NSNumber *> *connections;
+    NSMutableArray<TestHTTPServerResponse *> *responses;
+    NSUInteger concurrentRequestCount;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        listeningSocket = -1;
+        connections = [NSMutableSet new];
+        responses = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+- (BOOL)start {
+    listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listeningSocket < 0) {
+        return NO;
+    }
+
+    struct sockaddr_in address = {0};
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (bind(listeningSocket, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(listeningSocket, 64) != 0
+        || getsockname(listeningSocket, (struct sockaddr *)&address, &addressLength) != 0) {
+        close(listeningSocket);
+        listeningSocket = -1;
+        return NO;
+    }
+    _URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d", ntohs(address.sin_port)]];
+
+    int socketToAccept = listeningSocket;
+    __weak TestHTTPServer *weakSelf = self;
+    acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, socketToAccept, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    dispatch_source_set_event_handler(acceptSource, ^{
+        int connection = accept(socketToAccept, NULL, NULL);
+        if (connection < 0) {
+            return;
+        }
+        int noSigPipe = 1;
+        setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [weakSelf serveConnection:connection];
+        });
+    });
+    dispatch_source_set_cancel_handler(acceptSource, ^{
+        close(socketToAccept);
+    });
+    dispatch_resume(acceptSource);
+    return YES;
+}
+
+- (void)stop {
+    if (acceptSource) {
+        dispatch_source_cancel(acceptSource);
+        acceptSource = nil;
+        listeningSocket = -1;
+    }
+    @synchronized(connections) {
+        for (NSNumber *connection in connections) {
+            shutdown([connection intValue], SHUT_RDWR);
+        }
+    }
+}
+
+- (void)addResponseWithStatusCode:(NSInteger)statusCode
+                          headers:(NSDictionary<NSString *, NSString *> *)headers
+                             body:(NSData *)body {
+    TestHTTPServerResponse *response = [TestHTTPServerResponse responseWithStatusCode:statusCode
+                                                                               headers:headers
+                                                                                  body:body];
+    @synchronized(responses) {
+        [responses addObject:response];
+    }
+}
+
+- (TestHTTPServerResponse *)nextResponse {
+    @synchronized(responses) {
+        TestHTTPServerResponse *response = [responses firstObject];
+        if ([responses count] > 1) {
+            [responses removeObjectAtIndex:0];
+        }
+        return response;
+    }
+}
+
+// Answers the requests on one keep-alive connection until the client closes it, or asks for it to be closed.
+- (void)serveConnection:(int)connection {
+    @synchronized(connections) {
+        [connections addObject:@(connection)];
+        self.connectionCount++;
+        self.maximumConcurrentConnectionCount = MAX(self.maximumConcurrentConnectionCount, [connections count]);
+    }
+
+    NSMutableData *buffer = [NSMutableData new];
+    TestHTTPServerRequest *request;
+    while ((request = [self readRequestFrom:connection buffer:buffer])) {
+        @synchronized(self) {
+            concurrentRequestCount++;
+            self.maximumConcurrentRequestCount = MAX(self.maximumConcurrentRequestCount, concurrentRequestCount);
+        }
+        BOOL shouldClose = [[request.headers[@"connection"] lowercaseString] isEqualToString:@"close"];
+        if (self.responseDelay > 0) {
+            [NSThread sleepForTimeInterval:self.responseDelay];
+        }
+        TestHTTPServerRequestHandler requestHandler = self.requestHandler;
+        TestHTTPServerResponse *response = requestHandler ? requestHandler(request) : nil;
+        if (!response) {
+            response = [self nextResponse];
+        }
+        NSMutableString *responseHead = [NSMutableString stringWithFormat:@"HTTP/1.1 %ld %@\r\nContent-Length: %lu\r\n",
+                                         (long)response.statusCode,
+                                         [NSHTTPURLResponse localizedStringForStatusCode:response.statusCode],
+                                         (unsigned long)response.body.length];
+        [response.headers enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSString *value, BOOL *stop) {
+            [responseHead appendFormat:@"%@: %@\r\n", name, value];
+        }];
+        if (shouldClose) {
+            [responseHead appendString:@"Connection: close\r\n"];
+        }
+        [responseHead appendString:@"\r\n"];
+        NSMutableData *responseData = [[responseHead dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+        [responseData appendData:response.body];
+        @synchronized(self) {
+            self.requestCount++;
+            concurrentRequestCount--;
+        }
+        if (![self write:responseData to:connection] || shouldClose) {
+            break;
+        }
+    }
+
+    @synchronized(connections) {
+        [connections removeObject:@(connection)];
+    }
+    close(connection);
+}
+
+// Reads the next request, leaving any bytes after it in the buffer. Returns nil once the connection is closed.
+- (TestHTTPServerRequest *)readRequestFrom:(int)connection buffer:(NSMutableData *)buffer {
+    NSData *headerTerminator = [@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSRange headerEnd;
+    while ((headerEnd = [buffer rangeOfData:headerTerminator options:0 range:NSMakeRange(0, buffer.length)]).location == NSNotFound) {
+        if (![self read:connection into:buffer]) {
+            return nil;
+        }
+    }
+
+    NSString *head = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headerEnd.location)]
+                                           encoding:NSUTF8StringEncoding];
+    [buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(headerEnd)) withBytes:NULL length:0];
+    NSArray<NSString *> *lines = [head componentsSeparatedByString:@"\r\n"];
+    NSArray<NSString *> *requestLine = [[lines firstObject] componentsSeparatedByString:@" "];
+    if ([requestLine count] < 2) {
+        return nil;
+    }
+
+    TestHTTPServerRequest *request = [TestHTTPServerRequest new];
+    request.method = requestLine[0];
+    NSRange querySeparator = [requestLine[1] rangeOfString:@"?"];
+    if (querySeparator.location == NSNotFound) {
+        request.path = requestLine[1];
+    } else {
+        request.path = [requestLine[1] substringToIndex:querySeparator.location];
+        request.query = [requestLine[1] substringFromIndex:NSMaxRange(querySeparator)];
+    }
+    NSMutableDictionary<NSString *, NSString *> *headers = [NSMutableDictionary new];
+    for (NSString *line in [lines subarrayWithRange:NSMakeRange(1, [lines count] - 1)]) {
+        NSRange separator = [line rangeOfString:@":"];
+        if (separator.location != NSNotFound) {
+            NSString *name = [[line substringToIndex:separator.location] lowercaseString];
+            headers[name] = [[line substringFromIndex:NSMaxRange(separator)] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        }
+    }
+    request.headers = headers;
+
+    if ([[headers[@"transfer-encoding"] lowercaseString] isEqualToString:@"chunked"]) {
+        request.body = [self readChunkedBodyFrom:connection buffer:buffer];
+    } else {
+        NSUInteger contentLength = (NSUInteger)[headers[@"content-length"] integerValue];
+        request.body = [self read:contentLength bytesFrom:connection buffer:buffer];
+    }
+    return request.body ? request : nil;
+}
+
+- (NSData *)readChunkedBodyFrom:(int)connection buffer:(NSMutableData *)buffer {
+    NSData *lineTerminator = [@"\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableData *body = [NSMutableData new];
+    while (YES) {
+        NSRange lineEnd;
+        while ((lineEnd = [buffer rangeOfData:lineTerminator options:0 range:NSMakeRange(0, buffer.length)]).location == NSNotFound) {
+            if (![self read:connection into:buffer]) {
+                return nil;
+            }
+        }
+        NSString *sizeLine = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, lineEnd.location)]
+                                                   encoding:NSUTF8StringEncoding];
+        [buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(lineEnd)) withBytes:NULL length:0];
+        NSUInteger chunkSize = strtoul([sizeLine UTF8String], NULL, 16);
+
+        // Every chunk, including the last empty one, is followed by a line break.
+        NSData *chunk = [self read:chunkSize + lineTerminator.length bytesFrom:connection buffer:buffer];
+        if (!chunk) {
+            return nil;
+        }
+        if (chunkSize == 0) {
+            return body;
+        }
+        [body appendBytes:chunk.bytes length:chunkSize];
+    }
+}
+
+- (NSData *)read:(NSUInteger)length bytesFrom:(int)connection buffer:(NSMutableData *)buffer {
+    while (buffer.length < length) {
+        if (![self read:connection into:buffer]) {
+            return nil;
+        }
+    }
+    NSData *data = [buffer subdataWithRange:NSMakeRange(0, length)];
+    [buffer replaceBytesInRange:NSMakeRange(0, length) withBytes:NULL length:0];
+    return data;
+}
+
+- (BOOL)read:(int)connection into:(NSMutableData *)buffer {
+    uint8_t bytes[16384];
+    ssize_t length = recv(connection, bytes, sizeof(bytes), 0);
+    if (length <= 0) {
+        return NO;
+    }
+    [buffer appendBytes:bytes length:length];
+    return YES;
+}
+
+- (BOOL)write:(NSData *)data to:(int)connection {
+    NSUInteger offset = 0;
+    while (offset < data.length) {
+        ssize_t written = send(connection, (const uint8_t *)data.bytes + offset, data.length - offset, 0);
+        if (written <= 0) {
+            return NO;
+        }
+        offset += written;
+    }
+    return YES;
+}
+
+@end
@@ -0,0 +1,211 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDDFileLoggerTestsBenchmarkLineCount = 20000;
+
+@interface AWSDDFileLoggerTests : XCTestCase
+
+@property (nonatomic, strong) NSString *logsDirectory;
+@property (nonatomic, strong) AWSDDLog *log;
+
+@end
+
+@implementation AWSDDFileLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    self.logsDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    self.log = [AWSDDLog new];
+}
+
+- (void)tearDown {
+    [self.log removeAllLoggers];
+    [[NSFileManager defaultManager] removeItemAtPath:self.logsDirectory error:nil];
+    [super tearDown];
+}
+
+- (AWSDDFileLogger *)addFileLogger {
+    AWSDDLogFileManagerDefault *logFileManager = [[AWSDDLogFileManagerDefault alloc] initWithLogsDirectory:self.logsDirectory];
+    AWSDDFileLogger *fileLogger = [[AWSDDFileLogger alloc] initWithLogFileManager:logFileManager];
+    fileLogger.maximumFileSize = 0;
+    fileLogger.rollingFrequency = 0;
+    [self.log addLogger:fileLogger withLevel:AWSDDLogLevelVerbose];
+    return fileLogger;
+}
+
+- (void)logLines:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; i++) {
+        AWSDDLogMessage *message = [[AWSDDLogMessage alloc] initWithMessage:[NSString stringWithFormat:@"line %lu", (unsigned long)i]
+                                                                      level:AWSDDLogLevelVerbose
+                                                                       flag:AWSDDLogFlagVerbose
+                                                                    context:0
+                                                                       file:@(__FILE__)
+                                                                   function:@(__PRETTY_FUNCTION__)
+                                                                       line:__LINE__
+                                                                        tag:nil
+                                                                    options:0
+                                                                  timestamp:nil];
+        [self.log log:YES message:message];
+    }
+}
+
+- (NSString *)contentsOfLogFile:(AWSDDFileLogger *)fileLogger {
+    NSString *filePath = fileLogger.logFileManager.sortedLogFilePaths.firstObject;
+    return [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+}
+
+- (void)assertContents:(NSString *)contents containLines:(NSUInteger)count {
+    NSArray<NSString *> *lines = [contents componentsSeparatedByString:@"\n"];
+    // The last element is the empty string after the final newline.
+    XCTAssertEqual(lines.count, count + 1);
+    for (NSUInteger i = 0; i < MIN(count, lines.count); i++) {
+        XCTAssertTrue([lines[i] hasSuffix:[NSString stringWithFormat:@"  line %lu", (unsigned long)i]], @"%@", lines[i]);
+    }
+}
+
+- (void)testBufferedLinesAreWrittenOnFlush {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    fileLogger.maximumBufferSize = 1024 * 1024;
+    fileLogger.bufferFlushInterval = 3600;
+
+    [self logLines:100];
+    [self.log flushLog];
+
+    [self assertContents:[self contentsOfLogFile:fileLogger] containLines:100];
+}
+
+- (void)testBufferIsWrittenOnceItIsFull {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    fileLogger.maximumBufferSize = 256;
+    fileLogger.bufferFlushInterval = 3600;
+
+    [self logLines:100];
+    // Wait for the lines to reach the logger without flushing it.
+    dispatch_sync([AWSDDLog loggingQueue], ^{});
+    dispatch_sync(fileLogger.loggerQueue, ^{});
+
+    NSString *contents = [self contentsOfLogFile:fileLogger];
+    XCTAssertGreaterThan(contents.length, 0);
+    XCTAssertLessThan([contents componentsSeparatedByString:@"\n"].count, 101);
+}
+
+- (void)testBufferIsWrittenAfterTheFlushInterval {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    fileLogger.maximumBufferSize = 1024 * 1024;
+    fileLogger.bufferFlushInterval = 0.1;
+
+    [self logLines:10];
+
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+    while ([self contentsOfLogFile:fileLogger].length == 0 && [deadline timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.05];
+    }
+    [self assertContents:[self contentsOfLogFile:fileLogger] containLines:10];
+}
+
+- (void)testBufferIsWrittenBeforeRolling {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    fileLogger.maximumBufferSize = 1024 * 1024;
+    fileLogger.bufferFlushInterval = 3600;
+
+    [self logLines:50];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Rolled"];
+    [fileLogger rollLogFileWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    AWSDDLogFileInfo *archived = fileLogger.logFileManager.sortedLogFileInfos.firstObject;
+    XCTAssertTrue(archived.isArchived);
+    NSString *contents = [NSString stringWithContentsOfFile:archived.filePath encoding:NSUTF8StringEncoding error:nil];
+    [self assertContents:contents containLines:50];
+}
+
+- (void)testMemoryMappedAppendsAreTrimmedWhenRolled {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    fileLogger.usesMemoryMappedAppends = YES;
+
+    // Enough to cross more than one mapping window.
+    [self logLines:100000];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Rolled"];
+    [fileLogger rollLogFileWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:30 handler:nil];
+
+    AWSDDLogFileInfo *archived = fileLogger.logFileManager.sortedLogFileInfos.firstObject;
+    NSString *contents = [NSString stringWithContentsOfFile:archived.filePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertEqual(archived.fileSize, [contents lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertFalse([contents containsString:@"\0"]);
+    [self assertContents:contents containLines:100000];
+}
+
+- (void)testPaddingLeftByAKilledProcessIsTrimmedWhenResumed {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    [self logLines:10];
+    [self.log flushLog];
+    [self.log removeAllLoggers];
+
+    // What a mapped window looks like when the process is killed before the file is trimmed.
+    NSString *filePath = fileLogger.logFileManager.sortedLogFilePaths.firstObject;
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:filePath];
+    [fileHandle seekToEndOfFile];
+    [fileHandle writeData:[NSMutableData dataWithLength:1024 * 1024]];
+    [fileHandle closeFile];
+
+    AWSDDFileLogger *resumedFileLogger = [self addFileLogger];
+    resumedFileLogger.maximumFileSize = 1024 * 1024;
+    resumedFileLogger.usesMemoryMappedAppends = YES;
+    [self logLines:10];
+    [self.log flushLog];
+    [self.log removeAllLoggers];
+
+    XCTAssertEqual(resumedFileLogger.logFileManager.sortedLogFilePaths.count, 1);
+    XCTAssertEqualObjects(resumedFileLogger.logFileManager.sortedLogFilePaths.firstObject, filePath);
+    NSString *contents = [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertFalse([contents containsString:@"\0"]);
+    XCTAssertEqual([contents componentsSeparatedByString:@"\n"].count, 21);
+}
+
+- (void)measureLinesPerSecondWithConfiguration:(void (^)(AWSDDFileLogger *fileLogger))configure {
+    AWSDDFileLogger *fileLogger = [self addFileLogger];
+    configure(fileLogger);
+    [self measureBlock:^{
+        [self logLines:AWSDDFileLoggerTestsBenchmarkLineCount];
+        [self.log flushLog];
+    }];
+}
+
+- (void)testPerformanceUnbufferedWrites {
+    [self measureLinesPerSecondWithConfiguration:^(AWSDDFileLogger *fileLogger) {
+    }];
+}
+
+- (void)testPerformanceBufferedWrites {
+    [self measureLinesPerSecondWithConfiguration:^(AWSDDFileLogger *fileLogger) {
+        fileLogger.maximumBufferSize = 64 * 1024;
+    }];
+}
+
+- (void)testPerformanceMemoryMappedAppends {
+    [self measureLinesPerSecondWithConfiguration:^(AWSDDFileLogger *fileLogger) {
+        fileLogger.usesMemoryMappedAppends = YES;
+    }];
+}
+
+@end
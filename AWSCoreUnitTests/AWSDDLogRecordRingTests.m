@@ -0,0 +1,198 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDDLogRecordRingTestsBenchmarkThreadCount = 4;
+static const NSUInteger AWSDDLogRecordRingTestsBenchmarkLinesPerThread = 5000;
+
+@interface AWSDDLogRecordRingTestsLogger : AWSDDAbstractLogger
+
+@property (nonatomic, strong) NSMutableArray<AWSDDLogMessage *> *messages;
+@property (nonatomic, assign) BOOL keepsMessages;
+
+@end
+
+@implementation AWSDDLogRecordRingTestsLogger
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _messages = [NSMutableArray new];
+        _keepsMessages = YES;
+    }
+    return self;
+}
+
+- (void)logMessage:(AWSDDLogMessage *)logMessage {
+    if (self.keepsMessages) {
+        [self.messages addObject:logMessage];
+    }
+}
+
+@end
+
+@interface AWSDDLogRecordRingTests : XCTestCase
+
+@property (nonatomic, strong) AWSDDLog *log;
+@property (nonatomic, strong) AWSDDLogRecordRingTestsLogger *logger;
+
+@end
+
+@implementation AWSDDLogRecordRingTests
+
+- (void)setUp {
+    [super setUp];
+    self.log = [AWSDDLog new];
+    self.log.logLevel = AWSDDLogLevelVerbose;
+    self.logger = [AWSDDLogRecordRingTestsLogger new];
+    [self.log addLogger:self.logger withLevel:AWSDDLogLevelVerbose];
+}
+
+- (void)tearDown {
+    [self.log removeAllLoggers];
+    [super tearDown];
+}
+
+- (void)testRecordsArriveInOrderWithTheirMetadata {
+    AWSDDLogRecordRing *ring = [[AWSDDLogRecordRing alloc] initWithCapacity:1000 log:self.log];
+    XCTAssertEqual(ring.capacity, 1024);
+
+    NSUInteger line = __LINE__;
+    for (int i = 0; i < 500; i++) {
+        XCTAssertTrue(AWSDDLogRecordWrite(ring, AWSDDLogLevelVerbose, AWSDDLogFlagInfo, 7,
+                                          __FILE__, __PRETTY_FUNCTION__, line, "record %d of %s", i, "many"));
+    }
+    [ring flush];
+
+    XCTAssertEqual(self.logger.messages.count, 500);
+    for (NSUInteger i = 0; i < self.logger.messages.count; i++) {
+        AWSDDLogMessage *message = self.logger.messages[i];
+        XCTAssertEqualObjects(message.message, ([NSString stringWithFormat:@"record %lu of many", (unsigned long)i]));
+        XCTAssertEqual(message.flag, AWSDDLogFlagInfo);
+        XCTAssertEqual(message.context, 7);
+        XCTAssertEqual(message.line, line);
+        XCTAssertEqualObjects(message.file, @(__FILE__));
+        XCTAssertEqualObjects(message.fileName, @"AWSDDLogRecordRingTests");
+        XCTAssertEqualObjects(message.function, @(__PRETTY_FUNCTION__));
+        XCTAssertGreaterThan(message.threadID.length, 0);
+        XCTAssertEqualObjects(message.queueLabel, @"com.apple.main-thread");
+    }
+    XCTAssertEqual(ring.droppedRecordCount, 0);
+}
+
+- (void)testLongMessagesAreTruncatedOnACharacterBoundary {
+    AWSDDLogRecordRing *ring = [[AWSDDLogRecordRing alloc] initWithCapacity:4 log:self.log];
+    NSString *longText = [@"" stringByPaddingToLength:AWSDDLogRecordMessageCapacity * 2 withString:@"é" startingAtIndex:0];
+    AWSDDLogRecordWrite(ring, AWSDDLogLevelVerbose, AWSDDLogFlagInfo, 0, __FILE__, __PRETTY_FUNCTION__, __LINE__,
+                        "%s", longText.UTF8String);
+    [ring flush];
+
+    NSString *message = self.logger.messages.firstObject.message;
+    XCTAssertTrue([message hasPrefix:@"éé"]);
+    XCTAssertLessThan([message lengthOfBytesUsingEncoding:NSUTF8StringEncoding], AWSDDLogRecordMessageCapacity);
+}
+
+- (void)testOverflowIsCountedWithoutBlocking {
+    AWSDDLogRecordRing *ring = [[AWSDDLogRecordRing alloc] initWithCapacity:16 log:self.log];
+    // Hold up the logging queue. Once AWSDDLog has as many messages queued as it allows, the drain waits too and the
+    // ring fills.
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    dispatch_async([AWSDDLog loggingQueue], ^{
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+
+    NSUInteger written = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (AWSDDLogRecordWrite(ring, AWSDDLogLevelVerbose, AWSDDLogFlagInfo, 0, __FILE__, __PRETTY_FUNCTION__, __LINE__, "%d", i)) {
+            written++;
+        }
+    }
+    dispatch_semaphore_signal(semaphore);
+    [ring flush];
+
+    XCTAssertGreaterThan(ring.droppedRecordCount, 0);
+    XCTAssertEqual(written + ring.droppedRecordCount, 10000);
+    AWSDDLogMessage *warning = self.logger.messages.lastObject;
+    XCTAssertEqual(warning.flag, AWSDDLogFlagWarning);
+    XCTAssertTrue([warning.message containsString:@"Dropped"]);
+}
+
+- (void)testConcurrentWritersLoseNothingWhileThereIsRoom {
+    AWSDDLogRecordRing *ring = [[AWSDDLogRecordRing alloc] initWithCapacity:1 << 15 log:self.log];
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t writer) {
+        for (int i = 0; i < 1000; i++) {
+            AWSDDLogRecordWrite(ring, AWSDDLogLevelVerbose, AWSDDLogFlagInfo, 0, __FILE__, __PRETTY_FUNCTION__, __LINE__,
+                                "%zu %d", writer, i);
+        }
+    });
+    [ring flush];
+
+    XCTAssertEqual(ring.droppedRecordCount, 0);
+    XCTAssertEqual(self.logger.messages.count, 8000);
+    NSMutableSet<NSString *> *messages = [NSMutableSet new];
+    for (AWSDDLogMessage *message in self.logger.messages) {
+        [messages addObject:message.message];
+    }
+    XCTAssertEqual(messages.count, 8000);
+}
+
+#pragma mark - Caller-side latency
+
+// Only the time spent in the logging calls is measured; the backlog is drained afterwards.
+- (void)measureCallerLatencyWithBlock:(void (^)(NSUInteger thread, NSUInteger line))logLine flush:(void (^)(void))flush {
+    self.logger.keepsMessages = NO;
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self startMeasuring];
+        dispatch_apply(AWSDDLogRecordRingTestsBenchmarkThreadCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger line = 0; line < AWSDDLogRecordRingTestsBenchmarkLinesPerThread; line++) {
+                logLine(thread, line);
+            }
+        });
+        [self stopMeasuring];
+        flush();
+    }];
+}
+
+- (void)testPerformanceCallerLatencyLogMessages {
+    AWSDDLog *log = self.log;
+    [self measureCallerLatencyWithBlock:^(NSUInteger thread, NSUInteger line) {
+        [log log:YES
+           level:AWSDDLogLevelVerbose
+            flag:AWSDDLogFlagInfo
+         context:0
+            file:__FILE__
+        function:__PRETTY_FUNCTION__
+            line:__LINE__
+             tag:nil
+          format:@"thread %lu line %lu", (unsigned long)thread, (unsigned long)line];
+    } flush:^{
+        [log flushLog];
+    }];
+}
+
+- (void)testPerformanceCallerLatencyLogRecords {
+    AWSDDLogRecordRing *ring = [[AWSDDLogRecordRing alloc] initWithCapacity:AWSDDLogRecordRingTestsBenchmarkThreadCount * AWSDDLogRecordRingTestsBenchmarkLinesPerThread
+                                                                        log:self.log];
+    [self measureCallerLatencyWithBlock:^(NSUInteger thread, NSUInteger line) {
+        AWSDDLogRecordWrite(ring, AWSDDLogLevelVerbose, AWSDDLogFlagInfo, 0, __FILE__, __PRETTY_FUNCTION__, __LINE__,
+                            "thread %lu line %lu", (unsigned long)thread, (unsigned long)line);
+    } flush:^{
+        [ring flush];
+    }];
+    XCTAssertEqual(ring.droppedRecordCount, 0);
+}
+
+@end
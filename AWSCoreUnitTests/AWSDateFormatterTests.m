@@ -16,6 +16,8 @@
 #import <XCTest/XCTest.h>
 #import <AWSCore/AWSCore.h>
 
+static const NSUInteger AWSDateFormatterTestsBenchmarkDateCount = 10000;
+
 @interface AWSDateFormatterTests : XCTestCase
 
 @end
@@ -158,4 +160,142 @@
     XCTAssertEqual([components second], 01);
 }
 
+#pragma mark - Fixed formats
+
+- (NSDateFormatter *)referenceFormatterWithFormat:(NSString *)dateFormat {
+    NSDateFormatter *dateFormatter = [NSDateFormatter new];
+    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    dateFormatter.dateFormat = dateFormat;
+    return dateFormatter;
+}
+
+- (NSArray<NSDate *> *)sampleDates {
+    NSMutableArray<NSDate *> *dates = [NSMutableArray arrayWithObjects:
+                                       [NSDate dateWithTimeIntervalSince1970:0],
+                                       [NSDate dateWithTimeIntervalSince1970:-1],
+                                       [NSDate dateWithTimeIntervalSince1970:951782400], // 2000-02-29
+                                       [NSDate dateWithTimeIntervalSince1970:4107542399.999], // 2100-02-28T23:59:59.999
+                                       nil];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        // Between 1900 and 2100, with milliseconds.
+        double seconds = -2208988800.0 + arc4random_uniform(200 * 365) * 86400.0 + arc4random_uniform(86400000) / 1000.0;
+        [dates addObject:[NSDate dateWithTimeIntervalSince1970:seconds]];
+    }
+    return dates;
+}
+
+- (void)test_aws_stringValue_matchesNSDateFormatter {
+    NSArray<NSString *> *dateFormats = @[AWSDateRFC822DateFormat1,
+                                         AWSDateISO8601DateFormat1,
+                                         AWSDateISO8601DateFormat2,
+                                         AWSDateISO8601DateFormat3,
+                                         AWSDateShortDateFormat1,
+                                         AWSDateShortDateFormat2];
+    for (NSString *dateFormat in dateFormats) {
+        NSDateFormatter *referenceFormatter = [self referenceFormatterWithFormat:dateFormat];
+        // The reference formatter writes the UTC zone as "UTC" rather than "GMT".
+        referenceFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+        for (NSDate *date in [self sampleDates]) {
+            XCTAssertEqualObjects([date aws_stringValue:dateFormat], [referenceFormatter stringFromDate:date], @"%@", dateFormat);
+        }
+    }
+}
+
+- (void)test_aws_dateFromString_roundTripsFixedFormats {
+    for (NSDate *date in [self sampleDates]) {
+        NSTimeInterval milliseconds = floor([date timeIntervalSince1970] * 1000) / 1000;
+        NSTimeInterval seconds = floor([date timeIntervalSince1970]);
+        XCTAssertEqualWithAccuracy([[NSDate aws_dateFromString:[date aws_stringValue:AWSDateISO8601DateFormat3]] timeIntervalSince1970], milliseconds, 0.0001);
+        XCTAssertEqual([[NSDate aws_dateFromString:[date aws_stringValue:AWSDateISO8601DateFormat1]] timeIntervalSince1970], seconds);
+        XCTAssertEqual([[NSDate aws_dateFromString:[date aws_stringValue:AWSDateISO8601DateFormat2]] timeIntervalSince1970], seconds);
+        XCTAssertEqual([[NSDate aws_dateFromString:[date aws_stringValue:AWSDateRFC822DateFormat1]] timeIntervalSince1970], seconds);
+    }
+}
+
+- (void)testRFC822NumericOffsets {
+    NSDate *date = [NSDate aws_dateFromString:@"Wed, 02 Jan 2019 03:45:06 -0130" format:AWSDateRFC822DateFormat1];
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateISO8601DateFormat1], @"2019-01-02T05:15:06Z");
+}
+
+- (void)testParserRejectsInvalidDates {
+    NSTimeInterval timeInterval;
+    const char *invalidDates[] = {"2019-02-29T00:00:00Z", "2019-13-01T00:00:00Z", "2019-01-01T24:00:00Z",
+                                  "2019-01-01T00:00:00", "2019-01-01T00:00:00Zjunk", "19-01-01T00:00:00Z"};
+    for (size_t i = 0; i < sizeof(invalidDates) / sizeof(invalidDates[0]); i++) {
+        XCTAssertFalse(AWSDateFormatParse(AWSDateFormatISO8601, invalidDates[i], strlen(invalidDates[i]), &timeInterval), @"%s", invalidDates[i]);
+    }
+    XCTAssertTrue(AWSDateFormatParse(AWSDateFormatISO8601, "2020-02-29T00:00:00Z", 20, &timeInterval));
+}
+
+- (void)testUnixDateFormat {
+    NSDateFormatter *referenceFormatter = [self referenceFormatterWithFormat:@"EEE MMM d HH:mm:ss 'UTC' yyyy"];
+    char buffer[AWSDateFormatMaximumLength];
+    for (NSDate *date in [self sampleDates]) {
+        size_t length = AWSDateFormatWrite(AWSDateFormatUnixDate, [date timeIntervalSince1970], buffer, sizeof(buffer));
+        NSString *string = [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
+        XCTAssertEqualObjects(string, [referenceFormatter stringFromDate:date]);
+
+        NSTimeInterval timeInterval;
+        XCTAssertTrue(AWSDateFormatParse(AWSDateFormatUnixDate, buffer, length, &timeInterval));
+        XCTAssertEqual(timeInterval, floor([date timeIntervalSince1970]));
+    }
+}
+
+- (void)testWriteFailsWhenTheBufferIsTooSmall {
+    char buffer[20];
+    XCTAssertEqual(AWSDateFormatWrite(AWSDateFormatISO8601, 0, buffer, sizeof(buffer)), 0);
+    XCTAssertEqual(AWSDateFormatWrite(AWSDateFormatISO8601, 0, buffer, 21), 20);
+    XCTAssertEqual(strcmp(buffer, "1970-01-01T00:00:00Z"), 0);
+}
+
+#pragma mark - Performance
+
+- (void)testPerformanceFormattingWithNSDateFormatter {
+    NSDateFormatter *dateFormatter = [self referenceFormatterWithFormat:AWSDateISO8601DateFormat2];
+    NSDate *date = [NSDate date];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDateFormatterTestsBenchmarkDateCount; i++) {
+            @autoreleasepool {
+                [dateFormatter stringFromDate:[date dateByAddingTimeInterval:i]];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceFormattingWithAWSStringValue {
+    NSDate *date = [NSDate date];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDateFormatterTestsBenchmarkDateCount; i++) {
+            @autoreleasepool {
+                [[date dateByAddingTimeInterval:i] aws_stringValue:AWSDateISO8601DateFormat2];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceParsingWithNSDateFormatter {
+    NSDateFormatter *dateFormatter = [self referenceFormatterWithFormat:AWSDateRFC822DateFormat1];
+    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+    NSString *string = [[NSDate date] aws_stringValue:AWSDateRFC822DateFormat1];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDateFormatterTestsBenchmarkDateCount; i++) {
+            @autoreleasepool {
+                [dateFormatter dateFromString:string];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceParsingWithAWSDateFromString {
+    NSString *string = [[NSDate date] aws_stringValue:AWSDateRFC822DateFormat1];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDateFormatterTestsBenchmarkDateCount; i++) {
+            @autoreleasepool {
+                [NSDate aws_dateFromString:string];
+            }
+        }
+    }];
+}
+
 @end
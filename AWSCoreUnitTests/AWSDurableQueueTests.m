@@ -0,0 +1,312 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDurableQueueTestsRecordByteSize = 100;
+static const NSUInteger AWSDurableQueueTestsBenchmarkRecordCount = 2000;
+static const NSUInteger AWSDurableQueueTestsBenchmarkBatchSize = 100;
+
+@interface AWSDurableQueueTests : XCTestCase
+
+@property (nonatomic, strong) NSString *databasePath;
+
+@end
+
+@implementation AWSDurableQueueTests
+
+- (void)setUp {
+    [super setUp];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix] error:nil];
+    }
+    [super tearDown];
+}
+
+- (AWSDurableQueueRecord *)recordInChannel:(NSString *)channel tag:(NSString *)tag {
+    NSMutableData *data = [NSMutableData dataWithLength:AWSDurableQueueTestsRecordByteSize];
+    return [[AWSDurableQueueRecord alloc] initWithChannel:channel key:nil tag:tag data:data];
+}
+
+- (NSArray<AWSDurableQueueRecord *> *)recordsInChannel:(NSString *)channel count:(NSUInteger)count {
+    NSMutableArray *records = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [records addObject:[self recordInChannel:channel tag:nil]];
+    }
+    return records;
+}
+
+- (void)testRecordByteCountIncludesKeyAndTag {
+    AWSDurableQueueRecord *record = [[AWSDurableQueueRecord alloc] initWithChannel:@"stream"
+                                                                               key:@"key"
+                                                                               tag:@"é"
+                                                                              data:[NSMutableData dataWithLength:10]];
+    XCTAssertEqual(record.byteCount, 10 + 3 + 2);
+    XCTAssertEqual(record.identifier, 0);
+    XCTAssertEqual(record.retryCount, 0);
+}
+
+- (void)testAppendAndAcknowledge {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    NSError *error = nil;
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:3] error:&error]);
+    XCTAssertNil(error);
+    XCTAssertEqual(queue.recordCount, 3);
+    XCTAssertEqual(queue.byteCount, 3 * AWSDurableQueueTestsRecordByteSize);
+
+    NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:0 error:&error];
+    XCTAssertEqual(records.count, 3);
+    XCTAssertLessThan(records[0].identifier, records[1].identifier);
+    XCTAssertLessThan(records[1].identifier, records[2].identifier);
+
+    XCTAssertTrue([queue acknowledgeRecords:[records subarrayWithRange:NSMakeRange(0, 2)] error:&error]);
+    XCTAssertEqual(queue.recordCount, 1);
+    XCTAssertEqual(queue.byteCount, AWSDurableQueueTestsRecordByteSize);
+
+    // Acknowledging a record twice is harmless.
+    XCTAssertTrue([queue acknowledgeRecords:records error:&error]);
+    XCTAssertEqual(queue.recordCount, 0);
+    XCTAssertEqual(queue.byteCount, 0);
+}
+
+- (void)testAppendRecordTaskReturnsTheStoredRecord {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    AWSTask<AWSDurableQueueRecord *> *task = [queue appendRecord:[self recordInChannel:@"stream" tag:@"tag"]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertGreaterThan(task.result.identifier, 0);
+    XCTAssertEqualObjects(task.result.tag, @"tag");
+    XCTAssertEqual(queue.recordCount, 1);
+}
+
+- (void)testConcurrentAppendsAreCommittedTogether {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    AWSFMDatabaseQueueStatistics *statistics = queue.databaseQueue.aws_statistics;
+    [statistics reset];
+
+    NSUInteger count = 800;
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:count];
+    NSLock *lock = [NSLock new];
+    dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        AWSTask *task = [queue appendRecord:[self recordInChannel:@"stream" tag:nil]];
+        [lock lock];
+        [tasks addObject:task];
+        [lock unlock];
+    });
+    [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+
+    XCTAssertEqual(queue.recordCount, count);
+    XCTAssertEqual(queue.byteCount, count * AWSDurableQueueTestsRecordByteSize);
+    XCTAssertLessThan(statistics.operationCount, count);
+}
+
+- (void)testUnacknowledgedRecordsAreDeliveredAgain {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:5] error:nil]);
+
+    NSArray<AWSDurableQueueRecord *> *first = [queue oldestRecordsInChannel:nil limit:2 byteLimit:0 error:nil];
+    NSArray<AWSDurableQueueRecord *> *second = [queue oldestRecordsInChannel:nil limit:2 byteLimit:0 error:nil];
+    XCTAssertEqualObjects([first valueForKey:@"identifier"], [second valueForKey:@"identifier"]);
+
+    [queue.databaseQueue close];
+    AWSDurableQueue *reopened = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertEqual(reopened.recordCount, 5);
+    XCTAssertEqual(reopened.byteCount, 5 * AWSDurableQueueTestsRecordByteSize);
+    NSArray<AWSDurableQueueRecord *> *third = [reopened oldestRecordsInChannel:nil limit:2 byteLimit:0 error:nil];
+    XCTAssertEqualObjects([first valueForKey:@"identifier"], [third valueForKey:@"identifier"]);
+}
+
+- (void)testOldestRecordsRespectTheByteLimit {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:3] error:nil]);
+
+    XCTAssertEqual([queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:250 error:nil].count, 2);
+    // The oldest record is returned even when it is larger than the limit.
+    XCTAssertEqual([queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:50 error:nil].count, 1);
+}
+
+- (void)testOldestRecordsPickTheOldestChannel {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.deadLetterChannel = @"dead";
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"dead" count:1] error:nil]);
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"b" count:1] error:nil]);
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"a" count:2] error:nil]);
+
+    NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:nil limit:10 byteLimit:0 error:nil];
+    XCTAssertEqual(records.count, 1);
+    XCTAssertEqualObjects(records.firstObject.channel, @"b");
+}
+
+- (void)testRetriedRecordsMoveToTheDeadLetterChannel {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.maximumRetryCount = 2;
+    queue.deadLetterChannel = @"dead";
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:1] error:nil]);
+
+    for (NSUInteger i = 1; i <= 2; i++) {
+        NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:1 byteLimit:0 error:nil];
+        XCTAssertTrue([queue retryRecords:records error:nil]);
+        XCTAssertEqual([queue oldestRecordsInChannel:@"stream" limit:1 byteLimit:0 error:nil].firstObject.retryCount, i);
+    }
+    NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:1 byteLimit:0 error:nil];
+    XCTAssertTrue([queue retryRecords:records error:nil]);
+
+    XCTAssertEqual([queue oldestRecordsInChannel:@"stream" limit:1 byteLimit:0 error:nil].count, 0);
+    XCTAssertEqual([queue oldestRecordsInChannel:@"dead" limit:1 byteLimit:0 error:nil].count, 1);
+    XCTAssertEqual(queue.recordCount, 1);
+}
+
+- (void)testRetriedRecordsAreRemovedWithoutADeadLetterChannel {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.maximumRetryCount = 0;
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:2] error:nil]);
+
+    NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:1 byteLimit:0 error:nil];
+    XCTAssertTrue([queue retryRecords:records error:nil]);
+    XCTAssertEqual(queue.recordCount, 1);
+    XCTAssertEqual(queue.byteCount, AWSDurableQueueTestsRecordByteSize);
+}
+
+- (void)testByteLimitEvictsWholeOldestSegments {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.segmentByteSize = 10 * AWSDurableQueueTestsRecordByteSize;
+    queue.byteLimit = 50 * AWSDurableQueueTestsRecordByteSize;
+
+    for (NSUInteger i = 0; i < 100; i++) {
+        XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:1] error:nil]);
+        XCTAssertLessThanOrEqual(queue.byteCount, queue.byteLimit);
+    }
+    // Each eviction removes exactly one segment of ten records.
+    XCTAssertEqual(queue.recordCount % 10, 0);
+
+    NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:100 byteLimit:0 error:nil];
+    XCTAssertEqual(records.count, queue.recordCount);
+    XCTAssertEqual(records.lastObject.identifier - records.firstObject.identifier + 1, (int64_t)records.count);
+
+    [queue.databaseQueue close];
+    AWSDurableQueue *reopened = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertEqual(reopened.byteCount, queue.byteCount);
+}
+
+- (void)testByteLimitSmallerThanASegmentKeepsTheAppendedRecords {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.byteLimit = 3 * AWSDurableQueueTestsRecordByteSize;
+
+    for (NSUInteger i = 0; i < 10; i++) {
+        AWSDurableQueueRecord *record = [self recordInChannel:@"stream" tag:nil];
+        XCTAssertTrue([queue appendRecords:@[record] error:nil]);
+        XCTAssertLessThanOrEqual(queue.byteCount, queue.byteLimit);
+
+        NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:0 error:nil];
+        XCTAssertEqual(records.count, queue.recordCount);
+        XCTAssertEqual(records.lastObject.identifier, record.identifier);
+    }
+}
+
+- (void)testByteLimitEvictsTheDeadLetterChannelFirst {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.deadLetterChannel = @"dead";
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"dead" count:2] error:nil]);
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:2] error:nil]);
+
+    queue.byteLimit = 4 * AWSDurableQueueTestsRecordByteSize;
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:1] error:nil]);
+
+    XCTAssertEqual([queue oldestRecordsInChannel:@"dead" limit:10 byteLimit:0 error:nil].count, 0);
+    XCTAssertEqual([queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:0 error:nil].count, 3);
+}
+
+- (void)testAgeLimitRemovesOldRecords {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    queue.ageLimit = 60;
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    AWSDurableQueueRecord *old = [[AWSDurableQueueRecord alloc] initWithChannel:@"stream"
+                                                                            key:nil
+                                                                            tag:nil
+                                                                           data:[NSMutableData dataWithLength:10]
+                                                                      timestamp:now - 120
+                                                                     retryCount:0];
+    XCTAssertTrue([queue appendRecords:@[old] error:nil]);
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"stream" count:1] error:nil]);
+
+    XCTAssertEqual(queue.recordCount, 1);
+    XCTAssertEqual(queue.byteCount, AWSDurableQueueTestsRecordByteSize);
+}
+
+- (void)testUpdateRecordsByTag {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertTrue([queue appendRecords:@[[self recordInChannel:@"stream" tag:@"start"],
+                                         [self recordInChannel:@"stream" tag:@"stop"]] error:nil]);
+
+    NSData *updated = [@"updated" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertTrue([queue updateRecordsInChannel:@"stream" tag:@"start" usingBlock:^NSData *(AWSDurableQueueRecord *record) {
+        return updated;
+    } error:nil]);
+
+    NSArray<AWSDurableQueueRecord *> *records = [queue recordsInChannel:@"stream" tag:@"start" error:nil];
+    XCTAssertEqual(records.count, 1);
+    XCTAssertEqualObjects(records.firstObject.data, updated);
+    // "updated" and "start", plus the untouched record and its "stop" tag.
+    XCTAssertEqual(queue.byteCount, (7 + 5) + (AWSDurableQueueTestsRecordByteSize + 4));
+}
+
+- (void)testRemoveRecordsInChannel {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"a" count:2] error:nil]);
+    XCTAssertTrue([queue appendRecords:[self recordsInChannel:@"b" count:1] error:nil]);
+
+    XCTAssertTrue([queue removeRecordsInChannel:@"a" error:nil]);
+    XCTAssertEqual(queue.recordCount, 1);
+    XCTAssertTrue([queue removeRecordsInChannel:nil error:nil]);
+    XCTAssertEqual(queue.recordCount, 0);
+    XCTAssertEqual(queue.byteCount, 0);
+}
+
+#pragma mark - Performance
+
+- (void)testPerformanceEnqueue {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    [self measureBlock:^{
+        NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:AWSDurableQueueTestsBenchmarkRecordCount];
+        for (NSUInteger i = 0; i < AWSDurableQueueTestsBenchmarkRecordCount; i++) {
+            [tasks addObject:[queue appendRecord:[self recordInChannel:@"stream" tag:nil]]];
+        }
+        [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    }];
+}
+
+- (void)testPerformanceDequeue {
+    AWSDurableQueue *queue = [[AWSDurableQueue alloc] initWithPath:self.databasePath];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [queue appendRecords:[self recordsInChannel:@"stream" count:AWSDurableQueueTestsBenchmarkRecordCount] error:nil];
+
+        [self startMeasuring];
+        NSArray<AWSDurableQueueRecord *> *records = nil;
+        while ((records = [queue oldestRecordsInChannel:nil
+                                                  limit:AWSDurableQueueTestsBenchmarkBatchSize
+                                              byteLimit:0
+                                                  error:nil]).count > 0) {
+            [queue acknowledgeRecords:records error:nil];
+        }
+        [self stopMeasuring];
+    }];
+}
+
+@end
@@ -0,0 +1,175 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <sqlite3.h>
+#import <AWSCore/AWSCore.h>
+#import <AWSCore/AWSFMDB.h>
+
+static const NSUInteger AWSFMDatabaseQueueHelpersTestsInsertCount = 500;
+static const NSUInteger AWSFMDatabaseQueueHelpersTestsSelectCount = 5000;
+
+@interface AWSFMDatabaseQueueHelpersTests : XCTestCase
+
+@property (nonatomic, strong) NSString *databasePath;
+
+@end
+
+@implementation AWSFMDatabaseQueueHelpersTests
+
+- (void)setUp {
+    [super setUp];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix] error:nil];
+    }
+    [super tearDown];
+}
+
+- (NSString *)stringForPragma:(NSString *)pragma inQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    __block NSString *value = nil;
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:@"PRAGMA %@", pragma]];
+        if ([rs next]) {
+            value = [rs stringForColumnIndex:0];
+        }
+        [rs close];
+    }];
+    return value;
+}
+
+- (void)testSerialQueueAppliesTheDefaultConfiguration {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+
+    XCTAssertTrue(databaseQueue.openFlags & SQLITE_OPEN_NOMUTEX);
+    XCTAssertFalse(databaseQueue.openFlags & SQLITE_OPEN_FULLMUTEX);
+    XCTAssertEqualObjects([[self stringForPragma:@"journal_mode" inQueue:databaseQueue] lowercaseString], @"wal");
+    XCTAssertEqualObjects([self stringForPragma:@"synchronous" inQueue:databaseQueue], @"1");
+    XCTAssertEqualObjects([self stringForPragma:@"wal_autocheckpoint" inQueue:databaseQueue], @"1000");
+    XCTAssertEqualObjects([self stringForPragma:@"journal_size_limit" inQueue:databaseQueue], @"1048576");
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue(db.shouldCacheStatements);
+        XCTAssertEqual(db.maxBusyRetryTimeInterval, 2);
+    }];
+}
+
+- (void)testConfigurationIsAppliedAgainAfterClose {
+    AWSFMDatabaseStorageConfiguration *configuration = [AWSFMDatabaseStorageConfiguration defaultConfiguration];
+    configuration.synchronous = @"FULL";
+    configuration.shouldCacheStatements = NO;
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath
+                                                                          configuration:configuration];
+    // Changing the configuration afterwards does not affect the queue.
+    configuration.synchronous = @"OFF";
+
+    XCTAssertEqualObjects([self stringForPragma:@"synchronous" inQueue:databaseQueue], @"2");
+    [databaseQueue close];
+    XCTAssertEqualObjects([self stringForPragma:@"synchronous" inQueue:databaseQueue], @"2");
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertFalse(db.shouldCacheStatements);
+    }];
+}
+
+- (void)testStatisticsCountEveryKindOfBlock {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+    AWSFMDatabaseQueueStatistics *statistics = databaseQueue.aws_statistics;
+    XCTAssertNotNil(statistics);
+    XCTAssertEqual(statistics.operationCount, 0);
+
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:@"CREATE TABLE item (id INTEGER PRIMARY KEY, value TEXT)"]);
+    }];
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO item (value) VALUES (?)", @"a"]);
+    }];
+    [databaseQueue inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO item (value) VALUES (?)", @"b"]);
+    }];
+    [databaseQueue inSavePoint:^(AWSFMDatabase *db, BOOL *rollback) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO item (value) VALUES (?)", @"c"]);
+    }];
+
+    XCTAssertEqual(statistics.operationCount, 4);
+    XCTAssertGreaterThan(statistics.totalDuration, 0);
+    XCTAssertGreaterThanOrEqual(statistics.maximumDuration, statistics.averageDuration);
+    XCTAssertEqualWithAccuracy(statistics.averageDuration, statistics.totalDuration / 4, 1e-9);
+
+    [statistics reset];
+    XCTAssertEqual(statistics.operationCount, 0);
+    XCTAssertEqual(statistics.totalDuration, 0);
+    XCTAssertEqual(statistics.maximumDuration, 0);
+    XCTAssertEqual(statistics.totalWaitDuration, 0);
+
+    XCTAssertNil([AWSFMDatabaseQueue databaseQueueWithPath:self.databasePath].aws_statistics);
+}
+
+#pragma mark - Performance
+
+- (void)createItemTableInQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [db executeUpdate:@"CREATE TABLE IF NOT EXISTS item (id INTEGER PRIMARY KEY, value TEXT NOT NULL)"];
+    }];
+}
+
+// Each insert commits on its own, the way the recorders save one record at a time.
+- (void)measureInsertsInQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    [self createItemTableInQueue:databaseQueue];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSFMDatabaseQueueHelpersTestsInsertCount; i++) {
+            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                [db executeUpdate:@"INSERT INTO item (value) VALUES (?)", [NSUUID UUID].UUIDString];
+            }];
+        }
+    }];
+}
+
+- (void)measureSelectsInQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    [self createItemTableInQueue:databaseQueue];
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (NSUInteger i = 0; i < 1000; i++) {
+            [db executeUpdate:@"INSERT INTO item (id, value) VALUES (?, ?)", @(i), [NSUUID UUID].UUIDString];
+        }
+    }];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSFMDatabaseQueueHelpersTestsSelectCount; i++) {
+            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                AWSFMResultSet *rs = [db executeQuery:@"SELECT value FROM item WHERE id = ?", @(i % 1000)];
+                [rs next];
+                [rs close];
+            }];
+        }
+    }];
+}
+
+- (void)testPerformanceInsertsWithDefaultDatabaseQueue {
+    [self measureInsertsInQueue:[AWSFMDatabaseQueue databaseQueueWithPath:self.databasePath]];
+}
+
+- (void)testPerformanceInsertsWithSerialDatabaseQueue {
+    [self measureInsertsInQueue:[AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath]];
+}
+
+- (void)testPerformanceSelectsWithDefaultDatabaseQueue {
+    [self measureSelectsInQueue:[AWSFMDatabaseQueue databaseQueueWithPath:self.databasePath]];
+}
+
+- (void)testPerformanceSelectsWithSerialDatabaseQueue {
+    [self measureSelectsInQueue:[AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath]];
+}
+
+@end
@@ -0,0 +1,204 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "TestHTTPServer.h"
+
+static NSString *const AWSNetworkingMetricsTestsCallerIdentity = @"<GetCallerIdentityResponse xmlns=\"https://sts.amazonaws.com/doc/2011-06-15/\">"
+"<GetCallerIdentityResult><Arn>arn:aws:iam::123456789012:user/test</Arn><UserId>AIDAEXAMPLE</UserId><Account>123456789012</Account></GetCallerIdentityResult>"
+"<ResponseMetadata><RequestId>01234567-89ab-cdef-0123-456789abcdef</RequestId></ResponseMetadata>"
+"</GetCallerIdentityResponse>";
+
+static NSString *const AWSNetworkingMetricsTestsInternalFailure = @"<ErrorResponse xmlns=\"https://sts.amazonaws.com/doc/2011-06-15/\">"
+"<Error><Type>Receiver</Type><Code>InternalFailure</Code><Message>Internal failure</Message></Error>"
+"<RequestId>01234567-89ab-cdef-0123-456789abcdef</RequestId>"
+"</ErrorResponse>";
+
+@interface AWSNetworkingMetricsTestExporter : NSObject <AWSNetworkingMetricsExporter>
+
+@property (nonatomic, strong) NSMutableArray<AWSNetworkingOperationMetrics *> *exportedMetrics;
+@property (nonatomic, strong) XCTestExpectation *expectation;
+
+@end
+
+@implementation AWSNetworkingMetricsTestExporter
+
+- (void)metricsCollector:(AWSNetworkingMetricsCollector *)collector didRecordOperationMetrics:(AWSNetworkingOperationMetrics *)metrics {
+    [self.exportedMetrics addObject:metrics];
+    [self.expectation fulfill];
+}
+
+@end
+
+@interface AWSNetworkingMetricsTests : XCTestCase
+
+@property (nonatomic, strong) TestHTTPServer *server;
+@property (nonatomic, strong) AWSNetworkingMetricsCollector *collector;
+@property (nonatomic, strong) AWSSTS *sts;
+
+@end
+
+@implementation AWSNetworkingMetricsTests
+
+- (void)setUp {
+    [super setUp];
+    self.server = [TestHTTPServer new];
+    XCTAssertTrue([self.server start]);
+    self.collector = [AWSNetworkingMetricsCollector new];
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceSTS
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    configuration.metricsCollector = self.collector;
+    [AWSSTS registerSTSWithConfiguration:configuration forKey:@"AWSNetworkingMetricsTests"];
+    self.sts = [AWSSTS STSForKey:@"AWSNetworkingMetricsTests"];
+}
+
+- (void)tearDown {
+    [AWSSTS removeSTSForKey:@"AWSNetworkingMetricsTests"];
+    [self.server stop];
+    [super tearDown];
+}
+
+- (void)addCallerIdentityResponse {
+    [self.server addResponseWithStatusCode:200
+                                   headers:@{@"Content-Type" : @"text/xml"}
+                                      body:[AWSNetworkingMetricsTestsCallerIdentity dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (AWSTask *)getCallerIdentity {
+    AWSTask *task = [self.sts getCallerIdentity:[AWSSTSGetCallerIdentityRequest new]];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (void)testHistogramSummarizesRecordedDurations {
+    for (NSUInteger i = 1; i <= 100; i++) {
+        AWSNetworkingOperationMetrics *metrics = [[AWSNetworkingOperationMetrics alloc] initWithServiceName:@"service"
+                                                                                               operationName:@"Operation"];
+        [metrics addDuration:i / 1000.0 forPhase:AWSNetworkingMetricsPhaseTotal];
+        [self.collector recordOperationMetrics:metrics];
+    }
+
+    AWSNetworkingMetricsSnapshot *snapshot = [self.collector snapshotForServiceName:@"service" operationName:@"Operation"];
+    AWSNetworkingMetricsHistogramSnapshot *total = [snapshot histogramForPhase:AWSNetworkingMetricsPhaseTotal];
+    XCTAssertEqual(snapshot.operationCount, 100);
+    XCTAssertEqual(total.count, 100);
+    XCTAssertEqualWithAccuracy(total.minimum, 0.001, 0.000001);
+    XCTAssertEqualWithAccuracy(total.maximum, 0.1, 0.000001);
+    XCTAssertEqualWithAccuracy(total.mean, 0.0505, 0.000001);
+    // Buckets are powers of two, so a percentile is at most twice the exact value.
+    XCTAssertGreaterThanOrEqual([total valueAtPercentile:50], 0.050);
+    XCTAssertLessThanOrEqual([total valueAtPercentile:50], 0.100);
+    XCTAssertEqualWithAccuracy([total valueAtPercentile:100], 0.1, 0.000001);
+    XCTAssertEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseSigning].count, 0);
+
+    [self.collector reset];
+    XCTAssertNil([self.collector snapshotForServiceName:@"service" operationName:@"Operation"]);
+}
+
+- (void)testHistogramsAcceptConcurrentRecording {
+    dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < 1000; i++) {
+            AWSNetworkingOperationMetrics *metrics = [[AWSNetworkingOperationMetrics alloc] initWithServiceName:@"service"
+                                                                                                   operationName:@"Operation"];
+            [metrics addDuration:0.001 forPhase:AWSNetworkingMetricsPhaseNetwork];
+            [self.collector recordOperationMetrics:metrics];
+        }
+    });
+
+    AWSNetworkingMetricsSnapshot *snapshot = [self.collector snapshotForServiceName:@"service" operationName:@"Operation"];
+    XCTAssertEqual(snapshot.operationCount, 8000);
+    XCTAssertEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseNetwork].count, 8000);
+    XCTAssertEqualWithAccuracy([snapshot histogramForPhase:AWSNetworkingMetricsPhaseNetwork].sum, 8.0, 0.000001);
+}
+
+- (void)testCollectsPhaseTimingsOfAnOperation {
+    [self addCallerIdentityResponse];
+    self.server.responseDelay = 0.05;
+
+    AWSTask *task = [self getCallerIdentity];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects([task.result account], @"123456789012");
+
+    AWSNetworkingMetricsSnapshot *snapshot = [self.collector snapshotForServiceName:@"sts" operationName:@"GetCallerIdentity"];
+    XCTAssertNotNil(snapshot);
+    XCTAssertEqual(snapshot.operationCount, 1);
+    XCTAssertEqual(snapshot.errorCount, 0);
+    XCTAssertEqual(snapshot.retryCount, 0);
+    for (NSNumber *phase in @[@(AWSNetworkingMetricsPhaseTotal),
+                              @(AWSNetworkingMetricsPhaseCredentials),
+                              @(AWSNetworkingMetricsPhaseSigning),
+                              @(AWSNetworkingMetricsPhaseSerialization),
+                              @(AWSNetworkingMetricsPhaseNetwork),
+                              @(AWSNetworkingMetricsPhaseTimeToFirstByte),
+                              @(AWSNetworkingMetricsPhaseParsing)]) {
+        XCTAssertEqual([snapshot histogramForPhase:[phase integerValue]].count, 1, @"%@", AWSNetworkingMetricsPhaseName([phase integerValue]));
+    }
+    XCTAssertEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseRetryDelay].count, 0);
+    XCTAssertGreaterThanOrEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseTimeToFirstByte].maximum, 0.05);
+    XCTAssertGreaterThanOrEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseTotal].maximum,
+                                [snapshot histogramForPhase:AWSNetworkingMetricsPhaseNetwork].maximum);
+    XCTAssertEqual(snapshot.bytesReceived.sum, [AWSNetworkingMetricsTestsCallerIdentity lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testCountsRetries {
+    [self.server addResponseWithStatusCode:500
+                                   headers:@{@"Content-Type" : @"text/xml"}
+                                      body:[AWSNetworkingMetricsTestsInternalFailure dataUsingEncoding:NSUTF8StringEncoding]];
+    [self addCallerIdentityResponse];
+
+    AWSTask *task = [self getCallerIdentity];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(self.server.requestCount, 2);
+
+    AWSNetworkingMetricsSnapshot *snapshot = [self.collector snapshotForServiceName:@"sts" operationName:@"GetCallerIdentity"];
+    XCTAssertEqual(snapshot.operationCount, 1);
+    XCTAssertEqual(snapshot.retryCount, 1);
+    XCTAssertEqual(snapshot.errorCount, 0);
+    XCTAssertEqual([snapshot histogramForPhase:AWSNetworkingMetricsPhaseRetryDelay].count, 1);
+}
+
+- (void)testExporterReceivesEachOperation {
+    [self addCallerIdentityResponse];
+    AWSNetworkingMetricsTestExporter *exporter = [AWSNetworkingMetricsTestExporter new];
+    exporter.exportedMetrics = [NSMutableArray new];
+    exporter.expectation = [self expectationWithDescription:@"metrics exported"];
+    exporter.expectation.expectedFulfillmentCount = 2;
+    [self.collector addExporter:exporter];
+
+    XCTAssertNil([self getCallerIdentity].error);
+    XCTAssertNil([self getCallerIdentity].error);
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual([exporter.exportedMetrics count], 2);
+    AWSNetworkingOperationMetrics *metrics = [exporter.exportedMetrics firstObject];
+    XCTAssertEqualObjects(metrics.serviceName, @"sts");
+    XCTAssertEqualObjects(metrics.operationName, @"GetCallerIdentity");
+    XCTAssertEqual(metrics.statusCode, 200);
+    XCTAssertNil(metrics.error);
+    XCTAssertTrue([metrics hasDurationForPhase:AWSNetworkingMetricsPhaseTotal]);
+    XCTAssertTrue([[exporter.exportedMetrics lastObject] reusedConnection]);
+
+    [self.collector removeExporter:exporter];
+}
+
+@end
@@ -0,0 +1,281 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "TestHTTPServer.h"
+
+static NSString *const AWSNetworkingTransportTestsCallerIdentity = @"<GetCallerIdentityResponse xmlns=\"https://sts.amazonaws.com/doc/2011-06-15/\">"
+"<GetCallerIdentityResult><Arn>arn:aws:iam::123456789012:user/test</Arn><UserId>AIDAEXAMPLE</UserId><Account>123456789012</Account></GetCallerIdentityResult>"
+"<ResponseMetadata><RequestId>01234567-89ab-cdef-0123-456789abcdef</RequestId></ResponseMetadata>"
+"</GetCallerIdentityResponse>";
+
+static const NSUInteger AWSNetworkingTransportTestsRequestCount = 5;
+
+// Fetches its credentials with a request through a scheduler, like a provider sharing the scheduler of its clients.
+@interface AWSNetworkingTransportTestsCredentialsProvider : NSObject <AWSCredentialsProvider>
+
+@property (nonatomic, strong) AWSNetworkingRequestScheduler *scheduler;
+
+@end
+
+@implementation AWSNetworkingTransportTestsCredentialsProvider
+
+- (AWSTask<AWSCredentials *> *)credentials {
+    return [[self.scheduler scheduleWithPriority:AWSNetworkingRequestPriorityNormal block:^AWSTask *{
+        return [AWSTask taskWithResult:nil];
+    }] continueWithSuccessBlock:^id(AWSTask *task) {
+        return [[AWSCredentials alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                               secretKey:@"SECRETEXAMPLE"
+                                              sessionKey:nil
+                                              expiration:nil];
+    }];
+}
+
+- (void)invalidateCachedTemporaryCredentials {
+}
+
+@end
+
+@interface AWSNetworkingTransportTests : XCTestCase
+
+@property (nonatomic, strong) TestHTTPServer *server;
+@property (nonatomic, strong) NSMutableArray<NSString *> *registeredKeys;
+
+@end
+
+@implementation AWSNetworkingTransportTests
+
+- (void)setUp {
+    [super setUp];
+    self.server = [TestHTTPServer new];
+    XCTAssertTrue([self.server start]);
+    [self.server addResponseWithStatusCode:200
+                                   headers:@{@"Content-Type" : @"text/xml"}
+                                      body:[AWSNetworkingTransportTestsCallerIdentity dataUsingEncoding:NSUTF8StringEncoding]];
+    self.registeredKeys = [NSMutableArray new];
+}
+
+- (void)tearDown {
+    for (NSString *key in self.registeredKeys) {
+        [AWSSTS removeSTSForKey:key];
+    }
+    [self.server stop];
+    [super tearDown];
+}
+
+- (AWSSTS *)STSWithKey:(NSString *)key configure:(void (^)(AWSServiceConfiguration *configuration))configure {
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    return [self STSWithKey:key credentialsProvider:credentialsProvider configure:configure];
+}
+
+- (AWSSTS *)STSWithKey:(NSString *)key
+   credentialsProvider:(id<AWSCredentialsProvider>)credentialsProvider
+             configure:(void (^)(AWSServiceConfiguration *configuration))configure {
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceSTS
+                                                            URL:self.server.URL];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    if (configure) {
+        configure(configuration);
+    }
+    [AWSSTS registerSTSWithConfiguration:configuration forKey:key];
+    [self.registeredKeys addObject:key];
+    return [AWSSTS STSForKey:key];
+}
+
+- (AWSTask *)getCallerIdentityWithSTS:(AWSSTS *)sts {
+    AWSTask *task = [sts getCallerIdentity:[AWSSTSGetCallerIdentityRequest new]];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (void)testReusesConnectionForSequentialRequests {
+    AWSSTS *sts = [self STSWithKey:@"AWSNetworkingTransportTests" configure:nil];
+
+    for (NSUInteger i = 0; i < AWSNetworkingTransportTestsRequestCount; i++) {
+        XCTAssertNil([self getCallerIdentityWithSTS:sts].error);
+    }
+
+    XCTAssertEqual(self.server.requestCount, AWSNetworkingTransportTestsRequestCount);
+    XCTAssertEqual(self.server.connectionCount, 1);
+}
+
+- (void)testOpensConnectionPerRequestWithoutConnectionReuse {
+    AWSSTS *sts = [self STSWithKey:@"AWSNetworkingTransportTests" configure:^(AWSServiceConfiguration *configuration) {
+        configuration.allowsConnectionReuse = NO;
+    }];
+
+    for (NSUInteger i = 0; i < AWSNetworkingTransportTestsRequestCount; i++) {
+        XCTAssertNil([self getCallerIdentityWithSTS:sts].error);
+    }
+
+    XCTAssertEqual(self.server.requestCount, AWSNetworkingTransportTestsRequestCount);
+    XCTAssertEqual(self.server.connectionCount, AWSNetworkingTransportTestsRequestCount);
+}
+
+- (void)testClosesIdleConnectionsAfterIdleTimeout {
+    AWSSTS *sts = [self STSWithKey:@"AWSNetworkingTransportTests" configure:^(AWSServiceConfiguration *configuration) {
+        configuration.connectionIdleTimeout = 0.1;
+    }];
+
+    XCTAssertNil([self getCallerIdentityWithSTS:sts].error);
+    XCTAssertNil([self getCallerIdentityWithSTS:sts].error);
+    XCTAssertEqual(self.server.connectionCount, 1);
+
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertNil([self getCallerIdentityWithSTS:sts].error);
+    XCTAssertEqual(self.server.connectionCount, 2);
+}
+
+- (void)testClientsShareConnectionsOfSharedSession {
+    void (^configure)(AWSServiceConfiguration *) = ^(AWSServiceConfiguration *configuration) {
+        configuration.usesSharedURLSession = YES;
+    };
+    AWSSTS *first = [self STSWithKey:@"AWSNetworkingTransportTestsFirst" configure:configure];
+    AWSSTS *second = [self STSWithKey:@"AWSNetworkingTransportTestsSecond" configure:configure];
+
+    for (NSUInteger i = 0; i < AWSNetworkingTransportTestsRequestCount; i++) {
+        XCTAssertNil([self getCallerIdentityWithSTS:first].error);
+        XCTAssertNil([self getCallerIdentityWithSTS:second].error);
+    }
+
+    XCTAssertEqual(self.server.requestCount, 2 * AWSNetworkingTransportTestsRequestCount);
+    XCTAssertEqual(self.server.connectionCount, 1);
+}
+
+- (void)testSharedSessionKeepsWorkingAfterAClientIsRemoved {
+    void (^configure)(AWSServiceConfiguration *) = ^(AWSServiceConfiguration *configuration) {
+        configuration.usesSharedURLSession = YES;
+    };
+    AWSSTS *first = [self STSWithKey:@"AWSNetworkingTransportTestsFirst" configure:configure];
+    XCTAssertNil([self getCallerIdentityWithSTS:first].error);
+    [AWSSTS removeSTSForKey:@"AWSNetworkingTransportTestsFirst"];
+    first = nil;
+
+    AWSSTS *second = [self STSWithKey:@"AWSNetworkingTransportTestsSecond" configure:configure];
+    XCTAssertNil([self getCallerIdentityWithSTS:second].error);
+    XCTAssertEqual(self.server.connectionCount, 1);
+}
+
+- (void)testSchedulerLimitsRequestsInFlight {
+    self.server.responseDelay = 0.05;
+    AWSNetworkingRequestScheduler *scheduler = [[AWSNetworkingRequestScheduler alloc] initWithMaximumConcurrentRequests:2];
+    void (^configure)(AWSServiceConfiguration *) = ^(AWSServiceConfiguration *configuration) {
+        configuration.requestScheduler = scheduler;
+    };
+    // The clients share the limit of the scheduler.
+    AWSSTS *first = [self STSWithKey:@"AWSNetworkingTransportTestsFirst" configure:configure];
+    AWSSTS *second = [self STSWithKey:@"AWSNetworkingTransportTestsSecond" configure:configure];
+
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSNetworkingTransportTestsRequestCount; i++) {
+        [tasks addObject:[first getCallerIdentity:[AWSSTSGetCallerIdentityRequest new]]];
+        [tasks addObject:[second getCallerIdentity:[AWSSTSGetCallerIdentityRequest new]]];
+    }
+    AWSTask *all = [AWSTask taskForCompletionOfAllTasks:tasks];
+    [all waitUntilFinished];
+
+    XCTAssertNil(all.error);
+    XCTAssertEqual(self.server.requestCount, 2 * AWSNetworkingTransportTestsRequestCount);
+    XCTAssertGreaterThan(self.server.maximumConcurrentRequestCount, 0);
+    XCTAssertLessThanOrEqual(self.server.maximumConcurrentRequestCount, 2);
+    XCTAssertEqual(scheduler.inFlightRequestCount, 0);
+    XCTAssertEqual(scheduler.waitingRequestCount, 0);
+}
+
+- (void)testSchedulerSlotIsNotHeldWhileFetchingCredentials {
+    AWSNetworkingRequestScheduler *scheduler = [[AWSNetworkingRequestScheduler alloc] initWithMaximumConcurrentRequests:1];
+    AWSNetworkingTransportTestsCredentialsProvider *credentialsProvider = [AWSNetworkingTransportTestsCredentialsProvider new];
+    credentialsProvider.scheduler = scheduler;
+    AWSSTS *sts = [self STSWithKey:@"AWSNetworkingTransportTests" credentialsProvider:credentialsProvider configure:^(AWSServiceConfiguration *configuration) {
+        configuration.requestScheduler = scheduler;
+    }];
+
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSNetworkingTransportTestsRequestCount; i++) {
+        [tasks addObject:[sts getCallerIdentity:[AWSSTSGetCallerIdentityRequest new]]];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"All requests finished"];
+    AWSTask *all = [[AWSTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id(AWSTask *task) {
+        [expectation fulfill];
+        return task;
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    [all waitUntilFinished];
+
+    XCTAssertNil(all.error);
+    XCTAssertEqual(self.server.requestCount, AWSNetworkingTransportTestsRequestCount);
+    XCTAssertEqual(scheduler.inFlightRequestCount, 0);
+}
+
+- (void)testSchedulerStartsWaitingRequestsByPriority {
+    AWSNetworkingRequestScheduler *scheduler = [[AWSNetworkingRequestScheduler alloc] initWithMaximumConcurrentRequests:1];
+    NSMutableArray<NSString *> *startOrder = [NSMutableArray new];
+    NSMutableDictionary<NSString *, AWSTaskCompletionSource *> *requests = [NSMutableDictionary new];
+    AWSTask *(^schedule)(NSString *, AWSNetworkingRequestPriority) = ^AWSTask *(NSString *name, AWSNetworkingRequestPriority priority) {
+        return [scheduler scheduleWithPriority:priority block:^AWSTask *{
+            [startOrder addObject:name];
+            requests[name] = [AWSTaskCompletionSource taskCompletionSource];
+            return requests[name].task;
+        }];
+    };
+
+    AWSTask *running = schedule(@"running", AWSNetworkingRequestPriorityLow);
+    schedule(@"low", AWSNetworkingRequestPriorityLow);
+    schedule(@"normal1", AWSNetworkingRequestPriorityNormal);
+    schedule(@"high", AWSNetworkingRequestPriorityHigh);
+    schedule(@"normal2", AWSNetworkingRequestPriorityNormal);
+    XCTAssertEqualObjects(startOrder, @[@"running"]);
+    XCTAssertEqual(scheduler.inFlightRequestCount, 1);
+    XCTAssertEqual(scheduler.waitingRequestCount, 4);
+
+    requests[@"running"].result = @"done";
+    [running waitUntilFinished];
+    XCTAssertEqualObjects(running.result, @"done");
+    for (NSString *name in @[@"high", @"normal1", @"normal2"]) {
+        XCTAssertEqualObjects([startOrder lastObject], name);
+        requests[name].result = nil;
+    }
+    XCTAssertEqualObjects(startOrder, (@[@"running", @"high", @"normal1", @"normal2", @"low"]));
+
+    requests[@"low"].error = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo:nil];
+    XCTAssertEqual(scheduler.inFlightRequestCount, 0);
+    XCTAssertEqual(scheduler.waitingRequestCount, 0);
+}
+
+- (void)testSchedulerPassesOnTheResultOfTheRequest {
+    AWSNetworkingRequestScheduler *scheduler = [[AWSNetworkingRequestScheduler alloc] initWithMaximumConcurrentRequests:0];
+    XCTAssertEqual(scheduler.maximumConcurrentRequests, 1);
+
+    NSError *error = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorCancelled userInfo:nil];
+    AWSTask *failed = [scheduler scheduleWithPriority:AWSNetworkingRequestPriorityNormal block:^AWSTask *{
+        return [AWSTask taskWithError:error];
+    }];
+    [failed waitUntilFinished];
+    XCTAssertEqualObjects(failed.error, error);
+
+    AWSTask *succeeded = [scheduler scheduleWithPriority:AWSNetworkingRequestPriorityNormal block:^AWSTask *{
+        return [AWSTask taskWithResult:@"result"];
+    }];
+    [succeeded waitUntilFinished];
+    XCTAssertEqualObjects(succeeded.result, @"result");
+    XCTAssertEqual(scheduler.inFlightRequestCount, 0);
+}
+
+@end
@@ -0,0 +1,111 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSSynchronizedMutableDictionaryTestsKeyCount = 1000;
+static const NSUInteger AWSSynchronizedMutableDictionaryTestsReaderCount = 8;
+static const NSUInteger AWSSynchronizedMutableDictionaryTestsWriterCount = 2;
+static const NSUInteger AWSSynchronizedMutableDictionaryTestsOperationsPerThread = 50000;
+
+@interface AWSSynchronizedMutableDictionaryTests : XCTestCase
+
+@end
+
+@implementation AWSSynchronizedMutableDictionaryTests
+
+- (void)testBasicOperations {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    NSObject *first = [NSObject new];
+    NSObject *second = [NSObject new];
+
+    [dictionary setObject:first forKey:@1];
+    [dictionary setObject:second forKey:@"two"];
+    XCTAssertEqual([dictionary objectForKey:@1], first);
+    XCTAssertEqual([dictionary objectForKey:@"two"], second);
+    XCTAssertNil([dictionary objectForKey:@3]);
+    XCTAssertEqualObjects([NSSet setWithArray:[dictionary allKeys]], ([NSSet setWithObjects:@1, @"two", nil]));
+
+    [dictionary setObject:second forKey:@1];
+    XCTAssertEqual([dictionary objectForKey:@1], second);
+
+    [dictionary removeObjectForKey:@"two"];
+    XCTAssertNil([dictionary objectForKey:@"two"]);
+
+    [dictionary removeObject:second];
+    XCTAssertNil([dictionary objectForKey:@1]);
+    XCTAssertEqual([dictionary allKeys].count, 0);
+}
+
+- (void)testRemoveObjectRemovesOnlyOneEntry {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    NSObject *object = [NSObject new];
+    for (NSUInteger i = 0; i < 100; i++) {
+        [dictionary setObject:object forKey:@(i)];
+    }
+    [dictionary removeObject:object];
+    XCTAssertEqual([dictionary allKeys].count, 99);
+}
+
+- (void)testConcurrentReadersAndWriters {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryTestsKeyCount; i++) {
+        [dictionary setObject:@(i) forKey:@(i)];
+    }
+
+    dispatch_apply(AWSSynchronizedMutableDictionaryTestsReaderCount + AWSSynchronizedMutableDictionaryTestsWriterCount,
+                   dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < 10000; i++) {
+            NSNumber *key = @(arc4random_uniform((uint32_t)AWSSynchronizedMutableDictionaryTestsKeyCount));
+            if (thread < AWSSynchronizedMutableDictionaryTestsWriterCount) {
+                [dictionary setObject:key forKey:key];
+            } else {
+                XCTAssertEqualObjects([dictionary objectForKey:key], key);
+            }
+        }
+    });
+
+    XCTAssertEqual([dictionary allKeys].count, AWSSynchronizedMutableDictionaryTestsKeyCount);
+}
+
+- (void)testPerformanceManyReadersFewWriters {
+    AWSSynchronizedMutableDictionary *dictionary = [AWSSynchronizedMutableDictionary new];
+    NSMutableArray<NSNumber *> *keys = [NSMutableArray arrayWithCapacity:AWSSynchronizedMutableDictionaryTestsKeyCount];
+    for (NSUInteger i = 0; i < AWSSynchronizedMutableDictionaryTestsKeyCount; i++) {
+        [keys addObject:@(i)];
+        [dictionary setObject:[NSObject new] forKey:@(i)];
+    }
+
+    [self measureBlock:^{
+        dispatch_apply(AWSSynchronizedMutableDictionaryTestsReaderCount + AWSSynchronizedMutableDictionaryTestsWriterCount,
+                       dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            BOOL isWriter = thread < AWSSynchronizedMutableDictionaryTestsWriterCount;
+            NSUInteger operations = isWriter
+                ? AWSSynchronizedMutableDictionaryTestsOperationsPerThread / 10
+                : AWSSynchronizedMutableDictionaryTestsOperationsPerThread;
+            for (NSUInteger i = 0; i < operations; i++) {
+                NSNumber *key = keys[(i * 7919 + thread) % AWSSynchronizedMutableDictionaryTestsKeyCount];
+                if (isWriter) {
+                    [dictionary setObject:key forKey:key];
+                } else {
+                    [dictionary objectForKey:key];
+                }
+            }
+        });
+    }];
+}
+
+@end
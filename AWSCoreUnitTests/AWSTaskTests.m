@@ -0,0 +1,152 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <libkern/OSAtomic.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSTaskTestsChainLength = 10000;
+static const NSUInteger AWSTaskTestsContendingThreads = 8;
+static const NSUInteger AWSTaskTestsContinuationsPerThread = 1000;
+
+@interface AWSTaskTests : XCTestCase
+
+@end
+
+@implementation AWSTaskTests
+
+- (void)testContinuationsRunInTheOrderTheyWereAdded {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    NSMutableArray<NSNumber *> *order = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 100; i++) {
+        [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+            [order addObject:@(i)];
+            return nil;
+        }];
+    }
+    XCTAssertEqual(order.count, 0);
+
+    source.result = @"done";
+    XCTAssertEqual(order.count, 100);
+    for (NSUInteger i = 0; i < order.count; i++) {
+        XCTAssertEqual(order[i].unsignedIntegerValue, i);
+    }
+}
+
+- (void)testOnlyTheFirstCompletionWins {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    XCTAssertTrue([source trySetResult:@1]);
+    XCTAssertFalse([source trySetError:[NSError errorWithDomain:AWSTaskErrorDomain code:0 userInfo:nil]]);
+    XCTAssertFalse([source trySetCancelled]);
+
+    XCTAssertTrue(source.task.completed);
+    XCTAssertFalse(source.task.faulted);
+    XCTAssertFalse(source.task.cancelled);
+    XCTAssertEqualObjects(source.task.result, @1);
+    XCTAssertNil(source.task.error);
+}
+
+- (void)testCompletedTasksReportTheirState {
+    NSError *error = [NSError errorWithDomain:AWSTaskErrorDomain code:1 userInfo:nil];
+    AWSTask *faulted = [AWSTask taskWithError:error];
+    XCTAssertTrue(faulted.completed);
+    XCTAssertTrue(faulted.faulted);
+    XCTAssertEqualObjects(faulted.error, error);
+    XCTAssertNil(faulted.result);
+
+    AWSTask *cancelled = [AWSTask cancelledTask];
+    XCTAssertTrue(cancelled.completed);
+    XCTAssertTrue(cancelled.cancelled);
+    XCTAssertFalse(cancelled.faulted);
+}
+
+- (void)testConcurrentCompletionHasExactlyOneWinner {
+    for (NSUInteger iteration = 0; iteration < 1000; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        __block int32_t winners = 0;
+        dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+            if ([source trySetResult:@(index)]) {
+                OSAtomicIncrement32Barrier(&winners);
+            }
+        });
+        XCTAssertEqual(winners, 1);
+    }
+}
+
+- (void)testContinuationsAddedWhileCompletingRunExactlyOnce {
+    for (NSUInteger iteration = 0; iteration < 200; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        __block int32_t runs = 0;
+        dispatch_group_t group = dispatch_group_create();
+        for (NSUInteger thread = 0; thread < AWSTaskTestsContendingThreads; thread++) {
+            dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                for (NSUInteger i = 0; i < 50; i++) {
+                    [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                        OSAtomicIncrement32Barrier(&runs);
+                        return nil;
+                    }];
+                }
+            });
+        }
+        source.result = nil;
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        XCTAssertEqual(runs, AWSTaskTestsContendingThreads * 50);
+    }
+}
+
+- (void)testWaitUntilFinishedWakesUpForLateCompletion {
+    for (NSUInteger iteration = 0; iteration < 200; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            source.result = @(iteration);
+        });
+        [source.task waitUntilFinished];
+        XCTAssertEqualObjects(source.task.result, @(iteration));
+    }
+}
+
+- (void)testPerformanceChainedContinueWithBlock {
+    [self measureBlock:^{
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        AWSTask *task = source.task;
+        for (NSUInteger i = 0; i < AWSTaskTestsChainLength; i++) {
+            task = [task continueWithBlock:^id(AWSTask *t) {
+                return @([t.result unsignedIntegerValue] + 1);
+            }];
+        }
+        source.result = @0;
+        [task waitUntilFinished];
+        XCTAssertEqual([task.result unsignedIntegerValue], AWSTaskTestsChainLength);
+    }];
+}
+
+- (void)testPerformanceContendedContinueWithBlock {
+    [self measureBlock:^{
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        __block int32_t runs = 0;
+        dispatch_apply(AWSTaskTestsContendingThreads, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (NSUInteger i = 0; i < AWSTaskTestsContinuationsPerThread; i++) {
+                [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                    OSAtomicIncrement32Barrier(&runs);
+                    return nil;
+                }];
+            }
+        });
+        source.result = nil;
+        XCTAssertEqual(runs, AWSTaskTestsContendingThreads * AWSTaskTestsContinuationsPerThread);
+    }];
+}
+
+@end
@@ -31,10 +31,53 @@
 
 @interface AWSURLSessionManager()
 
+@property (nonatomic, strong) NSURLSession *session;
+
 - (void)invalidate;
 
 @end
 
+static NSInteger AWSURLSessionManagerTestStatusCode = 200;
+static NSData *AWSURLSessionManagerTestResponseBody = nil;
+static const NSUInteger AWSURLSessionManagerTestChunkLength = 16 * 1024;
+
+// Answers every request with `AWSURLSessionManagerTestResponseBody`, in chunks of `AWSURLSessionManagerTestChunkLength`
+// bytes and with its Content-Length.
+@interface AWSURLSessionManagerTestURLProtocol : NSURLProtocol
+
+@end
+
+@implementation AWSURLSessionManagerTestURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    NSData *body = AWSURLSessionManagerTestResponseBody;
+    NSDictionary *headers = @{@"Content-Type" : @"application/octet-stream",
+                              @"Content-Length" : [@(body.length) stringValue]};
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                              statusCode:AWSURLSessionManagerTestStatusCode
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:headers];
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    for (NSUInteger offset = 0; offset < body.length; offset += AWSURLSessionManagerTestChunkLength) {
+        NSRange range = NSMakeRange(offset, MIN(AWSURLSessionManagerTestChunkLength, body.length - offset));
+        [self.client URLProtocol:self didLoadData:[body subdataWithRange:range]];
+    }
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
+
 @interface AWSURLSessionManagerTests : XCTestCase
 
 @end
@@ -45,6 +88,28 @@
 
 - (void)setUp {
     [AWSTestUtility setupFakeCognitoCredentialsProvider];
+    AWSURLSessionManagerTestStatusCode = 200;
+    NSMutableData *body = [NSMutableData dataWithLength:10 * AWSURLSessionManagerTestChunkLength + 100];
+    for (NSUInteger i = 0; i < body.length; i++) {
+        ((uint8_t *)body.mutableBytes)[i] = (uint8_t)(i % 251);
+    }
+    AWSURLSessionManagerTestResponseBody = body;
+}
+
+- (AWSURLSessionManager *)stubbedSessionManager {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    configuration.baseURL = [NSURL URLWithString:@"https://example.com"];
+    configuration.URLString = @"/object";
+    configuration.HTTPMethod = AWSHTTPMethodGET;
+    AWSURLSessionManager *sessionManager = [[AWSURLSessionManager alloc] initWithConfiguration:configuration];
+
+    NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    sessionConfiguration.protocolClasses = @[[AWSURLSessionManagerTestURLProtocol class]];
+    [sessionManager.session invalidateAndCancel];
+    sessionManager.session = [NSURLSession sessionWithConfiguration:sessionConfiguration
+                                                           delegate:sessionManager
+                                                      delegateQueue:nil];
+    return sessionManager;
 }
 
 /**
@@ -113,4 +178,68 @@
     }] waitUntilFinished];
 }
 
+/**
+ - Given: A response with a Content-Length, delivered in several parts
+ - When: The request has no response data handler
+ - Then: The whole body is the result of the task
+ */
+- (void)testResponseBodyIsCollected {
+    AWSURLSessionManager *sessionManager = [self stubbedSessionManager];
+
+    AWSTask *task = [sessionManager dataTaskWithRequest:[AWSNetworkingRequest new]];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(task.result, AWSURLSessionManagerTestResponseBody);
+    [sessionManager invalidate];
+}
+
+/**
+ - Given: A successful response delivered in several parts
+ - When: The request has a response data handler
+ - Then: The handler receives the whole body in order, and it is not also returned as the result
+ */
+- (void)testResponseDataHandlerReceivesSuccessfulResponseBody {
+    AWSURLSessionManager *sessionManager = [self stubbedSessionManager];
+    NSMutableData *receivedData = [NSMutableData new];
+    __block NSUInteger handlerCallCount = 0;
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.responseDataHandler = ^(NSData *data) {
+        handlerCallCount++;
+        [receivedData appendData:data];
+    };
+
+    AWSTask *task = [sessionManager dataTaskWithRequest:request];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertNil(task.result);
+    XCTAssertGreaterThan(handlerCallCount, 1);
+    XCTAssertEqualObjects(receivedData, AWSURLSessionManagerTestResponseBody);
+    [sessionManager invalidate];
+}
+
+/**
+ - Given: An error response
+ - When: The request has a response data handler
+ - Then: The handler is not called and the body is collected for the response serializer
+ */
+- (void)testResponseDataHandlerIsNotCalledForErrorResponse {
+    AWSURLSessionManagerTestStatusCode = 500;
+    AWSURLSessionManagerTestResponseBody = [@"{\"message\":\"internal error\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    AWSURLSessionManager *sessionManager = [self stubbedSessionManager];
+    __block NSUInteger handlerCallCount = 0;
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.responseDataHandler = ^(NSData *data) {
+        handlerCallCount++;
+    };
+
+    AWSTask *task = [sessionManager dataTaskWithRequest:request];
+    [task waitUntilFinished];
+
+    XCTAssertEqual(handlerCallCount, 0);
+    XCTAssertEqualObjects(task.result, AWSURLSessionManagerTestResponseBody);
+    [sessionManager invalidate];
+}
+
 @end
@@ -0,0 +1,164 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <libkern/OSAtomic.h>
+#import <AWSCore/AWSCore.h>
+
+// The stress benchmark fans out this many chains of continuations, each this long.
+static const NSUInteger AWSWorkStealingExecutorTestsChainCount = 2000;
+static const NSUInteger AWSWorkStealingExecutorTestsChainLength = 20;
+
+@interface AWSWorkStealingExecutorTests : XCTestCase
+
+@end
+
+@implementation AWSWorkStealingExecutorTests
+
+- (void)runChainsOnExecutor:(AWSExecutor *)executor {
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:AWSWorkStealingExecutorTestsChainCount];
+    for (NSUInteger chain = 0; chain < AWSWorkStealingExecutorTestsChainCount; chain++) {
+        AWSTask *task = [AWSTask taskWithResult:@0];
+        for (NSUInteger link = 0; link < AWSWorkStealingExecutorTestsChainLength; link++) {
+            task = [task continueWithExecutor:executor withSuccessBlock:^id(AWSTask *t) {
+                // A little work per continuation, so that queueing and not just dispatch overhead is measured.
+                NSUInteger value = [t.result unsignedIntegerValue];
+                for (NSUInteger i = 0; i < 200; i++) {
+                    value = (value * 31 + i) % 1000003;
+                }
+                return @(value);
+            }];
+        }
+        [tasks addObject:task];
+    }
+    [[AWSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    for (AWSTask *task in tasks) {
+        XCTAssertNotNil(task.result);
+    }
+}
+
+- (void)testEveryBlockRunsExactlyOnce {
+    AWSWorkStealingExecutor *executor = [[AWSWorkStealingExecutor alloc] initWithThreadCount:4];
+    const NSUInteger blockCount = 10000;
+    uint8_t *runs = calloc(blockCount, 1);
+    dispatch_group_t group = dispatch_group_create();
+
+    dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t submitter) {
+        for (NSUInteger i = submitter; i < blockCount; i += 4) {
+            dispatch_group_enter(group);
+            [executor execute:^{
+                runs[i]++;
+                dispatch_group_leave(group);
+            }];
+        }
+    });
+
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0);
+    for (NSUInteger i = 0; i < blockCount; i++) {
+        XCTAssertEqual(runs[i], 1, @"block %lu", (unsigned long)i);
+    }
+    free(runs);
+
+    // The count is bumped just after each block returns, which can be after the group has been left.
+    for (NSUInteger attempt = 0; attempt < 1000 && executor.executedCount < blockCount; attempt++) {
+        usleep(1000);
+    }
+    XCTAssertEqual(executor.threadCount, 4);
+    XCTAssertEqual(executor.executedCount, blockCount);
+    XCTAssertEqual(executor.queueDepth, 0);
+    XCTAssertGreaterThan(executor.maxQueueDepth, 0);
+}
+
+- (void)testIdleWorkersStealFromABusyWorker {
+    AWSWorkStealingExecutor *executor = [[AWSWorkStealingExecutor alloc] initWithThreadCount:4];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"All queued blocks ran"];
+    const int32_t queuedCount = 400;
+    __block int32_t remaining = queuedCount;
+
+    // Nest blocks on one worker until its stack headroom is used up. Everything submitted from there on goes onto that
+    // worker's own deque, so the other workers only get work by stealing it.
+    __block volatile int32_t queued = 0;
+    __block void (^nest)(void) = nil;
+    nest = ^{
+        __block BOOL ranInline = NO;
+        [executor execute:^{
+            ranInline = YES;
+            if (!queued) {
+                nest();
+            }
+        }];
+        if (ranInline || !OSAtomicCompareAndSwap32Barrier(0, 1, &queued)) {
+            return;
+        }
+        for (int32_t i = 0; i < queuedCount; i++) {
+            [executor execute:^{
+                usleep(100);
+                if (OSAtomicDecrement32Barrier(&remaining) == 0) {
+                    [expectation fulfill];
+                }
+            }];
+        }
+    };
+    [executor execute:^{
+        nest();
+    }];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    nest = nil;
+    XCTAssertGreaterThan(executor.stealCount, 0);
+    XCTAssertGreaterThan(executor.inlineCount, 0);
+}
+
+- (void)testDeepContinuationChainsDoNotOverflowTheStack {
+    AWSWorkStealingExecutor *executor = [[AWSWorkStealingExecutor alloc] initWithThreadCount:2];
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    AWSTask *task = source.task;
+    for (NSUInteger i = 0; i < 100000; i++) {
+        task = [task continueWithExecutor:executor withBlock:^id(AWSTask *t) {
+            return @([t.result unsignedIntegerValue] + 1);
+        }];
+    }
+    [executor execute:^{
+        source.result = @0;
+    }];
+    [task waitUntilFinished];
+    XCTAssertEqual([task.result unsignedIntegerValue], 100000);
+}
+
+- (void)testConfigurationCopiesTheContinuationExecutor {
+    AWSWorkStealingExecutor *executor = [[AWSWorkStealingExecutor alloc] initWithThreadCount:1];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:nil];
+    XCTAssertNil(configuration.continuationExecutor);
+    configuration.continuationExecutor = executor;
+    AWSServiceConfiguration *copiedConfiguration = [configuration copy];
+    XCTAssertEqual(copiedConfiguration.continuationExecutor, executor);
+}
+
+- (void)testPerformanceStressGlobalDispatchQueue {
+    AWSExecutor *executor = [AWSExecutor executorWithDispatchQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+    [self measureBlock:^{
+        [self runChainsOnExecutor:executor];
+    }];
+}
+
+- (void)testPerformanceStressWorkStealingExecutor {
+    AWSWorkStealingExecutor *executor = [AWSWorkStealingExecutor sharedExecutor];
+    [self measureBlock:^{
+        [self runChainsOnExecutor:executor];
+    }];
+}
+
+@end
@@ -18,6 +18,16 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+FOUNDATION_EXPORT NSString *const AWSDynamoDBObjectMapperErrorDomain;
+
+typedef NS_ENUM(NSInteger, AWSDynamoDBObjectMapperErrorType) {
+    AWSDynamoDBObjectMapperErrorUnknown,
+    /**
+     DynamoDB returned the item as unprocessed every time a batch request was sent, up to `maximumBatchRetryCount` times.
+     */
+    AWSDynamoDBObjectMapperErrorUnprocessedItem,
+};
+
 /**
  Enumeration of behaviors for the save operation.
  */
@@ -67,6 +77,7 @@ typedef NS_ENUM(NSInteger, AWSDynamoDBObjectMapperSaveBehavior) {
 @class AWSDynamoDBQueryExpression;
 @class AWSDynamoDBScanExpression;
 @class AWSDynamoDBPaginatedOutput;
+@class AWSDynamoDBObjectMapperBatchResult;
 
 /**
  A DynamoDB Modeling protocol. All objects mapped to an Amazon DynamoDB table row need to conform to this protocol.
@@ -526,6 +537,218 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
 configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
 completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable response, NSError * _Nullable error))completionHandler;
 
+/**
+ Scans through an Amazon DynamoDB table in `totalSegments` segments at once using the default configuration, and passes each page of instantiated objects to `pageHandler` as it arrives.
+
+ Up to `maximumConcurrentScanSegments` segments are scanned at a time, and a segment's next page is requested only after `pageHandler` has returned for its current page, so at most that many pages are held in memory. `pageHandler` is never called for two pages at once. The `exclusiveStartKey` of the expression is ignored.
+
+ @param resultClass       The class of the result object.
+ @param expression        An expression object.
+ @param totalSegments     The number of segments to divide the table into.
+ @param cancellationToken A token that cancels the scan and its requests in flight.
+ @param pageHandler       The block to call with each page of model objects. Set `stop` to `YES` to end the scan.
+
+ @return AWSTask. `task.error` indicates why a request failed, and the task is cancelled if `cancellationToken` was. `task.result` is always `nil`.
+ */
+- (AWSTask *)parallelScan:(Class)resultClass
+               expression:(AWSDynamoDBScanExpression *)expression
+            totalSegments:(NSUInteger)totalSegments
+        cancellationToken:(nullable AWSCancellationToken *)cancellationToken
+              pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler;
+
+/**
+ Scans through an Amazon DynamoDB table in `totalSegments` segments at once using the default configuration, and passes each page of instantiated objects to `pageHandler` as it arrives.
+
+ @param resultClass       The class of the result object.
+ @param expression        An expression object.
+ @param totalSegments     The number of segments to divide the table into.
+ @param cancellationToken A token that cancels the scan and its requests in flight.
+ @param pageHandler       The block to call with each page of model objects. Set `stop` to `YES` to end the scan.
+ @param completionHandler The completion handler to call when every segment has been scanned, the scan was stopped or cancelled, or a request failed.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)parallelScan:(Class)resultClass
+          expression:(AWSDynamoDBScanExpression *)expression
+       totalSegments:(NSUInteger)totalSegments
+   cancellationToken:(nullable AWSCancellationToken *)cancellationToken
+         pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler
+   completionHandler:(void (^ _Nullable)(NSError * _Nullable error))completionHandler;
+
+/**
+ Scans through an Amazon DynamoDB table in `totalSegments` segments at once using the specified configuration, and passes each page of instantiated objects to `pageHandler` as it arrives.
+
+ @param resultClass       The class of the result object.
+ @param expression        An expression object.
+ @param totalSegments     The number of segments to divide the table into.
+ @param configuration     A configuration.
+ @param cancellationToken A token that cancels the scan and its requests in flight.
+ @param pageHandler       The block to call with each page of model objects. Set `stop` to `YES` to end the scan.
+
+ @return AWSTask. `task.error` indicates why a request failed, and the task is cancelled if `cancellationToken` was. `task.result` is always `nil`.
+ */
+- (AWSTask *)parallelScan:(Class)resultClass
+               expression:(AWSDynamoDBScanExpression *)expression
+            totalSegments:(NSUInteger)totalSegments
+            configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
+        cancellationToken:(nullable AWSCancellationToken *)cancellationToken
+              pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler;
+
+/**
+ Scans through an Amazon DynamoDB table in `totalSegments` segments at once using the specified configuration, and passes each page of instantiated objects to `pageHandler` as it arrives.
+
+ @param resultClass       The class of the result object.
+ @param expression        An expression object.
+ @param totalSegments     The number of segments to divide the table into.
+ @param configuration     A configuration.
+ @param cancellationToken A token that cancels the scan and its requests in flight.
+ @param pageHandler       The block to call with each page of model objects. Set `stop` to `YES` to end the scan.
+ @param completionHandler The completion handler to call when every segment has been scanned, the scan was stopped or cancelled, or a request failed.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)parallelScan:(Class)resultClass
+          expression:(AWSDynamoDBScanExpression *)expression
+       totalSegments:(NSUInteger)totalSegments
+       configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
+   cancellationToken:(nullable AWSCancellationToken *)cancellationToken
+         pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler
+   completionHandler:(void (^ _Nullable)(NSError * _Nullable error))completionHandler;
+
+/**
+ Returns the objects with the keys of the given models, using the default configuration. The models only need their hash key and range key (if it exists) set, and may belong to different tables.
+
+ Keys are read with BatchGetItem, 100 at a time, with up to `maximumConcurrentBatchRequests` requests in flight. Keys DynamoDB returns as unprocessed are requested again after a backoff.
+
+ @param models Models that hold the keys to load.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order. Each result's `loadedModel` is the object with that key, or `nil` if no such object exists.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models;
+
+/**
+ Returns the objects with the keys of the given models, using the default configuration.
+
+ @param models            Models that hold the keys to load.
+ @param completionHandler The completion handler to call when the load request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
+/**
+ Returns the objects with the keys of the given models, using the specified configuration.
+
+ @param models        Models that hold the keys to load.
+ @param configuration A configuration.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                           configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration;
+
+/**
+ Returns the objects with the keys of the given models, using the specified configuration.
+
+ @param models            Models that hold the keys to load.
+ @param configuration     A configuration.
+ @param completionHandler The completion handler to call when the load request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+    configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
+/**
+ Saves the model objects to their Amazon DynamoDB tables using the default configuration.
+
+ Models are written with BatchWriteItem, 25 at a time, with up to `maximumConcurrentBatchRequests` requests in flight. Items DynamoDB returns as unprocessed are written again after a backoff. Batch writes replace whole items, as `AWSDynamoDBObjectMapperSaveBehaviorClobber` does, whatever the configured save behavior. If several models have the same key, the last one is saved.
+
+ @param models Models to save.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models;
+
+/**
+ Saves the model objects to their Amazon DynamoDB tables using the default configuration.
+
+ @param models            Models to save.
+ @param completionHandler The completion handler to call when the save request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
+/**
+ Saves the model objects to their Amazon DynamoDB tables using the specified configuration.
+
+ @param models        Models to save.
+ @param configuration A configuration.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                           configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration;
+
+/**
+ Saves the model objects to their Amazon DynamoDB tables using the specified configuration.
+
+ @param models            Models to save.
+ @param configuration     A configuration.
+ @param completionHandler The completion handler to call when the save request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+    configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
+/**
+ Removes the given model objects from their Amazon DynamoDB tables using the default configuration. Models are removed with BatchWriteItem, in the same way `batchSave:` writes them.
+
+ @param models Models to delete.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models;
+
+/**
+ Removes the given model objects from their Amazon DynamoDB tables using the default configuration.
+
+ @param models            Models to delete.
+ @param completionHandler The completion handler to call when the remove request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+  completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
+/**
+ Removes the given model objects from their Amazon DynamoDB tables using the specified configuration.
+
+ @param models        Models to delete.
+ @param configuration A configuration.
+
+ @return AWSTask. `task.result` holds one `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+ */
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                             configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration;
+
+/**
+ Removes the given model objects from their Amazon DynamoDB tables using the specified configuration.
+
+ @param models            Models to delete.
+ @param configuration     A configuration.
+ @param completionHandler The completion handler to call when the remove request is complete.
+                          `results`: One `AWSDynamoDBObjectMapperBatchResult` per model, in the same order.
+                          `error`: An error object that indicates why the request failed, or `nil` if the request was successful.
+ */
+- (void)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+      configuration:(nullable AWSDynamoDBObjectMapperConfiguration *)configuration
+  completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler;
+
 @end
 
 /**
@@ -543,6 +766,48 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
  */
 @property (nonatomic, strong, nullable) NSNumber *consistentRead;
 
+/**
+ The most BatchGetItem or BatchWriteItem requests a batch operation keeps in flight at once. The default is 4.
+ */
+@property (nonatomic, assign) NSUInteger maximumConcurrentBatchRequests;
+
+/**
+ How many times a batch request is sent again for the items DynamoDB returned as unprocessed. Items still unprocessed after the last retry fail with `AWSDynamoDBObjectMapperErrorUnprocessedItem`. The default is 8.
+ */
+@property (nonatomic, assign) NSUInteger maximumBatchRetryCount;
+
+/**
+ The most segments `parallelScan:` scans at once. The default is 4.
+ */
+@property (nonatomic, assign) NSUInteger maximumConcurrentScanSegments;
+
+/**
+ When set to `YES`, the `AWSDynamoDBPaginatedOutput` of a query or scan requests the page after the one it holds as soon as that page arrives, so that `loadNextPage` can usually finish without waiting for the network. At most one page is read ahead. The default is `NO`.
+ */
+@property (nonatomic, assign) BOOL prefetchesNextPage;
+
+@end
+
+/**
+ The outcome of one model of a batch operation.
+ */
+@interface AWSDynamoDBObjectMapperBatchResult : NSObject
+
+/**
+ The model passed to the batch operation.
+ */
+@property (nonatomic, strong, readonly) AWSDynamoDBObjectModel<AWSDynamoDBModeling> *model;
+
+/**
+ For `batchLoad:`, the object with the key of `model`, or `nil` if no such object exists. Always `nil` for `batchSave:` and `batchRemove:`.
+ */
+@property (nonatomic, strong, readonly, nullable) __kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *loadedModel;
+
+/**
+ An error object that indicates why the model was not processed, or `nil` if it was.
+ */
+@property (nonatomic, strong, readonly, nullable) NSError *error;
+
 @end
 
 /**
@@ -718,6 +983,11 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
  */
 - (void)reloadWithCompletionHandler:(void (^ _Nullable)(NSError * _Nullable error))completionHandler;
 
+/**
+ Cancels the request for the page being read ahead, if `prefetchesNextPage` was set. The next call to `loadNextPage` requests the page again. It is also cancelled by `reload` and when the paginated output is deallocated.
+ */
+- (void)cancelPrefetch;
+
 @end
 
 NS_ASSUME_NONNULL_END
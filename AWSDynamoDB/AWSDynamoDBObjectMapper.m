@@ -19,11 +19,48 @@
 #import "AWSCocoaLumberjack.h"
 #import "AWSSynchronizedMutableDictionary.h"
 #import "AWSCategory.h"
+#import "AWSDynamoDBObjectMapperCodec.h"
 
 static NSString *const AWSInfoDynamoDBObjectMapper = @"DynamoDBObjectMapper";
 
 static const NSString *AWSDynamoDBObjectMapperHashKeyAttributePlaceHolder = @":awsddbomhashvalueplaceholder";
+static NSString *const AWSDynamoDBObjectMapperTargetPrefix = @"DynamoDB_20120810";
 NSString *const AWSDynamoDBObjectMapperUserAgent = @"mapper";
+NSString *const AWSDynamoDBObjectMapperErrorDomain = @"com.amazonaws.AWSDynamoDBObjectMapperErrorDomain";
+
+// The most keys one BatchGetItem request may read, and the most items one BatchWriteItem request may write.
+static const NSUInteger AWSDynamoDBObjectMapperBatchGetItemLimit = 100;
+static const NSUInteger AWSDynamoDBObjectMapperBatchWriteItemLimit = 25;
+
+static const NSUInteger AWSDynamoDBObjectMapperDefaultMaximumConcurrentBatchRequests = 4;
+static const NSUInteger AWSDynamoDBObjectMapperDefaultMaximumBatchRetryCount = 8;
+static const NSUInteger AWSDynamoDBObjectMapperDefaultMaximumConcurrentScanSegments = 4;
+static const int AWSDynamoDBObjectMapperBatchRetryBaseDelay = 50;
+static const int AWSDynamoDBObjectMapperBatchRetryMaximumDelay = 10000;
+
+typedef NS_ENUM(NSInteger, AWSDynamoDBObjectMapperBatchOperation) {
+    AWSDynamoDBObjectMapperBatchOperationLoad,
+    AWSDynamoDBObjectMapperBatchOperationSave,
+    AWSDynamoDBObjectMapperBatchOperationRemove,
+};
+
+// Copies a query or scan input for one page request. The copy gets its own networking request, so that cancelling the
+// request for one page does not cancel the next.
+static id AWSDynamoDBObjectMapperCopyPageInput(AWSRequest *input) {
+    NSMutableDictionary *dictionaryValue = [[input dictionaryValue] mutableCopy];
+    [dictionaryValue removeObjectForKey:@"internalRequest"];
+    return [[[input class] alloc] initWithDictionary:dictionaryValue error:nil];
+}
+
+// Exponential backoff with jitter, in milliseconds: half of each delay is fixed and the other half random, so that
+// batches throttled together do not retry together.
+static int AWSDynamoDBObjectMapperBatchRetryDelay(NSUInteger attempt) {
+    int delay = AWSDynamoDBObjectMapperBatchRetryMaximumDelay;
+    if (attempt < 16) {
+        delay = MIN(AWSDynamoDBObjectMapperBatchRetryBaseDelay << attempt, AWSDynamoDBObjectMapperBatchRetryMaximumDelay);
+    }
+    return delay / 2 + (int)arc4random_uniform(delay / 2 + 1);
+}
 
 @interface NSString (AWSDynamoDBObjectMapperSaveBehavior)
 
@@ -53,71 +90,68 @@ NSString *const AWSDynamoDBObjectMapperUserAgent = @"mapper";
 
 @end
 
-@interface NSObject (AWSDynamoDBObjectMapper)
-
-- (NSString *)aws_hashKeyAttributeForClass:(Class)class;
+@interface AWSDynamoDBObjectModel ()
 
-- (NSString *)aws_rangeKeyAttributeForClass:(Class)class;
+- (NSDictionary *)itemForPutItemInput;
+- (NSDictionary *)itemForUpdateItemInput:(AWSDynamoDBObjectMapperSaveBehavior)behavior;
+- (NSDictionary *)key;
 
 @end
 
-@implementation NSObject (AWSDynamoDBObjectMapper)
+@interface AWSDynamoDBPaginatedOutput()
 
-- (NSString *)aws_hashKeyAttributeForClass:(Class)class {
-    NSString *hashKeyAttribute = nil;
+@property (nonatomic, strong) NSArray *items;
+@property (nonatomic, strong, nullable) NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *lastEvaluatedKey;
 
-    NSDictionary *JSONKeyPathsByPropertyKey = nil;
-    if ([class respondsToSelector:@selector(JSONKeyPathsByPropertyKey)]) {
-        JSONKeyPathsByPropertyKey = [class performSelector:@selector(JSONKeyPathsByPropertyKey)];
-    }
+@property (nonatomic, weak) AWSDynamoDBObjectMapper *dynamoDBObjectMapper;
+@property (nonatomic, assign) Class resultClass;
+@property (nonatomic, strong) AWSDynamoDBScanInput *scanInput;
+@property (nonatomic, strong) AWSDynamoDBQueryInput *queryInput;
 
-    if ([class respondsToSelector:@selector(hashKeyAttribute)]) {
-        hashKeyAttribute = [class performSelector:@selector(hashKeyAttribute)];
-        if ([JSONKeyPathsByPropertyKey objectForKey:hashKeyAttribute]) {
-            hashKeyAttribute = [JSONKeyPathsByPropertyKey objectForKey:hashKeyAttribute];
-        }
-    }
+@property (nonatomic, assign) BOOL prefetchesNextPage;
+@property (nonatomic, strong, nullable) AWSTask<AWSDynamoDBPaginatedOutput *> *prefetchTask;
+@property (nonatomic, strong, nullable) AWSRequest *prefetchInput;
+@property (nonatomic, strong, nullable) NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *prefetchStartKey;
 
-    return hashKeyAttribute;
-}
+- (void)prefetchNextPage;
 
-- (NSString *)aws_rangeKeyAttributeForClass:(Class)class {
-    NSString *rangeKeyAttribute = nil;
+@end
 
-    NSDictionary *JSONKeyPathsByPropertyKey = nil;
-    if ([class respondsToSelector:@selector(JSONKeyPathsByPropertyKey)]) {
-        JSONKeyPathsByPropertyKey = [class performSelector:@selector(JSONKeyPathsByPropertyKey)];
-    }
+// The shared state of the segments of one parallel scan.
+@interface AWSDynamoDBObjectMapperParallelScan : NSObject
 
-    if ([class respondsToSelector:@selector(rangeKeyAttribute)]) {
-        rangeKeyAttribute = [class performSelector:@selector(rangeKeyAttribute)];
-        if ([JSONKeyPathsByPropertyKey objectForKey:rangeKeyAttribute]) {
-            rangeKeyAttribute = [JSONKeyPathsByPropertyKey objectForKey:rangeKeyAttribute];
-        }
-    }
+@property (nonatomic, assign) Class resultClass;
+@property (nonatomic, strong) AWSDynamoDBScanInput *scanInput;
+@property (nonatomic, assign) NSUInteger totalSegments;
+@property (nonatomic, copy) void (^pageHandler)(NSArray *items, BOOL *stop);
+@property (atomic, strong, nullable) NSError *error;
 
-    return rangeKeyAttribute;
-}
+- (BOOL)takeSegment:(NSUInteger *)segment;
+- (BOOL)beginRequest:(AWSRequest *)request;
+- (void)endRequest:(AWSRequest *)request;
+- (BOOL)deliverItems:(NSArray *)items;
+- (BOOL)isStopped;
+- (void)stop;
 
 @end
 
-@interface AWSDynamoDBObjectModel ()
+@interface AWSDynamoDBObjectMapperBatchResult()
 
-- (NSDictionary *)itemForPutItemInput;
-- (NSDictionary *)itemForUpdateItemInput:(AWSDynamoDBObjectMapperSaveBehavior)behavior;
-- (NSDictionary *)key;
+@property (nonatomic, strong) AWSDynamoDBObjectModel<AWSDynamoDBModeling> *model;
+@property (nonatomic, strong, nullable) __kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *loadedModel;
+@property (nonatomic, strong, nullable) NSError *error;
 
 @end
 
-@interface AWSDynamoDBPaginatedOutput()
+// One key in a batch operation, shared by every model given with that key.
+@interface AWSDynamoDBObjectMapperBatchEntry : NSObject
 
-@property (nonatomic, strong) NSArray *items;
-@property (nonatomic, strong, nullable) NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *lastEvaluatedKey;
+@property (nonatomic, strong) AWSDynamoDBObjectModel<AWSDynamoDBModeling> *model;
+@property (nonatomic, strong) NSString *tableName;
+@property (nonatomic, strong) NSArray *identity;
+@property (nonatomic, strong) NSMutableArray<AWSDynamoDBObjectMapperBatchResult *> *results;
 
-@property (nonatomic, weak) AWSDynamoDBObjectMapper *dynamoDBObjectMapper;
-@property (nonatomic, assign) Class resultClass;
-@property (nonatomic, strong) AWSDynamoDBScanInput *scanInput;
-@property (nonatomic, strong) AWSDynamoDBQueryInput *queryInput;
+- (void)finishWithLoadedModel:(nullable id)loadedModel error:(nullable NSError *)error;
 
 @end
 
@@ -125,21 +159,29 @@ NSString *const AWSDynamoDBObjectMapperUserAgent = @"mapper";
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration;
 
+- (AWSTask *)invokeRequest:(AWSRequest *)request
+               HTTPMethod:(AWSHTTPMethod)HTTPMethod
+                URLString:(NSString *) URLString
+             targetPrefix:(NSString *)targetPrefix
+            operationName:(NSString *)operationName
+              outputClass:(Class)outputClass;
+
 @end
 
 @interface AWSDynamoDBAttributeValue (AWSDynamoDBObjectMapper)
 
 - (void)aws_setAttributeValue:(id)attributeValue;
-- (id)aws_getAttributeValue;
 
 @end
 
 @implementation AWSDynamoDBAttributeValue (AWSDynamoDBObjectMapper)
 
 - (void)aws_setAttributeValue:(id)attributeValue {
-    //doesn't support NULL type yet.
-    //must be ahead of [attributeValue isKindOfClass:[NSNumber class]]
-    if ([attributeValue isKindOfClass:[[NSNumber numberWithBool:YES] class]]) {
+    //NSNull only appears inside lists and maps, where it stands for a NULL attribute value.
+    if (attributeValue == [NSNull null]) {
+        self.NIL = @YES;
+    } else if ([attributeValue isKindOfClass:[[NSNumber numberWithBool:YES] class]]) {
+        //must be ahead of [attributeValue isKindOfClass:[NSNumber class]]
         self.BOOLEAN = attributeValue;
     } else if ([attributeValue isKindOfClass:[NSString class]]) {
         self.S = attributeValue;
@@ -180,47 +222,6 @@ NSString *const AWSDynamoDBObjectMapperUserAgent = @"mapper";
     }
 }
 
-- (id)aws_getAttributeValue {
-    //Does not support self.NIL yet.
-    if (self.BOOLEAN != nil) {
-        return self.BOOLEAN;
-    } else if (self.S) {
-        return self.S;
-    } else if (self.N) {
-        return [NSNumber aws_numberFromString:self.N];
-    } else if (self.B) {
-        return self.B;
-    } else if (self.SS) {
-        return [NSSet setWithArray:self.SS];
-    } else if (self.NS) {
-        NSMutableSet *mutableSet = [NSMutableSet new];
-        [self.NS enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
-            [mutableSet addObject:[NSNumber aws_numberFromString:obj]];
-        }];
-
-        return mutableSet;
-    } else if (self.BS) {
-        return [NSSet setWithArray:self.BS];
-    } else if (self.L) {
-        NSMutableArray *list = [NSMutableArray arrayWithCapacity:self.L.count];
-        for (id listItemAttributeValue in self.L) {
-            [list addObject: [listItemAttributeValue aws_getAttributeValue]];
-        }
-        return list;
-
-    } else if (self.M) {
-        NSMutableDictionary *map = [NSMutableDictionary dictionaryWithCapacity:self.M.count];
-        for (NSString *entryAttributeKey in self.M) {
-            id entryAttributeValue = self.M[entryAttributeKey];
-            [map setObject:[entryAttributeValue aws_getAttributeValue]
-                    forKey:entryAttributeKey];
-        }
-        return map;
-    }
-
-    return nil;
-}
-
 @end
 
 @interface AWSDynamoDBObjectMapper()
@@ -229,9 +230,11 @@ NSString *const AWSDynamoDBObjectMapperUserAgent = @"mapper";
 @property (nonatomic, strong) AWSDynamoDBObjectMapperConfiguration *objectMapperConfiguration;
 
 - (AWSTask<AWSDynamoDBPaginatedOutput *> *)query:(Class)resultClass
-                                      queryInput:(AWSDynamoDBQueryInput *)queryInput;
+                                      queryInput:(AWSDynamoDBQueryInput *)queryInput
+                              prefetchesNextPage:(BOOL)prefetchesNextPage;
 - (AWSTask<AWSDynamoDBPaginatedOutput *> *)scan:(Class)resultClass
-                                      scanInput:(AWSDynamoDBScanInput *)scanInput;
+                                      scanInput:(AWSDynamoDBScanInput *)scanInput
+                             prefetchesNextPage:(BOOL)prefetchesNextPage;
 
 @end
 
@@ -453,13 +456,15 @@ completionHandler:completionHandler];
 
     NSMutableDictionary *key = [NSMutableDictionary new];
 
-    NSString *hashKeyAttribute = [self aws_hashKeyAttributeForClass:resultClass];
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:resultClass];
+
+    NSString *hashKeyAttribute = codec.hashKeyAttribute;
     AWSDynamoDBAttributeValue *hashAttributeValue = [AWSDynamoDBAttributeValue new];
     [hashAttributeValue aws_setAttributeValue:hashKey];
     [key setObject:hashAttributeValue
             forKey:hashKeyAttribute];
 
-    NSString *rangeKeyAttribute = [self aws_rangeKeyAttributeForClass:resultClass];
+    NSString *rangeKeyAttribute = codec.rangeKeyAttribute;
     if (rangeKeyAttribute) {
         AWSDynamoDBAttributeValue *rangeKeyAttributeValue = [AWSDynamoDBAttributeValue new];
         [rangeKeyAttributeValue aws_setAttributeValue:rangeKey];
@@ -468,17 +473,15 @@ completionHandler:completionHandler];
     }
     getItemInput.key = key;
 
-    return [[self.dynamoDB getItem:getItemInput] continueWithSuccessBlock:^id(AWSTask *task) {
-        AWSDynamoDBGetItemOutput *getItemOutput = task.result;
+    return [[self JSONResponseForRequest:getItemInput
+                           operationName:@"GetItem"] continueWithSuccessBlock:^id(AWSTask *task) {
+        NSDictionary *item = [task.result objectForKey:@"Item"];
 
         NSError *error = nil;
-        NSDictionary *itemsDictionary = [self removeAttributes:getItemOutput.item];
-
         id responseObject = nil;
-        if ([itemsDictionary count] > 0) {
-            responseObject = [AWSMTLJSONAdapter modelOfClass:resultClass
-                                          fromJSONDictionary:itemsDictionary
-                                                       error:&error];
+        if ([item isKindOfClass:[NSDictionary class]] && [item count] > 0) {
+            responseObject = [codec modelFromJSONItem:item
+                                                error:&error];
             if (error) {
                 return [AWSTask taskWithError:error];
             }
@@ -540,7 +543,7 @@ completionHandler:completionHandler];
         NSString *hashKeyAttribute = expression.hashKeyAttribute;
         if (hashKeyAttribute == nil) {
             //if it is nil, use table's hashKeyAttribute
-            hashKeyAttribute = [self aws_hashKeyAttributeForClass:resultClass];
+            hashKeyAttribute = [AWSDynamoDBObjectMapperCodec codecForClass:resultClass].hashKeyAttribute;
         }
 
         AWSDynamoDBAttributeValue *hashAttributeValue = [AWSDynamoDBAttributeValue new];
@@ -580,36 +583,34 @@ completionHandler:completionHandler];
     queryInput.projectionExpression = expression.projectionExpression;
 
     return [self query:resultClass
-            queryInput:queryInput];
+            queryInput:queryInput
+    prefetchesNextPage:configuration.prefetchesNextPage];
 }
 
 // Internal class
 - (AWSTask<AWSDynamoDBPaginatedOutput *> *)query:(Class)resultClass
-                                      queryInput:(AWSDynamoDBQueryInput *)queryInput {
-    return [[self.dynamoDB query:queryInput] continueWithSuccessBlock:^id(AWSTask *task) {
-        AWSDynamoDBQueryOutput *queryOutput = task.result;
-
-        NSMutableArray *items = [NSMutableArray new];
+                                      queryInput:(AWSDynamoDBQueryInput *)queryInput
+                              prefetchesNextPage:(BOOL)prefetchesNextPage {
+    return [[self JSONResponseForRequest:queryInput
+                           operationName:@"Query"] continueWithSuccessBlock:^id(AWSTask *task) {
         NSError *error = nil;
-        for (id item in queryOutput.items) {
-
-            NSDictionary *itemsDictionary = [self removeAttributes:item];
-
-            id responseObject = [AWSMTLJSONAdapter modelOfClass:resultClass
-                                             fromJSONDictionary:itemsDictionary
-                                                          error:&error];
-            if (error) {
-                return [AWSTask taskWithError:error];
-            }
-            [items addObject:responseObject];
+        NSArray *items = [self modelsOfClass:resultClass
+                               fromJSONItems:[task.result objectForKey:@"Items"]
+                                       error:&error];
+        if (!items) {
+            return [AWSTask taskWithError:error ?: [NSError errorWithDomain:AWSDynamoDBErrorDomain
+                                                                       code:AWSDynamoDBErrorUnknown
+                                                                   userInfo:nil]];
         }
 
         AWSDynamoDBPaginatedOutput *paginatedOutput = [AWSDynamoDBPaginatedOutput new];
         paginatedOutput.items = items;
-        paginatedOutput.lastEvaluatedKey = queryOutput.lastEvaluatedKey;
+        paginatedOutput.lastEvaluatedKey = [self lastEvaluatedKeyFromJSONResponse:task.result];
         paginatedOutput.dynamoDBObjectMapper = self;
         paginatedOutput.resultClass = resultClass;
         paginatedOutput.queryInput = queryInput;
+        paginatedOutput.prefetchesNextPage = prefetchesNextPage;
+        [paginatedOutput prefetchNextPage];
 
         return paginatedOutput;
     }];
@@ -651,6 +652,14 @@ completionHandler:completionHandler];
 - (AWSTask<AWSDynamoDBPaginatedOutput *> *)scan:(Class)resultClass
                                      expression:(AWSDynamoDBScanExpression *)expression
                                   configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    return [self scan:resultClass
+            scanInput:[self scanInputForClass:resultClass expression:expression]
+   prefetchesNextPage:configuration.prefetchesNextPage];
+}
+
+// Internal method
+- (AWSDynamoDBScanInput *)scanInputForClass:(Class)resultClass
+                                 expression:(AWSDynamoDBScanExpression *)expression {
     AWSDynamoDBScanInput *scanInput = [AWSDynamoDBScanInput new];
     scanInput.tableName = [resultClass performSelector:@selector(dynamoDBTableName)];
     scanInput.limit = expression.limit;
@@ -676,36 +685,33 @@ completionHandler:completionHandler];
     scanInput.projectionExpression = expression.projectionExpression;
     scanInput.expressionAttributeNames = expression.expressionAttributeNames;
 
-    return [self scan:resultClass
-            scanInput:scanInput];
+    return scanInput;
 }
 
 // Internal class
 - (AWSTask<AWSDynamoDBPaginatedOutput *> *)scan:(Class)resultClass
-                                      scanInput:(AWSDynamoDBScanInput *)scanInput {
-    return [[self.dynamoDB scan:scanInput] continueWithSuccessBlock:^id(AWSTask *task) {
-        AWSDynamoDBScanOutput *scanOutput = task.result;
-
-        NSMutableArray *items = [NSMutableArray new];
+                                      scanInput:(AWSDynamoDBScanInput *)scanInput
+                             prefetchesNextPage:(BOOL)prefetchesNextPage {
+    return [[self JSONResponseForRequest:scanInput
+                           operationName:@"Scan"] continueWithSuccessBlock:^id(AWSTask *task) {
         NSError *error = nil;
-        for (id item in scanOutput.items) {
-
-            NSDictionary *itemsDictionary = [self removeAttributes:item];
-            id responseObject = [AWSMTLJSONAdapter modelOfClass:resultClass
-                                             fromJSONDictionary:itemsDictionary
-                                                          error:&error];
-            if (error) {
-                return [AWSTask taskWithError:error];
-            }
-            [items addObject:responseObject];
+        NSArray *items = [self modelsOfClass:resultClass
+                               fromJSONItems:[task.result objectForKey:@"Items"]
+                                       error:&error];
+        if (!items) {
+            return [AWSTask taskWithError:error ?: [NSError errorWithDomain:AWSDynamoDBErrorDomain
+                                                                       code:AWSDynamoDBErrorUnknown
+                                                                   userInfo:nil]];
         }
 
         AWSDynamoDBPaginatedOutput *paginatedOutput = [AWSDynamoDBPaginatedOutput new];
         paginatedOutput.items = items;
-        paginatedOutput.lastEvaluatedKey = scanOutput.lastEvaluatedKey;
+        paginatedOutput.lastEvaluatedKey = [self lastEvaluatedKeyFromJSONResponse:task.result];
         paginatedOutput.dynamoDBObjectMapper = self;
         paginatedOutput.resultClass = resultClass;
         paginatedOutput.scanInput = scanInput;
+        paginatedOutput.prefetchesNextPage = prefetchesNextPage;
+        [paginatedOutput prefetchNextPage];
 
         return paginatedOutput;
     }];
@@ -728,149 +734,608 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
     }];
 }
 
-#pragma mark - Utility
+#pragma mark - Parallel scan
+
+- (AWSTask *)parallelScan:(Class)resultClass
+               expression:(AWSDynamoDBScanExpression *)expression
+            totalSegments:(NSUInteger)totalSegments
+        cancellationToken:(AWSCancellationToken *)cancellationToken
+              pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler {
+    return [self parallelScan:resultClass
+                   expression:expression
+                totalSegments:totalSegments
+                configuration:self.objectMapperConfiguration
+            cancellationToken:cancellationToken
+                  pageHandler:pageHandler];
+}
 
-- (NSDictionary *)removeAttributes:(NSDictionary *)item {
-    NSMutableDictionary *mutableItem = [NSMutableDictionary new];
-    [item enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
-        if ([obj respondsToSelector:@selector(aws_getAttributeValue)]) {
-            id value = [obj aws_getAttributeValue];
-            if (value) {
-                [mutableItem setObject:value
-                                forKey:key];
-            }
-        }
+- (void)parallelScan:(Class)resultClass
+          expression:(AWSDynamoDBScanExpression *)expression
+       totalSegments:(NSUInteger)totalSegments
+   cancellationToken:(AWSCancellationToken *)cancellationToken
+         pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler
+   completionHandler:(void (^ _Nullable)(NSError * _Nullable error))completionHandler {
+    [self parallelScan:resultClass
+            expression:expression
+         totalSegments:totalSegments
+         configuration:self.objectMapperConfiguration
+     cancellationToken:cancellationToken
+           pageHandler:pageHandler
+     completionHandler:completionHandler];
+}
+
+- (AWSTask *)parallelScan:(Class)resultClass
+               expression:(AWSDynamoDBScanExpression *)expression
+            totalSegments:(NSUInteger)totalSegments
+            configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration
+        cancellationToken:(AWSCancellationToken *)cancellationToken
+              pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler {
+    if (cancellationToken.isCancellationRequested) {
+        return [AWSTask cancelledTask];
+    }
+    configuration = configuration ?: self.objectMapperConfiguration;
+
+    AWSDynamoDBObjectMapperParallelScan *parallelScan = [AWSDynamoDBObjectMapperParallelScan new];
+    parallelScan.resultClass = resultClass;
+    parallelScan.scanInput = [self scanInputForClass:resultClass expression:expression];
+    parallelScan.scanInput.exclusiveStartKey = nil;
+    parallelScan.totalSegments = MAX(totalSegments, 1);
+    parallelScan.pageHandler = pageHandler;
+
+    AWSCancellationTokenRegistration *registration = [cancellationToken registerCancellationObserverWithBlock:^{
+        [parallelScan stop];
     }];
 
-    return mutableItem;
+    NSUInteger workerCount = MIN(MAX(configuration.maximumConcurrentScanSegments, 1), parallelScan.totalSegments);
+    NSMutableArray<AWSTask *> *workers = [NSMutableArray arrayWithCapacity:workerCount];
+    for (NSUInteger i = 0; i < workerCount; i++) {
+        [workers addObject:[self scanNextSegmentOfParallelScan:parallelScan]];
+    }
+
+    return [[AWSTask taskForCompletionOfAllTasks:workers] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        [registration dispose];
+        if (parallelScan.error) {
+            return [AWSTask taskWithError:parallelScan.error];
+        }
+        if (cancellationToken.isCancellationRequested) {
+            return [AWSTask cancelledTask];
+        }
+        return nil;
+    }];
 }
 
-@end
+- (void)parallelScan:(Class)resultClass
+          expression:(AWSDynamoDBScanExpression *)expression
+       totalSegments:(NSUInteger)totalSegments
+       configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration
+   cancellationToken:(AWSCancellationToken *)cancellationToken
+         pageHandler:(void (^)(NSArray<__kindof AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *items, BOOL *stop))pageHandler
+   completionHandler:(void (^ _Nullable)(NSError * _Nullable error))completionHandler {
+    [[self parallelScan:resultClass
+             expression:expression
+          totalSegments:totalSegments
+          configuration:configuration
+      cancellationToken:cancellationToken
+            pageHandler:pageHandler] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        if (completionHandler) {
+            completionHandler(task.error);
+        }
+        return nil;
+    }];
+}
 
-@implementation AWSDynamoDBObjectModel
+// Scans segments one after another until none are left. Several of these run at once.
+- (AWSTask *)scanNextSegmentOfParallelScan:(AWSDynamoDBObjectMapperParallelScan *)parallelScan {
+    NSUInteger segment = 0;
+    if (![parallelScan takeSegment:&segment]) {
+        return [AWSTask taskWithResult:nil];
+    }
 
-+ (NSDictionary *)JSONKeyPathsByPropertyKey {
-    return nil;
+    return [[self scanSegment:segment
+            exclusiveStartKey:nil
+                 parallelScan:parallelScan] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        return [self scanNextSegmentOfParallelScan:parallelScan];
+    }];
 }
 
-- (NSDictionary *)removeIgnoredAttributesFromJSONDictionary:(NSDictionary *)JSONDictionary {
-    if ([[self class] respondsToSelector:@selector(ignoreAttributes)] == NO) {
-        return JSONDictionary;
+- (AWSTask *)scanSegment:(NSUInteger)segment
+       exclusiveStartKey:(NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *)exclusiveStartKey
+            parallelScan:(AWSDynamoDBObjectMapperParallelScan *)parallelScan {
+    AWSDynamoDBScanInput *scanInput = AWSDynamoDBObjectMapperCopyPageInput(parallelScan.scanInput);
+    scanInput.segment = @(segment);
+    scanInput.totalSegments = @(parallelScan.totalSegments);
+    scanInput.exclusiveStartKey = exclusiveStartKey;
+    if (![parallelScan beginRequest:scanInput]) {
+        return [AWSTask taskWithResult:nil];
     }
 
-    NSArray *ignoredAttrArray = [[self class] performSelector:@selector(ignoreAttributes)];
-    NSMutableDictionary *resultDictionary = [JSONDictionary mutableCopy];
-    [resultDictionary removeObjectsForKeys:ignoredAttrArray];
-    return resultDictionary;
+    return [[self scan:parallelScan.resultClass
+             scanInput:scanInput
+    prefetchesNextPage:NO] continueWithBlock:^id _Nullable(AWSTask<AWSDynamoDBPaginatedOutput *> * _Nonnull task) {
+        [parallelScan endRequest:scanInput];
+        if ([parallelScan isStopped]) {
+            return nil;
+        }
+        if (task.error) {
+            parallelScan.error = task.error;
+            [parallelScan stop];
+            return nil;
+        }
+
+        AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
+        if (![parallelScan deliverItems:paginatedOutput.items] || !paginatedOutput.lastEvaluatedKey) {
+            return nil;
+        }
+        return [self scanSegment:segment
+               exclusiveStartKey:paginatedOutput.lastEvaluatedKey
+                    parallelScan:parallelScan];
+    }];
 }
 
-- (NSDictionary *)itemForPutItemInput {
-    NSMutableDictionary *item = [NSMutableDictionary new];
-    NSMutableArray *keyArray = [NSMutableArray new];
+#pragma mark - Batch operations
 
-    NSString *hashKeyAttribute = [self aws_hashKeyAttributeForClass:[self class]];
-    [keyArray addObject:hashKeyAttribute];
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models {
+    return [self batchLoad:models
+             configuration:self.objectMapperConfiguration];
+}
 
-    NSString *rangeKeyAttribute = [self aws_rangeKeyAttributeForClass:[self class]];
-    if (rangeKeyAttribute) {
-        [keyArray addObject:rangeKeyAttribute];
+- (void)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [self batchLoad:models configuration:self.objectMapperConfiguration completionHandler:completionHandler];
+}
+
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                           configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    return [self batch:AWSDynamoDBObjectMapperBatchOperationLoad
+                models:models
+         configuration:configuration ?: self.objectMapperConfiguration];
+}
+
+- (void)batchLoad:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+    configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [[self batchLoad:models
+       configuration:configuration] continueWithBlock:^id _Nullable(AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> * _Nonnull task) {
+        if (completionHandler) {
+            completionHandler(task.result, task.error);
+        }
+        return nil;
+    }];
+}
+
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models {
+    return [self batchSave:models
+             configuration:self.objectMapperConfiguration];
+}
+
+- (void)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [self batchSave:models configuration:self.objectMapperConfiguration completionHandler:completionHandler];
+}
+
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                           configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    return [self batch:AWSDynamoDBObjectMapperBatchOperationSave
+                models:models
+         configuration:configuration ?: self.objectMapperConfiguration];
+}
+
+- (void)batchSave:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+    configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration
+completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [[self batchSave:models
+       configuration:configuration] continueWithBlock:^id _Nullable(AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> * _Nonnull task) {
+        if (completionHandler) {
+            completionHandler(task.result, task.error);
+        }
+        return nil;
+    }];
+}
+
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models {
+    return [self batchRemove:models
+               configuration:self.objectMapperConfiguration];
+}
+
+- (void)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+  completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [self batchRemove:models configuration:self.objectMapperConfiguration completionHandler:completionHandler];
+}
+
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                             configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    return [self batch:AWSDynamoDBObjectMapperBatchOperationRemove
+                models:models
+         configuration:configuration ?: self.objectMapperConfiguration];
+}
+
+- (void)batchRemove:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+      configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration
+  completionHandler:(void (^ _Nullable)(NSArray<AWSDynamoDBObjectMapperBatchResult *> * _Nullable results, NSError * _Nullable error))completionHandler {
+    [[self batchRemove:models
+         configuration:configuration] continueWithBlock:^id _Nullable(AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> * _Nonnull task) {
+        if (completionHandler) {
+            completionHandler(task.result, task.error);
+        }
+        return nil;
+    }];
+}
+
+// Internal method
+- (AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)batch:(AWSDynamoDBObjectMapperBatchOperation)operation
+                                                              models:(NSArray<AWSDynamoDBObjectModel<AWSDynamoDBModeling> *> *)models
+                                                       configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    // DynamoDB rejects a batch that names the same key twice, so models with the same key share one entry. For saves,
+    // the last model wins, as it would if the models were saved one by one.
+    NSMutableArray<AWSDynamoDBObjectMapperBatchResult *> *results = [NSMutableArray arrayWithCapacity:[models count]];
+    NSMutableArray<AWSDynamoDBObjectMapperBatchEntry *> *entries = [NSMutableArray new];
+    NSMutableDictionary<NSArray *, AWSDynamoDBObjectMapperBatchEntry *> *entriesByIdentity = [NSMutableDictionary new];
+    for (AWSDynamoDBObjectModel<AWSDynamoDBModeling> *model in models) {
+        AWSDynamoDBObjectMapperBatchResult *result = [AWSDynamoDBObjectMapperBatchResult new];
+        result.model = model;
+        [results addObject:result];
+
+        NSString *tableName = [[model class] dynamoDBTableName];
+        AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[model class]];
+        NSArray *identity = [self batchIdentityForTable:tableName
+                                              hashValue:[codec valueForAttribute:codec.hashKeyAttribute ofModel:model]
+                                             rangeValue:codec.rangeKeyAttribute ? [codec valueForAttribute:codec.rangeKeyAttribute ofModel:model] : nil];
+
+        AWSDynamoDBObjectMapperBatchEntry *entry = entriesByIdentity[identity];
+        if (!entry) {
+            entry = [AWSDynamoDBObjectMapperBatchEntry new];
+            entry.tableName = tableName;
+            entry.identity = identity;
+            entry.results = [NSMutableArray new];
+            entriesByIdentity[identity] = entry;
+            [entries addObject:entry];
+        }
+        entry.model = model;
+        [entry.results addObject:result];
     }
 
-    NSDictionary *dictionaryValue = [AWSMTLJSONAdapter JSONDictionaryFromModel:self];
-    dictionaryValue = [self removeIgnoredAttributesFromJSONDictionary:dictionaryValue];
+    NSUInteger batchSize = operation == AWSDynamoDBObjectMapperBatchOperationLoad ? AWSDynamoDBObjectMapperBatchGetItemLimit : AWSDynamoDBObjectMapperBatchWriteItemLimit;
+    NSMutableArray<NSArray<AWSDynamoDBObjectMapperBatchEntry *> *> *pendingBatches = [NSMutableArray new];
+    for (NSUInteger location = 0; location < [entries count]; location += batchSize) {
+        [pendingBatches addObject:[entries subarrayWithRange:NSMakeRange(location, MIN(batchSize, [entries count] - location))]];
+    }
 
-    for (id key in dictionaryValue) {
-        if ([keyArray containsObject:key]) {
-            // For key attributes
-            AWSDynamoDBAttributeValue *keyAttributeValue = [AWSDynamoDBAttributeValue new];
-            [keyAttributeValue aws_setAttributeValue:dictionaryValue[key]];
-            item[key] = keyAttributeValue;
-        } else if (dictionaryValue[key]) {
-            // For other attributes
-            if (dictionaryValue[key] == [NSNull null]) {
-                //when doing a putItem, we can safely ignore the null-valvued attributes
+    NSUInteger workerCount = MIN(MAX(configuration.maximumConcurrentBatchRequests, 1), [pendingBatches count]);
+    NSMutableArray<AWSTask *> *workers = [NSMutableArray arrayWithCapacity:workerCount];
+    for (NSUInteger i = 0; i < workerCount; i++) {
+        [workers addObject:[self sendPendingBatches:pendingBatches
+                                          operation:operation
+                                      configuration:configuration]];
+    }
+
+    return [[AWSTask taskForCompletionOfAllTasks:workers] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        return results;
+    }];
+}
+
+// Sends the pending batches one after another until none are left. Several of these run at once.
+- (AWSTask *)sendPendingBatches:(NSMutableArray<NSArray<AWSDynamoDBObjectMapperBatchEntry *> *> *)pendingBatches
+                      operation:(AWSDynamoDBObjectMapperBatchOperation)operation
+                  configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    NSArray<AWSDynamoDBObjectMapperBatchEntry *> *batch = nil;
+    @synchronized(pendingBatches) {
+        batch = [pendingBatches firstObject];
+        if (batch) {
+            [pendingBatches removeObjectAtIndex:0];
+        }
+    }
+    if (!batch) {
+        return [AWSTask taskWithResult:nil];
+    }
+
+    return [[self sendBatch:batch
+                  operation:operation
+                    attempt:0
+              configuration:configuration] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        return [self sendPendingBatches:pendingBatches
+                              operation:operation
+                          configuration:configuration];
+    }];
+}
+
+- (AWSTask *)sendBatch:(NSArray<AWSDynamoDBObjectMapperBatchEntry *> *)batch
+             operation:(AWSDynamoDBObjectMapperBatchOperation)operation
+               attempt:(NSUInteger)attempt
+         configuration:(AWSDynamoDBObjectMapperConfiguration *)configuration {
+    AWSTask<NSDictionary *> *responseTask = nil;
+    if (operation == AWSDynamoDBObjectMapperBatchOperationLoad) {
+        NSMutableDictionary<NSString *, AWSDynamoDBKeysAndAttributes *> *requestItems = [NSMutableDictionary new];
+        for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+            AWSDynamoDBKeysAndAttributes *keysAndAttributes = requestItems[entry.tableName];
+            if (!keysAndAttributes) {
+                keysAndAttributes = [AWSDynamoDBKeysAndAttributes new];
+                keysAndAttributes.keys = [NSMutableArray new];
+                keysAndAttributes.consistentRead = configuration.consistentRead;
+                requestItems[entry.tableName] = keysAndAttributes;
+            }
+            [(NSMutableArray *)keysAndAttributes.keys addObject:[entry.model key]];
+        }
+
+        AWSDynamoDBBatchGetItemInput *batchGetItemInput = [AWSDynamoDBBatchGetItemInput new];
+        batchGetItemInput.requestItems = requestItems;
+        responseTask = [self JSONResponseForRequest:batchGetItemInput
+                                      operationName:@"BatchGetItem"];
+    } else {
+        NSMutableDictionary<NSString *, NSMutableArray<AWSDynamoDBWriteRequest *> *> *requestItems = [NSMutableDictionary new];
+        for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+            AWSDynamoDBWriteRequest *writeRequest = [AWSDynamoDBWriteRequest new];
+            if (operation == AWSDynamoDBObjectMapperBatchOperationSave) {
+                writeRequest.putRequest = [AWSDynamoDBPutRequest new];
+                writeRequest.putRequest.item = [entry.model itemForPutItemInput];
             } else {
-                AWSDynamoDBAttributeValue *attributeValue = [AWSDynamoDBAttributeValue new];
-                [attributeValue aws_setAttributeValue:dictionaryValue[key]];
-                item[key] = attributeValue;
+                writeRequest.deleteRequest = [AWSDynamoDBDeleteRequest new];
+                writeRequest.deleteRequest.key = [entry.model key];
+            }
+
+            if (!requestItems[entry.tableName]) {
+                requestItems[entry.tableName] = [NSMutableArray new];
             }
+            [requestItems[entry.tableName] addObject:writeRequest];
         }
+
+        AWSDynamoDBBatchWriteItemInput *batchWriteItemInput = [AWSDynamoDBBatchWriteItemInput new];
+        batchWriteItemInput.requestItems = requestItems;
+        responseTask = [self JSONResponseForRequest:batchWriteItemInput
+                                      operationName:@"BatchWriteItem"];
+    }
+
+    return [responseTask continueWithBlock:^id _Nullable(AWSTask<NSDictionary *> * _Nonnull task) {
+        if (task.error) {
+            for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+                [entry finishWithLoadedModel:nil error:task.error];
+            }
+            return nil;
+        }
+
+        NSMutableDictionary<NSArray *, AWSDynamoDBObjectMapperBatchEntry *> *batchByIdentity = [NSMutableDictionary dictionaryWithCapacity:[batch count]];
+        for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+            batchByIdentity[entry.identity] = entry;
+        }
+
+        NSSet<NSArray *> *unprocessedIdentities = nil;
+        if (operation == AWSDynamoDBObjectMapperBatchOperationLoad) {
+            NSDictionary<NSString *, NSArray *> *responses = [task.result objectForKey:@"Responses"];
+            for (NSString *tableName in responses) {
+                for (NSDictionary *JSONItem in responses[tableName]) {
+                    AWSDynamoDBObjectMapperBatchEntry *entry = batchByIdentity[[self batchIdentityForTable:tableName
+                                                                                                   JSONItem:JSONItem
+                                                                                                      batch:batch]];
+                    NSError *error = nil;
+                    id loadedModel = [[AWSDynamoDBObjectMapperCodec codecForClass:[entry.model class]] modelFromJSONItem:JSONItem
+                                                                                                                   error:&error];
+                    [entry finishWithLoadedModel:loadedModel error:error];
+                }
+            }
+
+            NSDictionary<NSString *, NSDictionary *> *unprocessedKeys = [task.result objectForKey:@"UnprocessedKeys"];
+            NSMutableSet *identities = [NSMutableSet new];
+            for (NSString *tableName in unprocessedKeys) {
+                for (NSDictionary *JSONKey in [unprocessedKeys[tableName] objectForKey:@"Keys"]) {
+                    [identities addObject:[self batchIdentityForTable:tableName JSONItem:JSONKey batch:batch]];
+                }
+            }
+            unprocessedIdentities = identities;
+        } else {
+            NSDictionary<NSString *, NSArray *> *unprocessedItems = [task.result objectForKey:@"UnprocessedItems"];
+            NSMutableSet *identities = [NSMutableSet new];
+            for (NSString *tableName in unprocessedItems) {
+                for (NSDictionary *JSONWriteRequest in unprocessedItems[tableName]) {
+                    NSDictionary *JSONItem = [[JSONWriteRequest objectForKey:@"PutRequest"] objectForKey:@"Item"]
+                        ?: [[JSONWriteRequest objectForKey:@"DeleteRequest"] objectForKey:@"Key"];
+                    [identities addObject:[self batchIdentityForTable:tableName JSONItem:JSONItem batch:batch]];
+                }
+            }
+            unprocessedIdentities = identities;
+        }
+
+        NSMutableArray<AWSDynamoDBObjectMapperBatchEntry *> *unprocessed = [NSMutableArray new];
+        for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+            if ([unprocessedIdentities containsObject:entry.identity]) {
+                [unprocessed addObject:entry];
+            } else if (operation != AWSDynamoDBObjectMapperBatchOperationLoad) {
+                [entry finishWithLoadedModel:nil error:nil];
+            }
+            // Keys that were neither returned nor left unprocessed have no item, and keep a nil loadedModel.
+        }
+
+        if ([unprocessed count] == 0) {
+            return nil;
+        }
+        if (attempt >= configuration.maximumBatchRetryCount) {
+            NSError *error = [NSError errorWithDomain:AWSDynamoDBObjectMapperErrorDomain
+                                                 code:AWSDynamoDBObjectMapperErrorUnprocessedItem
+                                             userInfo:@{NSLocalizedDescriptionKey : @"DynamoDB did not process the item before the batch retries ran out."}];
+            for (AWSDynamoDBObjectMapperBatchEntry *entry in unprocessed) {
+                [entry finishWithLoadedModel:nil error:error];
+            }
+            return nil;
+        }
+
+        AWSDDLogDebug(@"Retrying %lu unprocessed items of a batch request, attempt %lu.", (unsigned long)[unprocessed count], (unsigned long)attempt + 1);
+        return [[AWSTask taskWithDelay:AWSDynamoDBObjectMapperBatchRetryDelay(attempt)] continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {
+            return [self sendBatch:unprocessed
+                         operation:operation
+                           attempt:attempt + 1
+                     configuration:configuration];
+        }];
+    }];
+}
+
+// Identifies a key by table and key values, so that keys in responses can be matched to the models they were read or
+// written for.
+- (NSArray *)batchIdentityForTable:(NSString *)tableName
+                         hashValue:(id)hashValue
+                        rangeValue:(id)rangeValue {
+    return @[tableName, hashValue ?: [NSNull null], rangeValue ?: [NSNull null]];
+}
+
+- (NSArray *)batchIdentityForTable:(NSString *)tableName
+                          JSONItem:(NSDictionary *)JSONItem
+                             batch:(NSArray<AWSDynamoDBObjectMapperBatchEntry *> *)batch {
+    for (AWSDynamoDBObjectMapperBatchEntry *entry in batch) {
+        if ([entry.tableName isEqualToString:tableName]) {
+            AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[entry.model class]];
+            id hashValue = AWSDynamoDBObjectFromJSONAttributeValue(JSONItem[codec.hashKeyAttribute]);
+            id rangeValue = codec.rangeKeyAttribute ? AWSDynamoDBObjectFromJSONAttributeValue(JSONItem[codec.rangeKeyAttribute]) : nil;
+            return [self batchIdentityForTable:tableName
+                                     hashValue:hashValue
+                                    rangeValue:rangeValue];
+        }
+    }
+    return @[tableName];
+}
+
+#pragma mark - Utility
+
+// Sends a request without mapping the response to an output model, so that items can be decoded straight into
+// `resultClass` instead of going through `AWSDynamoDBAttributeValue`.
+- (AWSTask<NSDictionary *> *)JSONResponseForRequest:(AWSRequest *)request
+                                      operationName:(NSString *)operationName {
+    return [self.dynamoDB invokeRequest:request
+                             HTTPMethod:AWSHTTPMethodPOST
+                              URLString:@""
+                           targetPrefix:AWSDynamoDBObjectMapperTargetPrefix
+                          operationName:operationName
+                            outputClass:nil];
+}
+
+- (NSArray *)modelsOfClass:(Class)resultClass
+             fromJSONItems:(NSArray<NSDictionary *> *)JSONItems
+                     error:(NSError **)error {
+    if (![JSONItems isKindOfClass:[NSArray class]]) {
+        return @[];
     }
 
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:resultClass];
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:[JSONItems count]];
+    for (NSDictionary *JSONItem in JSONItems) {
+        id responseObject = [codec modelFromJSONItem:JSONItem
+                                               error:error];
+        if (!responseObject) {
+            return nil;
+        }
+        [items addObject:responseObject];
+    }
+
+    return items;
+}
+
+- (NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *)lastEvaluatedKeyFromJSONResponse:(NSDictionary *)JSONResponse {
+    NSDictionary *lastEvaluatedKey = [JSONResponse objectForKey:@"LastEvaluatedKey"];
+    if (![lastEvaluatedKey isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+
+    return [AWSModelUtility mapMTLDictionaryFromJSONDictionary:lastEvaluatedKey
+                                                withModelClass:[AWSDynamoDBAttributeValue class]];
+}
+
+@end
+
+@implementation AWSDynamoDBObjectModel
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return nil;
+}
+
+- (NSDictionary *)itemForPutItemInput {
+    NSMutableDictionary *item = [NSMutableDictionary new];
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[self class]];
+
+    [codec enumerateAttributesOfModel:self
+                       includeIgnored:NO
+                           usingBlock:^(NSString *attributeName, id value) {
+        if ([attributeName isEqualToString:codec.hashKeyAttribute]
+            || [attributeName isEqualToString:codec.rangeKeyAttribute]) {
+            // For key attributes
+            AWSDynamoDBAttributeValue *keyAttributeValue = [AWSDynamoDBAttributeValue new];
+            [keyAttributeValue aws_setAttributeValue:value];
+            item[attributeName] = keyAttributeValue;
+        } else if (value) {
+            // For other attributes. When doing a putItem, we can safely ignore the null-valued attributes.
+            AWSDynamoDBAttributeValue *attributeValue = [AWSDynamoDBAttributeValue new];
+            [attributeValue aws_setAttributeValue:value];
+            item[attributeName] = attributeValue;
+        }
+    }];
+
     return item;
 }
 
 - (NSDictionary *)itemForUpdateItemInput:(AWSDynamoDBObjectMapperSaveBehavior)behavior {
     // TODO: update this method to use UpdateExpression instead of AWSDynamoDBAttributeValueUpdate.
     NSMutableDictionary *item = [NSMutableDictionary new];
-    NSArray *keyArray = [[self key] allKeys];
-    NSDictionary *dictionaryValue = [AWSMTLJSONAdapter JSONDictionaryFromModel:self];
-    dictionaryValue = [self removeIgnoredAttributesFromJSONDictionary:dictionaryValue];
-
-    for (id key in dictionaryValue) {
-        if (![keyArray containsObject:key]) {
-            // For other attributes
-
-            if (dictionaryValue[key] == [NSNull null]) {
-                //If attribute value is null
-                if (behavior == AWSDynamoDBObjectMapperSaveBehaviorUpdateSkipNullAttributes
-                    || behavior == AWSDynamoDBObjectMapperSaveBehaviorAppendSet) {
-                    /*
-                     * If UPDATE_SKIP_NULL_ATTRIBUTES or APPEND_SET is
-                     * configured, we don't delete null value attributes.
-                     */
-                } else {
-                    /* Delete attributes that are set as null in the object. */
-                    AWSDynamoDBAttributeValueUpdate *attributeValueUpdate = [AWSDynamoDBAttributeValueUpdate new];
-                    attributeValueUpdate.action = AWSDynamoDBAttributeActionDelete;
-
-                    item[key] = attributeValueUpdate;
-                }
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[self class]];
+
+    [codec enumerateAttributesOfModel:self
+                       includeIgnored:NO
+                           usingBlock:^(NSString *attributeName, id value) {
+        if ([attributeName isEqualToString:codec.hashKeyAttribute]
+            || [attributeName isEqualToString:codec.rangeKeyAttribute]) {
+            return;
+        }
 
+        // For other attributes
+        if (value == nil) {
+            //If attribute value is null
+            if (behavior == AWSDynamoDBObjectMapperSaveBehaviorUpdateSkipNullAttributes
+                || behavior == AWSDynamoDBObjectMapperSaveBehaviorAppendSet) {
+                /*
+                 * If UPDATE_SKIP_NULL_ATTRIBUTES or APPEND_SET is
+                 * configured, we don't delete null value attributes.
+                 */
             } else {
-                //If attribute value is not null
+                /* Delete attributes that are set as null in the object. */
                 AWSDynamoDBAttributeValueUpdate *attributeValueUpdate = [AWSDynamoDBAttributeValueUpdate new];
-                AWSDynamoDBAttributeValue *attributeValue = [AWSDynamoDBAttributeValue new];
-                [attributeValue aws_setAttributeValue:dictionaryValue[key]];
-                attributeValueUpdate.value = attributeValue;
-                if (behavior == AWSDynamoDBObjectMapperSaveBehaviorAppendSet &&
-                    (attributeValue.BS != nil || attributeValue.NS != nil || attributeValue.SS != nil)) {
-
-                    /* If it's a set attribute and the mapper is configured with APPEND_SET,
-                     * we do an "ADD" update instead of the default "PUT".
-                     */
-                    attributeValueUpdate.action = AWSDynamoDBAttributeActionAdd;
-                } else {
-                    /* Otherwise, we do the default "PUT" update. */
-                    attributeValueUpdate.action = AWSDynamoDBAttributeActionPut;
-                }
+                attributeValueUpdate.action = AWSDynamoDBAttributeActionDelete;
 
-                item[key] = attributeValueUpdate;
+                item[attributeName] = attributeValueUpdate;
             }
+
+        } else {
+            //If attribute value is not null
+            AWSDynamoDBAttributeValueUpdate *attributeValueUpdate = [AWSDynamoDBAttributeValueUpdate new];
+            AWSDynamoDBAttributeValue *attributeValue = [AWSDynamoDBAttributeValue new];
+            [attributeValue aws_setAttributeValue:value];
+            attributeValueUpdate.value = attributeValue;
+            if (behavior == AWSDynamoDBObjectMapperSaveBehaviorAppendSet &&
+                (attributeValue.BS != nil || attributeValue.NS != nil || attributeValue.SS != nil)) {
+
+                /* If it's a set attribute and the mapper is configured with APPEND_SET,
+                 * we do an "ADD" update instead of the default "PUT".
+                 */
+                attributeValueUpdate.action = AWSDynamoDBAttributeActionAdd;
+            } else {
+                /* Otherwise, we do the default "PUT" update. */
+                attributeValueUpdate.action = AWSDynamoDBAttributeActionPut;
+            }
+
+            item[attributeName] = attributeValueUpdate;
         }
-    }
+    }];
 
     return item;
 }
 
 - (NSDictionary *)key {
     NSMutableDictionary *keyDictionary = [NSMutableDictionary new];
-    NSMutableArray *keyArray = [NSMutableArray new];
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[self class]];
 
-    NSString *hashKeyAttribute = [self aws_hashKeyAttributeForClass:[self class]];
-    [keyArray addObject:hashKeyAttribute];
-
-    NSString *rangeKeyAttribute = [self aws_rangeKeyAttributeForClass:[self class]];
-    if (rangeKeyAttribute) {
-        [keyArray addObject:rangeKeyAttribute];
+    NSMutableArray *keyArray = [NSMutableArray new];
+    [keyArray addObject:codec.hashKeyAttribute];
+    if (codec.rangeKeyAttribute) {
+        [keyArray addObject:codec.rangeKeyAttribute];
     }
 
-    NSDictionary *dictionaryValue = [AWSMTLJSONAdapter JSONDictionaryFromModel:self];
-    
-    for (id key in keyArray) {
+    for (NSString *key in keyArray) {
         // For key attributes
         AWSDynamoDBAttributeValue *keyAttributeValue = [AWSDynamoDBAttributeValue new];
-        [keyAttributeValue aws_setAttributeValue:dictionaryValue[key]];
+        [keyAttributeValue aws_setAttributeValue:[codec valueForAttribute:key ofModel:self]];
         keyDictionary[key] = keyAttributeValue;
     }
 
@@ -884,6 +1349,9 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
 - (instancetype)init {
     if (self = [super init]) {
         _saveBehavior = AWSDynamoDBObjectMapperSaveBehaviorUpdate;
+        _maximumConcurrentBatchRequests = AWSDynamoDBObjectMapperDefaultMaximumConcurrentBatchRequests;
+        _maximumBatchRetryCount = AWSDynamoDBObjectMapperDefaultMaximumBatchRetryCount;
+        _maximumConcurrentScanSegments = AWSDynamoDBObjectMapperDefaultMaximumConcurrentScanSegments;
     }
 
     return self;
@@ -893,12 +1361,110 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
     AWSDynamoDBObjectMapperConfiguration *configuration = [[[self class] allocWithZone:zone] init];
     configuration.saveBehavior = self.saveBehavior;
     configuration.consistentRead = [self.consistentRead copy];
+    configuration.maximumConcurrentBatchRequests = self.maximumConcurrentBatchRequests;
+    configuration.maximumBatchRetryCount = self.maximumBatchRetryCount;
+    configuration.maximumConcurrentScanSegments = self.maximumConcurrentScanSegments;
+    configuration.prefetchesNextPage = self.prefetchesNextPage;
     
     return configuration;
 }
 
 @end
 
+@implementation AWSDynamoDBObjectMapperBatchResult
+
+@end
+
+@implementation AWSDynamoDBObjectMapperParallelScan {
+    NSUInteger _nextSegment;
+    NSMutableSet<AWSRequest *> *_requests;
+    BOOL _stopped;
+    dispatch_queue_t _pageHandlerQueue;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _requests = [NSMutableSet new];
+        _pageHandlerQueue = dispatch_queue_create("com.amazonaws.AWSDynamoDBObjectMapperParallelScan.pageHandler", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (BOOL)takeSegment:(NSUInteger *)segment {
+    @synchronized(self) {
+        if (_stopped || _nextSegment >= self.totalSegments) {
+            return NO;
+        }
+        *segment = _nextSegment++;
+        return YES;
+    }
+}
+
+- (BOOL)beginRequest:(AWSRequest *)request {
+    @synchronized(self) {
+        if (_stopped) {
+            return NO;
+        }
+        [_requests addObject:request];
+        return YES;
+    }
+}
+
+- (void)endRequest:(AWSRequest *)request {
+    @synchronized(self) {
+        [_requests removeObject:request];
+    }
+}
+
+// Pages are passed to the handler one at a time, so that it does not need its own locking. The handler runs on its own
+// serial queue rather than under the lock, so it may wait on a thread that stops the scan without deadlocking.
+- (BOOL)deliverItems:(NSArray *)items {
+    __block BOOL delivered = NO;
+    dispatch_sync(_pageHandlerQueue, ^{
+        if ([self isStopped]) {
+            return;
+        }
+        BOOL stop = NO;
+        self.pageHandler(items, &stop);
+        if (stop) {
+            [self stop];
+        }
+        delivered = !stop;
+    });
+    return delivered;
+}
+
+- (BOOL)isStopped {
+    @synchronized(self) {
+        return _stopped;
+    }
+}
+
+- (void)stop {
+    NSArray<AWSRequest *> *requests = nil;
+    @synchronized(self) {
+        _stopped = YES;
+        requests = [_requests allObjects];
+        [_requests removeAllObjects];
+    }
+    for (AWSRequest *request in requests) {
+        [request cancel];
+    }
+}
+
+@end
+
+@implementation AWSDynamoDBObjectMapperBatchEntry
+
+- (void)finishWithLoadedModel:(id)loadedModel error:(NSError *)error {
+    for (AWSDynamoDBObjectMapperBatchResult *result in self.results) {
+        result.loadedModel = loadedModel;
+        result.error = error;
+    }
+}
+
+@end
+
 @implementation AWSDynamoDBQueryExpression
 
 @end
@@ -929,6 +1495,7 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
 }
 
 - (AWSTask *)reload {
+    [self cancelPrefetch];
     self.lastEvaluatedKey = nil;
     return [self loadPage];
 }
@@ -944,32 +1511,93 @@ completionHandler:(void (^ _Nullable)(AWSDynamoDBPaginatedOutput * _Nullable res
     }];
 }
 
+- (void)cancelPrefetch {
+    AWSRequest *prefetchInput = nil;
+    @synchronized(self) {
+        prefetchInput = self.prefetchInput;
+        self.prefetchTask = nil;
+        self.prefetchInput = nil;
+        self.prefetchStartKey = nil;
+    }
+    [prefetchInput cancel];
+}
+
+- (void)dealloc {
+    [_prefetchInput cancel];
+}
+
 // Internal method
 - (AWSTask *)loadPage {
-    if (self.queryInput) {
-        self.queryInput.exclusiveStartKey = self.lastEvaluatedKey;
-        return [[self.dynamoDBObjectMapper query:self.resultClass
-                                      queryInput:self.queryInput] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSDynamoDBPaginatedOutput *> * _Nonnull task) {
-            AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
-            self.lastEvaluatedKey = paginatedOutput.lastEvaluatedKey;
-            self.items = paginatedOutput.items;
+    if (!self.queryInput && !self.scanInput) {
+        return [AWSTask taskWithResult:nil];
+    }
 
-            return nil;
-        }];
+    // Use the page read ahead if it starts where the current page ends. A page read ahead before a reload is stale.
+    AWSTask<AWSDynamoDBPaginatedOutput *> *pageTask = nil;
+    @synchronized(self) {
+        if (self.prefetchTask && self.lastEvaluatedKey && self.prefetchStartKey == self.lastEvaluatedKey) {
+            pageTask = self.prefetchTask;
+            self.prefetchTask = nil;
+            self.prefetchInput = nil;
+            self.prefetchStartKey = nil;
+        }
+    }
+    if (!pageTask) {
+        [self cancelPrefetch];
+        pageTask = [self pageTaskForInput:[self pageInputStartingAt:self.lastEvaluatedKey]];
     }
-    if (self.scanInput) {
-        self.scanInput.exclusiveStartKey = self.lastEvaluatedKey;
-        return [[self.dynamoDBObjectMapper scan:self.resultClass
-                                      scanInput:self.scanInput] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSDynamoDBPaginatedOutput *> * _Nonnull task) {
-            AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
-            self.lastEvaluatedKey = paginatedOutput.lastEvaluatedKey;
-            self.items = paginatedOutput.items;
 
-            return nil;
-        }];
+    return [pageTask continueWithSuccessBlock:^id _Nullable(AWSTask<AWSDynamoDBPaginatedOutput *> * _Nonnull task) {
+        AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
+        self.lastEvaluatedKey = paginatedOutput.lastEvaluatedKey;
+        self.items = paginatedOutput.items;
+        [self prefetchNextPage];
+
+        return nil;
+    }];
+}
+
+// Internal method
+- (void)prefetchNextPage {
+    NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *startKey = self.lastEvaluatedKey;
+    if (!self.prefetchesNextPage || !startKey) {
+        return;
     }
 
-    return [AWSTask taskWithResult:nil];
+    AWSRequest *input = [self pageInputStartingAt:startKey];
+    AWSTask<AWSDynamoDBPaginatedOutput *> *prefetchTask = [self pageTaskForInput:input];
+    AWSRequest *replacedInput = nil;
+    @synchronized(self) {
+        replacedInput = self.prefetchInput;
+        self.prefetchTask = prefetchTask;
+        self.prefetchInput = input;
+        self.prefetchStartKey = startKey;
+    }
+    [replacedInput cancel];
+}
+
+// Internal method
+- (AWSRequest *)pageInputStartingAt:(NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *)startKey {
+    if (self.queryInput) {
+        AWSDynamoDBQueryInput *queryInput = AWSDynamoDBObjectMapperCopyPageInput(self.queryInput);
+        queryInput.exclusiveStartKey = startKey;
+        return queryInput;
+    }
+    AWSDynamoDBScanInput *scanInput = AWSDynamoDBObjectMapperCopyPageInput(self.scanInput);
+    scanInput.exclusiveStartKey = startKey;
+    return scanInput;
+}
+
+// Internal method
+- (AWSTask<AWSDynamoDBPaginatedOutput *> *)pageTaskForInput:(AWSRequest *)input {
+    if ([input isKindOfClass:[AWSDynamoDBQueryInput class]]) {
+        return [self.dynamoDBObjectMapper query:self.resultClass
+                                     queryInput:(AWSDynamoDBQueryInput *)input
+                             prefetchesNextPage:NO];
+    }
+    return [self.dynamoDBObjectMapper scan:self.resultClass
+                                 scanInput:(AWSDynamoDBScanInput *)input
+                        prefetchesNextPage:NO];
 }
 
 @end
@@ -0,0 +1,87 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Parses a DynamoDB number. Integers that fit in 64 bits are returned as `long long` numbers, larger integers as
+ `NSDecimalNumber` so that no digits are lost, and other numbers as the nearest `double`.
+
+ @return The number, or `nil` if `string` is not a number.
+ */
+FOUNDATION_EXPORT NSNumber * _Nullable AWSDynamoDBNumberFromString(NSString *string);
+
+/**
+ Decodes one attribute value in DynamoDB JSON, such as `{"N": "42"}`, into the Foundation value the object mapper uses
+ for it: `NSString`, `NSNumber`, `NSData`, `NSSet`, `NSArray` or `NSDictionary`.
+
+ @return The value, or `nil` for a `NULL` attribute value.
+ */
+FOUNDATION_EXPORT id _Nullable AWSDynamoDBObjectFromJSONAttributeValue(NSDictionary *JSONAttributeValue);
+
+/**
+ Maps items between DynamoDB JSON and the properties of an `AWSDynamoDBObjectModel` subclass.
+
+ The codec reads the class's key paths, value transformers, keys and ignored attributes once, so converting an item
+ does not build the intermediate `AWSDynamoDBAttributeValue` objects and JSON dictionary the Mantle adapter needs.
+ */
+@interface AWSDynamoDBObjectMapperCodec : NSObject
+
+/**
+ Returns the codec for a model class, creating it the first time the class is used.
+ */
++ (instancetype)codecForClass:(Class)modelClass;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) Class modelClass;
+
+/**
+ The name of the hash key attribute.
+ */
+@property (nonatomic, readonly, nullable) NSString *hashKeyAttribute;
+
+/**
+ The name of the range key attribute, or `nil` if the table has none.
+ */
+@property (nonatomic, readonly, nullable) NSString *rangeKeyAttribute;
+
+/**
+ Creates a model from an item in DynamoDB JSON, as returned in the `Item` or `Items` of a response.
+
+ @return The model, or `nil` if a value could not be transformed or failed validation.
+ */
+- (nullable id)modelFromJSONItem:(NSDictionary<NSString *, NSDictionary *> *)JSONItem error:(NSError **)error;
+
+/**
+ Calls `block` with the name and value of each attribute of a model, after its value transformer has run. `value` is
+ `nil` for properties that are not set.
+
+ @param includeIgnored Whether to include the attributes listed in `+ignoreAttributes`.
+ */
+- (void)enumerateAttributesOfModel:(id)model
+                    includeIgnored:(BOOL)includeIgnored
+                        usingBlock:(void (^)(NSString *attributeName, id _Nullable value))block;
+
+/**
+ Returns the value of one attribute of a model, after its value transformer has run.
+ */
+- (nullable id)valueForAttribute:(NSString *)attributeName ofModel:(id)model;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,343 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDynamoDBObjectMapperCodec.h"
+#import <AWSCore/AWSCore.h>
+#import "AWSDynamoDBObjectMapper.h"
+#import <xlocale.h>
+
+// DynamoDB numbers have at most 38 significant digits, so any number it returns fits.
+static const NSUInteger AWSDynamoDBNumberMaximumLength = 64;
+
+NSNumber *AWSDynamoDBNumberFromString(NSString *string) {
+    if (![string isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+
+    char buffer[AWSDynamoDBNumberMaximumLength];
+    const char *characters = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+    if (characters == NULL) {
+        if (![string getCString:buffer maxLength:sizeof(buffer) encoding:NSASCIIStringEncoding]) {
+            return [NSNumber aws_numberFromString:string];
+        }
+        characters = buffer;
+    }
+
+    const char *cursor = characters;
+    if (*cursor == '-' || *cursor == '+') {
+        cursor++;
+    }
+    const char *digits = cursor;
+    while (*cursor >= '0' && *cursor <= '9') {
+        cursor++;
+    }
+
+    if (*cursor == '\0' && cursor != digits) {
+        errno = 0;
+        long long value = strtoll(characters, NULL, 10);
+        if (errno != ERANGE) {
+            return [NSNumber numberWithLongLong:value];
+        }
+        return [NSDecimalNumber decimalNumberWithString:string];
+    }
+
+    for (const char *character = cursor; *character != '\0'; character++) {
+        if (strchr("0123456789.eE+-", *character) == NULL) {
+            return [NSNumber aws_numberFromString:string];
+        }
+    }
+
+    // A NULL locale parses in the C locale, whatever the device's region.
+    char *end = NULL;
+    double value = strtod_l(characters, &end, NULL);
+    if (end == characters || *end != '\0') {
+        return [NSNumber aws_numberFromString:string];
+    }
+    return [NSNumber numberWithDouble:value];
+}
+
+static id AWSDynamoDBObjectFromJSONValue(NSString *type, id value) {
+    if ([type isEqualToString:@"S"]) {
+        return value;
+    }
+    if ([type isEqualToString:@"N"]) {
+        return AWSDynamoDBNumberFromString(value);
+    }
+    if ([type isEqualToString:@"BOOL"]) {
+        return value;
+    }
+    if ([type isEqualToString:@"M"]) {
+        NSMutableDictionary *map = [NSMutableDictionary dictionaryWithCapacity:[value count]];
+        for (NSString *key in value) {
+            map[key] = AWSDynamoDBObjectFromJSONAttributeValue(value[key]) ?: [NSNull null];
+        }
+        return map;
+    }
+    if ([type isEqualToString:@"L"]) {
+        NSMutableArray *list = [NSMutableArray arrayWithCapacity:[value count]];
+        for (NSDictionary *item in value) {
+            [list addObject:AWSDynamoDBObjectFromJSONAttributeValue(item) ?: [NSNull null]];
+        }
+        return list;
+    }
+    if ([type isEqualToString:@"B"]) {
+        return value;
+    }
+    if ([type isEqualToString:@"SS"] || [type isEqualToString:@"BS"]) {
+        return [NSSet setWithArray:value];
+    }
+    if ([type isEqualToString:@"NS"]) {
+        NSMutableSet *set = [NSMutableSet setWithCapacity:[value count]];
+        for (NSString *number in value) {
+            NSNumber *parsedNumber = AWSDynamoDBNumberFromString(number);
+            if (parsedNumber) {
+                [set addObject:parsedNumber];
+            }
+        }
+        return set;
+    }
+
+    // NULL, or a type this SDK does not know yet.
+    return nil;
+}
+
+id AWSDynamoDBObjectFromJSONAttributeValue(NSDictionary *JSONAttributeValue) {
+    if (![JSONAttributeValue isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+
+    // An attribute value on the wire has exactly one member, named after its type.
+    for (NSString *type in JSONAttributeValue) {
+        id value = AWSDynamoDBObjectFromJSONValue(type, JSONAttributeValue[type]);
+        if (value) {
+            return value;
+        }
+    }
+    return nil;
+}
+
+@interface AWSDynamoDBObjectMapperAttributeMapping : NSObject
+
+@property (nonatomic, strong) NSString *propertyKey;
+@property (nonatomic, strong) NSString *attributeName;
+@property (nonatomic, strong) NSValueTransformer *transformer;
+@property (nonatomic, assign) BOOL reversible;
+@property (nonatomic, assign) BOOL ignored;
+
+@end
+
+@implementation AWSDynamoDBObjectMapperAttributeMapping
+
+@end
+
+@interface AWSDynamoDBObjectMapperCodec()
+
+@property (nonatomic, strong) NSArray<AWSDynamoDBObjectMapperAttributeMapping *> *mappings;
+@property (nonatomic, strong) NSDictionary<NSString *, AWSDynamoDBObjectMapperAttributeMapping *> *mappingsByAttributeName;
+@property (nonatomic, strong) NSSet<NSString *> *ignoredAttributes;
+
+/**
+ Whether every property maps to one top-level attribute. Classes with nested key paths, or that pick their class with
+ `+classForParsingJSONDictionary:`, are mapped by the Mantle adapter instead.
+ */
+@property (nonatomic, assign) BOOL mapsDirectly;
+
+@end
+
+@implementation AWSDynamoDBObjectMapperCodec
+
++ (instancetype)codecForClass:(Class)modelClass {
+    static NSMapTable<Class, AWSDynamoDBObjectMapperCodec *> *_codecs = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _codecs = [NSMapTable strongToStrongObjectsMapTable];
+    });
+
+    @synchronized(_codecs) {
+        AWSDynamoDBObjectMapperCodec *codec = [_codecs objectForKey:modelClass];
+        if (!codec) {
+            codec = [[AWSDynamoDBObjectMapperCodec alloc] initWithModelClass:modelClass];
+            [_codecs setObject:codec forKey:modelClass];
+        }
+        return codec;
+    }
+}
+
+- (instancetype)initWithModelClass:(Class)modelClass {
+    if (self = [super init]) {
+        _modelClass = modelClass;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+        NSDictionary *JSONKeyPathsByPropertyKey = nil;
+        if ([modelClass respondsToSelector:@selector(JSONKeyPathsByPropertyKey)]) {
+            JSONKeyPathsByPropertyKey = [modelClass performSelector:@selector(JSONKeyPathsByPropertyKey)];
+        }
+
+        NSArray *ignoreAttributes = nil;
+        if ([modelClass respondsToSelector:@selector(ignoreAttributes)]) {
+            ignoreAttributes = [modelClass performSelector:@selector(ignoreAttributes)];
+        }
+        _ignoredAttributes = [NSSet setWithArray:ignoreAttributes ?: @[]];
+
+        _mapsDirectly = ![modelClass respondsToSelector:@selector(classForParsingJSONDictionary:)];
+
+        NSMutableArray *mappings = [NSMutableArray new];
+        NSMutableDictionary *mappingsByAttributeName = [NSMutableDictionary new];
+        for (NSString *propertyKey in [modelClass propertyKeys]) {
+            id JSONKeyPath = JSONKeyPathsByPropertyKey[propertyKey];
+            if (JSONKeyPath == [NSNull null]) {
+                continue;
+            }
+
+            AWSDynamoDBObjectMapperAttributeMapping *mapping = [AWSDynamoDBObjectMapperAttributeMapping new];
+            mapping.propertyKey = propertyKey;
+            mapping.attributeName = JSONKeyPath ?: propertyKey;
+            mapping.transformer = [self JSONTransformerForPropertyKey:propertyKey];
+            mapping.reversible = [[mapping.transformer class] allowsReverseTransformation];
+            mapping.ignored = [_ignoredAttributes containsObject:mapping.attributeName];
+
+            if ([mapping.attributeName rangeOfString:@"."].location != NSNotFound
+                || mappingsByAttributeName[mapping.attributeName]) {
+                _mapsDirectly = NO;
+            }
+            [mappings addObject:mapping];
+            mappingsByAttributeName[mapping.attributeName] = mapping;
+        }
+        _mappings = mappings;
+        _mappingsByAttributeName = mappingsByAttributeName;
+
+        if ([modelClass respondsToSelector:@selector(hashKeyAttribute)]) {
+            NSString *hashKeyAttribute = [modelClass performSelector:@selector(hashKeyAttribute)];
+            _hashKeyAttribute = [JSONKeyPathsByPropertyKey objectForKey:hashKeyAttribute] ?: hashKeyAttribute;
+        }
+        if ([modelClass respondsToSelector:@selector(rangeKeyAttribute)]) {
+            NSString *rangeKeyAttribute = [modelClass performSelector:@selector(rangeKeyAttribute)];
+            _rangeKeyAttribute = [JSONKeyPathsByPropertyKey objectForKey:rangeKeyAttribute] ?: rangeKeyAttribute;
+        }
+#pragma clang diagnostic pop
+    }
+
+    return self;
+}
+
+- (NSValueTransformer *)JSONTransformerForPropertyKey:(NSString *)propertyKey {
+    SEL selector = NSSelectorFromString([propertyKey stringByAppendingString:@"JSONTransformer"]);
+    if ([self.modelClass respondsToSelector:selector]) {
+        NSValueTransformer *(*transformerForKey)(id, SEL) = (void *)[self.modelClass methodForSelector:selector];
+        return transformerForKey(self.modelClass, selector);
+    }
+    if ([self.modelClass respondsToSelector:@selector(JSONTransformerForKey:)]) {
+        return [self.modelClass JSONTransformerForKey:propertyKey];
+    }
+    return nil;
+}
+
+#pragma mark - Decoding
+
+- (id)modelFromJSONItem:(NSDictionary<NSString *, NSDictionary *> *)JSONItem error:(NSError **)error {
+    if (!self.mapsDirectly) {
+        NSMutableDictionary *JSONDictionary = [NSMutableDictionary dictionaryWithCapacity:[JSONItem count]];
+        for (NSString *attributeName in JSONItem) {
+            id value = AWSDynamoDBObjectFromJSONAttributeValue(JSONItem[attributeName]);
+            if (value) {
+                JSONDictionary[attributeName] = value;
+            }
+        }
+        return [AWSMTLJSONAdapter modelOfClass:self.modelClass
+                            fromJSONDictionary:JSONDictionary
+                                         error:error];
+    }
+
+    id model = [self.modelClass new];
+    for (NSString *attributeName in JSONItem) {
+        AWSDynamoDBObjectMapperAttributeMapping *mapping = self.mappingsByAttributeName[attributeName];
+        if (!mapping) {
+            continue;
+        }
+
+        id value = AWSDynamoDBObjectFromJSONAttributeValue(JSONItem[attributeName]);
+        if (!value) {
+            continue;
+        }
+
+        @try {
+            if (mapping.transformer) {
+                value = [mapping.transformer transformedValue:value];
+            }
+
+            // validateValue may replace the value, as it does for AWSMTLModel's own initializer.
+            __autoreleasing id validatedValue = value;
+            if (![model validateValue:&validatedValue forKey:mapping.propertyKey error:error]) {
+                return nil;
+            }
+            [model setValue:validatedValue forKey:mapping.propertyKey];
+        } @catch (NSException *exception) {
+            AWSDDLogError(@"Failed to set \"%@\" of %@: %@", mapping.propertyKey, self.modelClass, exception);
+            if (error) {
+                *error = [NSError errorWithDomain:AWSMTLJSONAdapterErrorDomain
+                                             code:AWSMTLJSONAdapterErrorInvalidJSONDictionary
+                                         userInfo:@{NSLocalizedDescriptionKey : exception.description,
+                                                    NSLocalizedFailureReasonErrorKey : exception.reason ?: @""}];
+            }
+            return nil;
+        }
+    }
+
+    return model;
+}
+
+#pragma mark - Encoding
+
+- (id)valueForMapping:(AWSDynamoDBObjectMapperAttributeMapping *)mapping ofModel:(id)model {
+    id value = [model valueForKey:mapping.propertyKey];
+    if (mapping.reversible) {
+        value = [mapping.transformer reverseTransformedValue:value];
+    }
+    return value == [NSNull null] ? nil : value;
+}
+
+- (void)enumerateAttributesOfModel:(id)model
+                    includeIgnored:(BOOL)includeIgnored
+                        usingBlock:(void (^)(NSString *attributeName, id value))block {
+    if (!self.mapsDirectly) {
+        NSDictionary *JSONDictionary = [AWSMTLJSONAdapter JSONDictionaryFromModel:model];
+        [JSONDictionary enumerateKeysAndObjectsUsingBlock:^(NSString *attributeName, id value, BOOL *stop) {
+            if (includeIgnored || ![self.ignoredAttributes containsObject:attributeName]) {
+                block(attributeName, value == [NSNull null] ? nil : value);
+            }
+        }];
+        return;
+    }
+
+    for (AWSDynamoDBObjectMapperAttributeMapping *mapping in self.mappings) {
+        if (mapping.ignored && !includeIgnored) {
+            continue;
+        }
+        block(mapping.attributeName, [self valueForMapping:mapping ofModel:model]);
+    }
+}
+
+- (id)valueForAttribute:(NSString *)attributeName ofModel:(id)model {
+    if (!self.mapsDirectly) {
+        id value = [[AWSMTLJSONAdapter JSONDictionaryFromModel:model] objectForKey:attributeName];
+        return value == [NSNull null] ? nil : value;
+    }
+
+    AWSDynamoDBObjectMapperAttributeMapping *mapping = self.mappingsByAttributeName[attributeName];
+    return mapping ? [self valueForMapping:mapping ofModel:model] : nil;
+}
+
+@end
@@ -0,0 +1,126 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSDynamoDB.h"
+#import "AWSBenchmark.h"
+#import "TestDynamoDBServer.h"
+
+static NSString *const AWSDynamoDBBenchmarkTestsKey = @"AWSDynamoDBBenchmarkTests";
+static const NSUInteger AWSDynamoDBBenchmarkAuthorCount = 20;
+static const NSUInteger AWSDynamoDBBenchmarkBooksPerAuthor = 25;
+static const NSUInteger AWSDynamoDBBenchmarkWarmUpCount = 10;
+static const NSUInteger AWSDynamoDBBenchmarkOperationCount = 200;
+
+@interface AWSDynamoDBBenchmarkBook : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *author;
+@property (nonatomic, strong) NSString *ISBN;
+@property (nonatomic, strong) NSString *title;
+@property (nonatomic, strong) NSNumber *pageCount;
+@property (nonatomic, strong) NSNumber *price;
+@property (nonatomic, strong) NSSet<NSString *> *genres;
+
+@end
+
+@implementation AWSDynamoDBBenchmarkBook
+
++ (NSString *)dynamoDBTableName {
+    return @"Books";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"author";
+}
+
++ (NSString *)rangeKeyAttribute {
+    return @"ISBN";
+}
+
+@end
+
+@interface AWSDynamoDBBenchmarkTests : XCTestCase
+
+@property (nonatomic, strong) TestDynamoDBServer *server;
+@property (nonatomic, strong) AWSDynamoDBObjectMapper *objectMapper;
+
+@end
+
+@implementation AWSDynamoDBBenchmarkTests
+
++ (XCTestSuite *)defaultTestSuite {
+    // Benchmarks are opt-in; see AWSBenchmark.
+    return [AWSBenchmark isEnabled] ? [super defaultTestSuite] : [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+}
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestDynamoDBServer new];
+    XCTAssertTrue([self.server start]);
+    [self.server createTableNamed:@"Books" hashKey:@"author" rangeKey:@"ISBN"];
+    for (NSUInteger author = 0; author < AWSDynamoDBBenchmarkAuthorCount; author++) {
+        for (NSUInteger book = 0; book < AWSDynamoDBBenchmarkBooksPerAuthor; book++) {
+            [self.server putItem:@{@"author" : @{@"S" : [NSString stringWithFormat:@"Author %lu", (unsigned long)author]},
+                                   @"ISBN" : @{@"S" : [NSString stringWithFormat:@"978-%04lu-%05lu", (unsigned long)author, (unsigned long)book]},
+                                   @"title" : @{@"S" : [NSString stringWithFormat:@"Book %lu of author %lu", (unsigned long)book, (unsigned long)author]},
+                                   @"pageCount" : @{@"N" : [NSString stringWithFormat:@"%lu", (unsigned long)(100 + book * 7)]},
+                                   @"price" : @{@"N" : @"19.99"},
+                                   @"genres" : @{@"SS" : @[@"fiction", @"mystery"]}}
+                         inTable:@"Books"];
+        }
+    }
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceDynamoDB
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSDynamoDBObjectMapper registerDynamoDBObjectMapperWithConfiguration:configuration
+                                                 objectMapperConfiguration:[AWSDynamoDBObjectMapperConfiguration new]
+                                                                    forKey:AWSDynamoDBBenchmarkTestsKey];
+    self.objectMapper = [AWSDynamoDBObjectMapper DynamoDBObjectMapperForKey:AWSDynamoDBBenchmarkTestsKey];
+}
+
+- (void)tearDown {
+    [AWSDynamoDBObjectMapper removeDynamoDBObjectMapperForKey:AWSDynamoDBBenchmarkTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+- (void)testQueryBenchmark {
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"DynamoDBQuery"
+                                                     warmUpCount:AWSDynamoDBBenchmarkWarmUpCount
+                                                  operationCount:AWSDynamoDBBenchmarkOperationCount
+                                                       operation:^BOOL(NSUInteger index) {
+        AWSDynamoDBQueryExpression *expression = [AWSDynamoDBQueryExpression new];
+        expression.keyConditionExpression = @"#author = :author";
+        expression.expressionAttributeNames = @{@"#author" : @"author"};
+        expression.expressionAttributeValues = @{@":author" : [NSString stringWithFormat:@"Author %lu", (unsigned long)(index % AWSDynamoDBBenchmarkAuthorCount)]};
+
+        AWSTask<AWSDynamoDBPaginatedOutput *> *task = [self.objectMapper query:[AWSDynamoDBBenchmarkBook class]
+                                                                    expression:expression];
+        [task waitUntilFinished];
+        return !task.error && [task.result.items count] == AWSDynamoDBBenchmarkBooksPerAuthor;
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+@end
@@ -0,0 +1,300 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSDynamoDB.h"
+#import "TestDynamoDBServer.h"
+
+static NSString *const AWSDynamoDBObjectMapperBatchTestsKey = @"AWSDynamoDBObjectMapperBatchTests";
+
+@interface AWSDynamoDBBatchTestBook : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *ISBN;
+@property (nonatomic, strong) NSNumber *edition;
+@property (nonatomic, strong) NSString *title;
+
+@end
+
+@implementation AWSDynamoDBBatchTestBook
+
++ (NSString *)dynamoDBTableName {
+    return @"Books";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"ISBN";
+}
+
++ (NSString *)rangeKeyAttribute {
+    return @"edition";
+}
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return @{@"ISBN" : @"isbn"};
+}
+
+@end
+
+@interface AWSDynamoDBBatchTestAuthor : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSNumber *bookCount;
+
+@end
+
+@implementation AWSDynamoDBBatchTestAuthor
+
++ (NSString *)dynamoDBTableName {
+    return @"Authors";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"name";
+}
+
+@end
+
+@interface AWSDynamoDBObjectMapperBatchTests : XCTestCase
+
+@property (nonatomic, strong) TestDynamoDBServer *server;
+@property (nonatomic, strong) AWSDynamoDBObjectMapper *objectMapper;
+
+@end
+
+@implementation AWSDynamoDBObjectMapperBatchTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestDynamoDBServer new];
+    XCTAssertTrue([self.server start]);
+    [self.server createTableNamed:@"Books" hashKey:@"isbn" rangeKey:@"edition"];
+    [self.server createTableNamed:@"Authors" hashKey:@"name" rangeKey:nil];
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceDynamoDB
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    AWSDynamoDBObjectMapperConfiguration *objectMapperConfiguration = [AWSDynamoDBObjectMapperConfiguration new];
+    objectMapperConfiguration.maximumConcurrentBatchRequests = 4;
+    [AWSDynamoDBObjectMapper registerDynamoDBObjectMapperWithConfiguration:configuration
+                                                 objectMapperConfiguration:objectMapperConfiguration
+                                                                    forKey:AWSDynamoDBObjectMapperBatchTestsKey];
+    self.objectMapper = [AWSDynamoDBObjectMapper DynamoDBObjectMapperForKey:AWSDynamoDBObjectMapperBatchTestsKey];
+}
+
+- (void)tearDown {
+    [AWSDynamoDBObjectMapper removeDynamoDBObjectMapperForKey:AWSDynamoDBObjectMapperBatchTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+- (NSArray<AWSDynamoDBBatchTestBook *> *)booksWithCount:(NSUInteger)count {
+    NSMutableArray<AWSDynamoDBBatchTestBook *> *books = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        AWSDynamoDBBatchTestBook *book = [AWSDynamoDBBatchTestBook new];
+        book.ISBN = [NSString stringWithFormat:@"978-%09lu", (unsigned long)i];
+        book.edition = @(i % 3 + 1);
+        book.title = [NSString stringWithFormat:@"Book %lu", (unsigned long)i];
+        [books addObject:book];
+    }
+    return books;
+}
+
+- (NSArray<AWSDynamoDBObjectMapperBatchResult *> *)waitForTask:(AWSTask<NSArray<AWSDynamoDBObjectMapperBatchResult *> *> *)task {
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return task.result;
+}
+
+- (void)testBatchSaveSplitsIntoConcurrentRequests {
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:260];
+    self.server.responseDelay = 0.05;
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchSave:books]];
+
+    XCTAssertEqual([results count], 260);
+    for (NSUInteger i = 0; i < [results count]; i++) {
+        XCTAssertEqual(results[i].model, books[i]);
+        XCTAssertNil(results[i].loadedModel);
+        XCTAssertNil(results[i].error);
+    }
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 260);
+    XCTAssertEqualObjects([self.server itemInTable:@"Books" withKey:@{@"isbn" : @{@"S" : @"978-000000007"}, @"edition" : @{@"N" : @"2"}}][@"title"],
+                          @{@"S" : @"Book 7"});
+    XCTAssertEqual(self.server.requestCount, 11);
+    XCTAssertGreaterThan(self.server.maximumConcurrentRequestCount, 1);
+    XCTAssertLessThanOrEqual(self.server.maximumConcurrentRequestCount, 4);
+}
+
+- (void)testBatchLoadReturnsModelsInInputOrder {
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:150];
+    [self waitForTask:[self.objectMapper batchSave:books]];
+    NSUInteger saveRequestCount = self.server.requestCount;
+
+    NSMutableArray<AWSDynamoDBBatchTestBook *> *keys = [NSMutableArray new];
+    for (AWSDynamoDBBatchTestBook *book in [books reverseObjectEnumerator]) {
+        AWSDynamoDBBatchTestBook *key = [AWSDynamoDBBatchTestBook new];
+        key.ISBN = book.ISBN;
+        key.edition = book.edition;
+        [keys addObject:key];
+    }
+    AWSDynamoDBBatchTestBook *missing = [AWSDynamoDBBatchTestBook new];
+    missing.ISBN = @"978-999999999";
+    missing.edition = @1;
+    [keys insertObject:missing atIndex:40];
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchLoad:keys]];
+
+    XCTAssertEqual([results count], 151);
+    XCTAssertEqual(self.server.requestCount - saveRequestCount, 2);
+    for (NSUInteger i = 0; i < [results count]; i++) {
+        XCTAssertEqual(results[i].model, keys[i]);
+        XCTAssertNil(results[i].error);
+        if (keys[i] == missing) {
+            XCTAssertNil(results[i].loadedModel);
+            continue;
+        }
+        AWSDynamoDBBatchTestBook *loaded = results[i].loadedModel;
+        XCTAssertTrue([loaded isKindOfClass:[AWSDynamoDBBatchTestBook class]]);
+        XCTAssertEqualObjects(loaded.ISBN, keys[i].ISBN);
+        XCTAssertEqualObjects(loaded.edition, keys[i].edition);
+        XCTAssertNotNil(loaded.title);
+    }
+}
+
+- (void)testBatchLoadAcrossTables {
+    AWSDynamoDBBatchTestAuthor *author = [AWSDynamoDBBatchTestAuthor new];
+    author.name = @"Harold Abelson";
+    author.bookCount = @4;
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:2];
+    [self waitForTask:[self.objectMapper batchSave:@[author, books[0], books[1]]]];
+
+    AWSDynamoDBBatchTestAuthor *authorKey = [AWSDynamoDBBatchTestAuthor new];
+    authorKey.name = @"Harold Abelson";
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchLoad:@[books[1], authorKey]]];
+
+    XCTAssertEqualObjects([results[0].loadedModel title], @"Book 1");
+    XCTAssertTrue([results[1].loadedModel isKindOfClass:[AWSDynamoDBBatchTestAuthor class]]);
+    XCTAssertEqualObjects([results[1].loadedModel bookCount], @4);
+}
+
+- (void)testBatchSaveRetriesUnprocessedItems {
+    self.server.maximumProcessedPerRequest = 10;
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchSave:[self booksWithCount:25]]];
+
+    for (AWSDynamoDBObjectMapperBatchResult *result in results) {
+        XCTAssertNil(result.error);
+    }
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 25);
+    XCTAssertEqual(self.server.requestCount, 3);
+}
+
+- (void)testBatchLoadRetriesUnprocessedKeys {
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:30];
+    [self waitForTask:[self.objectMapper batchSave:books]];
+    self.server.maximumProcessedPerRequest = 8;
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchLoad:books]];
+
+    for (AWSDynamoDBObjectMapperBatchResult *result in results) {
+        XCTAssertNil(result.error);
+        XCTAssertEqualObjects([result.loadedModel title], [(AWSDynamoDBBatchTestBook *)result.model title]);
+    }
+}
+
+- (void)testBatchSaveFailsItemsStillUnprocessedAfterRetries {
+    self.server.maximumProcessedPerRequest = 10;
+    AWSDynamoDBObjectMapperConfiguration *configuration = [AWSDynamoDBObjectMapperConfiguration new];
+    configuration.maximumBatchRetryCount = 1;
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchSave:[self booksWithCount:25]
+                                                                                              configuration:configuration]];
+
+    NSUInteger failureCount = 0;
+    for (AWSDynamoDBObjectMapperBatchResult *result in results) {
+        if (result.error) {
+            XCTAssertEqualObjects(result.error.domain, AWSDynamoDBObjectMapperErrorDomain);
+            XCTAssertEqual(result.error.code, AWSDynamoDBObjectMapperErrorUnprocessedItem);
+            failureCount++;
+        }
+    }
+    XCTAssertEqual(failureCount, 5);
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 20);
+    XCTAssertEqual(self.server.requestCount, 2);
+}
+
+- (void)testBatchSaveWritesDuplicateKeysOnce {
+    AWSDynamoDBBatchTestBook *first = [self booksWithCount:1][0];
+    AWSDynamoDBBatchTestBook *second = [self booksWithCount:1][0];
+    second.title = @"Second printing";
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchSave:@[first, second]]];
+
+    XCTAssertEqual([results count], 2);
+    XCTAssertNil(results[0].error);
+    XCTAssertNil(results[1].error);
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 1);
+    XCTAssertEqualObjects([self.server itemInTable:@"Books" withKey:@{@"isbn" : @{@"S" : first.ISBN}, @"edition" : @{@"N" : @"1"}}][@"title"],
+                          @{@"S" : @"Second printing"});
+}
+
+- (void)testBatchRemove {
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:40];
+    [self waitForTask:[self.objectMapper batchSave:books]];
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchRemove:[books subarrayWithRange:NSMakeRange(0, 30)]]];
+
+    XCTAssertEqual([results count], 30);
+    for (AWSDynamoDBObjectMapperBatchResult *result in results) {
+        XCTAssertNil(result.error);
+    }
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 10);
+}
+
+- (void)testBatchRequestFailureIsReportedPerModel {
+    AWSDynamoDBBatchTestBook *book = [self booksWithCount:1][0];
+    AWSDynamoDBBatchTestBook *keyless = [AWSDynamoDBBatchTestBook new];
+    keyless.edition = @1;
+
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchSave:@[book, keyless]]];
+
+    XCTAssertNotNil(results[0].error);
+    XCTAssertTrue([results[0].error.userInfo[@"__type"] hasSuffix:@"#ValidationException"]);
+    XCTAssertEqualObjects(results[1].error, results[0].error);
+    XCTAssertEqual([self.server itemCountInTable:@"Books"], 0);
+}
+
+- (void)testBatchWithNoModels {
+    NSArray<AWSDynamoDBObjectMapperBatchResult *> *results = [self waitForTask:[self.objectMapper batchLoad:@[]]];
+
+    XCTAssertEqualObjects(results, @[]);
+    XCTAssertEqual(self.server.requestCount, 0);
+}
+
+- (void)testBatchSavePerformance {
+    NSArray<AWSDynamoDBBatchTestBook *> *books = [self booksWithCount:1000];
+
+    [self measureBlock:^{
+        [self waitForTask:[self.objectMapper batchSave:books]];
+    }];
+}
+
+@end
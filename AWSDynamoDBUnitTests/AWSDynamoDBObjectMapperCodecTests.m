@@ -0,0 +1,332 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "OCMock.h"
+#import "AWSDynamoDB.h"
+#import "AWSDynamoDBObjectMapperCodec.h"
+
+// Query result pages are limited to 1MB by DynamoDB.
+static const NSUInteger AWSDynamoDBObjectMapperCodecTestsPageByteCount = 1024 * 1024;
+
+@interface AWSDynamoDBObjectModel ()
+
+- (NSDictionary *)itemForPutItemInput;
+- (NSDictionary *)itemForUpdateItemInput:(AWSDynamoDBObjectMapperSaveBehavior)behavior;
+- (NSDictionary *)key;
+
+@end
+
+@interface AWSDynamoDBCodecTestBook : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *ISBN;
+@property (nonatomic, strong) NSNumber *edition;
+@property (nonatomic, strong) NSString *title;
+@property (nonatomic, strong) NSNumber *price;
+@property (nonatomic, assign) long long pageCount;
+@property (nonatomic, strong) NSNumber *inStock;
+@property (nonatomic, strong) NSSet<NSString *> *tags;
+@property (nonatomic, strong) NSSet<NSNumber *> *ratings;
+@property (nonatomic, strong) NSArray *chapters;
+@property (nonatomic, strong) NSDictionary *details;
+@property (nonatomic, strong) NSData *cover;
+@property (nonatomic, strong) NSDate *publishedAt;
+@property (nonatomic, strong) NSString *cachedSummary;
+
+@end
+
+@implementation AWSDynamoDBCodecTestBook
+
++ (NSString *)dynamoDBTableName {
+    return @"Books";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"ISBN";
+}
+
++ (NSString *)rangeKeyAttribute {
+    return @"edition";
+}
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return @{@"ISBN" : @"isbn",
+             @"publishedAt" : @"published_at"};
+}
+
++ (NSArray<NSString *> *)ignoreAttributes {
+    return @[@"cachedSummary"];
+}
+
++ (NSValueTransformer *)publishedAtJSONTransformer {
+    return [AWSMTLValueTransformer reversibleTransformerWithForwardBlock:^id(NSNumber *seconds) {
+        return [NSDate dateWithTimeIntervalSince1970:[seconds doubleValue]];
+    } reverseBlock:^id(NSDate *date) {
+        return @((long long)[date timeIntervalSince1970]);
+    }];
+}
+
+@end
+
+// The item decoding path the object mapper used before the codec: attribute values, then plain values, then Mantle.
+static id AWSDynamoDBCodecTestsPlainValue(AWSDynamoDBAttributeValue *attributeValue) {
+    if (attributeValue.BOOLEAN != nil) {
+        return attributeValue.BOOLEAN;
+    } else if (attributeValue.S) {
+        return attributeValue.S;
+    } else if (attributeValue.N) {
+        return [NSNumber aws_numberFromString:attributeValue.N];
+    } else if (attributeValue.SS) {
+        return [NSSet setWithArray:attributeValue.SS];
+    } else if (attributeValue.NS) {
+        NSMutableSet *set = [NSMutableSet new];
+        for (NSString *number in attributeValue.NS) {
+            [set addObject:[NSNumber aws_numberFromString:number]];
+        }
+        return set;
+    } else if (attributeValue.L) {
+        NSMutableArray *list = [NSMutableArray new];
+        for (AWSDynamoDBAttributeValue *item in attributeValue.L) {
+            [list addObject:AWSDynamoDBCodecTestsPlainValue(item)];
+        }
+        return list;
+    } else if (attributeValue.M) {
+        NSMutableDictionary *map = [NSMutableDictionary new];
+        for (NSString *key in attributeValue.M) {
+            map[key] = AWSDynamoDBCodecTestsPlainValue(attributeValue.M[key]);
+        }
+        return map;
+    }
+    return nil;
+}
+
+@interface AWSDynamoDBObjectMapperCodecTests : XCTestCase
+
+@end
+
+@implementation AWSDynamoDBObjectMapperCodecTests
+
+- (NSDictionary *)JSONItemAtIndex:(NSUInteger)index {
+    return @{@"isbn" : @{@"S" : [NSString stringWithFormat:@"978-0-%08lu", (unsigned long)index]},
+             @"edition" : @{@"N" : @"2"},
+             @"title" : @{@"S" : @"Structure and Interpretation of Computer Programs"},
+             @"price" : @{@"N" : @"54.95"},
+             @"pageCount" : @{@"N" : [NSString stringWithFormat:@"%lu", (unsigned long)(400 + index % 300)]},
+             @"inStock" : @{@"BOOL" : @YES},
+             @"tags" : @{@"SS" : @[@"lisp", @"classic", @"computer-science"]},
+             @"ratings" : @{@"NS" : @[@"5", @"4", @"3"]},
+             @"chapters" : @{@"L" : @[@{@"S" : @"Building Abstractions with Procedures"},
+                                      @{@"S" : @"Building Abstractions with Data"},
+                                      @{@"S" : @"Modularity, Objects, and State"}]},
+             @"details" : @{@"M" : @{@"publisher" : @{@"S" : @"MIT Press"},
+                                     @"language" : @{@"S" : @"en"},
+                                     @"weight" : @{@"N" : @"1.2"}}},
+             @"published_at" : @{@"N" : @"838857600"},
+             };
+}
+
+- (NSDictionary *)JSONQueryPage {
+    NSMutableArray *items = [NSMutableArray new];
+    NSUInteger byteCount = 0;
+    while (byteCount < AWSDynamoDBObjectMapperCodecTestsPageByteCount) {
+        NSDictionary *item = [self JSONItemAtIndex:[items count]];
+        byteCount += [[NSJSONSerialization dataWithJSONObject:item options:0 error:nil] length];
+        [items addObject:item];
+    }
+    return @{@"Items" : items,
+             @"Count" : @([items count]),
+             @"ScannedCount" : @([items count])};
+}
+
+- (void)testNumberFromString {
+    NSNumber *integer = AWSDynamoDBNumberFromString(@"42");
+    XCTAssertEqualObjects(integer, @42);
+    XCTAssertEqual(strcmp([integer objCType], @encode(long long)), 0);
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@"-9223372036854775808"), @(LLONG_MIN));
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@"+7"), @7);
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@"54.95"), @54.95);
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@"-0.001"), @(-0.001));
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@"1E+3"), @1000);
+    XCTAssertEqualObjects(AWSDynamoDBNumberFromString(@".5"), @0.5);
+
+    // Integers past 64 bits keep every digit.
+    NSNumber *large = AWSDynamoDBNumberFromString(@"12345678901234567890123456789012345678");
+    XCTAssertTrue([large isKindOfClass:[NSDecimalNumber class]]);
+    XCTAssertEqualObjects([large stringValue], @"12345678901234567890123456789012345678");
+
+    XCTAssertNil(AWSDynamoDBNumberFromString(@""));
+    XCTAssertNil(AWSDynamoDBNumberFromString(@"-"));
+    XCTAssertNil(AWSDynamoDBNumberFromString(@"forty-two"));
+}
+
+- (void)testObjectFromJSONAttributeValue {
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue(@{@"S" : @"value"}), @"value");
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue(@{@"N" : @"3"}), @3);
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue(@{@"BOOL" : @NO}), @NO);
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue(@{@"NS" : @[@"1", @"2"]}), ([NSSet setWithObjects:@1, @2, nil]));
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue(@{@"BS" : @[[NSData data]]}), [NSSet setWithObject:[NSData data]]);
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue((@{@"L" : @[@{@"S" : @"a"}, @{@"NULL" : @YES}]})), (@[@"a", [NSNull null]]));
+    XCTAssertEqualObjects(AWSDynamoDBObjectFromJSONAttributeValue((@{@"M" : @{@"a" : @{@"M" : @{@"b" : @{@"N" : @"1"}}}}})), (@{@"a" : @{@"b" : @1}}));
+    XCTAssertNil(AWSDynamoDBObjectFromJSONAttributeValue(@{@"NULL" : @YES}));
+}
+
+- (void)testModelFromJSONItem {
+    NSMutableDictionary *JSONItem = [[self JSONItemAtIndex:7] mutableCopy];
+    JSONItem[@"cover"] = @{@"B" : [@"cover" dataUsingEncoding:NSUTF8StringEncoding]};
+    JSONItem[@"unknownAttribute"] = @{@"S" : @"ignored"};
+    JSONItem[@"cachedSummary"] = @{@"NULL" : @YES};
+
+    NSError *error = nil;
+    AWSDynamoDBCodecTestBook *book = [[AWSDynamoDBObjectMapperCodec codecForClass:[AWSDynamoDBCodecTestBook class]] modelFromJSONItem:JSONItem
+                                                                                                                             error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(book.ISBN, @"978-0-00000007");
+    XCTAssertEqualObjects(book.edition, @2);
+    XCTAssertEqualObjects(book.price, @54.95);
+    XCTAssertEqual(book.pageCount, 407);
+    XCTAssertEqualObjects(book.inStock, @YES);
+    XCTAssertEqualObjects(book.tags, ([NSSet setWithObjects:@"lisp", @"classic", @"computer-science", nil]));
+    XCTAssertEqualObjects(book.ratings, ([NSSet setWithObjects:@5, @4, @3, nil]));
+    XCTAssertEqual([book.chapters count], 3);
+    XCTAssertEqualObjects(book.details[@"weight"], @1.2);
+    XCTAssertEqualObjects(book.cover, [@"cover" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects(book.publishedAt, [NSDate dateWithTimeIntervalSince1970:838857600]);
+    XCTAssertNil(book.cachedSummary);
+}
+
+- (void)testModelFromJSONItemMatchesMantleAdapter {
+    NSDictionary *JSONItem = [self JSONItemAtIndex:3];
+    AWSDynamoDBCodecTestBook *book = [[AWSDynamoDBObjectMapperCodec codecForClass:[AWSDynamoDBCodecTestBook class]] modelFromJSONItem:JSONItem
+                                                                                                                             error:nil];
+
+    NSDictionary *attributeValues = [AWSModelUtility mapMTLDictionaryFromJSONDictionary:JSONItem
+                                                                         withModelClass:[AWSDynamoDBAttributeValue class]];
+    NSMutableDictionary *plainItem = [NSMutableDictionary new];
+    for (NSString *attributeName in attributeValues) {
+        plainItem[attributeName] = AWSDynamoDBCodecTestsPlainValue(attributeValues[attributeName]);
+    }
+    AWSDynamoDBCodecTestBook *expected = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBCodecTestBook class]
+                                                      fromJSONDictionary:plainItem
+                                                                   error:nil];
+
+    XCTAssertEqualObjects(book, expected);
+}
+
+- (void)testItemForPutItemInput {
+    AWSDynamoDBCodecTestBook *book = [AWSDynamoDBCodecTestBook new];
+    book.ISBN = @"978-0262510875";
+    book.edition = @2;
+    book.pageCount = 657;
+    book.tags = [NSSet setWithObject:@"lisp"];
+    book.publishedAt = [NSDate dateWithTimeIntervalSince1970:838857600];
+    book.cachedSummary = @"Not stored";
+
+    NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *item = [book itemForPutItemInput];
+    XCTAssertEqualObjects(item[@"isbn"].S, @"978-0262510875");
+    XCTAssertEqualObjects(item[@"edition"].N, @"2");
+    XCTAssertEqualObjects(item[@"pageCount"].N, @"657");
+    XCTAssertEqualObjects(item[@"tags"].SS, @[@"lisp"]);
+    XCTAssertEqualObjects(item[@"published_at"].N, @"838857600");
+    XCTAssertNil(item[@"title"]);
+    XCTAssertNil(item[@"cachedSummary"]);
+    XCTAssertNil(item[@"ISBN"]);
+}
+
+- (void)testItemForUpdateItemInput {
+    AWSDynamoDBCodecTestBook *book = [AWSDynamoDBCodecTestBook new];
+    book.ISBN = @"978-0262510875";
+    book.edition = @2;
+    book.ratings = [NSSet setWithObject:@5];
+
+    NSDictionary<NSString *, AWSDynamoDBAttributeValueUpdate *> *update = [book itemForUpdateItemInput:AWSDynamoDBObjectMapperSaveBehaviorUpdate];
+    XCTAssertNil(update[@"isbn"]);
+    XCTAssertNil(update[@"edition"]);
+    XCTAssertNil(update[@"cachedSummary"]);
+    XCTAssertEqual(update[@"ratings"].action, AWSDynamoDBAttributeActionPut);
+    XCTAssertEqualObjects(update[@"ratings"].value.NS, @[@"5"]);
+    XCTAssertEqual(update[@"title"].action, AWSDynamoDBAttributeActionDelete);
+
+    update = [book itemForUpdateItemInput:AWSDynamoDBObjectMapperSaveBehaviorAppendSet];
+    XCTAssertEqual(update[@"ratings"].action, AWSDynamoDBAttributeActionAdd);
+    XCTAssertNil(update[@"title"]);
+
+    NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *key = [book key];
+    XCTAssertEqual([key count], 2);
+    XCTAssertEqualObjects(key[@"isbn"].S, @"978-0262510875");
+    XCTAssertEqualObjects(key[@"edition"].N, @"2");
+}
+
+- (void)testQueryDecodesItemsFromResponse {
+    NSString *key = @"testQueryDecodesItemsFromResponse";
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1 credentialsProvider:nil];
+    [AWSDynamoDBObjectMapper registerDynamoDBObjectMapperWithConfiguration:configuration
+                                                 objectMapperConfiguration:[AWSDynamoDBObjectMapperConfiguration new]
+                                                                    forKey:key];
+    AWSDynamoDBObjectMapper *objectMapper = [AWSDynamoDBObjectMapper DynamoDBObjectMapperForKey:key];
+
+    NSDictionary *response = @{@"Items" : @[[self JSONItemAtIndex:0], [self JSONItemAtIndex:1]],
+                               @"LastEvaluatedKey" : @{@"isbn" : @{@"S" : @"978-0-00000001"},
+                                                       @"edition" : @{@"N" : @"2"}}};
+    id mockNetworking = OCMClassMock([AWSNetworking class]);
+    OCMStub([mockNetworking sendRequest:[OCMArg checkWithBlock:^BOOL(AWSNetworkingRequest *request) {
+        return [request.headers[@"X-Amz-Target"] isEqualToString:@"DynamoDB_20120810.Query"];
+    }]]).andReturn([AWSTask taskWithResult:response]);
+    [[objectMapper valueForKey:@"dynamoDB"] setValue:mockNetworking forKey:@"networking"];
+
+    AWSDynamoDBQueryExpression *expression = [AWSDynamoDBQueryExpression new];
+    expression.keyConditionExpression = @"isbn = :isbn";
+    expression.expressionAttributeValues = @{@":isbn" : @"978-0-00000001"};
+    AWSTask<AWSDynamoDBPaginatedOutput *> *task = [objectMapper query:[AWSDynamoDBCodecTestBook class]
+                                                           expression:expression];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertEqual([task.result.items count], 2);
+    XCTAssertEqualObjects([task.result.items[1] ISBN], @"978-0-00000001");
+    XCTAssertEqualObjects(task.result.lastEvaluatedKey[@"isbn"].S, @"978-0-00000001");
+    XCTAssertEqualObjects(task.result.lastEvaluatedKey[@"edition"].N, @"2");
+
+    [AWSDynamoDBObjectMapper removeDynamoDBObjectMapperForKey:key];
+}
+
+- (void)testPerformanceDecodeQueryPageThroughAttributeValues {
+    NSDictionary *page = [self JSONQueryPage];
+    [self measureBlock:^{
+        AWSDynamoDBQueryOutput *queryOutput = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBQueryOutput class]
+                                                           fromJSONDictionary:page
+                                                                        error:nil];
+        for (NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *item in queryOutput.items) {
+            NSMutableDictionary *plainItem = [NSMutableDictionary new];
+            for (NSString *attributeName in item) {
+                plainItem[attributeName] = AWSDynamoDBCodecTestsPlainValue(item[attributeName]);
+            }
+            [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBCodecTestBook class]
+                         fromJSONDictionary:plainItem
+                                      error:nil];
+        }
+    }];
+}
+
+- (void)testPerformanceDecodeQueryPageWithCodec {
+    NSDictionary *page = [self JSONQueryPage];
+    AWSDynamoDBObjectMapperCodec *codec = [AWSDynamoDBObjectMapperCodec codecForClass:[AWSDynamoDBCodecTestBook class]];
+    [self measureBlock:^{
+        for (NSDictionary *JSONItem in page[@"Items"]) {
+            [codec modelFromJSONItem:JSONItem error:nil];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,284 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSDynamoDB.h"
+#import "TestDynamoDBServer.h"
+
+static NSString *const AWSDynamoDBObjectMapperScanTestsKey = @"AWSDynamoDBObjectMapperScanTests";
+
+@interface AWSDynamoDBScanTestBook : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *ISBN;
+@property (nonatomic, strong) NSString *title;
+
+@end
+
+@implementation AWSDynamoDBScanTestBook
+
++ (NSString *)dynamoDBTableName {
+    return @"Books";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"ISBN";
+}
+
+@end
+
+@interface AWSDynamoDBScanTestMissingTable : AWSDynamoDBObjectModel <AWSDynamoDBModeling>
+
+@property (nonatomic, strong) NSString *name;
+
+@end
+
+@implementation AWSDynamoDBScanTestMissingTable
+
++ (NSString *)dynamoDBTableName {
+    return @"Missing";
+}
+
++ (NSString *)hashKeyAttribute {
+    return @"name";
+}
+
+@end
+
+@interface AWSDynamoDBObjectMapperScanTests : XCTestCase
+
+@property (nonatomic, strong) TestDynamoDBServer *server;
+@property (nonatomic, strong) AWSDynamoDBObjectMapper *objectMapper;
+@property (nonatomic, strong) AWSDynamoDBObjectMapperConfiguration *objectMapperConfiguration;
+
+@end
+
+@implementation AWSDynamoDBObjectMapperScanTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestDynamoDBServer new];
+    XCTAssertTrue([self.server start]);
+    [self.server createTableNamed:@"Books" hashKey:@"ISBN" rangeKey:nil];
+    for (NSUInteger i = 0; i < 500; i++) {
+        [self.server putItem:@{@"ISBN" : @{@"S" : [NSString stringWithFormat:@"978-%09lu", (unsigned long)i]},
+                               @"title" : @{@"S" : [NSString stringWithFormat:@"Book %lu", (unsigned long)i]}}
+                     inTable:@"Books"];
+    }
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceDynamoDB
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSDynamoDBObjectMapper registerDynamoDBObjectMapperWithConfiguration:configuration
+                                                 objectMapperConfiguration:[AWSDynamoDBObjectMapperConfiguration new]
+                                                                    forKey:AWSDynamoDBObjectMapperScanTestsKey];
+    self.objectMapper = [AWSDynamoDBObjectMapper DynamoDBObjectMapperForKey:AWSDynamoDBObjectMapperScanTestsKey];
+    self.objectMapperConfiguration = [AWSDynamoDBObjectMapperConfiguration new];
+}
+
+- (void)tearDown {
+    [AWSDynamoDBObjectMapper removeDynamoDBObjectMapperForKey:AWSDynamoDBObjectMapperScanTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+- (AWSDynamoDBScanExpression *)expressionWithLimit:(NSUInteger)limit {
+    AWSDynamoDBScanExpression *expression = [AWSDynamoDBScanExpression new];
+    expression.limit = @(limit);
+    return expression;
+}
+
+- (BOOL)waitForRequestCount:(NSUInteger)requestCount {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+    while (self.server.requestCount < requestCount && [deadline timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    return self.server.requestCount >= requestCount;
+}
+
+#pragma mark - Parallel scan
+
+- (void)testParallelScanReturnsEveryItemOnce {
+    self.objectMapperConfiguration.maximumConcurrentScanSegments = 3;
+    self.server.responseDelay = 0.01;
+    NSMutableSet<NSString *> *ISBNs = [NSMutableSet new];
+    __block NSUInteger itemCount = 0;
+
+    AWSTask *task = [self.objectMapper parallelScan:[AWSDynamoDBScanTestBook class]
+                                         expression:[self expressionWithLimit:20]
+                                      totalSegments:8
+                                      configuration:self.objectMapperConfiguration
+                                  cancellationToken:nil
+                                        pageHandler:^(NSArray<AWSDynamoDBScanTestBook *> *items, BOOL *stop) {
+        XCTAssertLessThanOrEqual([items count], 20);
+        for (AWSDynamoDBScanTestBook *book in items) {
+            [ISBNs addObject:book.ISBN];
+        }
+        itemCount += [items count];
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertFalse(task.cancelled);
+    XCTAssertEqual(itemCount, 500);
+    XCTAssertEqual([ISBNs count], 500);
+    XCTAssertGreaterThan(self.server.maximumConcurrentRequestCount, 1);
+    XCTAssertLessThanOrEqual(self.server.maximumConcurrentRequestCount, 3);
+}
+
+- (void)testParallelScanStopsWhenPageHandlerSetsStop {
+    __block NSUInteger pageCount = 0;
+
+    AWSTask *task = [self.objectMapper parallelScan:[AWSDynamoDBScanTestBook class]
+                                         expression:[self expressionWithLimit:10]
+                                      totalSegments:4
+                                  cancellationToken:nil
+                                        pageHandler:^(NSArray<AWSDynamoDBScanTestBook *> *items, BOOL *stop) {
+        pageCount++;
+        *stop = YES;
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertFalse(task.cancelled);
+    XCTAssertEqual(pageCount, 1);
+    XCTAssertLessThanOrEqual(self.server.requestCount, 4);
+}
+
+- (void)testParallelScanCancellation {
+    AWSCancellationTokenSource *cancellationTokenSource = [AWSCancellationTokenSource cancellationTokenSource];
+    __block NSUInteger pageCount = 0;
+
+    AWSTask *task = [self.objectMapper parallelScan:[AWSDynamoDBScanTestBook class]
+                                         expression:[self expressionWithLimit:10]
+                                      totalSegments:4
+                                  cancellationToken:cancellationTokenSource.token
+                                        pageHandler:^(NSArray<AWSDynamoDBScanTestBook *> *items, BOOL *stop) {
+        pageCount++;
+        [cancellationTokenSource cancel];
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertTrue(task.cancelled);
+    XCTAssertEqual(pageCount, 1);
+}
+
+- (void)testParallelScanCancelledFromAnotherThreadWhileThePageHandlerWaits {
+    AWSCancellationTokenSource *cancellationTokenSource = [AWSCancellationTokenSource cancellationTokenSource];
+    __block NSUInteger pageCount = 0;
+    __block long waitResult = 0;
+
+    AWSTask *task = [self.objectMapper parallelScan:[AWSDynamoDBScanTestBook class]
+                                         expression:[self expressionWithLimit:10]
+                                      totalSegments:4
+                                  cancellationToken:cancellationTokenSource.token
+                                        pageHandler:^(NSArray<AWSDynamoDBScanTestBook *> *items, BOOL *stop) {
+        pageCount++;
+        dispatch_semaphore_t cancelled = dispatch_semaphore_create(0);
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [cancellationTokenSource cancel];
+            dispatch_semaphore_signal(cancelled);
+        });
+        waitResult = dispatch_semaphore_wait(cancelled, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(5 * NSEC_PER_SEC)));
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertEqual(waitResult, 0, @"Cancelling the scan blocked on the page handler.");
+    XCTAssertTrue(task.cancelled);
+    XCTAssertEqual(pageCount, 1);
+}
+
+- (void)testParallelScanReportsRequestErrors {
+    __block NSUInteger pageCount = 0;
+
+    AWSTask *task = [self.objectMapper parallelScan:[AWSDynamoDBScanTestMissingTable class]
+                                         expression:[AWSDynamoDBScanExpression new]
+                                      totalSegments:4
+                                  cancellationToken:nil
+                                        pageHandler:^(NSArray *items, BOOL *stop) {
+        pageCount++;
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(pageCount, 0);
+}
+
+#pragma mark - Prefetch
+
+- (void)testLoadNextPageUsesPrefetchedPage {
+    self.objectMapperConfiguration.prefetchesNextPage = YES;
+    AWSTask<AWSDynamoDBPaginatedOutput *> *task = [self.objectMapper scan:[AWSDynamoDBScanTestBook class]
+                                                               expression:[self expressionWithLimit:200]
+                                                            configuration:self.objectMapperConfiguration];
+    [task waitUntilFinished];
+    AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
+    NSMutableSet<NSString *> *ISBNs = [NSMutableSet setWithArray:[paginatedOutput.items valueForKey:@"ISBN"]];
+    XCTAssertTrue([self waitForRequestCount:2]);
+
+    [[paginatedOutput loadNextPage] waitUntilFinished];
+    [ISBNs addObjectsFromArray:[paginatedOutput.items valueForKey:@"ISBN"]];
+    XCTAssertEqual([paginatedOutput.items count], 200);
+    XCTAssertNotNil(paginatedOutput.lastEvaluatedKey);
+    XCTAssertTrue([self waitForRequestCount:3]);
+
+    [[paginatedOutput loadNextPage] waitUntilFinished];
+    [ISBNs addObjectsFromArray:[paginatedOutput.items valueForKey:@"ISBN"]];
+    XCTAssertEqual([paginatedOutput.items count], 100);
+    XCTAssertNil(paginatedOutput.lastEvaluatedKey);
+
+    XCTAssertEqual([ISBNs count], 500);
+    XCTAssertEqual(self.server.requestCount, 3);
+}
+
+- (void)testReloadDiscardsPrefetchedPage {
+    self.objectMapperConfiguration.prefetchesNextPage = YES;
+    AWSTask<AWSDynamoDBPaginatedOutput *> *task = [self.objectMapper scan:[AWSDynamoDBScanTestBook class]
+                                                               expression:[self expressionWithLimit:200]
+                                                            configuration:self.objectMapperConfiguration];
+    [task waitUntilFinished];
+    AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
+    NSArray<NSString *> *firstPage = [paginatedOutput.items valueForKey:@"ISBN"];
+
+    [[paginatedOutput reload] waitUntilFinished];
+
+    XCTAssertEqualObjects([paginatedOutput.items valueForKey:@"ISBN"], firstPage);
+    XCTAssertNotNil(paginatedOutput.lastEvaluatedKey);
+
+    [[paginatedOutput loadNextPage] waitUntilFinished];
+    XCTAssertEqual([paginatedOutput.items count], 200);
+    XCTAssertFalse([[NSSet setWithArray:[paginatedOutput.items valueForKey:@"ISBN"]] intersectsSet:[NSSet setWithArray:firstPage]]);
+}
+
+- (void)testLoadNextPageWithoutPrefetch {
+    AWSTask<AWSDynamoDBPaginatedOutput *> *task = [self.objectMapper scan:[AWSDynamoDBScanTestBook class]
+                                                               expression:[self expressionWithLimit:200]
+                                                            configuration:self.objectMapperConfiguration];
+    [task waitUntilFinished];
+    AWSDynamoDBPaginatedOutput *paginatedOutput = task.result;
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(self.server.requestCount, 1);
+
+    [[paginatedOutput loadNextPage] waitUntilFinished];
+    XCTAssertEqual([paginatedOutput.items count], 200);
+    XCTAssertEqual(self.server.requestCount, 2);
+}
+
+@end
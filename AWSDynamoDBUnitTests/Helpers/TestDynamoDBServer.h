@@ -0,0 +1,75 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A minimal DynamoDB stand-in that serves BatchGetItem, BatchWriteItem, Query and Scan over HTTP/1.1 on 127.0.0.1. Items
+ are kept in memory as DynamoDB JSON. Like DynamoDB, it rejects batches over 100 keys or 25 writes and batches that name
+ the same key twice with a ValidationException. Scans return items in a stable order, split into segments by hash key.
+ Queries only support key conditions on the hash key, and return its items ordered by range key.
+ */
+@interface TestDynamoDBServer : NSObject
+
+/**
+ The endpoint to point the client at, once the server has started.
+ */
+@property (nonatomic, readonly, nullable) NSURL *URL;
+
+/**
+ The most keys or writes processed per request. The rest are returned as unprocessed. Zero, the default, processes
+ every key.
+ */
+@property (atomic, assign) NSUInteger maximumProcessedPerRequest;
+
+/**
+ How long each request waits before it is answered. Defaults to zero.
+ */
+@property (atomic, assign) NSTimeInterval responseDelay;
+
+/**
+ The number of requests answered so far.
+ */
+@property (atomic, readonly) NSUInteger requestCount;
+
+/**
+ The most requests that were being answered at the same time.
+ */
+@property (atomic, readonly) NSUInteger maximumConcurrentRequestCount;
+
+/**
+ Listens on an ephemeral port.
+
+ @return Whether the server could listen.
+ */
+- (BOOL)start;
+- (void)stop;
+
+- (void)createTableNamed:(NSString *)tableName hashKey:(NSString *)hashKey rangeKey:(nullable NSString *)rangeKey;
+
+- (void)putItem:(NSDictionary *)JSONItem inTable:(NSString *)tableName;
+
+/**
+ Returns the stored item with a key, in DynamoDB JSON.
+ */
+- (nullable NSDictionary *)itemInTable:(NSString *)tableName withKey:(NSDictionary *)JSONKey;
+
+- (NSUInteger)itemCountInTable:(NSString *)tableName;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,523 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "TestDynamoDBServer.h"
+#import <arpa/inet.h>
+#import <netinet/in.h>
+#import <sys/socket.h>
+#import <unistd.h>
+
+static NSString *const TestDynamoDBServerValidationException = @"com.amazonaws.dynamodb.v20120810#ValidationException";
+static NSString *const TestDynamoDBServerResourceNotFoundException = @"com.amazonaws.dynamodb.v20120810#ResourceNotFoundException";
+
+@interface TestDynamoDBServerTable : NSObject
+
+@property (nonatomic, strong) NSString *hashKey;
+@property (nonatomic, strong, nullable) NSString *rangeKey;
+@property (nonatomic, strong) NSMutableDictionary<NSArray *, NSDictionary *> *items;
+
+- (NSArray *)keyOfItem:(NSDictionary *)JSONItem;
+
+@end
+
+@implementation TestDynamoDBServerTable
+
+- (NSArray *)keyOfItem:(NSDictionary *)JSONItem {
+    return @[JSONItem[self.hashKey] ?: [NSNull null],
+             self.rangeKey ? JSONItem[self.rangeKey] ?: [NSNull null] : [NSNull null]];
+}
+
+@end
+
+@interface TestDynamoDBServer()
+
+@property (atomic, assign) NSUInteger requestCount;
+@property (atomic, assign) NSUInteger maximumConcurrentRequestCount;
+
+@end
+
+@implementation TestDynamoDBServer {
+    int listeningSocket;
+    dispatch_source_t acceptSource;
+    NSMutableSet<NSNumber *> *connections;
+    NSMutableDictionary<NSString *, TestDynamoDBServerTable *> *tables;
+    NSUInteger concurrentRequestCount;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        listeningSocket = -1;
+        connections = [NSMutableSet new];
+        tables = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+- (BOOL)start {
+    listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listeningSocket < 0) {
+        return NO;
+    }
+
+    struct sockaddr_in address = {0};
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (bind(listeningSocket, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(listeningSocket, 64) != 0
+        || getsockname(listeningSocket, (struct sockaddr *)&address, &addressLength) != 0) {
+        close(listeningSocket);
+        listeningSocket = -1;
+        return NO;
+    }
+    _URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d", ntohs(address.sin_port)]];
+
+    int socketToAccept = listeningSocket;
+    __weak TestDynamoDBServer *weakSelf = self;
+    acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, socketToAccept, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    dispatch_source_set_event_handler(acceptSource, ^{
+        int connection = accept(socketToAccept, NULL, NULL);
+        if (connection < 0) {
+            return;
+        }
+        int noSigPipe = 1;
+        setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [weakSelf serveConnection:connection];
+        });
+    });
+    dispatch_source_set_cancel_handler(acceptSource, ^{
+        close(socketToAccept);
+    });
+    dispatch_resume(acceptSource);
+    return YES;
+}
+
+- (void)stop {
+    if (acceptSource) {
+        dispatch_source_cancel(acceptSource);
+        acceptSource = nil;
+        listeningSocket = -1;
+    }
+    @synchronized(connections) {
+        for (NSNumber *connection in connections) {
+            shutdown([connection intValue], SHUT_RDWR);
+        }
+    }
+}
+
+#pragma mark - Tables
+
+- (void)createTableNamed:(NSString *)tableName hashKey:(NSString *)hashKey rangeKey:(NSString *)rangeKey {
+    TestDynamoDBServerTable *table = [TestDynamoDBServerTable new];
+    table.hashKey = hashKey;
+    table.rangeKey = rangeKey;
+    table.items = [NSMutableDictionary new];
+    @synchronized(tables) {
+        tables[tableName] = table;
+    }
+}
+
+- (void)putItem:(NSDictionary *)JSONItem inTable:(NSString *)tableName {
+    @synchronized(tables) {
+        TestDynamoDBServerTable *table = tables[tableName];
+        table.items[[table keyOfItem:JSONItem]] = JSONItem;
+    }
+}
+
+- (NSDictionary *)itemInTable:(NSString *)tableName withKey:(NSDictionary *)JSONKey {
+    @synchronized(tables) {
+        TestDynamoDBServerTable *table = tables[tableName];
+        return table.items[[table keyOfItem:JSONKey]];
+    }
+}
+
+- (NSUInteger)itemCountInTable:(NSString *)tableName {
+    @synchronized(tables) {
+        return [tables[tableName].items count];
+    }
+}
+
+#pragma mark - HTTP
+
+// Answers the requests on one keep-alive connection until the client closes it.
+- (void)serveConnection:(int)connection {
+    @synchronized(connections) {
+        [connections addObject:@(connection)];
+    }
+
+    NSMutableData *buffer = [NSMutableData new];
+    while (YES) {
+        NSRange headerEnd;
+        while ((headerEnd = [buffer rangeOfData:[@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding]
+                                        options:0
+                                          range:NSMakeRange(0, buffer.length)]).location == NSNotFound) {
+            if (![self read:connection into:buffer]) {
+                goto closed;
+            }
+        }
+
+        NSString *head = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headerEnd.location)]
+                                               encoding:NSUTF8StringEncoding];
+        NSMutableDictionary<NSString *, NSString *> *headers = [NSMutableDictionary new];
+        NSArray<NSString *> *lines = [head componentsSeparatedByString:@"\r\n"];
+        for (NSString *line in [lines subarrayWithRange:NSMakeRange(1, [lines count] - 1)]) {
+            NSRange colon = [line rangeOfString:@":"];
+            if (colon.location != NSNotFound) {
+                headers[[[line substringToIndex:colon.location] lowercaseString]] = [[line substringFromIndex:colon.location + 1] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+            }
+        }
+
+        NSUInteger bodyStart = NSMaxRange(headerEnd);
+        NSUInteger contentLength = (NSUInteger)[headers[@"content-length"] integerValue];
+        while (buffer.length < bodyStart + contentLength) {
+            if (![self read:connection into:buffer]) {
+                goto closed;
+            }
+        }
+        NSData *body = [buffer subdataWithRange:NSMakeRange(bodyStart, contentLength)];
+        [buffer replaceBytesInRange:NSMakeRange(0, bodyStart + contentLength) withBytes:NULL length:0];
+
+        [self beginRequest];
+        if (self.responseDelay > 0) {
+            [NSThread sleepForTimeInterval:self.responseDelay];
+        }
+        NSInteger statusCode = 200;
+        NSDictionary *response = [self responseForTarget:headers[@"x-amz-target"] body:body statusCode:&statusCode];
+        [self endRequest];
+
+        NSData *responseBody = [NSJSONSerialization dataWithJSONObject:response options:0 error:nil];
+        NSMutableData *responseData = [[[NSString stringWithFormat:@"HTTP/1.1 %ld %@\r\nContent-Type: application/x-amz-json-1.0\r\nContent-Length: %lu\r\nx-amzn-RequestId: %@\r\n\r\n",
+                                         (long)statusCode,
+                                         statusCode == 200 ? @"OK" : @"Bad Request",
+                                         (unsigned long)responseBody.length,
+                                         [[NSUUID UUID] UUIDString]] dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+        [responseData appendData:responseBody];
+        if (![self write:responseData to:connection]) {
+            goto closed;
+        }
+    }
+
+closed:
+    @synchronized(connections) {
+        [connections removeObject:@(connection)];
+    }
+    close(connection);
+}
+
+- (BOOL)read:(int)connection into:(NSMutableData *)buffer {
+    uint8_t bytes[16384];
+    ssize_t length = recv(connection, bytes, sizeof(bytes), 0);
+    if (length <= 0) {
+        return NO;
+    }
+    [buffer appendBytes:bytes length:length];
+    return YES;
+}
+
+- (BOOL)write:(NSData *)data to:(int)connection {
+    NSUInteger offset = 0;
+    while (offset < data.length) {
+        ssize_t written = send(connection, (const uint8_t *)data.bytes + offset, data.length - offset, 0);
+        if (written <= 0) {
+            return NO;
+        }
+        offset += written;
+    }
+    return YES;
+}
+
+- (void)beginRequest {
+    @synchronized(self) {
+        concurrentRequestCount++;
+        self.maximumConcurrentRequestCount = MAX(self.maximumConcurrentRequestCount, concurrentRequestCount);
+    }
+}
+
+- (void)endRequest {
+    @synchronized(self) {
+        concurrentRequestCount--;
+        self.requestCount++;
+    }
+}
+
+#pragma mark - Operations
+
+- (NSDictionary *)responseForTarget:(NSString *)target body:(NSData *)body statusCode:(NSInteger *)statusCode {
+    NSDictionary *input = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil];
+    NSString *errorType = nil;
+    NSString *message = nil;
+    NSDictionary *response = nil;
+    if ([target isEqualToString:@"DynamoDB_20120810.BatchWriteItem"]) {
+        response = [self batchWriteItem:input errorType:&errorType message:&message];
+    } else if ([target isEqualToString:@"DynamoDB_20120810.BatchGetItem"]) {
+        response = [self batchGetItem:input errorType:&errorType message:&message];
+    } else if ([target isEqualToString:@"DynamoDB_20120810.Scan"]) {
+        response = [self scan:input errorType:&errorType message:&message];
+    } else if ([target isEqualToString:@"DynamoDB_20120810.Query"]) {
+        response = [self query:input errorType:&errorType message:&message];
+    } else {
+        errorType = @"com.amazon.coral.service#UnknownOperationException";
+    }
+
+    if (errorType) {
+        *statusCode = 400;
+        return @{@"__type" : errorType, @"message" : message ?: @""};
+    }
+    return response;
+}
+
+- (NSDictionary *)batchWriteItem:(NSDictionary *)input errorType:(NSString **)errorType message:(NSString **)message {
+    NSDictionary<NSString *, NSArray<NSDictionary *> *> *requestItems = input[@"RequestItems"];
+    NSUInteger writeCount = 0;
+    for (NSString *tableName in requestItems) {
+        writeCount += [requestItems[tableName] count];
+    }
+    if (writeCount == 0 || writeCount > 25) {
+        *errorType = TestDynamoDBServerValidationException;
+        *message = @"Too many items requested for the BatchWriteItem call";
+        return nil;
+    }
+
+    NSMutableDictionary *unprocessedItems = [NSMutableDictionary new];
+    @synchronized(tables) {
+        if (![self validateRequestItems:requestItems
+                                keysFor:^NSArray<NSDictionary *> *(id writeRequests) {
+                                    NSMutableArray *keys = [NSMutableArray new];
+                                    for (NSDictionary *writeRequest in writeRequests) {
+                                        [keys addObject:writeRequest[@"PutRequest"][@"Item"] ?: writeRequest[@"DeleteRequest"][@"Key"] ?: @{}];
+                                    }
+                                    return keys;
+                                }
+                              errorType:errorType
+                                message:message]) {
+            return nil;
+        }
+
+        NSUInteger processed = 0;
+        for (NSString *tableName in [[requestItems allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+            TestDynamoDBServerTable *table = tables[tableName];
+            for (NSDictionary *writeRequest in requestItems[tableName]) {
+                if (self.maximumProcessedPerRequest > 0 && processed >= self.maximumProcessedPerRequest) {
+                    if (!unprocessedItems[tableName]) {
+                        unprocessedItems[tableName] = [NSMutableArray new];
+                    }
+                    [unprocessedItems[tableName] addObject:writeRequest];
+                    continue;
+                }
+                processed++;
+
+                NSDictionary *item = writeRequest[@"PutRequest"][@"Item"];
+                if (item) {
+                    table.items[[table keyOfItem:item]] = item;
+                } else {
+                    [table.items removeObjectForKey:[table keyOfItem:writeRequest[@"DeleteRequest"][@"Key"]]];
+                }
+            }
+        }
+    }
+    return @{@"UnprocessedItems" : unprocessedItems};
+}
+
+- (NSDictionary *)batchGetItem:(NSDictionary *)input errorType:(NSString **)errorType message:(NSString **)message {
+    NSDictionary<NSString *, NSDictionary *> *requestItems = input[@"RequestItems"];
+    NSUInteger keyCount = 0;
+    for (NSString *tableName in requestItems) {
+        keyCount += [requestItems[tableName][@"Keys"] count];
+    }
+    if (keyCount == 0 || keyCount > 100) {
+        *errorType = TestDynamoDBServerValidationException;
+        *message = @"Too many items requested for the BatchGetItem call";
+        return nil;
+    }
+
+    NSMutableDictionary *responses = [NSMutableDictionary new];
+    NSMutableDictionary *unprocessedKeys = [NSMutableDictionary new];
+    @synchronized(tables) {
+        if (![self validateRequestItems:requestItems
+                                keysFor:^NSArray<NSDictionary *> *(id keysAndAttributes) {
+                                    return keysAndAttributes[@"Keys"];
+                                }
+                              errorType:errorType
+                                message:message]) {
+            return nil;
+        }
+
+        NSUInteger processed = 0;
+        for (NSString *tableName in [[requestItems allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+            TestDynamoDBServerTable *table = tables[tableName];
+            responses[tableName] = [NSMutableArray new];
+            for (NSDictionary *key in requestItems[tableName][@"Keys"]) {
+                if (self.maximumProcessedPerRequest > 0 && processed >= self.maximumProcessedPerRequest) {
+                    if (!unprocessedKeys[tableName]) {
+                        unprocessedKeys[tableName] = @{@"Keys" : [NSMutableArray new]};
+                    }
+                    [unprocessedKeys[tableName][@"Keys"] addObject:key];
+                    continue;
+                }
+                processed++;
+
+                NSDictionary *item = table.items[[table keyOfItem:key]];
+                if (item) {
+                    [responses[tableName] addObject:item];
+                }
+            }
+        }
+    }
+    return @{@"Responses" : responses,
+             @"UnprocessedKeys" : unprocessedKeys};
+}
+
+- (NSDictionary *)scan:(NSDictionary *)input errorType:(NSString **)errorType message:(NSString **)message {
+    NSUInteger totalSegments = MAX([input[@"TotalSegments"] unsignedIntegerValue], 1);
+    NSUInteger segment = [input[@"Segment"] unsignedIntegerValue];
+    NSUInteger limit = [input[@"Limit"] unsignedIntegerValue] ?: NSUIntegerMax;
+    if (segment >= totalSegments) {
+        *errorType = TestDynamoDBServerValidationException;
+        *message = @"The Segment parameter is zero-based and must be less than parameter TotalSegments";
+        return nil;
+    }
+
+    @synchronized(tables) {
+        TestDynamoDBServerTable *table = tables[input[@"TableName"]];
+        if (!table) {
+            *errorType = TestDynamoDBServerResourceNotFoundException;
+            *message = @"Requested resource not found";
+            return nil;
+        }
+
+        NSString *startKey = input[@"ExclusiveStartKey"] ? [[table keyOfItem:input[@"ExclusiveStartKey"]] description] : nil;
+        NSMutableArray<NSArray *> *keys = [NSMutableArray new];
+        for (NSArray *key in table.items) {
+            if ([[key.firstObject description] hash] % totalSegments == segment
+                && (!startKey || [[key description] compare:startKey] == NSOrderedDescending)) {
+                [keys addObject:key];
+            }
+        }
+        [keys sortUsingComparator:^NSComparisonResult(NSArray *key1, NSArray *key2) {
+            return [[key1 description] compare:[key2 description]];
+        }];
+        return [self pageOfKeys:keys inTable:table limit:limit];
+    }
+}
+
+// Supports key conditions that compare the hash key for equality, such as `#author = :author`.
+- (NSDictionary *)query:(NSDictionary *)input errorType:(NSString **)errorType message:(NSString **)message {
+    NSUInteger limit = [input[@"Limit"] unsignedIntegerValue] ?: NSUIntegerMax;
+    BOOL scanIndexForward = input[@"ScanIndexForward"] ? [input[@"ScanIndexForward"] boolValue] : YES;
+    NSArray<NSString *> *condition = [[input[@"KeyConditionExpression"] stringByReplacingOccurrencesOfString:@" " withString:@""]
+                                      componentsSeparatedByString:@"="];
+    NSString *attributeName = [condition firstObject];
+    attributeName = input[@"ExpressionAttributeNames"][attributeName] ?: attributeName;
+    NSDictionary *hashKeyValue = [condition count] == 2 ? input[@"ExpressionAttributeValues"][condition[1]] : nil;
+
+    @synchronized(tables) {
+        TestDynamoDBServerTable *table = tables[input[@"TableName"]];
+        if (!table) {
+            *errorType = TestDynamoDBServerResourceNotFoundException;
+            *message = @"Requested resource not found";
+            return nil;
+        }
+        if (![attributeName isEqualToString:table.hashKey] || !hashKeyValue) {
+            *errorType = TestDynamoDBServerValidationException;
+            *message = @"Query condition missed key schema element";
+            return nil;
+        }
+
+        NSString *startKey = input[@"ExclusiveStartKey"] ? [[table keyOfItem:input[@"ExclusiveStartKey"]] description] : nil;
+        NSMutableArray<NSArray *> *keys = [NSMutableArray new];
+        for (NSArray *key in table.items) {
+            if (![key.firstObject isEqual:hashKeyValue]) {
+                continue;
+            }
+            NSComparisonResult order = startKey ? [[key description] compare:startKey] : NSOrderedSame;
+            if (!startKey
+                || (scanIndexForward && order == NSOrderedDescending)
+                || (!scanIndexForward && order == NSOrderedAscending)) {
+                [keys addObject:key];
+            }
+        }
+        [keys sortUsingComparator:^NSComparisonResult(NSArray *key1, NSArray *key2) {
+            return scanIndexForward ? [[key1 description] compare:[key2 description]] : [[key2 description] compare:[key1 description]];
+        }];
+        return [self pageOfKeys:keys inTable:table limit:limit];
+    }
+}
+
+// Returns the items of the first `limit` keys, with the key to continue from if there are more. Must be called while
+// holding `tables`.
+- (NSDictionary *)pageOfKeys:(NSArray<NSArray *> *)keys inTable:(TestDynamoDBServerTable *)table limit:(NSUInteger)limit {
+    NSMutableArray<NSDictionary *> *items = [NSMutableArray new];
+    for (NSArray *key in keys) {
+        if ([items count] == limit) {
+            break;
+        }
+        [items addObject:table.items[key]];
+    }
+
+    NSMutableDictionary *response = [@{@"Items" : items,
+                                       @"Count" : @([items count]),
+                                       @"ScannedCount" : @([items count])} mutableCopy];
+    if ([items count] < [keys count]) {
+        NSDictionary *lastItem = [items lastObject];
+        NSMutableDictionary *lastEvaluatedKey = [NSMutableDictionary new];
+        lastEvaluatedKey[table.hashKey] = lastItem[table.hashKey];
+        if (table.rangeKey) {
+            lastEvaluatedKey[table.rangeKey] = lastItem[table.rangeKey];
+        }
+        response[@"LastEvaluatedKey"] = lastEvaluatedKey;
+    }
+    return response;
+}
+
+// Checks that every table exists and that no table is given the same key twice. Must be called while holding `tables`.
+- (BOOL)validateRequestItems:(NSDictionary<NSString *, id> *)requestItems
+                     keysFor:(NSArray<NSDictionary *> *(^)(id tableRequest))keysFor
+                   errorType:(NSString **)errorType
+                     message:(NSString **)message {
+    for (NSString *tableName in requestItems) {
+        TestDynamoDBServerTable *table = tables[tableName];
+        if (!table) {
+            *errorType = TestDynamoDBServerResourceNotFoundException;
+            *message = @"Requested resource not found";
+            return NO;
+        }
+
+        NSMutableSet *keys = [NSMutableSet new];
+        for (NSDictionary *item in keysFor(requestItems[tableName])) {
+            NSArray *key = [table keyOfItem:item];
+            if ([key.firstObject isEqual:[NSNull null]]) {
+                *errorType = TestDynamoDBServerValidationException;
+                *message = @"The provided key element does not match the schema";
+                return NO;
+            }
+            if ([keys containsObject:key]) {
+                *errorType = TestDynamoDBServerValidationException;
+                *message = @"Provided list of item keys contains duplicates";
+                return NO;
+            }
+            [keys addObject:key];
+        }
+    }
+    return YES;
+}
+
+@end
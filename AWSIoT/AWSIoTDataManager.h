@@ -116,6 +116,29 @@ NS_ASSUME_NONNULL_BEGIN
  **/
 @property (nonatomic, copy) NSString *password;
 
+/**
+ Whether messages published while the connection is down are kept on disk and sent in order once it is back, even
+ after the app is restarted. Queued messages are sent at no more than `publishRetryThrottle` messages per second,
+ together with retries. Default value: NO
+ **/
+@property (nonatomic, assign) BOOL offlinePublishQueueEnabled;
+
+/**
+ The most payload and topic bytes the offline publish queue keeps, or 0 for no limit. Default value: 1 MB
+ **/
+@property (nonatomic, assign) NSUInteger offlinePublishQueueByteLimit;
+
+/**
+ The most messages the offline publish queue keeps, or 0 for no limit. Default value: 1000
+ **/
+@property (nonatomic, assign) NSUInteger offlinePublishQueueMessageLimit;
+
+/**
+ What happens to a message published while the offline publish queue is full.
+ Default value: AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest
+ **/
+@property (nonatomic, assign) AWSIoTMQTTOfflinePublishQueueEvictionPolicy offlinePublishQueueEvictionPolicy;
+
 
 /**
  Create an AWSIoTMQTTConfiguration object and initialize its parameters.
@@ -548,6 +571,12 @@ DEPRECATED_MSG_ATTRIBUTE("Use `updateUserMetaData` for updating the user meta da
  */
 - (AWSIoTMQTTStatus)getConnectionStatus;
 
+/**
+ Get the number of messages in the offline publish queue, including messages sent but not yet acknowledged.
+ @return The queue depth, or 0 if the offline publish queue is not enabled.
+ */
+- (NSUInteger)offlinePublishQueueDepth;
+
 /**
  Send MQTT message to specified topic
 
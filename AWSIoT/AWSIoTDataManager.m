@@ -167,6 +167,10 @@ static NSString *const AWSInfoIoTDataManager = @"IoTDataManager";
         _autoResubscribe = ars;
         _lastWillAndTestament = lwt;
         _publishRetryThrottle = 100; //Default to 100 if not specified.
+        _offlinePublishQueueEnabled = NO;
+        _offlinePublishQueueByteLimit = 1024 * 1024;
+        _offlinePublishQueueMessageLimit = 1000;
+        _offlinePublishQueueEvictionPolicy = AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest;
         AWSDDLogInfo(@"Initializing AWSIoTMqttConfiguration with KeepAlive:%f, baseReconnectTime:%f,"
                      "minimumConnectionTime:%f, maximumReconnectTime:%f, autoResubscribe:%@, lwt topic:%@ message:%@ ",
                      _keepAliveTimeInterval, _baseReconnectTimeInterval, _minimumConnectionTimeInterval,
@@ -196,6 +200,10 @@ static NSString *const AWSInfoIoTDataManager = @"IoTDataManager";
         _autoResubscribe = ars;
         _lastWillAndTestament = lwt;
         _publishRetryThrottle = prt;
+        _offlinePublishQueueEnabled = NO;
+        _offlinePublishQueueByteLimit = 1024 * 1024;
+        _offlinePublishQueueMessageLimit = 1000;
+        _offlinePublishQueueEvictionPolicy = AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest;
         AWSDDLogInfo(@"Initializing AWSIoTMqttConfiguration with KeepAlive:%f, baseReconnectTime:%f,"
                      "minimumConnectionTime:%f, maximumReconnectTime:%f, autoResubscribe:%@, lwt topic:%@ message:%@ ",
                      _keepAliveTimeInterval, _baseReconnectTimeInterval, _minimumConnectionTimeInterval,
@@ -458,6 +466,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     [self.mqttClient setMaximumReconnectTime:self.mqttConfiguration.maximumReconnectTimeInterval];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
     [self.mqttClient setPublishRetryThrottle:self.mqttConfiguration.publishRetryThrottle];
+    [self.mqttClient setOfflinePublishQueueEnabled:self.mqttConfiguration.offlinePublishQueueEnabled];
+    [self.mqttClient setOfflinePublishQueueByteLimit:self.mqttConfiguration.offlinePublishQueueByteLimit];
+    [self.mqttClient setOfflinePublishQueueMessageLimit:self.mqttConfiguration.offlinePublishQueueMessageLimit];
+    [self.mqttClient setOfflinePublishQueueEvictionPolicy:self.mqttConfiguration.offlinePublishQueueEvictionPolicy];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
     
     return [self.mqttClient connectWithClientId:clientId
@@ -497,6 +509,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     [self.mqttClient setMaximumReconnectTime:self.mqttConfiguration.maximumReconnectTimeInterval];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
     [self.mqttClient setPublishRetryThrottle:self.mqttConfiguration.publishRetryThrottle];
+    [self.mqttClient setOfflinePublishQueueEnabled:self.mqttConfiguration.offlinePublishQueueEnabled];
+    [self.mqttClient setOfflinePublishQueueByteLimit:self.mqttConfiguration.offlinePublishQueueByteLimit];
+    [self.mqttClient setOfflinePublishQueueMessageLimit:self.mqttConfiguration.offlinePublishQueueMessageLimit];
+    [self.mqttClient setOfflinePublishQueueEvictionPolicy:self.mqttConfiguration.offlinePublishQueueEvictionPolicy];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
     
     return [self.mqttClient connectWithClientId:clientId
@@ -538,6 +554,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     [self.mqttClient setMaximumReconnectTime:self.mqttConfiguration.maximumReconnectTimeInterval];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
     [self.mqttClient setPublishRetryThrottle:self.mqttConfiguration.publishRetryThrottle];
+    [self.mqttClient setOfflinePublishQueueEnabled:self.mqttConfiguration.offlinePublishQueueEnabled];
+    [self.mqttClient setOfflinePublishQueueByteLimit:self.mqttConfiguration.offlinePublishQueueByteLimit];
+    [self.mqttClient setOfflinePublishQueueMessageLimit:self.mqttConfiguration.offlinePublishQueueMessageLimit];
+    [self.mqttClient setOfflinePublishQueueEvictionPolicy:self.mqttConfiguration.offlinePublishQueueEvictionPolicy];
     [self.mqttClient setAutoResubscribe:self.mqttConfiguration.autoResubscribe];
 
     return [self.mqttClient connectWithClientId:clientId
@@ -569,6 +589,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     return self.mqttClient.mqttStatus;
 }
 
+- (NSUInteger)offlinePublishQueueDepth {
+    return self.mqttClient.offlinePublishQueueDepth;
+}
+
 - (BOOL)publishString:(NSString *)string
               onTopic:(NSString *)topic
                   QoS:(AWSIoTMQTTQoS)qos
@@ -584,12 +608,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         return NO;
     }
     
-    [self.mqttClient publishString:string
-                               qos:(UInt8)qos
-                           onTopic:topic
-                       ackCallback:ackCallback];
-    
-    return YES;
+    return [self.mqttClient publishString:string
+                                      qos:(UInt8)qos
+                                  onTopic:topic
+                              ackCallback:ackCallback];
 }
 
 - (BOOL)publishString:(NSString *)string
@@ -607,9 +629,7 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         return NO;
     }
     
-    [self.mqttClient publishString:string qos:(UInt8)qos onTopic:topic];
-
-    return YES;
+    return [self.mqttClient publishString:string qos:(UInt8)qos onTopic:topic];
 }
 
 
@@ -628,11 +648,10 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         return NO;
     }
     
-    [self.mqttClient publishData:data
-                             qos:(UInt8)qos
-                         onTopic:topic
-                     ackCallback:ackCallback];
-    return YES;
+    return [self.mqttClient publishData:data
+                                    qos:(UInt8)qos
+                                onTopic:topic
+                            ackCallback:ackCallback];
 }
 
 - (BOOL)publishData:(NSData *)data
@@ -649,8 +668,7 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         return NO;
     }
     
-    [self.mqttClient publishData:data qos:(UInt8)qos onTopic:topic];
-    return YES;
+    return [self.mqttClient publishData:data qos:(UInt8)qos onTopic:topic];
 }
 
 - (BOOL)subscribeToTopic:(NSString *)topic
@@ -32,6 +32,18 @@ typedef NS_ENUM(NSInteger, AWSIoTMQTTQoS) {
     AWSIoTMQTTQoSMessageDeliveryAttemptedAtLeastOnce = 1
 };
 
+/**
+ What happens when a message is published while the offline publish queue is full.
+ */
+typedef NS_ENUM(NSInteger, AWSIoTMQTTOfflinePublishQueueEvictionPolicy) {
+    /** The oldest queued messages are removed to make room for the new one. */
+    AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest,
+    /** The new message is dropped, and the publish call still succeeds. */
+    AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropNewest,
+    /** The new message is dropped, and the publish call fails. */
+    AWSIoTMQTTOfflinePublishQueueEvictionPolicyReject
+};
+
 typedef void(^AWSIoTMQTTNewMessageBlock)(NSData *data);
 typedef void(^AWSIoTMQTTExtendedNewMessageBlock)(NSObject *mqttClient, NSString *topic, NSData *data);
 typedef void(^AWSIoTMQTTAckBlock)(void);
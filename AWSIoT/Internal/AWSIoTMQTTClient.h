@@ -90,6 +90,34 @@
 
 @property(atomic, assign) BOOL isMetricsEnabled;
 @property(atomic, assign) NSUInteger publishRetryThrottle;
+
+/**
+ Whether messages published while the client is not connected are kept on disk and sent once it connects, instead of
+ being held in memory. The queue is opened for each client ID when connecting, so these settings take effect on the
+ next connect. Defaults to `NO`.
+ */
+@property(atomic, assign) BOOL offlinePublishQueueEnabled;
+
+/**
+ The most payload and topic bytes the offline publish queue keeps, or 0 for no limit. Defaults to 1 MB.
+ */
+@property(atomic, assign) NSUInteger offlinePublishQueueByteLimit;
+
+/**
+ The most messages the offline publish queue keeps, or 0 for no limit. Defaults to 1000.
+ */
+@property(atomic, assign) NSUInteger offlinePublishQueueMessageLimit;
+
+/**
+ What happens to a message published while the offline publish queue is full. Defaults to
+ `AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest`.
+ */
+@property(atomic, assign) AWSIoTMQTTOfflinePublishQueueEvictionPolicy offlinePublishQueueEvictionPolicy;
+
+/**
+ The number of messages in the offline publish queue, including messages sent but not yet acknowledged.
+ */
+@property(atomic, assign, readonly) NSUInteger offlinePublishQueueDepth;
 @property(atomic, copy) NSString *userMetaData;
 @property(atomic, copy) NSString *password;
 
@@ -170,8 +198,10 @@
 
  @param topic The topic for publish to.
 
+ @return NO if the message was rejected because the offline publish queue is full.
+
  */
-- (void)publishString:(NSString *)str
+- (BOOL)publishString:(NSString *)str
                   qos:(UInt8)qos
               onTopic:(NSString *)topic;
 
@@ -186,8 +216,10 @@
 
  @param ackCallback the callback for ack if QoS > 0.
 
+ @return NO if the message was rejected because the offline publish queue is full.
+
  */
-- (void)publishString:(NSString *)str
+- (BOOL)publishString:(NSString *)str
                   qos:(UInt8)qos
               onTopic:(NSString *)topic
           ackCallback:(AWSIoTMQTTAckBlock)ackCallback;
@@ -212,8 +244,10 @@
 
  @param topic The topic for publish to.
 
+ @return NO if the message was rejected because the offline publish queue is full.
+
  */
-- (void)publishData:(NSData *)data
+- (BOOL)publishData:(NSData *)data
                 qos:(UInt8)qos
             onTopic:(NSString *)topic;
 
@@ -228,8 +262,10 @@
 
  @param ackCallback the callback for ack if QoS > 0.
 
+ @return NO if the message was rejected because the offline publish queue is full.
+
  */
-- (void)publishData:(NSData *)data
+- (BOOL)publishData:(NSData *)data
                 qos:(UInt8)qos
             onTopic:(NSString *)topic
         ackCallback:(AWSIoTMQTTAckBlock)ackCallback;
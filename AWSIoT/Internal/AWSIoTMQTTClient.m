@@ -20,6 +20,9 @@
 #import "AWSSRWebSocket.h"
 #import "AWSIoTWebSocketOutputStream.h"
 #import "AWSIoTKeychain.h"
+#import "AWSMQTTOfflinePublishQueue.h"
+
+static NSString *const AWSIoTMQTTClientOfflinePublishQueueDirectory = @"com.amazonaws.AWSIoTOfflinePublishQueue";
 
 @implementation AWSIoTMQTTTopicModel
 @end
@@ -59,6 +62,10 @@
 @property UInt16 keepAliveInterval;
 
 @property(nonatomic, strong) NSMutableDictionary<NSNumber *, AWSIoTMQTTAckBlock> *ackCallbackDictionary;
+@property(nonatomic, strong) NSMutableDictionary<NSNumber *, AWSIoTMQTTAckBlock> *offlineAckCallbackDictionary; //Ack callbacks of queued messages, keyed by queue identifier until they are sent
+
+@property(nonatomic, strong) AWSMQTTOfflinePublishQueue *offlinePublishQueue;
+@property(nonatomic, strong) NSString *offlinePublishQueueClientId; //The client ID offlinePublishQueue was opened for
 
 @property NSString *lastWillAndTestamentTopic;
 @property NSData *lastWillAndTestamentMessage;
@@ -100,6 +107,11 @@
         _connectionAgeInSeconds = 0;
         _isMetricsEnabled = YES;
         _ackCallbackDictionary = [NSMutableDictionary new];
+        _offlineAckCallbackDictionary = [NSMutableDictionary new];
+        _offlinePublishQueueEnabled = NO;
+        _offlinePublishQueueByteLimit = 1024 * 1024;
+        _offlinePublishQueueMessageLimit = 1000;
+        _offlinePublishQueueEvictionPolicy = AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest;
         _webSocket = nil;
         _userDidIssueConnect = NO;
         _userDidIssueDisconnect = NO;
@@ -300,6 +312,7 @@
                                          willRetainFlag:self.lastWillAndTestamentRetainFlag
                                          publishRetryThrottle:self.publishRetryThrottle];
         self.session.delegate = self;
+        self.session.offlinePublishQueue = [self openOfflinePublishQueue];
     }
     
     //Notify connection status
@@ -557,6 +570,7 @@
                                                  willRetainFlag:self.lastWillAndTestamentRetainFlag
                                            publishRetryThrottle:self.publishRetryThrottle];
         self.session.delegate = self;
+        self.session.offlinePublishQueue = [self openOfflinePublishQueue];
     }
     
     //Notify connection status.
@@ -801,7 +815,7 @@
     [self publishData:[str dataUsingEncoding:NSUTF8StringEncoding] onTopic:topic];
 }
 
-- (void)publishString:(NSString*)str
+- (BOOL)publishString:(NSString*)str
                   qos:(UInt8)qos
               onTopic:(NSString*)topic
           ackCallback:(AWSIoTMQTTAckBlock)ackCallback {
@@ -809,14 +823,14 @@
         [NSException raise:NSInvalidArgumentException
                     format:@"Cannot specify `ackCallback` block for QoS = 0."];
     }
-    [self publishData:[str dataUsingEncoding:NSUTF8StringEncoding]
-                  qos:qos
-              onTopic:topic
-          ackCallback:ackCallback];
+    return [self publishData:[str dataUsingEncoding:NSUTF8StringEncoding]
+                         qos:qos
+                     onTopic:topic
+                 ackCallback:ackCallback];
 }
 
-- (void)publishString:(NSString*)str qos:(UInt8)qos onTopic:(NSString*)topic {
-    [self publishData:[str dataUsingEncoding:NSUTF8StringEncoding] qos:qos onTopic:topic];
+- (BOOL)publishString:(NSString*)str qos:(UInt8)qos onTopic:(NSString*)topic {
+    return [self publishData:[str dataUsingEncoding:NSUTF8StringEncoding] qos:qos onTopic:topic];
 }
 
 - (void)publishData:(NSData*)data
@@ -824,16 +838,16 @@
     [self.session publishData:data onTopic:topic];
 }
 
-- (void)publishData:(NSData *)data
+- (BOOL)publishData:(NSData *)data
                 qos:(UInt8)qos
             onTopic:(NSString *)topic {
-    [self publishData:data
-                  qos:qos
-              onTopic:topic
-          ackCallback:nil];
+    return [self publishData:data
+                         qos:qos
+                     onTopic:topic
+                 ackCallback:nil];
 }
 
-- (void)publishData:(NSData*)data
+- (BOOL)publishData:(NSData*)data
                 qos:(UInt8)qos
             onTopic:(NSString*)topic
         ackCallback:(AWSIoTMQTTAckBlock)ackCallback {
@@ -850,24 +864,93 @@
     
     if (qos > 1) {
         AWSDDLogError(@"invalid qos value: %u", qos);
-        return;
+        return NO;
     }
     if (qos == 0 && ackCallback != nil) {
         [NSException raise:NSInvalidArgumentException
                     format:@"Cannot specify `ackCallback` block for QoS = 0."];
     }
 
-    AWSDDLogVerbose(@"isReadyToPublish: %i",[self.session isReadyToPublish]);
+    //While offline, or while earlier offline messages are still being sent, the message goes to the offline publish
+    //queue. The session sends it from there once connected.
+    AWSMQTTSession *session = self.session;
+    AWSMQTTOfflinePublishQueue *offlinePublishQueue = session ? session.offlinePublishQueue : [self openOfflinePublishQueue];
+    if (offlinePublishQueue && (!session || [session shouldQueueOfflinePublish])) {
+        BOOL rejected = NO;
+        AWSMQTTOfflinePublishMessage *message = [offlinePublishQueue enqueueData:data
+                                                                         onTopic:topic
+                                                                             qos:qos
+                                                                      retainFlag:NO
+                                                                        rejected:&rejected];
+        if (message && ackCallback) {
+            @synchronized(self.offlineAckCallbackDictionary) {
+                [self.offlineAckCallbackDictionary setObject:ackCallback
+                                                      forKey:[NSNumber numberWithLongLong:message.identifier]];
+            }
+        }
+        return !rejected;
+    }
+
+    AWSDDLogVerbose(@"isReadyToPublish: %i",[session isReadyToPublish]);
     if (qos == 0) {
-        [self.session publishData:data onTopic:topic];
+        [session publishData:data onTopic:topic];
     }
     else {
-        UInt16 messageId = [self.session publishDataAtLeastOnce:data onTopic:topic];
+        UInt16 messageId = [session publishDataAtLeastOnce:data onTopic:topic];
         if (ackCallback) {
             [self.ackCallbackDictionary setObject:ackCallback
                                            forKey:[NSNumber numberWithInt:messageId]];
         }
     }
+    return YES;
+}
+
+#pragma mark offline publish queue
+
+- (NSUInteger)offlinePublishQueueDepth {
+    AWSMQTTOfflinePublishQueue *offlinePublishQueue = nil;
+    @synchronized(self) {
+        offlinePublishQueue = self.offlinePublishQueue;
+    }
+    return offlinePublishQueue.messageCount;
+}
+
+//Returns the offline publish queue of the current client ID, opening it if needed, or nil if the queue is disabled.
+- (AWSMQTTOfflinePublishQueue *)openOfflinePublishQueue {
+    if (!self.offlinePublishQueueEnabled || self.clientId == nil) {
+        return nil;
+    }
+
+    @synchronized(self) {
+        AWSMQTTOfflinePublishQueue *offlinePublishQueue = self.offlinePublishQueue;
+        if (offlinePublishQueue
+            && [self.offlinePublishQueueClientId isEqualToString:self.clientId]
+            && offlinePublishQueue.byteLimit == self.offlinePublishQueueByteLimit
+            && offlinePublishQueue.messageLimit == self.offlinePublishQueueMessageLimit
+            && offlinePublishQueue.evictionPolicy == self.offlinePublishQueueEvictionPolicy) {
+            return offlinePublishQueue;
+        }
+
+        //Each client ID has its own queue, so that messages are only sent on the connection they were published for.
+        NSString *applicationSupportDirectory = [NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES) firstObject];
+        NSString *directory = [applicationSupportDirectory stringByAppendingPathComponent:AWSIoTMQTTClientOfflinePublishQueueDirectory];
+        NSError *error = nil;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                       withIntermediateDirectories:YES
+                                                        attributes:nil
+                                                             error:&error]) {
+            AWSDDLogError(@"Failed to create the offline publish queue directory. [%@]", error);
+            return nil;
+        }
+        NSString *fileName = [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:self.clientId]];
+        self.offlinePublishQueue = [[AWSMQTTOfflinePublishQueue alloc] initWithPath:[directory stringByAppendingPathComponent:fileName]
+                                                                          byteLimit:self.offlinePublishQueueByteLimit
+                                                                       messageLimit:self.offlinePublishQueueMessageLimit
+                                                                     evictionPolicy:self.offlinePublishQueueEvictionPolicy];
+        self.offlinePublishQueueClientId = self.clientId;
+        AWSDDLogInfo(@"Opened the offline publish queue with %lu messages", (unsigned long)self.offlinePublishQueue.messageCount);
+        return self.offlinePublishQueue;
+    }
 }
 
 #pragma mark subscribe methods
@@ -1150,6 +1233,18 @@
     }
 }
 
+- (void)session:(AWSMQTTSession*)session didSendOfflineMessage:(int64_t)identifier messageId:(UInt16)msgId {
+    AWSIoTMQTTAckBlock callback = nil;
+    @synchronized(self.offlineAckCallbackDictionary) {
+        callback = [self.offlineAckCallbackDictionary objectForKey:[NSNumber numberWithLongLong:identifier]];
+        [self.offlineAckCallbackDictionary removeObjectForKey:[NSNumber numberWithLongLong:identifier]];
+    }
+    if (callback) {
+        [self.ackCallbackDictionary setObject:callback
+                                       forKey:[NSNumber numberWithInt:msgId]];
+    }
+}
+
 #pragma mark AWSSRWebSocketDelegate
 
 - (void)webSocketDidOpen:(AWSSRWebSocket *)webSocket {
@@ -1214,7 +1309,7 @@
     if ([message isKindOfClass:[NSData class]])
     {
         NSData *messageData = (NSData *)message;
-        AWSDDLogVerbose(@"Websocket didReceiveMessage: Received %lu bytes", (unsigned long)messageData.length);
+        AWSDDRecordVerbose("Websocket didReceiveMessage: Received %lu bytes", (unsigned long)messageData.length);
     
         // When a message is received, write it to the Decoder's input stream.
         [self.toDecoderStream write:[messageData bytes] maxLength:messageData.length];
@@ -49,7 +49,7 @@
 - (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)limit
 {
     [self.webSocket send:[NSData dataWithBytes:(void *)buffer length:limit]];
-    AWSDDLogVerbose(@"sending %lu bytes", (unsigned long)limit);
+    AWSDDRecordVerbose("sending %lu bytes", (unsigned long)limit);
     return limit;     // writes always succeed
 }
 
@@ -106,9 +106,9 @@
 
 - (void)encodeMessage:(AWSMQTTMessage*)msg {
     //Adding a mutex to prevent buffer from being modified by multiple threads
-    AWSDDLogVerbose(@"***** waiting on encodeSemaphore *****");
+    AWSDDRecordVerbose("***** waiting on encodeSemaphore *****");
     dispatch_semaphore_wait(self.encodeSemaphore, DISPATCH_TIME_FOREVER);
-    AWSDDLogVerbose(@"***** passed encodeSempahore. *****");
+    AWSDDRecordVerbose("***** passed encodeSempahore. *****");
     UInt8 header;
     NSInteger n, length;
     
@@ -164,7 +164,7 @@
         buffer = NULL;
         // XXX [delegate encoder:self handleEvent:MQTTEncoderEventReady];
     }
-    AWSDDLogVerbose(@"***** signaling encodeSemaphore *****");
+    AWSDDRecordVerbose("***** signaling encodeSemaphore *****");
     dispatch_semaphore_signal(self.encodeSemaphore);
     AWSDDLogVerbose(@"<<%@>>: Encoder finished writing message", [NSThread currentThread]);
 }
@@ -0,0 +1,101 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSIoTMQTTTypes.h"
+
+@class AWSDurableQueueRecord;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A message read back from an `AWSMQTTOfflinePublishQueue`.
+ */
+@interface AWSMQTTOfflinePublishMessage : NSObject
+
+@property (nonatomic, readonly) int64_t identifier;
+@property (nonatomic, readonly) NSString *topic;
+@property (nonatomic, readonly) NSData *data;
+@property (nonatomic, readonly) UInt8 qos;
+@property (nonatomic, readonly) BOOL retainFlag;
+
+@end
+
+/**
+ Keeps messages published while the session is not connected in a SQLite database, so that they are sent in order
+ once it connects, even after the app is restarted.
+ */
+@interface AWSMQTTOfflinePublishQueue : NSObject
+
+/**
+ @param path           The database file. It is created if needed.
+ @param byteLimit      The most payload and topic bytes to keep, or 0 for no limit.
+ @param messageLimit   The most messages to keep, or 0 for no limit.
+ @param evictionPolicy What to do with a message that does not fit.
+ */
+- (instancetype)initWithPath:(NSString *)path
+                   byteLimit:(NSUInteger)byteLimit
+                messageLimit:(NSUInteger)messageLimit
+              evictionPolicy:(AWSIoTMQTTOfflinePublishQueueEvictionPolicy)evictionPolicy NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) NSUInteger byteLimit;
+@property (nonatomic, readonly) NSUInteger messageLimit;
+@property (nonatomic, readonly) AWSIoTMQTTOfflinePublishQueueEvictionPolicy evictionPolicy;
+
+/**
+ The number of messages in the queue, including messages sent but not yet acknowledged.
+ */
+@property (nonatomic, readonly) NSUInteger messageCount;
+
+/**
+ The payload and topic bytes of the messages in the queue.
+ */
+@property (nonatomic, readonly) uint64_t byteCount;
+
+/**
+ The number of messages dropped or rejected because the queue was full, since it was opened.
+ */
+@property (nonatomic, readonly) NSUInteger droppedMessageCount;
+
+/**
+ Appends a message, applying the eviction policy if the queue is full.
+
+ @return The queued message, or `nil` if it was dropped or could not be written. `*rejected` is set to `YES` when it
+         was dropped under the reject policy.
+ */
+- (nullable AWSMQTTOfflinePublishMessage *)enqueueData:(NSData *)data
+                                               onTopic:(NSString *)topic
+                                                   qos:(UInt8)qos
+                                            retainFlag:(BOOL)retainFlag
+                                              rejected:(nullable BOOL *)rejected;
+
+/**
+ Reads the oldest messages, skipping those whose identifiers are in `excludedIdentifiers`.
+ */
+- (NSArray<AWSMQTTOfflinePublishMessage *> *)oldestMessagesWithLimit:(NSUInteger)limit
+                                                 excludingIdentifiers:(NSSet<NSNumber *> *)excludedIdentifiers;
+
+/**
+ Removes messages that have been delivered.
+ */
+- (void)removeMessages:(NSArray<AWSMQTTOfflinePublishMessage *> *)messages;
+
+- (void)removeAllMessages;
+
+@end
+
+NS_ASSUME_NONNULL_END
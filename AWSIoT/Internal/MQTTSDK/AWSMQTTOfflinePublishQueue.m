@@ -0,0 +1,223 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <AWSCore/AWSCore.h>
+#import "AWSMQTTOfflinePublishQueue.h"
+
+static NSString *const AWSMQTTOfflinePublishQueueChannel = @"Publish";
+
+// The number of messages read at a time when making room under the drop oldest policy.
+static const NSUInteger AWSMQTTOfflinePublishQueueEvictionBatchSize = 64;
+
+@interface AWSMQTTOfflinePublishMessage()
+
+@property (nonatomic, strong) AWSDurableQueueRecord *record;
+
+@end
+
+@implementation AWSMQTTOfflinePublishMessage
+
+- (instancetype)initWithRecord:(AWSDurableQueueRecord *)record {
+    if (self = [super init]) {
+        _record = record;
+    }
+    return self;
+}
+
+// The tag holds the QoS, followed by "r" for retained messages.
++ (NSString *)tagForQoS:(UInt8)qos retainFlag:(BOOL)retainFlag {
+    return [NSString stringWithFormat:@"%u%@", qos, retainFlag ? @"r" : @""];
+}
+
+- (int64_t)identifier {
+    return self.record.identifier;
+}
+
+- (NSString *)topic {
+    return self.record.key ?: @"";
+}
+
+- (NSData *)data {
+    return self.record.data;
+}
+
+- (UInt8)qos {
+    return (UInt8)[self.record.tag intValue];
+}
+
+- (BOOL)retainFlag {
+    return [self.record.tag hasSuffix:@"r"];
+}
+
+@end
+
+@interface AWSMQTTOfflinePublishQueue()
+
+@property (nonatomic, strong) AWSDurableQueue *queue;
+@property (atomic, assign) NSUInteger droppedMessageCount;
+
+@end
+
+@implementation AWSMQTTOfflinePublishQueue
+
+- (instancetype)initWithPath:(NSString *)path
+                   byteLimit:(NSUInteger)byteLimit
+                messageLimit:(NSUInteger)messageLimit
+              evictionPolicy:(AWSIoTMQTTOfflinePublishQueueEvictionPolicy)evictionPolicy {
+    if (self = [super init]) {
+        _byteLimit = byteLimit;
+        _messageLimit = messageLimit;
+        _evictionPolicy = evictionPolicy;
+        // The limits are enforced here, message by message, so the queue itself has none.
+        _queue = [[AWSDurableQueue alloc] initWithPath:path];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_queue.databaseQueue close];
+}
+
+- (NSUInteger)messageCount {
+    return self.queue.recordCount;
+}
+
+- (uint64_t)byteCount {
+    return self.queue.byteCount;
+}
+
+- (BOOL)hasRoomForMessageCount:(NSUInteger)messageCount byteCount:(uint64_t)byteCount {
+    return (self.messageLimit == 0 || messageCount <= self.messageLimit)
+    && (self.byteLimit == 0 || byteCount <= self.byteLimit);
+}
+
+- (AWSMQTTOfflinePublishMessage *)enqueueData:(NSData *)data
+                                      onTopic:(NSString *)topic
+                                          qos:(UInt8)qos
+                                   retainFlag:(BOOL)retainFlag
+                                     rejected:(BOOL *)rejected {
+    if (rejected) {
+        *rejected = NO;
+    }
+    AWSDurableQueueRecord *record = [[AWSDurableQueueRecord alloc] initWithChannel:AWSMQTTOfflinePublishQueueChannel
+                                                                               key:topic
+                                                                               tag:[AWSMQTTOfflinePublishMessage tagForQoS:qos retainFlag:retainFlag]
+                                                                              data:data];
+
+    // Checking for room and appending must not interleave with another publish.
+    @synchronized(self) {
+        AWSDurableQueue *queue = self.queue;
+        BOOL fits = [self hasRoomForMessageCount:queue.recordCount + 1 byteCount:queue.byteCount + record.byteCount];
+        if (!fits && self.evictionPolicy == AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest
+            && [self hasRoomForMessageCount:1 byteCount:record.byteCount]) {
+            fits = [self removeOldestMessagesToFitRecord:record];
+        }
+        if (!fits) {
+            self.droppedMessageCount++;
+            if (self.evictionPolicy == AWSIoTMQTTOfflinePublishQueueEvictionPolicyReject && rejected) {
+                *rejected = YES;
+            }
+            AWSDDLogWarn(@"The offline publish queue is full. Dropping a message on topic %@.", topic);
+            return nil;
+        }
+
+        AWSTask<AWSDurableQueueRecord *> *task = [queue appendRecord:record];
+        [task waitUntilFinished];
+        if (task.error) {
+            AWSDDLogError(@"Failed to queue a message on topic %@. [%@]", topic, task.error);
+            return nil;
+        }
+        return [[AWSMQTTOfflinePublishMessage alloc] initWithRecord:task.result];
+    }
+}
+
+- (BOOL)removeOldestMessagesToFitRecord:(AWSDurableQueueRecord *)record {
+    AWSDurableQueue *queue = self.queue;
+    NSUInteger messageCount = queue.recordCount;
+    uint64_t byteCount = queue.byteCount;
+    NSMutableArray<AWSDurableQueueRecord *> *evictedRecords = [NSMutableArray new];
+    NSError *error = nil;
+
+    while (![self hasRoomForMessageCount:messageCount + 1 byteCount:byteCount + record.byteCount]) {
+        NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:AWSMQTTOfflinePublishQueueChannel
+                                                                            limit:[evictedRecords count] + AWSMQTTOfflinePublishQueueEvictionBatchSize
+                                                                        byteLimit:0
+                                                                            error:&error];
+        if ([records count] <= [evictedRecords count]) {
+            break;
+        }
+        for (NSUInteger i = [evictedRecords count]; i < [records count]; i++) {
+            if ([self hasRoomForMessageCount:messageCount + 1 byteCount:byteCount + record.byteCount]) {
+                break;
+            }
+            [evictedRecords addObject:records[i]];
+            messageCount--;
+            byteCount -= records[i].byteCount;
+        }
+    }
+
+    if ([evictedRecords count] > 0) {
+        AWSDDLogWarn(@"The offline publish queue is full. Dropping the %lu oldest messages.", (unsigned long)[evictedRecords count]);
+        self.droppedMessageCount += [evictedRecords count];
+        if (![queue acknowledgeRecords:evictedRecords error:&error]) {
+            AWSDDLogError(@"Failed to drop messages from the offline publish queue. [%@]", error);
+            return NO;
+        }
+    }
+    return [self hasRoomForMessageCount:queue.recordCount + 1 byteCount:queue.byteCount + record.byteCount];
+}
+
+- (NSArray<AWSMQTTOfflinePublishMessage *> *)oldestMessagesWithLimit:(NSUInteger)limit
+                                                 excludingIdentifiers:(NSSet<NSNumber *> *)excludedIdentifiers {
+    NSError *error = nil;
+    NSArray<AWSDurableQueueRecord *> *records = [self.queue oldestRecordsInChannel:AWSMQTTOfflinePublishQueueChannel
+                                                                             limit:limit + [excludedIdentifiers count]
+                                                                         byteLimit:0
+                                                                             error:&error];
+    if (!records) {
+        AWSDDLogError(@"Failed to read the offline publish queue. [%@]", error);
+        return @[];
+    }
+
+    NSMutableArray<AWSMQTTOfflinePublishMessage *> *messages = [NSMutableArray arrayWithCapacity:limit];
+    for (AWSDurableQueueRecord *record in records) {
+        if ([messages count] >= limit) {
+            break;
+        }
+        if (![excludedIdentifiers containsObject:@(record.identifier)]) {
+            [messages addObject:[[AWSMQTTOfflinePublishMessage alloc] initWithRecord:record]];
+        }
+    }
+    return messages;
+}
+
+- (void)removeMessages:(NSArray<AWSMQTTOfflinePublishMessage *> *)messages {
+    if ([messages count] == 0) {
+        return;
+    }
+    NSError *error = nil;
+    if (![self.queue acknowledgeRecords:[messages valueForKey:@"record"] error:&error]) {
+        AWSDDLogError(@"Failed to remove sent messages from the offline publish queue. [%@]", error);
+    }
+}
+
+- (void)removeAllMessages {
+    NSError *error = nil;
+    if (![self.queue removeRecordsInChannel:nil error:&error]) {
+        AWSDDLogError(@"Failed to clear the offline publish queue. [%@]", error);
+    }
+}
+
+@end
@@ -15,6 +15,7 @@
 
 #import <Foundation/Foundation.h>
 #import "AWSMQTTMessage.h"
+#import "AWSMQTTOfflinePublishQueue.h"
 
 typedef enum {
     AWSMQTTSessionStatusCreated,
@@ -40,6 +41,7 @@ typedef enum {
 
 @optional
 - (void)session:(AWSMQTTSession*)session newAckForMessageId:(UInt16)msgId;
+- (void)session:(AWSMQTTSession*)session didSendOfflineMessage:(int64_t)identifier messageId:(UInt16)msgId;
 
 @end
 
@@ -87,6 +89,19 @@ typedef enum {
 - (UInt16)publishDataExactlyOnce:(NSData*)theData onTopic:(NSString*)theTopic retain:(BOOL)retainFlag;
 - (void)publishJson:(id)payload onTopic:(NSString*)theTopic;
 
+/**
+ When set, messages published while the session is not connected, or while earlier offline messages are still being
+ sent, are written to this queue. Once connected they are sent in order, counted against `publishRetryThrottle`, and
+ removed when they are delivered: QoS 0 messages once written, QoS 1 messages once acknowledged. Publishing a queued
+ message returns message id 0.
+ */
+@property (strong, atomic) AWSMQTTOfflinePublishQueue *offlinePublishQueue;
+
+/**
+ Whether a message published now goes to `offlinePublishQueue`.
+ */
+- (BOOL)shouldQueueOfflinePublish;
+
 - (BOOL)isReadyToPublish;
 - (void)send:(AWSMQTTMessage*)msg;
 
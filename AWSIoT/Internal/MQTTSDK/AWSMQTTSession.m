@@ -39,6 +39,10 @@
     NSMutableDictionary* txFlows; //Required for QOS1. Outbound publishes will be stored in txFlows until a PubAck is received
     NSMutableDictionary* rxFlows; //Required for handling QOS 2. Not in use currently
     unsigned int         retryThreshold; //used to throtttle retries. Overloading the publishes beyond service limit will result in message loss.
+    NSUInteger           queueHead; //index of the next message to send in queue. Sent messages before it are removed in bulk.
+
+    NSMutableDictionary* offlineFlows; //Offline messages sent with QOS1 that wait for a PubAck, keyed by message id.
+    NSMutableSet*        offlineInFlightIdentifiers; //Identifiers of the offline messages in offlineFlows, which are not sent again.
 }
 
 // private methods & properties
@@ -99,6 +103,9 @@
         connectMessage = msg;
         _publishRetryThrottle = publishRetryThrottle;
         self.queue = [NSMutableArray array];
+        queueHead = 0;
+        offlineFlows = [NSMutableDictionary new];
+        offlineInFlightIdentifiers = [NSMutableSet new];
         txMsgId = 1;
         txFlows = [[NSMutableDictionary alloc] init];
         rxFlows = [[NSMutableDictionary alloc] init];
@@ -189,6 +196,10 @@
 - (void)publishDataAtMostOnce:(NSData*)data
                       onTopic:(NSString*)topic
                        retain:(BOOL)retainFlag {
+    if ([self shouldQueueOfflinePublish]) {
+        [self queueOfflinePublishOfData:data onTopic:topic qos:0 retainFlag:retainFlag rejected:NULL];
+        return;
+    }
     [self send:[AWSMQTTMessage publishMessageWithData:data
                                            onTopic:topic
                                         retainFlag:retainFlag]];
@@ -202,7 +213,17 @@
 - (UInt16)publishDataAtLeastOnce:(NSData*)data
                        onTopic:(NSString*)topic
                         retain:(BOOL)retainFlag {
-    UInt16 msgId = [self nextMsgId];
+    if ([self shouldQueueOfflinePublish]) {
+        [self queueOfflinePublishOfData:data onTopic:topic qos:1 retainFlag:retainFlag rejected:NULL];
+        return 0;
+    }
+    return [self sendDataAtLeastOnce:data onTopic:topic retain:retainFlag msgId:[self nextMsgId]];
+}
+
+- (UInt16)sendDataAtLeastOnce:(NSData*)data
+                      onTopic:(NSString*)topic
+                       retain:(BOOL)retainFlag
+                        msgId:(UInt16)msgId {
     AWSMQTTMessage *msg = [AWSMQTTMessage publishMessageWithData:data
                                                    onTopic:topic
                                                        qos:1
@@ -270,7 +291,7 @@
     id msgId;
     
     //Stay under the throttle here and move the work to the next tick if throttle is breached.
-    NSUInteger count = [self.queue count];
+    NSUInteger count = [self queuedMessageCount];
     [self drainSenderQueue];
     while ((msgId = [e nextObject])) {
         AWSMQttTxFlow *flow = [txFlows objectForKey:msgId];
@@ -291,6 +312,11 @@
         [[self.timerRing objectAtIndex:((ticks + 1) % 60)] addObject:msgId];
         [[self.timerRing objectAtIndex:(ticks % 60)] removeObject:msgId];
     }
+
+    //Messages published while offline get what is left of the throttle, after the retries of earlier messages.
+    if (count < _publishRetryThrottle) {
+        count += [self drainOfflinePublishQueueWithLimit:_publishRetryThrottle - count];
+    }
     
     if (count > 0 ) {
         AWSDDLogVerbose(@"ClockTick: %d: republished %lu messages from timerHandler", ticks,(unsigned long)count);
@@ -321,11 +347,9 @@
                         dispatch_semaphore_wait(self.drainSenderQueueSemaphore, DISPATCH_TIME_FOREVER);
                         AWSDDLogVerbose(@"%s [Line %d], Thread:%@ passed  drainSenderQueueSemaphore", __PRETTY_FUNCTION__, __LINE__, [NSThread currentThread]);
                         
-                        if ([self.queue count] > 0) {
+                        if ([self queuedMessageCount] > 0) {
                             AWSDDLogDebug(@"Sending message from session queue" );
-                            AWSMQTTMessage *msg = [self.queue objectAtIndex:0];
-                            [self.queue removeObjectAtIndex:0];
-                            [encoder encodeMessage:msg];
+                            [encoder encodeMessage:[self dequeueMessage]];
                         }
                         
                         AWSDDLogVerbose(@"%s [Line %d], Thread:%@ signaling on drainSenderQueueSemaphore", __PRETTY_FUNCTION__, __LINE__, [NSThread currentThread]);
@@ -364,7 +388,7 @@
 
 - (void)decoder:(AWSMQTTDecoder*)sender newMessage:(AWSMQTTMessage*)msg {
     
-    AWSDDLogVerbose(@"%s [Line %d] messageType=%d, status=%d", __PRETTY_FUNCTION__, __LINE__, [msg type], status);
+    AWSDDRecordVerbose("%s [Line %d] messageType=%d, status=%d", __PRETTY_FUNCTION__, __LINE__, [msg type], status);
     AWSAWSMQTTMessageType messageType = [msg type];
     if(sender == decoder){
         switch (status) {
@@ -416,7 +440,7 @@
 
 # pragma mark Main ingress point for messages from protocol handlers (decoder - low level transport combo)
 - (void)newMessage:(AWSMQTTMessage*)msg {
-    AWSDDLogVerbose(@"MQTTSession- newMessage msg type is %d", [msg type]);
+    AWSDDRecordVerbose("MQTTSession- newMessage msg type is %d", [msg type]);
     switch ([msg type]) {
         case AWSMQTTPublish:
             [self handlePublish:msg];
@@ -548,6 +572,18 @@
     [[self.timerRing objectAtIndex:([flow deadline] % 60)] removeObject:msgId];
     [txFlows removeObjectForKey:msgId];
     AWSDDLogDebug(@"Removing msgID %@ from internal store for QOS1 gaurantee", msgId);
+
+    AWSMQTTOfflinePublishMessage *offlineMessage = nil;
+    @synchronized(offlineFlows) {
+        offlineMessage = [offlineFlows objectForKey:msgId];
+        if (offlineMessage) {
+            [offlineFlows removeObjectForKey:msgId];
+            [offlineInFlightIdentifiers removeObject:@(offlineMessage.identifier)];
+        }
+    }
+    if (offlineMessage) {
+        [self.offlinePublishQueue removeMessages:@[offlineMessage]];
+    }
     [_delegate session:self newAckForMessageId:msgId.unsignedShortValue];
 }
 
@@ -675,6 +711,98 @@
     return txMsgId;
 }
 
+#pragma mark Offline Publish Queue
+
+- (BOOL)shouldQueueOfflinePublish {
+    AWSMQTTOfflinePublishQueue *offlinePublishQueue = self.offlinePublishQueue;
+    if (!offlinePublishQueue) {
+        return NO;
+    }
+    if (status != AWSMQTTSessionStatusConnected) {
+        return YES;
+    }
+    // Keep the order: while older offline messages are waiting to be sent, new ones wait behind them.
+    @synchronized(offlineFlows) {
+        return offlinePublishQueue.messageCount > [offlineInFlightIdentifiers count];
+    }
+}
+
+- (AWSMQTTOfflinePublishMessage *)queueOfflinePublishOfData:(NSData*)data
+                                                    onTopic:(NSString*)topic
+                                                        qos:(UInt8)qos
+                                                 retainFlag:(BOOL)retainFlag
+                                                   rejected:(BOOL *)rejected {
+    AWSDDLogDebug(@"Session is offline. Queueing message on topic %@ to send later", topic);
+    return [self.offlinePublishQueue enqueueData:data
+                                         onTopic:topic
+                                             qos:qos
+                                      retainFlag:retainFlag
+                                        rejected:rejected];
+}
+
+// Sends up to `limit` of the oldest offline messages that are not already waiting for a PubAck, and returns how many
+// were sent.
+- (NSUInteger)drainOfflinePublishQueueWithLimit:(NSUInteger)limit {
+    AWSMQTTOfflinePublishQueue *offlinePublishQueue = self.offlinePublishQueue;
+    if (!offlinePublishQueue || limit == 0 || status != AWSMQTTSessionStatusConnected) {
+        return 0;
+    }
+
+    NSSet *excludedIdentifiers = nil;
+    @synchronized(offlineFlows) {
+        excludedIdentifiers = [offlineInFlightIdentifiers copy];
+    }
+    NSArray<AWSMQTTOfflinePublishMessage *> *messages = [offlinePublishQueue oldestMessagesWithLimit:limit
+                                                                                 excludingIdentifiers:excludedIdentifiers];
+    NSMutableArray<AWSMQTTOfflinePublishMessage *> *sentMessages = [NSMutableArray new];
+    for (AWSMQTTOfflinePublishMessage *message in messages) {
+        if (message.qos == 0) {
+            [self send:[AWSMQTTMessage publishMessageWithData:message.data
+                                                      onTopic:message.topic
+                                                   retainFlag:message.retainFlag]];
+            [sentMessages addObject:message];
+        } else {
+            //Track the message before sending it, so that its PubAck cannot arrive first.
+            UInt16 msgId = [self nextMsgId];
+            @synchronized(offlineFlows) {
+                [offlineFlows setObject:message forKey:[NSNumber numberWithUnsignedInt:msgId]];
+                [offlineInFlightIdentifiers addObject:@(message.identifier)];
+            }
+            if ([(NSObject *)_delegate respondsToSelector:@selector(session:didSendOfflineMessage:messageId:)]) {
+                [_delegate session:self didSendOfflineMessage:message.identifier messageId:msgId];
+            }
+            [self sendDataAtLeastOnce:message.data onTopic:message.topic retain:message.retainFlag msgId:msgId];
+        }
+    }
+    [offlinePublishQueue removeMessages:sentMessages];
+
+    if ([messages count] > 0) {
+        AWSDDLogDebug(@"Sent %lu messages from the offline publish queue", (unsigned long)[messages count]);
+    }
+    return [messages count];
+}
+
+#pragma mark Session Queue
+
+- (NSUInteger)queuedMessageCount {
+    return [self.queue count] - queueHead;
+}
+
+// Takes the first message of `queue`. Sent messages are removed once they make up half of the array, so that taking a
+// message does not move the rest of the array each time.
+- (AWSMQTTMessage *)dequeueMessage {
+    AWSMQTTMessage *msg = [self.queue objectAtIndex:queueHead];
+    queueHead++;
+    if (queueHead == [self.queue count]) {
+        [self.queue removeAllObjects];
+        queueHead = 0;
+    } else if (queueHead >= 64 && queueHead * 2 >= [self.queue count]) {
+        [self.queue removeObjectsInRange:NSMakeRange(0, queueHead)];
+        queueHead = 0;
+    }
+    return msg;
+}
+
 - (BOOL)isReadyToPublish {
     AWSDDLogVerbose(@"<<%@>> MQTTEncoderStatus = %d", [NSThread currentThread],[encoder status]);
     return encoder && [encoder status] == AWSMQTTEncoderStatusReady;
@@ -686,11 +814,9 @@
     AWSDDLogVerbose(@"%s [Line %d], Thread:%@ passed drainSenderQueueSemaphore", __PRETTY_FUNCTION__, __LINE__, [NSThread currentThread]);
 
     int count = 0;
-    while ([self.queue count] > 0 && count < _publishRetryThrottle && [self isReadyToPublish]) {
+    while ([self queuedMessageCount] > 0 && count < _publishRetryThrottle && [self isReadyToPublish]) {
         AWSDDLogDebug(@"Sending message from session queue" );
-        AWSMQTTMessage *msg = [self.queue objectAtIndex:0];
-        [self.queue removeObjectAtIndex:0];
-        [encoder encodeMessage:msg];
+        [encoder encodeMessage:[self dequeueMessage]];
         count = count + 1;
     }
     
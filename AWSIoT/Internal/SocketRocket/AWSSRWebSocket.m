@@ -215,6 +215,7 @@ typedef void (^data_callback)(AWSSRWebSocket *webSocket,  NSData *data);
  
     NSMutableData *_outputBuffer;
     NSUInteger _outputBufferOffset;
+    BOOL _pumpWritingScheduled;
 
     uint8_t _currentFrameOpcode;
     size_t _currentFrameCount;
@@ -1176,8 +1177,12 @@ static const uint8_t SRPayloadLenMask   = 0x7F;
         
         _outputBufferOffset += bytesWritten;
         
-        if (_outputBufferOffset > 4096 && _outputBufferOffset > (_outputBuffer.length >> 1)) {
-            _outputBuffer = [[NSMutableData alloc] initWithBytes:(char *)_outputBuffer.bytes + _outputBufferOffset length:_outputBuffer.length - _outputBufferOffset];
+        // Compact in place so the buffer's storage is reused by the next frames instead of being reallocated.
+        if (_outputBufferOffset == _outputBuffer.length) {
+            _outputBuffer.length = 0;
+            _outputBufferOffset = 0;
+        } else if (_outputBufferOffset > 4096 && _outputBufferOffset > (_outputBuffer.length >> 1)) {
+            [_outputBuffer replaceBytesInRange:NSMakeRange(0, _outputBufferOffset) withBytes:NULL length:0];
             _outputBufferOffset = 0;
         }
     }
@@ -1424,10 +1429,57 @@ static const char CRLFCRLFBytes[] = {'\r', '\n', '\r', '\n'};
     _isPumping = NO;
 }
 
+// Coalesces the frames queued on the work queue into a single write to the output stream.
+- (void)_schedulePumpWriting;
+{
+    [self assertOnWorkQueue];
+    
+    if (_pumpWritingScheduled) {
+        return;
+    }
+    _pumpWritingScheduled = YES;
+    dispatch_async(_workQueue, ^{
+        self->_pumpWritingScheduled = NO;
+        [self _pumpWriting];
+    });
+}
+
 //#define NOMASK
 
 static const size_t SRFrameHeaderOverhead = 32;
 
+// XORs the payload with the 4 byte mask key a machine word at a time, finishing the unaligned tail bytewise.
+static inline void SRMaskBytes(uint8_t *dst, const uint8_t *src, size_t length, const uint8_t *mask_key)
+{
+    uint32_t mask32;
+    memcpy(&mask32, mask_key, sizeof(uint32_t));
+    const uint64_t mask64 = ((uint64_t)mask32 << 32) | mask32;
+    
+    size_t i = 0;
+    for (; i + 2 * sizeof(uint64_t) <= length; i += 2 * sizeof(uint64_t)) {
+        uint64_t chunk[2];
+        memcpy(chunk, src + i, sizeof(chunk));
+        chunk[0] ^= mask64;
+        chunk[1] ^= mask64;
+        memcpy(dst + i, chunk, sizeof(chunk));
+    }
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t chunk;
+        memcpy(&chunk, src + i, sizeof(chunk));
+        chunk ^= mask64;
+        memcpy(dst + i, &chunk, sizeof(chunk));
+    }
+    // i is a multiple of 4 here, so the tail restarts at the first byte of the mask key.
+    for (; i < length; i++) {
+        dst[i] = src[i] ^ mask_key[i % sizeof(uint32_t)];
+    }
+}
+
++ (void)_maskBytes:(uint8_t *)dst source:(const uint8_t *)src length:(size_t)length maskKey:(const uint8_t *)maskKey;
+{
+    SRMaskBytes(dst, src, length, maskKey);
+}
+
 - (void)_sendFrameWithOpcode:(SROpCode)opcode data:(id)data;
 {
     [self assertOnWorkQueue];
@@ -1439,13 +1491,20 @@ static const size_t SRFrameHeaderOverhead = 32;
     NSAssert([data isKindOfClass:[NSData class]] || [data isKindOfClass:[NSString class]], @"NSString or NSData");
     
     size_t payloadLength = [data isKindOfClass:[NSString class]] ? [(NSString *)data lengthOfBytesUsingEncoding:NSUTF8StringEncoding] : [data length];
-        
-    NSMutableData *frame = [[NSMutableData alloc] initWithLength:payloadLength + SRFrameHeaderOverhead];
-    if (!frame) {
+    
+    if (_closeWhenFinishedWriting) {
+        return;
+    }
+    
+    if (payloadLength > NSUIntegerMax - SRFrameHeaderOverhead - _outputBuffer.length) {
         [self closeWithCode:AWSSRStatusCodeMessageTooBig reason:@"Message too big"];
         return;
     }
-    uint8_t *frame_buffer = (uint8_t *)[frame mutableBytes];
+    
+    // Frames are built directly at the end of the output buffer, so no per frame buffer is allocated or copied.
+    NSUInteger frameOffset = _outputBuffer.length;
+    [_outputBuffer increaseLengthBy:payloadLength + SRFrameHeaderOverhead];
+    uint8_t *frame_buffer = (uint8_t *)[_outputBuffer mutableBytes] + frameOffset;
     
     // set fin
     frame_buffer[0] = SRFinMask | opcode;
@@ -1468,6 +1527,7 @@ static const size_t SRFrameHeaderOverhead = 32;
     } else if ([data isKindOfClass:[NSString class]]) {
         unmasked_payload =  (const uint8_t *)[data UTF8String];
     } else {
+        _outputBuffer.length = frameOffset;
         return;
     }
     
@@ -1475,19 +1535,19 @@ static const size_t SRFrameHeaderOverhead = 32;
         frame_buffer[1] |= payloadLength;
     } else if (payloadLength <= UINT16_MAX) {
         frame_buffer[1] |= 126;
-        *((uint16_t *)(frame_buffer + frame_buffer_size)) = EndianU16_BtoN((uint16_t)payloadLength);
+        uint16_t networkLength = EndianU16_BtoN((uint16_t)payloadLength);
+        memcpy(frame_buffer + frame_buffer_size, &networkLength, sizeof(uint16_t));
         frame_buffer_size += sizeof(uint16_t);
     } else {
         frame_buffer[1] |= 127;
-        *((uint64_t *)(frame_buffer + frame_buffer_size)) = EndianU64_BtoN((uint64_t)payloadLength);
+        uint64_t networkLength = EndianU64_BtoN((uint64_t)payloadLength);
+        memcpy(frame_buffer + frame_buffer_size, &networkLength, sizeof(uint64_t));
         frame_buffer_size += sizeof(uint64_t);
     }
         
     if (!useMask) {
-        for (size_t i = 0; i < payloadLength; i++) {
-            frame_buffer[frame_buffer_size] = unmasked_payload[i];
-            frame_buffer_size += 1;
-        }
+        memcpy(frame_buffer + frame_buffer_size, unmasked_payload, payloadLength);
+        frame_buffer_size += payloadLength;
     } else {
         uint8_t *mask_key = frame_buffer + frame_buffer_size;
         int functionExitCode = SecRandomCopyBytes(kSecRandomDefault, sizeof(uint32_t), (uint8_t *)mask_key);
@@ -1496,17 +1556,19 @@ static const size_t SRFrameHeaderOverhead = 32;
         }
         frame_buffer_size += sizeof(uint32_t);
         
-        // TODO: could probably optimize this with SIMD
-        for (size_t i = 0; i < payloadLength; i++) {
-            frame_buffer[frame_buffer_size] = unmasked_payload[i] ^ mask_key[i % sizeof(uint32_t)];
-            frame_buffer_size += 1;
-        }
+        SRMaskBytes(frame_buffer + frame_buffer_size, unmasked_payload, payloadLength, mask_key);
+        frame_buffer_size += payloadLength;
     }
 
-    assert(frame_buffer_size <= [frame length]);
-    frame.length = frame_buffer_size;
+    assert(frame_buffer_size <= payloadLength + SRFrameHeaderOverhead);
+    _outputBuffer.length = frameOffset + frame_buffer_size;
     
-    [self _writeData:frame];
+    // A close frame has to reach the stream before the connection is torn down, everything else can be batched.
+    if (opcode == SROpCodeConnectionClose) {
+        [self _pumpWriting];
+    } else {
+        [self _schedulePumpWriting];
+    }
 }
 
 - (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode;
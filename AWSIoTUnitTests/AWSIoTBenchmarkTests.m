@@ -0,0 +1,147 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSMQTTSession.h"
+#import "AWSBenchmark.h"
+
+#import "TestMQTTBroker.h"
+#import "TestMQTTSessionDelegate.h"
+
+static const NSUInteger AWSIoTBenchmarkPayloadSize = 256;
+static const NSUInteger AWSIoTBenchmarkWarmUpCount = 20;
+static const NSUInteger AWSIoTBenchmarkOperationCount = 500;
+static const NSTimeInterval AWSIoTBenchmarkTimeout = 5.0;
+
+@interface AWSIoTBenchmarkTests : XCTestCase
+
+@end
+
+@implementation AWSIoTBenchmarkTests {
+    NSThread *brokerThread;
+    AWSMQTTSession *session;
+    TestMQTTSessionDelegate *sessionDelegate;
+    BOOL connected;
+    NSUInteger receivedCount;
+    NSUInteger ackCount;
+}
+
++ (XCTestSuite *)defaultTestSuite {
+    // Benchmarks are opt-in; see AWSBenchmark.
+    return [AWSBenchmark isEnabled] ? [super defaultTestSuite] : [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+}
+
+- (void)setUp {
+    [super setUp];
+
+    NSInputStream *sessionInputStream;
+    NSOutputStream *brokerOutputStream;
+    [NSStream getBoundStreamsWithBufferSize:16384 inputStream:&sessionInputStream outputStream:&brokerOutputStream];
+    NSInputStream *brokerInputStream;
+    NSOutputStream *sessionOutputStream;
+    [NSStream getBoundStreamsWithBufferSize:16384 inputStream:&brokerInputStream outputStream:&sessionOutputStream];
+
+    TestMQTTBroker *broker = [[TestMQTTBroker alloc] initWithInputStream:brokerInputStream
+                                                            outputStream:brokerOutputStream
+                                                               onPublish:nil];
+    brokerThread = [[NSThread alloc] initWithTarget:broker
+                                           selector:@selector(open)
+                                             object:nil];
+    brokerThread.name = @"broker";
+    [brokerThread start];
+
+    __weak AWSIoTBenchmarkTests *weakSelf = self;
+    sessionDelegate = [[TestMQTTSessionDelegate alloc] initWithOnMessageBlock:^(AWSMQTTSession *session, NSData *data, NSString *topic) {
+        AWSIoTBenchmarkTests *strongSelf = weakSelf;
+        if (strongSelf && [data length] == AWSIoTBenchmarkPayloadSize) {
+            strongSelf->receivedCount++;
+        }
+    } onEvent:^(AWSMQTTSession *session, AWSMQTTSessionEvent event) {
+        AWSIoTBenchmarkTests *strongSelf = weakSelf;
+        if (strongSelf && event == AWSMQTTSessionEventConnected) {
+            strongSelf->connected = YES;
+        }
+    } onAck:^(AWSMQTTSession *session, UInt16 msgId) {
+        AWSIoTBenchmarkTests *strongSelf = weakSelf;
+        if (strongSelf) {
+            strongSelf->ackCount++;
+        }
+    }];
+
+    session = [[AWSMQTTSession alloc] initWithClientId:@"benchmark"
+                                              userName:@""
+                                              password:@""
+                                             keepAlive:60
+                                          cleanSession:YES
+                                             willTopic:nil
+                                               willMsg:nil
+                                               willQoS:0
+                                        willRetainFlag:NO
+                                  publishRetryThrottle:10];
+    session.delegate = sessionDelegate;
+    // The session reads and writes on the run loop of the thread that connects it.
+    [session connectToInputStream:sessionInputStream outputStream:sessionOutputStream];
+    XCTAssertTrue([self runUntil:^BOOL{
+        return self->connected;
+    }]);
+
+    [session subscribeToTopic:@"benchmark/+" atLevel:1];
+    XCTAssertTrue([self runUntil:^BOOL{
+        return self->ackCount == 1;
+    }]);
+}
+
+- (void)tearDown {
+    [session close];
+    [brokerThread cancel];
+    brokerThread = nil;
+    [super tearDown];
+}
+
+// Runs the current run loop until `condition` holds or the timeout passes.
+- (BOOL)runUntil:(BOOL (^)(void))condition {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:AWSIoTBenchmarkTimeout];
+    while (!condition()) {
+        if ([deadline timeIntervalSinceNow] <= 0) {
+            return NO;
+        }
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:deadline];
+    }
+    return YES;
+}
+
+- (void)testPublishSubscribeBenchmark {
+    NSMutableData *payload = [NSMutableData dataWithLength:AWSIoTBenchmarkPayloadSize];
+    arc4random_buf(payload.mutableBytes, payload.length);
+
+    // Each operation publishes at QoS 1 and waits for both the PubAck and the message delivered to the subscription.
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"IoTPublishSubscribe"
+                                                     warmUpCount:AWSIoTBenchmarkWarmUpCount
+                                                  operationCount:AWSIoTBenchmarkOperationCount
+                                                       operation:^BOOL(NSUInteger index) {
+        NSUInteger expectedReceivedCount = self->receivedCount + 1;
+        NSUInteger expectedAckCount = self->ackCount + 1;
+        [self->session publishDataAtLeastOnce:payload
+                                      onTopic:[NSString stringWithFormat:@"benchmark/%lu", (unsigned long)(index % 16)]];
+        return [self runUntil:^BOOL{
+            return self->receivedCount >= expectedReceivedCount && self->ackCount >= expectedAckCount;
+        }];
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+@end
@@ -0,0 +1,196 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <pthread.h>
+#import <stdatomic.h>
+#import "AWSSRWebSocket.h"
+
+@interface AWSSRWebSocket()
+
++ (void)_maskBytes:(uint8_t *)dst source:(const uint8_t *)src length:(size_t)length maskKey:(const uint8_t *)maskKey;
+- (void)_sendFrameWithOpcode:(int)opcode data:(id)data;
+
+@end
+
+// libmalloc reports every allocation through this hook; it is what Instruments' allocation tracking uses.
+extern void (*malloc_logger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+
+static const uint32_t AWSSRWebSocketMaskingTestsMallocLogTypeAllocate = 2;
+static pthread_t AWSSRWebSocketMaskingTestsCountedThread;
+static atomic_ulong AWSSRWebSocketMaskingTestsAllocationCount;
+
+static void AWSSRWebSocketMaskingTestsCountAllocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if ((type & AWSSRWebSocketMaskingTestsMallocLogTypeAllocate) && pthread_equal(pthread_self(), AWSSRWebSocketMaskingTestsCountedThread)) {
+        atomic_fetch_add(&AWSSRWebSocketMaskingTestsAllocationCount, 1);
+    }
+}
+
+// Counts the heap allocations made by the calling thread while block runs.
+static NSUInteger AWSSRWebSocketMaskingTestsCountAllocations(void (^block)(void)) {
+    AWSSRWebSocketMaskingTestsCountedThread = pthread_self();
+    atomic_store(&AWSSRWebSocketMaskingTestsAllocationCount, 0);
+    malloc_logger = AWSSRWebSocketMaskingTestsCountAllocation;
+    block();
+    malloc_logger = NULL;
+    return atomic_load(&AWSSRWebSocketMaskingTestsAllocationCount);
+}
+
+static const uint8_t AWSSRWebSocketMaskingTestsOpCodeBinaryFrame = 0x2;
+static const size_t AWSSRWebSocketMaskingTestsFrameHeaderOverhead = 32;
+
+// The frame encoding AWSSRWebSocket used before frames were built in the output buffer: a new frame buffer per
+// frame, copied into the output buffer. Only the allocation pattern matters here, so the header is not filled in.
+static void AWSSRWebSocketMaskingTestsAppendFrameWithCopy(NSMutableData *outputBuffer, NSData *data) {
+    NSMutableData *frame = [[NSMutableData alloc] initWithLength:data.length + AWSSRWebSocketMaskingTestsFrameHeaderOverhead];
+    uint8_t *frame_buffer = (uint8_t *)[frame mutableBytes];
+    frame_buffer[0] = 0x80 | AWSSRWebSocketMaskingTestsOpCodeBinaryFrame;
+    uint8_t *mask_key = frame_buffer + 4;
+    SecRandomCopyBytes(kSecRandomDefault, sizeof(uint32_t), mask_key);
+    [AWSSRWebSocket _maskBytes:frame_buffer + 8 source:data.bytes length:data.length maskKey:mask_key];
+    frame.length = data.length + 8;
+    [outputBuffer appendData:frame];
+}
+
+static void AWSSRWebSocketMaskingTestsMaskBytewise(uint8_t *dst, const uint8_t *src, size_t length, const uint8_t *maskKey) {
+    for (size_t i = 0; i < length; i++) {
+        dst[i] = src[i] ^ maskKey[i % sizeof(uint32_t)];
+    }
+}
+
+static const size_t AWSSRWebSocketMaskingTestsBenchmarkPayloadSize = 128 * 1024;
+static const NSUInteger AWSSRWebSocketMaskingTestsBenchmarkIterations = 1000;
+static const NSUInteger AWSSRWebSocketMaskingTestsAllocationFrames = 1000;
+
+@interface AWSSRWebSocketMaskingTests : XCTestCase
+
+@end
+
+@implementation AWSSRWebSocketMaskingTests {
+    NSMutableData *payload;
+    NSMutableData *masked;
+    uint8_t maskKey[4];
+}
+
+- (void)setUp {
+    [super setUp];
+    payload = [NSMutableData dataWithLength:AWSSRWebSocketMaskingTestsBenchmarkPayloadSize + 16];
+    masked = [NSMutableData dataWithLength:AWSSRWebSocketMaskingTestsBenchmarkPayloadSize + 16];
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, payload.length, payload.mutableBytes), 0);
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, sizeof(maskKey), maskKey), 0);
+}
+
+- (void)testMaskingMatchesBytewiseMaskingForAllLengthsAndAlignments {
+    NSMutableData *expected = [NSMutableData dataWithLength:256];
+    NSMutableData *actual = [NSMutableData dataWithLength:256];
+    for (size_t offset = 0; offset < 8; offset++) {
+        const uint8_t *src = (const uint8_t *)payload.bytes + offset;
+        for (size_t length = 0; length <= 200; length++) {
+            memset(expected.mutableBytes, 0, expected.length);
+            memset(actual.mutableBytes, 0, actual.length);
+            AWSSRWebSocketMaskingTestsMaskBytewise(expected.mutableBytes, src, length, maskKey);
+            [AWSSRWebSocket _maskBytes:(uint8_t *)actual.mutableBytes + offset % 3 source:src length:length maskKey:maskKey];
+            XCTAssertEqual(memcmp(expected.bytes, (uint8_t *)actual.bytes + offset % 3, length), 0, @"length %zu offset %zu", length, offset);
+        }
+    }
+}
+
+- (void)testMaskingIsAnInvolution {
+    NSMutableData *roundTrip = [NSMutableData dataWithLength:payload.length];
+    [AWSSRWebSocket _maskBytes:masked.mutableBytes source:payload.bytes length:payload.length maskKey:maskKey];
+    [AWSSRWebSocket _maskBytes:roundTrip.mutableBytes source:masked.bytes length:masked.length maskKey:maskKey];
+    XCTAssertEqualObjects(roundTrip, payload);
+}
+
+- (void)testPerformanceWordWideMasking {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSSRWebSocketMaskingTestsBenchmarkIterations; i++) {
+            [AWSSRWebSocket _maskBytes:self->masked.mutableBytes
+                                source:self->payload.bytes
+                                length:AWSSRWebSocketMaskingTestsBenchmarkPayloadSize
+                               maskKey:self->maskKey];
+        }
+    }];
+}
+
+- (void)testPerformanceBytewiseMasking {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSSRWebSocketMaskingTestsBenchmarkIterations; i++) {
+            AWSSRWebSocketMaskingTestsMaskBytewise(self->masked.mutableBytes,
+                                                   self->payload.bytes,
+                                                   AWSSRWebSocketMaskingTestsBenchmarkPayloadSize,
+                                                   self->maskKey);
+        }
+    }];
+}
+
+- (void)testPerformanceSmallFrameMasking {
+    // 100 byte payloads, the size of a typical shadow update, exercise the tail loop.
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSSRWebSocketMaskingTestsBenchmarkIterations * 100; i++) {
+            [AWSSRWebSocket _maskBytes:self->masked.mutableBytes
+                                source:self->payload.bytes
+                                length:100
+                               maskKey:self->maskKey];
+        }
+    }];
+}
+
+- (void)testAllocationsPerSentFrame {
+    // A shadow update sized payload and one large enough to need the 64 bit length field.
+    for (NSNumber *payloadLength in @[@100, @(AWSSRWebSocketMaskingTestsBenchmarkPayloadSize)]) {
+        NSData *data = [payload subdataWithRange:NSMakeRange(0, payloadLength.unsignedIntegerValue)];
+
+        // Both sides drain the output buffer after every frame the way _pumpWriting does once a write completes,
+        // and both are warmed up first so the buffer's storage has already grown to fit a frame.
+        NSMutableData *outputBuffer = [NSMutableData new];
+        AWSSRWebSocketMaskingTestsAppendFrameWithCopy(outputBuffer, data);
+        outputBuffer.length = 0;
+        NSUInteger copiedFrameAllocations = AWSSRWebSocketMaskingTestsCountAllocations(^{
+            for (NSUInteger i = 0; i < AWSSRWebSocketMaskingTestsAllocationFrames; i++) {
+                @autoreleasepool {
+                    AWSSRWebSocketMaskingTestsAppendFrameWithCopy(outputBuffer, data);
+                    outputBuffer.length = 0;
+                }
+            }
+        });
+
+        // The socket is never opened, so the deferred pump finds no stream space and leaves the buffer to the test.
+        AWSSRWebSocket *socket = [[AWSSRWebSocket alloc] initWithURL:[NSURL URLWithString:@"wss://localhost"]];
+        dispatch_queue_t workQueue = [socket valueForKey:@"_workQueue"];
+        NSMutableData *socketOutputBuffer = [socket valueForKey:@"_outputBuffer"];
+        __block NSUInteger inPlaceFrameAllocations = 0;
+        dispatch_sync(workQueue, ^{
+            [socket _sendFrameWithOpcode:AWSSRWebSocketMaskingTestsOpCodeBinaryFrame data:data];
+            socketOutputBuffer.length = 0;
+            inPlaceFrameAllocations = AWSSRWebSocketMaskingTestsCountAllocations(^{
+                for (NSUInteger i = 0; i < AWSSRWebSocketMaskingTestsAllocationFrames; i++) {
+                    @autoreleasepool {
+                        [socket _sendFrameWithOpcode:AWSSRWebSocketMaskingTestsOpCodeBinaryFrame data:data];
+                        socketOutputBuffer.length = 0;
+                    }
+                }
+            });
+        });
+
+        double copiedPerFrame = (double)copiedFrameAllocations / AWSSRWebSocketMaskingTestsAllocationFrames;
+        double inPlacePerFrame = (double)inPlaceFrameAllocations / AWSSRWebSocketMaskingTestsAllocationFrames;
+        // The copied frame costs at least its NSMutableData and the bytes behind it.
+        XCTAssertGreaterThanOrEqual(copiedPerFrame, 1.0, @"%@ byte payload", payloadLength);
+        XCTAssertLessThan(inPlacePerFrame, 0.1, @"%@ byte payload: %.2f allocations per frame built in place, %.2f per copied frame", payloadLength, inPlacePerFrame, copiedPerFrame);
+    }
+}
+
+@end
@@ -0,0 +1,44 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^OnPublishBrokerBlock)(NSString *topic, NSData *payload, UInt8 qos);
+
+/**
+ A minimal MQTT broker stand-in. It reads the packets a session writes to `inputStream`, answers CONNECT with an
+ accepted CONNACK, PINGREQ with PINGRESP, SUBSCRIBE with a SUBACK granting at most QoS 1 and, while `acksPublishes` is
+ set, QoS 1 PUBLISH with PUBACK. Each PUBLISH is sent back to the session once for every subscription whose topic filter
+ matches it. Instances of `TestMQTTBroker` must be scheduled on a RunLoop.
+ */
+@interface TestMQTTBroker : NSObject<NSStreamDelegate>
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream
+                       outputStream:(NSOutputStream *)outputStream
+                          onPublish:(nullable OnPublishBrokerBlock)onPublish;
+
+/**
+ Whether QoS 1 publishes are acknowledged. Defaults to YES.
+ */
+@property (atomic, assign) BOOL acksPublishes;
+
+- (void)close;
+- (void)open;
+
+@end
+
+NS_ASSUME_NONNULL_END
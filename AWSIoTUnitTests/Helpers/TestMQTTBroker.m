@@ -0,0 +1,235 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "TestMQTTBroker.h"
+
+@implementation TestMQTTBroker {
+    NSInputStream *inputStream;
+    NSOutputStream *outputStream;
+    NSMutableData *readBuffer;
+    NSMutableData *writeBuffer;
+    OnPublishBrokerBlock onPublish;
+    NSMutableDictionary<NSString *, NSNumber *> *subscriptions;
+    UInt16 nextMessageId;
+}
+
+- (instancetype)initWithInputStream:(NSInputStream *)anInputStream
+                       outputStream:(NSOutputStream *)anOutputStream
+                          onPublish:(OnPublishBrokerBlock)block {
+    if (self = [super init]) {
+        inputStream = anInputStream;
+        outputStream = anOutputStream;
+        readBuffer = [NSMutableData new];
+        writeBuffer = [NSMutableData new];
+        onPublish = block;
+        subscriptions = [NSMutableDictionary new];
+        nextMessageId = 1;
+        _acksPublishes = YES;
+    }
+    return self;
+}
+
+- (void)open {
+    for (NSStream *stream in @[inputStream, outputStream]) {
+        [stream setDelegate:self];
+        [stream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+        [stream open];
+    }
+
+    while (!NSThread.currentThread.isCancelled) {
+        NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:1.0];
+        [NSRunLoop.currentRunLoop runUntilDate:deadline];
+    }
+    [self close];
+}
+
+- (void)close {
+    for (NSStream *stream in @[inputStream, outputStream]) {
+        [stream setDelegate:nil];
+        [stream close];
+    }
+}
+
+#pragma mark - NSStreamDelegate
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode {
+    switch (eventCode) {
+        case NSStreamEventHasBytesAvailable: {
+            uint8_t buffer[1024];
+            NSInteger length = [inputStream read:buffer maxLength:sizeof(buffer)];
+            if (length > 0) {
+                [readBuffer appendBytes:buffer length:length];
+                [self handlePackets];
+            }
+            break;
+        }
+        case NSStreamEventHasSpaceAvailable:
+            [self flush];
+            break;
+        default:
+            break;
+    }
+}
+
+#pragma mark - Packets
+
+// Handles every complete packet in the read buffer and leaves any partial packet for the next read.
+- (void)handlePackets {
+    while (YES) {
+        const UInt8 *bytes = readBuffer.bytes;
+        NSUInteger length = readBuffer.length;
+        if (length < 2) {
+            return;
+        }
+
+        NSUInteger remainingLength = 0;
+        NSUInteger multiplier = 1;
+        NSUInteger offset = 1;
+        UInt8 digit;
+        do {
+            if (offset >= length) {
+                return;
+            }
+            digit = bytes[offset++];
+            remainingLength += (digit & 0x7f) * multiplier;
+            multiplier *= 128;
+        } while (digit & 0x80);
+
+        if (length < offset + remainingLength) {
+            return;
+        }
+        [self handlePacketWithHeader:bytes[0] body:[readBuffer subdataWithRange:NSMakeRange(offset, remainingLength)]];
+        [readBuffer replaceBytesInRange:NSMakeRange(0, offset + remainingLength) withBytes:NULL length:0];
+    }
+}
+
+- (void)handlePacketWithHeader:(UInt8)header body:(NSData *)body {
+    const UInt8 *bytes = body.bytes;
+    switch (header >> 4) {
+        case 1: { // CONNECT
+            const UInt8 connack[] = {0x20, 0x02, 0x00, 0x00};
+            [self write:connack length:sizeof(connack)];
+            break;
+        }
+        case 3: { // PUBLISH
+            UInt8 qos = (header >> 1) & 0x03;
+            NSUInteger topicLength = (bytes[0] << 8) | bytes[1];
+            NSString *topic = [[NSString alloc] initWithData:[body subdataWithRange:NSMakeRange(2, topicLength)]
+                                                    encoding:NSUTF8StringEncoding];
+            NSUInteger offset = 2 + topicLength;
+            if (qos > 0) {
+                if (self.acksPublishes) {
+                    const UInt8 puback[] = {0x40, 0x02, bytes[offset], bytes[offset + 1]};
+                    [self write:puback length:sizeof(puback)];
+                }
+                offset += 2;
+            }
+            NSData *payload = [body subdataWithRange:NSMakeRange(offset, body.length - offset)];
+            if (onPublish) {
+                onPublish(topic, payload, qos);
+            }
+            [self deliverPayload:payload onTopic:topic qos:qos];
+            break;
+        }
+        case 8: { // SUBSCRIBE
+            NSMutableData *suback = [NSMutableData dataWithBytes:(const UInt8[]){0x90, 0x00, bytes[0], bytes[1]} length:4];
+            NSUInteger offset = 2;
+            while (offset + 2 < body.length) {
+                NSUInteger topicLength = (bytes[offset] << 8) | bytes[offset + 1];
+                NSString *topicFilter = [[NSString alloc] initWithData:[body subdataWithRange:NSMakeRange(offset + 2, topicLength)]
+                                                              encoding:NSUTF8StringEncoding];
+                UInt8 grantedQoS = MIN(bytes[offset + 2 + topicLength], 1);
+                subscriptions[topicFilter] = @(grantedQoS);
+                [suback appendBytes:&grantedQoS length:1];
+                offset += 2 + topicLength + 1;
+            }
+            ((UInt8 *)suback.mutableBytes)[1] = (UInt8)(suback.length - 2);
+            [self write:suback.bytes length:suback.length];
+            break;
+        }
+        case 12: { // PINGREQ
+            const UInt8 pingresp[] = {0xd0, 0x00};
+            [self write:pingresp length:sizeof(pingresp)];
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Sends a publish back to the session once for each of its subscriptions that match the topic.
+- (void)deliverPayload:(NSData *)payload onTopic:(NSString *)topic qos:(UInt8)qos {
+    for (NSString *topicFilter in subscriptions) {
+        if (![self topicFilter:topicFilter matchesTopic:topic]) {
+            continue;
+        }
+        UInt8 deliveryQoS = MIN(qos, [subscriptions[topicFilter] unsignedCharValue]);
+        NSData *topicData = [topic dataUsingEncoding:NSUTF8StringEncoding];
+        NSUInteger remainingLength = 2 + topicData.length + (deliveryQoS > 0 ? 2 : 0) + payload.length;
+
+        NSMutableData *packet = [NSMutableData new];
+        UInt8 header = 0x30 | (deliveryQoS << 1);
+        [packet appendBytes:&header length:1];
+        do {
+            UInt8 digit = remainingLength % 128;
+            remainingLength /= 128;
+            if (remainingLength > 0) {
+                digit |= 0x80;
+            }
+            [packet appendBytes:&digit length:1];
+        } while (remainingLength > 0);
+        [packet appendBytes:(const UInt8[]){topicData.length >> 8, topicData.length & 0xff} length:2];
+        [packet appendData:topicData];
+        if (deliveryQoS > 0) {
+            UInt16 messageId = nextMessageId;
+            nextMessageId = nextMessageId == UINT16_MAX ? 1 : nextMessageId + 1;
+            [packet appendBytes:(const UInt8[]){messageId >> 8, messageId & 0xff} length:2];
+        }
+        [packet appendData:payload];
+        [self write:packet.bytes length:packet.length];
+    }
+}
+
+- (BOOL)topicFilter:(NSString *)topicFilter matchesTopic:(NSString *)topic {
+    NSArray<NSString *> *filterLevels = [topicFilter componentsSeparatedByString:@"/"];
+    NSArray<NSString *> *topicLevels = [topic componentsSeparatedByString:@"/"];
+    for (NSUInteger i = 0; i < [filterLevels count]; i++) {
+        if ([filterLevels[i] isEqualToString:@"#"]) {
+            return YES;
+        }
+        if (i >= [topicLevels count]
+            || (![filterLevels[i] isEqualToString:@"+"] && ![filterLevels[i] isEqualToString:topicLevels[i]])) {
+            return NO;
+        }
+    }
+    return [filterLevels count] == [topicLevels count];
+}
+
+- (void)write:(const UInt8 *)bytes length:(NSUInteger)length {
+    [writeBuffer appendBytes:bytes length:length];
+    [self flush];
+}
+
+- (void)flush {
+    while (writeBuffer.length > 0 && [outputStream hasSpaceAvailable]) {
+        NSInteger written = [outputStream write:writeBuffer.bytes maxLength:writeBuffer.length];
+        if (written <= 0) {
+            return;
+        }
+        [writeBuffer replaceBytesInRange:NSMakeRange(0, written) withBytes:NULL length:0];
+    }
+}
+
+@end
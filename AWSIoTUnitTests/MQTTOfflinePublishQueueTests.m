@@ -0,0 +1,314 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSMQTTSession.h"
+#import "AWSMQTTOfflinePublishQueue.h"
+
+#import "TestMQTTBroker.h"
+#import "TestMQTTSessionDelegate.h"
+
+@interface MQTTOfflinePublishQueueTests : XCTestCase
+
+@end
+
+@implementation MQTTOfflinePublishQueueTests {
+    NSString *databasePath;
+    NSThread *brokerThread;
+}
+
+- (void)setUp {
+    databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    [brokerThread cancel];
+    brokerThread = nil;
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[databasePath stringByAppendingString:suffix] error:nil];
+    }
+}
+
+- (AWSMQTTOfflinePublishQueue *)queueWithByteLimit:(NSUInteger)byteLimit
+                                      messageLimit:(NSUInteger)messageLimit
+                                    evictionPolicy:(AWSIoTMQTTOfflinePublishQueueEvictionPolicy)evictionPolicy {
+    return [[AWSMQTTOfflinePublishQueue alloc] initWithPath:databasePath
+                                                  byteLimit:byteLimit
+                                               messageLimit:messageLimit
+                                             evictionPolicy:evictionPolicy];
+}
+
+- (AWSMQTTSession *)sessionWithPublishRetryThrottle:(NSUInteger)publishRetryThrottle {
+    return [[AWSMQTTSession alloc] initWithClientId:@"testOfflinePublishQueue"
+                                           userName:@"testOfflinePublishQueueUser"
+                                           password:@"testOfflinePublishQueuePass"
+                                          keepAlive:60
+                                       cleanSession:YES
+                                          willTopic:nil
+                                            willMsg:nil
+                                            willQoS:0
+                                     willRetainFlag:NO
+                               publishRetryThrottle:publishRetryThrottle];
+}
+
+// Connects the session to a broker stand-in running on its own thread.
+- (TestMQTTBroker *)connectSession:(AWSMQTTSession *)session onPublish:(OnPublishBrokerBlock)onPublish {
+    NSInputStream *sessionInputStream;
+    NSOutputStream *brokerOutputStream;
+    [NSStream getBoundStreamsWithBufferSize:1024 inputStream:&sessionInputStream outputStream:&brokerOutputStream];
+
+    NSInputStream *brokerInputStream;
+    NSOutputStream *sessionOutputStream;
+    [NSStream getBoundStreamsWithBufferSize:1024 inputStream:&brokerInputStream outputStream:&sessionOutputStream];
+
+    TestMQTTBroker *broker = [[TestMQTTBroker alloc] initWithInputStream:brokerInputStream
+                                                            outputStream:brokerOutputStream
+                                                               onPublish:onPublish];
+    brokerThread = [[NSThread alloc] initWithTarget:broker
+                                           selector:@selector(open)
+                                             object:nil];
+    brokerThread.name = @"broker";
+    [brokerThread start];
+
+    [session connectToInputStream:sessionInputStream outputStream:sessionOutputStream];
+    return broker;
+}
+
+- (NSData *)payloadWithIndex:(NSUInteger)index {
+    return [[NSString stringWithFormat:@"message %lu", (unsigned long)index] dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)topicWithIndex:(NSUInteger)index {
+    return [NSString stringWithFormat:@"offline/%lu", (unsigned long)index];
+}
+
+- (void)waitForMessageCount:(NSUInteger)messageCount inQueue:(AWSMQTTOfflinePublishQueue *)queue {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"messageCount == %lu", (unsigned long)messageCount];
+    [self waitForExpectations:@[[[XCTNSPredicateExpectation alloc] initWithPredicate:predicate object:queue]]
+                      timeout:5.0];
+}
+
+#pragma mark - Session
+
+- (void)testMessagesPublishedWhileOfflineAreSentInOrderOnceConnected {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:0
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    AWSMQTTSession *session = [self sessionWithPublishRetryThrottle:10];
+    session.offlinePublishQueue = queue;
+
+    XCTAssertTrue([session shouldQueueOfflinePublish]);
+    for (NSUInteger i = 0; i < 6; i++) {
+        if (i % 2 == 0) {
+            [session publishDataAtMostOnce:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i]];
+        } else {
+            XCTAssertEqual([session publishDataAtLeastOnce:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i]], 0);
+        }
+    }
+    XCTAssertEqual(queue.messageCount, 6);
+
+    XCTestExpectation *delivered = [self expectationWithDescription:@"6 messages delivered"];
+    delivered.expectedFulfillmentCount = 6;
+    NSMutableArray<NSString *> *topics = [NSMutableArray new];
+    NSMutableArray<NSData *> *payloads = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *qosLevels = [NSMutableArray new];
+    [self connectSession:session onPublish:^(NSString *topic, NSData *payload, UInt8 qos) {
+        @synchronized(topics) {
+            [topics addObject:topic];
+            [payloads addObject:payload];
+            [qosLevels addObject:@(qos)];
+        }
+        [delivered fulfill];
+    }];
+
+    [self waitForExpectations:@[delivered] timeout:5.0];
+    [self waitForMessageCount:0 inQueue:queue];
+
+    for (NSUInteger i = 0; i < 6; i++) {
+        XCTAssertEqualObjects(topics[i], [self topicWithIndex:i]);
+        XCTAssertEqualObjects(payloads[i], [self payloadWithIndex:i]);
+        XCTAssertEqualObjects(qosLevels[i], @(i % 2));
+    }
+    XCTAssertFalse([session shouldQueueOfflinePublish]);
+}
+
+- (void)testReplayIsLimitedByPublishRetryThrottle {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:0
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    AWSMQTTSession *session = [self sessionWithPublishRetryThrottle:2];
+    session.offlinePublishQueue = queue;
+    for (NSUInteger i = 0; i < 6; i++) {
+        [session publishDataAtLeastOnce:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i]];
+    }
+
+    XCTestExpectation *delivered = [self expectationWithDescription:@"6 messages delivered"];
+    delivered.expectedFulfillmentCount = 6;
+    NSMutableArray<NSDate *> *deliveryDates = [NSMutableArray new];
+    [self connectSession:session onPublish:^(NSString *topic, NSData *payload, UInt8 qos) {
+        @synchronized(deliveryDates) {
+            [deliveryDates addObject:[NSDate date]];
+        }
+        [delivered fulfill];
+    }];
+
+    [self waitForExpectations:@[delivered] timeout:10.0];
+
+    // Two messages go out on each one second tick.
+    XCTAssertGreaterThan([deliveryDates[2] timeIntervalSinceDate:deliveryDates[1]], 0.5);
+    XCTAssertGreaterThan([deliveryDates[4] timeIntervalSinceDate:deliveryDates[3]], 0.5);
+    [self waitForMessageCount:0 inQueue:queue];
+}
+
+- (void)testUnacknowledgedMessagesStayQueued {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:0
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    AWSMQTTSession *session = [self sessionWithPublishRetryThrottle:10];
+    session.offlinePublishQueue = queue;
+    [session publishDataAtMostOnce:[self payloadWithIndex:0] onTopic:[self topicWithIndex:0]];
+    [session publishDataAtLeastOnce:[self payloadWithIndex:1] onTopic:[self topicWithIndex:1]];
+
+    XCTestExpectation *delivered = [self expectationWithDescription:@"2 messages delivered"];
+    delivered.expectedFulfillmentCount = 2;
+    TestMQTTBroker *broker = [self connectSession:session onPublish:^(NSString *topic, NSData *payload, UInt8 qos) {
+        [delivered fulfill];
+    }];
+    broker.acksPublishes = NO;
+
+    [self waitForExpectations:@[delivered] timeout:5.0];
+
+    // The QoS 0 message is gone once written; the QoS 1 message waits for its PubAck and is not sent again meanwhile.
+    [self waitForMessageCount:1 inQueue:queue];
+    NSArray<AWSMQTTOfflinePublishMessage *> *messages = [queue oldestMessagesWithLimit:10 excludingIdentifiers:[NSSet set]];
+    XCTAssertEqual([messages count], 1);
+    XCTAssertEqualObjects(messages[0].topic, [self topicWithIndex:1]);
+
+    // Nothing is left to replay, so a message published now is sent directly.
+    XCTAssertFalse([session shouldQueueOfflinePublish]);
+}
+
+- (void)testMessagesWithoutAQueueAreNotQueued {
+    AWSMQTTSession *session = [self sessionWithPublishRetryThrottle:10];
+    XCTAssertFalse([session shouldQueueOfflinePublish]);
+    XCTAssertNotEqual([session publishDataAtLeastOnce:[self payloadWithIndex:0] onTopic:[self topicWithIndex:0]], 0);
+}
+
+#pragma mark - Queue
+
+- (void)testMessagesSurviveReopeningTheQueue {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:0
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:0] onTopic:[self topicWithIndex:0] qos:0 retainFlag:NO rejected:NULL]);
+    XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:1] onTopic:[self topicWithIndex:1] qos:1 retainFlag:YES rejected:NULL]);
+    XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:2] onTopic:[self topicWithIndex:2] qos:1 retainFlag:NO rejected:NULL]);
+    queue = nil;
+
+    queue = [self queueWithByteLimit:0
+                        messageLimit:0
+                      evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    XCTAssertEqual(queue.messageCount, 3);
+    NSArray<AWSMQTTOfflinePublishMessage *> *messages = [queue oldestMessagesWithLimit:10 excludingIdentifiers:[NSSet set]];
+    XCTAssertEqual([messages count], 3);
+    for (NSUInteger i = 0; i < 3; i++) {
+        XCTAssertEqualObjects(messages[i].topic, [self topicWithIndex:i]);
+        XCTAssertEqualObjects(messages[i].data, [self payloadWithIndex:i]);
+    }
+    XCTAssertEqual(messages[0].qos, 0);
+    XCTAssertFalse(messages[0].retainFlag);
+    XCTAssertEqual(messages[1].qos, 1);
+    XCTAssertTrue(messages[1].retainFlag);
+
+    NSSet *excludedIdentifiers = [NSSet setWithObject:@(messages[0].identifier)];
+    NSArray<AWSMQTTOfflinePublishMessage *> *remaining = [queue oldestMessagesWithLimit:1 excludingIdentifiers:excludedIdentifiers];
+    XCTAssertEqual([remaining count], 1);
+    XCTAssertEqual(remaining[0].identifier, messages[1].identifier);
+
+    [queue removeMessages:@[messages[1]]];
+    XCTAssertEqual(queue.messageCount, 2);
+    [queue removeAllMessages];
+    XCTAssertEqual(queue.messageCount, 0);
+}
+
+- (void)testDropOldestPolicyMakesRoomForNewMessages {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:3
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    for (NSUInteger i = 0; i < 5; i++) {
+        BOOL rejected = YES;
+        XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i] qos:1 retainFlag:NO rejected:&rejected]);
+        XCTAssertFalse(rejected);
+    }
+
+    XCTAssertEqual(queue.messageCount, 3);
+    XCTAssertEqual(queue.droppedMessageCount, 2);
+    NSArray<AWSMQTTOfflinePublishMessage *> *messages = [queue oldestMessagesWithLimit:10 excludingIdentifiers:[NSSet set]];
+    XCTAssertEqualObjects([messages valueForKey:@"topic"], (@[[self topicWithIndex:2], [self topicWithIndex:3], [self topicWithIndex:4]]));
+}
+
+- (void)testDropOldestPolicyHonorsTheByteLimit {
+    // Each message counts its payload, its topic and a one byte QoS tag.
+    NSUInteger messageByteCount = [self payloadWithIndex:0].length + [self topicWithIndex:0].length + 1;
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:messageByteCount * 2
+                                                    messageLimit:0
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropOldest];
+    for (NSUInteger i = 0; i < 4; i++) {
+        XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i] qos:1 retainFlag:NO rejected:NULL]);
+    }
+
+    XCTAssertEqual(queue.messageCount, 2);
+    XCTAssertEqual(queue.byteCount, messageByteCount * 2);
+    XCTAssertEqual(queue.droppedMessageCount, 2);
+
+    // A message larger than the whole queue is dropped without evicting anything.
+    NSMutableData *largePayload = [NSMutableData dataWithLength:messageByteCount * 3];
+    XCTAssertNil([queue enqueueData:largePayload onTopic:[self topicWithIndex:4] qos:1 retainFlag:NO rejected:NULL]);
+    XCTAssertEqual(queue.messageCount, 2);
+    XCTAssertEqual(queue.droppedMessageCount, 3);
+}
+
+- (void)testDropNewestPolicyKeepsQueuedMessages {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:3
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyDropNewest];
+    for (NSUInteger i = 0; i < 5; i++) {
+        BOOL rejected = YES;
+        AWSMQTTOfflinePublishMessage *message = [queue enqueueData:[self payloadWithIndex:i] onTopic:[self topicWithIndex:i] qos:1 retainFlag:NO rejected:&rejected];
+        XCTAssertEqual(message == nil, i >= 3);
+        XCTAssertFalse(rejected);
+    }
+
+    XCTAssertEqual(queue.messageCount, 3);
+    XCTAssertEqual(queue.droppedMessageCount, 2);
+    NSArray<AWSMQTTOfflinePublishMessage *> *messages = [queue oldestMessagesWithLimit:10 excludingIdentifiers:[NSSet set]];
+    XCTAssertEqualObjects([messages valueForKey:@"topic"], (@[[self topicWithIndex:0], [self topicWithIndex:1], [self topicWithIndex:2]]));
+}
+
+- (void)testRejectPolicyReportsTheRejection {
+    AWSMQTTOfflinePublishQueue *queue = [self queueWithByteLimit:0
+                                                    messageLimit:1
+                                                  evictionPolicy:AWSIoTMQTTOfflinePublishQueueEvictionPolicyReject];
+    BOOL rejected = YES;
+    XCTAssertNotNil([queue enqueueData:[self payloadWithIndex:0] onTopic:[self topicWithIndex:0] qos:0 retainFlag:NO rejected:&rejected]);
+    XCTAssertFalse(rejected);
+
+    XCTAssertNil([queue enqueueData:[self payloadWithIndex:1] onTopic:[self topicWithIndex:1] qos:0 retainFlag:NO rejected:&rejected]);
+    XCTAssertTrue(rejected);
+    XCTAssertEqual(queue.messageCount, 1);
+    XCTAssertEqual(queue.droppedMessageCount, 1);
+}
+
+@end
@@ -22,7 +22,7 @@
 @interface AWSAbstractKinesisRecorder : AWSService
 
 /**
- The number of bytes currently used to store AWSKinesisPutRecordInput objects on disk.
+ The number of bytes currently used to store AWSKinesisPutRecordInput objects on disk, counting the data and partition key of each record.
  */
 @property (nonatomic, assign, readonly) NSUInteger diskBytesUsed;
 
@@ -42,6 +42,11 @@
  */
 @property (nonatomic, assign) NSTimeInterval diskAgeLimit;
 
+/**
+ Whether records are gzip-compressed before they are saved, so that more of them fit in `diskByteLimit`. Records are decompressed again before they are submitted, so consumers of the stream receive the data as it was saved. Records that do not get smaller are saved as they are. `batchRecordsByteLimit` still applies to the decompressed size. The default is `NO`.
+ */
+@property (nonatomic, assign) BOOL compressesRecords;
+
 /**
  The maxium batch data size in bytes. The default value is 512KB. The maximum is 4MB.
  */
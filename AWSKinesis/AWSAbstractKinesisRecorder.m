@@ -23,6 +23,18 @@ NSTimeInterval const AWSKinesisAbstractClientAgeLimitDefault = 0.0; // Keeps the
 NSString *const AWSKinesisAbstractClientUserAgent = @"recorder";
 NSUInteger const AWSKinesisAbstractClientBatchRecordByteLimitDefault = 512 * 1024; // 512KB
 NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazonaws/AWSKinesisRecorder";
+NSUInteger const AWSKinesisAbstractClientBatchRecordCountLimitDefault = 128;
+// The tag of records saved gzip-compressed is this prefix followed by the length of their data before it was compressed.
+NSString *const AWSKinesisAbstractClientGZIPRecordTagPrefix = @"gzip:";
+
+// The bytes a record takes in a batch once its data is decompressed.
+static NSUInteger AWSKinesisAbstractClientSubmittedByteCount(AWSDurableQueueRecord *record) {
+    if (![record.tag hasPrefix:AWSKinesisAbstractClientGZIPRecordTagPrefix]) {
+        return record.byteCount;
+    }
+    NSUInteger dataLength = (NSUInteger)[[record.tag substringFromIndex:[AWSKinesisAbstractClientGZIPRecordTagPrefix length]] longLongValue];
+    return record.byteCount - [record.data length] + MAX(dataLength, [record.data length]);
+}
 
 @protocol AWSKinesisRecorderHelper <NSObject>
 
@@ -46,8 +58,9 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 @interface AWSAbstractKinesisRecorder()
 
 @property (nonatomic, strong) id<AWSKinesisRecorderHelper> recorderHelper;
-@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+@property (nonatomic, strong) AWSDurableQueue *queue;
 @property (nonatomic, strong) NSString *databasePath;
+@property (nonatomic, assign) NSUInteger batchRecordsCountLimit;
 
 @end
 
@@ -71,6 +84,7 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
         _diskByteLimit = AWSKinesisAbstractClientByteLimitDefault;
         _diskAgeLimit = AWSKinesisAbstractClientAgeLimitDefault;
         _batchRecordsByteLimit = AWSKinesisAbstractClientBatchRecordByteLimitDefault;
+        _batchRecordsCountLimit = AWSKinesisAbstractClientBatchRecordCountLimitDefault;
 
         // Creates a directory for storing databases if it doesn't exist.
         BOOL fileExistsAtPath = [[NSFileManager defaultManager] fileExistsAtPath:databaseDirectoryPath];
@@ -87,22 +101,19 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 
         // Creates a database for the identifier if it doesn't exist.
         AWSDDLogDebug(@"Database path: [%@]", _databasePath);
-        _databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
-        [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeStatements:@"PRAGMA auto_vacuum = FULL"]) {
                 AWSDDLogError(@"Failed to enable 'auto_vacuum' to 'FULL'. %@", db.lastError);
             }
+        }];
 
-            if (![db executeUpdate:
-                  @"CREATE TABLE IF NOT EXISTS record ("
-                  @"partition_key TEXT NOT NULL,"
-                  @"stream_name TEXT NOT NULL,"
-                  @"data BLOB NOT NULL,"
-                  @"timestamp REAL NOT NULL,"
-                  @"retry_count INTEGER NOT NULL)"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-            }
+        _queue = [[AWSDurableQueue alloc] initWithDatabaseQueue:databaseQueue];
+        _queue.byteLimit = _diskByteLimit;
+        _queue.ageLimit = _diskAgeLimit;
+        [self moveRecordsFromRecordTable];
 
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"VACUUM"]) {
                 AWSDDLogError(@"SQLite error. [%@]", db.lastError);
             }
@@ -111,6 +122,47 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
     return self;
 }
 
+// Records saved by earlier versions of the SDK are kept in the `record` table. They are appended to the queue before
+// the table is dropped, so an interruption in between can send them twice but never loses them.
+- (void)moveRecordsFromRecordTable {
+    AWSFMDatabaseQueue *databaseQueue = self.queue.databaseQueue;
+    NSMutableArray<AWSDurableQueueRecord *> *records = [NSMutableArray new];
+    __block BOOL tableExists = NO;
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        tableExists = [db tableExists:@"record"];
+        if (!tableExists) {
+            return;
+        }
+        AWSFMResultSet *rs = [db executeQuery:
+                              @"SELECT partition_key, stream_name, data, timestamp, retry_count "
+                              @"FROM record "
+                              @"ORDER BY timestamp ASC"];
+        while ([rs next]) {
+            [records addObject:[[AWSDurableQueueRecord alloc] initWithChannel:[rs stringForColumn:@"stream_name"]
+                                                                          key:[rs stringForColumn:@"partition_key"]
+                                                                          tag:nil
+                                                                         data:[rs dataForColumn:@"data"] ?: [NSData data]
+                                                                    timestamp:[rs doubleForColumn:@"timestamp"]
+                                                                   retryCount:(NSUInteger)[rs longLongIntForColumn:@"retry_count"]]];
+        }
+        [rs close];
+    }];
+    if (!tableExists) {
+        return;
+    }
+
+    NSError *error = nil;
+    if (![self.queue appendRecords:records error:&error]) {
+        AWSDDLogError(@"Failed to move the saved records. [%@]", error);
+        return;
+    }
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        if (![db executeUpdate:@"DROP TABLE record"]) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+        }
+    }];
+}
+
 + (dispatch_queue_t)sharedQueue {
     static dispatch_queue_t queue;
     static dispatch_once_t predicate;
@@ -135,190 +187,113 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
         return [AWSTask taskWithError:[self.recorderHelper dataTooLargeError]];
     }
 
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    NSTimeInterval diskAgeLimit = self.diskAgeLimit;
-    NSString *databasePath = self.databasePath;
+    AWSDurableQueue *queue = self.queue;
     NSUInteger notificationByteThreshold = self.notificationByteThreshold;
-    NSUInteger diskByteLimit = self.diskByteLimit;
     __weak id notificationSender = self;
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        // Inserts a new record to the database.
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            BOOL result = [db executeUpdate:
-                           @"INSERT INTO record ("
-                           @"partition_key, stream_name, data, timestamp, retry_count"
-                           @") VALUES ("
-                           @":partition_key, :stream_name, :data, :timestamp, :retry_count"
-                           @")"
-                    withParameterDictionary:@{
-                                              @"partition_key" : partitionKey,
-                                              @"stream_name" : streamName,
-                                              @"data" : data,
-                                              @"timestamp" : @([[NSDate date] timeIntervalSince1970]),
-                                              @"retry_count" : @0
-                                              }
-                           ];
-
-
-            if (!result) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
-            }
-        }];
-
-        if (!error && diskAgeLimit > 0) {
-            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                // Deletes old records exceeding the threshold.
-                BOOL result = [db executeUpdate:
-                               @"DELETE FROM record "
-                               @"WHERE timestamp < :timestamp"
-                        withParameterDictionary:@{
-                                                  @"timestamp" : @([[NSDate date] timeIntervalSince1970] - diskAgeLimit)
-                                                  }
-                               ];
-                if (!result) {
-                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                    error = db.lastError;
-                }
-            }];
-        }
-
-        if (error) {
-            return [AWSTask taskWithError:error];
+    // Compresses on the calling thread so that records are appended in the order they are saved.
+    NSString *tag = nil;
+    if (self.compressesRecords) {
+        NSData *compressedData = [data awsgzip_gzippedData];
+        if (compressedData && [compressedData length] < [data length]) {
+            tag = [NSString stringWithFormat:@"%@%lu", AWSKinesisAbstractClientGZIPRecordTagPrefix, (unsigned long)[data length]];
+            data = compressedData;
         }
-
-        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:databasePath
-                                                                                    error:&error];
-        if (attributes) {
-            NSUInteger fileSize = (NSUInteger)[attributes fileSize];
-            [self.recorderHelper checkByteThresholdForNotification:notificationByteThreshold
-                                                notificationSender:notificationSender
-                                                          fileSize:fileSize];
-            if (fileSize > diskByteLimit) {
-                // Deletes the oldest record if it exceeds the disk size threshold.
-                [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                    BOOL result = [db executeUpdate:
-                                   @"DELETE FROM record "
-                                   @"WHERE rowid IN ( "
-                                   @"SELECT rowid "
-                                   @"FROM record "
-                                   @"ORDER BY timestamp ASC "
-                                   @"LIMIT 1 "
-                                   @")"
-                                   ];
-                    if (!result) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                        return;
-                    }
-                }];
-
-            }
-        } else if (error) {
-            return [AWSTask taskWithError:error];
-        }
-
+    }
+    AWSDurableQueueRecord *record = [[AWSDurableQueueRecord alloc] initWithChannel:streamName
+                                                                               key:partitionKey
+                                                                               tag:tag
+                                                                              data:data];
+
+    // The queue writes records saved at about the same time in one transaction, and evicts the oldest records when it
+    // exceeds the age or byte limit.
+    return [[queue appendRecord:record] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        [self.recorderHelper checkByteThresholdForNotification:notificationByteThreshold
+                                            notificationSender:notificationSender
+                                                      fileSize:(NSUInteger)queue.byteCount];
         return nil;
     }];
 }
 
 - (AWSTask *)submitAllRecords {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSDurableQueue *queue = self.queue;
 
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        __block NSUInteger batchSize = 0;
-        __block BOOL stop = NO;
+        NSError *error = nil;
+        NSUInteger batchSize = 0;
+        BOOL stop = NO;
 
         do {
-            [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                NSMutableArray *rowIds = nil;
-
-                AWSFMResultSet *rs = [db executeQuery:
-                                      @"SELECT rowid, partition_key, data, retry_count, stream_name "
-                                      @"FROM record "
-                                      @"WHERE stream_name = (SELECT stream_name FROM record ORDER BY timestamp ASC LIMIT 1) "
-                                      @"ORDER BY timestamp ASC "
-                                      @"LIMIT 128"];
-                if (!rs) {
-                    AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-                    error = db.lastError;
-                    *rollback = YES;
-                    return;
-                }
+            // Records of the stream with the oldest record. They stay in the queue until the stream accepts them. Stored
+            // records are never larger than they are sent, so the batch is cut to the byte limit again below.
+            NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:nil
+                                                                                 limit:self.batchRecordsCountLimit
+                                                                             byteLimit:self.batchRecordsByteLimit
+                                                                                 error:&error];
+            batchSize = [records count];
+            if (batchSize == 0) {
+                break;
+            }
 
-                NSUInteger batchDataSize = 0;
-                NSMutableArray *temporaryRecords = [NSMutableArray new];
-                rowIds = [NSMutableArray new];
-                while ([rs next]) {
-                    [temporaryRecords addObject:@{
-                                                  @"partition_key": [rs stringForColumn:@"partition_key"],
-                                                  @"data": [rs dataForColumn:@"data"],
-                                                  @"stream_name": [rs stringForColumn:@"stream_name"],
-                                                  }];
-
-                    [rowIds addObject:[rs stringForColumn:@"rowid"]];
-                    batchDataSize += [[rs dataForColumn:@"data"] length];
-
-                    if (batchDataSize > self.batchRecordsByteLimit) { // if the batch size exceeds `batchRecordsByteLimit`, stop there.
-                        break;
+            NSMutableArray *temporaryRecords = [NSMutableArray new];
+            NSMutableArray *rowIds = [NSMutableArray new];
+            NSMutableArray *putRowIds = [NSMutableArray new];
+            NSMutableArray *retryRowIds = [NSMutableArray new];
+            NSMutableDictionary<NSString *, AWSDurableQueueRecord *> *recordsByRowId = [NSMutableDictionary new];
+            NSUInteger batchByteCount = 0;
+            for (AWSDurableQueueRecord *record in records) {
+                // Compressed records are limited by their decompressed size. The rest are left for the next batch.
+                NSUInteger submittedByteCount = AWSKinesisAbstractClientSubmittedByteCount(record);
+                if ([recordsByRowId count] > 0 && batchByteCount + submittedByteCount > self.batchRecordsByteLimit) {
+                    break;
+                }
+                batchByteCount += submittedByteCount;
+
+                NSString *rowId = [@(record.identifier) stringValue];
+                recordsByRowId[rowId] = record;
+
+                NSData *data = record.data;
+                if ([record.tag hasPrefix:AWSKinesisAbstractClientGZIPRecordTagPrefix]) {
+                    data = [data awsgzip_gunzippedData];
+                    if (!data) {
+                        // It can never be sent, so it is deleted.
+                        AWSDDLogError(@"Failed to decompress record %@. Deleting it.", rowId);
+                        [putRowIds addObject:rowId];
+                        continue;
                     }
                 }
-                rs = nil;
-                batchSize = [temporaryRecords count];
-
-                if (batchSize > 0) {
-                    __block NSMutableArray *putRowIds = [NSMutableArray new];
-                    __block NSMutableArray *retryRowIds = [NSMutableArray new];
-
-                    NSString *streamName = temporaryRecords[0][@"stream_name"];
-
-                    AWSTask *submitTask = \
-                        [self.recorderHelper submitRecordsForStream:streamName
-                                                            records:temporaryRecords
-                                                             rowIds:rowIds
-                                                          putRowIds:putRowIds
-                                                        retryRowIds:retryRowIds
-                                                               stop:&stop];
-
-                    [submitTask waitUntilFinished];
+                [temporaryRecords addObject:@{
+                                              @"partition_key": record.key ?: @"",
+                                              @"data": data,
+                                              @"stream_name": record.channel,
+                                              }];
+                [rowIds addObject:rowId];
+            }
 
-                    if (submitTask.error) {
-                        error = submitTask.error;
-                    }
+            if ([temporaryRecords count] > 0) {
+                AWSTask *submitTask = \
+                    [self.recorderHelper submitRecordsForStream:records[0].channel
+                                                        records:temporaryRecords
+                                                         rowIds:rowIds
+                                                      putRowIds:putRowIds
+                                                    retryRowIds:retryRowIds
+                                                           stop:&stop];
 
-                    for (NSString *rowId in putRowIds) {
-                        BOOL result = [db executeUpdate:@"DELETE FROM record WHERE rowid = :rowid"
-                                withParameterDictionary:@{
-                                                          @"rowid" : rowId
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                        }
-                    }
+                [submitTask waitUntilFinished];
 
-                    for (NSString *rowId in retryRowIds) {
-                        BOOL result = [db executeUpdate:@"UPDATE record SET retry_count = retry_count + 1 WHERE rowid = :rowid"
-                                withParameterDictionary:@{
-                                                          @"rowid" : rowId
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                        }
-                    }
+                if (submitTask.error) {
+                    error = submitTask.error;
                 }
+            }
 
-                // If a record failed three times, give up and delete the record.
-                BOOL result = [db executeUpdate:@"DELETE FROM record WHERE retry_count > 3"];
-                if (!result) {
-                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                    error = db.lastError;
-                }
-            }];
+            NSError *queueError = nil;
+            if (![queue acknowledgeRecords:[recordsByRowId objectsForKeys:putRowIds notFoundMarker:[NSNull null]] error:&queueError]) {
+                error = queueError;
+            }
+            // A record that failed more than three times is given up and deleted.
+            if (![queue retryRecords:[recordsByRowId objectsForKeys:retryRowIds notFoundMarker:[NSNull null]] error:&queueError]) {
+                error = queueError;
+            }
         } while (!stop && !error && batchSize > 0);
 
         if (error) {
@@ -330,18 +305,11 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 }
 
 - (AWSTask *)removeAllRecords {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSDurableQueue *queue = self.queue;
 
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            if (![db executeUpdate:@"DELETE FROM record"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
-            }
-        }];
-
-        if (error) {
+        NSError *error = nil;
+        if (![queue removeRecordsInChannel:nil error:&error]) {
             return [AWSTask taskWithError:error];
         }
 
@@ -350,15 +318,17 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 }
 
 - (NSUInteger)diskBytesUsed {
-    NSError *error = nil;
-    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:self.databasePath
-                                                                                error:&error];
-    if (attributes) {
-        return (NSUInteger)[attributes fileSize];
-    } else {
-        AWSDDLogError(@"Error [%@]", error);
-        return 0;
-    }
+    return (NSUInteger)self.queue.byteCount;
+}
+
+- (void)setDiskByteLimit:(NSUInteger)diskByteLimit {
+    _diskByteLimit = diskByteLimit;
+    self.queue.byteLimit = diskByteLimit;
+}
+
+- (void)setDiskAgeLimit:(NSTimeInterval)diskAgeLimit {
+    _diskAgeLimit = diskAgeLimit;
+    self.queue.ageLimit = diskAgeLimit;
 }
 
 - (void)setBatchRecordsByteLimit:(NSUInteger)batchRecordsByteLimit {
@@ -41,4 +41,5 @@ FOUNDATION_EXPORT const unsigned char AWSKinesisVersionString[] DEPRECATED_MSG_A
 #import <AWSCore/AWSCore.h>
 #import "AWSKinesisService.h"
 #import "AWSKinesisRecorder.h"
+#import "AWSKinesisRecordAggregator.h"
 #import "AWSFirehose.h"
@@ -0,0 +1,93 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+@class AWSKinesisPutRecordsRequestEntry;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The largest Kinesis record, counting the data and the partition key: 1MB.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSKinesisRecordAggregatorMaximumByteCountDefault;
+
+/**
+ Packs user records into a single Kinesis record in the aggregated record format of the Kinesis Producer Library.
+
+ An aggregated record is the 4 byte magic number `F3 89 9A C2`, an `AggregatedRecord` protobuf message and the MD5
+ digest of that message. The Kinesis Client Library, and the deaggregation modules built on it, split it back into the
+ user records. Consumers that read the stream without them see the aggregated bytes.
+ */
+@interface AWSKinesisRecordAggregator : NSObject
+
+/**
+ Creates an aggregator whose records are at most `AWSKinesisRecordAggregatorMaximumByteCountDefault` bytes.
+ */
+- (instancetype)init;
+
+/**
+ Creates an aggregator whose records, counting the aggregated data and the partition key, are at most
+ `maximumByteCount` bytes.
+ */
+- (instancetype)initWithMaximumByteCount:(NSUInteger)maximumByteCount NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly) NSUInteger maximumByteCount;
+
+/**
+ The number of user records added since the aggregator was last reset.
+ */
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+/**
+ The size of the record `requestEntry` would return, counting the partition key.
+ */
+@property (nonatomic, readonly) NSUInteger byteCount;
+
+/**
+ Adds a user record.
+
+ @return `NO`, without adding the record, if the aggregated record would grow past `maximumByteCount`. The first record
+         is always added.
+ */
+- (BOOL)addRecordWithData:(NSData *)data partitionKey:(NSString *)partitionKey;
+
+/**
+ The Kinesis record holding the records added so far, keyed by the partition key of the first of them. A single record
+ is returned as it was added, without aggregating it. `nil` if no records were added.
+ */
+- (nullable AWSKinesisPutRecordsRequestEntry *)requestEntry;
+
+/**
+ Removes the records added so far.
+ */
+- (void)reset;
+
+/**
+ Whether `data` starts with the aggregated record magic number and ends with a matching MD5 digest.
+ */
++ (BOOL)isAggregatedData:(NSData *)data;
+
+/**
+ Splits the data of an aggregated record into its user records.
+
+ @return The user records, with their data and partition key, or `nil` if `data` is not a well-formed aggregated
+         record.
+ */
++ (nullable NSArray<AWSKinesisPutRecordsRequestEntry *> *)requestEntriesFromAggregatedData:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
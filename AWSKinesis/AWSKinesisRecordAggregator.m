@@ -0,0 +1,331 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSKinesisRecordAggregator.h"
+#import "AWSKinesisModel.h"
+
+NSUInteger const AWSKinesisRecordAggregatorMaximumByteCountDefault = 1024 * 1024; // 1MB
+
+static const uint8_t AWSKinesisAggregatedRecordMagic[] = {0xF3, 0x89, 0x9A, 0xC2};
+
+// Protobuf keys, (field number << 3) | wire type, of the fields of
+//
+//     message AggregatedRecord {
+//         repeated string partition_key_table = 1;
+//         repeated string explicit_hash_key_table = 2;
+//         repeated Record records = 3;
+//     }
+//     message Record {
+//         required uint64 partition_key_index = 1;
+//         optional uint64 explicit_hash_key_index = 2;
+//         required bytes data = 3;
+//         repeated Tag tags = 4;
+//     }
+static const uint8_t AWSKinesisAggregatedRecordPartitionKeyKey = (1 << 3) | 2;
+static const uint8_t AWSKinesisAggregatedRecordRecordKey = (3 << 3) | 2;
+static const uint8_t AWSKinesisRecordPartitionKeyIndexKey = (1 << 3) | 0;
+static const uint8_t AWSKinesisRecordDataKey = (3 << 3) | 2;
+
+static inline NSUInteger AWSKinesisVarintSize(uint64_t value) {
+    NSUInteger size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// The encoded size of a length-delimited field.
+static inline NSUInteger AWSKinesisFieldSize(NSUInteger length) {
+    return 1 + AWSKinesisVarintSize(length) + length;
+}
+
+static inline uint8_t *AWSKinesisWriteVarint(uint8_t *p, uint64_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+static inline uint8_t *AWSKinesisWriteField(uint8_t *p, uint8_t key, const void *bytes, NSUInteger length) {
+    *p++ = key;
+    p = AWSKinesisWriteVarint(p, length);
+    memcpy(p, bytes, length);
+    return p + length;
+}
+
+static BOOL AWSKinesisReadVarint(const uint8_t **p, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        uint8_t byte = *(*p)++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// Reads the key of the next field and, for length-delimited fields, the bounds of its bytes. Fields of other wire
+// types are skipped over and returned with an empty range.
+static BOOL AWSKinesisReadField(const uint8_t **p, const uint8_t *end, uint64_t *field, const uint8_t **bytes, uint64_t *length, uint64_t *varint) {
+    uint64_t key = 0;
+    if (!AWSKinesisReadVarint(p, end, &key)) {
+        return NO;
+    }
+    *field = key >> 3;
+    *bytes = NULL;
+    *length = 0;
+    switch (key & 0x7) {
+        case 0:
+            return AWSKinesisReadVarint(p, end, varint);
+        case 1:
+            if (end - *p < 8) {
+                return NO;
+            }
+            *p += 8;
+            return YES;
+        case 2:
+            if (!AWSKinesisReadVarint(p, end, length) || *length > (uint64_t)(end - *p)) {
+                return NO;
+            }
+            *bytes = *p;
+            *p += *length;
+            return YES;
+        case 5:
+            if (end - *p < 4) {
+                return NO;
+            }
+            *p += 4;
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+@interface AWSKinesisRecordAggregator()
+
+@property (nonatomic, strong) NSMutableArray<NSData *> *partitionKeys;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *partitionKeyIndexes;
+@property (nonatomic, strong) NSMutableArray<NSData *> *records;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *recordPartitionKeyIndexes;
+@property (nonatomic, strong) NSString *firstPartitionKey;
+@property (nonatomic, assign) NSUInteger messageByteCount;
+
+@end
+
+@implementation AWSKinesisRecordAggregator
+
+- (instancetype)init {
+    return [self initWithMaximumByteCount:AWSKinesisRecordAggregatorMaximumByteCountDefault];
+}
+
+- (instancetype)initWithMaximumByteCount:(NSUInteger)maximumByteCount {
+    if (self = [super init]) {
+        _maximumByteCount = maximumByteCount;
+        _partitionKeys = [NSMutableArray new];
+        _partitionKeyIndexes = [NSMutableDictionary new];
+        _records = [NSMutableArray new];
+        _recordPartitionKeyIndexes = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSUInteger)recordCount {
+    return [self.records count];
+}
+
+- (NSUInteger)byteCount {
+    if ([self.records count] == 1) {
+        return [self.records[0] length] + [self.partitionKeys[0] length];
+    }
+    return [self aggregatedByteCountForMessageByteCount:self.messageByteCount];
+}
+
+- (NSUInteger)aggregatedByteCountForMessageByteCount:(NSUInteger)messageByteCount {
+    if (messageByteCount == 0) {
+        return 0;
+    }
+    return sizeof(AWSKinesisAggregatedRecordMagic) + messageByteCount + CC_MD5_DIGEST_LENGTH
+    + [self.partitionKeys[0] length];
+}
+
+- (BOOL)addRecordWithData:(NSData *)data partitionKey:(NSString *)partitionKey {
+    NSNumber *partitionKeyIndex = self.partitionKeyIndexes[partitionKey];
+    NSData *partitionKeyData = nil;
+    NSUInteger messageByteCount = self.messageByteCount;
+    if (!partitionKeyIndex) {
+        partitionKeyIndex = @([self.partitionKeys count]);
+        partitionKeyData = [partitionKey dataUsingEncoding:NSUTF8StringEncoding];
+        messageByteCount += AWSKinesisFieldSize([partitionKeyData length]);
+    }
+    NSUInteger recordByteCount = 1 + AWSKinesisVarintSize([partitionKeyIndex unsignedLongLongValue])
+    + AWSKinesisFieldSize([data length]);
+    messageByteCount += AWSKinesisFieldSize(recordByteCount);
+
+    if ([self.records count] > 0
+        && [self aggregatedByteCountForMessageByteCount:messageByteCount] > self.maximumByteCount) {
+        return NO;
+    }
+
+    if (partitionKeyData) {
+        [self.partitionKeys addObject:partitionKeyData];
+        self.partitionKeyIndexes[partitionKey] = partitionKeyIndex;
+    }
+    if (!self.firstPartitionKey) {
+        self.firstPartitionKey = partitionKey;
+    }
+    [self.records addObject:data];
+    [self.recordPartitionKeyIndexes addObject:partitionKeyIndex];
+    self.messageByteCount = messageByteCount;
+    return YES;
+}
+
+- (AWSKinesisPutRecordsRequestEntry *)requestEntry {
+    NSUInteger recordCount = [self.records count];
+    if (recordCount == 0) {
+        return nil;
+    }
+
+    AWSKinesisPutRecordsRequestEntry *requestEntry = [AWSKinesisPutRecordsRequestEntry new];
+    requestEntry.partitionKey = self.firstPartitionKey;
+    if (recordCount == 1) {
+        requestEntry.data = self.records[0];
+        return requestEntry;
+    }
+
+    NSUInteger messageByteCount = self.messageByteCount;
+    NSMutableData *data = [NSMutableData dataWithLength:sizeof(AWSKinesisAggregatedRecordMagic) + messageByteCount + CC_MD5_DIGEST_LENGTH];
+    uint8_t *message = (uint8_t *)[data mutableBytes] + sizeof(AWSKinesisAggregatedRecordMagic);
+    memcpy([data mutableBytes], AWSKinesisAggregatedRecordMagic, sizeof(AWSKinesisAggregatedRecordMagic));
+
+    uint8_t *p = message;
+    for (NSData *partitionKey in self.partitionKeys) {
+        p = AWSKinesisWriteField(p, AWSKinesisAggregatedRecordPartitionKeyKey, [partitionKey bytes], [partitionKey length]);
+    }
+    for (NSUInteger i = 0; i < recordCount; i++) {
+        NSData *recordData = self.records[i];
+        uint64_t partitionKeyIndex = [self.recordPartitionKeyIndexes[i] unsignedLongLongValue];
+        NSUInteger recordByteCount = 1 + AWSKinesisVarintSize(partitionKeyIndex) + AWSKinesisFieldSize([recordData length]);
+
+        *p++ = AWSKinesisAggregatedRecordRecordKey;
+        p = AWSKinesisWriteVarint(p, recordByteCount);
+        *p++ = AWSKinesisRecordPartitionKeyIndexKey;
+        p = AWSKinesisWriteVarint(p, partitionKeyIndex);
+        p = AWSKinesisWriteField(p, AWSKinesisRecordDataKey, [recordData bytes], [recordData length]);
+    }
+    NSAssert(p == message + messageByteCount, @"The aggregated record size was miscounted.");
+    CC_MD5(message, (CC_LONG)messageByteCount, p);
+
+    requestEntry.data = data;
+    return requestEntry;
+}
+
+- (void)reset {
+    [self.partitionKeys removeAllObjects];
+    [self.partitionKeyIndexes removeAllObjects];
+    [self.records removeAllObjects];
+    [self.recordPartitionKeyIndexes removeAllObjects];
+    self.firstPartitionKey = nil;
+    self.messageByteCount = 0;
+}
+
++ (BOOL)isAggregatedData:(NSData *)data {
+    NSUInteger length = [data length];
+    if (length < sizeof(AWSKinesisAggregatedRecordMagic) + CC_MD5_DIGEST_LENGTH) {
+        return NO;
+    }
+    const uint8_t *bytes = [data bytes];
+    if (memcmp(bytes, AWSKinesisAggregatedRecordMagic, sizeof(AWSKinesisAggregatedRecordMagic)) != 0) {
+        return NO;
+    }
+    const uint8_t *message = bytes + sizeof(AWSKinesisAggregatedRecordMagic);
+    CC_LONG messageLength = (CC_LONG)(length - sizeof(AWSKinesisAggregatedRecordMagic) - CC_MD5_DIGEST_LENGTH);
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5(message, messageLength, digest);
+    return memcmp(digest, message + messageLength, CC_MD5_DIGEST_LENGTH) == 0;
+}
+
++ (NSArray<AWSKinesisPutRecordsRequestEntry *> *)requestEntriesFromAggregatedData:(NSData *)data {
+    if (![self isAggregatedData:data]) {
+        return nil;
+    }
+
+    const uint8_t *p = (const uint8_t *)[data bytes] + sizeof(AWSKinesisAggregatedRecordMagic);
+    const uint8_t *end = (const uint8_t *)[data bytes] + [data length] - CC_MD5_DIGEST_LENGTH;
+    NSMutableArray<NSString *> *partitionKeys = [NSMutableArray new];
+    NSMutableArray<NSString *> *explicitHashKeys = [NSMutableArray new];
+    NSMutableArray<NSData *> *records = [NSMutableArray new];
+
+    while (p < end) {
+        uint64_t field = 0, length = 0, varint = 0;
+        const uint8_t *bytes = NULL;
+        if (!AWSKinesisReadField(&p, end, &field, &bytes, &length, &varint)) {
+            return nil;
+        }
+        if (!bytes) {
+            continue;
+        }
+        if (field == 1 || field == 2) {
+            NSString *key = [[NSString alloc] initWithBytes:bytes length:(NSUInteger)length encoding:NSUTF8StringEncoding];
+            if (!key) {
+                return nil;
+            }
+            [(field == 1 ? partitionKeys : explicitHashKeys) addObject:key];
+        } else if (field == 3) {
+            [records addObject:[NSData dataWithBytesNoCopy:(void *)bytes length:(NSUInteger)length freeWhenDone:NO]];
+        }
+    }
+
+    NSMutableArray<AWSKinesisPutRecordsRequestEntry *> *requestEntries = [NSMutableArray arrayWithCapacity:[records count]];
+    for (NSData *record in records) {
+        const uint8_t *rp = [record bytes];
+        const uint8_t *rend = rp + [record length];
+        uint64_t partitionKeyIndex = UINT64_MAX, explicitHashKeyIndex = UINT64_MAX;
+        NSData *recordData = nil;
+        while (rp < rend) {
+            uint64_t field = 0, length = 0, varint = 0;
+            const uint8_t *bytes = NULL;
+            if (!AWSKinesisReadField(&rp, rend, &field, &bytes, &length, &varint)) {
+                return nil;
+            }
+            if (field == 1 && !bytes) {
+                partitionKeyIndex = varint;
+            } else if (field == 2 && !bytes) {
+                explicitHashKeyIndex = varint;
+            } else if (field == 3 && bytes) {
+                recordData = [NSData dataWithBytes:bytes length:(NSUInteger)length];
+            }
+        }
+        if (!recordData || partitionKeyIndex >= [partitionKeys count]) {
+            return nil;
+        }
+
+        AWSKinesisPutRecordsRequestEntry *requestEntry = [AWSKinesisPutRecordsRequestEntry new];
+        requestEntry.partitionKey = partitionKeys[(NSUInteger)partitionKeyIndex];
+        requestEntry.data = recordData;
+        if (explicitHashKeyIndex < [explicitHashKeys count]) {
+            requestEntry.explicitHashKey = explicitHashKeys[(NSUInteger)explicitHashKeyIndex];
+        }
+        [requestEntries addObject:requestEntry];
+    }
+    return requestEntries;
+}
+
+@end
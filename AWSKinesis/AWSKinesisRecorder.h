@@ -43,6 +43,12 @@ FOUNDATION_EXPORT NSString *const AWSKinesisRecorderByteThresholdReachedNotifica
  */
 @interface AWSKinesisRecorder : AWSAbstractKinesisRecorder
 
+/**
+ Whether saved records are packed into aggregated Kinesis records when they are submitted. Records of a stream are sent together in records of up to 1MB in the aggregated record format of the Kinesis Producer Library, which uses fewer Kinesis records and less of a shard's throughput for small records. The default is `NO`.
+ @discussion Consumers need the Kinesis Client Library, or a deaggregation module, to read the records back. See `AWSKinesisRecordAggregator`.
+ */
+@property (nonatomic, assign) BOOL aggregatesRecords;
+
 /**
  Returns a shared instance of this service client using `[AWSServiceManager defaultServiceManager].defaultServiceConfiguration`. When `defaultServiceConfiguration` is not set, this method returns nil.
 
@@ -26,6 +26,10 @@ static NSString *const AWSInfoKinesisRecorder = @"KinesisRecorder";
 // Legacy constants
 NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorderCacheName.Cache";
 
+// Up to this many records are read for each batch when they are aggregated. They are still bounded by `batchRecordsByteLimit`.
+static NSUInteger const AWSKinesisRecorderAggregatedBatchRecordCountLimit = 1000;
+static NSUInteger const AWSKinesisRecorderBatchRecordCountLimit = 128;
+
 @protocol AWSKinesisRecorderHelper <NSObject>
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration;
@@ -35,12 +39,14 @@ NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorder
 @interface AWSKinesisRecorderHelper : NSObject <AWSKinesisRecorderHelper>
 
 @property (nonatomic, strong) AWSKinesis *kinesis;
+@property (atomic, assign) BOOL aggregatesRecords;
 
 @end
 
 @interface AWSAbstractKinesisRecorder()
 
 @property (nonatomic, strong) id<AWSKinesisRecorderHelper> recorderHelper;
+@property (nonatomic, assign) NSUInteger batchRecordsCountLimit;
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
@@ -144,6 +150,15 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     return self;
 }
 
+- (BOOL)aggregatesRecords {
+    return ((AWSKinesisRecorderHelper *)self.recorderHelper).aggregatesRecords;
+}
+
+- (void)setAggregatesRecords:(BOOL)aggregatesRecords {
+    ((AWSKinesisRecorderHelper *)self.recorderHelper).aggregatesRecords = aggregatesRecords;
+    self.batchRecordsCountLimit = aggregatesRecords ? AWSKinesisRecorderAggregatedBatchRecordCountLimit : AWSKinesisRecorderBatchRecordCountLimit;
+}
+
 @end
 
 @implementation AWSKinesisRecorderHelper
@@ -163,14 +178,39 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
                         retryRowIds:(NSMutableArray *)retryRowIds
                                stop:(BOOL *)stop {
     NSMutableArray *records = [NSMutableArray new];
-
-    for (NSDictionary *recordDictionary in temporaryRecords) {
-        AWSKinesisPutRecordsRequestEntry *requestEntry = [AWSKinesisPutRecordsRequestEntry new];
-        requestEntry.partitionKey = recordDictionary[@"partition_key"];
-        requestEntry.data = recordDictionary[@"data"];
-        streamName = recordDictionary[@"stream_name"];
-
-        [records addObject:requestEntry];
+    // The row ids sent in each request entry.
+    NSMutableArray<NSArray *> *entryRowIds = [NSMutableArray new];
+
+    if (self.aggregatesRecords) {
+        AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+        NSUInteger firstIndex = 0;
+        for (NSUInteger i = 0; i <= [temporaryRecords count]; i++) {
+            NSDictionary *recordDictionary = i < [temporaryRecords count] ? temporaryRecords[i] : nil;
+            if (recordDictionary
+                && [aggregator addRecordWithData:recordDictionary[@"data"] partitionKey:recordDictionary[@"partition_key"]]) {
+                streamName = recordDictionary[@"stream_name"];
+                continue;
+            }
+            // The aggregated record is full, or every record has been added.
+            [records addObject:[aggregator requestEntry]];
+            [entryRowIds addObject:[rowIds subarrayWithRange:NSMakeRange(firstIndex, i - firstIndex)]];
+            [aggregator reset];
+            firstIndex = i;
+            if (recordDictionary) {
+                [aggregator addRecordWithData:recordDictionary[@"data"] partitionKey:recordDictionary[@"partition_key"]];
+            }
+        }
+    } else {
+        for (NSUInteger i = 0; i < [temporaryRecords count]; i++) {
+            NSDictionary *recordDictionary = temporaryRecords[i];
+            AWSKinesisPutRecordsRequestEntry *requestEntry = [AWSKinesisPutRecordsRequestEntry new];
+            requestEntry.partitionKey = recordDictionary[@"partition_key"];
+            requestEntry.data = recordDictionary[@"data"];
+            streamName = recordDictionary[@"stream_name"];
+
+            [records addObject:requestEntry];
+            [entryRowIds addObject:@[rowIds[i]]];
+        }
     }
 
     AWSKinesisPutRecordsInput *putRecordsInput = [AWSKinesisPutRecordsInput new];
@@ -198,9 +238,9 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
                 // we should retry. So, don't delete the row from the database.
                 if (![resultEntry.errorCode isEqualToString:@"ProvisionedThroughputExceededException"]
                     && ![resultEntry.errorCode isEqualToString:@"InternalFailure"]) {
-                    [putRowIds addObject:rowIds[i]];
+                    [putRowIds addObjectsFromArray:entryRowIds[i]];
                 } else {
-                    [retryRowIds addObject:rowIds[i]];
+                    [retryRowIds addObjectsFromArray:entryRowIds[i]];
                 }
             }
         }
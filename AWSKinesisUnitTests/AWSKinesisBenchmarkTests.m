@@ -0,0 +1,118 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSKinesis.h"
+#import "AWSBenchmark.h"
+#import "TestHTTPServer.h"
+
+static NSString *const AWSKinesisBenchmarkTestsKey = @"AWSKinesisBenchmarkTests";
+static const NSUInteger AWSKinesisBenchmarkRecordsPerRequest = 100;
+static const NSUInteger AWSKinesisBenchmarkRecordSize = 1024;
+static const NSUInteger AWSKinesisBenchmarkWarmUpCount = 10;
+static const NSUInteger AWSKinesisBenchmarkOperationCount = 200;
+
+@interface AWSKinesisBenchmarkTests : XCTestCase
+
+@property (nonatomic, strong) TestHTTPServer *server;
+@property (nonatomic, strong) AWSKinesis *kinesis;
+
+@end
+
+@implementation AWSKinesisBenchmarkTests
+
++ (XCTestSuite *)defaultTestSuite {
+    // Benchmarks are opt-in; see AWSBenchmark.
+    return [AWSBenchmark isEnabled] ? [super defaultTestSuite] : [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+}
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestHTTPServer new];
+    XCTAssertTrue([self.server start]);
+    self.server.requestHandler = ^TestHTTPServerResponse *(TestHTTPServerRequest *request) {
+        return [AWSKinesisBenchmarkTests responseToPutRecordsRequest:request];
+    };
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceKinesis
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSKinesis registerKinesisWithConfiguration:configuration forKey:AWSKinesisBenchmarkTestsKey];
+    self.kinesis = [AWSKinesis KinesisForKey:AWSKinesisBenchmarkTestsKey];
+}
+
+- (void)tearDown {
+    [AWSKinesis removeKinesisForKey:AWSKinesisBenchmarkTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+// Accepts every record of a PutRecords request, the way Kinesis does.
++ (TestHTTPServerResponse *)responseToPutRecordsRequest:(TestHTTPServerRequest *)request {
+    NSDictionary *input = [NSJSONSerialization JSONObjectWithData:request.body options:0 error:nil];
+    if (![request.headers[@"x-amz-target"] isEqualToString:@"Kinesis_20131202.PutRecords"] || !input[@"Records"]) {
+        return [TestHTTPServerResponse responseWithStatusCode:400 headers:nil body:nil];
+    }
+
+    NSMutableArray<NSDictionary *> *records = [NSMutableArray new];
+    for (NSUInteger i = 0; i < [input[@"Records"] count]; i++) {
+        [records addObject:@{@"SequenceNumber" : [NSString stringWithFormat:@"4958947328492547281904849183%020lu", (unsigned long)i],
+                             @"ShardId" : @"shardId-000000000000"}];
+    }
+    NSData *body = [NSJSONSerialization dataWithJSONObject:@{@"FailedRecordCount" : @0,
+                                                             @"Records" : records}
+                                                   options:0
+                                                     error:nil];
+    return [TestHTTPServerResponse responseWithStatusCode:200
+                                                  headers:@{@"Content-Type" : @"application/x-amz-json-1.1"}
+                                                     body:body];
+}
+
+- (void)testPutRecordsBenchmark {
+    NSMutableArray<AWSKinesisPutRecordsRequestEntry *> *entries = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSKinesisBenchmarkRecordsPerRequest; i++) {
+        NSMutableData *data = [NSMutableData dataWithLength:AWSKinesisBenchmarkRecordSize];
+        arc4random_buf(data.mutableBytes, data.length);
+        AWSKinesisPutRecordsRequestEntry *entry = [AWSKinesisPutRecordsRequestEntry new];
+        entry.data = data;
+        entry.partitionKey = [NSString stringWithFormat:@"partition-%lu", (unsigned long)i];
+        [entries addObject:entry];
+    }
+
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"KinesisPutRecords"
+                                                     warmUpCount:AWSKinesisBenchmarkWarmUpCount
+                                                  operationCount:AWSKinesisBenchmarkOperationCount
+                                                       operation:^BOOL(NSUInteger index) {
+        AWSKinesisPutRecordsInput *input = [AWSKinesisPutRecordsInput new];
+        input.streamName = @"benchmark";
+        input.records = entries;
+        AWSTask<AWSKinesisPutRecordsOutput *> *task = [self.kinesis putRecords:input];
+        [task waitUntilFinished];
+        return !task.error
+        && [task.result.failedRecordCount integerValue] == 0
+        && [task.result.records count] == AWSKinesisBenchmarkRecordsPerRequest;
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+@end
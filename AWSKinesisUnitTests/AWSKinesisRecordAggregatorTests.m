@@ -0,0 +1,258 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSKinesis.h"
+
+static const NSUInteger AWSKinesisRecordAggregatorTestsBenchmarkRecordCount = 1000;
+
+@interface AWSAbstractKinesisRecorder()
+
+@property (nonatomic, strong) AWSDurableQueue *queue;
+
+- (void)moveRecordsFromRecordTable;
+
+@end
+
+@interface AWSKinesisRecordAggregatorTests : XCTestCase
+
+@end
+
+@implementation AWSKinesisRecordAggregatorTests
+
+// A small analytics event, the kind of record the recorders are usually given.
+- (NSData *)eventDataAtIndex:(NSUInteger)index {
+    NSString *event = [NSString stringWithFormat:@"{\"event_type\":\"screen_view\",\"session_id\":\"%@\","
+                       @"\"timestamp\":%lu,\"attributes\":{\"screen\":\"Settings\",\"index\":%lu,"
+                       @"\"platform\":\"iOS\",\"app_version\":\"2.24.0\"}}",
+                       @"8C1B6C2A-3F25-4E6F-9C1D-2B7E0C4F1A33", (unsigned long)(1600000000 + index), (unsigned long)index];
+    return [event dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)testAggregatedDataMatchesTheKinesisProducerLibraryFormat {
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    XCTAssertTrue([aggregator addRecordWithData:[@"a" dataUsingEncoding:NSUTF8StringEncoding] partitionKey:@"k1"]);
+    XCTAssertTrue([aggregator addRecordWithData:[@"b" dataUsingEncoding:NSUTF8StringEncoding] partitionKey:@"k2"]);
+    XCTAssertTrue([aggregator addRecordWithData:[@"c" dataUsingEncoding:NSUTF8StringEncoding] partitionKey:@"k1"]);
+
+    const uint8_t message[] = {
+        0x0A, 0x02, 'k', '1',                          // partition_key_table
+        0x0A, 0x02, 'k', '2',
+        0x1A, 0x05, 0x08, 0x00, 0x1A, 0x01, 'a',       // records
+        0x1A, 0x05, 0x08, 0x01, 0x1A, 0x01, 'b',
+        0x1A, 0x05, 0x08, 0x00, 0x1A, 0x01, 'c',
+    };
+    const uint8_t magic[] = {0xF3, 0x89, 0x9A, 0xC2};
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5(message, sizeof(message), digest);
+    NSMutableData *expected = [NSMutableData dataWithBytes:magic length:sizeof(magic)];
+    [expected appendBytes:message length:sizeof(message)];
+    [expected appendBytes:digest length:sizeof(digest)];
+
+    AWSKinesisPutRecordsRequestEntry *requestEntry = [aggregator requestEntry];
+    XCTAssertEqualObjects(requestEntry.partitionKey, @"k1");
+    XCTAssertEqualObjects(requestEntry.data, expected);
+    XCTAssertEqual(aggregator.byteCount, [expected length] + 2);
+    XCTAssertTrue([AWSKinesisRecordAggregator isAggregatedData:requestEntry.data]);
+}
+
+- (void)testRecordsRoundTrip {
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    NSMutableArray<NSData *> *records = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 200; i++) {
+        NSData *data = [self eventDataAtIndex:i];
+        [records addObject:data];
+        XCTAssertTrue([aggregator addRecordWithData:data partitionKey:[NSString stringWithFormat:@"key-%lu", (unsigned long)(i % 7)]]);
+    }
+    XCTAssertEqual(aggregator.recordCount, 200);
+
+    NSArray<AWSKinesisPutRecordsRequestEntry *> *requestEntries = [AWSKinesisRecordAggregator requestEntriesFromAggregatedData:[aggregator requestEntry].data];
+    XCTAssertEqual([requestEntries count], 200);
+    for (NSUInteger i = 0; i < 200; i++) {
+        XCTAssertEqualObjects(requestEntries[i].data, records[i]);
+        XCTAssertEqualObjects(requestEntries[i].partitionKey, ([NSString stringWithFormat:@"key-%lu", (unsigned long)(i % 7)]));
+        XCTAssertNil(requestEntries[i].explicitHashKey);
+    }
+}
+
+- (void)testSingleRecordIsNotAggregated {
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    XCTAssertNil([aggregator requestEntry]);
+    XCTAssertEqual(aggregator.byteCount, 0);
+
+    NSData *data = [self eventDataAtIndex:0];
+    XCTAssertTrue([aggregator addRecordWithData:data partitionKey:@"key"]);
+    AWSKinesisPutRecordsRequestEntry *requestEntry = [aggregator requestEntry];
+    XCTAssertEqualObjects(requestEntry.data, data);
+    XCTAssertEqualObjects(requestEntry.partitionKey, @"key");
+    XCTAssertEqual(aggregator.byteCount, [data length] + 3);
+    XCTAssertFalse([AWSKinesisRecordAggregator isAggregatedData:data]);
+    XCTAssertNil([AWSKinesisRecordAggregator requestEntriesFromAggregatedData:data]);
+}
+
+- (void)testAggregatedRecordsStayUnderTheMaximumByteCount {
+    AWSKinesisRecordAggregator *aggregator = [[AWSKinesisRecordAggregator alloc] initWithMaximumByteCount:1000];
+    NSData *data = [NSMutableData dataWithLength:100];
+    NSUInteger added = 0;
+    while ([aggregator addRecordWithData:data partitionKey:@"key"]) {
+        added++;
+        XCTAssertLessThanOrEqual(aggregator.byteCount, 1000);
+    }
+    XCTAssertGreaterThan(added, 1);
+    XCTAssertEqual(aggregator.recordCount, added);
+
+    AWSKinesisPutRecordsRequestEntry *requestEntry = [aggregator requestEntry];
+    XCTAssertEqual([requestEntry.data length] + 3, aggregator.byteCount);
+
+    [aggregator reset];
+    XCTAssertEqual(aggregator.recordCount, 0);
+    XCTAssertEqual(aggregator.byteCount, 0);
+    // The first record is always added, even when it is too large.
+    XCTAssertTrue([aggregator addRecordWithData:[NSMutableData dataWithLength:2000] partitionKey:@"key"]);
+}
+
+- (void)testMalformedAggregatedDataIsRejected {
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    [aggregator addRecordWithData:[self eventDataAtIndex:0] partitionKey:@"key"];
+    [aggregator addRecordWithData:[self eventDataAtIndex:1] partitionKey:@"key"];
+    NSData *aggregatedData = [aggregator requestEntry].data;
+
+    NSMutableData *corrupted = [aggregatedData mutableCopy];
+    ((uint8_t *)[corrupted mutableBytes])[10] ^= 0xFF;
+    XCTAssertFalse([AWSKinesisRecordAggregator isAggregatedData:corrupted]);
+    XCTAssertNil([AWSKinesisRecordAggregator requestEntriesFromAggregatedData:corrupted]);
+
+    NSData *truncated = [aggregatedData subdataWithRange:NSMakeRange(0, [aggregatedData length] - 1)];
+    XCTAssertNil([AWSKinesisRecordAggregator requestEntriesFromAggregatedData:truncated]);
+}
+
+- (void)testCompressedRecordsUseLessDisk {
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:nil];
+    NSString *key = @"testCompressedRecordsUseLessDisk";
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:configuration forKey:key];
+    AWSKinesisRecorder *recorder = [AWSKinesisRecorder KinesisRecorderForKey:key];
+    [[recorder removeAllRecords] waitUntilFinished];
+
+    NSData *data = [[NSMutableData dataWithLength:4096] copy];
+    [[recorder saveRecord:data streamName:@"stream" partitionKey:@"key"] waitUntilFinished];
+    NSUInteger uncompressedBytesUsed = recorder.diskBytesUsed;
+
+    recorder.compressesRecords = YES;
+    [[recorder saveRecord:data streamName:@"stream" partitionKey:@"key"] waitUntilFinished];
+    NSUInteger compressedBytesUsed = recorder.diskBytesUsed - uncompressedBytesUsed;
+    XCTAssertLessThan(compressedBytesUsed, uncompressedBytesUsed / 10);
+
+    [[recorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:key];
+}
+
+- (void)testMoveRecordsFromRecordTable {
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:nil];
+    NSString *key = @"testMoveRecordsFromRecordTable";
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:configuration forKey:key];
+    AWSKinesisRecorder *recorder = [AWSKinesisRecorder KinesisRecorderForKey:key];
+    [[recorder removeAllRecords] waitUntilFinished];
+
+    // Recreates the table an earlier version of the SDK saved records in.
+    NSTimeInterval timestamp = [[NSDate date] timeIntervalSince1970];
+    [recorder.queue.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:
+                       @"CREATE TABLE record ("
+                       @"partition_key TEXT NOT NULL,"
+                       @"stream_name TEXT NOT NULL,"
+                       @"data BLOB NOT NULL,"
+                       @"timestamp REAL NOT NULL,"
+                       @"retry_count INTEGER NOT NULL)"]);
+        for (NSUInteger i = 0; i < 3; i++) {
+            XCTAssertTrue(([db executeUpdate:@"INSERT INTO record (partition_key, stream_name, data, timestamp, retry_count) VALUES (?, ?, ?, ?, ?)",
+                            [NSString stringWithFormat:@"key-%lu", (unsigned long)i], i == 2 ? @"other-stream" : @"stream",
+                            [self eventDataAtIndex:i], @(timestamp + i), @(i)]));
+        }
+    }];
+
+    [recorder moveRecordsFromRecordTable];
+
+    [recorder.queue.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertFalse([db tableExists:@"record"]);
+    }];
+    NSArray<AWSDurableQueueRecord *> *records = [recorder.queue oldestRecordsInChannel:@"stream" limit:10 byteLimit:0 error:nil];
+    XCTAssertEqual([records count], 2);
+    for (NSUInteger i = 0; i < [records count]; i++) {
+        XCTAssertEqualObjects(records[i].key, ([NSString stringWithFormat:@"key-%lu", (unsigned long)i]));
+        XCTAssertEqualObjects(records[i].data, [self eventDataAtIndex:i]);
+        XCTAssertEqual(records[i].retryCount, i);
+    }
+    records = [recorder.queue oldestRecordsInChannel:@"other-stream" limit:10 byteLimit:0 error:nil];
+    XCTAssertEqual([records count], 1);
+    XCTAssertEqualObjects(records.firstObject.key, @"key-2");
+
+    [[recorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:key];
+}
+
+#pragma mark - Performance
+
+- (void)testCompressionRatio {
+    NSUInteger rawByteCount = 0;
+    NSUInteger compressedByteCount = 0;
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    for (NSUInteger i = 0; i < AWSKinesisRecordAggregatorTestsBenchmarkRecordCount; i++) {
+        NSData *data = [self eventDataAtIndex:i];
+        rawByteCount += [data length];
+        compressedByteCount += MIN([[data awsgzip_gzippedData] length], [data length]);
+        [aggregator addRecordWithData:data partitionKey:[NSUUID UUID].UUIDString];
+    }
+    // Requests are sent with `Content-Encoding: gzip`, so an aggregated batch is compressed as a whole.
+    NSUInteger aggregatedCompressedByteCount = [[[aggregator requestEntry].data awsgzip_gzippedData] length];
+
+    // Small records repeat too little of themselves to compress well on their own, while the batch shares its
+    // field names and values across records.
+    double storedRatio = (double)compressedByteCount / rawByteCount;
+    double sentRatio = (double)aggregatedCompressedByteCount / rawByteCount;
+    XCTAssertLessThan(storedRatio, 1.0);
+    XCTAssertLessThan(sentRatio, 0.25);
+    XCTAssertLessThan(sentRatio, storedRatio / 2);
+}
+
+- (void)testPerformanceCompressRecords {
+    NSMutableArray<NSData *> *records = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSKinesisRecordAggregatorTestsBenchmarkRecordCount; i++) {
+        [records addObject:[self eventDataAtIndex:i]];
+    }
+    [self measureBlock:^{
+        for (NSData *data in records) {
+            [[data awsgzip_gzippedData] awsgzip_gunzippedData];
+        }
+    }];
+}
+
+- (void)testPerformanceAggregateRecords {
+    NSMutableArray<NSData *> *records = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSKinesisRecordAggregatorTestsBenchmarkRecordCount; i++) {
+        [records addObject:[self eventDataAtIndex:i]];
+    }
+    [self measureBlock:^{
+        AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+        for (NSData *data in records) {
+            [aggregator addRecordWithData:data partitionKey:@"key"];
+        }
+        [AWSKinesisRecordAggregator requestEntriesFromAggregatedData:[aggregator requestEntry].data];
+    }];
+}
+
+@end
@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A fixed-capacity, lock-free ring buffer of audio bytes with exactly one producer thread and one consumer thread.
+
+ Frames are written whole or not at all, so an encoded frame (e.g. Opus) is never split by an overrun. When a frame
+ does not fit, the write is rejected and counted; the producer decides whether to drop it or retry later.
+ */
+@interface AWSLexAudioRingBuffer : NSObject
+
+/// Usable capacity in bytes. Always a power of two, at least the capacity requested.
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/// Bytes currently waiting to be consumed.
+@property (nonatomic, readonly) NSUInteger readableLength;
+
+/// Number of frames rejected because the buffer was full.
+@property (nonatomic, readonly) NSUInteger overrunCount;
+
+/// Total size of the frames rejected because the buffer was full.
+@property (nonatomic, readonly) NSUInteger droppedByteCount;
+
+/// Largest number of bytes ever waiting in the buffer.
+@property (nonatomic, readonly) NSUInteger highWaterMark;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/// Producer only. Appends a whole frame and returns YES, or returns NO and counts an overrun if it does not fit.
+- (BOOL)writeFrame:(const void *)bytes length:(NSUInteger)length;
+
+/// Consumer only. Returns the longest contiguous run of readable bytes without copying, and its length. The bytes stay
+/// valid until they are released with `consumeLength:`.
+- (nullable const uint8_t *)readableBytesWithLength:(NSUInteger *)length;
+
+/// Consumer only. Releases `length` bytes previously returned by `readableBytesWithLength:`.
+- (void)consumeLength:(NSUInteger)length;
+
+/// Consumer only. Copies up to `maxLength` bytes into `buffer` and returns the number of bytes copied.
+- (NSUInteger)readBytes:(void *)buffer maxLength:(NSUInteger)maxLength;
+
+/// Consumer only. Writes readable bytes to `stream` without copying them and releases what was written, calling
+/// `didWrite` after each write that took bytes. Returns once the buffer is empty or the stream takes no more bytes. A
+/// stream without space available stops the writes, unless `waitForSpace` is YES, in which case they block until the
+/// stream is read. Returns NO if a write failed.
+- (BOOL)writeToStream:(NSOutputStream *)stream
+         waitForSpace:(BOOL)waitForSpace
+             didWrite:(nullable void (^)(NSUInteger length))didWrite;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,158 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSLexAudioRingBuffer.h"
+#import <stdatomic.h>
+
+@implementation AWSLexAudioRingBuffer {
+    uint8_t *_bytes;
+    NSUInteger _mask;
+    // Free-running byte counters. The producer owns _writeIndex and the consumer owns _readIndex; each only reads the
+    // other's counter, so a release store paired with an acquire load is all the synchronization needed.
+    _Atomic(NSUInteger) _writeIndex;
+    _Atomic(NSUInteger) _readIndex;
+    _Atomic(NSUInteger) _overrunCount;
+    _Atomic(NSUInteger) _droppedByteCount;
+    _Atomic(NSUInteger) _highWaterMark;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        NSUInteger roundedCapacity = 1;
+        while (roundedCapacity < capacity) {
+            roundedCapacity <<= 1;
+        }
+        _capacity = roundedCapacity;
+        _mask = roundedCapacity - 1;
+        _bytes = malloc(roundedCapacity);
+        if (!_bytes) {
+            return nil;
+        }
+        atomic_init(&_writeIndex, 0);
+        atomic_init(&_readIndex, 0);
+        atomic_init(&_overrunCount, 0);
+        atomic_init(&_droppedByteCount, 0);
+        atomic_init(&_highWaterMark, 0);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_bytes);
+}
+
+- (NSUInteger)readableLength {
+    return atomic_load_explicit(&_writeIndex, memory_order_acquire) - atomic_load_explicit(&_readIndex, memory_order_acquire);
+}
+
+- (NSUInteger)overrunCount {
+    return atomic_load_explicit(&_overrunCount, memory_order_relaxed);
+}
+
+- (NSUInteger)droppedByteCount {
+    return atomic_load_explicit(&_droppedByteCount, memory_order_relaxed);
+}
+
+- (NSUInteger)highWaterMark {
+    return atomic_load_explicit(&_highWaterMark, memory_order_relaxed);
+}
+
+- (BOOL)writeFrame:(const void *)bytes length:(NSUInteger)length {
+    NSUInteger writeIndex = atomic_load_explicit(&_writeIndex, memory_order_relaxed);
+    NSUInteger readIndex = atomic_load_explicit(&_readIndex, memory_order_acquire);
+    NSUInteger used = writeIndex - readIndex;
+
+    if (length > _capacity - used) {
+        atomic_fetch_add_explicit(&_overrunCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&_droppedByteCount, length, memory_order_relaxed);
+        return NO;
+    }
+    if (length == 0) {
+        return YES;
+    }
+
+    NSUInteger offset = writeIndex & _mask;
+    NSUInteger firstLength = MIN(length, _capacity - offset);
+    memcpy(_bytes + offset, bytes, firstLength);
+    if (firstLength < length) {
+        memcpy(_bytes, (const uint8_t *)bytes + firstLength, length - firstLength);
+    }
+    atomic_store_explicit(&_writeIndex, writeIndex + length, memory_order_release);
+
+    if (used + length > atomic_load_explicit(&_highWaterMark, memory_order_relaxed)) {
+        atomic_store_explicit(&_highWaterMark, used + length, memory_order_relaxed);
+    }
+    return YES;
+}
+
+- (const uint8_t *)readableBytesWithLength:(NSUInteger *)length {
+    NSUInteger readIndex = atomic_load_explicit(&_readIndex, memory_order_relaxed);
+    NSUInteger writeIndex = atomic_load_explicit(&_writeIndex, memory_order_acquire);
+    NSUInteger readable = writeIndex - readIndex;
+    if (readable == 0) {
+        *length = 0;
+        return NULL;
+    }
+
+    NSUInteger offset = readIndex & _mask;
+    *length = MIN(readable, _capacity - offset);
+    return _bytes + offset;
+}
+
+- (void)consumeLength:(NSUInteger)length {
+    NSUInteger readIndex = atomic_load_explicit(&_readIndex, memory_order_relaxed);
+    NSUInteger writeIndex = atomic_load_explicit(&_writeIndex, memory_order_acquire);
+    length = MIN(length, writeIndex - readIndex);
+    atomic_store_explicit(&_readIndex, readIndex + length, memory_order_release);
+}
+
+- (NSUInteger)readBytes:(void *)buffer maxLength:(NSUInteger)maxLength {
+    NSUInteger copied = 0;
+    while (copied < maxLength) {
+        NSUInteger length = 0;
+        const uint8_t *bytes = [self readableBytesWithLength:&length];
+        if (!bytes) {
+            break;
+        }
+        length = MIN(length, maxLength - copied);
+        memcpy((uint8_t *)buffer + copied, bytes, length);
+        [self consumeLength:length];
+        copied += length;
+    }
+    return copied;
+}
+
+- (BOOL)writeToStream:(NSOutputStream *)stream
+         waitForSpace:(BOOL)waitForSpace
+             didWrite:(void (^)(NSUInteger length))didWrite {
+    NSUInteger length = 0;
+    const uint8_t *bytes = NULL;
+    while ((bytes = [self readableBytesWithLength:&length]) && (waitForSpace || [stream hasSpaceAvailable])) {
+        NSInteger result = [stream write:bytes maxLength:length];
+        if (result < 0) {
+            return NO;
+        }
+        if (result == 0) {
+            break;
+        }
+        [self consumeLength:result];
+        if (didWrite) {
+            didWrite(result);
+        }
+    }
+    return YES;
+}
+
+@end
@@ -19,6 +19,7 @@
 #import "BFAudioRecorder.h"
 #import "AWSLex.h"
 #import "AWSLexRequestRetryHandler.h"
+#import "AWSLexAudioRingBuffer.h"
 #import <AVFoundation/AVFoundation.h>
 
 NSString *const AWSInfoInteractionKit = @"LexInteractionKit";
@@ -47,6 +48,12 @@ const NSUInteger DefaultInteractionKitStartingPointThreshold = 9;
 const NSUInteger DefaultInteractionKitEndpointThreshold = 80;
 const float      DefaultInteractionKitLrtThreshold = 1.8f;
 
+// Smallest capacity of the buffer holding audio that has not been written to the request stream yet, about two
+// seconds of 16 kHz 16 bit PCM.
+static const NSUInteger AWSLexInteractionKitMinimumPendingAudioCapacity = 64 * 1024;
+// The pending audio buffer holds at least this many of the audio source's buffers.
+static const NSUInteger AWSLexInteractionKitPendingAudioSourceBuffers = 16;
+
 typedef NS_ENUM(NSInteger, AWSLexSpeechState) {
     AWSLexSpeechStateUninitialized,
     AWSLexSpeechStateStarted,
@@ -246,6 +253,9 @@ const NSUInteger MaxSpeechTimeoutInterval = 15;
     //the processed audio buffer
     NSMutableData *producerAudioBuffer;
     NSOutputStream *producerStream;
+    //audio not yet written to the producer stream, filled on the audio source queue and drained on audioStreamingQueue
+    AWSLexAudioRingBuffer *pendingAudioBuffer;
+    dispatch_queue_t audioStreamingQueue;
     
     dispatch_queue_t interactionDelegateQueue;
     
@@ -333,6 +343,7 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         retryHandler.delegate = self;
         
         interactionDelegateQueue = dispatch_queue_create("com.amazonaws.lex.InteractionDelegateQueue", DISPATCH_QUEUE_SERIAL);
+        audioStreamingQueue = dispatch_queue_create("com.amazonaws.lex.AudioStreamingQueue", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
@@ -616,6 +627,8 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
         
         producerAudioBuffer = [NSMutableData new];
         consumerAudioBuffer = [NSMutableData new];
+        pendingAudioBuffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:MAX(AWSLexInteractionKitMinimumPendingAudioCapacity,
+                                                                                 [audioSource audioBufferSize] * AWSLexInteractionKitPendingAudioSourceBuffers)];
         
         producerStream.delegate = self;
         
@@ -636,29 +649,77 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     if (isListening) {
         AWSDDLogVerbose(@"Stop Listening",nil);
         isListening = NO;
-        [producerStream close];
         producerStream.delegate = nil;
         
+        // Close the stream behind the audio that is still waiting to be written. The writes block until the request
+        // reads the audio, so none of it is dropped.
+        NSOutputStream *stream = producerStream;
+        AWSLexAudioRingBuffer *buffer = pendingAudioBuffer;
+        __weak AWSLexInteractionKit *weakSelf = self;
+        dispatch_async(audioStreamingQueue, ^{
+            [weakSelf drainPendingAudio:buffer toStream:stream waitForSpace:YES];
+            [stream close];
+            if (buffer.overrunCount > 0) {
+                AWSDDLogWarn(@"Dropped %lu audio frames (%lu bytes) because the request stream fell behind the microphone",
+                             (unsigned long)buffer.overrunCount,
+                             (unsigned long)buffer.droppedByteCount);
+            }
+            AWSDDLogVerbose(@"Pending audio high water mark %lu of %lu bytes",
+                            (unsigned long)buffer.highWaterMark,
+                            (unsigned long)buffer.capacity);
+        });
+        
         [self releaseAudioSource];
     }
 }
 
 - (void)streamAudio:(NSData *)audio{
     [producerAudioBuffer appendBytes:audio.bytes length:audio.length];
-    if(producerAudioBuffer.length > numOfBytesSent && [producerStream hasSpaceAvailable]) {
-        NSRange range = NSMakeRange(numOfBytesSent, producerAudioBuffer.length - numOfBytesSent);
-        UInt8 chunkBuffer[range.length];
-        [producerAudioBuffer getBytes:chunkBuffer range:range];
-        NSInteger result = [producerStream write:chunkBuffer maxLength:range.length];
-        AWSDDLogVerbose(@"wrote %ld to producer stream", (long)result);
-        if (result >= 0) {
-            numOfBytesSent += result;
+    // Frames are dropped whole rather than letting unsent audio grow without bound while the request stream is blocked.
+    if (![pendingAudioBuffer writeFrame:audio.bytes length:audio.length]) {
+        AWSDDLogVerbose(@"pending audio buffer full, dropped %lu bytes", (unsigned long)audio.length);
+    }
+    [self schedulePendingAudioDrain];
+}
+
+- (void)schedulePendingAudioDrain{
+    NSOutputStream *stream = producerStream;
+    AWSLexAudioRingBuffer *buffer = pendingAudioBuffer;
+    __weak AWSLexInteractionKit *weakSelf = self;
+    dispatch_async(audioStreamingQueue, ^{
+        [weakSelf drainPendingAudio:buffer toStream:stream waitForSpace:NO];
+    });
+}
+
+/**
+ Writes pending audio to the producer stream straight out of the ring buffer. Only called on audioStreamingQueue,
+ which is the ring buffer's single consumer. The kit's state is only changed on the main queue, where the producer
+ stream is scheduled, so the writes are reported there.
+ */
+- (void)drainPendingAudio:(AWSLexAudioRingBuffer *)buffer toStream:(NSOutputStream *)stream waitForSpace:(BOOL)waitForSpace{
+    __weak AWSLexInteractionKit *weakSelf = self;
+    BOOL written = [buffer writeToStream:stream waitForSpace:waitForSpace didWrite:^(NSUInteger length) {
+        AWSDDRecordVerbose("wrote %lu to producer stream", (unsigned long)length);
+        [weakSelf dispatchBlockOnMainQueue:^{
+            AWSLexInteractionKit *strongSelf = weakSelf;
+            // Audio written after the interaction ended does not change the state of the next one.
+            if (!strongSelf || stream != strongSelf->producerStream) {
+                return;
+            }
+            strongSelf->numOfBytesSent += length;
             //start streaming only after we get an actual audio
-            [self startStreaming];
-        }else{
+            [strongSelf startStreaming];
+        }];
+    }];
+    if (!written) {
+        [self dispatchBlockOnMainQueue:^{
+            AWSLexInteractionKit *strongSelf = weakSelf;
+            if (!strongSelf || stream != strongSelf->producerStream) {
+                return;
+            }
             NSError *audioError = [NSError errorWithDomain:AWSLexInteractionKitErrorDomain code:AWSLexInteractionKitErrorCodeAudioStreaming userInfo:nil];
-            [self handleError:audioError];
-        }
+            [strongSelf handleError:audioError];
+        }];
     }
 }
 
@@ -699,6 +760,12 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
             [self handleError:streamError];
             break;
         }
+        case NSStreamEventHasSpaceAvailable:{
+            if (aStream == producerStream) {
+                [self schedulePendingAudioDrain];
+            }
+            break;
+        }
         default:
             break;
     }
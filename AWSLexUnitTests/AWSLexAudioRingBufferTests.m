@@ -0,0 +1,187 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSLexAudioRingBuffer.h"
+
+// Synthetic frames are a 4 byte sequence number followed by that number repeated as filler.
+static const NSUInteger AWSLexAudioRingBufferTestsFrameLength = 320;
+
+@interface AWSLexAudioRingBufferTests : XCTestCase
+
+@end
+
+@implementation AWSLexAudioRingBufferTests
+
+- (void)fillFrame:(uint8_t *)frame sequenceNumber:(uint32_t)sequenceNumber {
+    memcpy(frame, &sequenceNumber, sizeof(sequenceNumber));
+    memset(frame + sizeof(sequenceNumber), (uint8_t)sequenceNumber, AWSLexAudioRingBufferTestsFrameLength - sizeof(sequenceNumber));
+}
+
+- (void)testCapacityIsRoundedUpToAPowerOfTwo {
+    XCTAssertEqual([[AWSLexAudioRingBuffer alloc] initWithCapacity:1000].capacity, 1024);
+    XCTAssertEqual([[AWSLexAudioRingBuffer alloc] initWithCapacity:4096].capacity, 4096);
+}
+
+- (void)testWritesAndReadsWrapAround {
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:16];
+    uint8_t input[10];
+    uint8_t output[10];
+    for (uint8_t round = 0; round < 50; round++) {
+        for (NSUInteger i = 0; i < sizeof(input); i++) {
+            input[i] = (uint8_t)(round * sizeof(input) + i);
+        }
+        XCTAssertTrue([buffer writeFrame:input length:sizeof(input)]);
+        XCTAssertEqual(buffer.readableLength, sizeof(input));
+        XCTAssertEqual([buffer readBytes:output maxLength:sizeof(output)], sizeof(output));
+        XCTAssertEqual(memcmp(input, output, sizeof(input)), 0);
+    }
+    XCTAssertEqual(buffer.readableLength, 0);
+    XCTAssertEqual(buffer.overrunCount, 0);
+}
+
+- (void)testFrameThatDoesNotFitIsRejectedWhole {
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:16];
+    uint8_t frame[12] = {0};
+    XCTAssertTrue([buffer writeFrame:frame length:sizeof(frame)]);
+    XCTAssertFalse([buffer writeFrame:frame length:sizeof(frame)]);
+    XCTAssertEqual(buffer.readableLength, sizeof(frame));
+    XCTAssertEqual(buffer.overrunCount, 1);
+    XCTAssertEqual(buffer.droppedByteCount, sizeof(frame));
+    XCTAssertEqual(buffer.highWaterMark, sizeof(frame));
+}
+
+- (void)testProducerFasterThanConsumerDropsWholeFramesInOrder {
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:AWSLexAudioRingBufferTestsFrameLength * 8];
+    const uint32_t frameCount = 20000;
+    __block NSUInteger acceptedFrames = 0;
+
+    dispatch_group_t producer = dispatch_group_create();
+    dispatch_group_async(producer, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint8_t frame[AWSLexAudioRingBufferTestsFrameLength];
+        for (uint32_t sequenceNumber = 0; sequenceNumber < frameCount; sequenceNumber++) {
+            [self fillFrame:frame sequenceNumber:sequenceNumber];
+            if ([buffer writeFrame:frame length:sizeof(frame)]) {
+                acceptedFrames++;
+            }
+        }
+    });
+
+    // A slow consumer that reads in odd sized pieces, so frames are regularly split across reads.
+    NSMutableData *consumed = [NSMutableData new];
+    uint8_t chunk[97];
+    BOOL producing = YES;
+    while (producing || buffer.readableLength > 0) {
+        producing = dispatch_group_wait(producer, DISPATCH_TIME_NOW) != 0;
+        NSUInteger length = [buffer readBytes:chunk maxLength:sizeof(chunk)];
+        [consumed appendBytes:chunk length:length];
+        usleep(10);
+    }
+
+    XCTAssertGreaterThan(buffer.overrunCount, 0);
+    XCTAssertEqual(buffer.overrunCount + acceptedFrames, frameCount);
+    XCTAssertEqual(buffer.droppedByteCount, buffer.overrunCount * AWSLexAudioRingBufferTestsFrameLength);
+    XCTAssertLessThanOrEqual(buffer.highWaterMark, buffer.capacity);
+    XCTAssertEqual(consumed.length, acceptedFrames * AWSLexAudioRingBufferTestsFrameLength);
+
+    uint8_t expectedFrame[AWSLexAudioRingBufferTestsFrameLength];
+    int64_t previousSequenceNumber = -1;
+    for (NSUInteger offset = 0; offset + AWSLexAudioRingBufferTestsFrameLength <= consumed.length; offset += AWSLexAudioRingBufferTestsFrameLength) {
+        uint32_t sequenceNumber;
+        memcpy(&sequenceNumber, (const uint8_t *)consumed.bytes + offset, sizeof(sequenceNumber));
+        XCTAssertGreaterThan((int64_t)sequenceNumber, previousSequenceNumber);
+        [self fillFrame:expectedFrame sequenceNumber:sequenceNumber];
+        XCTAssertEqual(memcmp(expectedFrame, (const uint8_t *)consumed.bytes + offset, sizeof(expectedFrame)), 0);
+        previousSequenceNumber = sequenceNumber;
+    }
+}
+
+- (void)testWritingToAFullStreamLeavesTheRestPending {
+    NSInputStream *inputStream = nil;
+    NSOutputStream *outputStream = nil;
+    [NSStream getBoundStreamsWithBufferSize:256 inputStream:&inputStream outputStream:&outputStream];
+    [inputStream open];
+    [outputStream open];
+
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:4096];
+    uint8_t frame[AWSLexAudioRingBufferTestsFrameLength];
+    for (uint32_t sequenceNumber = 0; sequenceNumber < 10; sequenceNumber++) {
+        [self fillFrame:frame sequenceNumber:sequenceNumber];
+        XCTAssertTrue([buffer writeFrame:frame length:sizeof(frame)]);
+    }
+
+    __block NSUInteger writtenLength = 0;
+    XCTAssertTrue([buffer writeToStream:outputStream waitForSpace:NO didWrite:^(NSUInteger length) {
+        writtenLength += length;
+    }]);
+    XCTAssertEqual(writtenLength, 256);
+    XCTAssertEqual(buffer.readableLength, 10 * AWSLexAudioRingBufferTestsFrameLength - 256);
+
+    [inputStream close];
+    [outputStream close];
+}
+
+- (void)testWaitingForSpaceWritesEveryPendingByte {
+    NSInputStream *inputStream = nil;
+    NSOutputStream *outputStream = nil;
+    [NSStream getBoundStreamsWithBufferSize:256 inputStream:&inputStream outputStream:&outputStream];
+    [inputStream open];
+    [outputStream open];
+
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:4096];
+    NSMutableData *expected = [NSMutableData new];
+    uint8_t frame[AWSLexAudioRingBufferTestsFrameLength];
+    for (uint32_t sequenceNumber = 0; sequenceNumber < 10; sequenceNumber++) {
+        [self fillFrame:frame sequenceNumber:sequenceNumber];
+        XCTAssertTrue([buffer writeFrame:frame length:sizeof(frame)]);
+        [expected appendBytes:frame length:sizeof(frame)];
+    }
+
+    // Stands in for the request, which reads the audio while the last of it is being written.
+    NSMutableData *received = [NSMutableData new];
+    dispatch_group_t reader = dispatch_group_create();
+    dispatch_group_async(reader, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint8_t chunk[97];
+        NSInteger length = 0;
+        while ((length = [inputStream read:chunk maxLength:sizeof(chunk)]) > 0) {
+            [received appendBytes:chunk length:length];
+        }
+    });
+
+    XCTAssertTrue([buffer writeToStream:outputStream waitForSpace:YES didWrite:nil]);
+    XCTAssertEqual(buffer.readableLength, 0);
+    [outputStream close];
+    XCTAssertEqual(dispatch_group_wait(reader, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    XCTAssertEqualObjects(received, expected);
+
+    [inputStream close];
+}
+
+- (void)testWritingToAClosedStreamFails {
+    NSInputStream *inputStream = nil;
+    NSOutputStream *outputStream = nil;
+    [NSStream getBoundStreamsWithBufferSize:256 inputStream:&inputStream outputStream:&outputStream];
+    [outputStream open];
+    [outputStream close];
+
+    AWSLexAudioRingBuffer *buffer = [[AWSLexAudioRingBuffer alloc] initWithCapacity:1024];
+    uint8_t frame[AWSLexAudioRingBufferTestsFrameLength] = {0};
+    XCTAssertTrue([buffer writeFrame:frame length:sizeof(frame)]);
+
+    XCTAssertFalse([buffer writeToStream:outputStream waitForSpace:YES didWrite:nil]);
+    XCTAssertEqual(buffer.readableLength, sizeof(frame));
+}
+
+@end
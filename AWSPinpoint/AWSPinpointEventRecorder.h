@@ -48,7 +48,7 @@ FOUNDATION_EXPORT NSString *const AWSPinpointEventByteThresholdReachedNotificati
 @interface AWSPinpointEventRecorder : AWSService
 
 /**
- The number of bytes currently used to store AWSPinpointEvent objects on disk.
+ The number of bytes currently used to store AWSPinpointEvent objects on disk, counting the archived event and its identifier.
  */
 @property (nonatomic, assign, readonly) uint64_t diskBytesUsed;
 
@@ -37,6 +37,11 @@ NSString *const AWSPinpointClientRecorderDatabasePathPrefix = @"com/amazonaws/AW
 NSUInteger const AWSPinpointClientValidEvent = 0;
 NSUInteger const AWSPinpointClientInvalidEvent = 1;
 
+// Queue channels. Events move to the dirty channel if submission fails with a non-retryable error or if it retrys more than 3 times.
+static NSString *const AWSPinpointEventChannel = @"Event";
+static NSString *const AWSPinpointDirtyEventChannel = @"DirtyEvent";
+static NSString *const AWSPinpointSessionStartEventType = @"_session.start";
+
 /**
  * According to the limit "Maximum number events in a request"
  * defined in https://docs.aws.amazon.com/pinpoint/latest/developerguide/limits.html
@@ -53,7 +58,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 @interface AWSPinpointEventRecorder()
 
 @property (nonatomic, weak) AWSPinpointContext *context;
-@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+@property (nonatomic, strong) AWSDurableQueue *queue;
 @property (nonatomic, strong) NSString *databasePath;
 @property (nonatomic, strong) AWSPinpointEndpointProfile *profile;
 @property (nonatomic, strong) NSObject *lock;
@@ -117,53 +122,85 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
         
         // Creates a database for the identifier if it doesn't exist.
         AWSDDLogDebug(@"Database path: [%@]", _databasePath);
-        _databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
-        [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            db.shouldCacheStatements = YES;
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeStatements:@"PRAGMA auto_vacuum = FULL"]) {
                 AWSDDLogError(@"Failed to enable 'auto_vacuum' to 'FULL'. %@", db.lastError);
             }
-            
-            //Event Table
-            if (![db executeUpdate:
-                  @"CREATE TABLE IF NOT EXISTS Event ("
-                  @"id TEXT NOT NULL,"
-                  @"attributes BLOB NOT NULL,"
-                  @"eventType TEXT NOT NULL,"
-                  @"metrics BLOB NOT NULL,"
-                  @"eventTimestamp TEXT NOT NULL,"
-                  @"sessionId TEXT NOT NULL,"
-                  @"sessionStartTime TEXT NOT NULL,"
-                  @"sessionStopTime TEXT NOT NULL,"
-                  @"timestamp REAL NOT NULL,"
-                  @"dirty INTEGER NOT NULL,"
-                  @"retryCount INTEGER NOT NULL)"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-            }
-            
-            //Dirty Event Table: Events are moved to the dirty table if submission fails with a non-retryable error or if it retrys more than 3 times.
-            if (![db executeUpdate:
-                  @"CREATE TABLE IF NOT EXISTS DirtyEvent ("
-                  @"id TEXT NOT NULL,"
-                  @"attributes BLOB NOT NULL,"
-                  @"eventType TEXT NOT NULL,"
-                  @"metrics BLOB NOT NULL,"
-                  @"eventTimestamp TEXT NOT NULL,"
-                  @"sessionId TEXT NOT NULL,"
-                  @"sessionStartTime TEXT NOT NULL,"
-                  @"sessionStopTime TEXT NOT NULL,"
-                  @"timestamp REAL NOT NULL,"
-                  @"dirty INTEGER NOT NULL,"
-                  @"retryCount INTEGER NOT NULL)"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-            }
         }];
+
+        _queue = [[AWSDurableQueue alloc] initWithDatabaseQueue:databaseQueue];
+        _queue.byteLimit = _diskByteLimit;
+        _queue.ageLimit = _diskAgeLimit;
+        _queue.deadLetterChannel = AWSPinpointDirtyEventChannel;
+        [self moveEventsFromEventTables];
     }
     return self;
 }
 
 - (void) dealloc {
-    [_databaseQueue close];
+    [_queue.databaseQueue close];
+}
+
+// Events saved by earlier versions of the SDK are kept in the `Event` and `DirtyEvent` tables. They are appended to
+// the queue before the tables are dropped, so an interruption in between can submit them twice but never loses them.
+- (void)moveEventsFromEventTables {
+    AWSFMDatabaseQueue *databaseQueue = self.queue.databaseQueue;
+    NSMutableArray<AWSDurableQueueRecord *> *records = [NSMutableArray new];
+    NSMutableArray<NSString *> *tableNames = [NSMutableArray new];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        for (NSString *tableName in @[@"DirtyEvent", @"Event"]) {
+            if (![db tableExists:tableName]) {
+                continue;
+            }
+            [tableNames addObject:tableName];
+            AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
+                                                   @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, dirty, retryCount "
+                                                   @"FROM %@ "
+                                                   @"ORDER BY timestamp ASC", tableName]];
+            while ([rs next]) {
+                NSError *codingError = nil;
+                NSData *data = [AWSPinpointEventRecorder dataForEventFields:@{
+                                                                              @"attributes": [rs dataForColumn:@"attributes"] ?: [NSData data],
+                                                                              @"eventType": [rs stringForColumn:@"eventType"],
+                                                                              @"metrics": [rs dataForColumn:@"metrics"] ?: [NSData data],
+                                                                              @"eventTimestamp": [rs stringForColumn:@"eventTimestamp"],
+                                                                              @"sessionId": [rs stringForColumn:@"sessionId"],
+                                                                              @"sessionStartTime": [rs stringForColumn:@"sessionStartTime"],
+                                                                              @"sessionStopTime": [rs stringForColumn:@"sessionStopTime"]
+                                                                              }
+                                                                      error:&codingError];
+                if (!data) {
+                    AWSDDLogError(@"Error archiving saved event: %@", codingError);
+                    continue;
+                }
+                BOOL dirty = [tableName isEqualToString:@"DirtyEvent"] || [rs intForColumn:@"dirty"] == AWSPinpointClientInvalidEvent;
+                [records addObject:[[AWSDurableQueueRecord alloc] initWithChannel:dirty ? AWSPinpointDirtyEventChannel : AWSPinpointEventChannel
+                                                                              key:[rs stringForColumn:@"id"]
+                                                                              tag:[rs stringForColumn:@"eventType"]
+                                                                             data:data
+                                                                        timestamp:[rs doubleForColumn:@"timestamp"]
+                                                                       retryCount:(NSUInteger)[rs longLongIntForColumn:@"retryCount"]]];
+            }
+            [rs close];
+        }
+    }];
+    if ([tableNames count] == 0) {
+        return;
+    }
+
+    NSError *error = nil;
+    if (![self.queue appendRecords:records error:&error]) {
+        AWSDDLogError(@"Failed to move the saved events. [%@]", error);
+        return;
+    }
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        for (NSString *tableName in tableNames) {
+            if (![db executeUpdate:[NSString stringWithFormat:@"DROP TABLE %@", tableName]]) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            }
+        }
+    }];
 }
 
 + (dispatch_queue_t)sharedQueue {
@@ -226,179 +263,91 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 
 - (AWSTask<AWSPinpointEvent *> *) saveEvent:(AWSPinpointEvent *) eventToSave {
     
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    NSTimeInterval diskAgeLimit = self.diskAgeLimit;
-    NSString *databasePath = self.databasePath;
+    AWSDurableQueue *queue = self.queue;
     NSUInteger notificationByteThreshold = self.notificationByteThreshold;
-    NSUInteger diskByteLimit = self.diskByteLimit;
     __weak id notificationSender = self;
     eventToSave.session = [self validateOrRetrieveSession:eventToSave.session];
     __block AWSPinpointEvent *event = [eventToSave copy];
     AWSDDLogVerbose(@"saveEvent: [%@]", event.toDictionary);
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        // Inserts a new record to the database.
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            
-            NSString *sessionId = event.session.sessionId;
-            NSString *stopTime = [event.session.stopTime aws_stringValue:AWSDateISO8601DateFormat3];
-            NSString *startTime = [event.session.startTime aws_stringValue:AWSDateISO8601DateFormat3];
-
-            NSError *codingError;
-
-            NSData *attributesData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:event.allAttributes
-                                                                           requiringSecureCoding:YES
-                                                                                           error:&codingError];
-            if (codingError) {
-                AWSDDLogError(@"Error archiving attributesData: %@", codingError);
-                error = codingError;
-                return;
-            }
-
-            NSData *metricsData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:event.allMetrics
-                                                                        requiringSecureCoding:YES
-                                                                                        error:&codingError];
-            if (codingError) {
-                AWSDDLogError(@"Error archiving metricsData: %@", codingError);
-                error = codingError;
-                return;
-            }
-
-            BOOL result = [db executeUpdate:
-                           @"INSERT INTO Event ("
-                           @"id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, dirty, retryCount"
-                           @") VALUES ("
-                           @":id, :attributes, :eventType, :metrics, :eventTimestamp, :sessionId, :sessionStartTime, :sessionStopTime, :timestamp, :dirty, :retryCount"
-                           @")"
-                    withParameterDictionary:@{
-                                              @"id" : [[NSUUID UUID] UUIDString],
-                                              @"attributes" : attributesData,
-                                              @"eventType" : event.eventType,
-                                              @"metrics" : metricsData,
-                                              @"eventTimestamp" : [AWSPinpointDateUtils isoDateTimeWithTimestamp:event.eventTimestamp],
-                                              @"sessionId": sessionId,
-                                              @"sessionStartTime": startTime? startTime : @"",
-                                              @"sessionStopTime": stopTime? stopTime : @"",
-                                              @"timestamp": @([[NSDate date] timeIntervalSince1970]),
-                                              @"dirty" : [NSNumber numberWithInteger:AWSPinpointClientValidEvent],
-                                              @"retryCount" : @0
-                                              }
-                           ];
-            
-            if (!result) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
-            }
-        }];
-        
-        if (!error && diskAgeLimit > 0) {
-            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                // Deletes old events exceeding the threshold.
-                BOOL result = [db executeUpdate:
-                               @"DELETE FROM Event "
-                               @"WHERE timestamp < :timestamp"
-                        withParameterDictionary:@{
-                                                  @"timestamp" : @([[NSDate date] timeIntervalSince1970] - diskAgeLimit)
-                                                  }
-                               ];
-                if (!result) {
-                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                    error = db.lastError;
-                }
-            }];
+    return [[[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        NSString *stopTime = [event.session.stopTime aws_stringValue:AWSDateISO8601DateFormat3];
+        NSString *startTime = [event.session.startTime aws_stringValue:AWSDateISO8601DateFormat3];
+
+        NSError *codingError;
+
+        NSData *attributesData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:event.allAttributes
+                                                                       requiringSecureCoding:YES
+                                                                                       error:&codingError];
+        if (codingError) {
+            AWSDDLogError(@"Error archiving attributesData: %@", codingError);
+            return [AWSTask taskWithError:codingError];
         }
-        
-        if (error) {
-            return [AWSTask taskWithError:error];
+
+        NSData *metricsData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:event.allMetrics
+                                                                    requiringSecureCoding:YES
+                                                                                    error:&codingError];
+        if (codingError) {
+            AWSDDLogError(@"Error archiving metricsData: %@", codingError);
+            return [AWSTask taskWithError:codingError];
         }
-        
-        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:databasePath
-                                                                                    error:&error];
-        if (attributes) {
-            NSUInteger fileSize = (NSUInteger)[attributes fileSize];
-            [self checkByteThresholdForNotification:notificationByteThreshold
-                                 notificationSender:notificationSender
-                                           fileSize:fileSize];
-            if (fileSize > diskByteLimit) {
-                //First Flush the dirty events
-                [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                    if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                    }
-                }];
-                
-                if (error) {
-                    return [AWSTask taskWithError:error];
-                }
-                
-                if ([self diskBytesUsed] > diskByteLimit) {
-                    // Deletes the oldest event if it still exceeds the disk size threshold after clearing the dirty events.
-                    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                        AWSDDLogWarn(@"Deleting oldest event from disk, diskByteLimit has been reached.");
-                        BOOL result = [db executeUpdate:
-                                       @"DELETE FROM Event "
-                                       @"WHERE id IN ( "
-                                       @"SELECT id "
-                                       @"FROM Event "
-                                       @"ORDER BY timestamp ASC "
-                                       @"LIMIT 1 "
-                                       @")"
-                                       ];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                            return;
-                        }
-                    }];
-                }
-            }
-        } else if (error) {
-            return [AWSTask taskWithError:error];
+
+        NSData *data = [AWSPinpointEventRecorder dataForEventFields:@{
+                                                                      @"attributes" : attributesData,
+                                                                      @"eventType" : event.eventType,
+                                                                      @"metrics" : metricsData,
+                                                                      @"eventTimestamp" : [AWSPinpointDateUtils isoDateTimeWithTimestamp:event.eventTimestamp],
+                                                                      @"sessionId": event.session.sessionId,
+                                                                      @"sessionStartTime": startTime? startTime : @"",
+                                                                      @"sessionStopTime": stopTime? stopTime : @""
+                                                                      }
+                                                              error:&codingError];
+        if (!data) {
+            AWSDDLogError(@"Error archiving event: %@", codingError);
+            return [AWSTask taskWithError:codingError];
         }
-        
+
+        // The queue writes events saved at about the same time in one transaction. Past the age or byte limit it
+        // evicts the dirty events first, then the oldest events.
+        return [queue appendRecord:[[AWSDurableQueueRecord alloc] initWithChannel:AWSPinpointEventChannel
+                                                                              key:[[NSUUID UUID] UUIDString]
+                                                                              tag:event.eventType
+                                                                             data:data]];
+    }] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        [self checkByteThresholdForNotification:notificationByteThreshold
+                             notificationSender:notificationSender
+                                       fileSize:(NSUInteger)queue.byteCount];
         return [AWSTask taskWithResult:event];
     }];
 }
 
 - (AWSTask*) updateSessionStartWithEventSourceAttributes:(NSDictionary*) attributes {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSDurableQueue *queue = self.queue;
     NSString *sessionId = [self validateOrRetrieveSessionId:self.context.sessionClient.session.sessionId];
     
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-            NSError *codingError;
-            NSData *attributesData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:attributes
-                                                                           requiringSecureCoding:YES
-                                                                                           error:&codingError];
-            if (codingError) {
-                AWSDDLogError(@"Error archiving attributesData: %@", codingError);
-                error = codingError;
-                *rollback = YES;
-                return;
-            }
+        NSError *codingError;
+        NSData *attributesData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:attributes
+                                                                       requiringSecureCoding:YES
+                                                                                       error:&codingError];
+        if (codingError) {
+            AWSDDLogError(@"Error archiving attributesData: %@", codingError);
+            return [AWSTask taskWithError:codingError];
+        }
 
-            BOOL result = [db executeUpdate:
-                           @"UPDATE Event "
-                           @"SET attributes = :attributes "
-                           @"WHERE sessionId = :sessionId "
-                           @"AND eventType = :eventType"
-                    withParameterDictionary:@{
-                                              @"attributes" : attributesData,
-                                              @"eventType" : @"_session.start",
-                                              @"sessionId" : sessionId
-                                              }
-                           ];
-            if (!result) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
+        NSError *error = nil;
+        BOOL result = [queue updateRecordsInChannel:AWSPinpointEventChannel
+                                                tag:AWSPinpointSessionStartEventType
+                                         usingBlock:^NSData * _Nullable(AWSDurableQueueRecord * _Nonnull record) {
+            NSError *decodingError = nil;
+            NSMutableDictionary *fields = [[AWSPinpointEventRecorder eventFieldsForRecord:record error:&decodingError] mutableCopy];
+            if (![fields[@"sessionId"] isEqualToString:sessionId]) {
+                return nil;
             }
-        }];
-        
-        if (error) {
+            fields[@"attributes"] = attributesData;
+            return [AWSPinpointEventRecorder dataForEventFields:fields error:&decodingError];
+        } error:&error];
+        if (!result) {
             return [AWSTask taskWithError:error];
         }
         
@@ -408,61 +357,24 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 
 //Only used for testing
 - (AWSTask*) getCurrentSession: (AWSPinpointSession*) session {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    NSString *sessionId = [self validateOrRetrieveSessionId:session.sessionId];
+    AWSDurableQueue *queue = self.queue;
     
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        __block AWSPinpointEvent *event;
-        
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-            AWSFMResultSet *rs = [db executeQuery:
-                                  @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
-                                  @"FROM Event "
-                                  @"WHERE eventType = :eventType"
-                          withParameterDictionary:@{
-                                                    @"eventType": @"_session.start",
-                                                    @"sessionId": sessionId
-                                                    }];
-            if (!rs) {
-                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-                error = db.lastError;
-                *rollback = YES;
-                return;
-            }
-            
-            if ([rs next]) {
-                NSMutableDictionary *attributes = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                                forColumnName:@"attributes"
-                                                                                                        error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring attributes from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
-
-                NSMutableDictionary *metrics = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                             forColumnName:@"metrics"
-                                                                                                     error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring metrics from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
+        NSError *error = nil;
+        NSArray<AWSDurableQueueRecord *> *records = [queue recordsInChannel:AWSPinpointEventChannel
+                                                                        tag:AWSPinpointSessionStartEventType
+                                                                      error:&error];
+        if (!records) {
+            return [AWSTask taskWithError:error];
+        }
 
-                AWSPinpointSession *session = [[AWSPinpointSession alloc] initWithSessionId:[rs stringForColumn:@"sessionId"]
-                                                                              withStartTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStartTime"] format:AWSDateISO8601DateFormat3]
-                                                                               withStopTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStopTime"] format:AWSDateISO8601DateFormat3]];
-                event = [[AWSPinpointEvent alloc] initWithEventType:[rs stringForColumn:@"eventType"]
-                                                     eventTimestamp:[AWSPinpointDateUtils utcTimeMillisFromISO8061String:[rs stringForColumn:@"eventTimestamp"]]
-                                                            session:session
-                                                         attributes:attributes
-                                                            metrics:metrics];
+        AWSPinpointEvent *event = nil;
+        if ([records count] > 0) {
+            event = [AWSPinpointEventRecorder eventForRecord:records[0] error:&error];
+            if (!event) {
+                AWSDDLogError(@"Error restoring event from DB: %@", error);
+                return [AWSTask taskWithError:error];
             }
-        }];
-        
-        if (error) {
-            return [AWSTask taskWithError:error];
         }
         
         return [AWSTask taskWithResult:event];
@@ -474,62 +386,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getEventsWithLimit:(NSNumber *) limit {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        __block NSMutableArray *events = [NSMutableArray new];
-        
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-            AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
-                                                   @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
-                                                   @"FROM Event "
-                                                   @"ORDER BY timestamp ASC "
-                                                   @"LIMIT %@", limit]];
-            if (!rs) {
-                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-                error = db.lastError;
-                *rollback = YES;
-                return;
-            }
-
-            while ([rs next]) {
-                NSMutableDictionary *attributes = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                                forColumnName:@"attributes"
-                                                                                                        error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring event attributes from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
-
-                NSMutableDictionary *metrics = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                             forColumnName:@"metrics"
-                                                                                                     error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring event metrics from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
-
-                AWSPinpointSession *session = [[AWSPinpointSession alloc] initWithSessionId:[rs stringForColumn:@"sessionId"]
-                                                                              withStartTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStartTime"] format:AWSDateISO8601DateFormat3]
-                                                                               withStopTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStopTime"] format:AWSDateISO8601DateFormat3]];
-                AWSPinpointEvent *event = [[AWSPinpointEvent alloc] initWithEventType:[rs stringForColumn:@"eventType"]
-                                                                       eventTimestamp:[AWSPinpointDateUtils utcTimeMillisFromISO8061String:[rs stringForColumn:@"eventTimestamp"]]
-                                                                              session:session
-                                                                           attributes:attributes
-                                                                              metrics:metrics];
-                [events addObject:event];
-            }
-        }];
-        
-        if (error) {
-            return [AWSTask taskWithError:error];
-        }
-        
-        return [AWSTask taskWithResult:events];
-    }];
+    return [self eventsInChannel:AWSPinpointEventChannel limit:limit];
 }
 
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getDirtyEvents {
@@ -537,65 +394,36 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getDirtyEventsWithLimit:(NSNumber *) limit {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    return [self eventsInChannel:AWSPinpointDirtyEventChannel limit:limit];
+}
+
+- (AWSTask<NSArray<AWSPinpointEvent *> *> *) eventsInChannel:(NSString *) channel limit:(NSNumber *) limit {
+    AWSDurableQueue *queue = self.queue;
     
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        __block NSMutableArray *events = [NSMutableArray new];
-        
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-            AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
-                                                   @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
-                                                   @"FROM DirtyEvent "
-                                                   @"ORDER BY timestamp ASC "
-                                                   @"LIMIT %@", limit]];
-            if (!rs) {
-                AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-                error = db.lastError;
-                *rollback = YES;
-                return;
-            }
-            
-            while ([rs next]) {
-                NSMutableDictionary *attributes = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                                forColumnName:@"attributes"
-                                                                                                        error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring dirty event attributes from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
-
-                NSMutableDictionary *metrics = [AWSPinpointEventRecorder getMutableDictionaryFromResultSet:rs
-                                                                                             forColumnName:@"metrics"
-                                                                                                     error:&error];
-                if (error) {
-                    AWSDDLogError(@"Error restoring dirty event metrics from DB: %@", error);
-                    *rollback = YES;
-                    return;
-                }
+        NSError *error = nil;
+        NSArray<AWSDurableQueueRecord *> *records = [queue oldestRecordsInChannel:channel
+                                                                             limit:[limit unsignedIntegerValue]
+                                                                         byteLimit:0
+                                                                             error:&error];
+        if (!records) {
+            return [AWSTask taskWithError:error];
+        }
 
-                AWSPinpointSession *session = [[AWSPinpointSession alloc] initWithSessionId:[rs stringForColumn:@"sessionId"]
-                                                                              withStartTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStartTime"] format:AWSDateISO8601DateFormat3]
-                                                                               withStopTime:[NSDate aws_dateFromString:[rs stringForColumn:@"sessionStopTime"] format:AWSDateISO8601DateFormat3]];
-                AWSPinpointEvent *event = [[AWSPinpointEvent alloc] initWithEventType:[rs stringForColumn:@"eventType"]
-                                                                       eventTimestamp:[AWSPinpointDateUtils utcTimeMillisFromISO8061String:[rs stringForColumn:@"eventTimestamp"]]
-                                                                              session:session
-                                                                           attributes:attributes
-                                                                              metrics:metrics];
-                [events addObject:event];
+        NSMutableArray *events = [NSMutableArray new];
+        for (AWSDurableQueueRecord *record in records) {
+            AWSPinpointEvent *event = [AWSPinpointEventRecorder eventForRecord:record error:&error];
+            if (!event) {
+                AWSDDLogError(@"Error restoring event from DB: %@", error);
+                return [AWSTask taskWithError:error];
             }
-        }];
-        
-        if (error) {
-            return [AWSTask taskWithError:error];
+            [events addObject:event];
         }
         
         return [AWSTask taskWithResult:events];
     }];
 }
 
-
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *)submitAllEvents {
     @synchronized(self.lock) {
         __block NSMutableArray *result = [NSMutableArray new];
@@ -681,66 +509,36 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (void) getBatchRecords:(void (^)(NSDictionary *eventsWithEventId, NSError *error))result {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    __block NSError *error = nil;
+    NSError *error = nil;
+    // The batch stops before the event that would take it past `batchRecordsByteLimit`.
+    NSArray<AWSDurableQueueRecord *> *records = [self.queue oldestRecordsInChannel:AWSPinpointEventChannel
+                                                                              limit:AWSPinpointServiceDefinedMaxEventsPerBatch
+                                                                          byteLimit:self.batchRecordsByteLimit
+                                                                              error:&error];
     
-    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-        AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
-                                               @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
-                                               @"FROM Event "
-                                               @"WHERE dirty = %@ "
-                                               @"ORDER BY timestamp ASC "
-                                               @"LIMIT %@",
-                                               [NSNumber numberWithInteger:AWSPinpointClientValidEvent], [NSNumber numberWithInteger:AWSPinpointServiceDefinedMaxEventsPerBatch]]];
-        if (!rs) {
-            AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-            error = db.lastError;
-            *rollback = YES;
-            return;
+    NSMutableDictionary *temporaryEventsWithEventId = [NSMutableDictionary new];
+    for (AWSDurableQueueRecord *record in records) {
+        NSMutableDictionary *fields = [[AWSPinpointEventRecorder eventFieldsForRecord:record error:&error] mutableCopy];
+        if (!fields) {
+            AWSDDLogError(@"Error restoring event from DB: %@", error);
+            break;
         }
-        
-        NSMutableDictionary *temporaryEventsWithEventId = [NSMutableDictionary new];
-        while ([rs next]) {
-            [temporaryEventsWithEventId setObject:@{
-                                         @"id": [rs stringForColumn:@"id"],
-                                         @"attributes": [rs dataForColumn:@"attributes"],
-                                         @"eventType": [rs stringForColumn:@"eventType"],
-                                         @"metrics": [rs dataForColumn:@"metrics"],
-                                         @"eventTimestamp": [rs stringForColumn:@"eventTimestamp"],
-                                         @"sessionId": [rs stringForColumn:@"sessionId"],
-                                         @"sessionStartTime": [rs stringForColumn:@"sessionStartTime"],
-                                         @"sessionStopTime": [rs stringForColumn:@"sessionStopTime"]
-                                         } forKey:[rs stringForColumn:@"id"]];
-
-            NSError *codingError;
-            NSData *batchData = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:temporaryEventsWithEventId
-                                                                      requiringSecureCoding:YES
-                                                                                      error:&codingError];
-            if (codingError) {
-                AWSDDLogError(@"Error getting size of batchData: %@", codingError);
-                error = codingError;
-                break;
-            }
-
-            if ([batchData length] > self.batchRecordsByteLimit) {
-                // if the batch size exceeds `batchRecordsByteLimit`, stop there.
-                break;
-            }
-        }
-        rs = nil;
-        
-        result(temporaryEventsWithEventId, error);
-    }];
+        fields[@"id"] = record.key;
+        fields[@"record"] = record;
+        [temporaryEventsWithEventId setObject:fields forKey:record.key];
+    }
+    
+    result(temporaryEventsWithEventId, error);
 }
 
 - (AWSTask<NSDictionary <NSString *, NSDictionary *> *> *)submitBatchEvents:(NSDictionary*) eventsWithEventId{
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSDictionary *temporaryEvents = [eventsWithEventId copy];
 
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]]
                                              withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableDictionary *events = [NSMutableDictionary new];
+        // Events that fail more than three times are moved to the dirty channel by the queue.
         AWSTask *submitTask = [[self putEvents:temporaryEvents
                                          error:&error]
                                continueWithBlock:^id _Nullable(AWSTask * _Nonnull task) {                                   
@@ -753,93 +551,28 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                                }];
         
         return [[AWSTask taskForCompletionOfAllTasksWithResults:@[submitTask]] continueWithBlock:^id _Nullable(AWSTask * _Nonnull t) {
-            AWSTask *failTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                // If an event failed three times, mark even as dirty
-                [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                    BOOL result = [db executeUpdate:[NSString stringWithFormat:
-                                                     @"UPDATE Event "
-                                                     @"SET dirty = %@ "
-                                                     @"WHERE retryCount > 3", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]];
-                    if (!result) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                    }
-                }];
-                return [AWSTask taskWithResult:nil];
-            }];
-            
-            AWSTask *moveTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                //Move dirty events into DirtyEvent table
-                [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                    BOOL result = [db executeUpdate:[NSString stringWithFormat:
-                                                     @"INSERT INTO DirtyEvent "
-                                                     @"SELECT * FROM Event "
-                                                     @"WHERE dirty = %@ ", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]];
-                    if (!result) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                    }
-                }];
-                return [AWSTask taskWithResult:nil];
-            }];
-            
-            AWSTask *deleteTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                //Delete dirty events
-                [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                    BOOL result = [db executeUpdate:[NSString stringWithFormat:
-                                                     @"DELETE FROM Event "
-                                                     @"WHERE dirty = %@ ", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]];
-                    if (!result) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                    }
-                }];
-                return [AWSTask taskWithResult:nil];
-            }];
-            
-            return [[AWSTask taskForCompletionOfAllTasksWithResults:@[failTask, moveTask, deleteTask]] continueWithBlock:^id _Nullable(AWSTask * _Nonnull t) {
-                if (error) {
-                    return [AWSTask taskWithError:error];
-                }
-                return [AWSTask taskWithResult:events];
-            }];
+            if (error) {
+                return [AWSTask taskWithError:error];
+            }
+            return [AWSTask taskWithResult:events];
         }];
     }];
 }
 
 - (AWSTask *)removeAllEvents {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
-    
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            if (![db executeUpdate:@"DELETE FROM Event"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
-            }
-        }];
-        
-        if (error) {
-            return [AWSTask taskWithError:error];
-        }
-        
-        return nil;
-    }];
+    return [self removeEventsInChannel:AWSPinpointEventChannel];
 }
 
 - (AWSTask *)removeAllDirtyEvents {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    return [self removeEventsInChannel:AWSPinpointDirtyEventChannel];
+}
+
+- (AWSTask *)removeEventsInChannel:(NSString *)channel {
+    AWSDurableQueue *queue = self.queue;
     
     return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
-            }
-        }];
-        
-        if (error) {
+        NSError *error = nil;
+        if (![queue removeRecordsInChannel:channel error:&error]) {
             return [AWSTask taskWithError:error];
         }
         
@@ -848,15 +581,17 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (uint64_t)diskBytesUsed {
-    NSError *error = nil;
-    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:self.databasePath
-                                                                                error:&error];
-    if (attributes) {
-        return [attributes fileSize];
-    } else {
-        AWSDDLogError(@"Error [%@]", error);
-        return 0;
-    }
+    return self.queue.byteCount;
+}
+
+- (void)setDiskByteLimit:(NSUInteger)diskByteLimit {
+    _diskByteLimit = diskByteLimit;
+    self.queue.byteLimit = diskByteLimit;
+}
+
+- (void)setDiskAgeLimit:(NSTimeInterval)diskAgeLimit {
+    _diskAgeLimit = diskAgeLimit;
+    self.queue.ageLimit = diskAgeLimit;
 }
 
 - (void)setBatchRecordsByteLimit:(NSUInteger)batchRecordsByteLimit {
@@ -970,7 +705,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask *)putEvents:(NSDictionary *) temporaryEvents
                  error:(NSError* __autoreleasing *) error
        endpointProfile:(AWSPinpointEndpointProfile *) profile {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSDurableQueue *queue = self.queue;
     
     // events to be submitted, and returned back to caller for debugging
     // aggregate attributes, metrics...
@@ -1034,34 +769,21 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 AWSDDLogError(@"Server rejected submission of %lu events. (Events will be marked dirty.) Response code:%ld, Error Message:%@", (unsigned long)[events count], (long)responseCode, task.error);
                 
                 return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                    for (__block NSString *eventID in _temporaryEvents) {
-                        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                            BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id = :id", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
-                                    withParameterDictionary:@{
-                                                              @"id" : eventID
-                                                              }];
-                            if (!result) {
-                                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                                *error = db.lastError;
-                            }
-                        }];
+                    NSError *queueError = nil;
+                    if (![queue moveRecords:[AWSPinpointEventRecorder recordsForEventIds:[_temporaryEvents allKeys] events:_temporaryEvents]
+                                  toChannel:AWSPinpointDirtyEventChannel
+                                      error:&queueError]) {
+                        *error = queueError;
                     }
                     return [AWSTask taskWithError:[self processError:task.error]];
                 }]]];
             } else {
                 AWSDDLogError(@"Unable to successfully deliver events to server. Events will be retried. Error Message:%@", task.error);
                 return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                    for (__block NSString *eventID in _temporaryEvents) {
-                        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                            BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id = :id"
-                                    withParameterDictionary:@{
-                                                              @"id" : eventID
-                                                              }];
-                            if (!result) {
-                                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                                *error = db.lastError;
-                            }
-                        }];
+                    NSError *queueError = nil;
+                    if (![queue retryRecords:[AWSPinpointEventRecorder recordsForEventIds:[_temporaryEvents allKeys] events:_temporaryEvents]
+                                       error:&queueError]) {
+                        *error = queueError;
                     }
                     return task;
                 }]]];
@@ -1086,45 +808,25 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                          (unsigned int)[[_processedEvents objectForKey:@"dirtyEvents"] count]);
 
             return [[AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+                NSError *queueError = nil;
                 //submitted events, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"acceptedEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:@"DELETE FROM Event WHERE id = :id"
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
+                if (![queue acknowledgeRecords:[AWSPinpointEventRecorder recordsForEventIds:[[_processedEvents objectForKey:@"acceptedEvents"] allKeys]
+                                                                                      events:_temporaryEvents]
+                                         error:&queueError]) {
+                    *error = queueError;
                 }
                 //retryable events, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"retryableEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id = :id"
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
+                if (![queue retryRecords:[AWSPinpointEventRecorder recordsForEventIds:[[_processedEvents objectForKey:@"retryableEvents"] allKeys]
+                                                                                events:_temporaryEvents]
+                                   error:&queueError]) {
+                    *error = queueError;
                 }
-                
                 //rejected events, mark dirty, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"dirtyEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id = :id", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
+                if (![queue moveRecords:[AWSPinpointEventRecorder recordsForEventIds:[[_processedEvents objectForKey:@"dirtyEvents"] allKeys]
+                                                                               events:_temporaryEvents]
+                              toChannel:AWSPinpointDirtyEventChannel
+                                  error:&queueError]) {
+                    *error = queueError;
                 }
                 
                 return task;
@@ -1268,20 +970,88 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     return putEventRequest;
 }
 
-+ (NSMutableDictionary *)getMutableDictionaryFromResultSet:(AWSFMResultSet *)rs
-                                             forColumnName:(NSString *)columnName
-                                                     error:(NSError *__autoreleasing *)error {
++ (NSArray<AWSDurableQueueRecord *> *)recordsForEventIds:(NSArray<NSString *> *)eventIds
+                                                  events:(NSDictionary *)events {
+    NSMutableArray<AWSDurableQueueRecord *> *records = [NSMutableArray new];
+    for (NSString *eventId in eventIds) {
+        AWSDurableQueueRecord *record = events[eventId][@"record"];
+        if (record) {
+            [records addObject:record];
+        }
+    }
+    return records;
+}
+
+// The fields are strings and the already archived attributes and metrics, so they are written as a binary property
+// list rather than archived a second time.
++ (nullable NSData *)dataForEventFields:(NSDictionary *)fields
+                                  error:(NSError *__autoreleasing *)error {
+    return [NSPropertyListSerialization dataWithPropertyList:fields
+                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                     options:0
+                                                       error:error];
+}
+
++ (nullable NSDictionary *)eventFieldsForRecord:(AWSDurableQueueRecord *)record
+                                          error:(NSError *__autoreleasing *)error {
+    NSError *decodingError = nil;
+    NSDictionary *fields = [NSPropertyListSerialization propertyListWithData:record.data
+                                                                     options:NSPropertyListImmutable
+                                                                      format:NULL
+                                                                       error:&decodingError];
+    if (![fields isKindOfClass:[NSDictionary class]]) {
+        if (error) {
+            *error = decodingError ?: [NSError errorWithDomain:AWSPinpointAnalyticsErrorDomain
+                                                          code:AWSPinpointAnalyticsErrorUnknown
+                                                      userInfo:@{NSLocalizedDescriptionKey: @"The saved event could not be read."}];
+        }
+        return nil;
+    }
+    return fields;
+}
+
++ (nullable AWSPinpointEvent *)eventForRecord:(AWSDurableQueueRecord *)record
+                                        error:(NSError *__autoreleasing *)error {
+    NSDictionary *fields = [self eventFieldsForRecord:record error:error];
+    if (!fields) {
+        return nil;
+    }
+
+    NSMutableDictionary *attributes = [self getMutableDictionaryFromData:fields[@"attributes"] error:error];
+    if (!attributes) {
+        return nil;
+    }
+    NSMutableDictionary *metrics = [self getMutableDictionaryFromData:fields[@"metrics"] error:error];
+    if (!metrics) {
+        return nil;
+    }
+
+    AWSPinpointSession *session = [[AWSPinpointSession alloc] initWithSessionId:fields[@"sessionId"]
+                                                                  withStartTime:[NSDate aws_dateFromString:fields[@"sessionStartTime"] format:AWSDateISO8601DateFormat3]
+                                                                   withStopTime:[NSDate aws_dateFromString:fields[@"sessionStopTime"] format:AWSDateISO8601DateFormat3]];
+    return [[AWSPinpointEvent alloc] initWithEventType:fields[@"eventType"]
+                                        eventTimestamp:[AWSPinpointDateUtils utcTimeMillisFromISO8061String:fields[@"eventTimestamp"]]
+                                               session:session
+                                            attributes:attributes
+                                               metrics:metrics];
+}
+
++ (NSMutableDictionary *)getMutableDictionaryFromData:(NSData *)data
+                                                error:(NSError *__autoreleasing *)error {
     NSSet *allowableClasses = [[NSSet alloc] initWithObjects:[NSMutableString class],
                                [NSDictionary class],
                                nil];
+    NSError *decodingError = nil;
     NSDictionary *immutableDict = [AWSNSCodingUtilities versionSafeUnarchivedObjectOfClasses:allowableClasses
-                                                                                    fromData:[rs dataForColumn:columnName]
-                                                                                       error:error];
-    if (*error) {
+                                                                                    fromData:data ?: [NSData data]
+                                                                                       error:&decodingError];
+    if (decodingError) {
+        if (error) {
+            *error = decodingError;
+        }
         return nil;
     }
-    NSMutableDictionary *mutableDict = [immutableDict mutableCopy];
-    return mutableDict;
+    return [immutableDict mutableCopy] ?: [NSMutableDictionary new];
 }
 
 @end
@@ -52,12 +52,14 @@ static NSString *const EventTypeSessionStart = @"_session.start";
 
 @interface AWSPinpointEventRecorder ()
 @property (nonatomic, strong) AWSPinpointEndpointProfile *profile;
+@property (nonatomic, strong) AWSDurableQueue *queue;
 
 - (instancetype)initWithIdentifier:(NSString *)identifier
                            context:(AWSPinpointContext *) context
                    targetingClient:(AWSPinpointTargetingClient *) targetingClient;
 - (AWSTask*) getCurrentSession: (AWSPinpointSession*) session;
 - (AWSTask*) updateSessionStartWithEventSourceAttributes:(NSDictionary*) attributes;
+- (void)moveEventsFromEventTables;
 @end
 
 @interface AWSPinpointSession()
@@ -1251,17 +1253,21 @@ targetingServiceConfiguration:(AWSServiceConfiguration*) targetingServiceConfigu
     for (int i = 0; i < 10; i++) {
         task = [task continueWithBlock:^id(AWSTask *task) {
             if (i == 9) {
-                sleep(1);
+                sleep(2);
             }
             return [self.pinpointIAD.analyticsClient.eventRecorder saveEvent:event];
         }];
     }
     
-    [[[task continueWithBlock:^id(AWSTask *task) {
-        uint64_t newSize = self.pinpointIAD.analyticsClient.eventRecorder.diskBytesUsed;
-        XCTAssertEqual(newSize, baseline);
-        [self.pinpointIAD.analyticsClient.eventRecorder removeAllEvents];
-        return nil;
+    // The first nine events are past the age limit when the last one is saved, so only its bytes are still counted.
+    [[[[task continueWithBlock:^id(AWSTask *task) {
+        XCTAssertNil(task.error);
+        XCTAssertGreaterThan(self.pinpointIAD.analyticsClient.eventRecorder.diskBytesUsed, baseline);
+        return [self.pinpointIAD.analyticsClient.eventRecorder getEvents];
+    }] continueWithBlock:^id(AWSTask *task) {
+        XCTAssertNil(task.error);
+        XCTAssertEqual([task.result count], 1);
+        return [self.pinpointIAD.analyticsClient.eventRecorder removeAllEvents];
     }] continueWithBlock:^id(AWSTask *task) {
         XCTAssertEqual(self.pinpointIAD.analyticsClient.eventRecorder.diskBytesUsed, baseline);
         return nil;
@@ -1270,6 +1276,78 @@ targetingServiceConfiguration:(AWSServiceConfiguration*) targetingServiceConfigu
     self.pinpointIAD.analyticsClient.eventRecorder.diskAgeLimit = 0;
 }
 
+- (void)testMoveEventsFromEventTables {
+    AWSPinpointEventRecorder *eventRecorder = self.pinpointIAD.analyticsClient.eventRecorder;
+    [[eventRecorder removeAllEvents] waitUntilFinished];
+    [[eventRecorder removeAllDirtyEvents] waitUntilFinished];
+
+    NSData *attributes = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:@{@"Attr1": @"Attr1"}
+                                                               requiringSecureCoding:YES
+                                                                               error:nil];
+    NSData *metrics = [AWSNSCodingUtilities versionSafeArchivedDataWithRootObject:@{@"Mettr1": @(1)}
+                                                            requiringSecureCoding:YES
+                                                                            error:nil];
+    NSString *timestamp = [[NSDate date] aws_stringValue:AWSDateISO8601DateFormat3];
+
+    // Recreates the tables an earlier version of the SDK saved events in.
+    [eventRecorder.queue.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        for (NSString *tableName in @[@"Event", @"DirtyEvent"]) {
+            XCTAssertTrue([db executeUpdate:[NSString stringWithFormat:
+                                             @"CREATE TABLE %@ ("
+                                             @"id TEXT NOT NULL,"
+                                             @"attributes BLOB NOT NULL,"
+                                             @"eventType TEXT NOT NULL,"
+                                             @"metrics BLOB NOT NULL,"
+                                             @"eventTimestamp TEXT NOT NULL,"
+                                             @"sessionId TEXT NOT NULL,"
+                                             @"sessionStartTime TEXT NOT NULL,"
+                                             @"sessionStopTime TEXT NOT NULL,"
+                                             @"timestamp REAL NOT NULL,"
+                                             @"dirty INTEGER NOT NULL,"
+                                             @"retryCount INTEGER NOT NULL)", tableName]]);
+        }
+        NSArray *rows = @[@[@"Event", @"LEGACY_EVENT", @0],
+                          @[@"Event", @"LEGACY_INVALID_EVENT", @1],
+                          @[@"DirtyEvent", @"LEGACY_DIRTY_EVENT", @0]];
+        for (NSArray *row in rows) {
+            XCTAssertTrue([db executeUpdate:[NSString stringWithFormat:
+                                             @"INSERT INTO %@ ("
+                                             @"id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, dirty, retryCount"
+                                             @") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", row[0]],
+                           [[NSUUID UUID] UUIDString], attributes, row[1], metrics, timestamp, @"LEGACY_SESSION", timestamp, timestamp,
+                           @([[NSDate date] timeIntervalSince1970]), row[2], @2]);
+        }
+    }];
+
+    [eventRecorder moveEventsFromEventTables];
+
+    [eventRecorder.queue.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertFalse([db tableExists:@"Event"]);
+        XCTAssertFalse([db tableExists:@"DirtyEvent"]);
+    }];
+
+    [[[eventRecorder getEvents] continueWithBlock:^id(AWSTask *task) {
+        XCTAssertNil(task.error);
+        XCTAssertEqual([task.result count], 1);
+        AWSPinpointEvent *event = [task.result firstObject];
+        XCTAssertEqualObjects(event.eventType, @"LEGACY_EVENT");
+        XCTAssertEqualObjects(event.session.sessionId, @"LEGACY_SESSION");
+        XCTAssertEqualObjects([event.allAttributes objectForKey:@"Attr1"], @"Attr1");
+        XCTAssertEqual([[event.allMetrics objectForKey:@"Mettr1"] intValue], 1);
+        return nil;
+    }] waitUntilFinished];
+
+    [[[eventRecorder getDirtyEvents] continueWithBlock:^id(AWSTask *task) {
+        XCTAssertNil(task.error);
+        NSSet *eventTypes = [NSSet setWithArray:[task.result valueForKey:@"eventType"]];
+        XCTAssertEqualObjects(eventTypes, ([NSSet setWithObjects:@"LEGACY_INVALID_EVENT", @"LEGACY_DIRTY_EVENT", nil]));
+        return nil;
+    }] waitUntilFinished];
+
+    [[eventRecorder removeAllEvents] waitUntilFinished];
+    [[eventRecorder removeAllDirtyEvents] waitUntilFinished];
+}
+
 @end
 
 #endif
@@ -0,0 +1,146 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSPinpointTargetingService.h"
+#import "AWSBenchmark.h"
+#import "TestHTTPServer.h"
+
+static NSString *const AWSPinpointBenchmarkTestsKey = @"AWSPinpointBenchmarkTests";
+static NSString *const AWSPinpointBenchmarkApplicationId = @"0123456789abcdef0123456789abcdef";
+static NSString *const AWSPinpointBenchmarkEndpointId = @"benchmark-endpoint";
+static const NSUInteger AWSPinpointBenchmarkEventsPerRequest = 50;
+static const NSUInteger AWSPinpointBenchmarkWarmUpCount = 10;
+static const NSUInteger AWSPinpointBenchmarkOperationCount = 200;
+
+@interface AWSPinpointBenchmarkTests : XCTestCase
+
+@property (nonatomic, strong) TestHTTPServer *server;
+@property (nonatomic, strong) AWSPinpointTargeting *targeting;
+
+@end
+
+@implementation AWSPinpointBenchmarkTests
+
++ (XCTestSuite *)defaultTestSuite {
+    // Benchmarks are opt-in; see AWSBenchmark.
+    return [AWSBenchmark isEnabled] ? [super defaultTestSuite] : [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+}
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestHTTPServer new];
+    XCTAssertTrue([self.server start]);
+    self.server.requestHandler = ^TestHTTPServerResponse *(TestHTTPServerRequest *request) {
+        return [AWSPinpointBenchmarkTests responseToPutEventsRequest:request];
+    };
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceMobileTargeting
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSPinpointTargeting registerPinpointTargetingWithConfiguration:configuration forKey:AWSPinpointBenchmarkTestsKey];
+    self.targeting = [AWSPinpointTargeting PinpointTargetingForKey:AWSPinpointBenchmarkTestsKey];
+}
+
+- (void)tearDown {
+    [AWSPinpointTargeting removePinpointTargetingForKey:AWSPinpointBenchmarkTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+// Accepts the endpoint and every event of a PutEvents request, the way Pinpoint does.
++ (TestHTTPServerResponse *)responseToPutEventsRequest:(TestHTTPServerRequest *)request {
+    NSString *path = [NSString stringWithFormat:@"/v1/apps/%@/events", AWSPinpointBenchmarkApplicationId];
+    NSDictionary *input = [NSJSONSerialization JSONObjectWithData:request.body options:0 error:nil];
+    if (![request.method isEqualToString:@"POST"] || ![request.path isEqualToString:path] || !input[@"BatchItem"]) {
+        return [TestHTTPServerResponse responseWithStatusCode:400 headers:nil body:nil];
+    }
+
+    NSDictionary *accepted = @{@"StatusCode" : @202, @"Message" : @"Accepted"};
+    NSMutableDictionary *results = [NSMutableDictionary new];
+    [input[@"BatchItem"] enumerateKeysAndObjectsUsingBlock:^(NSString *endpointId, NSDictionary *batch, BOOL *stop) {
+        NSMutableDictionary *eventsItemResponse = [NSMutableDictionary new];
+        for (NSString *eventId in batch[@"Events"]) {
+            eventsItemResponse[eventId] = accepted;
+        }
+        results[endpointId] = @{@"EndpointItemResponse" : accepted,
+                                @"EventsItemResponse" : eventsItemResponse};
+    }];
+    NSData *body = [NSJSONSerialization dataWithJSONObject:@{@"Results" : results} options:0 error:nil];
+    return [TestHTTPServerResponse responseWithStatusCode:202
+                                                  headers:@{@"Content-Type" : @"application/json"}
+                                                     body:body];
+}
+
+- (AWSPinpointTargetingEventsRequest *)eventsRequest {
+    AWSPinpointTargetingPublicEndpoint *endpoint = [AWSPinpointTargetingPublicEndpoint new];
+    endpoint.channelType = AWSPinpointTargetingChannelTypeApns;
+    endpoint.address = @"0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+    endpoint.optOut = @"NONE";
+
+    NSMutableDictionary<NSString *, AWSPinpointTargetingEvent *> *events = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < AWSPinpointBenchmarkEventsPerRequest; i++) {
+        AWSPinpointTargetingEvent *event = [AWSPinpointTargetingEvent new];
+        event.eventType = @"_session.start";
+        event.timestamp = @"2020-01-01T00:00:00.000Z";
+        event.appPackageName = @"com.amazonaws.benchmark";
+        event.appTitle = @"Benchmark";
+        event.appVersionCode = @"1";
+        event.sdkName = @"aws-sdk-iOS";
+        event.clientSdkVersion = @"2.13.0";
+        event.attributes = @{@"screen" : @"home", @"campaign" : @"benchmark"};
+        event.metrics = @{@"duration" : @(i * 10)};
+        AWSPinpointTargetingSession *session = [AWSPinpointTargetingSession new];
+        session.identifier = [NSString stringWithFormat:@"session-%lu", (unsigned long)i];
+        session.startTimestamp = @"2020-01-01T00:00:00.000Z";
+        event.session = session;
+        events[[NSString stringWithFormat:@"event-%lu", (unsigned long)i]] = event;
+    }
+
+    AWSPinpointTargetingEventsBatch *batch = [AWSPinpointTargetingEventsBatch new];
+    batch.endpoint = endpoint;
+    batch.events = events;
+    AWSPinpointTargetingEventsRequest *eventsRequest = [AWSPinpointTargetingEventsRequest new];
+    eventsRequest.batchItem = @{AWSPinpointBenchmarkEndpointId : batch};
+    return eventsRequest;
+}
+
+- (void)testPutEventsBenchmark {
+    AWSPinpointTargetingEventsRequest *eventsRequest = [self eventsRequest];
+
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"PinpointPutEvents"
+                                                     warmUpCount:AWSPinpointBenchmarkWarmUpCount
+                                                  operationCount:AWSPinpointBenchmarkOperationCount
+                                                       operation:^BOOL(NSUInteger index) {
+        AWSPinpointTargetingPutEventsRequest *request = [AWSPinpointTargetingPutEventsRequest new];
+        request.applicationId = AWSPinpointBenchmarkApplicationId;
+        request.eventsRequest = eventsRequest;
+        AWSTask<AWSPinpointTargetingPutEventsResponse *> *task = [self.targeting putEvents:request];
+        [task waitUntilFinished];
+        AWSPinpointTargetingItemResponse *itemResponse = task.result.eventsResponse.results[AWSPinpointBenchmarkEndpointId];
+        return !task.error && [itemResponse.eventsItemResponse count] == AWSPinpointBenchmarkEventsPerRequest;
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+@end
@@ -187,6 +187,13 @@ typedef NS_ENUM(NSInteger, AWSS3PresignedURLErrorType) {
  */
 + (void)removeS3PreSignedURLBuilderForKey:(NSString *)key;
 
+/**
+ The maximum number of pre-signed URLs the builder keeps for reuse. The default is `0`, which disables the cache.
+
+ While the cache is enabled, a URL is signed to expire at the end of the five minute interval its `expires` date falls in, and the same URL is returned for later requests with the same bucket, key, HTTP method, headers, parameters and expiry interval until the credentials change. The least recently used URLs are evicted once the limit is reached.
+ */
+@property (nonatomic, assign) NSUInteger preSignedURLCacheCountLimit;
+
 /**
  Build a time-limited pre-signed URL to get object from S3, return nil if build process failed.
 
@@ -196,6 +203,15 @@ typedef NS_ENUM(NSInteger, AWSS3PresignedURLErrorType) {
  */
 - (AWSTask<NSURL *> *)getPreSignedURL:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest;
 
+/**
+ Build time-limited pre-signed URLs for several requests at once. The credentials are resolved and the signing key is derived once for the whole batch, which is considerably cheaper than calling `- getPreSignedURL:` for each request.
+
+ @param getPreSignedURLRequests The AWSS3GetPreSignedURLRequests that define the parameters of each URL.
+ @return The pre-signed NSURLs, in the same order as the requests. If any request is invalid, the task fails with the error of the first invalid request.
+ @see AWSS3GetPreSignedURLRequest
+ */
+- (AWSTask<NSArray<NSURL *> *> *)getPreSignedURLs:(NSArray<AWSS3GetPreSignedURLRequest *> *)getPreSignedURLRequests;
+
 @end
 
 /** The GetPreSignedURLRequest contains the parameters used to create
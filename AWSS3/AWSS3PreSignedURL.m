@@ -28,9 +28,132 @@ static NSString *const AWSS3PreSignedURLBuilderAcceleratedEndpoint = @"s3-accele
 static NSString *const AWSInfoS3PreSignedURLBuilder = @"S3PreSignedURLBuilder";
 static NSString *const AWSS3PreSignedURLBuilderSDKVersion = @"2.24.0";
 
+static const NSTimeInterval AWSS3PreSignedURLMaximumExpireDuration = 604800;
+// Requests whose expires dates fall in the same interval share a cached URL.
+static const NSTimeInterval AWSS3PreSignedURLCacheExpiryInterval = 5 * 60;
+
+@interface AWSS3PreSignedURLCacheEntry : NSObject
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) NSURL *URL;
+@property (nonatomic, strong) AWSS3PreSignedURLCacheEntry *next;
+@property (nonatomic, weak) AWSS3PreSignedURLCacheEntry *previous;
+
+@end
+
+@implementation AWSS3PreSignedURLCacheEntry
+
+@end
+
+/**
+ A least recently used cache of presigned URLs. Entries are kept in a doubly linked list ordered from the most to the
+ least recently used, so lookups, insertions and evictions are all constant time.
+ */
+@interface AWSS3PreSignedURLCache : NSObject
+
+@property (nonatomic, assign) NSUInteger countLimit;
+
+- (NSURL *)URLForKey:(NSString *)key;
+- (void)setURL:(NSURL *)URL forKey:(NSString *)key;
+
+@end
+
+@implementation AWSS3PreSignedURLCache {
+    NSUInteger _countLimit;
+    NSMutableDictionary<NSString *, AWSS3PreSignedURLCacheEntry *> *_entries;
+    AWSS3PreSignedURLCacheEntry *_head;
+    AWSS3PreSignedURLCacheEntry *_tail;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _entries = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSUInteger)countLimit {
+    @synchronized(self) {
+        return _countLimit;
+    }
+}
+
+- (void)setCountLimit:(NSUInteger)countLimit {
+    @synchronized(self) {
+        _countLimit = countLimit;
+        [self trimToCountLimit];
+    }
+}
+
+- (NSURL *)URLForKey:(NSString *)key {
+    @synchronized(self) {
+        AWSS3PreSignedURLCacheEntry *entry = _entries[key];
+        if (entry) {
+            [self unlinkEntry:entry];
+            [self linkEntryAtHead:entry];
+        }
+        return entry.URL;
+    }
+}
+
+- (void)setURL:(NSURL *)URL forKey:(NSString *)key {
+    @synchronized(self) {
+        if (_countLimit == 0) {
+            return;
+        }
+
+        AWSS3PreSignedURLCacheEntry *entry = _entries[key];
+        if (entry) {
+            [self unlinkEntry:entry];
+        } else {
+            entry = [AWSS3PreSignedURLCacheEntry new];
+            entry.key = key;
+            _entries[key] = entry;
+        }
+        entry.URL = URL;
+        [self linkEntryAtHead:entry];
+        [self trimToCountLimit];
+    }
+}
+
+- (void)trimToCountLimit {
+    while ([_entries count] > _countLimit) {
+        AWSS3PreSignedURLCacheEntry *entry = _tail;
+        [self unlinkEntry:entry];
+        [_entries removeObjectForKey:entry.key];
+    }
+}
+
+- (void)linkEntryAtHead:(AWSS3PreSignedURLCacheEntry *)entry {
+    entry.next = _head;
+    _head.previous = entry;
+    _head = entry;
+    if (!_tail) {
+        _tail = entry;
+    }
+}
+
+- (void)unlinkEntry:(AWSS3PreSignedURLCacheEntry *)entry {
+    if (entry.previous) {
+        entry.previous.next = entry.next;
+    } else {
+        _head = entry.next;
+    }
+    if (entry.next) {
+        entry.next.previous = entry.previous;
+    } else {
+        _tail = entry.previous;
+    }
+    entry.next = nil;
+    entry.previous = nil;
+}
+
+@end
+
 @interface AWSS3PreSignedURLBuilder()
 
 @property (nonatomic, strong) AWSServiceConfiguration *configuration;
+@property (nonatomic, strong) AWSS3PreSignedURLCache *preSignedURLCache;
 
 @end
 
@@ -138,6 +261,7 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration {
     if (self = [super init]) {
         _configuration = [configuration copy];
+        _preSignedURLCache = [AWSS3PreSignedURLCache new];
         
         if(!configuration.endpoint){
             _configuration.endpoint = [[AWSEndpoint alloc] initWithRegion:_configuration.regionType
@@ -152,167 +276,278 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     return self;
 }
 
+- (NSUInteger)preSignedURLCacheCountLimit {
+    return self.preSignedURLCache.countLimit;
+}
+
+- (void)setPreSignedURLCacheCountLimit:(NSUInteger)preSignedURLCacheCountLimit {
+    self.preSignedURLCache.countLimit = preSignedURLCacheCountLimit;
+}
+
 - (AWSTask<NSURL *> *)getPreSignedURL:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest {
+    return [[self getPreSignedURLs:@[getPreSignedURLRequest]] continueWithSuccessBlock:^id _Nullable(AWSTask<NSArray<NSURL *> *> * _Nonnull task) {
+        return [task.result firstObject];
+    }];
+}
+
+- (AWSTask<NSArray<NSURL *> *> *)getPreSignedURLs:(NSArray<AWSS3GetPreSignedURLRequest *> *)getPreSignedURLRequests {
+    if ([getPreSignedURLRequests count] == 0) {
+        return [AWSTask taskWithResult:@[]];
+    }
+
+    id<AWSCredentialsProvider>credentialsProvider = self.configuration.credentialsProvider;
+
+    return [[[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
+        NSTimeInterval minimumCredentialsExpirationInterval = 0;
+        for (AWSS3GetPreSignedURLRequest *getPreSignedURLRequest in getPreSignedURLRequests) {
+            NSError *error = [self validateGetPreSignedURLRequest:getPreSignedURLRequest];
+            if (error) {
+                return [AWSTask taskWithError:error];
+            }
+            minimumCredentialsExpirationInterval = MAX(minimumCredentialsExpirationInterval, getPreSignedURLRequest.minimumCredentialsExpirationInterval);
+        }
+
+        //credentials are resolved once and shared by every URL in the batch.
+        return [[credentialsProvider credentials] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+            AWSCredentials *credentials = task.result;
+            if ([credentials.expiration timeIntervalSinceNow] < minimumCredentialsExpirationInterval) {
+                [credentialsProvider invalidateCachedTemporaryCredentials];
+                return [credentialsProvider credentials];
+            }
+
+            return task;
+        }];
+    }] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
+        if (!task.result) {
+            return [AWSTask taskWithError:[NSError errorWithDomain:AWSCognitoCredentialsProviderErrorDomain
+                                                              code:AWSCognitoCredentialsProviderErrorUnknown
+                                                          userInfo:@{NSLocalizedDescriptionKey: @"Credentials result unexpectedly nil generating presigned URL"}]];
+        }
+
+        return [self preSignedURLsForRequests:getPreSignedURLRequests
+                                  credentials:task.result];
+    }];
+}
+
+- (NSError *)validateGetPreSignedURLRequest:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest {
     //retrive parameters from request;
     NSString *bucketName = getPreSignedURLRequest.bucket;
     NSString *keyName = getPreSignedURLRequest.key;
     AWSHTTPMethod httpMethod = getPreSignedURLRequest.HTTPMethod;
-    AWSServiceConfiguration *configuration = self.configuration;
-    id<AWSCredentialsProvider>credentialsProvider = configuration.credentialsProvider;
+    id<AWSCredentialsProvider>credentialsProvider = self.configuration.credentialsProvider;
     AWSEndpoint *endpoint = self.configuration.endpoint;
     BOOL isAccelerateModeEnabled = getPreSignedURLRequest.isAccelerateModeEnabled;
-
     NSDate *expires = getPreSignedURLRequest.expires;
 
-    return [[[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
-
-        //validate additionalParams
-        for (id key in getPreSignedURLRequest.requestParameters) {
-            id value = getPreSignedURLRequest.requestParameters[key];
-            if (![key isKindOfClass:[NSString class]]
-                || ![value isKindOfClass:[NSString class]]) {
-                return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                                  code:AWSS3PresignedURLErrorInvalidRequestParameters
-                                                              userInfo:@{NSLocalizedDescriptionKey: @"requestParameters can only contain key-value pairs in NSString type."}]
-                        ];
-            }
+    //validate additionalParams
+    for (id key in getPreSignedURLRequest.requestParameters) {
+        id value = getPreSignedURLRequest.requestParameters[key];
+        if (![key isKindOfClass:[NSString class]]
+            || ![value isKindOfClass:[NSString class]]) {
+            return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                       code:AWSS3PresignedURLErrorInvalidRequestParameters
+                                   userInfo:@{NSLocalizedDescriptionKey: @"requestParameters can only contain key-value pairs in NSString type."}];
         }
+    }
 
-        //validate endpoint
-        if (!endpoint) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorEndpointIsNil
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"endpoint in configuration can not be nil"}]
-                    ];
-        } else if (endpoint.serviceType != AWSServiceS3) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorInvalidServiceType
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"Invalid serviceType: serviceType in endpoint must be AWSServiceS3"}]
-                    ];
-        }
+    //validate endpoint
+    if (!endpoint) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorEndpointIsNil
+                               userInfo:@{NSLocalizedDescriptionKey: @"endpoint in configuration can not be nil"}];
+    } else if (endpoint.serviceType != AWSServiceS3) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorInvalidServiceType
+                               userInfo:@{NSLocalizedDescriptionKey: @"Invalid serviceType: serviceType in endpoint must be AWSServiceS3"}];
+    }
 
-        //validate credentialsProvider
-        if (!credentialsProvider) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PreSignedURLErrorCredentialProviderIsNil
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"credentialsProvider in configuration can not be nil"}]
-                    ];
-        }
+    //validate credentialsProvider
+    if (!credentialsProvider) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PreSignedURLErrorCredentialProviderIsNil
+                               userInfo:@{NSLocalizedDescriptionKey: @"credentialsProvider in configuration can not be nil"}];
+    }
 
-        //validate bucketName
-        if (!bucketName || [bucketName length] < 1) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorBucketNameIsNil
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"S3 bucket can not be nil or empty"}]];
-        }
+    //validate bucketName
+    if (!bucketName || [bucketName length] < 1) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorBucketNameIsNil
+                               userInfo:@{NSLocalizedDescriptionKey: @"S3 bucket can not be nil or empty"}];
+    }
 
-        // Validates the buket name for transfer acceleration.
-        if (isAccelerateModeEnabled && ![bucketName aws_isVirtualHostedStyleCompliant]) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorInvalidBucketNameForAccelerateModeEnabled
-                                                          userInfo:@{
-                                                                     NSLocalizedDescriptionKey: @"For your bucket to work with transfer acceleration, the bucket name must conform to DNS naming requirements and must not contain periods."}]];
-        }
+    // Validates the buket name for transfer acceleration.
+    if (isAccelerateModeEnabled && ![bucketName aws_isVirtualHostedStyleCompliant]) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorInvalidBucketNameForAccelerateModeEnabled
+                               userInfo:@{
+                                          NSLocalizedDescriptionKey: @"For your bucket to work with transfer acceleration, the bucket name must conform to DNS naming requirements and must not contain periods."}];
+    }
 
-        //validate keyName
-        if (!keyName || [keyName length] < 1) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorKeyNameIsNil
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"S3 key can not be nil or empty"}]
-                    ];
+    //validate keyName
+    if (!keyName || [keyName length] < 1) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorKeyNameIsNil
+                               userInfo:@{NSLocalizedDescriptionKey: @"S3 key can not be nil or empty"}];
+    }
+
+    //validate expires Date
+    if (!expires) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorInvalidExpiresDate
+                               userInfo:@{NSLocalizedDescriptionKey: @"expires can not be nil"}];
+    } else if ([expires timeIntervalSinceNow] < 0.0) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorInvalidExpiresDate
+                               userInfo:@{NSLocalizedDescriptionKey: @"expires can not be in past"}];
+    } else if ((int32_t)[expires timeIntervalSinceNow] > AWSS3PreSignedURLMaximumExpireDuration) {
+        return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                   code:AWSS3PresignedURLErrorInvalidExpiresDate
+                               userInfo:@{NSLocalizedDescriptionKey: @"Invalid ExpiresDate, must be less than seven days in future"}];
+    }
+
+    //validate httpMethod
+    switch (httpMethod) {
+        case AWSHTTPMethodGET:
+        case AWSHTTPMethodPUT:
+        case AWSHTTPMethodHEAD:
+        case AWSHTTPMethodDELETE:
+            break;
+        default:
+            return [NSError errorWithDomain:AWSS3PresignedURLErrorDomain
+                                       code:AWSS3PresignedURLErrorUnsupportedHTTPVerbs
+                                   userInfo:@{NSLocalizedDescriptionKey: @"unsupported HTTP Method, currently only support AWSHTTPMethodGET, AWSHTTPMethodPUT, AWSHTTPMethodHEAD, AWSHTTPMethodDELETE"}];
+    }
+
+    return nil;
+}
+
+- (AWSTask<NSArray<NSURL *> *> *)preSignedURLsForRequests:(NSArray<AWSS3GetPreSignedURLRequest *> *)getPreSignedURLRequests
+                                               credentials:(AWSCredentials *)credentials {
+    AWSEndpoint *endpoint = self.configuration.endpoint;
+    NSDate *currentDate = [NSDate aws_clockSkewFixedDate];
+
+    //the derived key only depends on the credentials and the signing date, so the batch shares one.
+    NSData *signingKey = [AWSSignatureV4Signer getV4DerivedKey:credentials.secretKey
+                                                          date:[currentDate aws_stringValue:AWSDateShortDateFormat1]
+                                                        region:endpoint.regionName
+                                                       service:endpoint.serviceName];
+
+    NSMutableArray<NSURL *> *preSignedURLs = [NSMutableArray arrayWithCapacity:[getPreSignedURLRequests count]];
+    for (AWSS3GetPreSignedURLRequest *getPreSignedURLRequest in getPreSignedURLRequests) {
+        NSURL *unsignedURL = [self unsignedURLForRequest:getPreSignedURLRequest];
+        NSTimeInterval expireDuration = [getPreSignedURLRequest.expires timeIntervalSinceNow];
+
+        //cached URLs are signed to expire at the end of the expiry interval, so they outlive any request that maps to the same entry.
+        NSString *cacheKey = nil;
+        if (self.preSignedURLCache.countLimit > 0) {
+            NSTimeInterval expiryIntervalEnd = ceil([getPreSignedURLRequest.expires timeIntervalSince1970] / AWSS3PreSignedURLCacheExpiryInterval) * AWSS3PreSignedURLCacheExpiryInterval;
+            NSTimeInterval expiryIntervalDuration = expiryIntervalEnd - [[NSDate date] timeIntervalSince1970];
+            if (expiryIntervalDuration <= AWSS3PreSignedURLMaximumExpireDuration) {
+                cacheKey = [self cacheKeyForRequest:getPreSignedURLRequest
+                                        credentials:credentials
+                                  expiryIntervalEnd:expiryIntervalEnd];
+                NSURL *cachedURL = [self.preSignedURLCache URLForKey:cacheKey];
+                if (cachedURL) {
+                    [preSignedURLs addObject:cachedURL];
+                    continue;
+                }
+                expireDuration = expiryIntervalDuration;
+            }
         }
 
-        //validate expires Date
-        if (!expires) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorInvalidExpiresDate
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"expires can not be nil"}]
-                    ];
-        }else if ([expires timeIntervalSinceNow] < 0.0) {
+        NSMutableURLRequest *urlRequest = [[NSMutableURLRequest alloc] initWithURL:unsignedURL];
+        urlRequest.HTTPMethod = [NSString aws_stringWithHTTPMethod:getPreSignedURLRequest.HTTPMethod];
+        urlRequest.allHTTPHeaderFields = getPreSignedURLRequest.requestHeaders;
+
+        NSURL *preSignedURL = [AWSSignatureV4Signer sigV4SignedURLWithRequest:urlRequest
+                                                                  credentials:credentials
+                                                                   signingKey:signingKey
+                                                                   regionName:endpoint.regionName
+                                                                  serviceName:endpoint.serviceName
+                                                                         date:currentDate
+                                                               expireDuration:(int32_t)expireDuration
+                                                                     signBody:NO
+                                                             signSessionToken:YES];
+        if (!preSignedURL) {
             return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorInvalidExpiresDate
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"expires can not be in past"}]
-                    ];
+                                                              code:AWSS3PreSignedURLErrorInternalError
+                                                          userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Failed to sign the URL for key %@", getPreSignedURLRequest.key]}]];
         }
 
-        //validate httpMethod
-        switch (httpMethod) {
-            case AWSHTTPMethodGET:
-            case AWSHTTPMethodPUT:
-            case AWSHTTPMethodHEAD:
-            case AWSHTTPMethodDELETE:
-                break;
-            default:
-                return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                                  code:AWSS3PresignedURLErrorUnsupportedHTTPVerbs
-                                                              userInfo:@{NSLocalizedDescriptionKey: @"unsupported HTTP Method, currently only support AWSHTTPMethodGET, AWSHTTPMethodPUT, AWSHTTPMethodHEAD, AWSHTTPMethodDELETE"}]
-                        ];
-                break;
+        if (cacheKey) {
+            [self.preSignedURLCache setURL:preSignedURL forKey:cacheKey];
         }
+        [preSignedURLs addObject:preSignedURL];
+    }
 
-        return [[credentialsProvider credentials] continueWithSuccessBlock:^id _Nullable(AWSTask<AWSCredentials *> * _Nonnull task) {
-            AWSCredentials *credentials = task.result;
-            if ([credentials.expiration timeIntervalSinceNow] < getPreSignedURLRequest.minimumCredentialsExpirationInterval) {
-                [credentialsProvider invalidateCachedTemporaryCredentials];
-            }
+    return [AWSTask taskWithResult:preSignedURLs];
+}
 
-            return credentialsProvider;
-        }];
-    }] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        //generate baseURL String (use virtualHostStyle if possible)
-        //base url is not url encoded.
-        NSString *keyPath = nil;
-        if (bucketName == nil || [bucketName aws_isVirtualHostedStyleCompliant]) {
-            keyPath = (keyName == nil ? @"" : [NSString stringWithFormat:@"%@", [keyName aws_stringWithURLEncodingPath]]);
-        } else {
-            keyPath = (keyName == nil ? [NSString stringWithFormat:@"%@", bucketName] : [NSString stringWithFormat:@"%@/%@", bucketName, [keyName aws_stringWithURLEncodingPath]]);
-        }
+- (NSURL *)unsignedURLForRequest:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest {
+    NSString *bucketName = getPreSignedURLRequest.bucket;
+    NSString *keyName = getPreSignedURLRequest.key;
+    AWSEndpoint *endpoint = self.configuration.endpoint;
 
-        //generate correct hostName (use virtualHostStyle if possible)
-        NSString *host = nil;
-        if (!self.configuration.localTestingEnabled &&
-            bucketName &&
-            [bucketName aws_isVirtualHostedStyleCompliant]) {
-            if (isAccelerateModeEnabled) {
-                host = [NSString stringWithFormat:@"%@.%@", bucketName, AWSS3PreSignedURLBuilderAcceleratedEndpoint];
-            } else {
-                host = [NSString stringWithFormat:@"%@.%@", bucketName, endpoint.hostName];
-            }
+    //generate baseURL String (use virtualHostStyle if possible)
+    //base url is not url encoded.
+    NSString *keyPath = nil;
+    if ([bucketName aws_isVirtualHostedStyleCompliant]) {
+        keyPath = [keyName aws_stringWithURLEncodingPath];
+    } else {
+        keyPath = [NSString stringWithFormat:@"%@/%@", bucketName, [keyName aws_stringWithURLEncodingPath]];
+    }
+
+    //generate correct hostName (use virtualHostStyle if possible)
+    NSString *host = nil;
+    if (!self.configuration.localTestingEnabled &&
+        [bucketName aws_isVirtualHostedStyleCompliant]) {
+        if (getPreSignedURLRequest.isAccelerateModeEnabled) {
+            host = [NSString stringWithFormat:@"%@.%@", bucketName, AWSS3PreSignedURLBuilderAcceleratedEndpoint];
         } else {
-            host = endpoint.hostName;
+            host = [NSString stringWithFormat:@"%@.%@", bucketName, endpoint.hostName];
         }
-        [getPreSignedURLRequest setValue:host forRequestHeader:@"host"];
-        
-        //If this is a presigned request for a multipart upload, set the uploadID and partNumber on the request.
-        if (getPreSignedURLRequest.uploadID
-            && getPreSignedURLRequest.partNumber) {
-            
-            [getPreSignedURLRequest setValue:getPreSignedURLRequest.uploadID
-                         forRequestParameter:@"uploadId"];
-            
-            [getPreSignedURLRequest setValue:[NSString stringWithFormat:@"%@", getPreSignedURLRequest.partNumber]
-                         forRequestParameter:@"partNumber"];
-        }
-        NSString *portNumber = endpoint.portNumber != nil ? [NSString stringWithFormat:@":%@", endpoint.portNumber.stringValue]: @"";
-        AWSEndpoint *newEndpoint = [[AWSEndpoint alloc]initWithRegion:configuration.regionType service:AWSServiceS3 URL:[NSURL URLWithString:[NSString stringWithFormat:@"%@://%@%@", endpoint.useUnsafeURL?@"http":@"https", host, portNumber]]];
-        
-        int32_t expireDuration = [expires timeIntervalSinceNow];
-        if (expireDuration > 604800) {
-            return [AWSTask taskWithError:[NSError errorWithDomain:AWSS3PresignedURLErrorDomain
-                                                              code:AWSS3PresignedURLErrorInvalidExpiresDate
-                                                          userInfo:@{NSLocalizedDescriptionKey: @"Invalid ExpiresDate, must be less than seven days in future"}]
-                    ];
+    } else {
+        host = endpoint.hostName;
+    }
+    [getPreSignedURLRequest setValue:host forRequestHeader:@"host"];
+
+    //If this is a presigned request for a multipart upload, set the uploadID and partNumber on the request.
+    if (getPreSignedURLRequest.uploadID
+        && getPreSignedURLRequest.partNumber) {
+
+        [getPreSignedURLRequest setValue:getPreSignedURLRequest.uploadID
+                     forRequestParameter:@"uploadId"];
+
+        [getPreSignedURLRequest setValue:[NSString stringWithFormat:@"%@", getPreSignedURLRequest.partNumber]
+                     forRequestParameter:@"partNumber"];
+    }
+
+    NSString *portNumber = endpoint.portNumber != nil ? [NSString stringWithFormat:@":%@", endpoint.portNumber.stringValue]: @"";
+    NSURLComponents *urlComponents = [NSURLComponents componentsWithString:[NSString stringWithFormat:@"%@://%@%@", endpoint.useUnsafeURL?@"http":@"https", host, portNumber]];
+    urlComponents.percentEncodedPath = [NSString stringWithFormat:@"/%@", keyPath];
+    urlComponents.queryItems = [AWSNetworkingHelpers queryItemsFromDictionary:getPreSignedURLRequest.requestParameters];
+
+    return urlComponents.URL;
+}
+
+- (NSString *)cacheKeyForRequest:(AWSS3GetPreSignedURLRequest *)getPreSignedURLRequest
+                     credentials:(AWSCredentials *)credentials
+               expiryIntervalEnd:(NSTimeInterval)expiryIntervalEnd {
+    //the host header covers the addressing style and accelerate mode.
+    NSMutableString *cacheKey = [NSMutableString stringWithFormat:@"%ld\n%@\n%@\n%@\n%.0f",
+                                 (long)getPreSignedURLRequest.HTTPMethod,
+                                 getPreSignedURLRequest.bucket,
+                                 getPreSignedURLRequest.key,
+                                 credentials.accessKey,
+                                 expiryIntervalEnd];
+    for (NSDictionary<NSString *, NSString *> *dictionary in @[getPreSignedURLRequest.requestHeaders, getPreSignedURLRequest.requestParameters]) {
+        [cacheKey appendString:@"\n"];
+        for (NSString *name in [[dictionary allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+            [cacheKey appendFormat:@"%@=%@&", name, dictionary[name]];
         }
+    }
 
-        return [AWSSignatureV4Signer  generateQueryStringForSignatureV4WithCredentialProvider:task.result
-                                                                                   httpMethod:httpMethod
-                                                                               expireDuration:expireDuration
-                                                                                     endpoint:newEndpoint
-                                                                                      keyPath:keyPath
-                                                                               requestHeaders:getPreSignedURLRequest.requestHeaders
-                                                                            requestParameters:getPreSignedURLRequest.requestParameters
-                                                                                     signBody:NO];
-    }];
+    return cacheKey;
 }
 
 @end
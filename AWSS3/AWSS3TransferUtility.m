@@ -188,6 +188,9 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 + (void) deleteTransferRequestFromDB:(NSString *) transferID
                          databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
++ (void) deleteTransferRequestsFromDB:(NSArray<NSString *> *) transferIDs
+                        databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
 + (void) deleteTransferRequestFromDB:(NSString *) transferID
                       taskIdentifier: (NSUInteger) taskIdentifier
                        databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
@@ -209,9 +212,9 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 + (void) insertMultiPartUploadRequestInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
                             databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
-+ (void) insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
-                                         subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
-                                   databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
++ (void) insertMultiPartUploadRequestSubTasksInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
+                                         subTasks:(NSArray<AWSS3TransferUtilityUploadSubTask *> *) subTasks
+                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
 + (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
                                  databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
@@ -521,6 +524,9 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
     //Get All Tasks from DB
     NSMutableArray *tasks = [AWSS3TransferUtilityDatabaseHelper getTransferTaskDataFromDB:_sessionIdentifier databaseQueue:_databaseQueue];
     
+    //Records that are no longer needed are collected here and removed from the DB in a single transaction.
+    NSMutableSet<NSString *> *transferIDsToDelete = [NSMutableSet new];
+    
     //Iterate through the tasks and populate transferRequests and Multipart dictionary.
     for( NSMutableDictionary *task in tasks ) {
         NSString *transferType = [task objectForKey:@"transfer_type"];
@@ -532,7 +538,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             //If task is completed, no more processing is required.
             if (transferUtilityUploadTask.status == AWSS3TransferUtilityTransferStatusCompleted ) {
                 [self.completedTaskDictionary setObject:transferUtilityUploadTask forKey:transferUtilityUploadTask.transferID];
-                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:transferUtilityUploadTask.transferID databaseQueue:self->_databaseQueue];
+                [transferIDsToDelete addObject:transferUtilityUploadTask.transferID];
                 continue;
             }
             //Lodge in temporary Dictionary
@@ -545,7 +551,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             //If task is completed, no more processing is required.
             if (transferUtilityDownloadTask.status == AWSS3TransferUtilityTransferStatusCompleted ) {
                 [self.completedTaskDictionary setObject:transferUtilityDownloadTask forKey:transferUtilityDownloadTask.transferID];
-                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:transferUtilityDownloadTask.transferID databaseQueue:self->_databaseQueue];
+                [transferIDsToDelete addObject:transferUtilityDownloadTask.transferID];
                 continue;
             }
             //Lodge in temporary Dictionary for linking
@@ -561,7 +567,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
                 transferUtilityMultiPartUploadTask.status == AWSS3TransferUtilityTransferStatusCancelled ||
                 transferUtilityMultiPartUploadTask.status == AWSS3TransferUtilityTransferStatusError) {
                 [self.completedTaskDictionary setObject:transferUtilityMultiPartUploadTask forKey:transferUtilityMultiPartUploadTask.transferID];
-                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:transferUtilityMultiPartUploadTask.transferID databaseQueue:self->_databaseQueue];
+                [transferIDsToDelete addObject:transferUtilityMultiPartUploadTask.transferID];
                 continue;
             }
             
@@ -577,7 +583,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             AWSS3TransferUtilityMultiPartUploadTask *multiPartUploadTask = [tempMultiPartMasterTaskDictionary objectForKey:subTask.uploadID];
             if ( !multiPartUploadTask ) {
                 //Couldn't find the multipart upload master record. Must be an orphan part record. Clean up the DB and continue.
-                [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestFromDB:subTask.transferID databaseQueue:self->_databaseQueue];
+                [transferIDsToDelete addObject:subTask.transferID];
                 continue;
             }
             //Check if the subTask is is already completed. If it is, add it to the completed parts list, update the progress object and go to the next iteration of the loop
@@ -590,6 +596,8 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             [tempTransferDictionary setObject:subTask forKey:@(sessionTaskID)];
         }
     }
+    
+    [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestsFromDB:[transferIDsToDelete allObjects] databaseQueue:self.databaseQueue];
 }
 
 - (void) linkTransfersToNSURLSession:(NSMutableDictionary *) tempMultiPartMasterTaskDictionary
@@ -1358,7 +1366,8 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         
         AWSDDLogInfo(@"Initiated multipart upload on server: %@", output.uploadId);
         AWSDDLogInfo(@"Concurrency Limit is %@", self.transferUtilityConfiguration.multiPartConcurrencyLimit);
-        //Loop through the file and upload the parts one by one
+        //Loop through the file and create the parts
+        NSMutableArray<AWSS3TransferUtilityUploadSubTask *> *subTasks = [NSMutableArray arrayWithCapacity:partCount];
         for (int32_t i = 1; i <= partCount ; i++) {
             NSUInteger dataLength = AWSS3TransferUtilityMultiPartSize;
             if (i == partCount) {
@@ -1374,10 +1383,15 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             subTask.responseData = @"";
             subTask.file = @"";
             subTask.eTag = @"";
-            
-            //Save in Database
-            [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTaskInDB:transferUtilityMultiPartUploadTask subTask:subTask databaseQueue:self.databaseQueue];
-            
+            [subTasks addObject:subTask];
+        }
+        
+        //Save all the parts in the Database in a single transaction
+        [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTasksInDB:transferUtilityMultiPartUploadTask subTasks:subTasks databaseQueue:self.databaseQueue];
+        
+        //Loop through the parts and upload them one by one
+        for (AWSS3TransferUtilityUploadSubTask *subTask in subTasks) {
+            NSInteger i = [subTask.partNumber integerValue];
             NSError *subTaskCreationError;
             
             //Move to inProgress or Waiting based on concurrency limit
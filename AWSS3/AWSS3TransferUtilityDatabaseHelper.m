@@ -22,6 +22,14 @@
 NSString *const AWSS3TransferUtilityDatabaseDirectory = @"/com/amazonaws/AWSS3TransferUtility/";
 NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
 
+static NSString *const AWSS3TransferUtiltyInsertIntoAWSTransfer = @"INSERT INTO awstransfer ("
+@"transfer_id,ns_url_session_id, session_task_id, transfer_type, bucket_name, key, part_number, multi_part_id, etag, file, "
+@"temporary_file_created, content_length, status, retry_count, request_headers, request_parameters"
+@") VALUES ("
+@":transfer_id,:ns_url_session_id, :session_task_id, :transfer_type, :bucket_name, :key, :part_number, :multi_part_id, :etag, :file, :temporary_file_created, :content_length, "
+@":status, :retry_count, :request_headers, :request_parameters"
+@")";
+
 @interface AWSS3TransferUtilityTask()
 @property NSString *nsURLSessionID;
 @property NSString *file;
@@ -101,16 +109,30 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     NSString * databasePath = [dbDirPath stringByAppendingString:AWSS3TransferUtilityDatabaseName];
     //Open the database if the directory exists
     AWSDDLogInfo(@"Transfer Utility Database Path: [%@]", databasePath);
-    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue databaseQueueWithPath: databasePath];
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath: databasePath];
     
     if (!databaseQueue) {
         AWSDDLogError(@"Unable to create Database Queue for [%@]", databasePath);
         return nil;
     }
     
+    //Indexes backing the lookups done by recovery and by the per-part updates and deletes.
+    NSArray<NSString *> *const AWSS3TransferUtilityCreateAWSTransferIndexes = @[
+        @"CREATE INDEX IF NOT EXISTS awstransfer_transfer_id_part_number ON awstransfer (transfer_id, part_number)",
+        @"CREATE INDEX IF NOT EXISTS awstransfer_transfer_id_session_task_id ON awstransfer (transfer_id, session_task_id)",
+        @"CREATE INDEX IF NOT EXISTS awstransfer_ns_url_session_id ON awstransfer (ns_url_session_id, transfer_id, part_number)",
+        @"CREATE INDEX IF NOT EXISTS awstransfer_status ON awstransfer (status)"
+    ];
+    
     [databaseQueue inDatabase:^(AWSFMDatabase *db) {
         if (! [db executeUpdate: AWSS3TransferUtilityCreateAWSTransfer]) {
             AWSDDLogError(@"Failed to create awstransfer Database table. [%@]", db.lastError);
+            return;
+        }
+        for (NSString *createIndex in AWSS3TransferUtilityCreateAWSTransferIndexes) {
+            if (![db executeUpdate:createIndex]) {
+                AWSDDLogError(@"Failed to create index on awstransfer Database table. [%@]", db.lastError);
+            }
         }
     }];
     return databaseQueue;
@@ -138,6 +160,31 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     }];
 }
 
+//Delete a set of transfer requests in a single transaction.
++ (void) deleteTransferRequestsFromDB:(NSArray<NSString *> *) transferIDs
+                        databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    if ([transferIDs count] == 0) {
+        return;
+    }
+    NSString *const AWSS3TransferUtilityDeleteTransfer =  @"DELETE FROM awstransfer "
+    @"WHERE transfer_id=:transfer_id";
+    
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (NSString *transferID in transferIDs) {
+            BOOL result = [db executeUpdate: AWSS3TransferUtilityDeleteTransfer
+                    withParameterDictionary:@{
+                                              @"transfer_id": transferID
+                                              }];
+            if (!result) {
+                AWSDDLogError(@"Failed to delete transfer_request [%@] in Database. [%@]", transferID,
+                              db.lastError);
+                *rollback = YES;
+                return;
+            }
+        }
+    }];
+}
+
 //Delete a transfer request given its transfer ID and task Identifier.
 + (void) deleteTransferRequestFromDB:(NSString *) transferID
                       taskIdentifier: (NSUInteger) taskIdentifier
@@ -257,26 +304,45 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                     databaseQueue:databaseQueue];
 }
 
-+ (void) insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
-                                         subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
-                                   databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
-    [AWSS3TransferUtilityDatabaseHelper insertTransferRequestInDB:task.transferID
-                                                   nsURLSessionID:task.nsURLSessionID
-                                                   taskIdentifier:@(subTask.taskIdentifier)
-                                                     transferType:subTask.transferType
-                                                           bucket:task.bucket
-                                                              key:task.key
-                                                       partNumber:subTask.partNumber
-                                                      multiPartID:task.uploadID
-                                                             eTag:@""
-                                                             file:subTask.file
-                                             temporaryFileCreated: YES
-                                                    contentLength:@(subTask.totalBytesExpectedToSend)
-                                                           status:subTask.status
-                                                       retryCount:@(0)
-                                               requestHeadersJSON:[self getJSONRepresentation:task.expression.requestHeaders]
-                                            requestParametersJSON:[self getJSONRepresentation:task.expression.requestParameters]
-                                                    databaseQueue:databaseQueue];
+//Insert the records for all the parts of a multipart upload in a single transaction.
++ (void) insertMultiPartUploadRequestSubTasksInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
+                                         subTasks:(NSArray<AWSS3TransferUtilityUploadSubTask *> *) subTasks
+                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    //Every part shares the headers and parameters of the parent task, so serialize them only once.
+    NSString *requestHeadersJSON = [self getJSONRepresentation:task.expression.requestHeaders];
+    NSString *requestParametersJSON = [self getJSONRepresentation:task.expression.requestParameters];
+    
+    NSMutableArray<NSDictionary *> *parameterDictionaries = [NSMutableArray arrayWithCapacity:[subTasks count]];
+    for (AWSS3TransferUtilityUploadSubTask *subTask in subTasks) {
+        [parameterDictionaries addObject:[self parametersForTransferRequest:task.transferID
+                                                             nsURLSessionID:task.nsURLSessionID
+                                                             taskIdentifier:@(subTask.taskIdentifier)
+                                                               transferType:subTask.transferType
+                                                                     bucket:task.bucket
+                                                                        key:task.key
+                                                                 partNumber:subTask.partNumber
+                                                                multiPartID:task.uploadID
+                                                                       eTag:@""
+                                                                       file:subTask.file
+                                                       temporaryFileCreated:YES
+                                                              contentLength:@(subTask.totalBytesExpectedToSend)
+                                                                     status:subTask.status
+                                                                 retryCount:@(0)
+                                                         requestHeadersJSON:requestHeadersJSON
+                                                      requestParametersJSON:requestParametersJSON]];
+    }
+    
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (NSDictionary *parameterDictionary in parameterDictionaries) {
+            BOOL result = [db executeUpdate: AWSS3TransferUtiltyInsertIntoAWSTransfer
+                    withParameterDictionary:parameterDictionary];
+            if (!result) {
+                AWSDDLogError(@"Failed to save Transfer [%@] part [%@] in awstransfer database table. [%@]", task.transferID, parameterDictionary[@"part_number"], db.lastError);
+                *rollback = YES;
+                return;
+            }
+        }
+    }];
 }
 
 + (void) insertTransferRequestInDB: (NSString *) transferID
@@ -296,39 +362,26 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                 requestHeadersJSON: (NSString *) requestHeadersJSON
              requestParametersJSON: (NSString *) requestParametersJSON
                      databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
-    NSString *const AWSS3TransferUtiltyInsertIntoAWSTransfer = @"INSERT INTO awstransfer ("
-    @"transfer_id,ns_url_session_id, session_task_id, transfer_type, bucket_name, key, part_number, multi_part_id, etag, file, "
-    @"temporary_file_created, content_length, status, retry_count, request_headers, request_parameters"
-    @") VALUES ("
-    @":transfer_id,:ns_url_session_id, :session_task_id, :transfer_type, :bucket_name, :key, :part_number, :multi_part_id, :etag, :file, :temporary_file_created, :content_length, "
-    @":status, :retry_count, :request_headers, :request_parameters"
-    @")";
-    
-    NSNumber *tempFileCreated = [NSNumber numberWithInt:0];
-    if (temporaryFileCreated) {
-        tempFileCreated = [NSNumber numberWithInt:1];
-    }
+    NSDictionary *parameterDictionary = [self parametersForTransferRequest:transferID
+                                                            nsURLSessionID:nsURLSessionID
+                                                            taskIdentifier:taskIdentifier
+                                                              transferType:transferType
+                                                                    bucket:bucket
+                                                                       key:key
+                                                                partNumber:partNumber
+                                                               multiPartID:multiPartID
+                                                                      eTag:eTag
+                                                                      file:file
+                                                      temporaryFileCreated:temporaryFileCreated
+                                                             contentLength:contentLength
+                                                                    status:status
+                                                                retryCount:retryCount
+                                                        requestHeadersJSON:requestHeadersJSON
+                                                     requestParametersJSON:requestParametersJSON];
     
     [databaseQueue inDatabase:^(AWSFMDatabase *db) {
         BOOL result = [db executeUpdate: AWSS3TransferUtiltyInsertIntoAWSTransfer
-                withParameterDictionary:@{
-                                          @"transfer_id": transferID,
-                                          @"ns_url_session_id": nsURLSessionID,
-                                          @"session_task_id":taskIdentifier,
-                                          @"transfer_type": transferType,
-                                          @"bucket_name": bucket,
-                                          @"key": key,
-                                          @"part_number": partNumber,
-                                          @"multi_part_id": multiPartID,
-                                          @"etag": eTag,
-                                          @"file": file,
-                                          @"temporary_file_created": tempFileCreated,
-                                          @"content_length": contentLength,
-                                          @"status": [AWSS3TransferUtilityDatabaseHelper getStringRepresentation:status],
-                                          @"request_headers": requestHeadersJSON,
-                                          @"request_parameters": requestParametersJSON,
-                                          @"retry_count": retryCount
-                                          }];
+                withParameterDictionary:parameterDictionary];
         
         if (!result) {
             AWSDDLogError(@"Failed to save Transfer [%@] in awstransfer database table. [%@]", transferID, db.lastError);
@@ -336,6 +389,47 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     }];
 }
 
++ (NSDictionary *) parametersForTransferRequest: (NSString *) transferID
+                                 nsURLSessionID: (NSString *) nsURLSessionID
+                                 taskIdentifier: (NSNumber *) taskIdentifier
+                                   transferType: (NSString *) transferType
+                                         bucket: (NSString *) bucket
+                                            key: (NSString *) key
+                                     partNumber: (NSNumber *) partNumber
+                                    multiPartID: (NSString *) multiPartID
+                                           eTag: (NSString *) eTag
+                                           file: (NSString *) file
+                           temporaryFileCreated: (BOOL) temporaryFileCreated
+                                  contentLength: (NSNumber *) contentLength
+                                         status: (AWSS3TransferUtilityTransferStatusType) status
+                                     retryCount: (NSNumber *) retryCount
+                             requestHeadersJSON: (NSString *) requestHeadersJSON
+                          requestParametersJSON: (NSString *) requestParametersJSON {
+    NSNumber *tempFileCreated = [NSNumber numberWithInt:0];
+    if (temporaryFileCreated) {
+        tempFileCreated = [NSNumber numberWithInt:1];
+    }
+    
+    return @{
+             @"transfer_id": transferID,
+             @"ns_url_session_id": nsURLSessionID,
+             @"session_task_id":taskIdentifier,
+             @"transfer_type": transferType,
+             @"bucket_name": bucket,
+             @"key": key,
+             @"part_number": partNumber,
+             @"multi_part_id": multiPartID,
+             @"etag": eTag,
+             @"file": file,
+             @"temporary_file_created": tempFileCreated,
+             @"content_length": contentLength,
+             @"status": [AWSS3TransferUtilityDatabaseHelper getStringRepresentation:status],
+             @"request_headers": requestHeadersJSON,
+             @"request_parameters": requestParametersJSON,
+             @"retry_count": retryCount
+             };
+}
+
 + (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
                                  databaseQueue: (AWSFMDatabaseQueue *) databaseQueue
 {
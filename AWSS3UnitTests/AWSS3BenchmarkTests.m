@@ -0,0 +1,221 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSS3Service.h"
+#import "AWSS3PreSignedURL.h"
+#import "AWSBenchmark.h"
+#import "TestHTTPServer.h"
+
+static NSString *const AWSS3BenchmarkTestsKey = @"AWSS3BenchmarkTests";
+// A bucket name with dots keeps requests path-style, so they can be sent to 127.0.0.1.
+static NSString *const AWSS3BenchmarkBucket = @"aws.sdk.benchmark";
+static NSString *const AWSS3BenchmarkUploadId = @"VXBsb2FkIElEIGZvciBiZW5jaG1hcms";
+static const NSUInteger AWSS3BenchmarkPartSize = 256 * 1024;
+static const NSUInteger AWSS3BenchmarkPartCount = 3;
+static const NSUInteger AWSS3BenchmarkWarmUpCount = 3;
+static const NSUInteger AWSS3BenchmarkOperationCount = 50;
+static const NSUInteger AWSS3BenchmarkPreSignedURLCount = 10000;
+static const NSUInteger AWSS3BenchmarkPreSignedURLBatchSize = 1000;
+
+@interface AWSS3BenchmarkTests : XCTestCase
+
+@property (nonatomic, strong) TestHTTPServer *server;
+@property (nonatomic, strong) AWSS3 *s3;
+@property (nonatomic, strong) AWSS3PreSignedURLBuilder *preSignedURLBuilder;
+
+@end
+
+@implementation AWSS3BenchmarkTests
+
++ (XCTestSuite *)defaultTestSuite {
+    // Benchmarks are opt-in; see AWSBenchmark.
+    return [AWSBenchmark isEnabled] ? [super defaultTestSuite] : [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+}
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [TestHTTPServer new];
+    XCTAssertTrue([self.server start]);
+    self.server.requestHandler = ^TestHTTPServerResponse *(TestHTTPServerRequest *request) {
+        return [AWSS3BenchmarkTests responseToMultipartUploadRequest:request];
+    };
+
+    AWSEndpoint *endpoint = [[AWSEndpoint alloc] initWithRegion:AWSRegionUSEast1
+                                                        service:AWSServiceS3
+                                                            URL:self.server.URL];
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                    endpoint:endpoint
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSS3 registerS3WithConfiguration:configuration forKey:AWSS3BenchmarkTestsKey];
+    self.s3 = [AWSS3 S3ForKey:AWSS3BenchmarkTestsKey];
+
+    [AWSS3PreSignedURLBuilder registerS3PreSignedURLBuilderWithConfiguration:[[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                                                         credentialsProvider:credentialsProvider]
+                                                                      forKey:AWSS3BenchmarkTestsKey];
+    self.preSignedURLBuilder = [AWSS3PreSignedURLBuilder S3PreSignedURLBuilderForKey:AWSS3BenchmarkTestsKey];
+}
+
+- (void)tearDown {
+    [AWSS3 removeS3ForKey:AWSS3BenchmarkTestsKey];
+    [AWSS3PreSignedURLBuilder removeS3PreSignedURLBuilderForKey:AWSS3BenchmarkTestsKey];
+    [self.server stop];
+    [super tearDown];
+}
+
+// Answers CreateMultipartUpload, UploadPart and CompleteMultipartUpload the way S3 does.
++ (TestHTTPServerResponse *)responseToMultipartUploadRequest:(TestHTTPServerRequest *)request {
+    NSString *key = [request.path lastPathComponent];
+    NSDictionary *XMLHeaders = @{@"Content-Type" : @"application/xml"};
+    if ([request.method isEqualToString:@"POST"] && [request.query isEqualToString:@"uploads"]) {
+        NSString *body = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                          "<InitiateMultipartUploadResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+                          "<Bucket>%@</Bucket><Key>%@</Key><UploadId>%@</UploadId>"
+                          "</InitiateMultipartUploadResult>", AWSS3BenchmarkBucket, key, AWSS3BenchmarkUploadId];
+        return [TestHTTPServerResponse responseWithStatusCode:200
+                                                      headers:XMLHeaders
+                                                         body:[body dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    if ([request.method isEqualToString:@"PUT"] && [request.query containsString:@"partNumber="]) {
+        if ([request.body length] != AWSS3BenchmarkPartSize) {
+            return [TestHTTPServerResponse responseWithStatusCode:400 headers:nil body:nil];
+        }
+        return [TestHTTPServerResponse responseWithStatusCode:200
+                                                      headers:@{@"ETag" : @"\"b54357faf0632cce46e942fa68356b38\""}
+                                                         body:nil];
+    }
+    if ([request.method isEqualToString:@"POST"] && [request.query containsString:@"uploadId="]) {
+        NSString *body = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                          "<CompleteMultipartUploadResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+                          "<Location>http://%@.s3.amazonaws.com/%@</Location><Bucket>%@</Bucket><Key>%@</Key>"
+                          "<ETag>\"3858f62230ac3c915f300c664312c11f-%lu\"</ETag>"
+                          "</CompleteMultipartUploadResult>", AWSS3BenchmarkBucket, key, AWSS3BenchmarkBucket, key, (unsigned long)AWSS3BenchmarkPartCount];
+        return [TestHTTPServerResponse responseWithStatusCode:200
+                                                      headers:XMLHeaders
+                                                         body:[body dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    return [TestHTTPServerResponse responseWithStatusCode:400 headers:nil body:nil];
+}
+
+- (BOOL)uploadObjectWithKey:(NSString *)key data:(NSData *)data {
+    AWSS3CreateMultipartUploadRequest *createRequest = [AWSS3CreateMultipartUploadRequest new];
+    createRequest.bucket = AWSS3BenchmarkBucket;
+    createRequest.key = key;
+    createRequest.contentType = @"application/octet-stream";
+    AWSTask<AWSS3CreateMultipartUploadOutput *> *createTask = [self.s3 createMultipartUpload:createRequest];
+    [createTask waitUntilFinished];
+    NSString *uploadId = createTask.result.uploadId;
+    if (!uploadId) {
+        return NO;
+    }
+
+    NSMutableArray<AWSS3CompletedPart *> *completedParts = [NSMutableArray new];
+    for (NSUInteger partNumber = 1; partNumber <= AWSS3BenchmarkPartCount; partNumber++) {
+        AWSS3UploadPartRequest *partRequest = [AWSS3UploadPartRequest new];
+        partRequest.bucket = AWSS3BenchmarkBucket;
+        partRequest.key = key;
+        partRequest.uploadId = uploadId;
+        partRequest.partNumber = @(partNumber);
+        partRequest.body = data;
+        partRequest.contentLength = @([data length]);
+        AWSTask<AWSS3UploadPartOutput *> *partTask = [self.s3 uploadPart:partRequest];
+        [partTask waitUntilFinished];
+        if (!partTask.result.ETag) {
+            return NO;
+        }
+
+        AWSS3CompletedPart *completedPart = [AWSS3CompletedPart new];
+        completedPart.partNumber = @(partNumber);
+        completedPart.ETag = partTask.result.ETag;
+        [completedParts addObject:completedPart];
+    }
+
+    AWSS3CompleteMultipartUploadRequest *completeRequest = [AWSS3CompleteMultipartUploadRequest new];
+    completeRequest.bucket = AWSS3BenchmarkBucket;
+    completeRequest.key = key;
+    completeRequest.uploadId = uploadId;
+    completeRequest.multipartUpload = [AWSS3CompletedMultipartUpload new];
+    completeRequest.multipartUpload.parts = completedParts;
+    AWSTask<AWSS3CompleteMultipartUploadOutput *> *completeTask = [self.s3 completeMultipartUpload:completeRequest];
+    [completeTask waitUntilFinished];
+    return completeTask.result.ETag != nil;
+}
+
+- (void)testMultipartUploadBenchmark {
+    NSMutableData *data = [NSMutableData dataWithLength:AWSS3BenchmarkPartSize];
+    arc4random_buf(data.mutableBytes, data.length);
+
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"S3MultipartUpload"
+                                                     warmUpCount:AWSS3BenchmarkWarmUpCount
+                                                  operationCount:AWSS3BenchmarkOperationCount
+                                                       operation:^BOOL(NSUInteger index) {
+        return [self uploadObjectWithKey:[NSString stringWithFormat:@"object-%lu", (unsigned long)index] data:data];
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+- (AWSS3GetPreSignedURLRequest *)getPreSignedURLRequestWithIndex:(NSUInteger)index expires:(NSDate *)expires {
+    AWSS3GetPreSignedURLRequest *request = [AWSS3GetPreSignedURLRequest new];
+    request.bucket = @"aws-sdk-benchmark";
+    request.key = [NSString stringWithFormat:@"gallery/photo-%05lu.jpg", (unsigned long)index];
+    request.HTTPMethod = AWSHTTPMethodGET;
+    request.expires = expires;
+    return request;
+}
+
+- (void)testPreSignedURLBenchmark {
+    NSDate *expires = [NSDate dateWithTimeIntervalSinceNow:3600];
+
+    // Each operation presigns a single URL, the way callers without the batch API do.
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"S3PreSignedURL"
+                                                     warmUpCount:AWSS3BenchmarkPreSignedURLBatchSize
+                                                  operationCount:AWSS3BenchmarkPreSignedURLCount
+                                                       operation:^BOOL(NSUInteger index) {
+        AWSTask<NSURL *> *task = [self.preSignedURLBuilder getPreSignedURL:[self getPreSignedURLRequestWithIndex:index expires:expires]];
+        [task waitUntilFinished];
+        return task.result != nil;
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+- (void)testPreSignedURLBatchBenchmark {
+    NSDate *expires = [NSDate dateWithTimeIntervalSinceNow:3600];
+
+    // Each operation presigns a batch, so the benchmark as a whole presigns the same number of URLs as the one above.
+    AWSBenchmarkResult *result = [AWSBenchmark runBenchmarkNamed:@"S3PreSignedURLBatch"
+                                                     warmUpCount:1
+                                                  operationCount:AWSS3BenchmarkPreSignedURLCount / AWSS3BenchmarkPreSignedURLBatchSize
+                                                       operation:^BOOL(NSUInteger index) {
+        NSMutableArray<AWSS3GetPreSignedURLRequest *> *requests = [NSMutableArray arrayWithCapacity:AWSS3BenchmarkPreSignedURLBatchSize];
+        for (NSUInteger i = 0; i < AWSS3BenchmarkPreSignedURLBatchSize; i++) {
+            [requests addObject:[self getPreSignedURLRequestWithIndex:index * AWSS3BenchmarkPreSignedURLBatchSize + i expires:expires]];
+        }
+        AWSTask<NSArray<NSURL *> *> *task = [self.preSignedURLBuilder getPreSignedURLs:requests];
+        [task waitUntilFinished];
+        return [task.result count] == AWSS3BenchmarkPreSignedURLBatchSize;
+    }];
+
+    XCTAssertEqual(result.failureCount, 0);
+    XCTAssertEqualObjects([AWSBenchmark regressionsOfResult:result], @[]);
+}
+
+@end
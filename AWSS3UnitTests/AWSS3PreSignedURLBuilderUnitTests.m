@@ -0,0 +1,167 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSS3PreSignedURL.h"
+
+static NSString *const AWSS3PreSignedURLBuilderUnitTestsKey = @"AWSS3PreSignedURLBuilderUnitTests";
+
+@interface AWSS3PreSignedURLBuilderUnitTests : XCTestCase
+
+@property (nonatomic, strong) AWSS3PreSignedURLBuilder *preSignedURLBuilder;
+@property (nonatomic, strong) NSDate *expires;
+
+@end
+
+@implementation AWSS3PreSignedURLBuilderUnitTests
+
+- (void)setUp {
+    [super setUp];
+
+    AWSStaticCredentialsProvider *credentialsProvider = [[AWSStaticCredentialsProvider alloc] initWithAccessKey:@"AKIDEXAMPLE"
+                                                                                                      secretKey:@"SECRETEXAMPLE"];
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:credentialsProvider];
+    [AWSS3PreSignedURLBuilder registerS3PreSignedURLBuilderWithConfiguration:configuration forKey:AWSS3PreSignedURLBuilderUnitTestsKey];
+    self.preSignedURLBuilder = [AWSS3PreSignedURLBuilder S3PreSignedURLBuilderForKey:AWSS3PreSignedURLBuilderUnitTestsKey];
+    self.expires = [NSDate dateWithTimeIntervalSinceNow:3600];
+}
+
+- (void)tearDown {
+    [AWSS3PreSignedURLBuilder removeS3PreSignedURLBuilderForKey:AWSS3PreSignedURLBuilderUnitTestsKey];
+    [super tearDown];
+}
+
+- (AWSS3GetPreSignedURLRequest *)requestWithKey:(NSString *)key {
+    AWSS3GetPreSignedURLRequest *request = [AWSS3GetPreSignedURLRequest new];
+    request.bucket = @"aws-sdk-unit-tests";
+    request.key = key;
+    request.HTTPMethod = AWSHTTPMethodGET;
+    request.expires = self.expires;
+    return request;
+}
+
+- (NSURL *)preSignedURLWithKey:(NSString *)key {
+    AWSTask<NSURL *> *task = [self.preSignedURLBuilder getPreSignedURL:[self requestWithKey:key]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    return task.result;
+}
+
+- (NSString *)valueOfQueryItemNamed:(NSString *)name inURL:(NSURL *)URL {
+    NSURLComponents *components = [NSURLComponents componentsWithURL:URL resolvingAgainstBaseURL:NO];
+    for (NSURLQueryItem *queryItem in components.queryItems) {
+        if ([queryItem.name isEqualToString:name]) {
+            return queryItem.value;
+        }
+    }
+    return nil;
+}
+
+- (void)testGetPreSignedURLsReturnsURLsInRequestOrder {
+    NSArray<NSString *> *keys = @[@"photos/a.jpg", @"photos/b.jpg", @"photos/c.jpg"];
+    NSMutableArray<AWSS3GetPreSignedURLRequest *> *requests = [NSMutableArray new];
+    for (NSString *key in keys) {
+        [requests addObject:[self requestWithKey:key]];
+    }
+
+    AWSTask<NSArray<NSURL *> *> *task = [self.preSignedURLBuilder getPreSignedURLs:requests];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual([task.result count], [keys count]);
+
+    NSURL *firstURL = [task.result firstObject];
+    [task.result enumerateObjectsUsingBlock:^(NSURL *URL, NSUInteger idx, BOOL *stop) {
+        XCTAssertEqualObjects(URL.host, @"aws-sdk-unit-tests.s3.amazonaws.com");
+        XCTAssertEqualObjects(URL.path, [@"/" stringByAppendingString:keys[idx]]);
+        XCTAssertNotNil([self valueOfQueryItemNamed:@"X-Amz-Signature" inURL:URL]);
+        // The whole batch is signed with the same credentials and date.
+        XCTAssertEqualObjects([self valueOfQueryItemNamed:@"X-Amz-Credential" inURL:URL],
+                              [self valueOfQueryItemNamed:@"X-Amz-Credential" inURL:firstURL]);
+        XCTAssertEqualObjects([self valueOfQueryItemNamed:@"X-Amz-Date" inURL:URL],
+                              [self valueOfQueryItemNamed:@"X-Amz-Date" inURL:firstURL]);
+    }];
+}
+
+- (void)testGetPreSignedURLsFailsOnFirstInvalidRequest {
+    AWSS3GetPreSignedURLRequest *missingKeyRequest = [self requestWithKey:nil];
+    AWSS3GetPreSignedURLRequest *missingBucketRequest = [self requestWithKey:@"photos/b.jpg"];
+    missingBucketRequest.bucket = nil;
+
+    AWSTask<NSArray<NSURL *> *> *task = [self.preSignedURLBuilder getPreSignedURLs:@[[self requestWithKey:@"photos/a.jpg"],
+                                                                                      missingKeyRequest,
+                                                                                      missingBucketRequest]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.result);
+    XCTAssertEqualObjects(task.error.domain, AWSS3PresignedURLErrorDomain);
+    XCTAssertEqual(task.error.code, AWSS3PresignedURLErrorKeyNameIsNil);
+}
+
+- (void)testGetPreSignedURLsWithNoRequests {
+    AWSTask<NSArray<NSURL *> *> *task = [self.preSignedURLBuilder getPreSignedURLs:@[]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(task.result, @[]);
+}
+
+- (void)testCacheIsDisabledByDefault {
+    XCTAssertEqual(self.preSignedURLBuilder.preSignedURLCacheCountLimit, 0);
+
+    NSURL *URL = [self preSignedURLWithKey:@"photos/a.jpg"];
+    XCTAssertNotEqual([self preSignedURLWithKey:@"photos/a.jpg"], URL);
+}
+
+- (void)testCachedURLOutlivesRequestedExpiry {
+    self.preSignedURLBuilder.preSignedURLCacheCountLimit = 10;
+
+    NSURL *URL = [self preSignedURLWithKey:@"photos/a.jpg"];
+    XCTAssertEqual([self preSignedURLWithKey:@"photos/a.jpg"], URL);
+
+    NSInteger expireDuration = [[self valueOfQueryItemNamed:@"X-Amz-Expires" inURL:URL] integerValue];
+    XCTAssertGreaterThanOrEqual(expireDuration, (NSInteger)[self.expires timeIntervalSinceNow]);
+    XCTAssertLessThanOrEqual(expireDuration, 3600 + 5 * 60);
+}
+
+- (void)testCacheKeyIncludesMethodAndExpiryInterval {
+    self.preSignedURLBuilder.preSignedURLCacheCountLimit = 10;
+
+    NSURL *URL = [self preSignedURLWithKey:@"photos/a.jpg"];
+
+    AWSS3GetPreSignedURLRequest *putRequest = [self requestWithKey:@"photos/a.jpg"];
+    putRequest.HTTPMethod = AWSHTTPMethodPUT;
+    AWSTask<NSURL *> *task = [self.preSignedURLBuilder getPreSignedURL:putRequest];
+    [task waitUntilFinished];
+    XCTAssertNotEqual(task.result, URL);
+
+    AWSS3GetPreSignedURLRequest *laterRequest = [self requestWithKey:@"photos/a.jpg"];
+    laterRequest.expires = [self.expires dateByAddingTimeInterval:3600];
+    task = [self.preSignedURLBuilder getPreSignedURL:laterRequest];
+    [task waitUntilFinished];
+    XCTAssertNotEqual(task.result, URL);
+}
+
+- (void)testCacheEvictsLeastRecentlyUsedURL {
+    self.preSignedURLBuilder.preSignedURLCacheCountLimit = 2;
+
+    NSURL *firstURL = [self preSignedURLWithKey:@"photos/a.jpg"];
+    NSURL *secondURL = [self preSignedURLWithKey:@"photos/b.jpg"];
+    XCTAssertEqual([self preSignedURLWithKey:@"photos/a.jpg"], firstURL);
+    [self preSignedURLWithKey:@"photos/c.jpg"];
+
+    XCTAssertEqual([self preSignedURLWithKey:@"photos/a.jpg"], firstURL);
+    XCTAssertNotEqual([self preSignedURLWithKey:@"photos/b.jpg"], secondURL);
+}
+
+@end
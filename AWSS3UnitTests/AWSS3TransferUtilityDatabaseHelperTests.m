@@ -0,0 +1,168 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSFMDB.h>
+#import "AWSS3TransferUtility.h"
+#import "AWSS3TransferUtilityTasks.h"
+
+@interface AWSS3TransferUtilityMultiPartUploadTask()
+@property (strong, nonatomic) AWSS3TransferUtilityMultiPartUploadExpression *expression;
+@property NSString *nsURLSessionID;
+@property NSString *uploadID;
+@property (strong, nonatomic) NSString *bucket;
+@property (strong, nonatomic) NSString *key;
+@property (strong, nonatomic) NSString *transferID;
+@end
+
+@interface AWSS3TransferUtilityUploadSubTask()
+@property (strong, nonatomic) NSNumber *partNumber;
+@property (readwrite) NSUInteger taskIdentifier;
+@property int64_t totalBytesExpectedToSend;
+@property NSString *file;
+@property NSString *transferType;
+@property NSString *transferID;
+@property AWSS3TransferUtilityTransferStatusType status;
+@end
+
+@interface AWSS3TransferUtilityDatabaseHelper : NSObject
+
++ (AWSFMDatabaseQueue *) createDatabase:(NSString*) cacheDirectoryPath;
+
++ (void) deleteTransferRequestsFromDB:(NSArray<NSString *> *) transferIDs
+                        databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
++ (void) insertMultiPartUploadRequestSubTasksInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
+                                         subTasks:(NSArray<AWSS3TransferUtilityUploadSubTask *> *) subTasks
+                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
++ (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
+                                 databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+
+@end
+
+@interface AWSS3TransferUtilityDatabaseHelperTests : XCTestCase
+
+@property (nonatomic, strong) NSString *cacheDirectoryPath;
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+
+@end
+
+@implementation AWSS3TransferUtilityDatabaseHelperTests
+
+- (void)setUp {
+    [super setUp];
+    self.cacheDirectoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.databaseQueue = [AWSS3TransferUtilityDatabaseHelper createDatabase:self.cacheDirectoryPath];
+    XCTAssertNotNil(self.databaseQueue);
+}
+
+- (void)tearDown {
+    [self.databaseQueue close];
+    [[NSFileManager defaultManager] removeItemAtPath:self.cacheDirectoryPath error:nil];
+    [super tearDown];
+}
+
+- (AWSS3TransferUtilityMultiPartUploadTask *)multiPartUploadTaskWithSessionID:(NSString *)sessionID {
+    AWSS3TransferUtilityMultiPartUploadTask *task = [AWSS3TransferUtilityMultiPartUploadTask new];
+    task.transferID = [[NSUUID UUID] UUIDString];
+    task.nsURLSessionID = sessionID;
+    task.bucket = @"bucket";
+    task.key = @"key";
+    task.uploadID = [[NSUUID UUID] UUIDString];
+    task.expression = [AWSS3TransferUtilityMultiPartUploadExpression new];
+    return task;
+}
+
+- (NSArray<AWSS3TransferUtilityUploadSubTask *> *)subTasksForTask:(AWSS3TransferUtilityMultiPartUploadTask *)task
+                                                            count:(NSUInteger)count {
+    NSMutableArray *subTasks = [NSMutableArray new];
+    for (NSUInteger i = 1; i <= count; i++) {
+        AWSS3TransferUtilityUploadSubTask *subTask = [AWSS3TransferUtilityUploadSubTask new];
+        subTask.transferID = task.transferID;
+        subTask.partNumber = @(i);
+        subTask.taskIdentifier = i;
+        subTask.transferType = @"MULTI_PART_UPLOAD_SUB_TASK";
+        subTask.totalBytesExpectedToSend = 5 * 1024 * 1024;
+        subTask.file = @"";
+        subTask.status = AWSS3TransferUtilityTransferStatusWaiting;
+        [subTasks addObject:subTask];
+    }
+    return subTasks;
+}
+
+- (void)testCreateDatabaseCreatesIndexes {
+    __block NSMutableSet<NSString *> *indexNames = [NSMutableSet new];
+    __block NSString *journalMode = nil;
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT name FROM sqlite_master WHERE type = 'index' AND tbl_name = 'awstransfer'"];
+        while ([rs next]) {
+            [indexNames addObject:[rs stringForColumnIndex:0]];
+        }
+        [rs close];
+        rs = [db executeQuery:@"PRAGMA journal_mode"];
+        if ([rs next]) {
+            journalMode = [rs stringForColumnIndex:0];
+        }
+        [rs close];
+    }];
+    XCTAssertTrue([indexNames containsObject:@"awstransfer_transfer_id_part_number"]);
+    XCTAssertTrue([indexNames containsObject:@"awstransfer_transfer_id_session_task_id"]);
+    XCTAssertTrue([indexNames containsObject:@"awstransfer_ns_url_session_id"]);
+    XCTAssertTrue([indexNames containsObject:@"awstransfer_status"]);
+    XCTAssertEqualObjects([journalMode lowercaseString], @"wal");
+}
+
+- (void)testBatchInsertOfSubTasks {
+    NSString *sessionID = @"testBatchInsertOfSubTasks";
+    AWSS3TransferUtilityMultiPartUploadTask *task = [self multiPartUploadTaskWithSessionID:sessionID];
+    NSArray *subTasks = [self subTasksForTask:task count:2000];
+
+    [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTasksInDB:task
+                                                                        subTasks:subTasks
+                                                                   databaseQueue:self.databaseQueue];
+
+    NSMutableArray *records = [AWSS3TransferUtilityDatabaseHelper getTransferTaskDataFromDB:sessionID
+                                                                               databaseQueue:self.databaseQueue];
+    XCTAssertEqual([records count], 2000);
+    XCTAssertEqualObjects(records[0][@"part_number"], @1);
+    XCTAssertEqualObjects(records[1999][@"part_number"], @2000);
+    XCTAssertEqualObjects(records[0][@"multi_part_id"], task.uploadID);
+    XCTAssertEqualObjects(records[0][@"status"], @(AWSS3TransferUtilityTransferStatusWaiting));
+}
+
+- (void)testBatchDelete {
+    NSString *sessionID = @"testBatchDelete";
+    AWSS3TransferUtilityMultiPartUploadTask *first = [self multiPartUploadTaskWithSessionID:sessionID];
+    AWSS3TransferUtilityMultiPartUploadTask *second = [self multiPartUploadTaskWithSessionID:sessionID];
+    AWSS3TransferUtilityMultiPartUploadTask *third = [self multiPartUploadTaskWithSessionID:sessionID];
+    for (AWSS3TransferUtilityMultiPartUploadTask *task in @[first, second, third]) {
+        [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTasksInDB:task
+                                                                            subTasks:[self subTasksForTask:task count:10]
+                                                                       databaseQueue:self.databaseQueue];
+    }
+
+    [AWSS3TransferUtilityDatabaseHelper deleteTransferRequestsFromDB:@[first.transferID, third.transferID]
+                                                       databaseQueue:self.databaseQueue];
+
+    NSMutableArray *records = [AWSS3TransferUtilityDatabaseHelper getTransferTaskDataFromDB:sessionID
+                                                                               databaseQueue:self.databaseQueue];
+    XCTAssertEqual([records count], 10);
+    for (NSDictionary *record in records) {
+        XCTAssertEqualObjects(record[@"transfer_id"], second.transferID);
+    }
+}
+
+@end
@@ -17,6 +17,7 @@
 #import "AWSTranscribeStreamingEventDecoder.h"
 #import "AWSTranscribeStreamingClientDelegate.h"
 #import "AWSTranscribeStreamingTranscriptResultStream+Helpers.h"
+#import "AWSTranscribeStreamingEventStreamCodec.h"
 
 @implementation AWSTranscribeStreamingEventDecoder
 
@@ -35,23 +36,19 @@
 //    assert(error == nil);
 //    AWSDDLogError(@"Wrote data_chunk to %@", temporaryFileURL);
 
-    if(![AWSTranscribeStreamingEventDecoder verifyPreludeForData:data decodingError:decodingErrorPointer]) {
+    AWSTranscribeStreamingEventStreamMessage *message = [AWSTranscribeStreamingEventStreamMessage messageWithData:data
+                                                                                                            error:decodingErrorPointer];
+    if (!message) {
         return nil;
     }
 
-    if (![AWSTranscribeStreamingEventDecoder verifyMessageLengthHeaderForData:data decodingError:decodingErrorPointer]) {
-        return nil;
-    }
-    
-    NSDictionary<NSString *, NSString *> *headers = [AWSTranscribeStreamingEventDecoder getHeadersForData:data];
+    NSDictionary<NSString *, NSString *> *headers = [AWSTranscribeStreamingEventDecoder stringHeadersForMessage:message];
     AWSDDLogVerbose(@"Response headers: %@", headers);
+    AWSDDLogVerbose(@"Body size: %lu", (unsigned long)message.payload.length);
 
-    NSString *body = [AWSTranscribeStreamingEventDecoder getBodyForData:data];
-    AWSDDLogVerbose(@"First 100 bytes of body: %@", [body substringToIndex:MIN(100, body.length)]);
-    
-    AWSTranscribeStreamingTranscriptResultStream *resultStream = [AWSTranscribeStreamingTranscriptResultStream resultStreamForWSSBody:body
-                                                                                                                              headers:headers
-                                                                                                                                error:decodingErrorPointer];
+    AWSTranscribeStreamingTranscriptResultStream *resultStream = [AWSTranscribeStreamingTranscriptResultStream resultStreamForWSSPayload:message.payload
+                                                                                                                                 headers:headers
+                                                                                                                                   error:decodingErrorPointer];
 
     if (*decodingErrorPointer) {
         AWSDDLogError(@"Error deserializing response data into AWSTranscribeStreamingTranscriptResultStream: %@", *decodingErrorPointer);
@@ -62,83 +59,14 @@
     return resultStream;
 }
 
-+(bool)verifyPreludeForData:(NSData *)data
-              decodingError:(NSError **)decodingErrorPointer {
-    if (data.length < 16) {
-        NSString *failureReason = [NSString stringWithFormat:@"Socket overhead is at least 16 bytes, actual data size is %lu",
-                                   data.length];
-
-        NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey:failureReason};
-        *decodingErrorPointer = [NSError errorWithDomain:AWSTranscribeStreamingClientErrorDomain
-                                                    code:AWSTranscribeStreamingClientErrorCodeInvalidMessagePrelude
-                                                userInfo:userInfo];
-        return NO;
-    }
-    return YES;
-}
-
-+(bool)verifyMessageLengthHeaderForData:(NSData *)data
-                          decodingError:(NSError **)decodingErrorPointer {
-    int totalLength = [AWSTranscribeStreamingEventDecoder getTotalLengthForData:data];
-    if (data.length < totalLength) {
-        NSString *failureReason = [NSString stringWithFormat:@"Prelude specifies data size of %d, actual size is %lu",
-                                   totalLength,
-                                   data.length];
-        NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: failureReason};
-        *decodingErrorPointer = [NSError errorWithDomain:AWSTranscribeStreamingClientErrorDomain
-                                                    code:AWSTranscribeStreamingClientErrorCodeInvalidMessageLengthHeader
-                                                userInfo:userInfo];
-        return NO;
-    }
-    return YES;
-}
-
-+(NSDictionary<NSString *, NSString *> *)getHeadersForData:(NSData *)data {
-    
-    int headerLen = [AWSTranscribeStreamingEventDecoder getHeaderLengthForData:data];
-    NSData *headerData = [data subdataWithRange:NSMakeRange(12, headerLen)];
-    int currentPosition = 0;
++(NSDictionary<NSString *, NSString *> *)stringHeadersForMessage:(AWSTranscribeStreamingEventStreamMessage *)message {
     NSMutableDictionary<NSString *, NSString *> *dictionary = [NSMutableDictionary new];
-    
-    while (currentPosition < headerLen) {
-        int currentHeaderLen = *(int *)[[headerData subdataWithRange:NSMakeRange(currentPosition, 1)]  bytes];
-        currentPosition++;
-        NSString *headerKey = [[NSString alloc] initWithData:[headerData subdataWithRange:NSMakeRange(currentPosition, currentHeaderLen)] encoding:NSUTF8StringEncoding];
-        AWSDDLogVerbose(@"Header Name: %@", headerKey);
-        currentPosition += currentHeaderLen;
-        
-        // skip header type info, always 7 while decoding
-        currentPosition++;
-        
-        int currentHeaderValueLen = CFSwapInt16(*(UInt16 *)[[headerData subdataWithRange:NSMakeRange(currentPosition, 2)]  bytes]);
-        currentPosition += 2;
-
-        NSString *headerValue = [[NSString alloc] initWithData:[headerData subdataWithRange:NSMakeRange(currentPosition, currentHeaderValueLen)] encoding:NSUTF8StringEncoding];
-        AWSDDLogVerbose(@"Header Value: %@", headerValue);
-
-        dictionary[headerKey] = headerValue;
-
-        currentPosition += currentHeaderValueLen;
-    }
-    
-    return [NSDictionary dictionaryWithDictionary:dictionary];
-}
-
-+(NSString *)getBodyForData:(NSData *)data {
-    NSUInteger headerLen = [AWSTranscribeStreamingEventDecoder getHeaderLengthForData:data];
-    NSUInteger messageLen = [data length];
-    NSUInteger dataStartPos = 4 + 4 + 4 + headerLen;
-    NSUInteger dataLen = messageLen - dataStartPos - 4;
-    NSString *dataString = [[NSString alloc] initWithData:[data subdataWithRange:NSMakeRange(dataStartPos, dataLen)] encoding:NSUTF8StringEncoding];
-    return dataString;
-}
-
-+(int)getTotalLengthForData:(NSData *)data {
-    return CFSwapInt32(*(UInt32 *)[[data subdataWithRange:NSMakeRange(0, 4)] bytes]);;
-}
-
-+(int)getHeaderLengthForData:(NSData *)data {
-    return CFSwapInt32(*(UInt32 *)[[data subdataWithRange:NSMakeRange(4, 8)] bytes]);;
+    [message.headers enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+        if ([value isKindOfClass:[NSString class]]) {
+            dictionary[key] = value;
+        }
+    }];
+    return dictionary;
 }
 
 @end
@@ -26,6 +26,7 @@
 #import <AWSCore/AWSSynchronizedMutableDictionary.h>
 #import "AWSTranscribeStreamingClientDelegate.h"
 #import "AWSTranscribeEventEncoder.h"
+#import "AWSTranscribeStreamingEventStreamCodec.h"
 #import "AWSTranscribeStreamingResources.h"
 #import "AWSSRWebSocketAdaptor.h"
 #import "AWSTranscribeStreamingWebSocketProvider.h"
@@ -66,6 +67,7 @@ static NSDictionary *errorCodeDictionary = nil;
 @property (nonatomic, strong) AWSNetworking *networking;
 @property (nonatomic, strong) AWSServiceConfiguration *configuration;
 @property (nonatomic, strong) id<AWSTranscribeStreamingWebSocketProvider> webSocketProvider;
+@property (nonatomic, strong) AWSTranscribeStreamingEventStreamEncoder *eventEncoder;
 
 @end
 
@@ -245,7 +247,15 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 }
 
 - (void)sendData:(NSData *)data headers:(NSDictionary *)headers {
-    NSData *encodedChunk = [AWSTranscribeEventEncoder encodeChunk:data headers:headers];
+    // Audio chunks are encoded into a single reused buffer. The immutable copy handed to the provider is the only
+    // allocation per chunk, and the web socket can retain it without copying again.
+    NSData *encodedChunk = nil;
+    @synchronized(self) {
+        if (!self.eventEncoder) {
+            self.eventEncoder = [AWSTranscribeStreamingEventStreamEncoder new];
+        }
+        encodedChunk = [[self.eventEncoder encodeMessageWithHeaders:headers payload:data] copy];
+    }
     [self.webSocketProvider send:encodedChunk];
 }
 
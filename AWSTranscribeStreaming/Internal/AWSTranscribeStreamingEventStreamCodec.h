@@ -0,0 +1,101 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Size of the prelude (total length, headers length and prelude CRC) of an event stream message.
+extern const NSUInteger AWSTranscribeStreamingEventStreamPreludeLength;
+
+/// Smallest possible event stream message: a prelude and a message CRC with no headers or payload.
+extern const NSUInteger AWSTranscribeStreamingEventStreamMinimumMessageLength;
+
+/// Header value types, per
+/// https://docs.aws.amazon.com/transcribe/latest/dg/event-stream.html
+typedef NS_ENUM(uint8_t, AWSTranscribeStreamingEventStreamHeaderType) {
+    AWSTranscribeStreamingEventStreamHeaderTypeBoolTrue = 0,
+    AWSTranscribeStreamingEventStreamHeaderTypeBoolFalse = 1,
+    AWSTranscribeStreamingEventStreamHeaderTypeByte = 2,
+    AWSTranscribeStreamingEventStreamHeaderTypeInt16 = 3,
+    AWSTranscribeStreamingEventStreamHeaderTypeInt32 = 4,
+    AWSTranscribeStreamingEventStreamHeaderTypeInt64 = 5,
+    AWSTranscribeStreamingEventStreamHeaderTypeByteArray = 6,
+    AWSTranscribeStreamingEventStreamHeaderTypeString = 7,
+    AWSTranscribeStreamingEventStreamHeaderTypeTimestamp = 8,
+    AWSTranscribeStreamingEventStreamHeaderTypeUUID = 9,
+};
+
+/**
+ A single decoded event stream message.
+
+ `headersData` and `payload` are views into the buffer the message was decoded from; no bytes are copied when a
+ message is decoded. Header values are only materialized when they are asked for.
+ */
+@interface AWSTranscribeStreamingEventStreamMessage : NSObject
+
+/// The raw header block of the message.
+@property (nonatomic, readonly) NSData *headersData;
+
+/// The payload of the message.
+@property (nonatomic, readonly) NSData *payload;
+
+/// All headers of the message. String headers are `NSString`, integer and boolean headers `NSNumber`, byte array
+/// headers `NSData`, timestamps `NSDate` and UUIDs `NSUUID`.
+@property (nonatomic, readonly) NSDictionary<NSString *, id> *headers;
+
+/// Returns the value of a string header, scanning the header block without decoding the other headers.
+- (nullable NSString *)stringHeaderForName:(NSString *)name;
+
+/// Decodes `data`, which must contain exactly one message, validating both the prelude and the message CRC.
++ (nullable instancetype)messageWithData:(NSData *)data
+                                   error:(NSError **)error;
+
+@end
+
+/**
+ Incrementally decodes a stream of event stream messages.
+
+ Data may be fed in chunks split at arbitrary boundaries; every complete message is returned as soon as its last
+ byte arrives. Only the bytes of a message that straddles two chunks are buffered. A decoder is not thread safe.
+ */
+@interface AWSTranscribeStreamingEventStreamDecoder : NSObject
+
+/// Number of bytes of an incomplete message currently held by the decoder.
+@property (nonatomic, readonly) NSUInteger bufferedLength;
+
+/// Appends `data` to the stream and returns the messages it completes, which may be none. On a framing or CRC error
+/// returns nil and populates `error`; the decoder is then reset and discards any buffered bytes.
+- (nullable NSArray<AWSTranscribeStreamingEventStreamMessage *> *)decodeData:(NSData *)data
+                                                                       error:(NSError **)error;
+
+/// Discards any partially received message.
+- (void)reset;
+
+@end
+
+/**
+ Encodes event stream messages into a buffer that is reused from one message to the next.
+ */
+@interface AWSTranscribeStreamingEventStreamEncoder : NSObject
+
+/// Encodes a message with string headers. The returned data is owned by the encoder and is only valid until the next
+/// call to this method; copy it if it has to outlive that.
+- (NSData *)encodeMessageWithHeaders:(NSDictionary<NSString *, NSString *> *)headers
+                             payload:(NSData *)payload;
+
+@end
+
+NS_ASSUME_NONNULL_END
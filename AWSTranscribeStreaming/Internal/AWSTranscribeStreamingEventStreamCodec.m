@@ -0,0 +1,539 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSTranscribeStreamingEventStreamCodec.h"
+#import "AWSTranscribeStreamingClientDelegate.h"
+#import <AWSCore/AWSCore.h>
+#import <zlib.h>
+
+const NSUInteger AWSTranscribeStreamingEventStreamPreludeLength = 12;
+const NSUInteger AWSTranscribeStreamingEventStreamMinimumMessageLength = 16;
+
+// Limits from the event stream specification.
+static const uint32_t AWSTranscribeStreamingEventStreamMaximumHeadersLength = 128 * 1024;
+static const uint32_t AWSTranscribeStreamingEventStreamMaximumPayloadLength = 16 * 1024 * 1024;
+
+#pragma mark - Wire helpers
+
+static inline uint16_t AWSTranscribeStreamingReadUInt16(const uint8_t *bytes) {
+    return (uint16_t)(((uint16_t)bytes[0] << 8) | bytes[1]);
+}
+
+static inline uint32_t AWSTranscribeStreamingReadUInt32(const uint8_t *bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+static inline uint64_t AWSTranscribeStreamingReadUInt64(const uint8_t *bytes) {
+    return ((uint64_t)AWSTranscribeStreamingReadUInt32(bytes) << 32) | AWSTranscribeStreamingReadUInt32(bytes + 4);
+}
+
+static inline void AWSTranscribeStreamingWriteUInt16(uint8_t *bytes, uint16_t value) {
+    bytes[0] = (uint8_t)(value >> 8);
+    bytes[1] = (uint8_t)value;
+}
+
+static inline void AWSTranscribeStreamingWriteUInt32(uint8_t *bytes, uint32_t value) {
+    bytes[0] = (uint8_t)(value >> 24);
+    bytes[1] = (uint8_t)(value >> 16);
+    bytes[2] = (uint8_t)(value >> 8);
+    bytes[3] = (uint8_t)value;
+}
+
+static NSError *AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCode code, NSString *failureReason) {
+    return [NSError errorWithDomain:AWSTranscribeStreamingClientErrorDomain
+                               code:code
+                           userInfo:@{NSLocalizedFailureReasonErrorKey: failureReason}];
+}
+
+// Returns an NSData over `length` bytes of `backing` that keeps `backing` alive instead of copying the bytes.
+static NSData *AWSTranscribeStreamingDataView(NSData *backing, const uint8_t *bytes, NSUInteger length) {
+    if (length == 0) {
+        return [NSData data];
+    }
+    return [[NSData alloc] initWithBytesNoCopy:(void *)bytes
+                                        length:length
+                                   deallocator:^(void *viewBytes, NSUInteger viewLength) {
+                                       (void)backing;
+                                   }];
+}
+
+typedef struct {
+    const uint8_t *name;
+    uint8_t nameLength;
+    AWSTranscribeStreamingEventStreamHeaderType type;
+    const uint8_t *value;
+    NSUInteger valueLength;
+} AWSTranscribeStreamingEventStreamHeader;
+
+// Reads the header at `*cursor` and advances past it. Returns 1 for a header, 0 at the end of the block and -1 when
+// the block is malformed.
+static int AWSTranscribeStreamingNextHeader(const uint8_t **cursor,
+                                            const uint8_t *end,
+                                            AWSTranscribeStreamingEventStreamHeader *header) {
+    const uint8_t *position = *cursor;
+    if (position == end) {
+        return 0;
+    }
+
+    header->nameLength = position[0];
+    position += 1;
+    if (header->nameLength == 0 || end - position < header->nameLength + 1) {
+        return -1;
+    }
+    header->name = position;
+    position += header->nameLength;
+    header->type = position[0];
+    position += 1;
+
+    NSUInteger valueLength = 0;
+    switch (header->type) {
+        case AWSTranscribeStreamingEventStreamHeaderTypeBoolTrue:
+        case AWSTranscribeStreamingEventStreamHeaderTypeBoolFalse:
+            valueLength = 0;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeByte:
+            valueLength = 1;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeInt16:
+            valueLength = 2;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeInt32:
+            valueLength = 4;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeInt64:
+        case AWSTranscribeStreamingEventStreamHeaderTypeTimestamp:
+            valueLength = 8;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeUUID:
+            valueLength = 16;
+            break;
+        case AWSTranscribeStreamingEventStreamHeaderTypeByteArray:
+        case AWSTranscribeStreamingEventStreamHeaderTypeString:
+            if (end - position < 2) {
+                return -1;
+            }
+            valueLength = AWSTranscribeStreamingReadUInt16(position);
+            position += 2;
+            break;
+        default:
+            return -1;
+    }
+
+    if ((NSUInteger)(end - position) < valueLength) {
+        return -1;
+    }
+    header->value = position;
+    header->valueLength = valueLength;
+    *cursor = position + valueLength;
+    return 1;
+}
+
+// Checks the lengths and CRC in the first 12 bytes of a message.
+static BOOL AWSTranscribeStreamingValidatePrelude(const uint8_t *bytes,
+                                                  uint32_t *totalLength,
+                                                  uint32_t *headersLength,
+                                                  NSError **error) {
+    uint32_t total = AWSTranscribeStreamingReadUInt32(bytes);
+    uint32_t headers = AWSTranscribeStreamingReadUInt32(bytes + 4);
+
+    uint32_t preludeCRC = (uint32_t)crc32(0, bytes, 8);
+    if (preludeCRC != AWSTranscribeStreamingReadUInt32(bytes + 8)) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeInvalidMessageChecksum,
+                                                            [NSString stringWithFormat:@"Prelude CRC mismatch, computed %u, received %u",
+                                                             preludeCRC,
+                                                             AWSTranscribeStreamingReadUInt32(bytes + 8)]);
+        }
+        return NO;
+    }
+
+    if (total < AWSTranscribeStreamingEventStreamMinimumMessageLength
+        || headers > AWSTranscribeStreamingEventStreamMaximumHeadersLength
+        || headers > total - AWSTranscribeStreamingEventStreamMinimumMessageLength
+        || total - AWSTranscribeStreamingEventStreamMinimumMessageLength - headers > AWSTranscribeStreamingEventStreamMaximumPayloadLength) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeInvalidMessageLengthHeader,
+                                                            [NSString stringWithFormat:@"Invalid prelude, total length %u, headers length %u",
+                                                             total,
+                                                             headers]);
+        }
+        return NO;
+    }
+
+    *totalLength = total;
+    *headersLength = headers;
+    return YES;
+}
+
+// Checks the message CRC and the header block of a message whose prelude has already been validated.
+static BOOL AWSTranscribeStreamingValidateMessage(const uint8_t *bytes,
+                                                  uint32_t totalLength,
+                                                  uint32_t headersLength,
+                                                  NSError **error) {
+    uint32_t messageCRC = (uint32_t)crc32(0, bytes, totalLength - 4);
+    if (messageCRC != AWSTranscribeStreamingReadUInt32(bytes + totalLength - 4)) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeInvalidMessageChecksum,
+                                                            [NSString stringWithFormat:@"Message CRC mismatch, computed %u, received %u",
+                                                             messageCRC,
+                                                             AWSTranscribeStreamingReadUInt32(bytes + totalLength - 4)]);
+        }
+        return NO;
+    }
+
+    const uint8_t *cursor = bytes + AWSTranscribeStreamingEventStreamPreludeLength;
+    const uint8_t *end = cursor + headersLength;
+    AWSTranscribeStreamingEventStreamHeader header;
+    int result;
+    while ((result = AWSTranscribeStreamingNextHeader(&cursor, end, &header)) > 0) {
+    }
+    if (result < 0) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeEventSerializationError,
+                                                            @"Malformed message headers");
+        }
+        return NO;
+    }
+    return YES;
+}
+
+#pragma mark - AWSTranscribeStreamingEventStreamMessage
+
+@interface AWSTranscribeStreamingEventStreamMessage()
+
+@property (nonatomic, strong) NSData *headersData;
+@property (nonatomic, strong) NSData *payload;
+@property (nonatomic, strong) NSDictionary<NSString *, id> *decodedHeaders;
+
+@end
+
+@implementation AWSTranscribeStreamingEventStreamMessage
+
+- (instancetype)initWithBacking:(NSData *)backing
+                          bytes:(const uint8_t *)bytes
+                    totalLength:(uint32_t)totalLength
+                  headersLength:(uint32_t)headersLength {
+    if (self = [super init]) {
+        const uint8_t *headers = bytes + AWSTranscribeStreamingEventStreamPreludeLength;
+        _headersData = AWSTranscribeStreamingDataView(backing, headers, headersLength);
+        _payload = AWSTranscribeStreamingDataView(backing,
+                                                  headers + headersLength,
+                                                  totalLength - AWSTranscribeStreamingEventStreamMinimumMessageLength - headersLength);
+    }
+    return self;
+}
+
++ (nullable instancetype)messageWithData:(NSData *)data
+                                   error:(NSError **)error {
+    // Views are taken on the data, so make sure a mutable buffer can't change underneath them.
+    data = [data copy];
+
+    if (data.length < AWSTranscribeStreamingEventStreamMinimumMessageLength) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeInvalidMessagePrelude,
+                                                            [NSString stringWithFormat:@"Socket overhead is at least %lu bytes, actual data size is %lu",
+                                                             (unsigned long)AWSTranscribeStreamingEventStreamMinimumMessageLength,
+                                                             (unsigned long)data.length]);
+        }
+        return nil;
+    }
+
+    const uint8_t *bytes = data.bytes;
+    uint32_t declaredLength = AWSTranscribeStreamingReadUInt32(bytes);
+    if (declaredLength != data.length) {
+        if (error) {
+            *error = AWSTranscribeStreamingEventStreamError(AWSTranscribeStreamingClientErrorCodeInvalidMessageLengthHeader,
+                                                            [NSString stringWithFormat:@"Prelude specifies data size of %u, actual size is %lu",
+                                                             declaredLength,
+                                                             (unsigned long)data.length]);
+        }
+        return nil;
+    }
+
+    uint32_t totalLength = 0;
+    uint32_t headersLength = 0;
+    if (!AWSTranscribeStreamingValidatePrelude(bytes, &totalLength, &headersLength, error)
+        || !AWSTranscribeStreamingValidateMessage(bytes, totalLength, headersLength, error)) {
+        return nil;
+    }
+
+    return [[self alloc] initWithBacking:data
+                                   bytes:bytes
+                             totalLength:totalLength
+                           headersLength:headersLength];
+}
+
+- (nullable NSString *)stringHeaderForName:(NSString *)name {
+    NSData *nameData = [name dataUsingEncoding:NSUTF8StringEncoding];
+    const uint8_t *cursor = self.headersData.bytes;
+    const uint8_t *end = cursor + self.headersData.length;
+    AWSTranscribeStreamingEventStreamHeader header;
+    while (AWSTranscribeStreamingNextHeader(&cursor, end, &header) > 0) {
+        if (header.type == AWSTranscribeStreamingEventStreamHeaderTypeString
+            && header.nameLength == nameData.length
+            && memcmp(header.name, nameData.bytes, header.nameLength) == 0) {
+            return [[NSString alloc] initWithBytes:header.value
+                                            length:header.valueLength
+                                          encoding:NSUTF8StringEncoding];
+        }
+    }
+    return nil;
+}
+
+- (NSDictionary<NSString *, id> *)headers {
+    if (self.decodedHeaders) {
+        return self.decodedHeaders;
+    }
+
+    NSMutableDictionary<NSString *, id> *headers = [NSMutableDictionary new];
+    const uint8_t *cursor = self.headersData.bytes;
+    const uint8_t *end = cursor + self.headersData.length;
+    AWSTranscribeStreamingEventStreamHeader header;
+    while (AWSTranscribeStreamingNextHeader(&cursor, end, &header) > 0) {
+        NSString *name = [[NSString alloc] initWithBytes:header.name
+                                                  length:header.nameLength
+                                                encoding:NSUTF8StringEncoding];
+        id value = nil;
+        switch (header.type) {
+            case AWSTranscribeStreamingEventStreamHeaderTypeBoolTrue:
+                value = @YES;
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeBoolFalse:
+                value = @NO;
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeByte:
+                value = @((int8_t)header.value[0]);
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeInt16:
+                value = @((int16_t)AWSTranscribeStreamingReadUInt16(header.value));
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeInt32:
+                value = @((int32_t)AWSTranscribeStreamingReadUInt32(header.value));
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeInt64:
+                value = @((int64_t)AWSTranscribeStreamingReadUInt64(header.value));
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeByteArray:
+                value = [self.headersData subdataWithRange:NSMakeRange(header.value - (const uint8_t *)self.headersData.bytes,
+                                                                       header.valueLength)];
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeString:
+                value = [[NSString alloc] initWithBytes:header.value
+                                                 length:header.valueLength
+                                               encoding:NSUTF8StringEncoding];
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeTimestamp:
+                value = [NSDate dateWithTimeIntervalSince1970:(int64_t)AWSTranscribeStreamingReadUInt64(header.value) / 1000.0];
+                break;
+            case AWSTranscribeStreamingEventStreamHeaderTypeUUID:
+                value = [[NSUUID alloc] initWithUUIDBytes:header.value];
+                break;
+        }
+        if (name && value) {
+            headers[name] = value;
+        }
+    }
+
+    self.decodedHeaders = headers;
+    return headers;
+}
+
+@end
+
+#pragma mark - AWSTranscribeStreamingEventStreamDecoder
+
+@implementation AWSTranscribeStreamingEventStreamDecoder {
+    // Bytes of a message that started in an earlier chunk. Handed over as the backing of that message once complete.
+    NSMutableData *_pending;
+    // Total length of the pending message, 0 until its prelude has been received and validated.
+    uint32_t _pendingTotalLength;
+    uint32_t _pendingHeadersLength;
+}
+
+- (NSUInteger)bufferedLength {
+    return _pending.length;
+}
+
+- (void)reset {
+    _pending = nil;
+    _pendingTotalLength = 0;
+    _pendingHeadersLength = 0;
+}
+
+- (nullable NSArray<AWSTranscribeStreamingEventStreamMessage *> *)decodeData:(NSData *)data
+                                                                       error:(NSError **)error {
+    // Views are taken on the data, so make sure a mutable buffer can't change underneath them.
+    data = [data copy];
+
+    NSMutableArray<AWSTranscribeStreamingEventStreamMessage *> *messages = [NSMutableArray new];
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = 0;
+
+    // Finish the message that straddles the previous chunk first.
+    if (_pending.length > 0) {
+        if (_pending.length < AWSTranscribeStreamingEventStreamPreludeLength) {
+            NSUInteger needed = MIN(AWSTranscribeStreamingEventStreamPreludeLength - _pending.length, length);
+            [_pending appendBytes:bytes length:needed];
+            offset += needed;
+            if (_pending.length < AWSTranscribeStreamingEventStreamPreludeLength) {
+                return messages;
+            }
+        }
+
+        if (_pendingTotalLength == 0) {
+            if (!AWSTranscribeStreamingValidatePrelude(_pending.bytes, &_pendingTotalLength, &_pendingHeadersLength, error)) {
+                [self reset];
+                return nil;
+            }
+        }
+
+        NSUInteger needed = MIN(_pendingTotalLength - _pending.length, length - offset);
+        [_pending appendBytes:bytes + offset length:needed];
+        offset += needed;
+        if (_pending.length < _pendingTotalLength) {
+            return messages;
+        }
+
+        NSData *backing = _pending;
+        uint32_t totalLength = _pendingTotalLength;
+        uint32_t headersLength = _pendingHeadersLength;
+        [self reset];
+        if (!AWSTranscribeStreamingValidateMessage(backing.bytes, totalLength, headersLength, error)) {
+            return nil;
+        }
+        [messages addObject:[[AWSTranscribeStreamingEventStreamMessage alloc] initWithBacking:backing
+                                                                                        bytes:backing.bytes
+                                                                                  totalLength:totalLength
+                                                                                headersLength:headersLength]];
+    }
+
+    // Decode every message that is complete within this chunk in place.
+    while (length - offset >= AWSTranscribeStreamingEventStreamPreludeLength) {
+        uint32_t totalLength = 0;
+        uint32_t headersLength = 0;
+        if (!AWSTranscribeStreamingValidatePrelude(bytes + offset, &totalLength, &headersLength, error)) {
+            [self reset];
+            return nil;
+        }
+        if (length - offset < totalLength) {
+            _pendingTotalLength = totalLength;
+            _pendingHeadersLength = headersLength;
+            break;
+        }
+        if (!AWSTranscribeStreamingValidateMessage(bytes + offset, totalLength, headersLength, error)) {
+            [self reset];
+            return nil;
+        }
+        [messages addObject:[[AWSTranscribeStreamingEventStreamMessage alloc] initWithBacking:data
+                                                                                        bytes:bytes + offset
+                                                                                  totalLength:totalLength
+                                                                                headersLength:headersLength]];
+        offset += totalLength;
+    }
+
+    // Keep the start of the next message, sized for the whole message when its prelude is already known.
+    if (offset < length) {
+        _pending = [NSMutableData dataWithCapacity:MAX(_pendingTotalLength, AWSTranscribeStreamingEventStreamPreludeLength)];
+        [_pending appendBytes:bytes + offset length:length - offset];
+    }
+
+    return messages;
+}
+
+@end
+
+#pragma mark - AWSTranscribeStreamingEventStreamEncoder
+
+@implementation AWSTranscribeStreamingEventStreamEncoder {
+    NSMutableData *_buffer;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _buffer = [NSMutableData new];
+    }
+    return self;
+}
+
+- (NSData *)encodeMessageWithHeaders:(NSDictionary<NSString *, NSString *> *)headers
+                             payload:(NSData *)payload {
+    // Header lengths on the wire are UTF-8 byte counts, not character counts.
+    NSUInteger headersLength = 0;
+    for (NSString *name in headers) {
+        NSUInteger nameLength = [name lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        NSUInteger valueLength = [headers[name] lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        if (nameLength == 0 || nameLength > UINT8_MAX || valueLength > UINT16_MAX) {
+            AWSDDLogError(@"Skipping event stream header %@, name or value is too long", name);
+            continue;
+        }
+        headersLength += 1 + nameLength + 1 + 2 + valueLength;
+    }
+
+    NSUInteger totalLength = AWSTranscribeStreamingEventStreamMinimumMessageLength + headersLength + payload.length;
+    _buffer.length = totalLength;
+    uint8_t *bytes = _buffer.mutableBytes;
+
+    AWSTranscribeStreamingWriteUInt32(bytes, (uint32_t)totalLength);
+    AWSTranscribeStreamingWriteUInt32(bytes + 4, (uint32_t)headersLength);
+    uLong preludeCRC = crc32(0, bytes, 8);
+    AWSTranscribeStreamingWriteUInt32(bytes + 8, (uint32_t)preludeCRC);
+
+    uint8_t *position = bytes + AWSTranscribeStreamingEventStreamPreludeLength;
+    for (NSString *name in headers) {
+        NSString *value = headers[name];
+        NSUInteger nameLength = [name lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        NSUInteger valueLength = [value lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        if (nameLength == 0 || nameLength > UINT8_MAX || valueLength > UINT16_MAX) {
+            continue;
+        }
+
+        *position++ = (uint8_t)nameLength;
+        [name getBytes:position
+             maxLength:nameLength
+            usedLength:NULL
+              encoding:NSUTF8StringEncoding
+               options:0
+                 range:NSMakeRange(0, name.length)
+        remainingRange:NULL];
+        position += nameLength;
+
+        *position++ = AWSTranscribeStreamingEventStreamHeaderTypeString;
+        AWSTranscribeStreamingWriteUInt16(position, (uint16_t)valueLength);
+        position += 2;
+        [value getBytes:position
+              maxLength:valueLength
+             usedLength:NULL
+               encoding:NSUTF8StringEncoding
+                options:0
+                  range:NSMakeRange(0, value.length)
+         remainingRange:NULL];
+        position += valueLength;
+    }
+
+    if (payload.length > 0) {
+        memcpy(position, payload.bytes, payload.length);
+    }
+
+    // The message CRC covers everything before it, so continue from the prelude CRC instead of starting over.
+    uLong messageCRC = crc32(crc32(preludeCRC, bytes + 8, 4),
+                             bytes + AWSTranscribeStreamingEventStreamPreludeLength,
+                             (uInt)(totalLength - AWSTranscribeStreamingEventStreamMinimumMessageLength));
+    AWSTranscribeStreamingWriteUInt32(bytes + totalLength - 4, (uint32_t)messageCRC);
+
+    return _buffer;
+}
+
+@end
@@ -23,6 +23,11 @@ NS_ASSUME_NONNULL_BEGIN
                                                                           headers:(NSDictionary<NSString *, NSString *> *)headers
                                                                             error:(NSError * __autoreleasing *)errorPointer;
 
+/// Same as `resultStreamForWSSBody:headers:error:`, but parses the UTF-8 JSON payload directly.
++ (nullable AWSTranscribeStreamingTranscriptResultStream *)resultStreamForWSSPayload:(NSData *)payload
+                                                                             headers:(NSDictionary<NSString *, NSString *> *)headers
+                                                                               error:(NSError * __autoreleasing *)errorPointer;
+
 @end
 
 NS_ASSUME_NONNULL_END
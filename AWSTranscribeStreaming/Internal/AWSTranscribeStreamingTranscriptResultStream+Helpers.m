@@ -32,8 +32,16 @@ static NSDictionary *errorCodeDictionary = nil;
 + (nullable AWSTranscribeStreamingTranscriptResultStream *)resultStreamForWSSBody:(NSString *)body
                                                                           headers:(NSDictionary<NSString *, NSString *> *)headers
                                                                             error:(NSError * __autoreleasing *)errorPointer {
+    return [self resultStreamForWSSPayload:[body dataUsingEncoding:NSUTF8StringEncoding]
+                                   headers:headers
+                                     error:errorPointer];
+}
+
++ (nullable AWSTranscribeStreamingTranscriptResultStream *)resultStreamForWSSPayload:(NSData *)payload
+                                                                             headers:(NSDictionary<NSString *, NSString *> *)headers
+                                                                               error:(NSError * __autoreleasing *)errorPointer {
     
-    NSDictionary *jsonObject = [NSJSONSerialization JSONObjectWithData:[body dataUsingEncoding:NSUTF8StringEncoding]
+    NSDictionary *jsonObject = [NSJSONSerialization JSONObjectWithData:payload
                                                                options:NSJSONReadingMutableContainers
                                                                  error:errorPointer];
     
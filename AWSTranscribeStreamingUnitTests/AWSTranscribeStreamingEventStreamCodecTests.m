@@ -0,0 +1,204 @@
+//
+// Copyright 2010-2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import "AWSTranscribeStreamingEventStreamCodec.h"
+#import "AWSTranscribeStreamingClientDelegate.h"
+
+// A transcript event captured from the service.
+static NSString *const AWSTranscribeStreamingEventStreamCodecTestsTranscriptEvent = @"AAABsgAAAFXfePLDCzpldmVudC10eXBlBwAPVHJhbnNjcmlwdEV2ZW50DTpjb250ZW50LXR5cGUHABBhcHBsaWNhdGlvbi9qc29uDTptZXNzYWdlLXR5cGUHAAVldmVudHsiVHJhbnNjcmlwdCI6eyJSZXN1bHRzIjpbeyJBbHRlcm5hdGl2ZXMiOlt7Ikl0ZW1zIjpbeyJDb250ZW50IjoiSGVsbG8iLCJFbmRUaW1lIjowLjIxLCJTdGFydFRpbWUiOjAuMTIsIlR5cGUiOiJwcm9udW5jaWF0aW9uIn0seyJDb250ZW50Ijoid2VyZSIsIkVuZFRpbWUiOjAuNDksIlN0YXJ0VGltZSI6MC4yMiwiVHlwZSI6InByb251bmNpYXRpb24ifV0sIlRyYW5zY3JpcHQiOiJIZWxsbyB3ZXJlIn1dLCJFbmRUaW1lIjowLjUzLCJJc1BhcnRpYWwiOnRydWUsIlJlc3VsdElkIjoiOTQ4NjJmNGEtMzc5My00ZTViLThlODUtMTkxNWM4ZDMzZjkyIiwiU3RhcnRUaW1lIjowLjEyfV19fRMshLQ=";
+
+@interface AWSTranscribeStreamingEventStreamCodecTests : XCTestCase
+
+@end
+
+@implementation AWSTranscribeStreamingEventStreamCodecTests
+
+- (NSData *)randomDataWithLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    for (NSUInteger i = 0; i < length; i++) {
+        ((uint8_t *)data.mutableBytes)[i] = (uint8_t)arc4random_uniform(256);
+    }
+    return data;
+}
+
+- (NSDictionary<NSString *, NSString *> *)headersForIndex:(NSUInteger)index {
+    return @{
+             @":message-type": @"event",
+             @":event-type": @"AudioEvent",
+             @":content-type": @"application/octet-stream",
+             // Multi-byte characters make the UTF-8 length differ from the character count.
+             @"x-test-index": [NSString stringWithFormat:@"%lu-éü✓", (unsigned long)index],
+             };
+}
+
+- (void)testDecodesCapturedServiceEvent {
+    NSData *data = [[NSData alloc] initWithBase64EncodedString:AWSTranscribeStreamingEventStreamCodecTestsTranscriptEvent options:0];
+    NSError *error = nil;
+    AWSTranscribeStreamingEventStreamMessage *message = [AWSTranscribeStreamingEventStreamMessage messageWithData:data error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([message stringHeaderForName:@":message-type"], @"event");
+    XCTAssertEqualObjects(message.headers[@":event-type"], @"TranscriptEvent");
+    XCTAssertEqualObjects(message.headers[@":content-type"], @"application/json");
+    XCTAssertNotNil([NSJSONSerialization JSONObjectWithData:message.payload options:0 error:nil]);
+}
+
+- (void)testEncodedHeaderLengthsAreUTF8ByteCounts {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSData *encoded = [[encoder encodeMessageWithHeaders:@{@"k": @"✓"} payload:[NSData data]] copy];
+    // prelude + [1][k][7][0x0003][3 bytes] + message CRC
+    XCTAssertEqual(encoded.length, 12 + 1 + 1 + 1 + 2 + 3 + 4);
+
+    AWSTranscribeStreamingEventStreamMessage *message = [AWSTranscribeStreamingEventStreamMessage messageWithData:encoded error:nil];
+    XCTAssertEqualObjects([message stringHeaderForName:@"k"], @"✓");
+    XCTAssertEqual(message.payload.length, 0);
+}
+
+- (void)testRoundTripAcrossRandomReadBoundaries {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSMutableData *stream = [NSMutableData new];
+    NSMutableArray<NSData *> *payloads = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 200; i++) {
+        NSData *payload = [self randomDataWithLength:arc4random_uniform(4096)];
+        [payloads addObject:payload];
+        [stream appendData:[encoder encodeMessageWithHeaders:[self headersForIndex:i] payload:payload]];
+    }
+
+    for (NSUInteger iteration = 0; iteration < 20; iteration++) {
+        AWSTranscribeStreamingEventStreamDecoder *decoder = [AWSTranscribeStreamingEventStreamDecoder new];
+        NSMutableArray<AWSTranscribeStreamingEventStreamMessage *> *messages = [NSMutableArray new];
+        NSUInteger offset = 0;
+        while (offset < stream.length) {
+            // Mostly small reads, so that preludes and headers are regularly split, with the odd large one.
+            NSUInteger chunkLength = arc4random_uniform(10) == 0 ? arc4random_uniform(20000) : arc4random_uniform(64);
+            chunkLength = MIN(chunkLength, stream.length - offset);
+            NSError *error = nil;
+            NSArray *decoded = [decoder decodeData:[stream subdataWithRange:NSMakeRange(offset, chunkLength)] error:&error];
+            XCTAssertNil(error);
+            XCTAssertNotNil(decoded);
+            [messages addObjectsFromArray:decoded];
+            offset += chunkLength;
+        }
+
+        XCTAssertEqual(decoder.bufferedLength, 0);
+        XCTAssertEqual(messages.count, payloads.count);
+        for (NSUInteger i = 0; i < MIN(messages.count, payloads.count); i++) {
+            XCTAssertEqualObjects(messages[i].payload, payloads[i]);
+            XCTAssertEqualObjects(messages[i].headers, [self headersForIndex:i]);
+        }
+    }
+}
+
+- (void)testDecoderDetectsCorruptionAnywhereInTheMessage {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSData *encoded = [[encoder encodeMessageWithHeaders:[self headersForIndex:0]
+                                                 payload:[self randomDataWithLength:64]] copy];
+
+    for (NSUInteger position = 0; position < encoded.length; position++) {
+        NSMutableData *corrupted = [encoded mutableCopy];
+        ((uint8_t *)corrupted.mutableBytes)[position] ^= 0x10;
+
+        AWSTranscribeStreamingEventStreamDecoder *decoder = [AWSTranscribeStreamingEventStreamDecoder new];
+        NSError *error = nil;
+        NSArray *messages = [decoder decodeData:corrupted error:&error];
+        XCTAssertNil(messages, @"position %lu", (unsigned long)position);
+        XCTAssertEqualObjects(error.domain, AWSTranscribeStreamingClientErrorDomain);
+        XCTAssertEqual(error.code, AWSTranscribeStreamingClientErrorCodeInvalidMessageChecksum, @"position %lu", (unsigned long)position);
+    }
+}
+
+- (void)testDecoderRecoversAfterReset {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSData *encoded = [[encoder encodeMessageWithHeaders:[self headersForIndex:0] payload:[self randomDataWithLength:32]] copy];
+    AWSTranscribeStreamingEventStreamDecoder *decoder = [AWSTranscribeStreamingEventStreamDecoder new];
+
+    XCTAssertEqual([decoder decodeData:[encoded subdataWithRange:NSMakeRange(0, 20)] error:nil].count, 0);
+    XCTAssertEqual(decoder.bufferedLength, 20);
+    [decoder reset];
+    XCTAssertEqual(decoder.bufferedLength, 0);
+
+    NSArray *messages = [decoder decodeData:encoded error:nil];
+    XCTAssertEqual(messages.count, 1);
+}
+
+- (void)testFuzzedInputNeverCrashes {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSData *valid = [[encoder encodeMessageWithHeaders:[self headersForIndex:0] payload:[self randomDataWithLength:128]] copy];
+
+    for (NSUInteger iteration = 0; iteration < 5000; iteration++) {
+        NSMutableData *input;
+        if (iteration % 2 == 0) {
+            input = [[self randomDataWithLength:arc4random_uniform(512)] mutableCopy];
+        } else {
+            // Mutate the headers and payload of a valid message, then fix up its CRC so the header parser is reached.
+            input = [valid mutableCopy];
+            NSUInteger mutations = 1 + arc4random_uniform(4);
+            for (NSUInteger i = 0; i < mutations; i++) {
+                NSUInteger position = 12 + arc4random_uniform((uint32_t)(input.length - 16));
+                ((uint8_t *)input.mutableBytes)[position] = (uint8_t)arc4random_uniform(256);
+            }
+            uint8_t *bytes = input.mutableBytes;
+            uint32_t messageCRC = (uint32_t)crc32(0, bytes, (uInt)(input.length - 4));
+            bytes[input.length - 4] = (uint8_t)(messageCRC >> 24);
+            bytes[input.length - 3] = (uint8_t)(messageCRC >> 16);
+            bytes[input.length - 2] = (uint8_t)(messageCRC >> 8);
+            bytes[input.length - 1] = (uint8_t)messageCRC;
+        }
+
+        NSError *error = nil;
+        AWSTranscribeStreamingEventStreamMessage *message = [AWSTranscribeStreamingEventStreamMessage messageWithData:input error:&error];
+        XCTAssertTrue(message != nil || error != nil);
+        (void)message.headers;
+
+        AWSTranscribeStreamingEventStreamDecoder *decoder = [AWSTranscribeStreamingEventStreamDecoder new];
+        NSUInteger offset = 0;
+        while (offset < input.length) {
+            NSUInteger chunkLength = MIN((NSUInteger)1 + arc4random_uniform(32), input.length - offset);
+            NSArray<AWSTranscribeStreamingEventStreamMessage *> *messages = [decoder decodeData:[input subdataWithRange:NSMakeRange(offset, chunkLength)]
+                                                                                          error:nil];
+            if (!messages) {
+                break;
+            }
+            for (AWSTranscribeStreamingEventStreamMessage *decoded in messages) {
+                (void)decoded.headers;
+            }
+            offset += chunkLength;
+        }
+    }
+}
+
+- (void)testPerformanceDecodingStream {
+    AWSTranscribeStreamingEventStreamEncoder *encoder = [AWSTranscribeStreamingEventStreamEncoder new];
+    NSMutableData *stream = [NSMutableData new];
+    NSData *payload = [self randomDataWithLength:3200];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        [stream appendData:[encoder encodeMessageWithHeaders:[self headersForIndex:i] payload:payload]];
+    }
+
+    [self measureBlock:^{
+        AWSTranscribeStreamingEventStreamDecoder *decoder = [AWSTranscribeStreamingEventStreamDecoder new];
+        NSUInteger count = 0;
+        for (NSUInteger offset = 0; offset < stream.length; offset += 16384) {
+            NSData *chunk = [stream subdataWithRange:NSMakeRange(offset, MIN((NSUInteger)16384, stream.length - offset))];
+            for (AWSTranscribeStreamingEventStreamMessage *message in [decoder decodeData:chunk error:nil]) {
+                count += [message stringHeaderForName:@":event-type"].length > 0;
+            }
+        }
+        XCTAssertEqual(count, 1000);
+    }];
+}
+
+@end